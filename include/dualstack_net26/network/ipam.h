@@ -0,0 +1,159 @@
+/**
+ * Amphisbaena 🐍 - IP Address Management (IPAM)
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Address allocation for VPC subnets:
+ * - Hierarchical free bitmap: allocate and free touch one word per level
+ *   (three levels for a /16), whatever the pool occupancy
+ * - Reservations for fixed addresses (network, broadcast, gateway, ...);
+ *   the gateway can be claimed by an adapter that is the gateway
+ * - Expiring leases on a hashed timer wheel, advanced by expire_leases()
+ * - Dual-stack pairing: the IPv6 address is the subnet's IPv6 prefix with
+ *   the IPv4 address in its low 32 bits, so one allocation yields both
+ */
+
+#pragma once
+
+#include "../fix_format_header.h"
+#include "../../../src/core/ip_address.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+
+// Set of indices with O(levels) first-set search; a set bit means "free"
+class HierarchicalBitmap {
+private:
+    std::vector<std::vector<std::uint64_t>> levels_;    // levels_[0] holds the bits; above it, one bit per non-empty word
+    std::size_t size_ = 0;
+    std::size_t count_ = 0;
+
+public:
+    explicit HierarchicalBitmap(std::size_t size = 0);
+
+    auto set(std::size_t index) -> void;
+    auto reset(std::size_t index) -> void;
+    auto test(std::size_t index) const -> bool {
+        return (levels_[0][index / 64] >> (index % 64)) & 1;
+    }
+    auto find_first() const -> std::optional<std::size_t>;
+
+    auto size() const -> std::size_t { return size_; }
+    auto count() const -> std::size_t { return count_; }
+};
+
+// IPAM pool configuration
+struct IpamConfig {
+    ipv4_address base;                          // Subnet address; host bits are ignored
+    int prefix_length = 24;                     // IpamPool::MIN_PREFIX_LENGTH to MAX_PREFIX_LENGTH
+    std::optional<ipv6_address> ipv6_prefix;    // Enables dual-stack allocation
+    int ipv6_prefix_length = 64;                // At most 96, leaving room for the IPv4 address
+    bool reserve_gateway = true;                // First host address held for the VPC gateway
+    std::chrono::seconds lease_tick{1};         // Lease wheel resolution
+    std::size_t wheel_slots = 512;
+};
+
+// An allocated address
+struct IpamLease {
+    ipv4_address ipv4;
+    std::optional<ipv6_address> ipv6;           // Dual-stack allocations only
+    std::chrono::steady_clock::time_point expires_at = std::chrono::steady_clock::time_point::max();
+};
+
+// IPAM statistics
+struct IpamStats {
+    std::uint64_t allocations;
+    std::uint64_t releases;
+    std::uint64_t expirations;
+    std::uint64_t exhausted;                    // Allocations refused for want of a free address
+};
+
+// Address pool for one subnet; all methods are thread-safe
+class IpamPool {
+private:
+    enum class EntryState : std::uint8_t {
+        FREE,
+        LEASED,
+        RESERVED,               // Held by reserve() until released
+        FIXED                   // Network, broadcast and unclaimed gateway: never allocated or released
+    };
+
+    struct Entry {
+        std::uint32_t generation = 0;           // Bumped on every change; stales wheel entries
+        EntryState state = EntryState::FREE;
+        bool dual_stack = false;
+        std::int64_t expires_tick = 0;          // 0: held until released
+    };
+
+    IpamConfig config_;
+    std::uint32_t network_ = 0;
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+    HierarchicalBitmap free_;
+
+    // Lease wheel: slot = expiry tick % slots; entries of later revolutions are re-slotted when reached
+    std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t>>> wheel_;     // Index, generation
+    std::chrono::steady_clock::time_point epoch_;
+    std::int64_t current_tick_ = 0;
+
+    IpamStats stats_{};
+
+    explicit IpamPool(const IpamConfig& config);
+
+    auto index_of(const ipv4_address& ipv4) const -> std::optional<std::uint32_t>;
+    auto is_gateway_index(std::uint32_t index) const -> bool { return config_.reserve_gateway && index == 1; }
+    auto lease_for(std::uint32_t index) const -> IpamLease;
+    auto take_locked(std::uint32_t index, bool dual_stack, std::chrono::seconds duration) -> IpamLease;
+    auto free_locked(std::uint32_t index) -> void;
+    auto schedule_locked(std::uint32_t index, std::chrono::seconds duration) -> void;
+    auto tick_of(std::chrono::steady_clock::time_point time) const -> std::int64_t;
+
+public:
+    static constexpr int MIN_PREFIX_LENGTH = 16;
+    static constexpr int MAX_PREFIX_LENGTH = 30;
+
+    static auto create(const IpamConfig& config) -> std::expected<std::unique_ptr<IpamPool>, std::string>;
+
+    // Lowest free address; a zero duration holds it until released
+    auto allocate(std::chrono::seconds duration = std::chrono::seconds(0)) -> std::expected<IpamLease, std::string>;
+    // IPv4 and IPv6 in one allocation; requires ipv6_prefix
+    auto allocate_dual_stack(std::chrono::seconds duration = std::chrono::seconds(0)) -> std::expected<IpamLease, std::string>;
+    // Up to `count` addresses under one lock, appended to `out`; returns how many
+    auto allocate_batch(std::size_t count, bool dual_stack, std::chrono::seconds duration,
+                        std::vector<IpamLease>& out) -> std::size_t;
+
+    // Hold a specific address (e.g. one assigned by hand) until released.
+    // The gateway can be claimed this way once; releasing it holds it back again.
+    auto reserve(const ipv4_address& ipv4) -> std::expected<IpamLease, std::string>;
+    // False for free addresses and for the network, broadcast and unclaimed gateway
+    auto release(const ipv4_address& ipv4) -> bool;
+    // Restart a lease's clock; false when the address is not leased
+    auto renew(const ipv4_address& ipv4, std::chrono::seconds duration) -> bool;
+
+    // Free every lease due by `now`; their addresses are appended to `expired` when given
+    auto expire_leases(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now(),
+                       std::vector<IpamLease>* expired = nullptr) -> std::size_t;
+
+    auto get_config() const -> const IpamConfig& { return config_; }
+    auto is_dual_stack() const -> bool { return config_.ipv6_prefix.has_value(); }
+    auto contains(const ipv4_address& ipv4) const -> bool { return index_of(ipv4).has_value(); }
+    auto is_allocated(const ipv4_address& ipv4) const -> bool;
+    auto ipv6_for(const ipv4_address& ipv4) const -> std::optional<ipv6_address>;
+    auto gateway() const -> std::optional<ipv4_address>;
+    auto subnet_mask() const -> ipv4_address;
+    auto capacity() const -> std::size_t { return entries_.size(); }
+    auto available() const -> std::size_t;
+    auto get_stats() const -> IpamStats;
+};
+
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,127 @@
+/**
+ * Amphisbaena 🐍 - Host Interface State over Netlink
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Source of truth for the host's links, addresses and routes (Linux):
+ * - One rtnetlink socket dumps links, addresses and routes in turn
+ * - A subscribed socket reports incremental changes as they happen,
+ *   drained without blocking whenever an event loop sees it readable
+ * - HostNetworkState applies those changes, so a dump is only needed
+ *   at start-up and after an overrun
+ *
+ * Other platforms report netlink as unavailable.
+ */
+
+#pragma once
+
+#include "../fix_format_header.h"
+#include "../../../src/core/ip_address.h"
+#include "virtual_adapter.h"
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+
+// A network interface (RTM_NEWLINK)
+struct LinkInfo {
+    int index = 0;
+    std::string name;
+    std::uint32_t flags = 0;                    // IFF_* flags
+    std::uint32_t mtu = 0;
+    std::string mac_address;                    // Empty for links without one
+    std::string kind;                           // IFLA_INFO_KIND ("veth", "bridge", ...); empty for hardware
+    std::uint64_t bytes_sent = 0;
+    std::uint64_t bytes_received = 0;
+    std::uint64_t packets_sent = 0;
+    std::uint64_t packets_received = 0;
+};
+
+// An address assigned to an interface (RTM_NEWADDR)
+struct AddressInfo {
+    int interface_index = 0;
+    IPAddress address;
+    int prefix_length = 0;
+    int scope = 0;                              // RT_SCOPE_*
+};
+
+// A unicast route (RTM_NEWROUTE); multipath routes yield one entry per next hop
+struct RouteInfo {
+    IPAddress destination;
+    int prefix_length = 0;                      // 0 for a default route
+    std::optional<IPAddress> gateway;
+    int interface_index = 0;
+    std::uint32_t table = 0;                    // RT_TABLE_MAIN is 254
+    std::uint32_t priority = 0;                 // Metric; lower wins
+};
+
+// Change types delivered by NetlinkMonitor
+enum class NetlinkEventType {
+    LINK_CHANGED,       // New link, or flags / name / statistics changed
+    LINK_REMOVED,
+    ADDRESS_ADDED,
+    ADDRESS_REMOVED,
+    ROUTE_ADDED,
+    ROUTE_REMOVED,
+    OVERRUN             // Events were dropped or truncated; take a fresh dump
+};
+
+// One change; only the member matching `type` is filled in
+struct NetlinkEvent {
+    NetlinkEventType type;
+    LinkInfo link;
+    AddressInfo address;
+    RouteInfo route;
+};
+
+// Links, addresses and routes of the host, kept current by apply()
+struct HostNetworkState {
+    std::map<int, LinkInfo> links;              // By interface index
+    std::vector<AddressInfo> addresses;
+    std::vector<RouteInfo> routes;
+
+    auto apply(const NetlinkEvent& event) -> void;
+    auto find_link(const std::string& name) const -> const LinkInfo*;
+
+    // Adapter view: addresses per link, gateways from main-table default routes
+    auto to_network_interfaces() const -> std::vector<NetworkInterface>;
+};
+
+// Dump links, addresses and routes over one netlink socket
+auto netlink_dump() -> std::expected<HostNetworkState, std::string>;
+
+// Subscription to link, address and route changes
+//
+// Register native_handle() for readability with the event loop (e.g. the
+// Poller of the serving layers) and call process() when it fires. Open the
+// monitor before taking the initial dump so no change falls in between;
+// applying a change the dump already contains is harmless.
+class NetlinkMonitor {
+private:
+    int fd_ = -1;
+    std::vector<std::byte> buffer_;
+
+public:
+    NetlinkMonitor() = default;
+    ~NetlinkMonitor();
+
+    NetlinkMonitor(const NetlinkMonitor&) = delete;
+    auto operator=(const NetlinkMonitor&) -> NetlinkMonitor& = delete;
+
+    auto open() -> std::expected<void, std::string>;
+    auto close() -> void;
+    auto is_open() const -> bool { return fd_ >= 0; }
+    auto native_handle() const -> int { return fd_; }
+
+    // Deliver every queued change without blocking; returns how many were delivered
+    auto process(const std::function<void(const NetlinkEvent&)>& handler) -> std::expected<std::size_t, std::string>;
+};
+
+} // namespace network
+} // namespace dualstack
@@ -31,6 +31,7 @@
 #include <chrono>
 #include <expected>
 #include "../../../src/core/ip_address.h"
+#include "../../../src/reflect/reflection.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
@@ -110,6 +111,29 @@ struct AMPHISBAENA_API SubnetConfig {
     std::chrono::system_clock::time_point created_at;
     std::chrono::system_clock::time_point updated_at;
     
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(name);
+        DUALSTACK_REFLECT_MEMBER(network_address);
+        DUALSTACK_REFLECT_MEMBER(prefix_length);
+        DUALSTACK_REFLECT_MEMBER(type);
+        DUALSTACK_REFLECT_MEMBER(is_ipv6);
+        DUALSTACK_REFLECT_MEMBER(allow_inbound);
+        DUALSTACK_REFLECT_MEMBER(allow_outbound);
+        DUALSTACK_REFLECT_MEMBER(require_encryption);
+        DUALSTACK_REFLECT_MEMBER(require_authentication);
+        DUALSTACK_REFLECT_MEMBER(vpc_id);
+        DUALSTACK_REFLECT_MEMBER(vps_instance_id);
+        DUALSTACK_REFLECT_MEMBER(region);
+        DUALSTACK_REFLECT_MEMBER(vpn_endpoint);
+        DUALSTACK_REFLECT_MEMBER(vpn_protocol);
+        DUALSTACK_REFLECT_MEMBER(vnc_port);
+        DUALSTACK_REFLECT_MEMBER(vnc_encrypted);
+        DUALSTACK_REFLECT_MEMBER(description);
+        DUALSTACK_REFLECT_MEMBER(created_at);
+        DUALSTACK_REFLECT_MEMBER(updated_at);
+    }
+    
     SubnetConfig();
     SubnetConfig(const std::string& name, const IPAddress& addr, uint8_t prefix, NetworkType type);
     
@@ -140,6 +164,22 @@ struct AMPHISBAENA_API InterfaceConfig {
     uint64_t speed_mbps;                // Interface speed (Mbps)
     bool promiscuous_mode;              // Promiscuous mode enabled
     
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(name);
+        DUALSTACK_REFLECT_MEMBER(mac_address);
+        DUALSTACK_REFLECT_MEMBER(ip_address);
+        DUALSTACK_REFLECT_MEMBER(subnet_mask);
+        DUALSTACK_REFLECT_MEMBER(gateway);
+        DUALSTACK_REFLECT_MEMBER(dns_servers);
+        DUALSTACK_REFLECT_MEMBER(is_up);
+        DUALSTACK_REFLECT_MEMBER(is_loopback);
+        DUALSTACK_REFLECT_MEMBER(primary_type);
+        DUALSTACK_REFLECT_MEMBER(mtu);
+        DUALSTACK_REFLECT_MEMBER(speed_mbps);
+        DUALSTACK_REFLECT_MEMBER(promiscuous_mode);
+    }
+    
     InterfaceConfig();
 };
 
@@ -157,6 +197,17 @@ struct AMPHISBAENA_API RouteConfig {
     uint32_t metric;                    // Route metric (lower = preferred)
     bool is_default;                    // Default route
     
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(name);
+        DUALSTACK_REFLECT_MEMBER(destination);
+        DUALSTACK_REFLECT_MEMBER(destination_prefix);
+        DUALSTACK_REFLECT_MEMBER(gateway);
+        DUALSTACK_REFLECT_MEMBER(interface_name);
+        DUALSTACK_REFLECT_MEMBER(metric);
+        DUALSTACK_REFLECT_MEMBER(is_default);
+    }
+    
     RouteConfig();
 };
 
@@ -188,6 +239,23 @@ struct AMPHISBAENA_API NetworkProfile {
     std::chrono::system_clock::time_point created_at;
     std::chrono::system_clock::time_point updated_at;
     
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(profile_name);
+        DUALSTACK_REFLECT_MEMBER(description);
+        DUALSTACK_REFLECT_MEMBER(subnets);
+        DUALSTACK_REFLECT_MEMBER(interfaces);
+        DUALSTACK_REFLECT_MEMBER(routes);
+        DUALSTACK_REFLECT_MEMBER(firewall_enabled);
+        DUALSTACK_REFLECT_MEMBER(nat_enabled);
+        DUALSTACK_REFLECT_MEMBER(ip_forwarding_enabled);
+        DUALSTACK_REFLECT_MEMBER(vpc_id);
+        DUALSTACK_REFLECT_MEMBER(vps_instance_id);
+        DUALSTACK_REFLECT_MEMBER(availability_zone);
+        DUALSTACK_REFLECT_MEMBER(created_at);
+        DUALSTACK_REFLECT_MEMBER(updated_at);
+    }
+    
     NetworkProfile();
     NetworkProfile(const std::string& name);
 };
@@ -0,0 +1,137 @@
+/**
+ * Amphisbaena 🐍 - Notification Aggregator
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * PUBLIC LIBRARY - Notification coalescing, deduplication and rate-limiting
+ *
+ * Keeps the notification path from amplifying an incident: repeated reports of
+ * the same problem are forwarded once and then summarised per window, and each
+ * category is held to a token bucket.
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../fix_format_header.h"
+#include "notifications.h"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+namespace dualstack {
+namespace network {
+namespace notifications {
+
+/**
+ * @brief Token bucket limits for one notification category
+ *
+ * A bucket with no capacity does not limit, so nothing is throttled unless a
+ * limit is configured.
+ */
+struct AMPHISBAENA_API RateLimit {
+    double tokens_per_second = 0.0;     // Sustained forwarding rate
+    double burst = 0.0;                 // Bucket capacity; 0 disables the limit
+
+    bool is_unlimited() const { return burst <= 0.0; }
+};
+
+/**
+ * @brief Aggregation Configuration
+ *
+ * Notifications carrying an error_code are coalesced on
+ * (source_id, source_component, error_code, severity): the first occurrence is
+ * forwarded immediately, later ones inside the window are counted and reported
+ * as a single summary when the window closes. Notifications without an
+ * error_code are never coalesced; when a token bucket drops them they are
+ * counted per identical (title, message) and summarised the same way.
+ */
+struct AMPHISBAENA_API AggregationConfig {
+    bool enabled = true;
+    std::chrono::milliseconds window{1000};         // Coalescing window per key
+    RateLimit default_limit;                         // Applied to categories without an override (off by default)
+    std::map<Category, RateLimit> category_limits;   // Per-category overrides
+    bool exempt_critical = true;                     // CRITICAL bypasses the token bucket
+    size_t max_tracked_keys = 65536;                 // Bound on distinct keys held per window
+};
+
+/**
+ * @brief Notification Aggregator
+ *
+ * Windowed aggregation stage in front of NotificationManager dispatch.
+ * Time is passed in explicitly so the stage is deterministic under test.
+ */
+class AMPHISBAENA_API NotificationAggregator {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit NotificationAggregator(AggregationConfig config = AggregationConfig{});
+
+    /**
+     * @brief Decide whether a notification is forwarded now
+     *
+     * @return true to forward immediately, false if it was folded into a summary
+     */
+    bool admit(const Notification& notification, clock::time_point now = clock::now());
+
+    /**
+     * @brief Collect summaries for windows that have closed
+     *
+     * Keys that saw repeats produce one summary and open a new window; quiet
+     * keys are forgotten so their next occurrence is forwarded immediately.
+     */
+    std::vector<Notification> collect_summaries(clock::time_point now = clock::now());
+
+    /**
+     * @brief Collect summaries for every open window regardless of age
+     */
+    std::vector<Notification> drain(clock::time_point now = clock::now());
+
+    // Configuration
+    void set_config(const AggregationConfig& config);
+    AggregationConfig get_config() const;
+    bool is_enabled() const;
+
+    // Statistics
+    size_t get_suppressed_count() const;
+    size_t get_rate_limited_count() const;
+    size_t get_tracked_key_count() const;
+
+private:
+    struct TokenBucket {
+        double tokens;
+        clock::time_point last_refill;
+    };
+
+    struct Window {
+        Notification first;              // First occurrence, used as summary template
+        clock::time_point window_start;
+        clock::time_point last_seen;
+        size_t suppressed = 0;           // Duplicates folded inside this window
+        size_t rate_limited = 0;         // Of which dropped by the token bucket
+    };
+
+    mutable std::mutex mutex_;
+    AggregationConfig config_;
+    std::unordered_map<std::string, Window> windows_;
+    std::unordered_map<uint16_t, TokenBucket> buckets_;
+    clock::time_point next_sweep_;
+
+    size_t suppressed_count_ = 0;
+    size_t rate_limited_count_ = 0;
+
+    static std::string make_key(const Notification& notification);
+    bool try_consume(Category category, clock::time_point now);
+    const RateLimit& limit_for(Category category) const;
+    static Notification make_summary(const Window& window, clock::time_point now);
+    std::vector<Notification> sweep(clock::time_point now, bool force);
+};
+
+} // namespace notifications
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,101 @@
+/**
+ * Amphisbaena 🐍 - Notification Dispatch Ring
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * PUBLIC LIBRARY - Lock-free hand-off from the Lamia C interface
+ *
+ * Bounded multi-producer / single-consumer ring of fixed-layout
+ * NotificationRecord slots. Producers claim a slot with one CAS, fill it in
+ * place and publish it; the dispatcher converts records to Notification on
+ * its own thread, so the emitting thread never allocates or locks.
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../fix_format_header.h"
+#include "notifications.h"
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace dualstack {
+namespace network {
+namespace notifications {
+
+static_assert(sizeof(NotificationRecord) == 512, "NotificationRecord layout is part of the C ABI");
+
+/**
+ * @brief Notification Dispatch Ring
+ *
+ * Each slot carries a sequence number (Vyukov bounded queue): a producer owns
+ * a slot once its CAS on the enqueue position succeeds, and the consumer sees
+ * it only after publish() stores the next sequence with release ordering.
+ */
+class AMPHISBAENA_API NotificationRing {
+public:
+    explicit NotificationRing(size_t capacity = 4096);  // Rounded up to a power of two
+
+    NotificationRing(const NotificationRing&) = delete;
+    NotificationRing& operator=(const NotificationRing&) = delete;
+
+    // Producer side (any thread)
+    NotificationRecord* try_acquire();
+    void publish(NotificationRecord* record);
+    bool try_push(const char* source_id, const char* source_component, uint16_t category,
+                  uint8_t severity, const char* title, const char* message);
+
+    // Consumer side (one thread): visits published records in claim order
+    template<typename Visitor>
+    size_t consume(Visitor&& visitor, size_t max_records = SIZE_MAX);
+
+    bool empty() const;
+    size_t capacity() const { return mask_ + 1; }
+    uint64_t get_published_position() const { return enqueue_pos_.load(std::memory_order_acquire); }
+    uint64_t get_consumed_position() const { return dequeue_pos_.load(std::memory_order_acquire); }
+
+    // Record helpers
+    static void fill(NotificationRecord& record, const char* source_id, const char* source_component,
+                     uint16_t category, uint8_t severity, const char* title, const char* message);
+    static Notification to_notification(const NotificationRecord& record);
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence;
+        NotificationRecord record;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+    alignas(64) std::atomic<uint64_t> dequeue_pos_{0};
+};
+
+template<typename Visitor>
+size_t NotificationRing::consume(Visitor&& visitor, size_t max_records) {
+    size_t consumed = 0;
+    uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+    while (consumed < max_records) {
+        Slot& slot = slots_[pos & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            break;  // Empty, or the producer that claimed this slot has not published yet
+        }
+
+        visitor(static_cast<const NotificationRecord&>(slot.record));
+
+        slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        ++pos;
+        ++consumed;
+    }
+
+    dequeue_pos_.store(pos, std::memory_order_release);
+    return consumed;
+}
+
+} // namespace notifications
+} // namespace network
+} // namespace dualstack
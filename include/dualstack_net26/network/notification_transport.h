@@ -0,0 +1,213 @@
+/**
+ * Amphisbaena 🐍 - Notification Server Transport
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * PUBLIC LIBRARY - Binary batched delivery to the MedusaServ Notification Server
+ *
+ * Notifications are encoded into compact length-prefixed batches and pipelined
+ * over a persistent AsyncConnectionManager connection using GalaxyCDN framing.
+ * The server acknowledges batches cumulatively; unacknowledged batches are
+ * retransmitted after a reconnect and overflow to an on-disk spill queue while
+ * the server is unreachable. Callers never block on the network.
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../fix_format_header.h"
+#include "notifications.h"
+#include "../../../src/core/socket.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <optional>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+namespace dualstack {
+namespace network {
+
+class AsyncConnectionManager;
+
+namespace notifications {
+
+/**
+ * @brief Wire format for notification batches
+ *
+ * Batch payload (little-endian):
+ *   u32 magic "NTFB" | u8 version | u8 reserved | u16 record count
+ *   then per record: varint length | record bytes
+ *
+ * Record: u8 severity | u16 category | i64 timestamp (ms since epoch)
+ *   followed by varint-length-prefixed strings and string lists
+ *   (Notification's reflected members in reflect/serializer.h binary form).
+ */
+namespace wire {
+    constexpr uint32_t BATCH_MAGIC = 0x4246544E;   // "NTFB"
+    constexpr uint8_t BATCH_VERSION = 1;
+    constexpr size_t BATCH_HEADER_SIZE = 8;
+
+    // GalaxyCDN::ProtocolHeader flags used by the notification channel
+    constexpr uint16_t FLAG_NOTIFICATION_BATCH = 0x0100;
+    constexpr uint16_t FLAG_NOTIFICATION_ACK = 0x0200;   // request_id = highest batch received
+
+    // Server frames are bare acknowledgements; a longer payload is a protocol error
+    constexpr uint32_t MAX_SERVER_PAYLOAD = 64;
+
+    AMPHISBAENA_API void encode_notification(const Notification& notification, std::vector<std::byte>& out);
+    AMPHISBAENA_API std::optional<Notification> decode_notification(std::span<const std::byte> record);
+
+    AMPHISBAENA_API void begin_batch(std::vector<std::byte>& out);
+    AMPHISBAENA_API void append_record(std::vector<std::byte>& batch, std::span<const std::byte> record);
+    AMPHISBAENA_API void finish_batch(std::vector<std::byte>& batch, uint16_t count);
+    AMPHISBAENA_API std::optional<std::vector<Notification>> decode_batch(std::span<const std::byte> payload);
+}
+
+/**
+ * @brief Transport Configuration
+ */
+struct AMPHISBAENA_API NotificationTransportConfig {
+    std::string host;
+    uint16_t port = 0;
+
+    // Batching: a batch is flushed when either limit is reached or it ages out
+    size_t max_batch_notifications = 256;
+    size_t max_batch_bytes = 64 * 1024;
+    std::chrono::milliseconds flush_interval{50};
+
+    // Pipelining: batches sent without waiting for their acknowledgement
+    size_t max_in_flight_batches = 16;
+
+    // Reconnect with exponential backoff; connects are non-blocking and abandoned after connect_timeout
+    std::chrono::milliseconds connect_timeout{5000};
+    // A batch not fully written within send_timeout (server stopped reading) drops the connection
+    std::chrono::milliseconds send_timeout{5000};
+    std::chrono::milliseconds reconnect_initial{100};
+    std::chrono::milliseconds reconnect_max{30000};
+
+    // Queueing: batches beyond max_memory_batches, or any while disconnected, go to disk
+    size_t max_memory_batches = 64;
+    size_t max_total_memory_batches = 1024;     // Hard cap before explicit drops
+    // Empty = a private file created for this instance in the temp directory
+    // and removed once drained; set a path to replay undelivered batches after
+    // a restart. The file is opened with O_NOFOLLOW and created mode 0600.
+    std::string spill_path;
+    size_t max_spill_bytes = 256ull * 1024 * 1024;
+};
+
+/**
+ * @brief Transport Statistics
+ */
+struct AMPHISBAENA_API NotificationTransportStats {
+    uint64_t enqueued = 0;
+    uint64_t batches_sent = 0;
+    uint64_t batches_acked = 0;
+    uint64_t notifications_acked = 0;
+    uint64_t batches_retransmitted = 0;
+    uint64_t batches_spilled = 0;
+    uint64_t dropped = 0;            // Only when both memory and spill are exhausted
+    uint64_t reconnects = 0;
+    bool connected = false;
+};
+
+/**
+ * @brief Notification Transport
+ *
+ * Persistent, pipelined connection to the notification server.
+ * enqueue() only encodes into the open batch; all network and disk I/O
+ * happens on the transport worker thread.
+ */
+class AMPHISBAENA_API NotificationTransport {
+public:
+    explicit NotificationTransport(NotificationTransportConfig config);
+    ~NotificationTransport();
+
+    NotificationTransport(const NotificationTransport&) = delete;
+    NotificationTransport& operator=(const NotificationTransport&) = delete;
+
+    bool start();
+    void stop();
+    bool is_running() const { return running_; }
+
+    // Non-blocking; returns false only when the notification had to be dropped
+    bool enqueue(const Notification& notification);
+
+    // Seal the open batch and wake the worker
+    void flush();
+
+    NotificationTransportStats get_stats() const;
+    const NotificationTransportConfig& get_config() const { return config_; }
+    size_t get_pending_batch_count() const;
+
+private:
+    struct Batch {
+        uint64_t sequence = 0;
+        uint16_t count = 0;
+        std::vector<std::byte> payload;
+    };
+
+    NotificationTransportConfig config_;
+    std::unique_ptr<AsyncConnectionManager> connection_manager_;
+    std::string connection_id_;
+
+    // Producer side (guarded by queue_mutex_)
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::vector<std::byte> open_batch_;
+    uint16_t open_count_ = 0;
+    std::chrono::steady_clock::time_point open_since_;
+    std::deque<Batch> ready_;
+
+    // Worker side (worker thread only)
+    std::deque<Batch> retransmit_;      // Unacknowledged at disconnect; older than anything spilled
+    std::deque<Batch> memory_queue_;
+    std::deque<Batch> in_flight_;
+    std::vector<std::byte> receive_buffer_;
+    uint64_t next_sequence_ = 1;
+    std::chrono::milliseconds backoff_;
+    std::chrono::steady_clock::time_point next_connect_attempt_;
+    std::optional<Socket> connecting_;
+    IPAddress connect_address_;
+    std::chrono::steady_clock::time_point connect_deadline_;
+    int spill_fd_ = -1;
+    bool spill_owned_ = false;          // Generated path, removed when the transport stops with it empty
+    uint64_t spill_read_offset_ = 0;
+    uint64_t spill_size_ = 0;
+
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+
+    // Statistics
+    mutable std::mutex stats_mutex_;
+    NotificationTransportStats stats_;
+
+    void worker_loop();
+    void seal_open_batch_locked();
+    bool try_connect();
+    bool finish_connect();
+    void back_off();
+    void handle_disconnect();
+    bool send_batch(Batch& batch);
+    void process_acks(std::chrono::milliseconds timeout);
+    std::optional<Batch> next_batch_to_send();
+
+    // Spill queue (append-only file of [u32 length][u16 count][payload])
+    bool open_spill();
+    void close_spill();
+    void spill(Batch batch);
+    void spill_ahead(std::deque<Batch>& batches);
+    std::optional<Batch> read_spilled();
+};
+
+} // namespace notifications
+} // namespace network
+} // namespace dualstack
@@ -22,7 +22,10 @@
 #include <mutex>
 #include <unordered_map>
 #include <atomic>
+#include <thread>
+#include <condition_variable>
 #include <cstdint>
+#include "../../../src/reflect/reflection.h"
 
 // Public API Export for DLL/SO
 #ifdef AMPHISBAENA_BUILDING_LIBRARY
@@ -45,6 +48,40 @@ extern "C" {
     struct NotificationContext;
     typedef struct NotificationContext* NotificationContextHandle;
     
+    // Fixed-layout record written directly into the dispatch ring.
+    // Strings are stored inline, NUL-terminated and cut to fit their slot.
+    #define NOTIFICATION_RECORD_SOURCE_ID_SIZE 32
+    #define NOTIFICATION_RECORD_COMPONENT_SIZE 32
+    #define NOTIFICATION_RECORD_TITLE_SIZE 96
+    #define NOTIFICATION_RECORD_MESSAGE_SIZE 328
+
+    // Bits in NotificationRecord.truncated
+    #define NOTIFICATION_TRUNCATED_SOURCE_ID 0x01
+    #define NOTIFICATION_TRUNCATED_COMPONENT 0x02
+    #define NOTIFICATION_TRUNCATED_TITLE 0x04
+    #define NOTIFICATION_TRUNCATED_MESSAGE 0x08
+
+    // notification_send / notification_record_acquire results
+    #define NOTIFICATION_OK 0
+    #define NOTIFICATION_ERROR_INVALID -1
+    #define NOTIFICATION_ERROR_RING_FULL -2
+
+    typedef struct NotificationRecord {
+        uint64_t timestamp_ns;          // system_clock, nanoseconds since epoch
+        uint16_t category;
+        uint8_t severity;
+        uint8_t truncated;              // NOTIFICATION_TRUNCATED_* bits
+        uint8_t source_id_length;
+        uint8_t source_component_length;
+        uint16_t title_length;
+        uint16_t message_length;
+        uint8_t reserved[6];
+        char source_id[NOTIFICATION_RECORD_SOURCE_ID_SIZE];
+        char source_component[NOTIFICATION_RECORD_COMPONENT_SIZE];
+        char title[NOTIFICATION_RECORD_TITLE_SIZE];
+        char message[NOTIFICATION_RECORD_MESSAGE_SIZE];
+    } NotificationRecord;
+
     // C interface functions (implemented in .cpp)
     AMPHISBAENA_API NotificationContextHandle notification_context_create();
     AMPHISBAENA_API void notification_context_destroy(NotificationContextHandle ctx);
@@ -55,6 +92,10 @@ extern "C" {
                                          uint8_t severity,
                                          const char* title,
                                          const char* message);
+    AMPHISBAENA_API NotificationRecord* notification_record_acquire(NotificationContextHandle ctx);
+    AMPHISBAENA_API int notification_record_publish(NotificationContextHandle ctx, NotificationRecord* record);
+    AMPHISBAENA_API int notification_context_flush(NotificationContextHandle ctx);
+    AMPHISBAENA_API uint64_t notification_context_dropped(NotificationContextHandle ctx);
 }
 
 namespace dualstack {
@@ -123,6 +164,28 @@ struct AMPHISBAENA_API Notification {
     std::string resolution_hint;    // Suggested resolution
     std::vector<std::string> affected_components;  // Components affected by error/warning
     
+    // Order is the notification transport's record layout (see wire::encode_notification)
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(severity);
+        DUALSTACK_REFLECT_MEMBER(category);
+        DUALSTACK_REFLECT_MEMBER(timestamp);
+        DUALSTACK_REFLECT_MEMBER(notification_id);
+        DUALSTACK_REFLECT_MEMBER(source_id);
+        DUALSTACK_REFLECT_MEMBER(source_component);
+        DUALSTACK_REFLECT_MEMBER(title);
+        DUALSTACK_REFLECT_MEMBER(message);
+        DUALSTACK_REFLECT_MEMBER(detailed_message);
+        DUALSTACK_REFLECT_MEMBER(session_id);
+        DUALSTACK_REFLECT_MEMBER(user_id);
+        DUALSTACK_REFLECT_MEMBER(connection_id);
+        DUALSTACK_REFLECT_MEMBER(error_code);
+        DUALSTACK_REFLECT_MEMBER(error_type);
+        DUALSTACK_REFLECT_MEMBER(resolution_hint);
+        DUALSTACK_REFLECT_MEMBER(affected_components);
+        DUALSTACK_REFLECT_MEMBER(metadata);
+    }
+    
     Notification()
         : category(Category::SYSTEM)
         , severity(Severity::INFO)
@@ -136,6 +199,11 @@ struct AMPHISBAENA_API Notification {
     }
 };
 
+class NotificationAggregator;
+struct AggregationConfig;
+class NotificationTransport;
+struct NotificationTransportConfig;
+
 /**
  * @brief Notification Handler Interface
  * 
@@ -189,9 +257,17 @@ public:
     size_t get_notification_count() const { return notification_count_.load(); }
     size_t get_error_count() const { return error_count_.load(); }
     size_t get_warning_count() const { return warning_count_.load(); }
+    size_t get_suppressed_count() const;
+
+    // Aggregation (coalescing, deduplication and per-category rate limits)
+    void set_aggregation_config(const AggregationConfig& config);
+    AggregationConfig get_aggregation_config() const;
+    void flush_aggregated();
 
     // Configuration
     void set_notification_server_endpoint(const std::string& host, uint16_t port);
+    void set_notification_transport_config(const NotificationTransportConfig& config);
+    NotificationTransport* get_notification_transport() { return transport_.get(); }
     void enable_lamia_backend(bool enable);
 
 private:
@@ -207,6 +283,7 @@ private:
     // Notification server endpoint
     std::string notification_server_host_;
     uint16_t notification_server_port_;
+    std::unique_ptr<NotificationTransport> transport_;
     std::mutex endpoint_mutex_;
     
     // Statistics
@@ -214,7 +291,15 @@ private:
     std::atomic<size_t> error_count_{0};
     std::atomic<size_t> warning_count_{0};
     
+    // Aggregation stage and its summary flusher
+    std::unique_ptr<NotificationAggregator> aggregator_;
+    std::thread aggregation_thread_;
+    std::mutex aggregation_mutex_;
+    std::condition_variable aggregation_cv_;
+    bool aggregation_running_ = false;
+    
     // Internal processing
+    void aggregation_loop();
     void process_notification(const Notification& notification);
     void send_to_lamia_backend(const Notification& notification);
     void send_to_notification_server(const Notification& notification);
@@ -248,6 +333,10 @@ extern "C" {
     
     /**
      * @brief Send notification from Lamia
+     *
+     * Copies the strings into a ring record and returns without taking a lock
+     * or allocating. Returns NOTIFICATION_ERROR_RING_FULL if the dispatcher
+     * has fallen behind; the event is dropped and counted.
      */
     AMPHISBAENA_API int notification_send(NotificationContextHandle ctx,
                                          const char* source_id,
@@ -256,5 +345,28 @@ extern "C" {
                                          uint8_t severity,
                                          const char* title,
                                          const char* message);
+
+    /**
+     * @brief Claim a ring record to fill in place
+     *
+     * Returns nullptr if the ring is full. Every acquired record must be
+     * published promptly; records are dispatched in claim order.
+     */
+    AMPHISBAENA_API NotificationRecord* notification_record_acquire(NotificationContextHandle ctx);
+
+    /**
+     * @brief Hand a filled record to the dispatcher
+     */
+    AMPHISBAENA_API int notification_record_publish(NotificationContextHandle ctx, NotificationRecord* record);
+
+    /**
+     * @brief Block until everything published so far has been dispatched
+     */
+    AMPHISBAENA_API int notification_context_flush(NotificationContextHandle ctx);
+
+    /**
+     * @brief Number of events dropped because the ring was full
+     */
+    AMPHISBAENA_API uint64_t notification_context_dropped(NotificationContextHandle ctx);
 }
 
@@ -0,0 +1,242 @@
+/**
+ * Amphisbaena 🐍 - Stateless IPv4/IPv6 Translation (SIIT)
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Header translation for the virtual network layer:
+ * - IPv4 <-> IPv6 header rewriting per RFC 7915, a batch at a time
+ * - RFC 6052 prefix mapping (64:ff9b::/96 by default, /32 to /96)
+ * - Explicit address mappings (RFC 7757 EAMT) in open-addressing tables,
+ *   consulted before the prefix
+ * - TCP, UDP and ICMP echo checksums adjusted incrementally (RFC 1624)
+ *
+ * Fragments are translated (Fragment header <-> IPv4 fragment fields) but
+ * never created; ICMP errors and IPv4 options are not translated.
+ */
+
+#pragma once
+
+#include "../fix_format_header.h"
+#include "../../../src/core/ip_address.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+
+// Why a packet was not translated
+enum class TranslationError {
+    MALFORMED,      // Truncated or inconsistent header
+    NO_MAPPING,     // Address neither explicitly mapped nor under the prefix
+    TTL_EXPIRED,    // TTL / hop limit would reach zero
+    UNSUPPORTED,    // ICMP errors, IPv4 in IPv6 ICMP, routing headers still in use
+    TOO_BIG         // Output exceeds the output buffer or the IPv4 length field
+};
+
+auto to_string(TranslationError error) -> const char*;
+
+// Translator configuration
+struct SiitConfig {
+    // RFC 6052 prefix; the well-known 64:ff9b::/96 by default
+    std::optional<ipv6_address> prefix = ipv6_address(0x0064FF9B00000000ULL, 0);
+    int prefix_length = 96;                     // 32, 40, 48, 56, 64 or 96
+};
+
+// Per-translator statistics
+struct SiitStats {
+    std::uint64_t translated_to_ipv6;
+    std::uint64_t translated_to_ipv4;
+    std::uint64_t dropped_malformed;
+    std::uint64_t dropped_no_mapping;
+    std::uint64_t dropped_ttl_expired;
+    std::uint64_t dropped_unsupported;
+    std::uint64_t dropped_too_big;
+};
+
+// Packets stored back to back in one buffer, reused across batches
+class PacketBatch {
+private:
+    std::vector<std::byte> data_;                                   // Grows to the high-water mark only
+    std::size_t used_ = 0;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> packets_;  // Offset, length
+
+public:
+    auto clear() -> void;
+    auto add(std::span<const std::byte> packet) -> void;
+
+    // Room for one more packet of up to max_length bytes; commit() keeps the first `length`
+    auto prepare(std::size_t max_length) -> std::span<std::byte>;
+    auto commit(std::size_t length) -> void;
+
+    auto size() const -> std::size_t { return packets_.size(); }
+    auto empty() const -> bool { return packets_.empty(); }
+    auto bytes() const -> std::size_t { return used_; }
+    auto operator[](std::size_t index) const -> std::span<const std::byte> {
+        return {data_.data() + packets_[index].first, packets_[index].second};
+    }
+    auto operator[](std::size_t index) -> std::span<std::byte> {
+        return {data_.data() + packets_[index].first, packets_[index].second};
+    }
+};
+
+// Open-addressing hash table keyed by address: linear probing, no tombstones
+template<typename Key, typename Value, typename Hash>
+class FlatAddressMap {
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        bool used = false;
+    };
+
+    std::vector<Slot> slots_;
+    std::size_t count_ = 0;
+    std::size_t mask_ = 0;
+
+    auto grow() -> void {
+        std::vector<Slot> old = std::move(slots_);
+        slots_.assign(old.empty() ? 16 : old.size() * 2, Slot{});
+        mask_ = slots_.size() - 1;
+        count_ = 0;
+        for (auto& slot : old) {
+            if (slot.used) {
+                insert(slot.key, slot.value);
+            }
+        }
+    }
+
+public:
+    auto find(const Key& key) const -> const Value* {
+        if (count_ == 0) {
+            return nullptr;
+        }
+        for (std::size_t i = Hash{}(key) & mask_;; i = (i + 1) & mask_) {
+            const Slot& slot = slots_[i];
+            if (!slot.used) {
+                return nullptr;
+            }
+            if (slot.key == key) {
+                return &slot.value;
+            }
+        }
+    }
+
+    auto insert(const Key& key, const Value& value) -> void {
+        if ((count_ + 1) * 2 > slots_.size()) {     // Load factor at most 1/2
+            grow();
+        }
+        std::size_t i = Hash{}(key) & mask_;
+        while (slots_[i].used && !(slots_[i].key == key)) {
+            i = (i + 1) & mask_;
+        }
+        if (!slots_[i].used) {
+            ++count_;
+        }
+        slots_[i] = Slot{key, value, true};
+    }
+
+    auto erase(const Key& key) -> bool {
+        if (count_ == 0) {
+            return false;
+        }
+        std::size_t i = Hash{}(key) & mask_;
+        while (slots_[i].used && !(slots_[i].key == key)) {
+            i = (i + 1) & mask_;
+        }
+        if (!slots_[i].used) {
+            return false;
+        }
+        // Shift later members of the probe run back so lookups never stop early
+        for (std::size_t j = (i + 1) & mask_; slots_[j].used; j = (j + 1) & mask_) {
+            std::size_t home = Hash{}(slots_[j].key) & mask_;
+            if (((j - home) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i] = Slot{};
+        --count_;
+        return true;
+    }
+
+    auto size() const -> std::size_t { return count_; }
+};
+
+struct Ipv4AddressHash {
+    auto operator()(std::uint32_t address) const -> std::size_t {
+        return static_cast<std::size_t>((address * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+};
+
+struct Ipv6AddressHash {
+    auto operator()(const ipv6_address& address) const -> std::size_t {
+        std::uint64_t mixed = (address.high ^ (address.low * 0x9E3779B97F4A7C15ULL)) * 0xC2B2AE3D27D4EB4FULL;
+        return static_cast<std::size_t>(mixed ^ (mixed >> 29));
+    }
+};
+
+// Stateless IPv4/IPv6 header translator
+//
+// Translation runs under a shared lock taken once per batch, so mapping
+// changes wait for batches in flight and batches never block each other.
+class SiitTranslator {
+private:
+    mutable std::shared_mutex mutex_;
+    SiitConfig config_;
+    FlatAddressMap<std::uint32_t, ipv6_address, Ipv4AddressHash> ipv4_to_ipv6_;
+    FlatAddressMap<ipv6_address, std::uint32_t, Ipv6AddressHash> ipv6_to_ipv4_;
+
+    std::atomic<std::uint64_t> translated_to_ipv6_{0};
+    std::atomic<std::uint64_t> translated_to_ipv4_{0};
+    std::atomic<std::uint64_t> dropped_[5] = {};            // Indexed by TranslationError
+
+    auto map_to_ipv6(std::uint32_t ipv4) const -> std::optional<ipv6_address>;
+    auto map_to_ipv4(const ipv6_address& ipv6) const -> std::optional<std::uint32_t>;
+    auto ipv4_to_ipv6_locked(std::span<const std::byte> packet, std::span<std::byte> out) const
+        -> std::expected<std::size_t, TranslationError>;
+    auto ipv6_to_ipv4_locked(std::span<const std::byte> packet, std::span<std::byte> out) const
+        -> std::expected<std::size_t, TranslationError>;
+
+public:
+    explicit SiitTranslator(SiitConfig config = {});
+
+    // RFC 6052 prefix; false for an unsupported length
+    auto set_prefix(const ipv6_address& prefix, int prefix_length) -> bool;
+    auto clear_prefix() -> void;
+
+    // Explicit 1:1 mapping, replacing any earlier mapping of either address
+    auto add_mapping(const ipv4_address& ipv4, const ipv6_address& ipv6) -> void;
+    auto remove_mapping(const ipv4_address& ipv4) -> bool;
+    auto find_mapping(const ipv4_address& ipv4) const -> std::optional<ipv6_address>;
+    auto find_mapping(const ipv6_address& ipv6) const -> std::optional<ipv4_address>;
+    auto mapping_count() const -> std::size_t;
+
+    // Address translation as applied to packets: explicit mapping first, then the prefix
+    auto translate_address(const ipv4_address& ipv4) const -> std::optional<ipv6_address>;
+    auto translate_address(const ipv6_address& ipv6) const -> std::optional<ipv4_address>;
+
+    // One packet into `out`, which needs room for the packet plus 28 bytes
+    auto translate_to_ipv6(std::span<const std::byte> packet, std::span<std::byte> out)
+        -> std::expected<std::size_t, TranslationError>;
+    auto translate_to_ipv4(std::span<const std::byte> packet, std::span<std::byte> out)
+        -> std::expected<std::size_t, TranslationError>;
+
+    // Appends each translated packet to `out`, in order; returns how many were translated
+    auto translate_to_ipv6(const PacketBatch& ipv4_packets, PacketBatch& out) -> std::size_t;
+    auto translate_to_ipv4(const PacketBatch& ipv6_packets, PacketBatch& out) -> std::size_t;
+
+    auto get_stats() const -> SiitStats;
+};
+
+// RFC 6052 address synthesis and extraction
+auto embed_ipv4(const ipv6_address& prefix, int prefix_length, const ipv4_address& ipv4) -> ipv6_address;
+auto extract_ipv4(const ipv6_address& prefix, int prefix_length, const ipv6_address& ipv6) -> std::optional<ipv4_address>;
+
+} // namespace network
+} // namespace dualstack
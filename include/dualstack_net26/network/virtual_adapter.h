@@ -9,15 +9,20 @@
  * - Internal virtual network adapters and hubs
  * - Dual-stack IPv4/IPv6 simultaneous support
  * - VPC creation (10.0.0.x) with gateway routing
+ * - VPC address management (IPAM) with dual-stack allocation
  * - Full DNS support (Google DNS + custom)
  * - IPv4/IPv6 validation and linking
+ * - Stateless IPv4/IPv6 packet translation (SIIT/NAT64) over the links
  * - Network card/hub management
+ * - Host interfaces, addresses and routes from netlink (see netlink.h)
  */
 
 #pragma once
 
 #include "../fix_format_header.h"
 #include "../../../src/core/ip_address.h"
+#include "ipam.h"
+#include "siit_translator.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -219,6 +224,7 @@ private:
     
     // VPC management
     std::map<std::string, std::vector<std::string>> vpc_adapters_;  // vpc_id -> adapter_ids
+    std::map<std::string, std::unique_ptr<IpamPool>> vpc_ipam_;     // vpc_id -> address pool
     
     // Adapter counter
     std::atomic<std::uint64_t> adapter_counter_;
@@ -246,10 +252,16 @@ public:
     auto list_hubs() const -> std::vector<std::string>;
     
     // VPC management
-    auto create_vpc(const std::string& vpc_id, const ipv4_address& base_address, int prefix_length = 24) -> std::expected<void, std::string>;
+    // With a /16 to /30 prefix the VPC gets an address pool: adapters created with this
+    // vpc_id and no IPv4 address are given one (and an IPv6 one with ipv6_prefix), and
+    // hand-assigned addresses in the subnet are reserved. Other prefixes make a
+    // membership-only VPC. Membership is always explicit, through add_adapter_to_vpc.
+    auto create_vpc(const std::string& vpc_id, const ipv4_address& base_address, int prefix_length = 24,
+                    std::optional<ipv6_address> ipv6_prefix = std::nullopt, int ipv6_prefix_length = 64) -> std::expected<void, std::string>;
     auto add_adapter_to_vpc(const std::string& adapter_id, const std::string& vpc_id) -> bool;
     auto remove_adapter_from_vpc(const std::string& adapter_id, const std::string& vpc_id) -> bool;
     auto get_vpc_adapters(const std::string& vpc_id) const -> std::vector<std::string>;
+    auto get_vpc_ipam(const std::string& vpc_id) -> IpamPool*;     // nullptr for a membership-only VPC
     
     // Network interface enumeration
     auto enumerate_real_adapters() -> std::vector<NetworkInterface>;
@@ -284,9 +296,8 @@ private:
     std::atomic<std::uint64_t> packets_sent_;
     std::atomic<std::uint64_t> packets_received_;
     
-    // IPv4/IPv6 linking
-    std::map<ipv4_address, ipv6_address> ipv4_to_ipv6_map_;
-    std::map<ipv6_address, ipv4_address> ipv6_to_ipv4_map_;
+    // IPv4/IPv6 linking: explicit mappings and the RFC 6052 prefix
+    SiitTranslator translator_;
     
 public:
     VirtualAdapter(const std::string& adapter_id, const VirtualAdapterConfig& config);
@@ -311,6 +322,12 @@ public:
     auto get_ipv6_for_ipv4(const ipv4_address& ipv4) -> std::optional<ipv6_address>;
     auto get_ipv4_for_ipv6(const ipv6_address& ipv6) -> std::optional<ipv4_address>;
     
+    // Packet translation across the links; translated packets are appended to `out`
+    auto set_translation_prefix(const ipv6_address& prefix, int prefix_length) -> bool;
+    auto translate_to_ipv6(const PacketBatch& ipv4_packets, PacketBatch& out) -> std::size_t;
+    auto translate_to_ipv4(const PacketBatch& ipv6_packets, PacketBatch& out) -> std::size_t;
+    auto get_translator() -> SiitTranslator& { return translator_; }
+    
     // Statistics
     auto get_statistics() const -> NetworkInterface;
     
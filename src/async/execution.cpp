@@ -89,6 +89,18 @@ auto async_connect(Scheduler&& sched, const IPAddress& addr, port_t port)
         });
 }
 
+// Async same-host connect implementation
+template<typename Scheduler>
+auto async_connect(Scheduler&& sched, const UnixEndpoint& endpoint, local_socket_type type)
+    -> std::execution::sender auto {
+    return std::execution::just()
+        | std::execution::then([endpoint, type]() {
+            Socket socket;
+            auto result = socket.connect(endpoint, type);
+            return std::make_pair(std::move(socket), result);
+        });
+}
+
 // Async send operation implementation
 template<typename Scheduler>
 auto async_send(Scheduler&& sched, Socket& socket, buffer_t data)
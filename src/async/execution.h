@@ -56,6 +56,11 @@ template<typename Scheduler>
 auto async_connect(Scheduler&& sched, const IPAddress& addr, port_t port)
     -> std::execution::sender auto;
 
+// Async same-host connect over AF_UNIX
+template<typename Scheduler>
+auto async_connect(Scheduler&& sched, const UnixEndpoint& endpoint, local_socket_type type)
+    -> std::execution::sender auto;
+
 // Async send operation
 template<typename Scheduler>
 auto async_send(Scheduler&& sched, Socket& socket, buffer_t data)
@@ -27,13 +27,46 @@ using ::make_unexpected_value;
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <poll.h>
 #endif
 
 namespace dualstack {
 
+#ifndef _WIN32
+namespace {
+
+// A socket file nobody is listening on was left by a process that died
+// without cleaning up; anything else at the path is not ours to remove
+auto remove_stale_socket(const std::string& path, int socket_type,
+                         const sockaddr_storage& addr_storage, socklen_t addr_len) -> bool {
+    struct stat info{};
+    if (::lstat(path.c_str(), &info) != 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        return false;
+    }
+    int probe = ::socket(AF_UNIX, socket_type, 0);
+    if (probe == -1) {
+        return false;
+    }
+    bool live = ::connect(probe, reinterpret_cast<const sockaddr*>(&addr_storage), addr_len) == 0;
+    int probe_error = errno;
+    ::close(probe);
+    if (live || probe_error != ECONNREFUSED) {
+        return false;
+    }
+    return ::unlink(path.c_str()) == 0;
+}
+
+} // namespace
+#endif
+
 // Acceptor implementation
 Acceptor::Acceptor() : is_listening_(false) {}
 
@@ -52,8 +85,11 @@ Acceptor::~Acceptor() {
 
 Acceptor::Acceptor(Acceptor&& other) noexcept 
     : listen_socket_(std::move(other.listen_socket_)), 
-      is_listening_(other.is_listening_) {
+      is_listening_(other.is_listening_),
+      non_blocking_(other.non_blocking_),
+      unix_path_(std::move(other.unix_path_)) {
     other.is_listening_ = false;
+    other.unix_path_.clear();
 }
 
 auto Acceptor::operator=(Acceptor&& other) noexcept -> Acceptor& {
@@ -63,19 +99,26 @@ auto Acceptor::operator=(Acceptor&& other) noexcept -> Acceptor& {
         }
         listen_socket_ = std::move(other.listen_socket_);
         is_listening_ = other.is_listening_;
+        non_blocking_ = other.non_blocking_;
+        unix_path_ = std::move(other.unix_path_);
         other.is_listening_ = false;
+        other.unix_path_.clear();
     }
     return *this;
 }
 
 auto Acceptor::listen(port_t port, const IPAddress& bind_addr) -> error_code {
     // Create listening socket
-    auto socket_result = create_tcp_socket();
-    if (!socket_result.has_value()) {
-        return socket_result.error();
+    // The default (unspecified) address listens dual-stack on AF_INET6; an
+    // explicit IPv4 address gets an AF_INET socket
+    bool bind_any = bind_addr.is_ipv4() && bind_addr.get_ipv4().address == 0;
+    bool ipv4_only = bind_addr.is_ipv4() && !bind_any;
+    auto handle = ::socket(ipv4_only ? AF_INET : AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == static_cast<decltype(handle)>(-1)) {
+        return error_code::bind_failed;
     }
     
-    listen_socket_ = std::move(socket_result.value());
+    listen_socket_ = Socket(static_cast<native_socket_handle>(handle), true);
     
     // Enable reuse address
     auto reuse_result = listen_socket_.set_reuse_address(true);
@@ -84,16 +127,18 @@ auto Acceptor::listen(port_t port, const IPAddress& bind_addr) -> error_code {
     }
     
     // Enable dual-stack support
-    auto dual_stack_result = enable_dual_stack(true);
-    if (dual_stack_result != error_code::success) {
-        return dual_stack_result;
+    if (!ipv4_only) {
+        auto dual_stack_result = enable_dual_stack(true);
+        if (dual_stack_result != error_code::success) {
+            return dual_stack_result;
+        }
     }
     
     // Bind to address
     sockaddr_storage addr_storage;
     socklen_t addr_len;
     
-    if (bind_addr.is_ipv4() || bind_addr.is_ipv6()) {
+    if (!bind_any) {
         ip_to_sockaddr(bind_addr, port, addr_storage, addr_len);
     } else {
         // Bind to all interfaces
@@ -120,11 +165,108 @@ auto Acceptor::listen(port_t port, const IPAddress& bind_addr) -> error_code {
     return error_code::success;
 }
 
+auto Acceptor::listen(const UnixEndpoint& endpoint, local_socket_type type) -> error_code {
+    sockaddr_storage addr_storage;
+    socklen_t addr_len;
+    if (!unix_to_sockaddr(endpoint, addr_storage, addr_len)) {
+        return error_code::invalid_address;
+    }
+    
+#ifdef _WIN32
+    (void)type;
+    return error_code::bind_failed;
+#else
+    int socket_type = type == local_socket_type::seqpacket ? SOCK_SEQPACKET : SOCK_STREAM;
+    auto handle = ::socket(AF_UNIX, socket_type, 0);
+    if (handle == -1) {
+        return error_code::bind_failed;
+    }
+    
+    listen_socket_ = Socket(static_cast<native_socket_handle>(handle), true);
+    
+    // Abstract names vanish with their socket, so only files can go stale
+    if (!endpoint.is_abstract() && !remove_stale_socket(endpoint.path, socket_type, addr_storage, addr_len)) {
+        listen_socket_.disconnect();
+        return error_code::bind_failed;
+    }
+    
+    if (::bind(handle, reinterpret_cast<const sockaddr*>(&addr_storage), addr_len) == -1) {
+        listen_socket_.disconnect();
+        return error_code::bind_failed;
+    }
+    
+    if (::listen(handle, SOMAXCONN) == -1) {
+        listen_socket_.disconnect();
+        if (!endpoint.is_abstract()) {
+            ::unlink(endpoint.path.c_str());
+        }
+        return error_code::listen_failed;
+    }
+    
+    if (!endpoint.is_abstract()) {
+        unix_path_ = endpoint.path;
+    }
+    is_listening_ = true;
+    return error_code::success;
+#endif
+}
+
 auto Acceptor::stop_listening() -> void {
+    if (is_listening_) {
+        // Shut down first so a thread blocked in accept() returns
+#ifdef _WIN32
+        ::shutdown(static_cast<SOCKET>(listen_socket_.get_native_handle()), SD_BOTH);
+#else
+        ::shutdown(static_cast<int>(listen_socket_.get_native_handle()), SHUT_RDWR);
+#endif
+        listen_socket_.disconnect();
+        is_listening_ = false;
+#ifndef _WIN32
+        if (!unix_path_.empty()) {
+            ::unlink(unix_path_.c_str());
+        }
+#endif
+        unix_path_.clear();
+    }
+}
+
+auto Acceptor::detach() -> void {
     if (is_listening_) {
         listen_socket_.disconnect();
         is_listening_ = false;
+        // The file now belongs to whichever process still holds the listener
+        unix_path_.clear();
+    }
+}
+
+auto Acceptor::adopt(native_socket_handle handle) -> std::expected<Acceptor, error_code> {
+    Acceptor acceptor;
+    acceptor.listen_socket_ = Socket(handle, true);
+    int listening = 0;
+    socklen_t length = sizeof(listening);
+    if (::getsockopt(static_cast<int>(handle), SOL_SOCKET, SO_ACCEPTCONN,
+                     reinterpret_cast<char*>(&listening), &length) == -1 || !listening) {
+        return std::unexpected<error_code>(error_code::invalid_address);
+    }
+    acceptor.is_listening_ = true;
+    return acceptor;
+}
+
+auto Acceptor::wait_for_connection(std::chrono::milliseconds timeout) -> bool {
+    if (!is_listening_) {
+        return false;
     }
+#ifdef _WIN32
+    WSAPOLLFD entry{};
+    entry.fd = static_cast<SOCKET>(listen_socket_.get_native_handle());
+    entry.events = POLLRDNORM;
+    return WSAPoll(&entry, 1, static_cast<int>(timeout.count())) > 0;
+#else
+    pollfd entry{};
+    entry.fd = static_cast<int>(listen_socket_.get_native_handle());
+    entry.events = POLLIN;
+    return ::poll(&entry, 1, static_cast<int>(timeout.count())) > 0;
+#endif
 }
 
 auto Acceptor::accept() -> std::expected<Socket, error_code> {
@@ -153,10 +295,37 @@ auto Acceptor::accept() -> std::expected<Socket, error_code> {
     
     // Create new socket object from accepted handle
     Socket new_socket(static_cast<native_socket_handle>(new_socket_handle), true);
+#if !defined(__linux__)
+    // BSD and Windows copy the listener's O_NONBLOCK onto accepted sockets
+    if (non_blocking_) {
+        new_socket.set_non_blocking(false);
+    }
+#endif
     
     return new_socket;
 }
 
+auto Acceptor::local_port() const -> port_t {
+    if (!is_listening_) {
+        return 0;
+    }
+    
+    sockaddr_storage addr_storage;
+    socklen_t addr_len = sizeof(addr_storage);
+    if (::getsockname(static_cast<int>(listen_socket_.get_native_handle()),
+                      reinterpret_cast<sockaddr*>(&addr_storage), &addr_len) == -1) {
+        return 0;
+    }
+    
+    if (addr_storage.ss_family == AF_INET) {
+        return ntohs(reinterpret_cast<const sockaddr_in*>(&addr_storage)->sin_port);
+    }
+    if (addr_storage.ss_family != AF_INET6) {
+        return 0;
+    }
+    return ntohs(reinterpret_cast<const sockaddr_in6*>(&addr_storage)->sin6_port);
+}
+
 auto Acceptor::bind_to_interface(const IPAddress& addr [[maybe_unused]]) -> error_code {
     // This would be implemented to bind to specific interfaces
     return error_code::success;
@@ -191,6 +360,14 @@ auto Acceptor::enable_dual_stack(bool enable) -> error_code {
     return error_code::success;
 }
 
+auto Acceptor::set_non_blocking(bool non_blocking) -> error_code {
+    auto result = listen_socket_.set_non_blocking(non_blocking);
+    if (result == error_code::success) {
+        non_blocking_ = non_blocking;
+    }
+    return result;
+}
+
 // Helper function
 auto create_acceptor(port_t port) -> std::expected<Acceptor, error_code> {
     Acceptor acceptor;
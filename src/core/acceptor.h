@@ -4,7 +4,9 @@
 
 #include "socket.h"
 #include <memory>
+#include <chrono>
 #include <expected>
+#include <string>
 
 namespace dualstack {
 
@@ -12,6 +14,8 @@ class Acceptor {
 private:
     Socket listen_socket_;
     bool is_listening_;
+    bool non_blocking_ = false;
+    std::string unix_path_;     // Socket file to remove on stop_listening()
     
 public:
     // Constructors
@@ -29,10 +33,22 @@ public:
     
     // Listening operations
     [[nodiscard]] auto listen(port_t port, const IPAddress& bind_addr = {}) -> error_code;
+    // Same-host listener over AF_UNIX (POSIX only). A socket file left by a
+    // process that died is replaced; a live listener or any other file is not
+    [[nodiscard]] auto listen(const UnixEndpoint& endpoint,
+                              local_socket_type type = local_socket_type::stream) -> error_code;
     auto stop_listening() -> void;
+    // Close this descriptor without shutdown(), so copies held by another
+    // process (hot restart) keep accepting from the same queue
+    auto detach() -> void;
+
+    // Take over a listening socket inherited from another process
+    [[nodiscard]] static auto adopt(native_socket_handle handle) -> std::expected<Acceptor, error_code>;
     
     // Connection acceptance
     [[nodiscard]] auto accept() -> std::expected<Socket, error_code>;
+    // Wait until accept() will not block; false on timeout
+    auto wait_for_connection(std::chrono::milliseconds timeout) -> bool;
     
     // Asynchronous operations using std::execution (C++26)
 #if __cpp_lib_execution >= 202300L
@@ -42,10 +58,14 @@ public:
     // Listen with async callback
     template<typename Receiver>
     auto async_listen(port_t port, Receiver&& receiver) -> std::execution::sender auto;
+    template<typename Receiver>
+    auto async_listen(const UnixEndpoint& endpoint, Receiver&& receiver) -> std::execution::sender auto;
 #endif
     
     // Utility methods
     bool is_listening() const { return is_listening_; }
+    auto local_port() const -> port_t;  // Bound port, useful after listen(0); 0 for AF_UNIX
+    auto native_handle() const -> native_socket_handle { return listen_socket_.get_native_handle(); }
     
     // Socket binding helpers
     [[nodiscard]] auto bind_to_interface(const IPAddress& addr) -> error_code;
@@ -54,6 +74,8 @@ public:
     // Configuration
     auto set_backlog(int backlog) -> error_code;
     auto enable_dual_stack(bool enable = true) -> error_code;
+    // Accepted sockets stay blocking either way
+    auto set_non_blocking(bool non_blocking) -> error_code;
 };
 
 // Helper function for acceptor creation
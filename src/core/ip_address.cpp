@@ -124,11 +124,7 @@ auto ipv6_address::to_string() const -> std::string {
     bool compressed = false;
     for (std::size_t i = 0; i < 8; ++i) {
         if (i == compress_start && compress_len > 0) {
-            if (i == 0) {
-                oss << "::";
-            } else {
-                oss << ":";
-            }
+            oss << "::";
             i += compress_len - 1;
             compressed = true;
         } else {
@@ -210,7 +206,8 @@ auto ipv6_address::from_string(std::string_view str) -> dualstack_expected::expe
     }
         
         words[word_index++] = word;
-        parse_pos = colon_pos + 1;
+        // Stop on the first ':' of a "::" so the compression branch sees it
+        parse_pos = colon_pos == compress_pos ? colon_pos : colon_pos + 1;
         
         if (parse_pos > str.length()) break;
     }
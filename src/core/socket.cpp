@@ -13,6 +13,7 @@
 #include "../../include/dualstack_net26/fix_format_header.h"
 #include "socket.h"
 #include "ip_address.h"
+#include <cstddef>
 #include <cstring>
 
 using ::make_unexpected_value;
@@ -27,6 +28,8 @@ using ::make_unexpected_value;
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/un.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -54,14 +57,11 @@ auto ip_to_sockaddr(const IPAddress& ip, port_t port, sockaddr_storage& addr, so
         addr6->sin6_port = htons(port);
         // Convert IPv6 address from our format to in6_addr
         auto ipv6 = ip.get_ipv6();
+        // high holds bytes 0-7 and low bytes 8-15, both in network order
         std::uint8_t* bytes = reinterpret_cast<std::uint8_t*>(&addr6->sin6_addr);
         for (std::size_t i = 0; i < 8; ++i) {
-            bytes[i * 2] = (ipv6.high >> (56 - i * 8)) & 0xFF;
-            bytes[i * 2 + 1] = (ipv6.high >> (56 - i * 8 - 8)) & 0xFF;
-        }
-        for (std::size_t i = 0; i < 8; ++i) {
-            bytes[16 + i * 2] = (ipv6.low >> (56 - i * 8)) & 0xFF;
-            bytes[16 + i * 2 + 1] = (ipv6.low >> (56 - i * 8 - 8)) & 0xFF;
+            bytes[i] = static_cast<std::uint8_t>((ipv6.high >> (56 - i * 8)) & 0xFF);
+            bytes[8 + i] = static_cast<std::uint8_t>((ipv6.low >> (56 - i * 8)) & 0xFF);
         }
         addr_len = sizeof(sockaddr_in6);
     }
@@ -80,18 +80,55 @@ auto sockaddr_to_ip(const sockaddr_storage& addr) -> std::expected<IPAddress, er
         std::uint64_t high = 0;
         std::uint64_t low = 0;
         for (std::size_t i = 0; i < 8; ++i) {
-            high |= (static_cast<std::uint64_t>(bytes[i * 2]) << (56 - i * 8));
-            high |= (static_cast<std::uint64_t>(bytes[i * 2 + 1]) << (56 - i * 8 - 8));
-        }
-        for (std::size_t i = 0; i < 8; ++i) {
-            low |= (static_cast<std::uint64_t>(bytes[16 + i * 2]) << (56 - i * 8));
-            low |= (static_cast<std::uint64_t>(bytes[16 + i * 2 + 1]) << (56 - i * 8 - 8));
+            high |= (static_cast<std::uint64_t>(bytes[i]) << (56 - i * 8));
+            low |= (static_cast<std::uint64_t>(bytes[8 + i]) << (56 - i * 8));
         }
         return IPAddress(ipv6_address(high, low));
     }
     return std::unexpected<error_code>(error_code::invalid_address);
 }
 
+// Report IPv4 peers of a dual-stack socket as IPv4
+auto unmap_ipv4(const IPAddress& addr) -> IPAddress {
+    if (addr.is_ipv6() && addr.get_ipv6().high == 0 &&
+        (addr.get_ipv6().low >> 32) == 0x0000FFFFULL) {
+        return IPAddress(ipv4_address(static_cast<std::uint32_t>(addr.get_ipv6().low)));
+    }
+    return addr;
+}
+
+// Helper function to convert a UnixEndpoint to sockaddr_storage
+auto unix_to_sockaddr(const UnixEndpoint& endpoint, sockaddr_storage& addr, socklen_t& addr_len) -> bool {
+#ifdef _WIN32
+    (void)endpoint;
+    (void)addr;
+    (void)addr_len;
+    return false;
+#else
+    std::memset(&addr, 0, sizeof(addr));
+    auto* addr_un = reinterpret_cast<sockaddr_un*>(&addr);
+    addr_un->sun_family = AF_UNIX;
+    const std::string& path = endpoint.path;
+    if (path.empty() || path.size() >= sizeof(addr_un->sun_path)) {
+        return false;
+    }
+    if (endpoint.is_abstract()) {
+#if defined(__linux__)
+        // Leading NUL selects the abstract namespace; the length, not a
+        // terminator, delimits the name
+        std::memcpy(addr_un->sun_path + 1, path.data() + 1, path.size() - 1);
+        addr_len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+        return true;
+#else
+        return false;
+#endif
+    }
+    std::memcpy(addr_un->sun_path, path.data(), path.size());
+    addr_len = static_cast<socklen_t>(sizeof(sockaddr_un));
+    return true;
+#endif
+}
+
 // Socket implementation
 Socket::Socket() : handle_(0), is_open_(false), owns_handle_(false) {
 #ifdef _WIN32
@@ -127,10 +164,11 @@ Socket::~Socket() {
 }
 
 Socket::Socket(Socket&& other) noexcept 
-    : handle_(other.handle_), is_open_(other.is_open_), owns_handle_(other.owns_handle_) {
+    : handle_(other.handle_), is_open_(other.is_open_), owns_handle_(other.owns_handle_), family_(other.family_) {
     other.handle_ = 0;
     other.is_open_ = false;
     other.owns_handle_ = false;
+    other.family_ = 0;
 }
 
 auto Socket::operator=(Socket&& other) noexcept -> Socket& {
@@ -141,9 +179,11 @@ auto Socket::operator=(Socket&& other) noexcept -> Socket& {
         handle_ = other.handle_;
         is_open_ = other.is_open_;
         owns_handle_ = other.owns_handle_;
+        family_ = other.family_;
         other.handle_ = 0;
         other.is_open_ = false;
         other.owns_handle_ = false;
+        other.family_ = 0;
     }
     return *this;
 }
@@ -151,17 +191,22 @@ auto Socket::operator=(Socket&& other) noexcept -> Socket& {
 auto Socket::connect(const IPAddress& addr, port_t port) -> error_code {
     // Create socket if not already open
     if (!is_open_) {
-        handle_ = ::socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+        // Socket family must match the destination address family
+        int family = addr.is_ipv4() ? AF_INET : AF_INET6;
+        handle_ = ::socket(family, SOCK_STREAM, IPPROTO_TCP);
         if (handle_ == static_cast<native_socket_handle>(-1)) {
             return error_code::connection_failed;
         }
         is_open_ = true;
         owns_handle_ = true;
+        family_ = family;
         
-        // Enable dual-stack support (IPv6 socket can accept IPv4 connections)
-        int ipv6_only = 0;
-        setsockopt(static_cast<int>(handle_), IPPROTO_IPV6, IPV6_V6ONLY, 
-                   reinterpret_cast<const char*>(&ipv6_only), sizeof(ipv6_only));
+        if (family == AF_INET6) {
+            // Enable dual-stack support (IPv6 socket can accept IPv4 connections)
+            int ipv6_only = 0;
+            setsockopt(static_cast<int>(handle_), IPPROTO_IPV6, IPV6_V6ONLY, 
+                       reinterpret_cast<const char*>(&ipv6_only), sizeof(ipv6_only));
+        }
     }
     
     // Convert address
@@ -178,6 +223,36 @@ auto Socket::connect(const IPAddress& addr, port_t port) -> error_code {
     return error_code::success;
 }
 
+auto Socket::connect(const UnixEndpoint& endpoint, local_socket_type type) -> error_code {
+    sockaddr_storage addr_storage;
+    socklen_t addr_len;
+    if (!unix_to_sockaddr(endpoint, addr_storage, addr_len)) {
+        return error_code::invalid_address;
+    }
+    
+#ifdef _WIN32
+    (void)type;
+    return error_code::invalid_address;
+#else
+    if (!is_open_) {
+        handle_ = ::socket(AF_UNIX, type == local_socket_type::seqpacket ? SOCK_SEQPACKET : SOCK_STREAM, 0);
+        if (handle_ == static_cast<native_socket_handle>(-1)) {
+            return error_code::connection_failed;
+        }
+        is_open_ = true;
+        owns_handle_ = true;
+        family_ = AF_UNIX;
+    }
+    
+    if (::connect(static_cast<int>(handle_), 
+                  reinterpret_cast<const sockaddr*>(&addr_storage), addr_len) == -1) {
+        return error_code::connection_failed;
+    }
+    
+    return error_code::success;
+#endif
+}
+
 auto Socket::disconnect() -> void {
     if (is_open_ && owns_handle_) {
 #ifdef _WIN32
@@ -187,6 +262,7 @@ auto Socket::disconnect() -> void {
 #endif
         is_open_ = false;
         handle_ = 0;
+        family_ = 0;
     }
 }
 
@@ -195,9 +271,15 @@ auto Socket::send(buffer_t data) -> std::size_t {
         return 0;
     }
     
+#ifdef MSG_NOSIGNAL
+    // A peer reset must surface as a failed send, not SIGPIPE
+    constexpr int send_flags = MSG_NOSIGNAL;
+#else
+    constexpr int send_flags = 0;
+#endif
     auto result = ::send(static_cast<int>(handle_), 
                         reinterpret_cast<const char*>(data.data()), 
-                        static_cast<int>(data.size()), 0);
+                        static_cast<int>(data.size()), send_flags);
     
     if (result == -1) {
         return 0;
@@ -222,6 +304,258 @@ auto Socket::receive(buffer_t buffer) -> std::size_t {
     return static_cast<std::size_t>(result);
 }
 
+auto Socket::open_datagram(bool ipv6) -> error_code {
+    if (is_open_) {
+        disconnect();
+    }
+    
+    int family = ipv6 ? AF_INET6 : AF_INET;
+    handle_ = ::socket(family, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle_ == static_cast<native_socket_handle>(-1)) {
+        handle_ = 0;
+        return error_code::bind_failed;
+    }
+    is_open_ = true;
+    owns_handle_ = true;
+    family_ = family;
+    
+    if (ipv6) {
+        int ipv6_only = 0;
+        setsockopt(static_cast<int>(handle_), IPPROTO_IPV6, IPV6_V6ONLY, 
+                   reinterpret_cast<const char*>(&ipv6_only), sizeof(ipv6_only));
+    }
+    
+    return error_code::success;
+}
+
+// IPv4 peers of a dual-stack IPv6 socket are addressed as ::ffff:a.b.c.d
+static auto datagram_sockaddr(int family, const IPAddress& ip, port_t port,
+                              sockaddr_storage& addr, socklen_t& addr_len) -> void {
+    if (family == AF_INET6 && ip.is_ipv4()) {
+        std::uint32_t v4 = ip.get_ipv4().address;
+        ipv6_address mapped = v4 == 0 ? ipv6_address() : ipv6_address(0, 0x0000FFFF00000000ULL | v4);
+        ip_to_sockaddr(IPAddress(mapped), port, addr, addr_len);
+    } else {
+        ip_to_sockaddr(ip, port, addr, addr_len);
+    }
+}
+
+auto Socket::bind(const IPAddress& addr, port_t port) -> error_code {
+    if (!is_open_) {
+        return error_code::bind_failed;
+    }
+    
+    sockaddr_storage addr_storage;
+    socklen_t addr_len;
+    datagram_sockaddr(family(), addr, port, addr_storage, addr_len);
+    if (::bind(static_cast<int>(handle_), 
+               reinterpret_cast<const sockaddr*>(&addr_storage), addr_len) == -1) {
+        return error_code::bind_failed;
+    }
+    
+    return error_code::success;
+}
+
+auto Socket::send_to(buffer_t data, const IPAddress& addr, port_t port) -> std::size_t {
+    if (!is_open_) {
+        return 0;
+    }
+    
+    sockaddr_storage addr_storage;
+    socklen_t addr_len;
+    datagram_sockaddr(family(), addr, port, addr_storage, addr_len);
+    auto result = ::sendto(static_cast<int>(handle_), 
+                           reinterpret_cast<const char*>(data.data()), 
+                           static_cast<int>(data.size()), 0,
+                           reinterpret_cast<const sockaddr*>(&addr_storage), addr_len);
+    
+    if (result == -1) {
+        return 0;
+    }
+    
+    return static_cast<std::size_t>(result);
+}
+
+auto Socket::receive_from(buffer_t buffer, IPAddress& addr, port_t& port) -> std::size_t {
+    if (!is_open_) {
+        return 0;
+    }
+    
+    sockaddr_storage addr_storage;
+    socklen_t addr_len = sizeof(addr_storage);
+    auto result = ::recvfrom(static_cast<int>(handle_), 
+                             const_cast<char*>(reinterpret_cast<const char*>(buffer.data())), 
+                             static_cast<int>(buffer.size()), 0,
+                             reinterpret_cast<sockaddr*>(&addr_storage), &addr_len);
+    
+    if (result == -1) {
+        return 0;
+    }
+    
+    if (addr_storage.ss_family == AF_INET) {
+        port = ntohs(reinterpret_cast<const sockaddr_in*>(&addr_storage)->sin_port);
+    } else if (addr_storage.ss_family == AF_INET6) {
+        port = ntohs(reinterpret_cast<const sockaddr_in6*>(&addr_storage)->sin6_port);
+    }
+    if (auto ip = sockaddr_to_ip(addr_storage)) {
+        addr = unmap_ipv4(*ip);
+    }
+    
+    return static_cast<std::size_t>(result);
+}
+
+auto Socket::local_port() const -> port_t {
+    if (!is_open_) {
+        return 0;
+    }
+    
+    sockaddr_storage addr_storage;
+    socklen_t addr_len = sizeof(addr_storage);
+    if (::getsockname(static_cast<int>(handle_), 
+                      reinterpret_cast<sockaddr*>(&addr_storage), &addr_len) == -1) {
+        return 0;
+    }
+    
+    if (addr_storage.ss_family == AF_INET) {
+        return ntohs(reinterpret_cast<const sockaddr_in*>(&addr_storage)->sin_port);
+    }
+    if (addr_storage.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(&addr_storage)->sin6_port);
+    }
+    return 0;
+}
+
+auto Socket::peer_address() const -> std::expected<IPAddress, error_code> {
+    if (!is_open_) {
+        return std::unexpected<error_code>(error_code::invalid_address);
+    }
+    
+    sockaddr_storage addr_storage;
+    socklen_t addr_len = sizeof(addr_storage);
+    if (::getpeername(static_cast<int>(handle_), 
+                      reinterpret_cast<sockaddr*>(&addr_storage), &addr_len) == -1) {
+        return std::unexpected<error_code>(error_code::invalid_address);
+    }
+    auto ip = sockaddr_to_ip(addr_storage);
+    if (!ip) {
+        return ip;
+    }
+    return unmap_ipv4(*ip);
+}
+
+auto Socket::family() -> int {
+    if (!is_open_) {
+        return 0;
+    }
+    
+    if (family_ == 0) {
+        sockaddr_storage addr_storage;
+        socklen_t addr_len = sizeof(addr_storage);
+        if (::getsockname(static_cast<int>(handle_), 
+                          reinterpret_cast<sockaddr*>(&addr_storage), &addr_len) == 0) {
+            family_ = addr_storage.ss_family;
+        }
+    }
+    
+    return family_;
+}
+
+auto Socket::peer_credentials() const -> std::expected<PeerCredentials, error_code> {
+    if (!is_open_) {
+        return std::unexpected<error_code>(error_code::invalid_address);
+    }
+    
+    PeerCredentials credentials;
+#if defined(__linux__)
+    ucred peer{};
+    socklen_t length = sizeof(peer);
+    if (::getsockopt(static_cast<int>(handle_), SOL_SOCKET, SO_PEERCRED, &peer, &length) == -1) {
+        return std::unexpected<error_code>(error_code::invalid_address);
+    }
+    credentials.pid = static_cast<std::int32_t>(peer.pid);
+    credentials.uid = static_cast<std::uint32_t>(peer.uid);
+    credentials.gid = static_cast<std::uint32_t>(peer.gid);
+#elif !defined(_WIN32)
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (::getpeereid(static_cast<int>(handle_), &uid, &gid) == -1) {
+        return std::unexpected<error_code>(error_code::invalid_address);
+    }
+    credentials.uid = static_cast<std::uint32_t>(uid);
+    credentials.gid = static_cast<std::uint32_t>(gid);
+#else
+    return std::unexpected<error_code>(error_code::invalid_address);
+#endif
+    
+    return credentials;
+}
+
+auto Socket::set_pass_credentials(bool pass) -> error_code {
+    if (!is_open_) {
+        return error_code::invalid_address;
+    }
+    
+#if defined(__linux__)
+    int optval = pass ? 1 : 0;
+    if (setsockopt(static_cast<int>(handle_), SOL_SOCKET, SO_PASSCRED, &optval, sizeof(optval)) == -1) {
+        return error_code::invalid_address;
+    }
+#else
+    (void)pass;
+#endif
+    
+    return error_code::success;
+}
+
+auto Socket::receive_with_credentials(buffer_t buffer, PeerCredentials& sender) -> std::size_t {
+    if (!is_open_) {
+        return 0;
+    }
+    
+#if defined(__linux__)
+    iovec vector{const_cast<std::byte*>(buffer.data()), buffer.size()};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(ucred))];
+    msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    
+    auto result = ::recvmsg(static_cast<int>(handle_), &message, 0);
+    if (result <= 0) {
+        return 0;
+    }
+    
+    bool attached = false;
+    for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_CREDENTIALS) {
+            ucred peer{};
+            std::memcpy(&peer, CMSG_DATA(header), sizeof(peer));
+            sender.pid = static_cast<std::int32_t>(peer.pid);
+            sender.uid = static_cast<std::uint32_t>(peer.uid);
+            sender.gid = static_cast<std::uint32_t>(peer.gid);
+            attached = true;
+        }
+    }
+    if (!attached) {
+        // SO_PASSCRED was not set; the connecting peer is the next best answer
+        if (auto peer = peer_credentials()) {
+            sender = *peer;
+        }
+    }
+    
+    return static_cast<std::size_t>(result);
+#else
+    auto received = receive(buffer);
+    if (received != 0) {
+        if (auto peer = peer_credentials()) {
+            sender = *peer;
+        }
+    }
+    return received;
+#endif
+}
+
 auto Socket::set_reuse_address(bool reuse) -> error_code {
     if (!is_open_) {
         return error_code::invalid_address;
@@ -269,8 +603,12 @@ auto create_tcp_socket() -> std::expected<Socket, error_code> {
 }
 
 auto create_udp_socket() -> std::expected<Socket, error_code> {
-    // Not implemented yet
-    return std::unexpected<error_code>(error_code::invalid_address);
+    Socket socket;
+    auto result = socket.open_datagram(true);
+    if (result != error_code::success) {
+        return std::unexpected<error_code>(result);
+    }
+    return socket;
 }
 
 } // namespace dualstack
\ No newline at end of file
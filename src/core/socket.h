@@ -6,6 +6,9 @@
 #include <memory>
 #include <cstdint>
 #include <cstddef>
+#include <expected>
+#include <string>
+#include <utility>
 #include <vector>
 
 #ifdef _WIN32
@@ -57,6 +60,36 @@ using socklen_t = int;
 auto ip_to_sockaddr(const IPAddress& ip, port_t port, sockaddr_storage& addr, socklen_t& addr_len) -> void;
 auto sockaddr_to_ip(const sockaddr_storage& addr, socklen_t addr_len, IPAddress& ip, port_t& port) -> void;
 
+// Same-host (AF_UNIX) endpoint. A path starting with '@' names a socket in
+// the Linux abstract namespace: nothing on disk, and the name is released
+// with the last socket, so a crashed daemon leaves nothing behind.
+struct UnixEndpoint {
+    std::string path;
+
+    UnixEndpoint() = default;
+    UnixEndpoint(std::string endpoint_path) : path(std::move(endpoint_path)) {}
+    UnixEndpoint(const char* endpoint_path) : path(endpoint_path) {}
+
+    bool is_abstract() const { return !path.empty() && path.front() == '@'; }
+};
+
+// stream behaves like TCP; seqpacket keeps message boundaries, so each
+// receive() returns exactly what one send() wrote
+enum class local_socket_type : int {
+    stream = 0,
+    seqpacket = 1
+};
+
+// Process at the other end of a Unix socket, as reported by the kernel
+struct PeerCredentials {
+    std::int32_t pid = 0;   // 0 where the platform does not report it
+    std::uint32_t uid = 0;
+    std::uint32_t gid = 0;
+};
+
+// False for an empty or over-long path, or an abstract name off Linux
+auto unix_to_sockaddr(const UnixEndpoint& endpoint, sockaddr_storage& addr, socklen_t& addr_len) -> bool;
+
 // Native socket handle (platform-specific)
 #ifdef _WIN32
 using native_socket_handle = std::uintptr_t;
@@ -82,6 +115,7 @@ private:
     native_socket_handle handle_;
     bool is_open_;
     bool owns_handle_;  // Track if we own the handle (for move semantics)
+    int family_ = 0;    // AF_* of the handle; looked up on first use for adopted handles
     
 public:
     // Constructors
@@ -99,15 +133,40 @@ public:
     
     // Connection operations
     [[nodiscard]] auto connect(const IPAddress& addr, port_t port) -> error_code;
+    // Same-host connection over AF_UNIX, bypassing the TCP stack (POSIX only)
+    [[nodiscard]] auto connect(const UnixEndpoint& endpoint,
+                               local_socket_type type = local_socket_type::stream) -> error_code;
     auto disconnect() -> void;
     
     // Data transfer
     [[nodiscard]] auto send(buffer_t data) -> std::size_t;
     [[nodiscard]] auto receive(buffer_t buffer) -> std::size_t;
     
+    // Datagram (UDP) operations
+    // Unconnected UDP socket; an IPv6 one is dual-stack and also reaches IPv4 peers
+    [[nodiscard]] auto open_datagram(bool ipv6 = true) -> error_code;
+    [[nodiscard]] auto bind(const IPAddress& addr, port_t port) -> error_code;
+    [[nodiscard]] auto send_to(buffer_t data, const IPAddress& addr, port_t port) -> std::size_t;
+    // One datagram; a longer one is truncated to the buffer
+    [[nodiscard]] auto receive_from(buffer_t buffer, IPAddress& addr, port_t& port) -> std::size_t;
+    
+    // Credential passing (AF_UNIX only)
+    // Peer as of connect(), from SO_PEERCRED or getpeereid()
+    [[nodiscard]] auto peer_credentials() const -> std::expected<PeerCredentials, error_code>;
+    // Linux: have the kernel attach the sender's credentials to each message
+    // received; a no-op elsewhere
+    auto set_pass_credentials(bool pass) -> error_code;
+    // receive() that also reports who sent the data: SCM_CREDENTIALS on Linux
+    // (after set_pass_credentials(true)), peer_credentials() elsewhere
+    [[nodiscard]] auto receive_with_credentials(buffer_t buffer, PeerCredentials& sender) -> std::size_t;
+    
     // Utility methods
     bool is_open() const { return is_open_; }
     auto get_native_handle() const -> native_socket_handle { return handle_; }
+    auto local_port() const -> port_t;  // 0 when unbound or not an IP socket
+    // Connected IP peer; IPv4 clients of a dual-stack socket come back as IPv4
+    [[nodiscard]] auto peer_address() const -> std::expected<IPAddress, error_code>;
+    auto family() -> int;               // AF_INET, AF_INET6, AF_UNIX; 0 when closed
     
     // Socket options
     auto set_reuse_address(bool reuse) -> error_code;
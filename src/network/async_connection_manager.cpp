@@ -8,14 +8,120 @@
 // Include format header fix BEFORE any standard headers
 #include "../../include/dualstack_net26/fix_format_header.h"
 #include "async_connection_manager.h"
+#include "event_poller.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
+#include <climits>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
 
 namespace dualstack {
 namespace network {
 
+namespace {
+
+bool send_exact(Socket& socket, std::span<const std::byte> data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        size_t sent = socket.send(buffer_t(data.data() + offset, data.size() - offset));
+        if (sent == 0) {
+            return false;
+        }
+        offset += sent;
+    }
+    return true;
+}
+
+bool receive_exact(Socket& socket, std::byte* out, size_t size) {
+    size_t offset = 0;
+    while (offset < size) {
+        size_t received = socket.receive(buffer_t(out + offset, size - offset));
+        if (received == 0) {
+            return false;
+        }
+        offset += received;
+    }
+    return true;
+}
+
+// Wait for the socket to become readable; false once the deadline has passed
+bool wait_readable(Socket& socket, std::chrono::steady_clock::time_point deadline) {
+    for (;;) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
+        pollfd fd{};
+        fd.fd = socket.get_native_handle();
+        fd.events = POLLIN;
+        int timeout = static_cast<int>(std::min<std::chrono::milliseconds::rep>(remaining.count(), INT_MAX));
+#ifdef _WIN32
+        int ready = WSAPoll(&fd, 1, timeout);
+#else
+        int ready = ::poll(&fd, 1, timeout);
+#endif
+        if (ready < 0 && last_error_interrupted()) {
+            continue;
+        }
+        return ready > 0;
+    }
+}
+
+error_code receive_exact(Socket& socket, std::byte* out, size_t size, std::chrono::steady_clock::time_point deadline) {
+    size_t offset = 0;
+    while (offset < size) {
+        if (!wait_readable(socket, deadline)) {
+            return error_code::timeout;
+        }
+        size_t received = socket.receive(buffer_t(out + offset, size - offset));
+        if (received == 0) {
+            return error_code::receive_failed;
+        }
+        offset += received;
+    }
+    return error_code::success;
+}
+
+// Unread input, including a peer's close
+bool input_pending(Socket& socket) {
+    pollfd fd{};
+    fd.fd = socket.get_native_handle();
+    fd.events = POLLIN;
+#ifdef _WIN32
+    return WSAPoll(&fd, 1, 0) != 0;
+#else
+    return ::poll(&fd, 1, 0) != 0;
+#endif
+}
+
+// Holds an acquired connection in use for one manager operation
+class ConnectionUse {
+public:
+    explicit ConnectionUse(ConnectionState* state) : state_(state) {}
+    ~ConnectionUse() {
+        if (state_) {
+            --state_->in_use;
+        }
+    }
+    ConnectionUse(const ConnectionUse&) = delete;
+    ConnectionUse& operator=(const ConnectionUse&) = delete;
+
+    explicit operator bool() const { return state_ != nullptr; }
+    ConnectionState* operator->() const { return state_; }
+
+private:
+    ConnectionState* state_;
+};
+
+} // namespace
+
 // ============================================================================
 // AsyncConnectionManager Implementation
 // ============================================================================
@@ -80,22 +186,37 @@ std::string AsyncConnectionManager::create_async_connection(const IPAddress& add
         throw std::runtime_error("AsyncConnectionManager not initialized");
     }
 
-    std::string connection_id = generate_connection_id();
-    
     auto socket_result = create_tcp_socket();
     if (!socket_result.has_value()) {
         throw std::runtime_error("Failed to create socket");
     }
     
-    auto socket = std::make_unique<Socket>(std::move(socket_result.value()));
-    
-    error_code err = socket->connect(addr, port);
+    error_code err = socket_result.value().connect(addr, port);
     if (err != error_code::success) {
         throw std::runtime_error("Failed to connect");
     }
     
+    return adopt_connection(std::move(socket_result.value()), addr, port);
+}
+
+std::string AsyncConnectionManager::create_local_connection(const UnixEndpoint& endpoint, local_socket_type type) {
+    if (!initialized_) {
+        throw std::runtime_error("AsyncConnectionManager not initialized");
+    }
+
+    Socket socket;
+    error_code err = socket.connect(endpoint, type);
+    if (err != error_code::success) {
+        throw std::runtime_error("Failed to connect to " + endpoint.path);
+    }
+    
+    return adopt_connection(std::move(socket), IPAddress{}, 0);
+}
+
+std::string AsyncConnectionManager::adopt_connection(Socket socket, const IPAddress& addr, port_t port) {
+    std::string connection_id = generate_connection_id();
     auto state = std::make_unique<ConnectionState>();
-    state->socket = std::move(socket);
+    state->socket = std::make_unique<Socket>(std::move(socket));
     state->remote_addr = addr;
     state->remote_port = port;
     state->connected_at = std::chrono::system_clock::now();
@@ -130,8 +251,56 @@ ConnectionState* AsyncConnectionManager::get_connection(const std::string& conne
     return nullptr;
 }
 
+ConnectionState* AsyncConnectionManager::acquire(const std::string& connection_id) {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    auto it = active_connections_.find(connection_id);
+    if (it != active_connections_.end() && it->second->active) {
+        ++it->second->in_use;
+        return it->second.get();
+    }
+    return nullptr;
+}
+
+ConnectionState* AsyncConnectionManager::withdraw_connection(const std::string& connection_id, bool quiet) {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    auto it = active_connections_.find(connection_id);
+    if (it == active_connections_.end() || !it->second->active || it->second->in_use != 0) {
+        return nullptr;
+    }
+    ConnectionState* state = it->second.get();
+    if (!state->socket || !state->socket->is_open() || (quiet && input_pending(*state->socket))) {
+        return nullptr;
+    }
+    state->active = false;
+    return state;
+}
+
+void AsyncConnectionManager::restore_connection(const std::string& connection_id) {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    auto it = active_connections_.find(connection_id);
+    if (it != active_connections_.end()) {
+        it->second->active = true;
+    }
+}
+
 bool AsyncConnectionManager::send_galaxycdn_message(const std::string& connection_id, const std::vector<std::byte>& payload) {
-    auto* conn = get_connection(connection_id);
+    uint64_t request_id = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return send_galaxycdn_frame(connection_id, 0, request_id, payload);
+}
+
+std::expected<std::vector<std::byte>, error_code> AsyncConnectionManager::receive_galaxycdn_message(const std::string& connection_id) {
+    std::vector<std::byte> payload;
+    auto header = receive_galaxycdn_frame(connection_id, payload);
+    if (!header.has_value()) {
+        return std::unexpected(header.error());
+    }
+    return payload;
+}
+
+bool AsyncConnectionManager::send_galaxycdn_frame(const std::string& connection_id, uint16_t flags, uint64_t request_id,
+                                                  std::span<const std::byte> payload) {
+    ConnectionUse conn(acquire(connection_id));
     if (!conn || !conn->socket || !conn->socket->is_open()) {
         return false;
     }
@@ -139,63 +308,62 @@ bool AsyncConnectionManager::send_galaxycdn_message(const std::string& connectio
     GalaxyCDN::ProtocolHeader header{};
     header.magic = GalaxyCDN::PROTOCOL_MAGIC;
     header.version = GalaxyCDN::PROTOCOL_VERSION;
-    header.flags = 0;
+    header.flags = flags;
     header.payload_length = static_cast<uint32_t>(payload.size());
-    header.request_id = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-    
-    // Send header
-    buffer_t header_span(reinterpret_cast<const std::byte*>(&header), sizeof(header));
-    size_t sent = conn->socket->send(header_span);
-    if (sent != sizeof(header)) {
-        return false;
-    }
+    header.request_id = request_id;
     
-    // Send payload
-    if (!payload.empty()) {
-        buffer_t payload_span(payload.data(), payload.size());
-        sent = conn->socket->send(payload_span);
-        if (sent != payload.size()) {
-            return false;
-        }
-    }
-    
-    return true;
+    return send_exact(*conn->socket, std::span(reinterpret_cast<const std::byte*>(&header), sizeof(header))) &&
+           send_exact(*conn->socket, payload);
 }
 
-std::expected<std::vector<std::byte>, error_code> AsyncConnectionManager::receive_galaxycdn_message(const std::string& connection_id) {
-    auto* conn = get_connection(connection_id);
+std::expected<GalaxyCDN::ProtocolHeader, error_code> AsyncConnectionManager::receive_galaxycdn_frame(
+    const std::string& connection_id, std::vector<std::byte>& payload) {
+    ConnectionUse conn(acquire(connection_id));
     if (!conn || !conn->socket || !conn->socket->is_open()) {
         return std::unexpected(error_code::connection_failed);
     }
     
-    // Receive header
     GalaxyCDN::ProtocolHeader header{};
-    std::vector<std::byte> header_buffer(sizeof(header));
-    buffer_t header_span(header_buffer.data(), header_buffer.size());
-    size_t received = conn->socket->receive(header_span);
-    if (received != sizeof(header)) {
+    if (!receive_exact(*conn->socket, reinterpret_cast<std::byte*>(&header), sizeof(header))) {
         return std::unexpected(error_code::receive_failed);
     }
     
-    std::memcpy(&header, header_buffer.data(), sizeof(header));
-    
     // Validate magic
     if (header.magic != GalaxyCDN::PROTOCOL_MAGIC) {
         return std::unexpected(error_code::invalid_address);
     }
     
-    // Receive payload
-    std::vector<std::byte> payload(header.payload_length);
-    if (header.payload_length > 0) {
-        buffer_t payload_span(payload.data(), payload.size());
-        received = conn->socket->receive(payload_span);
-        if (received != payload.size()) {
-            return std::unexpected(error_code::receive_failed);
-        }
+    payload.resize(header.payload_length);
+    if (!receive_exact(*conn->socket, payload.data(), payload.size())) {
+        return std::unexpected(error_code::receive_failed);
     }
     
-    return payload;
+    return header;
+}
+
+std::expected<GalaxyCDN::ProtocolHeader, error_code> AsyncConnectionManager::receive_galaxycdn_frame(
+    const std::string& connection_id, std::vector<std::byte>& payload,
+    std::chrono::steady_clock::time_point deadline, uint32_t max_payload) {
+    ConnectionUse conn(acquire(connection_id));
+    if (!conn || !conn->socket || !conn->socket->is_open()) {
+        return std::unexpected(error_code::connection_failed);
+    }
+
+    GalaxyCDN::ProtocolHeader header{};
+    if (auto err = receive_exact(*conn->socket, reinterpret_cast<std::byte*>(&header), sizeof(header), deadline);
+        err != error_code::success) {
+        return std::unexpected(err);
+    }
+    if (header.magic != GalaxyCDN::PROTOCOL_MAGIC || header.payload_length > max_payload) {
+        return std::unexpected(error_code::invalid_address);
+    }
+
+    payload.resize(header.payload_length);
+    if (auto err = receive_exact(*conn->socket, payload.data(), payload.size(), deadline);
+        err != error_code::success) {
+        return std::unexpected(err);
+    }
+    return header;
 }
 
 size_t AsyncConnectionManager::get_active_connection_count() const {
@@ -239,10 +407,23 @@ auto AsyncConnectionManager::async_connect(const IPAddress& addr, port_t port) -
         });
 }
 
+auto AsyncConnectionManager::async_connect(const UnixEndpoint& endpoint, local_socket_type type)
+    -> std::execution::sender auto {
+    return std::execution::just()
+        | std::execution::then([this, endpoint, type]() {
+            try {
+                std::string conn_id = create_local_connection(endpoint, type);
+                return std::make_pair(conn_id, error_code::success);
+            } catch (...) {
+                return std::make_pair(std::string{}, error_code::connection_failed);
+            }
+        });
+}
+
 auto AsyncConnectionManager::async_send(const std::string& connection_id, buffer_t data) -> std::execution::sender auto {
     return std::execution::just()
         | std::execution::then([this, connection_id, data]() {
-            auto* conn = get_connection(connection_id);
+            ConnectionUse conn(acquire(connection_id));
             if (!conn || !conn->socket || !conn->socket->is_open()) {
                 return std::make_pair(size_t(0), error_code::connection_failed);
             }
@@ -254,7 +435,7 @@ auto AsyncConnectionManager::async_send(const std::string& connection_id, buffer
 auto AsyncConnectionManager::async_receive(const std::string& connection_id, buffer_t buffer) -> std::execution::sender auto {
     return std::execution::just()
         | std::execution::then([this, connection_id, buffer]() {
-            auto* conn = get_connection(connection_id);
+            ConnectionUse conn(acquire(connection_id));
             if (!conn || !conn->socket || !conn->socket->is_open()) {
                 return std::make_pair(size_t(0), error_code::connection_failed);
             }
@@ -268,6 +449,9 @@ auto AsyncConnectionManager::async_receive(const std::string& connection_id, buf
 // AsyncDualStackServer Implementation
 // ============================================================================
 
+// How long the accept thread waits before rechecking whether to keep accepting
+constexpr auto ACCEPT_WAIT = std::chrono::milliseconds(100);
+
 AsyncDualStackServer::AsyncDualStackServer(port_t port)
     : port_(port)
     , running_(false)
@@ -286,53 +470,78 @@ bool AsyncDualStackServer::start() {
     }
     
     try {
-        // Create IPv4 acceptor
-        auto ipv4_result = create_acceptor(port_);
-        if (!ipv4_result.has_value()) {
-            std::cerr << "❌ Failed to create IPv4 acceptor" << std::endl;
-            return false;
-        }
-        ipv4_acceptor_ = std::make_unique<Acceptor>(std::move(ipv4_result.value()));
-        
-        // Create IPv6 acceptor with dual-stack enabled
-        auto ipv6_result = create_acceptor(port_);
-        if (!ipv6_result.has_value()) {
-            std::cerr << "❌ Failed to create IPv6 acceptor" << std::endl;
+        // One dual-stack listener serves both families; a separate IPv4
+        // listener on the same port would fail to bind
+        auto acceptor_result = create_acceptor(port_);
+        if (!acceptor_result.has_value()) {
+            std::cerr << "❌ Failed to create dual-stack acceptor" << std::endl;
             return false;
         }
-        ipv6_acceptor_ = std::make_unique<Acceptor>(std::move(ipv6_result.value()));
-        ipv6_acceptor_->enable_dual_stack(true);
-        
-        running_ = true;
-        worker_running_ = true;
-        
-        // Start listener threads
-        ipv4_thread_ = std::thread(&AsyncDualStackServer::handle_ipv4_connections, this);
-        ipv6_thread_ = std::thread(&AsyncDualStackServer::handle_ipv6_connections, this);
-        async_worker_thread_ = std::thread(&AsyncDualStackServer::async_worker_loop, this);
-        
-        std::cout << "🐍 AsyncDualStackServer started on port " << port_ << std::endl;
+        acceptor_ = std::make_unique<Acceptor>(std::move(acceptor_result.value()));
+        return start_accepting();
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Server start failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool AsyncDualStackServer::start(Acceptor listener) {
+    if (running_) {
         return true;
+    }
+    if (!listener.is_listening()) {
+        std::cerr << "❌ Inherited listener is not listening" << std::endl;
+        return false;
+    }
+
+    try {
+        acceptor_ = std::make_unique<Acceptor>(std::move(listener));
+        return start_accepting();
     } catch (const std::exception& e) {
         std::cerr << "❌ Server start failed: " << e.what() << std::endl;
         return false;
     }
 }
 
+bool AsyncDualStackServer::start_accepting() {
+    // Non-blocking, so a connection taken by another process sharing the
+    // listener (hot restart) cannot leave accept() blocked
+    if (acceptor_->set_non_blocking(true) != error_code::success) {
+        std::cerr << "❌ Failed to make listener non-blocking" << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    accepting_ = true;
+    worker_running_ = true;
+    
+    // Start listener and worker threads
+    accept_thread_ = std::thread(&AsyncDualStackServer::accept_loop, this);
+    async_worker_thread_ = std::thread(&AsyncDualStackServer::async_worker_loop, this);
+    
+    std::cout << "🐍 AsyncDualStackServer started on port " << local_port() << std::endl;
+    return true;
+}
+
 void AsyncDualStackServer::stop() {
     if (!running_) {
         return;
     }
     
     running_ = false;
+    accepting_ = false;
     worker_running_ = false;
     
+    // Wake the accept thread, which is blocked in accept()
+    if (acceptor_) {
+        acceptor_->stop_listening();
+    }
+    
     // Notify worker thread
     pending_cv_.notify_all();
     
     // Wait for threads
-    if (ipv4_thread_.joinable()) ipv4_thread_.join();
-    if (ipv6_thread_.joinable()) ipv6_thread_.join();
+    if (accept_thread_.joinable()) accept_thread_.join();
     if (async_worker_thread_.joinable()) async_worker_thread_.join();
     
     // Close all connections
@@ -344,48 +553,61 @@ void AsyncDualStackServer::stop() {
     std::cout << "🐍 AsyncDualStackServer stopped" << std::endl;
 }
 
-void AsyncDualStackServer::handle_ipv4_connections() {
-    while (running_) {
-        try {
-            auto client_result = ipv4_acceptor_->accept();
-            if (client_result.has_value()) {
-                std::string conn_id = generate_connection_id();
-                IPAddress client_addr; // Would be populated from accept result
-                
-                PendingConnection pending;
-                pending.connection_id = conn_id;
-                pending.socket = std::move(client_result.value());
-                pending.addr = client_addr;
-                pending.accepted_at = std::chrono::system_clock::now();
-                
-                {
-                    std::lock_guard<std::mutex> lock(pending_mutex_);
-                    pending_connections_.push(std::move(pending));
-                }
-                pending_cv_.notify_one();
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            }
-        } catch (const std::exception& e) {
-            if (running_) {
-                std::cerr << "❌ IPv4 accept error: " << e.what() << std::endl;
-            }
-        }
+void AsyncDualStackServer::set_connection_handler(
+    std::function<void(std::string connection_id, Socket&, const IPAddress&)> handler) {
+    connection_handler_ = std::move(handler);
+}
+
+void AsyncDualStackServer::set_galaxycdn_handler(
+    std::function<void(std::string connection_id, Socket&, const GalaxyCDN::ProtocolHeader&, std::vector<std::byte>)> handler) {
+    galaxycdn_handler_ = std::move(handler);
+}
+
+port_t AsyncDualStackServer::local_port() const {
+    return acceptor_ ? acceptor_->local_port() : port_;
+}
+
+std::optional<native_socket_handle> AsyncDualStackServer::listener_handle() const {
+    if (!accepting_ || !acceptor_) {
+        return std::nullopt;
     }
+    return acceptor_->native_handle();
 }
 
-void AsyncDualStackServer::handle_ipv6_connections() {
-    while (running_) {
+bool AsyncDualStackServer::drain(std::chrono::milliseconds timeout) {
+    if (!running_) {
+        return true;
+    }
+
+    // The accept thread notices within ACCEPT_WAIT; only then is the descriptor closed
+    accepting_ = false;
+    if (accept_thread_.joinable()) accept_thread_.join();
+    acceptor_->detach();
+
+    std::cout << "🐍 AsyncDualStackServer draining " << get_active_connection_count() << " connections" << std::endl;
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    bool drained = get_active_connection_count() == 0;
+    while (!drained && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        drained = get_active_connection_count() == 0;
+    }
+    stop();
+    return drained;
+}
+
+void AsyncDualStackServer::accept_loop() {
+    while (running_ && accepting_) {
         try {
-            auto client_result = ipv6_acceptor_->accept();
+            if (!acceptor_->wait_for_connection(ACCEPT_WAIT)) {
+                continue;
+            }
+            auto client_result = acceptor_->accept();
             if (client_result.has_value()) {
                 std::string conn_id = generate_connection_id();
-                IPAddress client_addr; // Would be populated from accept result
-                
                 PendingConnection pending;
                 pending.connection_id = conn_id;
                 pending.socket = std::move(client_result.value());
-                pending.addr = client_addr;
+                pending.addr = pending.socket.peer_address().value_or(IPAddress{});
                 pending.accepted_at = std::chrono::system_clock::now();
                 
                 {
@@ -393,12 +615,12 @@ void AsyncDualStackServer::handle_ipv6_connections() {
                     pending_connections_.push(std::move(pending));
                 }
                 pending_cv_.notify_one();
-            } else {
+            } else if (client_result.error() != error_code::timeout) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
             }
         } catch (const std::exception& e) {
             if (running_) {
-                std::cerr << "❌ IPv6 accept error: " << e.what() << std::endl;
+                std::cerr << "❌ Accept error: " << e.what() << std::endl;
             }
         }
     }
@@ -431,6 +653,7 @@ void AsyncDualStackServer::handle_client_async(std::string connection_id, Socket
     state->connected_at = std::chrono::system_clock::now();
     state->connection_id = connection_id;
     
+    Socket* socket = state->socket.get();
     {
         std::lock_guard<std::mutex> lock(active_connections_mutex_);
         active_connections_[connection_id] = std::move(state);
@@ -438,7 +661,7 @@ void AsyncDualStackServer::handle_client_async(std::string connection_id, Socket
     
     // Call connection handler if set
     if (connection_handler_) {
-        connection_handler_(connection_id, *active_connections_[connection_id]->socket, addr);
+        connection_handler_(connection_id, *socket, addr);
     }
 }
 
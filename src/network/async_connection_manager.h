@@ -17,6 +17,7 @@
 #include "../core/socket.h"
 #include "../core/acceptor.h"
 #include "../async/execution.h"
+#include "../reflect/reflection.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -29,6 +30,7 @@
 #include <span>
 #include <execution>
 #include <unordered_map>
+#include <optional>
 #include <queue>
 #include <condition_variable>
 
@@ -58,6 +60,16 @@ namespace GalaxyCDN {
         uint16_t flags;           // Protocol flags
         uint32_t payload_length;  // Payload length
         uint64_t request_id;      // Request ID for tracking
+
+        // Reflected encoding is the packed little-endian form (20 bytes, no padding)
+        template<typename Reflection>
+        constexpr void reflect(Reflection& r) {
+            DUALSTACK_REFLECT_MEMBER(magic);
+            DUALSTACK_REFLECT_MEMBER(version);
+            DUALSTACK_REFLECT_MEMBER(flags);
+            DUALSTACK_REFLECT_MEMBER(payload_length);
+            DUALSTACK_REFLECT_MEMBER(request_id);
+        }
     };
 
     constexpr uint32_t PROTOCOL_MAGIC = 0x47414C58; // "GALX"
@@ -71,6 +83,7 @@ struct ConnectionState {
     port_t remote_port;
     std::chrono::system_clock::time_point connected_at;
     std::atomic<bool> active{true};
+    std::atomic<uint32_t> in_use{0};        // Manager operations currently on the socket
     std::string connection_id;
 };
 
@@ -92,13 +105,25 @@ public:
 
     // Async connection management
     std::string create_async_connection(const IPAddress& addr, port_t port);
+    // Same-host daemon over AF_UNIX; tracked with an unspecified address and port 0
+    std::string create_local_connection(const UnixEndpoint& endpoint,
+                                        local_socket_type type = local_socket_type::stream);
+    // Track an already-connected socket, e.g. one inherited on hot restart
+    std::string adopt_connection(Socket socket, const IPAddress& addr, port_t port);
     void close_connection(const std::string& connection_id);
     ConnectionState* get_connection(const std::string& connection_id);
+    // Take a connection out of service once no manager operation is using it
+    // and, with `quiet`, no input is waiting to be read. get_connection() and
+    // the I/O calls then skip it until restore_connection(); nullptr if busy.
+    ConnectionState* withdraw_connection(const std::string& connection_id, bool quiet);
+    void restore_connection(const std::string& connection_id);
     
     // Async operations using std::execution
 #if __cpp_lib_execution >= 202300L
     auto async_accept(Acceptor& acceptor) -> std::execution::sender auto;
     auto async_connect(const IPAddress& addr, port_t port) -> std::execution::sender auto;
+    auto async_connect(const UnixEndpoint& endpoint, local_socket_type type = local_socket_type::stream)
+        -> std::execution::sender auto;
     auto async_send(const std::string& connection_id, buffer_t data) -> std::execution::sender auto;
     auto async_receive(const std::string& connection_id, buffer_t buffer) -> std::execution::sender auto;
 #endif
@@ -107,6 +132,21 @@ public:
     bool send_galaxycdn_message(const std::string& connection_id, const std::vector<std::byte>& payload);
     std::expected<std::vector<std::byte>, error_code> receive_galaxycdn_message(const std::string& connection_id);
 
+    // Frame-level GalaxyCDN I/O. receive_galaxycdn_frame reuses the caller's
+    // payload buffer, so a handler viewing messages in place (galaxycdn_messages.h)
+    // stops allocating once the buffer has grown to the largest frame.
+    bool send_galaxycdn_frame(const std::string& connection_id, uint16_t flags, uint64_t request_id,
+                              std::span<const std::byte> payload);
+    std::expected<GalaxyCDN::ProtocolHeader, error_code> receive_galaxycdn_frame(
+        const std::string& connection_id, std::vector<std::byte>& payload);
+    // Bounded variant for request/response peers: error_code::timeout once the
+    // deadline passes, invalid_address for a bad magic or a payload over
+    // max_payload (refused before allocating). After any error the stream
+    // position is unknown, so the caller should close the connection.
+    std::expected<GalaxyCDN::ProtocolHeader, error_code> receive_galaxycdn_frame(
+        const std::string& connection_id, std::vector<std::byte>& payload,
+        std::chrono::steady_clock::time_point deadline, uint32_t max_payload);
+
     // Connection statistics
     size_t get_active_connection_count() const;
     std::vector<std::string> get_all_connection_ids() const;
@@ -124,13 +164,15 @@ private:
     std::atomic<uint64_t> connection_counter_{0};
     
     std::string generate_connection_id();
+    // get_connection() that also counts the caller in ConnectionState::in_use
+    ConnectionState* acquire(const std::string& connection_id);
 };
 
 /**
  * @brief Async Dual-Stack Server
  * 
  * High-performance dual-stack server with async connection handling.
- * Manages both IPv4 and IPv6 listeners simultaneously.
+ * One dual-stack listener accepts both IPv4 and IPv6 clients.
  */
 class AMPHISBAENA_API AsyncDualStackServer {
 public:
@@ -138,8 +180,23 @@ public:
     ~AsyncDualStackServer();
 
     bool start();
+    // Start on a listening socket inherited from a predecessor process
+    bool start(Acceptor listener);
     void stop();
     bool is_running() const { return running_; }
+    port_t local_port() const;     // Bound port, useful when constructed with port 0
+    // Listening socket to hand to a successor process
+    std::optional<native_socket_handle> listener_handle() const;
+
+    /**
+     * @brief Stop accepting in this process only, then wait for open connections
+     *
+     * The listening socket is closed without shutdown(), so a successor
+     * holding a copy keeps accepting. Stops the server once every connection
+     * has closed or the timeout has passed.
+     * @return true if all connections closed before the timeout
+     */
+    bool drain(std::chrono::milliseconds timeout);
 
     // Async connection handling
     void set_connection_handler(std::function<void(std::string connection_id, Socket&, const IPAddress&)> handler);
@@ -158,10 +215,9 @@ public:
 private:
     port_t port_;
     std::atomic<bool> running_;
-    std::unique_ptr<Acceptor> ipv4_acceptor_;
-    std::unique_ptr<Acceptor> ipv6_acceptor_;
-    std::thread ipv4_thread_;
-    std::thread ipv6_thread_;
+    std::atomic<bool> accepting_{false};
+    std::unique_ptr<Acceptor> acceptor_;       // Dual-stack: accepts IPv4 (mapped) and IPv6 clients
+    std::thread accept_thread_;
     std::thread async_worker_thread_;
     
     std::function<void(std::string, Socket&, const IPAddress&)> connection_handler_;
@@ -187,8 +243,8 @@ private:
     std::unordered_map<std::string, std::unique_ptr<ConnectionState>> active_connections_;
     std::atomic<uint64_t> connection_counter_{0};
 
-    void handle_ipv4_connections();
-    void handle_ipv6_connections();
+    bool start_accepting();
+    void accept_loop();
     void async_worker_loop();
     void handle_client_async(std::string connection_id, Socket client, const IPAddress& addr);
     std::string generate_connection_id();
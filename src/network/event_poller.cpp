@@ -0,0 +1,186 @@
+/**
+ * Amphisbaena 🐍 - Event Poller Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "event_poller.h"
+#include <cerrno>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
+namespace dualstack {
+namespace network {
+
+Poller::~Poller() {
+#if defined(__linux__)
+    if (epoll_ >= 0) ::close(epoll_);
+#endif
+#ifndef _WIN32
+    if (wake_read_ >= 0) ::close(wake_read_);
+    if (wake_write_ >= 0) ::close(wake_write_);
+#endif
+}
+
+bool Poller::open() {
+#if defined(__linux__)
+    epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_ < 0) {
+        return false;
+    }
+#endif
+#ifndef _WIN32
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        return false;
+    }
+    wake_read_ = fds[0];
+    wake_write_ = fds[1];
+    for (int fd : fds) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    return add(static_cast<native_socket_handle>(wake_read_));
+#else
+    return true;
+#endif
+}
+
+bool Poller::add(native_socket_handle fd) {
+#if defined(__linux__)
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = fd;
+    return ::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) == 0;
+#else
+    index_[fd] = fds_.size();
+    fds_.push_back(make_pollfd(fd, true, false));
+    return true;
+#endif
+}
+
+void Poller::set_interest(native_socket_handle fd, bool read, bool write) {
+#if defined(__linux__)
+    epoll_event event{};
+    event.events = (read ? (EPOLLIN | EPOLLRDHUP) : 0u) | (write ? EPOLLOUT : 0u);
+    event.data.fd = fd;
+    ::epoll_ctl(epoll_, EPOLL_CTL_MOD, fd, &event);
+#else
+    if (auto it = index_.find(fd); it != index_.end()) {
+        fds_[it->second] = make_pollfd(fd, read, write);
+    }
+#endif
+}
+
+void Poller::remove(native_socket_handle fd) {
+#if defined(__linux__)
+    ::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+#else
+    auto it = index_.find(fd);
+    if (it == index_.end()) {
+        return;
+    }
+    size_t slot = it->second;
+    index_.erase(it);
+    if (slot + 1 != fds_.size()) {
+        fds_[slot] = fds_.back();
+        index_[static_cast<native_socket_handle>(fds_[slot].fd)] = slot;
+    }
+    fds_.pop_back();
+#endif
+}
+
+void Poller::wait(std::vector<PollEvent>& events, int timeout_ms) {
+    events.clear();
+#if defined(__linux__)
+    epoll_event ready[256];
+    int count = ::epoll_wait(epoll_, ready, 256, timeout_ms);
+    for (int i = 0; i < count; ++i) {
+        uint32_t flags = ready[i].events;
+        events.push_back({static_cast<native_socket_handle>(ready[i].data.fd),
+                          (flags & (EPOLLIN | EPOLLRDHUP)) != 0, (flags & EPOLLOUT) != 0,
+                          (flags & (EPOLLERR | EPOLLHUP)) != 0});
+    }
+#else
+    if (fds_.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        return;
+    }
+#ifdef _WIN32
+    int count = WSAPoll(fds_.data(), static_cast<ULONG>(fds_.size()), timeout_ms);
+#else
+    int count = ::poll(fds_.data(), static_cast<nfds_t>(fds_.size()), timeout_ms);
+#endif
+    for (size_t i = 0; i < fds_.size() && count > 0; ++i) {
+        short flags = fds_[i].revents;
+        if (flags == 0) {
+            continue;
+        }
+        --count;
+        events.push_back({static_cast<native_socket_handle>(fds_[i].fd), (flags & POLLIN) != 0,
+                          (flags & POLLOUT) != 0, (flags & (POLLERR | POLLHUP | POLLNVAL)) != 0});
+    }
+#endif
+
+#ifndef _WIN32
+    // Drain the wake pipe and hide it from the caller
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (events[i].fd == static_cast<native_socket_handle>(wake_read_)) {
+            char drain[64];
+            while (::read(wake_read_, drain, sizeof(drain)) > 0) {
+            }
+            events.erase(events.begin() + static_cast<std::ptrdiff_t>(i));
+            break;
+        }
+    }
+#endif
+}
+
+void Poller::wake() {
+#ifndef _WIN32
+    if (wake_write_ >= 0) {
+        char byte = 0;
+        (void)::write(wake_write_, &byte, 1);
+    }
+#endif
+}
+
+#if !defined(__linux__)
+Poller::poll_entry Poller::make_pollfd(native_socket_handle fd, bool read, bool write) {
+    poll_entry entry{};
+    entry.fd = fd;
+    entry.events = static_cast<short>((read ? POLLIN : 0) | (write ? POLLOUT : 0));
+    return entry;
+}
+#endif
+
+bool last_error_would_block() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+bool last_error_interrupted() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEINTR;
+#else
+    return errno == EINTR;
+#endif
+}
+
+} // namespace network
+} // namespace dualstack
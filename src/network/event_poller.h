@@ -0,0 +1,98 @@
+/**
+ * Amphisbaena 🐍 - Event Poller
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Readiness polling shared by the non-blocking protocol layers (HTTP,
+ * WebSocket, TCP proxy): epoll on Linux, poll / WSAPoll elsewhere, plus a
+ * wake pipe so other threads can interrupt a wait.
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "async_connection_manager.h"
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+namespace dualstack {
+namespace network {
+
+struct PollEvent {
+    native_socket_handle fd;
+    bool readable;
+    bool writable;
+    bool failed;
+};
+
+/**
+ * @brief Level-triggered readiness poller
+ *
+ * A socket waits either for input or, while it has output queued, for
+ * writability only, so a peer that sends without reading is throttled.
+ * Not thread-safe except for wake().
+ */
+class AMPHISBAENA_API Poller {
+public:
+#ifdef _WIN32
+    // No wake pipe: new work is only picked up when a wait times out
+    static constexpr int MAX_WAIT_MS = 20;
+#else
+    static constexpr int MAX_WAIT_MS = 1000;
+#endif
+
+    Poller() = default;
+    ~Poller();
+
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    bool open();
+
+    bool add(native_socket_handle fd);
+    // Wait for input only, or for writability only
+    void watch(native_socket_handle fd, bool write) { set_interest(fd, !write, write); }
+    // Any combination; a socket with neither still reports errors and hang-ups
+    void set_interest(native_socket_handle fd, bool read, bool write);
+    void remove(native_socket_handle fd);
+
+    // Wake events are drained internally and never reported
+    void wait(std::vector<PollEvent>& events, int timeout_ms);
+
+    // Interrupt a wait from another thread
+    void wake();
+
+private:
+#if defined(__linux__)
+    int epoll_ = -1;
+#else
+#ifdef _WIN32
+    using poll_entry = WSAPOLLFD;
+#else
+    using poll_entry = pollfd;
+#endif
+    static poll_entry make_pollfd(native_socket_handle fd, bool read, bool write);
+
+    std::vector<poll_entry> fds_;
+    std::unordered_map<native_socket_handle, size_t> index_;
+#endif
+#ifndef _WIN32
+    int wake_read_ = -1;
+    int wake_write_ = -1;
+#endif
+};
+
+// errno / WSAGetLastError classification for non-blocking socket calls
+AMPHISBAENA_API bool last_error_would_block();
+AMPHISBAENA_API bool last_error_interrupted();
+
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,923 @@
+/**
+ * Amphisbaena 🐍 - GalaxyCDN Object Cache Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "galaxycdn_cache.h"
+#include "../reflect/message_view.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+namespace dualstack {
+namespace network {
+namespace GalaxyCDN {
+
+// ============================================================================
+// Segment files
+// ============================================================================
+//
+//   offset  size  field
+//        0     4  magic "GCSG"
+//        4     2  version
+//        6     2  header size
+//        8     8  sequence (segments are evicted oldest first)
+//       16    16  reserved
+//       32        records, each padded to 8 bytes:
+//                   u32 magic "GCOB" | u32 metadata length | u64 body length
+//                   u32 flags | u32 reserved | 32-byte SHA-256 | metadata | body
+//
+// A record's magic is written after its contents, so a scan on reopen stops
+// at the first record an interrupted append left incomplete. A record flagged
+// metadata-only carries no body: it replaces the metadata of the newest
+// earlier copy of the same content. Files are allocated at full segment size
+// up front and mapped once, so a full disk fails the create rather than
+// raising SIGBUS on a later write through the mapping.
+
+namespace {
+
+constexpr uint32_t SEGMENT_MAGIC = 0x47534347;      // "GCSG" read little-endian
+constexpr uint32_t RECORD_MAGIC = 0x424F4347;       // "GCOB"
+constexpr uint16_t SEGMENT_VERSION = 2;
+constexpr size_t SEGMENT_HEADER_SIZE = 32;
+constexpr size_t RECORD_HEADER_SIZE = 56;
+constexpr uint32_t RECORD_METADATA_ONLY = 1;
+
+auto load_u32(const std::byte* p) -> uint32_t {
+    return static_cast<uint32_t>(reflect::detail::load_le(p, 4));
+}
+
+auto load_u64(const std::byte* p) -> uint64_t {
+    return reflect::detail::load_le(p, 8);
+}
+
+auto store_u32(std::byte* p, uint32_t v) -> void {
+    reflect::detail::store_le(p, v, 4);
+}
+
+auto store_u64(std::byte* p, uint64_t v) -> void {
+    reflect::detail::store_le(p, v, 8);
+}
+
+constexpr auto padded(uint64_t size) -> uint64_t {
+    return (size + 7) & ~uint64_t{7};
+}
+
+auto segment_name(uint64_t sequence) -> std::string {
+    char digits[17] = {};
+    auto result = std::to_chars(digits, digits + 16, sequence, 16);
+    std::string name = "segment-";
+    name.append(16 - static_cast<size_t>(result.ptr - digits), '0');
+    name.append(digits, result.ptr);
+    return name + ".gcs";
+}
+
+// Finalizer from MurmurHash3 (public domain, Austin Appleby); mixes sketch indexes
+auto fmix64(uint64_t k) -> uint64_t {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// SHA-256 (FIPS 180-4)
+constexpr std::array<uint32_t, 64> SHA256_K = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+auto sha256_block(std::array<uint32_t, 8>& state, const std::byte* block) -> void {
+    std::array<uint32_t, 64> w;
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = std::to_integer<uint32_t>(block[i * 4]) << 24 | std::to_integer<uint32_t>(block[i * 4 + 1]) << 16 |
+               std::to_integer<uint32_t>(block[i * 4 + 2]) << 8 | std::to_integer<uint32_t>(block[i * 4 + 3]);
+    }
+    for (size_t i = 16; i < 64; ++i) {
+        uint32_t s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    auto [a, b, c, d, e, f, g, h] = state;
+    for (size_t i = 0; i < 64; ++i) {
+        uint32_t t1 = h + (std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)) + ((e & f) ^ (~e & g)) +
+                      SHA256_K[i] + w[i];
+        uint32_t t2 = (std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+auto sha256(std::span<const std::byte> data) -> ContentHash {
+    std::array<uint32_t, 8> state = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    size_t blocks = data.size() / 64;
+    for (size_t i = 0; i < blocks; ++i) {
+        sha256_block(state, data.data() + i * 64);
+    }
+
+    // Tail, 0x80 marker and the bit length fill one or two final blocks
+    std::array<std::byte, 128> tail{};
+    size_t rest = data.size() - blocks * 64;
+    if (rest > 0) {
+        std::memcpy(tail.data(), data.data() + blocks * 64, rest);
+    }
+    tail[rest] = std::byte{0x80};
+    size_t tail_size = rest < 56 ? 64 : 128;
+    uint64_t bits = static_cast<uint64_t>(data.size()) * 8;
+    for (size_t i = 0; i < 8; ++i) {
+        tail[tail_size - 1 - i] = static_cast<std::byte>(bits >> (8 * i));
+    }
+    for (size_t offset = 0; offset < tail_size; offset += 64) {
+        sha256_block(state, tail.data() + offset);
+    }
+
+    ContentHash hash;
+    for (size_t i = 0; i < 4; ++i) {
+        hash.words[i] = uint64_t{state[i * 2]} << 32 | state[i * 2 + 1];
+    }
+    return hash;
+}
+
+#ifndef _WIN32
+auto wait_writable(int fd) -> bool {
+    pollfd pfd{};
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    int result;
+    do {
+        result = ::poll(&pfd, 1, 1000);
+    } while (result < 0 && errno == EINTR);
+    return result > 0 && !(pfd.revents & (POLLERR | POLLHUP | POLLNVAL));
+}
+#endif
+
+auto send_bytes(Socket& socket, std::span<const std::byte> data) -> bool {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        size_t sent = socket.send(buffer_t(data.data() + offset, data.size() - offset));
+        if (sent == 0) {
+            return false;
+        }
+        offset += sent;
+    }
+    return true;
+}
+
+#if defined(__linux__)
+// sendfile has no MSG_NOSIGNAL: hold SIGPIPE blocked on this thread and
+// discard one raised by a reset peer, so it surfaces as EPIPE only
+auto send_file_range(int socket_fd, int file_fd, uint64_t offset, uint64_t length) -> bool {
+    sigset_t pipe_set;
+    sigset_t previous;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &previous);
+
+    off_t position = static_cast<off_t>(offset);
+    bool ok = true;
+    while (length > 0) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(length, 1u << 30));
+        ssize_t sent = ::sendfile(socket_fd, file_fd, &position, chunk);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && wait_writable(socket_fd)) {
+            continue;
+        }
+        if (sent <= 0) {
+            ok = false;
+            break;
+        }
+        length -= static_cast<uint64_t>(sent);
+    }
+
+    if (!ok && errno == EPIPE) {
+        timespec zero{};
+        while (sigtimedwait(&pipe_set, nullptr, &zero) == SIGPIPE) {
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+    return ok;
+}
+#endif
+
+} // anonymous namespace
+
+const char* describe(CacheError error) {
+    switch (error) {
+        case CacheError::io_error: return "object cache segment I/O failed";
+        case CacheError::not_found: return "object not cached";
+        case CacheError::range_not_satisfiable: return "range not satisfiable";
+        case CacheError::too_large: return "response exceeds GalaxyCDN payload limit";
+        case CacheError::send_failed: return "send failed";
+    }
+    return "unknown cache error";
+}
+
+// ============================================================================
+// ContentHash
+// ============================================================================
+
+ContentHash ContentHash::of(std::span<const std::byte> content) {
+    return sha256(content);
+}
+
+std::string ContentHash::to_string() const {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string text(64, '0');
+    for (size_t word = 0; word < words.size(); ++word) {
+        for (size_t i = 0; i < 16; ++i) {
+            text[word * 16 + 15 - i] = digits[(words[word] >> (4 * i)) & 0xF];
+        }
+    }
+    return text;
+}
+
+std::optional<ContentHash> ContentHash::from_string(std::string_view hex) {
+    if (hex.size() != 64) {
+        return std::nullopt;
+    }
+    ContentHash hash;
+    for (size_t word = 0; word < hash.words.size(); ++word) {
+        const char* begin = hex.data() + word * 16;
+        auto parsed = std::from_chars(begin, begin + 16, hash.words[word], 16);
+        if (parsed.ec != std::errc{} || parsed.ptr != begin + 16) {
+            return std::nullopt;
+        }
+    }
+    return hash;
+}
+
+// ============================================================================
+// CacheSegment
+// ============================================================================
+
+class CacheSegment {
+public:
+    static auto create(const std::filesystem::path& path, uint64_t sequence, uint64_t capacity)
+        -> std::shared_ptr<CacheSegment> {
+        auto segment = std::shared_ptr<CacheSegment>(new CacheSegment(path));
+        if (!segment->map(capacity, true)) {
+            return nullptr;
+        }
+        std::byte* header = segment->data_;
+        store_u32(header, SEGMENT_MAGIC);
+        header[4] = static_cast<std::byte>(SEGMENT_VERSION);
+        header[6] = static_cast<std::byte>(SEGMENT_HEADER_SIZE);
+        store_u64(header + 8, sequence);
+        segment->sequence_ = sequence;
+        segment->used_ = SEGMENT_HEADER_SIZE;
+        return segment;
+    }
+
+    static auto open(const std::filesystem::path& path) -> std::shared_ptr<CacheSegment> {
+        auto segment = std::shared_ptr<CacheSegment>(new CacheSegment(path));
+        if (!segment->map(0, false) || segment->capacity_ < SEGMENT_HEADER_SIZE) {
+            return nullptr;
+        }
+        const std::byte* header = segment->data_;
+        if (load_u32(header) != SEGMENT_MAGIC || std::to_integer<uint16_t>(header[4]) != SEGMENT_VERSION ||
+            std::to_integer<size_t>(header[6]) != SEGMENT_HEADER_SIZE) {
+            return nullptr;
+        }
+        segment->sequence_ = load_u64(header + 8);
+        segment->used_ = SEGMENT_HEADER_SIZE;
+        return segment;
+    }
+
+    ~CacheSegment() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) ::munmap(data_, capacity_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+        if (retired_) {
+            std::error_code ec;
+            std::filesystem::remove(path_, ec);
+        }
+    }
+
+    CacheSegment(const CacheSegment&) = delete;
+    CacheSegment& operator=(const CacheSegment&) = delete;
+
+    // Walk complete records, calling visit(hash, metadata bytes, body offset, body size, metadata only)
+    template<typename Visit>
+    void scan(Visit&& visit) {
+        uint64_t offset = SEGMENT_HEADER_SIZE;
+        while (capacity_ - offset >= RECORD_HEADER_SIZE) {
+            const std::byte* record = data_ + offset;
+            if (load_u32(record) != RECORD_MAGIC) {
+                break;
+            }
+            uint64_t metadata_size = load_u32(record + 4);
+            uint64_t body_size = load_u64(record + 8);
+            uint64_t available = capacity_ - offset - RECORD_HEADER_SIZE;
+            if (metadata_size > available || body_size > available - metadata_size) {
+                break;
+            }
+            ContentHash hash;
+            for (size_t i = 0; i < hash.words.size(); ++i) {
+                hash.words[i] = load_u64(record + 24 + i * 8);
+            }
+            bool metadata_only = (load_u32(record + 16) & RECORD_METADATA_ONLY) != 0;
+            visit(hash, std::span<const std::byte>(record + RECORD_HEADER_SIZE, metadata_size),
+                  offset + RECORD_HEADER_SIZE + metadata_size, body_size, metadata_only);
+            offset = std::min<uint64_t>(padded(offset + RECORD_HEADER_SIZE + metadata_size + body_size), capacity_);
+        }
+        used_ = offset;
+    }
+
+    // Claim space for a record; the caller fills it with write() outside the cache lock
+    auto reserve(uint64_t record_size) -> std::optional<uint64_t> {
+        if (record_size > capacity_ - used_) {
+            return std::nullopt;
+        }
+        uint64_t offset = used_;
+        used_ += padded(record_size);
+        used_ = std::min(used_, capacity_);
+        return offset;
+    }
+
+    // Returns the body offset
+    auto write(uint64_t offset, const ContentHash& hash, std::span<const std::byte> metadata,
+               std::span<const std::byte> body, uint32_t flags = 0) -> uint64_t {
+        std::byte* record = data_ + offset;
+        store_u32(record + 4, static_cast<uint32_t>(metadata.size()));
+        store_u64(record + 8, body.size());
+        store_u32(record + 16, flags);
+        store_u32(record + 20, 0);
+        for (size_t i = 0; i < hash.words.size(); ++i) {
+            store_u64(record + 24 + i * 8, hash.words[i]);
+        }
+        std::memcpy(record + RECORD_HEADER_SIZE, metadata.data(), metadata.size());
+        if (!body.empty()) {
+            std::memcpy(record + RECORD_HEADER_SIZE + metadata.size(), body.data(), body.size());
+        }
+        store_u32(record, RECORD_MAGIC);
+        return offset + RECORD_HEADER_SIZE + metadata.size();
+    }
+
+    auto data() const -> const std::byte* { return data_; }
+    auto capacity() const -> uint64_t { return capacity_; }
+    auto sequence() const -> uint64_t { return sequence_; }
+#ifndef _WIN32
+    auto fd() const -> int { return fd_; }
+#endif
+
+    // Delete the file once the last reference (cache or handle) is gone
+    void retire() { retired_ = true; }
+    auto retired() const -> bool { return retired_; }
+
+    std::vector<ContentHash> contents;      // Objects indexed to this segment (guarded by the cache's warm mutex)
+
+private:
+    explicit CacheSegment(std::filesystem::path path) : path_(std::move(path)) {}
+
+    auto map(uint64_t capacity, bool create) -> bool {
+#ifdef _WIN32
+        file_ = CreateFileW(path_.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                            create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size{};
+        if (create) {
+            size.QuadPart = static_cast<LONGLONG>(capacity);
+        } else if (!GetFileSizeEx(file_, &size)) {
+            return false;
+        }
+        capacity_ = static_cast<uint64_t>(size.QuadPart);
+        if (capacity_ == 0) {
+            return false;
+        }
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+        if (!mapping_) {
+            return false;
+        }
+        data_ = static_cast<std::byte*>(MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+        return data_ != nullptr;
+#else
+        fd_ = ::open(path_.c_str(), create ? (O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC) : (O_RDWR | O_CLOEXEC), 0644);
+        if (fd_ < 0) {
+            return false;
+        }
+        if (create) {
+            // Reserve the blocks now: writes into a sparse mapping raise SIGBUS once the disk fills
+            int error = ::posix_fallocate(fd_, 0, static_cast<off_t>(capacity));
+            if (error != 0) {
+                std::cerr << "⚠️  Cannot allocate cache segment " << path_.filename().string() << ": "
+                          << std::strerror(error) << std::endl;
+                return false;
+            }
+            capacity_ = capacity;
+        } else {
+            struct stat info {};
+            if (::fstat(fd_, &info) != 0 || info.st_size <= 0) {
+                return false;
+            }
+            capacity_ = static_cast<uint64_t>(info.st_size);
+        }
+        void* mapped = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        data_ = static_cast<std::byte*>(mapped);
+        return true;
+#endif
+    }
+
+    std::filesystem::path path_;
+    std::byte* data_ = nullptr;
+    uint64_t capacity_ = 0;
+    uint64_t used_ = 0;
+    uint64_t sequence_ = 0;
+    bool retired_ = false;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// ============================================================================
+// FrequencySketch
+// ============================================================================
+
+ObjectCache::FrequencySketch::FrequencySketch(size_t counters, size_t sample_size)
+    : sample_size_(std::max<size_t>(sample_size, 1)) {
+    size_t width = std::bit_ceil(std::max<size_t>(counters / 4, 16));
+    counters_.assign(width * 4, 0);
+    mask_ = width - 1;
+}
+
+size_t ObjectCache::FrequencySketch::index(const ContentHash& hash, size_t row) const {
+    static constexpr uint64_t seeds[4] = {
+        0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+    };
+    uint64_t mixed = fmix64(hash.words[3] ^ seeds[row]) + hash.words[2];
+    return row * (mask_ + 1) + static_cast<size_t>(mixed & mask_);
+}
+
+void ObjectCache::FrequencySketch::increment(const ContentHash& hash) {
+    for (size_t row = 0; row < 4; ++row) {
+        uint8_t& counter = counters_[index(hash, row)];
+        if (counter < 15) {
+            ++counter;
+        }
+    }
+    // Aging keeps the sketch tracking recent popularity
+    if (++additions_ >= sample_size_) {
+        for (uint8_t& counter : counters_) {
+            counter >>= 1;
+        }
+        additions_ /= 2;
+    }
+}
+
+uint32_t ObjectCache::FrequencySketch::estimate(const ContentHash& hash) const {
+    uint32_t frequency = 15;
+    for (size_t row = 0; row < 4; ++row) {
+        frequency = std::min<uint32_t>(frequency, counters_[index(hash, row)]);
+    }
+    return frequency;
+}
+
+// ============================================================================
+// ObjectCache
+// ============================================================================
+
+ObjectCache::ObjectCache(const ObjectCacheConfig& config) : config_(config) {
+    size_t shard_count = std::bit_ceil(std::max<size_t>(config_.shard_count, 1));
+    shard_mask_ = shard_count - 1;
+    shard_capacity_ = config_.hot_capacity_bytes / shard_count;
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>(config_.sketch_counters, config_.sketch_sample_size));
+    }
+}
+
+ObjectCache::~ObjectCache() = default;
+
+std::expected<std::unique_ptr<ObjectCache>, CacheError> ObjectCache::open(const ObjectCacheConfig& config) {
+    std::error_code ec;
+    std::filesystem::create_directories(config.segment_directory, ec);
+    if (ec) {
+        return std::unexpected(CacheError::io_error);
+    }
+    std::unique_ptr<ObjectCache> cache(new ObjectCache(config));
+    if (auto loaded = cache->load_segments(); !loaded) {
+        return std::unexpected(loaded.error());
+    }
+    return cache;
+}
+
+std::expected<void, CacheError> ObjectCache::load_segments() {
+    std::vector<std::shared_ptr<CacheSegment>> found;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(config_.segment_directory, ec)) {
+        std::string name = entry.path().filename().string();
+        if (!entry.is_regular_file() || !name.starts_with("segment-") || !name.ends_with(".gcs")) {
+            continue;
+        }
+        if (auto segment = CacheSegment::open(entry.path())) {
+            found.push_back(std::move(segment));
+        } else {
+            std::cerr << "⚠️  Ignoring unreadable cache segment " << name << std::endl;
+        }
+    }
+    if (ec) {
+        return std::unexpected(CacheError::io_error);
+    }
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a->sequence() < b->sequence(); });
+
+    std::lock_guard<std::mutex> lock(warm_mutex_);
+    for (auto& segment : found) {
+        segment->scan([&](const ContentHash& hash, std::span<const std::byte> metadata_bytes,
+                          uint64_t body_offset, uint64_t body_size, bool metadata_only) {
+            auto metadata = std::make_shared<ObjectMetadata>();
+            if (!reflect::from_binary(metadata_bytes, *metadata)) {
+                return;
+            }
+            if (metadata_only) {
+                // Applies to the body already loaded, if its segment survived
+                if (auto it = warm_.find(hash); it != warm_.end()) {
+                    WarmEntry updated = *it->second;
+                    updated.metadata = std::move(metadata);
+                    it->second = std::make_shared<const WarmEntry>(std::move(updated));
+                }
+                return;
+            }
+            // Later segments hold newer copies
+            warm_[hash] = std::make_shared<const WarmEntry>(
+                WarmEntry{hash, std::move(metadata), segment, body_offset, body_size});
+            segment->contents.push_back(hash);
+        });
+        warm_bytes_ += segment->capacity();
+        next_segment_sequence_ = std::max(next_segment_sequence_, segment->sequence() + 1);
+        segments_.push_back(std::move(segment));
+    }
+    evict_segments();
+    return {};
+}
+
+std::expected<std::shared_ptr<CacheSegment>, CacheError> ObjectCache::segment_for(uint64_t record_size) {
+    uint64_t capacity = std::max<uint64_t>(config_.segment_bytes, padded(record_size) + SEGMENT_HEADER_SIZE);
+    uint64_t sequence = next_segment_sequence_++;
+    auto path = std::filesystem::path(config_.segment_directory) / segment_name(sequence);
+    auto segment = CacheSegment::create(path, sequence, capacity);
+    if (!segment) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return std::unexpected(CacheError::io_error);
+    }
+    segments_.push_back(segment);
+    warm_bytes_ += segment->capacity();
+    evict_segments();
+    return segment;
+}
+
+void ObjectCache::evict_segments() {
+    // The newest segment is the append target and always stays
+    while (warm_bytes_ > config_.warm_capacity_bytes && segments_.size() > 1) {
+        std::shared_ptr<CacheSegment> oldest = std::move(segments_.front());
+        segments_.pop_front();
+        for (const ContentHash& hash : oldest->contents) {
+            auto it = warm_.find(hash);
+            if (it != warm_.end() && it->second->segment == oldest) {
+                warm_.erase(it);
+            }
+        }
+        oldest->contents.clear();
+        oldest->retire();
+        warm_bytes_ -= oldest->capacity();
+        ++segments_evicted_;
+    }
+}
+
+std::expected<ContentHash, CacheError> ObjectCache::put(std::span<const std::byte> body, const ObjectMetadata& metadata) {
+    ContentHash hash = ContentHash::of(body);
+    auto shared_metadata = std::make_shared<const ObjectMetadata>(metadata);
+    std::vector<std::byte> metadata_bytes = reflect::to_binary(metadata);
+
+    for (;;) {
+        std::shared_ptr<CacheSegment> segment;
+        uint64_t offset = 0;
+        bool update = false;
+        {
+            std::lock_guard<std::mutex> lock(warm_mutex_);
+            // Content already stored: append only its new metadata
+            update = warm_.contains(hash);
+            uint64_t record_size = RECORD_HEADER_SIZE + metadata_bytes.size() + (update ? 0 : body.size());
+            std::optional<uint64_t> reserved;
+            if (!segments_.empty()) {
+                reserved = segments_.back()->reserve(record_size);
+            }
+            if (!reserved) {
+                auto created = segment_for(record_size);
+                if (!created) {
+                    return std::unexpected(created.error());
+                }
+                reserved = (*created)->reserve(record_size);
+            }
+            segment = segments_.back();
+            offset = *reserved;
+        }
+
+        // Copy outside the lock so lookups never wait on a large body
+        uint64_t body_offset = update
+            ? segment->write(offset, hash, metadata_bytes, {}, RECORD_METADATA_ONLY)
+            : segment->write(offset, hash, metadata_bytes, body);
+
+        std::lock_guard<std::mutex> lock(warm_mutex_);
+        if (segment->retired()) {
+            continue;       // Evicted while we were writing; append again to the current segment
+        }
+        if (update) {
+            auto it = warm_.find(hash);
+            if (it == warm_.end()) {
+                continue;   // The stored copy was evicted meanwhile; append the body after all
+            }
+            WarmEntry updated = *it->second;
+            updated.metadata = shared_metadata;
+            it->second = std::make_shared<const WarmEntry>(std::move(updated));
+            break;
+        }
+        if (!warm_.contains(hash)) {
+            warm_[hash] = std::make_shared<const WarmEntry>(
+                WarmEntry{hash, shared_metadata, segment, body_offset, body.size()});
+            segment->contents.push_back(hash);
+        }
+        return hash;
+    }
+
+    // Same content stored again: refresh the hot copy's metadata as well
+    Shard& shard = shard_for(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (auto it = shard.lookup.find(hash); it != shard.lookup.end()) {
+        *it->second = std::make_shared<const HotEntry>(HotEntry{hash, shared_metadata, (*it->second)->body});
+    }
+    return hash;
+}
+
+bool ObjectCache::admit(Shard& shard, const ContentHash& candidate, size_t size, bool evict) {
+    if (size > shard_capacity_) {
+        return false;
+    }
+    if (shard.bytes + size <= shard_capacity_) {
+        return true;
+    }
+
+    // The candidate must out-score every victim it would displace
+    uint32_t frequency = shard.sketch.estimate(candidate);
+    size_t freed = 0;
+    auto victim = shard.lru.end();
+    while (shard.bytes - freed + size > shard_capacity_) {
+        if (victim == shard.lru.begin()) {
+            return false;
+        }
+        --victim;
+        if (shard.sketch.estimate((*victim)->hash) >= frequency) {
+            return false;
+        }
+        freed += (*victim)->body->size();
+    }
+    if (!evict) {
+        return true;
+    }
+
+    while (shard.bytes + size > shard_capacity_) {
+        const auto& entry = shard.lru.back();
+        size_t entry_size = entry->body->size();
+        shard.lookup.erase(entry->hash);
+        shard.lru.pop_back();
+        shard.bytes -= entry_size;
+        hot_bytes_ -= entry_size;
+        ++hot_evictions_;
+    }
+    return true;
+}
+
+void ObjectCache::offer_hot(const WarmEntry& entry) {
+    if (entry.body_size > config_.max_hot_object_bytes) {
+        return;
+    }
+    size_t size = static_cast<size_t>(entry.body_size);
+    Shard& shard = shard_for(entry.hash);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.lookup.contains(entry.hash)) {
+            return;
+        }
+        if (!admit(shard, entry.hash, size, false)) {
+            ++rejected_;
+            return;
+        }
+    }
+
+    const std::byte* source = entry.segment->data() + entry.body_offset;
+    auto body = std::make_shared<const std::vector<std::byte>>(source, source + size);
+    auto hot = std::make_shared<const HotEntry>(HotEntry{entry.hash, entry.metadata, std::move(body)});
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.lookup.contains(entry.hash)) {
+        return;
+    }
+    if (!admit(shard, entry.hash, size, true)) {
+        ++rejected_;
+        return;
+    }
+    shard.lru.push_front(std::move(hot));
+    shard.lookup[entry.hash] = shard.lru.begin();
+    shard.bytes += size;
+    hot_bytes_ += size;
+    ++admitted_;
+}
+
+std::optional<ObjectHandle> ObjectCache::find(const ContentHash& hash) {
+    ObjectHandle handle;
+    handle.hash_ = hash;
+
+    Shard& shard = shard_for(hash);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.sketch.increment(hash);
+        if (auto it = shard.lookup.find(hash); it != shard.lookup.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            const auto& entry = *it->second;
+            handle.metadata_ = entry->metadata;
+            handle.body_ = std::span<const std::byte>(*entry->body);
+            handle.owner_ = entry;
+            ++hot_hits_;
+            return handle;
+        }
+    }
+
+    std::shared_ptr<const WarmEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(warm_mutex_);
+        if (auto it = warm_.find(hash); it != warm_.end()) {
+            entry = it->second;
+        }
+    }
+    if (!entry) {
+        ++misses_;
+        return std::nullopt;
+    }
+    ++warm_hits_;
+    offer_hot(*entry);
+
+    handle.metadata_ = entry->metadata;
+    handle.body_ = std::span<const std::byte>(entry->segment->data() + entry->body_offset, entry->body_size);
+    handle.segment_ = entry->segment;
+    handle.file_offset_ = entry->body_offset;
+    handle.owner_ = entry;
+    return handle;
+}
+
+bool ObjectCache::contains(const ContentHash& hash) const {
+    std::lock_guard<std::mutex> lock(warm_mutex_);
+    return warm_.contains(hash);
+}
+
+std::expected<uint64_t, CacheError> ObjectCache::serve(Socket& socket, const ContentHash& hash,
+                                                       const std::optional<ByteRange>& range, uint64_t request_id) {
+    auto handle = find(hash);
+    if (!handle) {
+        return std::unexpected(CacheError::not_found);
+    }
+
+    uint64_t size = handle->body().size();
+    uint64_t first = 0;
+    uint64_t length = size;
+    ObjectResponse response;
+    response.status = 200;
+    if (range) {
+        if (range->first >= size || range->first > range->last) {
+            return std::unexpected(CacheError::range_not_satisfiable);
+        }
+        first = range->first;
+        length = std::min(range->last, size - 1) - first + 1;
+        response.status = 206;
+    }
+    response.etag = hash.to_string();
+    response.content_type = handle->metadata().content_type;
+    response.content_length = size;
+    response.last_modified = handle->metadata().last_modified;
+
+    // Frame header and message prefix go out together; the body follows untouched
+    auto built = reflect::build_message(response);
+    if (!built) {
+        return std::unexpected(CacheError::too_large);
+    }
+    std::vector<std::byte> prefix = std::move(*built);
+    if (!reflect::attach_trailing_bytes<&ObjectResponse::body>(prefix, length) ||
+        prefix.size() + length > UINT32_MAX) {
+        return std::unexpected(CacheError::too_large);
+    }
+
+    ProtocolHeader header{};
+    header.magic = PROTOCOL_MAGIC;
+    header.version = PROTOCOL_VERSION;
+    header.flags = message_flags<ObjectResponse>();
+    header.payload_length = static_cast<uint32_t>(prefix.size() + length);
+    header.request_id = request_id;
+    std::vector<std::byte> frame(sizeof(ProtocolHeader));
+    std::memcpy(frame.data(), &header, sizeof(header));
+    frame.insert(frame.end(), prefix.begin(), prefix.end());
+
+    if (!send_bytes(socket, frame)) {
+        return std::unexpected(CacheError::send_failed);
+    }
+
+    bool sent = false;
+#if defined(__linux__)
+    if (!handle->in_memory() && length > 0) {
+        sent = send_file_range(static_cast<int>(socket.get_native_handle()), handle->segment_->fd(),
+                               handle->file_offset_ + first, length);
+        if (!sent) {
+            return std::unexpected(CacheError::send_failed);
+        }
+        bytes_sendfile_ += length;
+    }
+#endif
+    if (!sent && !send_bytes(socket, handle->body().subspan(first, length))) {
+        return std::unexpected(CacheError::send_failed);
+    }
+
+    uint64_t total = frame.size() + length;
+    bytes_sent_ += total;
+    return total;
+}
+
+std::expected<uint64_t, CacheError> ObjectCache::serve(AsyncConnectionManager& manager, const std::string& connection_id,
+                                                       const ContentHash& hash, const std::optional<ByteRange>& range,
+                                                       uint64_t request_id) {
+    auto* connection = manager.get_connection(connection_id);
+    if (!connection || !connection->socket || !connection->socket->is_open()) {
+        return std::unexpected(CacheError::send_failed);
+    }
+    return serve(*connection->socket, hash, range, request_id);
+}
+
+ObjectCacheStats ObjectCache::get_stats() const {
+    ObjectCacheStats stats;
+    stats.hot_hits = hot_hits_.load();
+    stats.warm_hits = warm_hits_.load();
+    stats.misses = misses_.load();
+    stats.admitted = admitted_.load();
+    stats.rejected = rejected_.load();
+    stats.hot_evictions = hot_evictions_.load();
+    stats.segments_evicted = segments_evicted_.load();
+    stats.bytes_sent = bytes_sent_.load();
+    stats.bytes_sendfile = bytes_sendfile_.load();
+    stats.hot_bytes = hot_bytes_.load();
+
+    std::lock_guard<std::mutex> lock(warm_mutex_);
+    stats.warm_bytes = warm_bytes_;
+    stats.objects = warm_.size();
+    return stats;
+}
+
+} // namespace GalaxyCDN
+} // namespace network
+} // namespace dualstack
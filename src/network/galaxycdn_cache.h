@@ -0,0 +1,268 @@
+/**
+ * Amphisbaena 🐍 - GalaxyCDN Object Cache
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Content-addressed object cache for edge nodes:
+ *   - every object is written through to memory-mapped, append-only segment files (warm tier)
+ *   - small hot objects are also held in a sharded in-memory LRU (hot tier) guarded by
+ *     TinyLFU admission, so one-hit wonders never displace popular objects
+ *   - responses are GalaxyCDN ObjectResponse frames whose body is streamed with
+ *     sendfile straight from the segment file; byte ranges map to file offsets
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "async_connection_manager.h"
+#include "galaxycdn_messages.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace GalaxyCDN {
+
+/**
+ * @brief 256-bit content hash (SHA-256 of the object body)
+ *
+ * The hash is the object's identity and ETag, so it has to be collision
+ * resistant: a forged body with a matching hash would be served in place
+ * of the real one.
+ */
+struct AMPHISBAENA_API ContentHash {
+    std::array<uint64_t, 4> words{};   // Digest as four big-endian words
+
+    static ContentHash of(std::span<const std::byte> content);
+    static std::optional<ContentHash> from_string(std::string_view hex);
+    std::string to_string() const;     // 64 lowercase hex digits; also the ETag
+
+    bool operator==(const ContentHash&) const = default;
+
+    struct Hasher {
+        size_t operator()(const ContentHash& hash) const { return static_cast<size_t>(hash.words[3]); }
+    };
+};
+
+/**
+ * @brief Per-object metadata stored alongside the body
+ */
+struct AMPHISBAENA_API ObjectMetadata {
+    std::string content_type;
+    std::chrono::system_clock::time_point last_modified{};
+    std::chrono::system_clock::time_point expires_at{};
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(content_type);
+        DUALSTACK_REFLECT_MEMBER(last_modified);
+        DUALSTACK_REFLECT_MEMBER(expires_at);
+    }
+};
+
+enum class CacheError : uint8_t {
+    io_error,               // Segment directory or file could not be created, grown or mapped
+    not_found,
+    range_not_satisfiable,
+    too_large,              // Response exceeds the 4 GiB GalaxyCDN payload limit
+    send_failed
+};
+
+AMPHISBAENA_API const char* describe(CacheError error);
+
+/**
+ * @brief Object Cache Configuration
+ */
+struct AMPHISBAENA_API ObjectCacheConfig {
+    std::string segment_directory;                  // Created if missing; existing segments are reloaded
+
+    // Hot tier
+    size_t shard_count = 16;                        // Rounded up to a power of two
+    size_t hot_capacity_bytes = 256ull * 1024 * 1024;
+    size_t max_hot_object_bytes = 1024 * 1024;      // Larger objects are always served from segments
+
+    // TinyLFU: counters per shard sketch, and accesses per shard before counters are halved
+    size_t sketch_counters = 4096;
+    size_t sketch_sample_size = 40960;
+
+    // Warm tier
+    size_t segment_bytes = 64ull * 1024 * 1024;     // Objects larger than this get a segment of their own
+    size_t warm_capacity_bytes = 4ull * 1024 * 1024 * 1024;
+};
+
+/**
+ * @brief Object Cache Statistics
+ */
+struct AMPHISBAENA_API ObjectCacheStats {
+    uint64_t hot_hits = 0;
+    uint64_t warm_hits = 0;
+    uint64_t misses = 0;
+    uint64_t admitted = 0;          // Objects taken into the hot tier
+    uint64_t rejected = 0;          // Hot-tier candidates refused by TinyLFU
+    uint64_t hot_evictions = 0;
+    uint64_t segments_evicted = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_sendfile = 0;    // Of bytes_sent, body bytes the kernel copied from segment files
+    size_t hot_bytes = 0;
+    size_t warm_bytes = 0;
+    size_t objects = 0;
+};
+
+class CacheSegment;
+
+/**
+ * @brief Reference to a cached object
+ *
+ * Keeps the object's memory (hot) or segment mapping (warm) alive, so the
+ * body stays readable even if the cache evicts it meanwhile.
+ */
+class AMPHISBAENA_API ObjectHandle {
+public:
+    const ContentHash& hash() const { return hash_; }
+    const ObjectMetadata& metadata() const { return *metadata_; }
+    std::span<const std::byte> body() const { return body_; }
+    bool in_memory() const { return segment_ == nullptr; }
+
+private:
+    friend class ObjectCache;
+
+    ContentHash hash_;
+    std::shared_ptr<const ObjectMetadata> metadata_;
+    std::span<const std::byte> body_;
+    std::shared_ptr<const void> owner_;             // Hot body or warm entry
+    std::shared_ptr<CacheSegment> segment_;         // Set when the body lives in a segment file
+    uint64_t file_offset_ = 0;                      // Body offset within the segment file
+};
+
+/**
+ * @brief GalaxyCDN Object Cache
+ */
+class AMPHISBAENA_API ObjectCache {
+public:
+    static std::expected<std::unique_ptr<ObjectCache>, CacheError> open(const ObjectCacheConfig& config);
+    ~ObjectCache();
+
+    ObjectCache(const ObjectCache&) = delete;
+    ObjectCache& operator=(const ObjectCache&) = delete;
+
+    /**
+     * @brief Store an object; storing the same content again only updates its metadata
+     */
+    std::expected<ContentHash, CacheError> put(std::span<const std::byte> body, const ObjectMetadata& metadata);
+
+    /**
+     * @brief Look up an object, counting the access for admission
+     */
+    std::optional<ObjectHandle> find(const ContentHash& hash);
+
+    bool contains(const ContentHash& hash) const;
+
+    /**
+     * @brief Send an ObjectResponse frame for the object (or one byte range of it)
+     *
+     * Status is 200, or 206 for a range. The body follows the message prefix on
+     * the wire and, for warm objects, is sent with sendfile from the segment.
+     * @return Bytes written to the socket
+     */
+    std::expected<uint64_t, CacheError> serve(Socket& socket, const ContentHash& hash,
+                                              const std::optional<ByteRange>& range, uint64_t request_id);
+    std::expected<uint64_t, CacheError> serve(AsyncConnectionManager& manager, const std::string& connection_id,
+                                              const ContentHash& hash, const std::optional<ByteRange>& range,
+                                              uint64_t request_id);
+
+    ObjectCacheStats get_stats() const;
+
+private:
+    struct HotEntry {
+        ContentHash hash;
+        std::shared_ptr<const ObjectMetadata> metadata;
+        std::shared_ptr<const std::vector<std::byte>> body;
+    };
+
+    struct WarmEntry {
+        ContentHash hash;
+        std::shared_ptr<const ObjectMetadata> metadata;
+        std::shared_ptr<CacheSegment> segment;
+        uint64_t body_offset = 0;
+        uint64_t body_size = 0;
+    };
+
+    // Count-min sketch (4 rows, counters saturate at 15), halved every sample_size increments
+    class FrequencySketch {
+    public:
+        FrequencySketch(size_t counters, size_t sample_size);
+        void increment(const ContentHash& hash);
+        uint32_t estimate(const ContentHash& hash) const;
+
+    private:
+        size_t index(const ContentHash& hash, size_t row) const;
+
+        std::vector<uint8_t> counters_;
+        size_t mask_;
+        size_t sample_size_;
+        size_t additions_ = 0;
+    };
+
+    struct Shard {
+        explicit Shard(size_t counters, size_t sample_size) : sketch(counters, sample_size) {}
+
+        std::mutex mutex;
+        std::list<std::shared_ptr<const HotEntry>> lru;     // Most recently used first
+        std::unordered_map<ContentHash, std::list<std::shared_ptr<const HotEntry>>::iterator,
+                           ContentHash::Hasher> lookup;
+        FrequencySketch sketch;
+        size_t bytes = 0;
+    };
+
+    explicit ObjectCache(const ObjectCacheConfig& config);
+
+    std::expected<void, CacheError> load_segments();
+    std::expected<std::shared_ptr<CacheSegment>, CacheError> segment_for(uint64_t record_size);
+    void evict_segments();
+
+    Shard& shard_for(const ContentHash& hash) { return *shards_[hash.words[3] & shard_mask_]; }
+    // TinyLFU: room for the candidate, evicting LRU victims it out-scores; caller holds shard.mutex.
+    // With evict = false only reports whether it would be admitted.
+    bool admit(Shard& shard, const ContentHash& candidate, size_t size, bool evict);
+    void offer_hot(const WarmEntry& entry);
+
+    ObjectCacheConfig config_;
+    size_t shard_mask_ = 0;
+    size_t shard_capacity_ = 0;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    mutable std::mutex warm_mutex_;
+    std::unordered_map<ContentHash, std::shared_ptr<const WarmEntry>, ContentHash::Hasher> warm_;
+    std::deque<std::shared_ptr<CacheSegment>> segments_;    // Oldest first; back is the append target
+    uint64_t next_segment_sequence_ = 0;
+    size_t warm_bytes_ = 0;
+
+    std::atomic<uint64_t> hot_hits_{0};
+    std::atomic<uint64_t> warm_hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> admitted_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> hot_evictions_{0};
+    std::atomic<uint64_t> segments_evicted_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> bytes_sendfile_{0};
+    std::atomic<size_t> hot_bytes_{0};
+};
+
+} // namespace GalaxyCDN
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,403 @@
+/**
+ * Amphisbaena 🐍 - GalaxyCDN Coalescing Origin Fetcher Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "galaxycdn_fetcher.h"
+#include <algorithm>
+
+namespace dualstack {
+namespace network {
+namespace GalaxyCDN {
+
+namespace {
+
+// Catalog and flight key; the length prefix keeps ("a.b", "/c") apart from ("a.b/", "c")
+std::string flight_id(const std::string& host, const std::string& key) {
+    return std::to_string(host.size()) + ':' + host + key;
+}
+
+} // namespace
+
+const char* describe(FetchError error) {
+    switch (error) {
+        case FetchError::origin_unavailable: return "origin unavailable";
+        case FetchError::origin_error: return "origin returned an error status";
+        case FetchError::invalid_response: return "invalid origin response";
+        case FetchError::cache_error: return "object could not be cached";
+    }
+    return "unknown fetch error";
+}
+
+CoalescingFetcher::CoalescingFetcher(ObjectCache& cache, AsyncConnectionManager& manager, FetcherConfig config)
+    : cache_(cache), manager_(manager), config_(std::move(config)), origin_id_(config_.origin_connection_id) {
+    if (auto* origin = manager_.get_connection(origin_id_)) {
+        origin_addr_ = origin->remote_addr;
+        origin_port_ = origin->remote_port;
+    }
+    reader_ = std::thread(&CoalescingFetcher::read_loop, this);
+    worker_ = std::thread(&CoalescingFetcher::revalidate_loop, this);
+}
+
+CoalescingFetcher::~CoalescingFetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    revalidate_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(origin_mutex_);
+        origin_stopping_ = true;
+    }
+    origin_cv_.notify_all();
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+    // Connections dialled after a reset belong to the fetcher; the configured one to the caller
+    if (!origin_id_.empty() && origin_id_ != config_.origin_connection_id) {
+        manager_.close_connection(origin_id_);
+    }
+}
+
+std::expected<FetchResult, FetchError> CoalescingFetcher::fetch(const std::string& host, const std::string& key) {
+    std::string id = flight_id(host, key);
+    std::promise<Outcome> promise;
+    std::shared_future<Outcome> flight;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        if (auto it = catalog_.find(id); it != catalog_.end() && cache_.contains(it->second.hash)) {
+            CatalogEntry& entry = it->second;
+            if (now < entry.fresh_until) {
+                ++fresh_hits_;
+                return FetchResult{entry.hash, FetchSource::fresh_hit};
+            }
+            if (now < entry.fresh_until + config_.stale_while_revalidate) {
+                if (!entry.revalidating && !in_flight_.contains(id)) {
+                    entry.revalidating = true;
+                    revalidate_queue_.emplace_back(host, key);
+                    revalidate_cv_.notify_one();
+                }
+                ++stale_hits_;
+                return FetchResult{entry.hash, FetchSource::stale_hit};
+            }
+        }
+        if (auto it = in_flight_.find(id); it != in_flight_.end()) {
+            flight = it->second;
+        } else {
+            in_flight_.emplace(id, promise.get_future().share());
+        }
+    }
+
+    if (flight.valid()) {
+        ++coalesced_;
+        const Outcome& outcome = flight.get();
+        if (!outcome) {
+            return std::unexpected(outcome.error());
+        }
+        return FetchResult{*outcome, FetchSource::coalesced};
+    }
+
+    Outcome outcome = lead(id, host, key, std::move(promise));
+    if (!outcome) {
+        return std::unexpected(outcome.error());
+    }
+    return FetchResult{*outcome, FetchSource::origin};
+}
+
+CoalescingFetcher::Outcome CoalescingFetcher::lead(const std::string& id, const std::string& host,
+                                                   const std::string& key, std::promise<Outcome> promise) {
+    Outcome outcome = std::unexpected(FetchError::origin_unavailable);
+    try {
+        // Revalidate with the cached copy's ETag when there is one
+        std::string etag;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (auto it = catalog_.find(id); it != catalog_.end() && cache_.contains(it->second.hash)) {
+                etag = it->second.hash.to_string();
+            }
+        }
+
+        outcome = exchange(host, key, etag);
+        if (outcome) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            CatalogEntry& entry = catalog_[id];
+            entry.hash = *outcome;
+            entry.fresh_until = Clock::now() + config_.ttl;
+            entry.revalidating = false;
+        }
+    } catch (const std::exception&) {
+        // Allocation failures and the like fail this flight instead of stranding its followers
+        outcome = std::unexpected(FetchError::origin_unavailable);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!outcome) {
+            ++errors_;
+            // A failed revalidation keeps serving the stale copy until its grace period ends
+            if (auto it = catalog_.find(id); it != catalog_.end()) {
+                it->second.revalidating = false;
+            }
+        }
+        in_flight_.erase(id);
+    }
+    promise.set_value(outcome);
+    return outcome;
+}
+
+CoalescingFetcher::Outcome CoalescingFetcher::exchange(const std::string& host, const std::string& key,
+                                                       const std::string& etag) {
+    ObjectRequest request;
+    request.host = host;
+    request.key = key;
+    request.if_none_match = etag;
+
+    PendingResponse pending;
+    pending.deadline = Clock::now() + config_.response_timeout;
+    if (!send_request(request, pending)) {
+        return std::unexpected(FetchError::origin_unavailable);
+    }
+    {
+        // The reader fills in the response, or fails it by the deadline
+        std::unique_lock<std::mutex> lock(origin_mutex_);
+        origin_cv_.wait(lock, [&pending] { return pending.done; });
+    }
+    if (!pending.header) {
+        return std::unexpected(pending.header.error());
+    }
+    auto response = view_message<ObjectResponse>(*pending.header, pending.payload);
+    if (!response) {
+        return std::unexpected(FetchError::invalid_response);
+    }
+
+    uint16_t status = response->get<&ObjectResponse::status>();
+    if (status == 304 && !etag.empty()) {
+        ++not_modified_;
+        if (auto hash = ContentHash::from_string(etag)) {
+            return *hash;
+        }
+    }
+    if (status != 200) {
+        return std::unexpected(FetchError::origin_error);
+    }
+
+    ObjectMetadata metadata;
+    metadata.content_type = std::string(response->get<&ObjectResponse::content_type>());
+    metadata.last_modified = response->get<&ObjectResponse::last_modified>();
+    metadata.expires_at = std::chrono::system_clock::now() + config_.ttl;
+    auto stored = cache_.put(response->get<&ObjectResponse::body>().bytes(), metadata);
+    if (!stored) {
+        return std::unexpected(FetchError::cache_error);
+    }
+    return *stored;
+}
+
+bool CoalescingFetcher::send_request(const ObjectRequest& request, PendingResponse& pending) {
+    for (;;) {
+        {
+            // A connection left broken by a failed send is closed by the reader first
+            std::unique_lock<std::mutex> lock(origin_mutex_);
+            origin_cv_.wait(lock, [this] { return !origin_broken_ || origin_stopping_; });
+            if (origin_stopping_) {
+                return false;
+            }
+        }
+        std::lock_guard<std::mutex> send_lock(send_mutex_);
+        std::unique_lock<std::mutex> lock(origin_mutex_);
+        if (origin_broken_) {
+            continue;
+        }
+        if (origin_id_.empty()) {
+            lock.unlock();
+            std::string dialled = dial_origin();
+            lock.lock();
+            if (dialled.empty()) {
+                return false;
+            }
+            origin_id_ = std::move(dialled);
+        }
+
+        // Registered before sending, so the reader knows the id however fast the reply comes
+        uint64_t request_id = next_request_id_++;
+        pending_.emplace(request_id, &pending);
+        std::string connection = origin_id_;
+        ++origin_fetches_;
+        lock.unlock();
+        origin_cv_.notify_all();
+
+        bool sent = send_message(manager_, connection, request, request_id);
+        lock.lock();
+        if (!sent) {
+            // Part of the frame may be out; nothing more can go on this connection
+            pending_.erase(request_id);
+            origin_broken_ = true;
+            origin_cv_.notify_all();
+        }
+        return sent;
+    }
+}
+
+void CoalescingFetcher::reset_origin(FetchError error) {
+    std::lock_guard<std::mutex> send_lock(send_mutex_);
+    std::lock_guard<std::mutex> lock(origin_mutex_);
+    if (!origin_id_.empty()) {
+        manager_.close_connection(origin_id_);
+        origin_id_.clear();
+    }
+    origin_broken_ = false;
+    for (auto& [request_id, pending] : pending_) {
+        pending->header = std::unexpected(error);
+        pending->done = true;
+    }
+    pending_.clear();
+    origin_cv_.notify_all();
+}
+
+std::string CoalescingFetcher::dial_origin() {
+    if (origin_port_ == 0) {
+        return {};
+    }
+    try {
+        return manager_.create_async_connection(origin_addr_, origin_port_);
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+void CoalescingFetcher::read_loop() {
+    std::vector<std::byte> payload;
+    for (;;) {
+        std::string connection;
+        Clock::time_point deadline;
+        {
+            std::unique_lock<std::mutex> lock(origin_mutex_);
+            origin_cv_.wait(lock, [this] { return origin_stopping_ || origin_broken_ || !pending_.empty(); });
+            if (origin_stopping_) {
+                return;
+            }
+            if (origin_broken_) {
+                lock.unlock();
+                reset_origin(FetchError::origin_unavailable);
+                continue;
+            }
+            // Read until the oldest exchange's deadline; missing it stalls every later one too
+            connection = origin_id_;
+            deadline = Clock::time_point::max();
+            for (const auto& [request_id, pending] : pending_) {
+                deadline = std::min(deadline, pending->deadline);
+            }
+        }
+
+        std::expected<ProtocolHeader, error_code> header = std::unexpected(error_code::receive_failed);
+        try {
+            header = manager_.receive_galaxycdn_frame(connection, payload, deadline, config_.max_response_size);
+        } catch (const std::bad_alloc&) {
+            // Payload under the cap but still too large to buffer; its body is left unread
+        }
+        if (!header) {
+            reset_origin(header.error() == error_code::invalid_address ? FetchError::invalid_response
+                                                                       : FetchError::origin_unavailable);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(origin_mutex_);
+        auto it = pending_.find(header->request_id);
+        if (it == pending_.end()) {
+            // An answer to nothing we asked: the origin and this side disagree on the stream
+            lock.unlock();
+            reset_origin(FetchError::invalid_response);
+            continue;
+        }
+        PendingResponse& pending = *it->second;
+        pending_.erase(it);
+        pending.header = *header;
+        pending.payload.swap(payload);
+        pending.done = true;
+        origin_cv_.notify_all();
+    }
+}
+
+void CoalescingFetcher::revalidate_loop() {
+    for (;;) {
+        std::pair<std::string, std::string> next;
+        std::string id;
+        std::promise<Outcome> promise;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            revalidate_cv_.wait(lock, [this] { return stopping_ || !revalidate_queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            next = std::move(revalidate_queue_.front());
+            revalidate_queue_.pop_front();
+            id = flight_id(next.first, next.second);
+            if (in_flight_.contains(id)) {
+                continue;       // A foreground miss is already refreshing it
+            }
+            in_flight_.emplace(id, promise.get_future().share());
+        }
+        ++revalidations_;
+        lead(id, next.first, next.second, std::move(promise));
+    }
+}
+
+bool CoalescingFetcher::handle(AsyncConnectionManager& clients, const std::string& connection_id,
+                               const ObjectRequest& request, uint64_t request_id) {
+    auto send_status = [&](uint16_t status, std::string etag) {
+        ObjectResponse response;
+        response.status = status;
+        response.etag = std::move(etag);
+        return send_message(clients, connection_id, response, request_id);
+    };
+
+    auto fetched = fetch(request.host, request.key);
+    if (!fetched) {
+        return send_status(502, {});
+    }
+    std::string etag = fetched->hash.to_string();
+    if (!request.if_none_match.empty() && request.if_none_match == etag) {
+        return send_status(304, std::move(etag));
+    }
+
+    // A response carries a single body, so several ranges cannot be served together
+    if (request.ranges.size() > 1) {
+        return send_status(416, std::move(etag));
+    }
+    std::optional<ByteRange> range;
+    if (!request.ranges.empty()) {
+        range = request.ranges.front();
+    }
+    auto served = cache_.serve(clients, connection_id, fetched->hash, range, request_id);
+    if (served) {
+        return true;
+    }
+    switch (served.error()) {
+        case CacheError::range_not_satisfiable: return send_status(416, std::move(etag));
+        case CacheError::not_found: return send_status(503, {});        // Evicted between fetch and serve
+        default: return false;
+    }
+}
+
+FetcherStats CoalescingFetcher::get_stats() const {
+    FetcherStats stats;
+    stats.fresh_hits = fresh_hits_.load();
+    stats.stale_hits = stale_hits_.load();
+    stats.coalesced = coalesced_.load();
+    stats.origin_fetches = origin_fetches_.load();
+    stats.revalidations = revalidations_.load();
+    stats.not_modified = not_modified_.load();
+    stats.errors = errors_.load();
+    return stats;
+}
+
+} // namespace GalaxyCDN
+} // namespace network
+} // namespace dualstack
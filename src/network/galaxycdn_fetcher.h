@@ -0,0 +1,189 @@
+/**
+ * Amphisbaena 🐍 - GalaxyCDN Coalescing Origin Fetcher
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Maps request keys to cached content and fills misses from the origin:
+ *   - single flight: concurrent misses for one key attach to the request already
+ *     in flight and all complete from its result, so the origin sees one fetch
+ *   - stale-while-revalidate: an expired object is still served for a grace
+ *     period while a background worker revalidates it (If-None-Match = ETag)
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "galaxycdn_cache.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <expected>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace GalaxyCDN {
+
+enum class FetchError : uint8_t {
+    origin_unavailable,     // Origin connection missing, or the exchange failed
+    origin_error,           // Origin answered with a status other than 200/304
+    invalid_response,       // Origin frame failed validation or answered another request
+    cache_error             // Object could not be stored
+};
+
+AMPHISBAENA_API const char* describe(FetchError error);
+
+enum class FetchSource : uint8_t {
+    fresh_hit,
+    stale_hit,              // Served past its TTL; a revalidation is queued
+    coalesced,              // Waited on another request's origin fetch
+    origin
+};
+
+struct AMPHISBAENA_API FetchResult {
+    ContentHash hash;
+    FetchSource source = FetchSource::origin;
+};
+
+/**
+ * @brief Fetcher Configuration
+ */
+struct AMPHISBAENA_API FetcherConfig {
+    std::string origin_connection_id;               // AsyncConnectionManager connection to the origin
+    std::chrono::seconds ttl{60};                   // Freshness after each successful fetch or revalidation
+    std::chrono::seconds stale_while_revalidate{30};
+    std::chrono::milliseconds response_timeout{10000};     // Per origin exchange, from send to full response
+    uint32_t max_response_size = 256u * 1024 * 1024;       // Larger response frames are refused unread
+};
+
+/**
+ * @brief Fetcher Statistics
+ */
+struct AMPHISBAENA_API FetcherStats {
+    uint64_t fresh_hits = 0;
+    uint64_t stale_hits = 0;
+    uint64_t coalesced = 0;
+    uint64_t origin_fetches = 0;    // Frames exchanged with the origin, revalidations included
+    uint64_t revalidations = 0;
+    uint64_t not_modified = 0;
+    uint64_t errors = 0;
+};
+
+/**
+ * @brief Single-flight origin fetcher in front of an ObjectCache
+ *
+ * Origin exchanges share one connection, multiplexed by request id: senders
+ * take turns only to write their frame, and a reader thread hands each
+ * response to the exchange waiting on its id. A failed send or read, a
+ * timeout or a response to an unknown id leaves the stream position unknown,
+ * so the connection is closed, every exchange on it fails, and the next one
+ * redials the origin (TCP origins only; a local origin connection is not
+ * re-established).
+ */
+class AMPHISBAENA_API CoalescingFetcher {
+public:
+    CoalescingFetcher(ObjectCache& cache, AsyncConnectionManager& manager, FetcherConfig config);
+    ~CoalescingFetcher();
+
+    CoalescingFetcher(const CoalescingFetcher&) = delete;
+    CoalescingFetcher& operator=(const CoalescingFetcher&) = delete;
+
+    /**
+     * @brief Resolve host + key to cached content, fetching from the origin on a miss
+     */
+    std::expected<FetchResult, FetchError> fetch(const std::string& host, const std::string& key);
+
+    /**
+     * @brief Answer a client's ObjectRequest on a managed connection
+     *
+     * Sends 304 when If-None-Match matches, the requested range (206) or the
+     * whole object (200) from the cache, 416 for an unsatisfiable range or a
+     * request for several ranges (a response carries one body), and 502 when
+     * the origin fetch fails.
+     * @return true if a response was sent
+     */
+    bool handle(AsyncConnectionManager& clients, const std::string& connection_id,
+                const ObjectRequest& request, uint64_t request_id);
+
+    FetcherStats get_stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Outcome = std::expected<ContentHash, FetchError>;
+
+    struct CatalogEntry {
+        ContentHash hash;
+        Clock::time_point fresh_until;
+        bool revalidating = false;
+    };
+
+    // An exchange waiting for its response frame
+    struct PendingResponse {
+        Clock::time_point deadline;
+        bool done = false;
+        std::expected<ProtocolHeader, FetchError> header = std::unexpected(FetchError::origin_unavailable);
+        std::vector<std::byte> payload;
+    };
+
+    // Fetch for the flight registered under id, publish the outcome and wake followers.
+    // Never throws: the flight is removed and the promise fulfilled on every path.
+    Outcome lead(const std::string& id, const std::string& host, const std::string& key,
+                 std::promise<Outcome> promise);
+    Outcome exchange(const std::string& host, const std::string& key, const std::string& etag);
+    // Send request and register it under a fresh request id
+    bool send_request(const ObjectRequest& request, PendingResponse& pending);
+    // Close the connection and fail every pending exchange with error; reader thread only
+    void reset_origin(FetchError error);
+    std::string dial_origin();
+    void read_loop();
+    void revalidate_loop();
+
+    ObjectCache& cache_;
+    AsyncConnectionManager& manager_;
+    FetcherConfig config_;
+
+    // Keyed by a length-prefixed host + key, so distinct pairs never share an entry
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, CatalogEntry> catalog_;
+    std::unordered_map<std::string, std::shared_future<Outcome>> in_flight_;
+
+    // Lock order: send_mutex_, then origin_mutex_. The connection is only
+    // closed by the reader with both held, so no send or read is using it.
+    std::mutex send_mutex_;                         // One frame at a time goes out on the origin connection
+    std::mutex origin_mutex_;                       // Guards the origin state below
+    std::condition_variable origin_cv_;             // Responses delivered, requests registered, resets
+    std::string origin_id_;                         // Current origin connection; empty after a reset
+    IPAddress origin_addr_;                         // Redialled after a reset; port 0 if not TCP
+    port_t origin_port_ = 0;
+    uint64_t next_request_id_ = 1;
+    std::unordered_map<uint64_t, PendingResponse*> pending_;   // By request id, all on origin_id_
+    bool origin_broken_ = false;                    // A send failed; the reader resets before the next one
+    bool origin_stopping_ = false;
+    std::thread reader_;
+
+    std::thread worker_;
+    std::condition_variable revalidate_cv_;
+    std::deque<std::pair<std::string, std::string>> revalidate_queue_;     // host, key
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> fresh_hits_{0};
+    std::atomic<uint64_t> stale_hits_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> origin_fetches_{0};
+    std::atomic<uint64_t> revalidations_{0};
+    std::atomic<uint64_t> not_modified_{0};
+    std::atomic<uint64_t> errors_{0};
+};
+
+} // namespace GalaxyCDN
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,289 @@
+/**
+ * Amphisbaena 🐍 - GalaxyCDN Maglev Node Selection Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "galaxycdn_maglev.h"
+#include <algorithm>
+#include <bit>
+
+namespace dualstack {
+namespace network {
+namespace GalaxyCDN {
+
+namespace {
+
+// Routing needs speed and spread, not collision resistance, so keys are
+// placed with MurmurHash3 x64/128 (public domain, Austin Appleby) rather than
+// the cache's SHA-256 content hash
+struct RoutingHash {
+    uint64_t high = 0;
+    uint64_t low = 0;
+};
+
+auto fmix64(uint64_t k) -> uint64_t {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+auto load_u64(const char* p) -> uint64_t {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value |= uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+    }
+    return value;
+}
+
+auto hash_of(std::string_view text) -> RoutingHash {
+    constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+    constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+    const char* in = text.data();
+    size_t blocks = text.size() / 16;
+    uint64_t h1 = 0;
+    uint64_t h2 = 0;
+
+    for (size_t i = 0; i < blocks; ++i) {
+        uint64_t k1 = load_u64(in + i * 16);
+        uint64_t k2 = load_u64(in + i * 16 + 8);
+        k1 *= c1; k1 = std::rotl(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = std::rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+        k2 *= c2; k2 = std::rotl(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = std::rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const char* tail = in + blocks * 16;
+    size_t rest = text.size() & 15;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t i = rest; i > 8; --i) {
+        k2 |= uint64_t{static_cast<unsigned char>(tail[i - 1])} << (8 * (i - 9));
+    }
+    for (size_t i = std::min<size_t>(rest, 8); i > 0; --i) {
+        k1 |= uint64_t{static_cast<unsigned char>(tail[i - 1])} << (8 * (i - 1));
+    }
+    if (rest > 8) {
+        k2 *= c2; k2 = std::rotl(k2, 33); k2 *= c1; h2 ^= k2;
+    }
+    if (rest > 0) {
+        k1 *= c1; k1 = std::rotl(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= text.size();
+    h2 ^= text.size();
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+    return RoutingHash{h1, h2};
+}
+
+auto is_prime(size_t n) -> bool {
+    if (n < 2) {
+        return false;
+    }
+    for (size_t d = 2; d * d <= n; ++d) {
+        if (n % d == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+uint64_t maglev_hash(std::string_view key) {
+    return hash_of(key).low;
+}
+
+uint64_t maglev_hash(std::string_view host, std::string_view key) {
+    // Combined without concatenating, so routing never allocates
+    return (hash_of(host).high * 0x9E3779B97F4A7C15ULL) ^ hash_of(key).low;
+}
+
+// ============================================================================
+// MaglevTable
+// ============================================================================
+
+size_t MaglevTable::next_prime(size_t n) {
+    while (!is_prime(n)) {
+        ++n;
+    }
+    return n;
+}
+
+MaglevTable::MaglevTable(std::vector<MaglevNode> nodes, size_t size) : nodes_(std::move(nodes)) {
+    uint32_t max_weight = 0;
+    for (const MaglevNode& node : nodes_) {
+        max_weight = std::max(max_weight, node.weight);
+    }
+    if (max_weight == 0) {
+        return;
+    }
+    const size_t table_size = next_prime(std::max<size_t>(size, 3));
+
+    // Node i visits slots offset, offset + skip, offset + 2 skip, ... (mod the
+    // prime size, so every slot is reached); both come from the name alone
+    struct Walk {
+        size_t position;
+        size_t skip;
+        uint64_t credit = 0;
+    };
+    std::vector<Walk> walks;
+    walks.reserve(nodes_.size());
+    for (const MaglevNode& node : nodes_) {
+        RoutingHash hash = hash_of(node.name);
+        walks.push_back({static_cast<size_t>(hash.high % table_size),
+                         static_cast<size_t>(hash.low % (table_size - 1)) + 1});
+    }
+
+    entries_.assign(table_size, NO_NODE);
+    size_t filled = 0;
+    while (filled < table_size) {
+        for (size_t i = 0; i < nodes_.size() && filled < table_size; ++i) {
+            // A node claims one slot per max_weight of credit it has accrued
+            Walk& walk = walks[i];
+            walk.credit += nodes_[i].weight;
+            while (walk.credit >= max_weight && filled < table_size) {
+                walk.credit -= max_weight;
+                while (entries_[walk.position] != NO_NODE) {
+                    walk.position = (walk.position + walk.skip) % table_size;
+                }
+                entries_[walk.position] = static_cast<uint32_t>(i);
+                walk.position = (walk.position + walk.skip) % table_size;
+                ++filled;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// MaglevRing
+// ============================================================================
+
+MaglevRing::MaglevRing(size_t table_size)
+    : table_size_(table_size), table_(std::make_shared<const MaglevTable>()) {
+    worker_ = std::thread(&MaglevRing::build_loop, this);
+}
+
+MaglevRing::~MaglevRing() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+uint64_t MaglevRing::update(std::vector<MaglevNode> nodes) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = std::move(nodes);
+        generation = ++requested_;
+    }
+    cv_.notify_all();
+    return generation;
+}
+
+bool MaglevRing::wait_for(uint64_t generation, std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [&] { return built_ >= generation; });
+}
+
+uint64_t MaglevRing::generation() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return built_;
+}
+
+void MaglevRing::build_loop() {
+    for (;;) {
+        std::vector<MaglevNode> nodes;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || pending_.has_value(); });
+            if (stopping_) {
+                return;
+            }
+            nodes = std::move(*pending_);
+            pending_.reset();
+            generation = requested_;
+        }
+
+        auto table = std::make_shared<const MaglevTable>(std::move(nodes), table_size_);
+        table_.store(std::move(table), std::memory_order_release);
+        ++builds_;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            built_ = generation;
+        }
+        cv_.notify_all();
+    }
+}
+
+// ============================================================================
+// EdgeRouter
+// ============================================================================
+
+EdgeRouter::EdgeRouter(AsyncConnectionManager& manager, size_t table_size)
+    : manager_(manager), ring_(table_size) {}
+
+uint64_t EdgeRouter::set_nodes(std::vector<EdgeNode> nodes) {
+    std::vector<MaglevNode> members;
+    members.reserve(nodes.size());
+    {
+        std::unique_lock<std::shared_mutex> lock(connections_mutex_);
+        connections_.clear();
+        for (EdgeNode& node : nodes) {
+            members.push_back({node.node_id, node.weight});
+            connections_[std::move(node.node_id)] = std::move(node.connection_id);
+        }
+    }
+    return ring_.update(std::move(members));
+}
+
+std::optional<std::string> EdgeRouter::node_for(std::string_view host, std::string_view key) const {
+    auto table = ring_.table();
+    if (const MaglevNode* node = table->find(maglev_hash(host, key))) {
+        return node->name;
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> EdgeRouter::route(std::string_view host, std::string_view key) const {
+    auto table = ring_.table();
+    const MaglevNode* node = table->find(maglev_hash(host, key));
+    if (!node) {
+        return std::nullopt;
+    }
+    std::string connection_id;
+    {
+        std::shared_lock<std::shared_mutex> lock(connections_mutex_);
+        auto it = connections_.find(node->name);
+        if (it == connections_.end()) {
+            return std::nullopt;        // Removed; the rebuilt table has not landed yet
+        }
+        connection_id = it->second;
+    }
+    ConnectionState* state = manager_.get_connection(connection_id);
+    if (!state || !state->active) {
+        return std::nullopt;
+    }
+    return connection_id;
+}
+
+} // namespace GalaxyCDN
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,174 @@
+/**
+ * Amphisbaena 🐍 - GalaxyCDN Maglev Node Selection
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Consistent hashing of request keys onto GalaxyCDN nodes (Maglev, NSDI '16):
+ *   - each node walks its own permutation of a prime-sized table, claiming
+ *     free slots in turn; a lookup is one multiply and one array read
+ *   - weighted nodes take proportionally more turns, so more slots
+ *   - a membership change moves little more than the keys of the nodes
+ *     that came or went, unlike modulo hashing
+ *   - tables are rebuilt on a background thread and swapped atomically;
+ *     readers never wait on a rebuild
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "galaxycdn_cache.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace GalaxyCDN {
+
+struct MaglevNode {
+    std::string name;               // Stable identity; seeds the node's permutation
+    uint32_t weight = 1;            // Relative share of the table; 0 leaves the node out
+};
+
+/**
+ * @brief Hash a request key for MaglevTable::lookup
+ */
+AMPHISBAENA_API uint64_t maglev_hash(std::string_view key);
+AMPHISBAENA_API uint64_t maglev_hash(std::string_view host, std::string_view key);
+
+/**
+ * @brief Immutable Maglev lookup table
+ *
+ * Keep the table size at least 100x the node count, so weights are honoured
+ * to within about one percent.
+ */
+class AMPHISBAENA_API MaglevTable {
+public:
+    static constexpr size_t DEFAULT_SIZE = 65537;
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    MaglevTable() = default;
+    // The size is rounded up to a prime
+    explicit MaglevTable(std::vector<MaglevNode> nodes, size_t size = DEFAULT_SIZE);
+
+    // Index into nodes(), or NO_NODE for a table without nodes
+    uint32_t lookup(uint64_t hash) const {
+        if (entries_.empty()) {
+            return NO_NODE;
+        }
+#if defined(__SIZEOF_INT128__)
+        // Multiply-shift range reduction: uniform like %, without the division
+        __extension__ using wide = unsigned __int128;
+        return entries_[static_cast<size_t>((static_cast<wide>(hash) * entries_.size()) >> 64)];
+#else
+        return entries_[hash % entries_.size()];
+#endif
+    }
+    // Node owning the key, or nullptr for a table without nodes
+    const MaglevNode* find(uint64_t hash) const {
+        uint32_t index = lookup(hash);
+        return index == NO_NODE ? nullptr : &nodes_[index];
+    }
+
+    const std::vector<MaglevNode>& nodes() const { return nodes_; }
+    std::span<const uint32_t> entries() const { return entries_; }
+    size_t size() const { return entries_.size(); }
+
+    static size_t next_prime(size_t n);
+
+private:
+    std::vector<MaglevNode> nodes_;
+    std::vector<uint32_t> entries_;
+};
+
+/**
+ * @brief Current MaglevTable for a changing node set
+ *
+ * update() hands the new membership to a builder thread and returns at
+ * once; table() keeps returning the previous table until the new one is
+ * swapped in. Updates queued during a build collapse into the latest.
+ */
+class AMPHISBAENA_API MaglevRing {
+public:
+    explicit MaglevRing(size_t table_size = MaglevTable::DEFAULT_SIZE);
+    ~MaglevRing();
+
+    MaglevRing(const MaglevRing&) = delete;
+    MaglevRing& operator=(const MaglevRing&) = delete;
+
+    // Queue a rebuild; returns the generation that will contain it
+    uint64_t update(std::vector<MaglevNode> nodes);
+    // Wait until the table for `generation` (or a later one) is current
+    bool wait_for(uint64_t generation, std::chrono::milliseconds timeout) const;
+
+    std::shared_ptr<const MaglevTable> table() const { return table_.load(std::memory_order_acquire); }
+    uint64_t generation() const;
+    uint64_t builds() const { return builds_.load(); }
+
+private:
+    void build_loop();
+
+    size_t table_size_;
+    std::atomic<std::shared_ptr<const MaglevTable>> table_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cv_;
+    std::optional<std::vector<MaglevNode>> pending_;
+    uint64_t requested_ = 0;
+    uint64_t built_ = 0;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    std::atomic<uint64_t> builds_{0};
+};
+
+/**
+ * @brief GalaxyCDN node reached through an AsyncConnectionManager connection
+ */
+struct AMPHISBAENA_API EdgeNode {
+    std::string node_id;
+    std::string connection_id;
+    uint32_t weight = 1;
+};
+
+/**
+ * @brief Routes object requests to the connection of the node owning their key
+ */
+class AMPHISBAENA_API EdgeRouter {
+public:
+    explicit EdgeRouter(AsyncConnectionManager& manager, size_t table_size = MaglevTable::DEFAULT_SIZE);
+
+    // Replace the node set; routing follows once the background rebuild lands
+    uint64_t set_nodes(std::vector<EdgeNode> nodes);
+    bool wait_for(uint64_t generation, std::chrono::milliseconds timeout) const {
+        return ring_.wait_for(generation, timeout);
+    }
+
+    // Owning node for host + key
+    std::optional<std::string> node_for(std::string_view host, std::string_view key) const;
+    // Connection to the owning node, if it is still open
+    std::optional<std::string> route(std::string_view host, std::string_view key) const;
+
+private:
+    AsyncConnectionManager& manager_;
+    MaglevRing ring_;
+    mutable std::shared_mutex connections_mutex_;
+    std::unordered_map<std::string, std::string> connections_;     // node_id -> connection_id
+};
+
+} // namespace GalaxyCDN
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,166 @@
+/**
+ * Amphisbaena 🐍 - GalaxyCDN Message Schemas
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Management-plane payloads carried in GalaxyCDN frames, declared as plain
+ * structs and read in place through reflect::MessageView.
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "async_connection_manager.h"
+#include "../reflect/message_view.h"
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace GalaxyCDN {
+
+// ProtocolHeader::flags for schema messages: FLAG_SCHEMA_MESSAGE plus the
+// schema's MessageType in the low byte
+constexpr uint16_t FLAG_SCHEMA_MESSAGE = 0x0400;
+constexpr uint16_t MESSAGE_TYPE_MASK = 0x00FF;
+
+enum class MessageType : uint8_t {
+    object_request = 1,
+    object_response = 2,
+    purge_request = 3,
+    edge_status = 4
+};
+
+// Inclusive byte range; last = UINT64_MAX means "to the end"
+struct ByteRange {
+    uint64_t first = 0;
+    uint64_t last = UINT64_MAX;
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(first);
+        DUALSTACK_REFLECT_MEMBER(last);
+    }
+};
+
+struct ObjectRequest {
+    static constexpr MessageType type = MessageType::object_request;
+
+    std::string host;
+    std::string key;
+    std::vector<ByteRange> ranges;      // Empty = whole object
+    std::string if_none_match;          // ETag the requester already holds
+    std::chrono::seconds max_stale{0};
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(host);
+        DUALSTACK_REFLECT_MEMBER(key);
+        DUALSTACK_REFLECT_MEMBER(ranges);
+        DUALSTACK_REFLECT_MEMBER(if_none_match);
+        DUALSTACK_REFLECT_MEMBER(max_stale);
+    }
+};
+
+struct ObjectResponse {
+    static constexpr MessageType type = MessageType::object_response;
+
+    uint16_t status = 0;
+    std::string etag;
+    std::string content_type;
+    uint64_t content_length = 0;        // Whole object, even for range responses
+    std::chrono::system_clock::time_point last_modified{};
+    std::vector<std::byte> body;
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(status);
+        DUALSTACK_REFLECT_MEMBER(etag);
+        DUALSTACK_REFLECT_MEMBER(content_type);
+        DUALSTACK_REFLECT_MEMBER(content_length);
+        DUALSTACK_REFLECT_MEMBER(last_modified);
+        DUALSTACK_REFLECT_MEMBER(body);
+    }
+};
+
+struct PurgeRequest {
+    static constexpr MessageType type = MessageType::purge_request;
+
+    std::vector<std::string> keys;
+    std::vector<std::string> tags;
+    bool soft = false;                  // Mark stale instead of evicting
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(keys);
+        DUALSTACK_REFLECT_MEMBER(tags);
+        DUALSTACK_REFLECT_MEMBER(soft);
+    }
+};
+
+struct EdgeStatus {
+    static constexpr MessageType type = MessageType::edge_status;
+
+    std::string node_id;
+    std::string region;
+    uint64_t objects = 0;
+    uint64_t bytes = 0;
+    double hit_ratio = 0.0;
+    std::vector<uint32_t> shard_load;   // Objects per cache shard
+    std::chrono::system_clock::time_point reported_at{};
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(node_id);
+        DUALSTACK_REFLECT_MEMBER(region);
+        DUALSTACK_REFLECT_MEMBER(objects);
+        DUALSTACK_REFLECT_MEMBER(bytes);
+        DUALSTACK_REFLECT_MEMBER(hit_ratio);
+        DUALSTACK_REFLECT_MEMBER(shard_load);
+        DUALSTACK_REFLECT_MEMBER(reported_at);
+    }
+};
+
+template<typename Message>
+constexpr auto message_flags() -> uint16_t {
+    return static_cast<uint16_t>(FLAG_SCHEMA_MESSAGE | static_cast<uint16_t>(Message::type));
+}
+
+inline auto message_type_of(const ProtocolHeader& header) -> std::optional<MessageType> {
+    if (!(header.flags & FLAG_SCHEMA_MESSAGE)) {
+        return std::nullopt;
+    }
+    return static_cast<MessageType>(header.flags & MESSAGE_TYPE_MASK);
+}
+
+// Validate a received payload as Message; the view borrows payload
+template<typename Message>
+auto view_message(const ProtocolHeader& header, std::span<const std::byte> payload)
+    -> std::expected<reflect::MessageView<Message>, reflect::SerialError> {
+    if (message_type_of(header) != Message::type) {
+        return std::unexpected(reflect::SerialError::invalid_value);
+    }
+    return reflect::MessageView<Message>::validate(payload);
+}
+
+// Encode and send one schema message on a managed connection
+template<typename Message>
+bool send_message(AsyncConnectionManager& manager, const std::string& connection_id,
+                  const Message& message, uint64_t request_id) {
+    std::vector<std::byte> payload;
+    if (!reflect::build_message(message, payload)) {
+        return false;
+    }
+    return manager.send_galaxycdn_frame(connection_id, message_flags<Message>(), request_id, payload);
+}
+
+} // namespace GalaxyCDN
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,546 @@
+/**
+ * Amphisbaena 🐍 - Hot Restart Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "hot_restart.h"
+#include "../reflect/serializer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace dualstack {
+namespace network {
+namespace hot_restart {
+
+const char* describe(HotRestartError error) {
+    switch (error) {
+        case HotRestartError::unsupported: return "descriptor passing not supported on this platform";
+        case HotRestartError::no_predecessor: return "no predecessor on the handoff socket";
+        case HotRestartError::protocol_error: return "malformed handoff message";
+        case HotRestartError::io_error: return "handoff socket I/O failed";
+    }
+    return "unknown hot restart error";
+}
+
+#ifndef _WIN32
+
+namespace {
+
+// Wire format on the handoff socket:
+//   successor   -> predecessor  Hello
+//   predecessor -> successor    OfferHeader + the descriptors (SCM_RIGHTS), then the
+//                               binary-serialized Manifest
+//   successor   -> predecessor  READY once it is accepting
+constexpr uint32_t HANDOFF_MAGIC = 0x48525354;     // "HRST"
+constexpr uint16_t HANDOFF_VERSION = 1;
+constexpr char READY = 'R';
+constexpr size_t MAX_DESCRIPTORS = 253;             // Linux SCM_MAX_FD: the listener plus 252 pooled
+constexpr size_t MAX_MANIFEST_BYTES = 64 * 1024 * 1024;
+
+struct Hello {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+};
+
+struct OfferHeader {
+    uint32_t magic;
+    uint32_t manifest_bytes;
+    uint32_t descriptors;       // Listener first
+};
+
+struct PooledDescriptor {
+    std::string connection_id;
+    IPAddress remote_address;
+    port_t remote_port = 0;
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(connection_id);
+        DUALSTACK_REFLECT_MEMBER(remote_address);
+        DUALSTACK_REFLECT_MEMBER(remote_port);
+    }
+};
+
+struct Manifest {
+    uint16_t version = HANDOFF_VERSION;
+    std::vector<PooledDescriptor> pooled;       // In descriptor order, after the listener
+    std::vector<std::byte> snapshot;
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(version);
+        DUALSTACK_REFLECT_MEMBER(pooled);
+        DUALSTACK_REFLECT_MEMBER(snapshot);
+    }
+};
+
+auto make_address(const std::string& path, sockaddr_un& address) -> bool {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, path.data(), path.size());
+    return true;
+}
+
+auto set_receive_timeout(int fd, std::chrono::milliseconds timeout) -> void {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+auto send_all(int fd, const void* data, size_t size) -> bool {
+    auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+auto receive_all(int fd, void* data, size_t size) -> bool {
+    auto* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = ::recv(fd, bytes, size, 0);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+auto close_all(const std::vector<int>& fds) -> void {
+    for (int fd : fds) {
+        ::close(fd);
+    }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Predecessor
+// ============================================================================
+
+Predecessor::Predecessor(AsyncDualStackServer& server, HotRestartConfig config)
+    : server_(server), config_(std::move(config)) {}
+
+Predecessor::~Predecessor() {
+    stop();
+}
+
+void Predecessor::set_snapshot(std::vector<std::byte> snapshot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_ = std::move(snapshot);
+}
+
+void Predecessor::share_pool(AsyncConnectionManager* pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pool_ = pool;
+}
+
+void Predecessor::set_drained_handler(std::function<void(bool drained)> handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    drained_handler_ = std::move(handler);
+}
+
+bool Predecessor::start() {
+    if (running_) {
+        return true;
+    }
+    sockaddr_un address;
+    if (!make_address(config_.socket_path, address)) {
+        std::cerr << "❌ Invalid hot restart socket path: " << config_.socket_path << std::endl;
+        return false;
+    }
+    listener_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener_ < 0) {
+        return false;
+    }
+    ::fcntl(listener_, F_SETFD, FD_CLOEXEC);
+    // A previous generation has already handed off and stopped listening
+    ::unlink(config_.socket_path.c_str());
+    if (::bind(listener_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener_, 4) != 0) {
+        std::cerr << "❌ Failed to listen on hot restart socket " << config_.socket_path << ": "
+                  << std::strerror(errno) << std::endl;
+        ::close(listener_);
+        listener_ = -1;
+        return false;
+    }
+    struct stat info{};
+    if (::stat(config_.socket_path.c_str(), &info) == 0) {
+        listener_device_ = static_cast<uint64_t>(info.st_dev);
+        listener_inode_ = static_cast<uint64_t>(info.st_ino);
+    }
+
+    running_ = true;
+    thread_ = std::thread(&Predecessor::serve_loop, this);
+    return true;
+}
+
+void Predecessor::stop() {
+    running_ = false;
+    // The drained handler may stop us from the handoff thread itself
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+        thread_.join();
+    }
+    close_listener();
+}
+
+void Predecessor::close_listener() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (listener_ < 0) {
+        return;
+    }
+    ::close(listener_);
+    listener_ = -1;
+    // The successor may already have bound its own socket at the same path
+    struct stat info{};
+    if (::stat(config_.socket_path.c_str(), &info) == 0 &&
+        static_cast<uint64_t>(info.st_dev) == listener_device_ && static_cast<uint64_t>(info.st_ino) == listener_inode_) {
+        ::unlink(config_.socket_path.c_str());
+    }
+}
+
+void Predecessor::serve_loop() {
+    while (running_) {
+        pollfd entry{};
+        entry.fd = listener_;
+        entry.events = POLLIN;
+        if (::poll(&entry, 1, 100) <= 0) {
+            continue;
+        }
+        int channel = ::accept(listener_, nullptr, nullptr);
+        if (channel < 0) {
+            continue;
+        }
+        ::fcntl(channel, F_SETFD, FD_CLOEXEC);
+        if (!authorized(channel)) {
+            ::close(channel);
+            continue;
+        }
+        set_receive_timeout(channel, config_.confirm_timeout);
+        std::vector<std::string> handed;
+        bool confirmed = hand_off(channel, handed);
+        ::close(channel);
+        AsyncConnectionManager* pool;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool = pool_;
+        }
+        if (!confirmed) {
+            for (const std::string& id : handed) {
+                pool->restore_connection(id);       // Non-empty only with a pool
+            }
+            continue;       // Keep serving; the next successor can try again
+        }
+
+        handed_off_ = true;
+        close_listener();
+        std::cout << "🐍 Listener handed to successor; draining" << std::endl;
+        auto deadline = std::chrono::steady_clock::now() + config_.drain_timeout;
+        bool drained = true;
+        if (pool) {
+            // The successor owns these now; closing our copies leaves its open
+            for (const std::string& id : handed) {
+                pool->close_connection(id);
+            }
+            drained = drain_pool(pool, deadline);
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        drained = server_.drain(std::max(remaining, std::chrono::milliseconds(0))) && drained;
+        std::function<void(bool)> handler;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            handler = drained_handler_;
+        }
+        running_ = false;
+        if (handler) {
+            handler(drained);
+        }
+        return;
+    }
+}
+
+bool Predecessor::authorized(int channel) const {
+    auto peer = Socket(static_cast<native_socket_handle>(channel), false).peer_credentials();
+    bool allowed = peer && (config_.successor_pid != 0 ? peer->pid == config_.successor_pid
+                                                       : peer->uid == static_cast<uint32_t>(::geteuid()));
+    if (!allowed) {
+        std::cerr << "⚠️  Ignoring hot restart request from an unexpected process" << std::endl;
+    }
+    return allowed;
+}
+
+bool Predecessor::drain_pool(AsyncConnectionManager* pool, std::chrono::steady_clock::time_point deadline) {
+    for (;;) {
+        std::vector<std::string> busy = pool->get_all_connection_ids();
+        std::erase_if(busy, [pool](const std::string& id) {
+            if (!pool->withdraw_connection(id, false)) {
+                return false;
+            }
+            pool->close_connection(id);
+            return true;
+        });
+        if (busy.empty()) {
+            return true;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;       // Still in use; closing them under their users is not safe
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+bool Predecessor::hand_off(int channel, std::vector<std::string>& handed) {
+    Hello hello{};
+    if (!receive_all(channel, &hello, sizeof(hello)) || hello.magic != HANDOFF_MAGIC ||
+        hello.version != HANDOFF_VERSION) {
+        std::cerr << "⚠️  Ignoring hot restart request with a bad hello" << std::endl;
+        return false;
+    }
+    auto listener = server_.listener_handle();
+    if (!listener) {
+        std::cerr << "⚠️  Hot restart requested but the server is not accepting" << std::endl;
+        return false;
+    }
+
+    std::vector<int> descriptors{static_cast<int>(*listener)};
+    Manifest manifest;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        manifest.snapshot = snapshot_;
+        if (pool_) {
+            // Only idle connections: one mid-exchange stays here and is drained
+            for (const std::string& id : pool_->get_all_connection_ids()) {
+                if (descriptors.size() == MAX_DESCRIPTORS) {
+                    break;
+                }
+                ConnectionState* state = pool_->withdraw_connection(id, true);
+                if (!state) {
+                    continue;
+                }
+                handed.push_back(id);
+                descriptors.push_back(static_cast<int>(state->socket->get_native_handle()));
+                manifest.pooled.push_back({id, state->remote_addr, state->remote_port});
+            }
+        }
+    }
+    std::vector<std::byte> encoded = reflect::to_binary(manifest);
+
+    OfferHeader header{HANDOFF_MAGIC, static_cast<uint32_t>(encoded.size()), static_cast<uint32_t>(descriptors.size())};
+    iovec vector{&header, sizeof(header)};
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * descriptors.size()), 0);
+    msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    cmsghdr* rights = CMSG_FIRSTHDR(&message);
+    rights->cmsg_level = SOL_SOCKET;
+    rights->cmsg_type = SCM_RIGHTS;
+    rights->cmsg_len = CMSG_LEN(sizeof(int) * descriptors.size());
+    std::memcpy(CMSG_DATA(rights), descriptors.data(), sizeof(int) * descriptors.size());
+
+    ssize_t sent;
+    do {
+        sent = ::sendmsg(channel, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    // The descriptors travel with the first byte; the rest of the header may follow separately
+    if (sent <= 0 ||
+        !send_all(channel, reinterpret_cast<const char*>(&header) + sent, sizeof(header) - static_cast<size_t>(sent)) ||
+        !send_all(channel, encoded.data(), encoded.size())) {
+        std::cerr << "⚠️  Hot restart handoff failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    char ready = 0;
+    if (!receive_all(channel, &ready, 1) || ready != READY) {
+        std::cerr << "⚠️  Successor did not confirm; still accepting here" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Successor
+// ============================================================================
+
+Successor::Successor(HotRestartConfig config) : config_(std::move(config)) {}
+
+Successor::~Successor() {
+    if (channel_ >= 0) {
+        ::close(channel_);
+    }
+}
+
+std::expected<Inheritance, HotRestartError> Successor::inherit(AsyncConnectionManager* pool) {
+    sockaddr_un address;
+    if (!make_address(config_.socket_path, address)) {
+        return std::unexpected(HotRestartError::no_predecessor);
+    }
+    if (channel_ >= 0) {
+        ::close(channel_);
+    }
+    channel_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (channel_ < 0) {
+        return std::unexpected(HotRestartError::io_error);
+    }
+    ::fcntl(channel_, F_SETFD, FD_CLOEXEC);
+    if (::connect(channel_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        bool absent = errno == ENOENT || errno == ECONNREFUSED;
+        ::close(channel_);
+        channel_ = -1;
+        return std::unexpected(absent ? HotRestartError::no_predecessor : HotRestartError::io_error);
+    }
+    set_receive_timeout(channel_, config_.confirm_timeout);
+
+    Hello hello{HANDOFF_MAGIC, HANDOFF_VERSION, 0};
+    if (!send_all(channel_, &hello, sizeof(hello))) {
+        return std::unexpected(HotRestartError::io_error);
+    }
+
+    OfferHeader header{};
+    iovec vector{&header, sizeof(header)};
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * MAX_DESCRIPTORS), 0);
+    msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    ssize_t got;
+    do {
+#if defined(__linux__)
+        got = ::recvmsg(channel_, &message, MSG_CMSG_CLOEXEC);
+#else
+        got = ::recvmsg(channel_, &message, 0);
+#endif
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        return std::unexpected(got == 0 ? HotRestartError::protocol_error : HotRestartError::io_error);
+    }
+
+    std::vector<int> descriptors;
+    for (cmsghdr* part = CMSG_FIRSTHDR(&message); part; part = CMSG_NXTHDR(&message, part)) {
+        if (part->cmsg_level == SOL_SOCKET && part->cmsg_type == SCM_RIGHTS) {
+            size_t count = (part->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            size_t first = descriptors.size();
+            descriptors.resize(first + count);
+            std::memcpy(descriptors.data() + first, CMSG_DATA(part), count * sizeof(int));
+        }
+    }
+    auto fail = [&](HotRestartError error) {
+        close_all(descriptors);
+        return std::unexpected(error);
+    };
+    if (!receive_all(channel_, reinterpret_cast<char*>(&header) + got, sizeof(header) - static_cast<size_t>(got))) {
+        return fail(HotRestartError::io_error);
+    }
+    if ((message.msg_flags & MSG_CTRUNC) || header.magic != HANDOFF_MAGIC || descriptors.empty() ||
+        header.descriptors != descriptors.size() || header.manifest_bytes > MAX_MANIFEST_BYTES) {
+        return fail(HotRestartError::protocol_error);
+    }
+
+    std::vector<std::byte> encoded(header.manifest_bytes);
+    if (!receive_all(channel_, encoded.data(), encoded.size())) {
+        return fail(HotRestartError::io_error);
+    }
+    Manifest manifest;
+    if (!reflect::from_binary(encoded, manifest) || manifest.version != HANDOFF_VERSION ||
+        manifest.pooled.size() + 1 != descriptors.size()) {
+        return fail(HotRestartError::protocol_error);
+    }
+
+    auto listener = Acceptor::adopt(static_cast<native_socket_handle>(descriptors[0]));
+    if (!listener) {
+        close_all({descriptors.begin() + 1, descriptors.end()});
+        return std::unexpected(HotRestartError::protocol_error);
+    }
+    Inheritance inheritance{std::move(*listener), {}, std::move(manifest.snapshot)};
+    for (size_t i = 0; i < manifest.pooled.size(); ++i) {
+        const PooledDescriptor& pooled = manifest.pooled[i];
+        Socket socket(static_cast<native_socket_handle>(descriptors[i + 1]), true);
+        if (pool) {
+            inheritance.pooled[pooled.connection_id] =
+                pool->adopt_connection(std::move(socket), pooled.remote_address, pooled.remote_port);
+        }
+    }
+    return inheritance;
+}
+
+bool Successor::confirm() {
+    if (channel_ < 0) {
+        return false;
+    }
+    bool sent = send_all(channel_, &READY, 1);
+    ::close(channel_);
+    channel_ = -1;
+    return sent;
+}
+
+#else // _WIN32
+
+Predecessor::Predecessor(AsyncDualStackServer& server, HotRestartConfig config)
+    : server_(server), config_(std::move(config)) {}
+Predecessor::~Predecessor() = default;
+void Predecessor::set_snapshot(std::vector<std::byte> snapshot) { snapshot_ = std::move(snapshot); }
+void Predecessor::share_pool(AsyncConnectionManager* pool) { pool_ = pool; }
+void Predecessor::set_drained_handler(std::function<void(bool)> handler) { drained_handler_ = std::move(handler); }
+bool Predecessor::start() {
+    std::cerr << "❌ Hot restart is not supported on Windows" << std::endl;
+    return false;
+}
+void Predecessor::stop() {}
+void Predecessor::serve_loop() {}
+bool Predecessor::authorized(int) const { return false; }
+bool Predecessor::hand_off(int, std::vector<std::string>&) { return false; }
+bool Predecessor::drain_pool(AsyncConnectionManager*, std::chrono::steady_clock::time_point) { return true; }
+void Predecessor::close_listener() {}
+
+Successor::Successor(HotRestartConfig config) : config_(std::move(config)) {}
+Successor::~Successor() = default;
+std::expected<Inheritance, HotRestartError> Successor::inherit(AsyncConnectionManager*) {
+    return std::unexpected(HotRestartError::unsupported);
+}
+bool Successor::confirm() { return false; }
+
+#endif
+
+} // namespace hot_restart
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,145 @@
+/**
+ * Amphisbaena 🐍 - Hot Restart
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Listening-socket handoff between an old and a new server process:
+ *   - the running process (Predecessor) waits on a Unix domain socket,
+ *     answering only a successor running as the same user (or the one
+ *     expected process)
+ *   - the new process (Successor) connects and receives the listening
+ *     socket, plus any idle pooled connections, over SCM_RIGHTS, together
+ *     with a pre-warmed configuration snapshot
+ *   - once the successor is accepting it confirms, and the predecessor
+ *     stops accepting (without shutdown, so no queued client sees a reset)
+ *     and drains its open connections, including pooled ones that were busy
+ *
+ * POSIX only; on Windows every call reports HotRestartError::unsupported.
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "async_connection_manager.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace hot_restart {
+
+enum class HotRestartError : uint8_t {
+    unsupported,            // No descriptor passing on this platform
+    no_predecessor,         // Nothing waiting on the handoff socket; start normally
+    protocol_error,         // Malformed or unexpected handoff message
+    io_error
+};
+
+AMPHISBAENA_API const char* describe(HotRestartError error);
+
+/**
+ * @brief Hot Restart Configuration, shared by both processes
+ */
+struct AMPHISBAENA_API HotRestartConfig {
+    std::string socket_path;                                // Unix domain socket both processes agree on
+    std::chrono::milliseconds confirm_timeout{10000};       // Successor must be accepting within this
+    std::chrono::milliseconds drain_timeout{30000};         // Predecessor's wait for open connections
+    int32_t successor_pid = 0;                              // Nonzero: only this process may take over,
+                                                            // otherwise any process of the same user
+};
+
+/**
+ * @brief What a successor takes over from its predecessor
+ */
+struct AMPHISBAENA_API Inheritance {
+    Acceptor listener;                                      // Pass to AsyncDualStackServer::start
+    std::unordered_map<std::string, std::string> pooled;    // Predecessor's connection id -> id in our pool
+    std::vector<std::byte> snapshot;
+};
+
+/**
+ * @brief Running process: hands its listener to the next one, then drains
+ */
+class AMPHISBAENA_API Predecessor {
+public:
+    Predecessor(AsyncDualStackServer& server, HotRestartConfig config);
+    ~Predecessor();
+
+    Predecessor(const Predecessor&) = delete;
+    Predecessor& operator=(const Predecessor&) = delete;
+
+    // Pre-warmed configuration sent with the sockets
+    void set_snapshot(std::vector<std::byte> snapshot);
+    // Idle connections in `pool` are handed over too, and closed here once the successor
+    // confirms; busy ones stay here and are closed as their operations finish
+    void share_pool(AsyncConnectionManager* pool);
+    // Runs on the handoff thread after draining, e.g. to exit the process
+    void set_drained_handler(std::function<void(bool drained)> handler);
+
+    // Listen on the handoff socket, replacing a stale one left at the path
+    bool start();
+    void stop();
+    bool handed_off() const { return handed_off_; }
+
+private:
+    void serve_loop();
+    bool authorized(int channel) const;
+    // True once the successor has confirmed; `handed` lists the pooled connections sent
+    bool hand_off(int channel, std::vector<std::string>& handed);
+    // Close the pool's remaining connections as they go idle; false if any outlive the deadline
+    bool drain_pool(AsyncConnectionManager* pool, std::chrono::steady_clock::time_point deadline);
+    void close_listener();
+
+    AsyncDualStackServer& server_;
+    HotRestartConfig config_;
+    std::mutex mutex_;                      // Guards snapshot_, pool_ and handler_
+    std::vector<std::byte> snapshot_;
+    AsyncConnectionManager* pool_ = nullptr;
+    std::function<void(bool)> drained_handler_;
+
+    int listener_ = -1;
+    uint64_t listener_device_ = 0;          // Identity of our socket file, so a successor's is never unlinked
+    uint64_t listener_inode_ = 0;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> handed_off_{false};
+};
+
+/**
+ * @brief New process: takes over a predecessor's sockets
+ *
+ * Call inherit(), apply the snapshot, start the server on the inherited
+ * listener, then confirm(). Without a predecessor, inherit() fails with
+ * no_predecessor and the server starts normally.
+ */
+class AMPHISBAENA_API Successor {
+public:
+    explicit Successor(HotRestartConfig config);
+    ~Successor();
+
+    Successor(const Successor&) = delete;
+    Successor& operator=(const Successor&) = delete;
+
+    // Receive the listener and snapshot; pooled connections join `pool`, or are closed without one
+    std::expected<Inheritance, HotRestartError> inherit(AsyncConnectionManager* pool = nullptr);
+    // Tell the predecessor this process is accepting, so it starts draining
+    bool confirm();
+
+private:
+    HotRestartConfig config_;
+    int channel_ = -1;
+};
+
+} // namespace hot_restart
+} // namespace network
+} // namespace dualstack
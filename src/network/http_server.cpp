@@ -0,0 +1,1055 @@
+/**
+ * Amphisbaena 🐍 - HTTP/1.1 Server Layer Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "http_server.h"
+#include "event_poller.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DUALSTACK_HTTP_SSE2 1
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define DUALSTACK_HTTP_NEON 1
+    #include <arm_neon.h>
+#endif
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0      // I/O threads block SIGPIPE instead
+#endif
+
+namespace dualstack {
+namespace network {
+namespace http {
+
+// ============================================================================
+// Request Parser
+// ============================================================================
+
+namespace {
+
+constexpr auto make_token_table() {
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) table[c] = true;
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+    for (char c : std::string_view("!#$%&'*+-.^_`|~")) table[static_cast<unsigned char>(c)] = true;
+    return table;
+}
+
+constexpr auto TOKEN_CHARS = make_token_table();
+
+auto is_token(std::string_view text) -> bool {
+    if (text.empty()) {
+        return false;
+    }
+    for (char c : text) {
+        if (!TOKEN_CHARS[static_cast<unsigned char>(c)]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto lower(char c) -> char {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+auto iequals(std::string_view a, std::string_view b) -> bool {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (lower(a[i]) != lower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto trim(std::string_view text) -> std::string_view {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+// First control character (< 0x20 other than tab, or DEL) in [p, end). In a
+// well-formed head that is the CR ending the line, so one pass both finds
+// line ends and rejects bytes that may not appear in a request line or field.
+auto find_control(const char* p, const char* end) -> const char* {
+#if defined(DUALSTACK_HTTP_SSE2)
+    const __m128i below_space = _mm_set1_epi8(0x1F);
+    const __m128i del = _mm_set1_epi8(0x7F);
+    const __m128i tab = _mm_set1_epi8('\t');
+    while (end - p >= 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(bytes, below_space), bytes);
+        control = _mm_or_si128(control, _mm_cmpeq_epi8(bytes, del));
+        control = _mm_andnot_si128(_mm_cmpeq_epi8(bytes, tab), control);
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(control));
+        if (mask != 0) {
+            return p + std::countr_zero(mask);
+        }
+        p += 16;
+    }
+#elif defined(DUALSTACK_HTTP_NEON)
+    while (end - p >= 16) {
+        uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        uint8x16_t control = vorrq_u8(vcltq_u8(bytes, vdupq_n_u8(0x20)), vceqq_u8(bytes, vdupq_n_u8(0x7F)));
+        control = vbicq_u8(control, vceqq_u8(bytes, vdupq_n_u8('\t')));
+        // Narrow to one nibble per byte to get a scalar mask
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(control), 4)), 0);
+        if (mask != 0) {
+            return p + (std::countr_zero(mask) >> 2);
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        auto c = static_cast<unsigned char>(*p);
+        if ((c < 0x20 && c != '\t') || c == 0x7F) {
+            return p;
+        }
+    }
+    return end;
+}
+
+auto parse_content_length(std::string_view text, uint64_t& value) -> bool {
+    if (text.empty()) {
+        return false;
+    }
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc{} && result.ptr == text.data() + text.size() && text.front() != '-' &&
+           text.front() != '+';
+}
+
+} // anonymous namespace
+
+const char* describe(HttpError error) {
+    switch (error) {
+        case HttpError::incomplete: return "incomplete request";
+        case HttpError::bad_request: return "malformed request";
+        case HttpError::body_too_large: return "request body too large";
+        case HttpError::header_too_large: return "request header too large";
+        case HttpError::not_implemented: return "request transfer coding not implemented";
+        case HttpError::version_not_supported: return "HTTP version not supported";
+    }
+    return "unknown HTTP error";
+}
+
+uint16_t status_for(HttpError error) {
+    switch (error) {
+        case HttpError::incomplete: return 0;
+        case HttpError::bad_request: return 400;
+        case HttpError::body_too_large: return 413;
+        case HttpError::header_too_large: return 431;
+        case HttpError::not_implemented: return 501;
+        case HttpError::version_not_supported: return 505;
+    }
+    return 400;
+}
+
+std::string_view HttpRequest::header(std::string_view name) const {
+    for (const HttpHeader& field : all_headers()) {
+        if (iequals(field.name, name)) {
+            return field.value;
+        }
+    }
+    return {};
+}
+
+std::expected<size_t, HttpError> parse_request(std::string_view buffer, HttpRequest& request,
+                                               const HttpLimits& limits) {
+    request.header_count = 0;
+    request.content_length = 0;
+    request.body = {};
+    request.expect_continue = false;
+    request.head_size = 0;
+
+    const char* begin = buffer.data();
+    const char* end = begin + buffer.size();
+    const char* head_end = begin + std::min(buffer.size(), limits.max_header_bytes);
+    const HttpError overrun = head_end == end ? HttpError::incomplete : HttpError::header_too_large;
+
+    auto next_line = [&](const char*& p, std::string_view& line) -> std::optional<HttpError> {
+        const char* stop = find_control(p, head_end);
+        if (stop == head_end || stop + 1 == head_end) {
+            return overrun;
+        }
+        if (stop[0] != '\r' || stop[1] != '\n') {
+            return HttpError::bad_request;
+        }
+        line = std::string_view(p, static_cast<size_t>(stop - p));
+        p = stop + 2;
+        return std::nullopt;
+    };
+
+    // Request line (ignoring blank lines a client may leave between requests)
+    const char* p = begin;
+    std::string_view line;
+    do {
+        if (auto error = next_line(p, line)) {
+            return std::unexpected(*error);
+        }
+    } while (line.empty());
+
+    size_t method_end = line.find(' ');
+    size_t target_end = method_end == std::string_view::npos ? method_end : line.find(' ', method_end + 1);
+    if (target_end == std::string_view::npos) {
+        return std::unexpected(HttpError::bad_request);
+    }
+    request.method = line.substr(0, method_end);
+    request.target = line.substr(method_end + 1, target_end - method_end - 1);
+    std::string_view version = line.substr(target_end + 1);
+    if (!is_token(request.method) || request.target.empty()) {
+        return std::unexpected(HttpError::bad_request);
+    }
+    if (version.size() != 8 || !version.starts_with("HTTP/") || version[6] != '.' ||
+        version[5] < '0' || version[5] > '9' || version[7] < '0' || version[7] > '9') {
+        return std::unexpected(HttpError::bad_request);
+    }
+    if (version[5] != '1') {
+        return std::unexpected(HttpError::version_not_supported);
+    }
+    request.version_minor = static_cast<uint8_t>(version[7] - '0');
+
+    size_t query_start = request.target.find('?');
+    request.path = request.target.substr(0, query_start);
+    request.query = query_start == std::string_view::npos ? std::string_view{} : request.target.substr(query_start + 1);
+
+    // Header fields
+    bool has_length = false;
+    bool has_host = false;
+    bool connection_close = false;
+    bool connection_keep_alive = false;
+    for (;;) {
+        if (auto error = next_line(p, line)) {
+            return std::unexpected(*error);
+        }
+        if (line.empty()) {
+            break;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos || !is_token(line.substr(0, colon))) {
+            return std::unexpected(HttpError::bad_request);     // Includes obsolete line folding
+        }
+        if (request.header_count == MAX_HTTP_HEADERS) {
+            return std::unexpected(HttpError::header_too_large);
+        }
+        HttpHeader& field = request.headers[request.header_count++];
+        field.name = line.substr(0, colon);
+        field.value = trim(line.substr(colon + 1));
+
+        if (iequals(field.name, "content-length")) {
+            uint64_t length = 0;
+            if (!parse_content_length(field.value, length) || (has_length && length != request.content_length)) {
+                return std::unexpected(HttpError::bad_request);
+            }
+            request.content_length = length;
+            has_length = true;
+        } else if (iequals(field.name, "transfer-encoding")) {
+            return std::unexpected(HttpError::not_implemented);
+        } else if (iequals(field.name, "host")) {
+            if (has_host) {
+                return std::unexpected(HttpError::bad_request);     // RFC 9112 section 3.2
+            }
+            has_host = true;
+        } else if (iequals(field.name, "connection")) {
+            std::string_view options = field.value;
+            while (!options.empty()) {
+                size_t comma = options.find(',');
+                std::string_view option = trim(options.substr(0, comma));
+                connection_close |= iequals(option, "close");
+                connection_keep_alive |= iequals(option, "keep-alive");
+                options = comma == std::string_view::npos ? std::string_view{} : options.substr(comma + 1);
+            }
+        } else if (iequals(field.name, "expect")) {
+            request.expect_continue = iequals(field.value, "100-continue");
+        }
+    }
+    if (request.version_minor >= 1 && !has_host) {
+        return std::unexpected(HttpError::bad_request);
+    }
+    request.keep_alive = request.version_minor >= 1 ? !connection_close : connection_keep_alive && !connection_close;
+    request.head_size = static_cast<size_t>(p - begin);
+
+    // Body
+    if (request.content_length > limits.max_body_bytes) {
+        return std::unexpected(HttpError::body_too_large);
+    }
+    if (static_cast<uint64_t>(end - p) < request.content_length) {
+        return std::unexpected(HttpError::incomplete);
+    }
+    request.body = std::string_view(p, static_cast<size_t>(request.content_length));
+    return request.head_size + static_cast<size_t>(request.content_length);
+}
+
+// ============================================================================
+// HttpResponse
+// ============================================================================
+
+void HttpResponse::add_header(std::string_view name, std::string_view value) {
+    // Refuse anything that could split the header block
+    if (!is_token(name) || value.find_first_of("\r\n") != std::string_view::npos) {
+        return;
+    }
+    headers_.append(name);
+    headers_.append(": ");
+    headers_.append(value);
+    headers_.append("\r\n");
+}
+
+void HttpResponse::set_body(std::string_view body) {
+    release_file();
+    body_.assign(body);
+}
+
+void HttpResponse::set_body(std::span<const std::byte> body) {
+    set_body(std::string_view(reinterpret_cast<const char*>(body.data()), body.size()));
+}
+
+bool HttpResponse::send_file(const std::filesystem::path& path, uint64_t offset, uint64_t length) {
+    release_file();
+    body_.clear();
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    if (ec || offset > size) {
+        return false;
+    }
+    length = std::min(length, size - offset);
+#ifdef _WIN32
+    // No sendfile: read the range into the body
+    std::ifstream file(path, std::ios::binary);
+    body_.resize(static_cast<size_t>(length));
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(body_.data(), static_cast<std::streamsize>(length))) {
+        body_.clear();
+        return false;
+    }
+#else
+    file_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_ < 0) {
+        return false;
+    }
+    file_offset_ = offset;
+    file_length_ = length;
+#endif
+    return true;
+}
+
+void HttpResponse::reset() {
+    status_ = 200;
+    headers_.clear();
+    body_.clear();
+    release_file();
+    close_ = false;
+}
+
+void HttpResponse::release_file() {
+#ifndef _WIN32
+    if (file_ >= 0) {
+        ::close(file_);
+    }
+#endif
+    file_ = -1;
+    file_offset_ = 0;
+    file_length_ = 0;
+}
+
+// ============================================================================
+// Response Fragments
+// ============================================================================
+
+namespace {
+
+struct StatusLine {
+    uint16_t status;
+    std::string_view line;
+};
+
+constexpr StatusLine STATUS_LINES[] = {
+    {200, "HTTP/1.1 200 OK\r\n"},
+    {201, "HTTP/1.1 201 Created\r\n"},
+    {202, "HTTP/1.1 202 Accepted\r\n"},
+    {204, "HTTP/1.1 204 No Content\r\n"},
+    {206, "HTTP/1.1 206 Partial Content\r\n"},
+    {301, "HTTP/1.1 301 Moved Permanently\r\n"},
+    {302, "HTTP/1.1 302 Found\r\n"},
+    {303, "HTTP/1.1 303 See Other\r\n"},
+    {304, "HTTP/1.1 304 Not Modified\r\n"},
+    {307, "HTTP/1.1 307 Temporary Redirect\r\n"},
+    {308, "HTTP/1.1 308 Permanent Redirect\r\n"},
+    {400, "HTTP/1.1 400 Bad Request\r\n"},
+    {401, "HTTP/1.1 401 Unauthorized\r\n"},
+    {403, "HTTP/1.1 403 Forbidden\r\n"},
+    {404, "HTTP/1.1 404 Not Found\r\n"},
+    {405, "HTTP/1.1 405 Method Not Allowed\r\n"},
+    {408, "HTTP/1.1 408 Request Timeout\r\n"},
+    {409, "HTTP/1.1 409 Conflict\r\n"},
+    {411, "HTTP/1.1 411 Length Required\r\n"},
+    {412, "HTTP/1.1 412 Precondition Failed\r\n"},
+    {413, "HTTP/1.1 413 Content Too Large\r\n"},
+    {414, "HTTP/1.1 414 URI Too Long\r\n"},
+    {416, "HTTP/1.1 416 Range Not Satisfiable\r\n"},
+    {429, "HTTP/1.1 429 Too Many Requests\r\n"},
+    {431, "HTTP/1.1 431 Request Header Fields Too Large\r\n"},
+    {500, "HTTP/1.1 500 Internal Server Error\r\n"},
+    {501, "HTTP/1.1 501 Not Implemented\r\n"},
+    {502, "HTTP/1.1 502 Bad Gateway\r\n"},
+    {503, "HTTP/1.1 503 Service Unavailable\r\n"},
+    {504, "HTTP/1.1 504 Gateway Timeout\r\n"},
+    {505, "HTTP/1.1 505 HTTP Version Not Supported\r\n"},
+};
+
+constexpr std::string_view CONTINUE = "HTTP/1.1 100 Continue\r\n\r\n";
+constexpr std::string_view KEEP_ALIVE_END = "Connection: keep-alive\r\n\r\n";
+constexpr std::string_view CLOSE_END = "Connection: close\r\n\r\n";
+constexpr std::string_view CONTENT_LENGTH = "Content-Length: ";
+
+auto static_status_line(uint16_t status) -> std::string_view {
+    for (const StatusLine& entry : STATUS_LINES) {
+        if (entry.status == status) {
+            return entry.line;
+        }
+    }
+    return {};
+}
+
+// "Date: ..." line, reformatted at most once a second per thread
+auto date_line() -> std::string_view {
+    static constexpr const char* days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    static constexpr const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                             "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    thread_local std::time_t cached_second = -1;
+    thread_local char line[64];
+    thread_local size_t length = 0;
+
+    std::time_t now = std::time(nullptr);
+    if (now != cached_second) {
+        std::tm utc{};
+#ifdef _WIN32
+        gmtime_s(&utc, &now);
+#else
+        gmtime_r(&now, &utc);
+#endif
+        int written = std::snprintf(line, sizeof(line), "Date: %s, %02d %s %04d %02d:%02d:%02d GMT\r\n",
+                                    days[utc.tm_wday], utc.tm_mday, months[utc.tm_mon], utc.tm_year + 1900,
+                                    utc.tm_hour, utc.tm_min, utc.tm_sec);
+        length = written > 0 ? static_cast<size_t>(written) : 0;
+        cached_second = now;
+    }
+    return std::string_view(line, length);
+}
+
+// Part of a queued response: a static fragment, a range of the connection's
+// output buffer, or a file range
+struct OutputSegment {
+    const char* data = nullptr;     // Static fragment; nullptr = output buffer range
+    size_t offset = 0;
+    size_t length = 0;
+    int file = -1;
+    uint64_t file_offset = 0;
+};
+
+constexpr size_t MAX_GATHER = 64;
+constexpr size_t INITIAL_INPUT_BYTES = 4096;
+
+} // anonymous namespace
+
+// ============================================================================
+// Connections and I/O Threads
+// ============================================================================
+
+struct HttpServer::Connection {
+    std::string id;
+    native_socket_handle fd = 0;
+    std::vector<char> input;
+    size_t input_used = 0;
+    std::string output;                     // Generated response bytes
+    std::vector<OutputSegment> segments;    // Queued responses, in order
+    size_t segment_index = 0;
+    size_t segment_progress = 0;
+    HttpRequest request;
+    HttpResponse response;
+    bool continue_sent = false;
+    bool closing = false;                   // Close once the output drains
+    bool want_write = false;
+    std::chrono::steady_clock::time_point last_active;
+    std::chrono::steady_clock::time_point last_write;   // Last progress on output waiting for the socket
+
+    ~Connection() {
+        for (OutputSegment& segment : segments) {
+            if (segment.file >= 0) {
+#ifndef _WIN32
+                ::close(segment.file);
+#endif
+            }
+        }
+    }
+};
+
+class HttpServer::IoThread {
+public:
+    explicit IoThread(HttpServer& owner) : owner_(owner) {}
+
+    ~IoThread() { stop(); }
+
+    bool start() {
+        if (!poller_.open()) {
+            return false;
+        }
+        running_ = true;
+        thread_ = std::thread(&IoThread::run, this);
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        poller_.wake();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void adopt(std::unique_ptr<Connection> connection) {
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            pending_.push_back(std::move(connection));
+        }
+        poller_.wake();
+    }
+
+private:
+    void run() {
+#ifndef _WIN32
+        // sendfile has no MSG_NOSIGNAL; a reset peer must surface as EPIPE
+        sigset_t pipe_set;
+        sigemptyset(&pipe_set);
+        sigaddset(&pipe_set, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipe_set, nullptr);
+#endif
+        std::vector<PollEvent> events;
+        auto next_sweep = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+        while (running_) {
+            poller_.wait(events, Poller::MAX_WAIT_MS);
+            for (const PollEvent& event : events) {
+                auto it = connections_.find(event.fd);
+                if (it == connections_.end()) {
+                    continue;
+                }
+                Connection& connection = *it->second;
+                if (event.writable && !flush(connection)) {
+                    continue;
+                }
+                if (event.readable && !connection.want_write) {
+                    on_readable(connection);
+                } else if (event.failed && !event.readable && !event.writable) {
+                    close(connection);
+                }
+            }
+            adopt_pending();
+
+            auto now = std::chrono::steady_clock::now();
+            if (now >= next_sweep) {
+                close_idle(now);
+                next_sweep = now + std::chrono::seconds(1);
+            }
+        }
+
+        adopt_pending();
+        while (!connections_.empty()) {
+            close(*connections_.begin()->second);
+        }
+    }
+
+    void adopt_pending() {
+        std::vector<std::unique_ptr<Connection>> adopted;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            adopted.swap(pending_);
+        }
+        for (auto& connection : adopted) {
+            connection->last_active = std::chrono::steady_clock::now();
+            native_socket_handle fd = connection->fd;
+            if (!poller_.add(fd)) {
+                owner_.close(*connection);
+                continue;
+            }
+            connections_.emplace(fd, std::move(connection));
+        }
+    }
+
+    void close_idle(std::chrono::steady_clock::time_point now) {
+        std::vector<Connection*> idle;
+        for (auto& [fd, connection] : connections_) {
+            bool idle_expired = connection->segments.empty() &&
+                                now - connection->last_active > owner_.config_.keep_alive_timeout;
+            // A peer that stops reading would otherwise hold its output queue forever
+            bool write_stalled = connection->want_write &&
+                                 now - connection->last_write > owner_.config_.write_timeout;
+            if (idle_expired || write_stalled) {
+                idle.push_back(connection.get());
+            }
+        }
+        for (Connection* connection : idle) {
+            close(*connection);
+        }
+    }
+
+    void close(Connection& connection) {
+        native_socket_handle fd = connection.fd;
+        poller_.remove(fd);
+        owner_.close(connection);
+        connections_.erase(fd);
+    }
+
+    void on_readable(Connection& connection) {
+        const HttpLimits& limits = owner_.config_.limits;
+        if (connection.input_used == connection.input.size()) {
+            size_t cap = limits.max_header_bytes + limits.max_body_bytes;
+            if (connection.input.size() >= cap) {
+                close(connection);      // Unreachable unless the parser failed to report an oversize request
+                return;
+            }
+            connection.input.resize(std::min(cap, std::max(connection.input.size() * 2, INITIAL_INPUT_BYTES)));
+        }
+
+        auto received = ::recv(connection.fd, connection.input.data() + connection.input_used,
+                               static_cast<int>(connection.input.size() - connection.input_used), 0);
+        if (received < 0 && (last_error_would_block() || last_error_interrupted())) {
+            return;
+        }
+        if (received <= 0) {
+            close(connection);
+            return;
+        }
+        connection.input_used += static_cast<size_t>(received);
+        connection.last_active = std::chrono::steady_clock::now();
+        process(connection);
+    }
+
+    void process(Connection& connection) {
+        size_t consumed = 0;
+        size_t answered = 0;
+        while (!connection.closing && consumed < connection.input_used) {
+            std::string_view pending(connection.input.data() + consumed, connection.input_used - consumed);
+            auto parsed = parse_request(pending, connection.request, owner_.config_.limits);
+            if (!parsed) {
+                if (parsed.error() == HttpError::incomplete) {
+                    if (connection.request.head_size != 0 && connection.request.expect_continue &&
+                        !connection.continue_sent) {
+                        push_static(connection, CONTINUE);
+                        connection.continue_sent = true;
+                    }
+                    break;
+                }
+                ++owner_.parse_errors_;
+                connection.response.reset();
+                connection.response.set_status(status_for(parsed.error()));
+                connection.closing = true;
+                queue_response(connection, false);
+                break;
+            }
+
+            ++owner_.requests_;
+            if (answered > 0) {
+                ++owner_.pipelined_;
+            }
+            connection.continue_sent = false;
+            connection.response.reset();
+            if (!owner_.handler_) {
+                connection.response.set_status(404);
+            } else {
+                try {
+                    owner_.handler_(connection.request, connection.response);
+                } catch (const std::exception& e) {
+                    std::cerr << "❌ HTTP handler error: " << e.what() << std::endl;
+                    connection.response.reset();
+                    connection.response.set_status(500);
+                }
+            }
+            connection.closing = !connection.request.keep_alive || connection.response.close_;
+            queue_response(connection, connection.request.method == "HEAD");
+            consumed += *parsed;
+            ++answered;
+        }
+
+        // Keep any partial request at the front of the buffer
+        if (consumed > 0) {
+            std::memmove(connection.input.data(), connection.input.data() + consumed,
+                         connection.input_used - consumed);
+            connection.input_used -= consumed;
+        }
+        if (!connection.segments.empty()) {
+            flush(connection);
+        } else if (connection.closing) {
+            close(connection);
+        }
+    }
+
+    void push_static(Connection& connection, std::string_view fragment) {
+        OutputSegment segment;
+        segment.data = fragment.data();
+        segment.length = fragment.size();
+        connection.segments.push_back(segment);
+    }
+
+    // Queue output_[start, end), merging with a directly preceding buffer range
+    void push_output(Connection& connection, size_t start) {
+        size_t length = connection.output.size() - start;
+        if (length == 0) {
+            return;
+        }
+        if (!connection.segments.empty()) {
+            OutputSegment& last = connection.segments.back();
+            if (!last.data && last.file < 0 && last.offset + last.length == start) {
+                last.length += length;
+                return;
+            }
+        }
+        OutputSegment segment;
+        segment.offset = start;
+        segment.length = length;
+        connection.segments.push_back(segment);
+    }
+
+    void queue_response(Connection& connection, bool head_request) {
+        HttpResponse& response = connection.response;
+        uint16_t status = response.status_;
+        bool bodyless = status == 204 || status == 304 || (status >= 100 && status < 200);
+
+        std::string& output = connection.output;
+        std::string_view line = static_status_line(status);
+        if (!line.empty()) {
+            push_static(connection, line);
+        }
+        size_t start = output.size();
+        if (line.empty()) {
+            char digits[8];
+            auto result = std::to_chars(digits, digits + sizeof(digits), status);
+            output.append("HTTP/1.1 ");
+            output.append(digits, result.ptr);
+            output.append(" \r\n");
+        }
+        output.append(date_line());
+        output.append(response.headers_);
+        uint64_t length = response.file_ >= 0 ? response.file_length_ : response.body_.size();
+        if (!bodyless) {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), length);
+            output.append(CONTENT_LENGTH);
+            output.append(digits, result.ptr);
+            output.append("\r\n");
+        }
+        push_output(connection, start);
+        push_static(connection, connection.closing ? CLOSE_END : KEEP_ALIVE_END);
+
+        if (bodyless || head_request || length == 0) {
+            return;
+        }
+        if (response.file_ >= 0) {
+            OutputSegment segment;
+            segment.file = response.file_;
+            segment.file_offset = response.file_offset_;
+            segment.length = static_cast<size_t>(response.file_length_);
+            connection.segments.push_back(segment);
+            response.file_ = -1;        // Now owned by the output queue
+        } else {
+            start = output.size();
+            output.append(response.body_);
+            push_output(connection, start);
+        }
+    }
+
+    // Advance past `sent` bytes of queued output
+    void advance(Connection& connection, size_t sent) {
+        while (sent > 0) {
+            OutputSegment& segment = connection.segments[connection.segment_index];
+            size_t remaining = segment.length - connection.segment_progress;
+            if (sent < remaining) {
+                connection.segment_progress += sent;
+                return;
+            }
+            sent -= remaining;
+            ++connection.segment_index;
+            connection.segment_progress = 0;
+        }
+    }
+
+    // Returns false if the connection was closed
+    bool flush(Connection& connection) {
+        while (connection.segment_index < connection.segments.size()) {
+            OutputSegment& segment = connection.segments[connection.segment_index];
+            if (segment.file >= 0) {
+                auto sent = send_file_segment(connection, segment);
+                if (sent < 0) {
+                    if (last_error_interrupted()) {
+                        continue;
+                    }
+                    if (last_error_would_block()) {
+                        return wait_writable(connection);
+                    }
+                    close(connection);
+                    return false;
+                }
+                connection.segment_progress += static_cast<size_t>(sent);
+                if (sent > 0) {
+                    connection.last_write = std::chrono::steady_clock::now();
+                }
+                owner_.bytes_sendfile_ += static_cast<uint64_t>(sent);
+                owner_.bytes_sent_ += static_cast<uint64_t>(sent);
+                if (connection.segment_progress == segment.length || sent == 0) {
+#ifndef _WIN32
+                    ::close(segment.file);
+#endif
+                    segment.file = -1;
+                    if (connection.segment_progress != segment.length) {
+                        close(connection);      // File shrank under us; the Content-Length cannot be met
+                        return false;
+                    }
+                    ++connection.segment_index;
+                    connection.segment_progress = 0;
+                }
+                continue;
+            }
+
+            auto sent = send_gathered(connection);
+            if (sent < 0) {
+                if (last_error_interrupted()) {
+                    continue;
+                }
+                if (last_error_would_block()) {
+                    return wait_writable(connection);
+                }
+                close(connection);
+                return false;
+            }
+            owner_.bytes_sent_ += static_cast<uint64_t>(sent);
+            if (sent > 0) {
+                connection.last_write = std::chrono::steady_clock::now();
+            }
+            advance(connection, static_cast<size_t>(sent));
+        }
+
+        connection.output.clear();
+        connection.segments.clear();
+        connection.segment_index = 0;
+        connection.segment_progress = 0;
+        connection.last_active = std::chrono::steady_clock::now();
+        if (connection.want_write) {
+            poller_.watch(connection.fd, false);
+            connection.want_write = false;
+        }
+        if (connection.closing) {
+            close(connection);
+            return false;
+        }
+        return true;
+    }
+
+    bool wait_writable(Connection& connection) {
+        if (!connection.want_write) {
+            poller_.watch(connection.fd, true);
+            connection.want_write = true;
+            connection.last_write = std::chrono::steady_clock::now();     // The write deadline starts here
+        }
+        return true;
+    }
+
+    // One gathered write of the consecutive in-memory segments at the head of the queue
+    auto send_gathered(Connection& connection) -> long long {
+        size_t count = 0;
+#ifdef _WIN32
+        WSABUF buffers[MAX_GATHER];
+#else
+        iovec buffers[MAX_GATHER];
+#endif
+        for (size_t i = connection.segment_index;
+             i < connection.segments.size() && count < MAX_GATHER && connection.segments[i].file < 0; ++i) {
+            const OutputSegment& segment = connection.segments[i];
+            const char* data = segment.data ? segment.data : connection.output.data() + segment.offset;
+            size_t length = segment.length;
+            if (i == connection.segment_index) {
+                data += connection.segment_progress;
+                length -= connection.segment_progress;
+            }
+#ifdef _WIN32
+            buffers[count].buf = const_cast<char*>(data);
+            buffers[count].len = static_cast<ULONG>(length);
+#else
+            buffers[count].iov_base = const_cast<char*>(data);
+            buffers[count].iov_len = length;
+#endif
+            ++count;
+        }
+#ifdef _WIN32
+        DWORD sent = 0;
+        if (WSASend(static_cast<SOCKET>(connection.fd), buffers, static_cast<DWORD>(count), &sent, 0, nullptr,
+                    nullptr) != 0) {
+            return -1;
+        }
+        return static_cast<long long>(sent);
+#else
+        msghdr message{};
+        message.msg_iov = buffers;
+        message.msg_iovlen = count;
+        return ::sendmsg(connection.fd, &message, MSG_NOSIGNAL);
+#endif
+    }
+
+    auto send_file_segment(Connection& connection, const OutputSegment& segment) -> long long {
+        uint64_t offset = segment.file_offset + connection.segment_progress;
+        size_t remaining = segment.length - connection.segment_progress;
+#if defined(__linux__)
+        off_t position = static_cast<off_t>(offset);
+        return ::sendfile(connection.fd, segment.file, &position, std::min<size_t>(remaining, 1u << 30));
+#elif !defined(_WIN32)
+        char chunk[64 * 1024];
+        auto got = ::pread(segment.file, chunk, std::min(remaining, sizeof(chunk)), static_cast<off_t>(offset));
+        if (got <= 0) {
+            return got;
+        }
+        return ::send(connection.fd, chunk, static_cast<size_t>(got), MSG_NOSIGNAL);
+#else
+        (void)connection; (void)offset; (void)remaining;
+        return 0;       // send_file reads into the body on Windows, so no file segments are queued
+#endif
+    }
+
+    HttpServer& owner_;
+    Poller poller_;
+    std::unordered_map<native_socket_handle, std::unique_ptr<Connection>> connections_;
+    std::mutex pending_mutex_;
+    std::vector<std::unique_ptr<Connection>> pending_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+// ============================================================================
+// HttpServer
+// ============================================================================
+
+HttpServer::HttpServer(AsyncDualStackServer& server, HttpServerConfig config)
+    : server_(server), config_(std::move(config)) {}
+
+HttpServer::~HttpServer() {
+    stop();
+}
+
+void HttpServer::set_handler(HttpHandler handler) {
+    handler_ = std::move(handler);
+}
+
+bool HttpServer::start() {
+    if (running_) {
+        return true;
+    }
+    size_t threads = config_.io_threads ? config_.io_threads : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < threads; ++i) {
+        auto io_thread = std::make_unique<IoThread>(*this);
+        if (!io_thread->start()) {
+            std::cerr << "❌ Failed to start HTTP I/O thread" << std::endl;
+            io_threads_.clear();
+            return false;
+        }
+        io_threads_.push_back(std::move(io_thread));
+    }
+
+    running_ = true;
+    server_.set_connection_handler([this](std::string connection_id, Socket& socket, const IPAddress&) {
+        adopt(std::move(connection_id), socket);
+    });
+    if (!server_.is_running() && !server_.start()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void HttpServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // I/O threads close their connections first; the server owns the sockets
+    for (auto& io_thread : io_threads_) {
+        io_thread->stop();
+    }
+    server_.stop();
+    server_.set_connection_handler(nullptr);
+    io_threads_.clear();
+}
+
+void HttpServer::adopt(std::string connection_id, Socket& socket) {
+    if (!running_ || socket.set_non_blocking(true) != error_code::success) {
+        server_.close_connection(connection_id);
+        return;
+    }
+    int no_delay = 1;
+    ::setsockopt(socket.get_native_handle(), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay),
+                 sizeof(no_delay));
+
+    auto connection = std::make_unique<Connection>();
+    connection->id = std::move(connection_id);
+    connection->fd = socket.get_native_handle();
+    connection->input.resize(INITIAL_INPUT_BYTES);
+    ++connections_;
+    ++open_connections_;
+    io_threads_[next_thread_++ % io_threads_.size()]->adopt(std::move(connection));
+}
+
+void HttpServer::close(Connection& connection) {
+    server_.close_connection(connection.id);
+    --open_connections_;
+}
+
+HttpServerStats HttpServer::get_stats() const {
+    HttpServerStats stats;
+    stats.connections = connections_.load();
+    stats.requests = requests_.load();
+    stats.pipelined = pipelined_.load();
+    stats.parse_errors = parse_errors_.load();
+    stats.bytes_sent = bytes_sent_.load();
+    stats.bytes_sendfile = bytes_sendfile_.load();
+    stats.open_connections = open_connections_.load();
+    return stats;
+}
+
+} // namespace http
+} // namespace network
+} // namespace dualstack
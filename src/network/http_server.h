@@ -0,0 +1,213 @@
+/**
+ * Amphisbaena 🐍 - HTTP/1.1 Server Layer
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * HTTP/1.1 on top of AsyncDualStackServer connections:
+ *   - request parser that never allocates: every field is a view into the
+ *     connection's receive buffer, and line scanning is SIMD (SSE2 / NEON)
+ *   - keep-alive and pipelining; responses to a batch of pipelined requests
+ *     leave in one gathered write (writev/sendmsg) built from static status
+ *     line and Connection fragments
+ *   - file bodies are sent with sendfile
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "async_connection_manager.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace http {
+
+constexpr size_t MAX_HTTP_HEADERS = 64;
+
+enum class HttpError : uint8_t {
+    incomplete,             // Need more bytes; not an error on the connection
+    bad_request,            // 400
+    body_too_large,         // 413
+    header_too_large,       // 431 (also more than MAX_HTTP_HEADERS headers)
+    not_implemented,        // 501: request Transfer-Encoding (chunked uploads)
+    version_not_supported   // 505
+};
+
+AMPHISBAENA_API const char* describe(HttpError error);
+AMPHISBAENA_API uint16_t status_for(HttpError error);
+
+struct HttpLimits {
+    size_t max_header_bytes = 16 * 1024;            // Request line + headers
+    size_t max_body_bytes = 8 * 1024 * 1024;
+};
+
+struct HttpHeader {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * @brief Parsed request; all views point into the parsed buffer
+ */
+struct AMPHISBAENA_API HttpRequest {
+    std::string_view method;
+    std::string_view target;        // As sent: path plus optional ?query
+    std::string_view path;
+    std::string_view query;         // Without the '?'
+    uint8_t version_minor = 1;      // HTTP/1.x
+    std::array<HttpHeader, MAX_HTTP_HEADERS> headers{};
+    size_t header_count = 0;
+    uint64_t content_length = 0;
+    std::string_view body;
+    bool keep_alive = true;
+    bool expect_continue = false;
+    size_t head_size = 0;           // Request line + headers, set once the head is complete
+
+    std::span<const HttpHeader> all_headers() const { return {headers.data(), header_count}; }
+
+    // Case-insensitive lookup of the first header with this name; empty if absent
+    std::string_view header(std::string_view name) const;
+};
+
+/**
+ * @brief Parse one request from the start of buffer
+ * @return Bytes consumed (head + body); HttpError::incomplete if the buffer ends first
+ */
+AMPHISBAENA_API std::expected<size_t, HttpError> parse_request(std::string_view buffer, HttpRequest& request,
+                                                                const HttpLimits& limits = {});
+
+/**
+ * @brief Response under construction; reused for every request on a connection,
+ * so its buffers stop allocating once warm
+ */
+class AMPHISBAENA_API HttpResponse {
+public:
+    HttpResponse() = default;
+    ~HttpResponse() { release_file(); }
+
+    HttpResponse(const HttpResponse&) = delete;
+    HttpResponse& operator=(const HttpResponse&) = delete;
+
+    void set_status(uint16_t status) { status_ = status; }
+    uint16_t status() const { return status_; }
+
+    // Date, Content-Length and Connection are added by the server
+    void add_header(std::string_view name, std::string_view value);
+
+    void set_body(std::string_view body);
+    void set_body(std::span<const std::byte> body);
+
+    /**
+     * @brief Send [offset, offset + length) of a file as the body (sendfile where available)
+     * @return false if the file cannot be opened or the range lies outside it
+     */
+    bool send_file(const std::filesystem::path& path, uint64_t offset = 0, uint64_t length = UINT64_MAX);
+
+    // Answer, then close the connection
+    void close_connection() { close_ = true; }
+
+private:
+    friend class HttpServer;
+
+    void reset();
+    void release_file();
+
+    uint16_t status_ = 200;
+    std::string headers_;           // "Name: value\r\n" lines
+    std::string body_;
+    int file_ = -1;                 // Owned until handed to the connection's output queue
+    uint64_t file_offset_ = 0;
+    uint64_t file_length_ = 0;
+    bool close_ = false;
+};
+
+using HttpHandler = std::function<void(const HttpRequest&, HttpResponse&)>;
+
+/**
+ * @brief HTTP Server Configuration
+ */
+struct AMPHISBAENA_API HttpServerConfig {
+    size_t io_threads = 0;                          // 0 = one per hardware thread
+    HttpLimits limits;
+    std::chrono::seconds keep_alive_timeout{15};    // Idle connections are closed after this
+    std::chrono::seconds write_timeout{30};         // As are connections whose queued output stops draining
+};
+
+/**
+ * @brief HTTP Server Statistics
+ */
+struct AMPHISBAENA_API HttpServerStats {
+    uint64_t connections = 0;
+    uint64_t requests = 0;
+    uint64_t pipelined = 0;         // Requests answered in the same write as the previous one
+    uint64_t parse_errors = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_sendfile = 0;
+    size_t open_connections = 0;
+};
+
+/**
+ * @brief HTTP/1.1 server on an AsyncDualStackServer
+ *
+ * Installs itself as the server's connection handler and runs accepted
+ * sockets non-blocking on its own I/O threads (epoll on Linux, poll
+ * elsewhere). Handlers run on those threads and must not block.
+ */
+class AMPHISBAENA_API HttpServer {
+public:
+    explicit HttpServer(AsyncDualStackServer& server, HttpServerConfig config = {});
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    void set_handler(HttpHandler handler);
+
+    // Start the I/O threads, then the AsyncDualStackServer if it is not running
+    bool start();
+    // Close HTTP connections and stop the AsyncDualStackServer, which owns their sockets
+    void stop();
+    bool is_running() const { return running_; }
+
+    HttpServerStats get_stats() const;
+
+private:
+    class IoThread;
+    struct Connection;
+
+    void adopt(std::string connection_id, Socket& socket);
+    void close(Connection& connection);
+
+    AsyncDualStackServer& server_;
+    HttpServerConfig config_;
+    HttpHandler handler_;
+    std::vector<std::unique_ptr<IoThread>> io_threads_;
+    std::atomic<size_t> next_thread_{0};
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint64_t> connections_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> pipelined_{0};
+    std::atomic<uint64_t> parse_errors_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> bytes_sendfile_{0};
+    std::atomic<size_t> open_connections_{0};
+};
+
+} // namespace http
+} // namespace network
+} // namespace dualstack
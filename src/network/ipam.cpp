@@ -0,0 +1,353 @@
+/**
+ * Amphisbaena 🐍 - IP Address Management Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "../../include/dualstack_net26/network/ipam.h"
+#include <algorithm>
+#include <bit>
+
+namespace dualstack {
+namespace network {
+
+// ============================================================================
+// HierarchicalBitmap Implementation
+// ============================================================================
+
+HierarchicalBitmap::HierarchicalBitmap(std::size_t size) : size_(size) {
+    std::size_t words = (size + 63) / 64;
+    do {
+        levels_.emplace_back(std::max<std::size_t>(words, 1), 0);
+        words = (words + 63) / 64;
+    } while (levels_.back().size() > 1);
+}
+
+auto HierarchicalBitmap::set(std::size_t index) -> void {
+    for (auto& level : levels_) {
+        std::uint64_t& word = level[index / 64];
+        bool was_empty = word == 0;
+        std::uint64_t bit = std::uint64_t(1) << (index % 64);
+        if (&level == &levels_[0]) {
+            if (word & bit) {
+                return;
+            }
+            ++count_;
+        }
+        word |= bit;
+        if (!was_empty) {
+            return;         // Summaries above already mark this word
+        }
+        index /= 64;
+    }
+}
+
+auto HierarchicalBitmap::reset(std::size_t index) -> void {
+    for (auto& level : levels_) {
+        std::uint64_t& word = level[index / 64];
+        std::uint64_t bit = std::uint64_t(1) << (index % 64);
+        if (&level == &levels_[0]) {
+            if (!(word & bit)) {
+                return;
+            }
+            --count_;
+        }
+        word &= ~bit;
+        if (word != 0) {
+            return;         // Still non-empty: summaries above stay set
+        }
+        index /= 64;
+    }
+}
+
+auto HierarchicalBitmap::find_first() const -> std::optional<std::size_t> {
+    if (levels_.back()[0] == 0) {
+        return std::nullopt;
+    }
+    std::size_t index = 0;
+    for (std::size_t level = levels_.size(); level-- > 0;) {
+        index = index * 64 + static_cast<std::size_t>(std::countr_zero(levels_[level][index]));
+    }
+    return index;
+}
+
+// ============================================================================
+// IpamPool Implementation
+// ============================================================================
+
+IpamPool::IpamPool(const IpamConfig& config)
+    : config_(config)
+    , entries_(std::size_t(1) << (32 - config.prefix_length))
+    , free_(entries_.size())
+    , wheel_(config.wheel_slots)
+    , epoch_(std::chrono::steady_clock::now()) {
+    network_ = config.base.address & (~std::uint32_t(0) << (32 - config.prefix_length));
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        free_.set(i);
+    }
+
+    // Network and broadcast addresses are never handed out
+    auto hold = [this](std::size_t index) {
+        entries_[index].state = EntryState::FIXED;
+        free_.reset(index);
+    };
+    hold(0);
+    hold(entries_.size() - 1);
+    if (config_.reserve_gateway) {
+        hold(1);
+    }
+}
+
+auto IpamPool::create(const IpamConfig& config) -> std::expected<std::unique_ptr<IpamPool>, std::string> {
+    if (config.prefix_length < MIN_PREFIX_LENGTH || config.prefix_length > MAX_PREFIX_LENGTH) {
+        return std::unexpected("IPv4 prefix must be /" + std::to_string(MIN_PREFIX_LENGTH) + " to /" +
+                               std::to_string(MAX_PREFIX_LENGTH));
+    }
+    if (config.ipv6_prefix && (config.ipv6_prefix_length < 0 || config.ipv6_prefix_length > 96)) {
+        return std::unexpected(std::string("IPv6 prefix must be at most /96"));
+    }
+    if (config.lease_tick.count() <= 0 || config.wheel_slots == 0) {
+        return std::unexpected(std::string("Lease wheel needs a positive tick and at least one slot"));
+    }
+    return std::unique_ptr<IpamPool>(new IpamPool(config));
+}
+
+auto IpamPool::index_of(const ipv4_address& ipv4) const -> std::optional<std::uint32_t> {
+    std::uint32_t index = ipv4.address - network_;
+    if (index >= entries_.size()) {
+        return std::nullopt;
+    }
+    return index;
+}
+
+auto IpamPool::lease_for(std::uint32_t index) const -> IpamLease {
+    const Entry& entry = entries_[index];
+    IpamLease lease;
+    lease.ipv4 = ipv4_address(network_ + index);
+    if (entry.dual_stack && config_.ipv6_prefix) {
+        lease.ipv6 = ipv6_for(lease.ipv4);
+    }
+    if (entry.expires_tick != 0) {
+        lease.expires_at = epoch_ + config_.lease_tick * entry.expires_tick;
+    }
+    return lease;
+}
+
+auto IpamPool::tick_of(std::chrono::steady_clock::time_point time) const -> std::int64_t {
+    return (time - epoch_) / config_.lease_tick;
+}
+
+auto IpamPool::schedule_locked(std::uint32_t index, std::chrono::seconds duration) -> void {
+    Entry& entry = entries_[index];
+    if (duration.count() <= 0) {
+        entry.expires_tick = 0;
+        return;
+    }
+    // Rounded up, and never in a tick the wheel has already passed
+    auto remaining = std::chrono::steady_clock::now() + duration - epoch_;
+    std::int64_t tick = (remaining + config_.lease_tick - std::chrono::nanoseconds(1)) / config_.lease_tick;
+    entry.expires_tick = std::max(tick, current_tick_ + 1);
+    wheel_[static_cast<std::size_t>(entry.expires_tick) % wheel_.size()].emplace_back(index, entry.generation);
+}
+
+auto IpamPool::take_locked(std::uint32_t index, bool dual_stack, std::chrono::seconds duration) -> IpamLease {
+    Entry& entry = entries_[index];
+    ++entry.generation;
+    entry.state = EntryState::LEASED;
+    entry.dual_stack = dual_stack;
+    free_.reset(index);
+    schedule_locked(index, duration);
+    ++stats_.allocations;
+    return lease_for(index);
+}
+
+auto IpamPool::free_locked(std::uint32_t index) -> void {
+    Entry& entry = entries_[index];
+    ++entry.generation;
+    entry.state = EntryState::FREE;
+    entry.dual_stack = false;
+    entry.expires_tick = 0;
+    free_.set(index);
+}
+
+auto IpamPool::allocate(std::chrono::seconds duration) -> std::expected<IpamLease, std::string> {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto index = free_.find_first();
+    if (!index) {
+        ++stats_.exhausted;
+        return std::unexpected(std::string("Address pool exhausted"));
+    }
+    return take_locked(static_cast<std::uint32_t>(*index), false, duration);
+}
+
+auto IpamPool::allocate_dual_stack(std::chrono::seconds duration) -> std::expected<IpamLease, std::string> {
+    if (!config_.ipv6_prefix) {
+        return std::unexpected(std::string("No IPv6 prefix configured"));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto index = free_.find_first();
+    if (!index) {
+        ++stats_.exhausted;
+        return std::unexpected(std::string("Address pool exhausted"));
+    }
+    return take_locked(static_cast<std::uint32_t>(*index), true, duration);
+}
+
+auto IpamPool::allocate_batch(std::size_t count, bool dual_stack, std::chrono::seconds duration,
+                              std::vector<IpamLease>& out) -> std::size_t {
+    if (dual_stack && !config_.ipv6_prefix) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t allocated = 0;
+    for (; allocated < count; ++allocated) {
+        auto index = free_.find_first();
+        if (!index) {
+            ++stats_.exhausted;
+            break;
+        }
+        out.push_back(take_locked(static_cast<std::uint32_t>(*index), dual_stack, duration));
+    }
+    return allocated;
+}
+
+auto IpamPool::reserve(const ipv4_address& ipv4) -> std::expected<IpamLease, std::string> {
+    auto index = index_of(ipv4);
+    if (!index) {
+        return std::unexpected(std::string("Address outside the subnet: " + ipv4.to_string()));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[*index];
+    bool claimable = entry.state == EntryState::FREE ||
+                     (entry.state == EntryState::FIXED && is_gateway_index(*index));
+    if (!claimable) {
+        return std::unexpected(std::string("Address already in use: " + ipv4.to_string()));
+    }
+    ++entry.generation;
+    entry.state = EntryState::RESERVED;
+    entry.dual_stack = config_.ipv6_prefix.has_value();
+    entry.expires_tick = 0;
+    free_.reset(*index);
+    ++stats_.allocations;
+    return lease_for(*index);
+}
+
+auto IpamPool::release(const ipv4_address& ipv4) -> bool {
+    auto index = index_of(ipv4);
+    if (!index) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[*index];
+    if (entry.state == EntryState::FREE || entry.state == EntryState::FIXED) {
+        return false;
+    }
+    if (is_gateway_index(*index)) {
+        // A claimed gateway goes back to being held, never into the free set
+        ++entry.generation;
+        entry.state = EntryState::FIXED;
+        entry.dual_stack = false;
+        entry.expires_tick = 0;
+    } else {
+        free_locked(*index);
+    }
+    ++stats_.releases;
+    return true;
+}
+
+auto IpamPool::renew(const ipv4_address& ipv4, std::chrono::seconds duration) -> bool {
+    auto index = index_of(ipv4);
+    if (!index) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[*index];
+    if (entry.state != EntryState::LEASED) {
+        return false;
+    }
+    ++entry.generation;         // The old wheel entry goes stale
+    schedule_locked(*index, duration);
+    return true;
+}
+
+auto IpamPool::expire_leases(std::chrono::steady_clock::time_point now, std::vector<IpamLease>* expired) -> std::size_t {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::int64_t now_tick = tick_of(now);
+    if (now_tick <= current_tick_) {
+        return 0;
+    }
+
+    // One revolution at most: every slot is visited once however long the gap
+    std::int64_t steps = std::min<std::int64_t>(now_tick - current_tick_, static_cast<std::int64_t>(wheel_.size()));
+    std::size_t count = 0;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> due;
+    for (std::int64_t step = 1; step <= steps; ++step) {
+        auto& slot = wheel_[static_cast<std::size_t>(current_tick_ + step) % wheel_.size()];
+        due.swap(slot);
+        for (auto [index, generation] : due) {
+            const Entry& entry = entries_[index];
+            if (entry.generation != generation || entry.state != EntryState::LEASED) {
+                continue;       // Renewed or released since it was scheduled
+            }
+            if (entry.expires_tick > now_tick) {
+                slot.emplace_back(index, generation);       // A later revolution
+                continue;
+            }
+            if (expired) {
+                expired->push_back(lease_for(index));
+            }
+            free_locked(index);
+            ++count;
+        }
+        due.clear();
+    }
+    current_tick_ = now_tick;
+    stats_.expirations += count;
+    return count;
+}
+
+auto IpamPool::is_allocated(const ipv4_address& ipv4) const -> bool {
+    auto index = index_of(ipv4);
+    if (!index) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_[*index].state != EntryState::FREE;
+}
+
+auto IpamPool::ipv6_for(const ipv4_address& ipv4) const -> std::optional<ipv6_address> {
+    if (!config_.ipv6_prefix || !index_of(ipv4)) {
+        return std::nullopt;
+    }
+    // Keep the prefix bits, then put the IPv4 address in the low 32 bits
+    const ipv6_address& prefix = *config_.ipv6_prefix;
+    int length = config_.ipv6_prefix_length;
+    std::uint64_t high_mask = length >= 64 ? ~std::uint64_t(0) : (length == 0 ? 0 : ~std::uint64_t(0) << (64 - length));
+    std::uint64_t low_mask = length <= 64 ? 0 : ~std::uint64_t(0) << (128 - length);
+    return ipv6_address(prefix.high & high_mask, (prefix.low & low_mask) | ipv4.address);
+}
+
+auto IpamPool::gateway() const -> std::optional<ipv4_address> {
+    if (!config_.reserve_gateway) {
+        return std::nullopt;
+    }
+    return ipv4_address(network_ + 1);
+}
+
+auto IpamPool::subnet_mask() const -> ipv4_address {
+    return ipv4_address(~std::uint32_t(0) << (32 - config_.prefix_length));
+}
+
+auto IpamPool::available() const -> std::size_t {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.count();
+}
+
+auto IpamPool::get_stats() const -> IpamStats {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,779 @@
+/**
+ * Amphisbaena 🐍 - Multicast Distribution Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "multicast.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+#else
+#include <net/if.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+namespace dualstack {
+namespace network {
+namespace multicast {
+
+namespace {
+
+constexpr uint32_t PACKET_MAGIC = 0x524D4331;      // "RMC1"
+constexpr size_t HEADER_SIZE = 32;
+constexpr size_t NACK_RANGE_SIZE = 12;             // First sequence (8) and count (4)
+
+enum class PacketType : uint8_t {
+    data = 1,
+    heartbeat = 2,
+    nack = 3
+};
+
+constexpr uint8_t FLAG_REPAIR = 0x01;
+
+// Wire header, big-endian:
+//   magic(4) type(1) flags(1) reserved(2) session(8) sequence(8) aux(8)
+// DATA:      sequence = its number, aux = sender's lowest retained sequence
+// HEARTBEAT: sequence = next to be sent, aux = lowest retained sequence
+// NACK:      aux = range count; the payload lists the missing ranges
+struct PacketHeader {
+    PacketType type = PacketType::data;
+    uint8_t flags = 0;
+    uint64_t session = 0;
+    uint64_t sequence = 0;
+    uint64_t aux = 0;
+};
+
+void put_u32(std::byte* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<std::byte>(value >> (24 - i * 8));
+    }
+}
+
+void put_u64(std::byte* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<std::byte>(value >> (56 - i * 8));
+    }
+}
+
+uint32_t get_u32(const std::byte* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value = (value << 8) | std::to_integer<uint32_t>(in[i]);
+    }
+    return value;
+}
+
+uint64_t get_u64(const std::byte* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | std::to_integer<uint64_t>(in[i]);
+    }
+    return value;
+}
+
+void encode_header(const PacketHeader& header, std::byte* out) {
+    put_u32(out, PACKET_MAGIC);
+    out[4] = static_cast<std::byte>(header.type);
+    out[5] = static_cast<std::byte>(header.flags);
+    out[6] = std::byte{0};
+    out[7] = std::byte{0};
+    put_u64(out + 8, header.session);
+    put_u64(out + 16, header.sequence);
+    put_u64(out + 24, header.aux);
+}
+
+std::optional<PacketHeader> decode_header(std::span<const std::byte> datagram) {
+    if (datagram.size() < HEADER_SIZE || get_u32(datagram.data()) != PACKET_MAGIC) {
+        return std::nullopt;
+    }
+    PacketHeader header;
+    header.type = static_cast<PacketType>(datagram[4]);
+    header.flags = std::to_integer<uint8_t>(datagram[5]);
+    header.session = get_u64(datagram.data() + 8);
+    header.sequence = get_u64(datagram.data() + 16);
+    header.aux = get_u64(datagram.data() + 24);
+    return header;
+}
+
+IPAddress wildcard_for(const IPAddress& address) {
+    return address.is_ipv6() ? IPAddress(ipv6_address()) : IPAddress(ipv4_address());
+}
+
+bool same_group(const MulticastGroup& a, const MulticastGroup& b) {
+    return a.group == b.group && a.source == b.source && a.interface_index == b.interface_index;
+}
+
+// IP_MULTICAST_LOOP / IP_MULTICAST_TTL take a byte on the BSDs, an int on Linux and Windows
+#if defined(_WIN32) || defined(__linux__)
+using ipv4_option_t = int;
+#else
+using ipv4_option_t = unsigned char;
+#endif
+
+int set_option(Socket& socket, int level, int name, const void* value, socklen_t length) {
+    return setsockopt(static_cast<int>(socket.get_native_handle()), level, name,
+                      reinterpret_cast<const char*>(value), length);
+}
+
+} // namespace
+
+bool is_multicast(const IPAddress& address) {
+    if (address.is_ipv4()) {
+        return (address.get_ipv4().address >> 28) == 0xE;                  // 224.0.0.0/4
+    }
+    return (address.get_ipv6().high >> 56) == 0xFF;                         // ff00::/8
+}
+
+bool is_source_specific(const IPAddress& address) {
+    if (address.is_ipv4()) {
+        return (address.get_ipv4().address >> 24) == 232;                   // 232.0.0.0/8
+    }
+    return (address.get_ipv6().high >> 52) == 0xFF3;                        // ff3x::/32
+}
+
+uint32_t interface_index(std::string_view name) {
+    std::string terminated(name);
+    return static_cast<uint32_t>(::if_nametoindex(terminated.c_str()));
+}
+
+// ============================================================================
+// MulticastSocket
+// ============================================================================
+
+MulticastSocket::~MulticastSocket() {
+    close();
+}
+
+MulticastSocket& MulticastSocket::operator=(MulticastSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        socket_ = std::move(other.socket_);
+        ipv6_ = other.ipv6_;
+        groups_ = std::move(other.groups_);
+        other.groups_.clear();
+    }
+    return *this;
+}
+
+error_code MulticastSocket::open(const IPAddress& bind_addr, port_t port) {
+    close();
+    ipv6_ = bind_addr.is_ipv6();
+    if (auto result = socket_.open_datagram(ipv6_); result != error_code::success) {
+        return result;
+    }
+
+    // Every member process on this host binds the group port
+    (void)socket_.set_reuse_address(true);
+#ifdef SO_REUSEPORT
+    int reuse = 1;
+    set_option(socket_, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse));
+#endif
+#if defined(__linux__)
+    // Linux otherwise delivers every group joined by any socket on the port
+    int all = 0;
+    if (ipv6_) {
+#ifdef IPV6_MULTICAST_ALL
+        set_option(socket_, IPPROTO_IPV6, IPV6_MULTICAST_ALL, &all, sizeof(all));
+#endif
+    } else {
+        set_option(socket_, IPPROTO_IP, IP_MULTICAST_ALL, &all, sizeof(all));
+    }
+#endif
+
+    if (auto result = socket_.bind(bind_addr, port); result != error_code::success) {
+        socket_.disconnect();
+        return result;
+    }
+    return error_code::success;
+}
+
+void MulticastSocket::close() {
+    if (!socket_.is_open()) {
+        groups_.clear();
+        return;
+    }
+    for (const auto& group : groups_) {
+        (void)change_membership(group, false);
+    }
+    groups_.clear();
+    socket_.disconnect();
+}
+
+error_code MulticastSocket::join(const MulticastGroup& group) {
+    if (auto result = change_membership(group, true); result != error_code::success) {
+        return result;
+    }
+    groups_.push_back(group);
+    return error_code::success;
+}
+
+error_code MulticastSocket::leave(const MulticastGroup& group) {
+    auto joined = std::find_if(groups_.begin(), groups_.end(),
+                               [&](const MulticastGroup& candidate) { return same_group(candidate, group); });
+    if (joined == groups_.end()) {
+        return error_code::invalid_address;
+    }
+    groups_.erase(joined);
+    return change_membership(group, false);
+}
+
+// RFC 3678 protocol-independent options: the kernel sends IGMP or MLD reports by family
+error_code MulticastSocket::change_membership(const MulticastGroup& group, bool join) {
+    if (!socket_.is_open() || !is_multicast(group.group) || group.group.is_ipv6() != ipv6_ ||
+        (group.source && group.source->is_ipv6() != ipv6_)) {
+        return error_code::invalid_address;
+    }
+
+    int level = ipv6_ ? IPPROTO_IPV6 : IPPROTO_IP;
+    socklen_t length = 0;
+    int result;
+    if (group.source) {
+        group_source_req request{};
+        request.gsr_interface = group.interface_index;
+        ip_to_sockaddr(group.group, 0, request.gsr_group, length);
+        ip_to_sockaddr(*group.source, 0, request.gsr_source, length);
+        result = set_option(socket_, level, join ? MCAST_JOIN_SOURCE_GROUP : MCAST_LEAVE_SOURCE_GROUP,
+                            &request, sizeof(request));
+    } else {
+        group_req request{};
+        request.gr_interface = group.interface_index;
+        ip_to_sockaddr(group.group, 0, request.gr_group, length);
+        result = set_option(socket_, level, join ? MCAST_JOIN_GROUP : MCAST_LEAVE_GROUP, &request, sizeof(request));
+    }
+
+    if (result != 0) {
+        if (join) {
+            std::cerr << "❌ Multicast join failed for " << group.group.to_string() << std::endl;
+        }
+        return error_code::connection_failed;
+    }
+    return error_code::success;
+}
+
+error_code MulticastSocket::set_send_interface(uint32_t interface_index) {
+    if (!socket_.is_open()) {
+        return error_code::invalid_address;
+    }
+    int result;
+    if (ipv6_) {
+        unsigned int index = interface_index;
+        result = set_option(socket_, IPPROTO_IPV6, IPV6_MULTICAST_IF, &index, sizeof(index));
+    } else {
+#if defined(__linux__)
+        ip_mreqn request{};
+        request.imr_ifindex = static_cast<int>(interface_index);
+        result = set_option(socket_, IPPROTO_IP, IP_MULTICAST_IF, &request, sizeof(request));
+#elif defined(_WIN32)
+        // An address in 0.0.0.0/8 is taken as an interface index
+        DWORD index = htonl(interface_index);
+        result = set_option(socket_, IPPROTO_IP, IP_MULTICAST_IF, &index, sizeof(index));
+#else
+        // BSD IP_MULTICAST_IF selects by address only
+        if (interface_index != 0) {
+            return error_code::invalid_address;
+        }
+        in_addr any{};
+        result = set_option(socket_, IPPROTO_IP, IP_MULTICAST_IF, &any, sizeof(any));
+#endif
+    }
+    return result == 0 ? error_code::success : error_code::invalid_address;
+}
+
+error_code MulticastSocket::set_loopback(bool enabled) {
+    if (!socket_.is_open()) {
+        return error_code::invalid_address;
+    }
+    int result;
+    if (ipv6_) {
+        unsigned int value = enabled ? 1 : 0;
+        result = set_option(socket_, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &value, sizeof(value));
+    } else {
+        ipv4_option_t value = enabled ? 1 : 0;
+        result = set_option(socket_, IPPROTO_IP, IP_MULTICAST_LOOP, &value, sizeof(value));
+    }
+    return result == 0 ? error_code::success : error_code::invalid_address;
+}
+
+error_code MulticastSocket::set_hops(int hops) {
+    if (!socket_.is_open() || hops < 0 || hops > 255) {
+        return error_code::invalid_address;
+    }
+    int result;
+    if (ipv6_) {
+        result = set_option(socket_, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &hops, sizeof(hops));
+    } else {
+        ipv4_option_t value = static_cast<ipv4_option_t>(hops);
+        result = set_option(socket_, IPPROTO_IP, IP_MULTICAST_TTL, &value, sizeof(value));
+    }
+    return result == 0 ? error_code::success : error_code::invalid_address;
+}
+
+size_t MulticastSocket::send_to(std::span<const std::byte> data, const IPAddress& address, port_t port) {
+    return socket_.send_to(buffer_t(data.data(), data.size()), address, port);
+}
+
+size_t MulticastSocket::receive_from(std::span<std::byte> buffer, IPAddress& address, port_t& port,
+                                     std::chrono::milliseconds timeout) {
+    if (!socket_.is_open()) {
+        return 0;
+    }
+#ifdef _WIN32
+    WSAPOLLFD entry{};
+    entry.fd = static_cast<SOCKET>(socket_.get_native_handle());
+    entry.events = POLLRDNORM;
+    if (WSAPoll(&entry, 1, static_cast<INT>(timeout.count())) <= 0) {
+        return 0;
+    }
+#else
+    pollfd entry{};
+    entry.fd = socket_.get_native_handle();
+    entry.events = POLLIN;
+    if (::poll(&entry, 1, static_cast<int>(timeout.count())) <= 0) {
+        return 0;
+    }
+#endif
+    return socket_.receive_from(buffer_t(buffer.data(), buffer.size()), address, port);
+}
+
+// ============================================================================
+// ReliableMulticastSender
+// ============================================================================
+
+ReliableMulticastSender::ReliableMulticastSender(ReliableMulticastConfig config)
+    : config_(std::move(config)) {
+    std::random_device device;
+    session_ = (uint64_t(device()) << 32) ^ device() ^
+               static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+ReliableMulticastSender::~ReliableMulticastSender() {
+    stop();
+}
+
+bool ReliableMulticastSender::start() {
+    if (running_) {
+        return true;
+    }
+    if (socket_.open(wildcard_for(config_.group.group), 0) != error_code::success ||
+        (config_.send_interface != 0 && socket_.set_send_interface(config_.send_interface) != error_code::success) ||
+        socket_.set_loopback(config_.loopback) != error_code::success ||
+        socket_.set_hops(config_.hops) != error_code::success) {
+        std::cerr << "❌ Reliable multicast sender failed to open for " << config_.group.group.to_string() << std::endl;
+        socket_.close();
+        return false;
+    }
+
+    running_ = true;
+    {
+        // Receivers learn the session and its starting sequence before any data
+        std::lock_guard<std::mutex> lock(mutex_);
+        send_heartbeat_locked();
+    }
+    thread_ = std::thread([this] { service_loop(); });
+    std::cout << "🐍 Reliable multicast session " << std::hex << session_ << std::dec << " to "
+              << config_.group.group.to_string() << ":" << config_.port << std::endl;
+    return true;
+}
+
+void ReliableMulticastSender::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    socket_.close();
+}
+
+std::optional<uint64_t> ReliableMulticastSender::send(std::span<const std::byte> payload) {
+    if (!running_ || payload.size() > config_.max_payload) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t sequence = next_sequence_;
+    uint64_t lowest = window_.empty() ? sequence : window_.front().sequence;
+    if (window_.size() >= config_.retransmit_window && !window_.empty()) {
+        lowest = window_.size() > 1 ? window_[1].sequence : sequence;
+    }
+
+    Retained retained;
+    retained.sequence = sequence;
+    retained.packet.resize(HEADER_SIZE + payload.size());
+    encode_header({PacketType::data, 0, session_, sequence, lowest}, retained.packet.data());
+    std::copy(payload.begin(), payload.end(), retained.packet.begin() + HEADER_SIZE);
+
+    if (socket_.send_to(retained.packet, config_.group.group, config_.port) != retained.packet.size()) {
+        return std::nullopt;
+    }
+    auto now = std::chrono::steady_clock::now();
+    retained.last_sent = now;
+    last_send_ = now;
+    ++next_sequence_;
+
+    window_.push_back(std::move(retained));
+    while (window_.size() > config_.retransmit_window) {
+        window_.pop_front();
+    }
+    ++stats_.packets_sent;
+    stats_.bytes_sent += payload.size();
+    return sequence;
+}
+
+void ReliableMulticastSender::send_heartbeat_locked() {
+    std::byte packet[HEADER_SIZE];
+    uint64_t lowest = window_.empty() ? next_sequence_ : window_.front().sequence;
+    encode_header({PacketType::heartbeat, 0, session_, next_sequence_, lowest}, packet);
+    socket_.send_to(packet, config_.group.group, config_.port);
+    last_send_ = std::chrono::steady_clock::now();
+    ++stats_.heartbeats_sent;
+}
+
+void ReliableMulticastSender::service_loop() {
+    std::vector<std::byte> datagram(HEADER_SIZE + config_.max_payload);
+    while (running_) {
+        std::chrono::milliseconds wait;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto now = std::chrono::steady_clock::now();
+            // Silence would hide tail loss: heartbeats carry the next sequence
+            if (now - last_send_ >= config_.heartbeat_interval) {
+                send_heartbeat_locked();
+                now = last_send_;
+            }
+            wait = std::chrono::duration_cast<std::chrono::milliseconds>(last_send_ + config_.heartbeat_interval - now);
+        }
+
+        IPAddress from;
+        port_t from_port = 0;
+        size_t received = socket_.receive_from(datagram, from, from_port,
+                                               std::clamp(wait, std::chrono::milliseconds(1),
+                                                          std::chrono::milliseconds(100)));
+        if (received > 0) {
+            handle_nack(std::span<const std::byte>(datagram.data(), received));
+        }
+    }
+}
+
+void ReliableMulticastSender::handle_nack(std::span<const std::byte> datagram) {
+    auto header = decode_header(datagram);
+    if (!header || header->type != PacketType::nack || header->session != session_) {
+        return;
+    }
+    size_t ranges = std::min<size_t>(header->aux, (datagram.size() - HEADER_SIZE) / NACK_RANGE_SIZE);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.nacks_received;
+    auto now = std::chrono::steady_clock::now();
+    bool unavailable = false;
+    for (size_t i = 0; i < ranges; ++i) {
+        const std::byte* range = datagram.data() + HEADER_SIZE + i * NACK_RANGE_SIZE;
+        uint64_t first = get_u64(range);
+        uint64_t count = std::min<uint64_t>(get_u32(range + 8), config_.retransmit_window);
+        for (uint64_t sequence = first; sequence < first + count && sequence < next_sequence_; ++sequence) {
+            if (window_.empty() || sequence < window_.front().sequence) {
+                ++stats_.repairs_unavailable;
+                unavailable = true;
+                continue;
+            }
+            Retained& retained = window_[sequence - window_.front().sequence];
+            // Receivers missing the same packet NACK within one backoff of each other; repair once
+            if (now - retained.last_sent < config_.nack_delay) {
+                continue;
+            }
+            retained.packet[5] = static_cast<std::byte>(FLAG_REPAIR);
+            socket_.send_to(retained.packet, config_.group.group, config_.port);
+            retained.last_sent = now;
+            last_send_ = now;
+            ++stats_.retransmissions;
+        }
+    }
+    // Tell receivers promptly what can no longer be repaired
+    if (unavailable) {
+        send_heartbeat_locked();
+    }
+}
+
+ReliableMulticastSenderStats ReliableMulticastSender::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// ============================================================================
+// ReliableMulticastReceiver
+// ============================================================================
+
+ReliableMulticastReceiver::ReliableMulticastReceiver(ReliableMulticastConfig config)
+    : config_(std::move(config)) {
+    std::random_device device;
+    rng_state_ = (uint64_t(device()) << 32) | device() | 1;
+}
+
+ReliableMulticastReceiver::~ReliableMulticastReceiver() {
+    stop();
+}
+
+bool ReliableMulticastReceiver::start() {
+    if (running_) {
+        return true;
+    }
+    if (socket_.open(wildcard_for(config_.group.group), config_.port) != error_code::success ||
+        socket_.join(config_.group) != error_code::success) {
+        std::cerr << "❌ Reliable multicast receiver failed to join " << config_.group.group.to_string() << std::endl;
+        socket_.close();
+        return false;
+    }
+    running_ = true;
+    thread_ = std::thread([this] { receive_loop(); });
+    return true;
+}
+
+void ReliableMulticastReceiver::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    socket_.close();
+    senders_.clear();
+}
+
+void ReliableMulticastReceiver::receive_loop() {
+    std::vector<std::byte> datagram(HEADER_SIZE + config_.max_payload);
+    while (running_) {
+        IPAddress from;
+        port_t from_port = 0;
+        size_t received = socket_.receive_from(datagram, from, from_port,
+                                               next_timer(std::chrono::steady_clock::now()));
+        if (received > 0) {
+            handle_packet(std::span<const std::byte>(datagram.data(), received), from, from_port);
+        }
+        service_gaps(std::chrono::steady_clock::now());
+    }
+}
+
+void ReliableMulticastReceiver::handle_packet(std::span<const std::byte> datagram, const IPAddress& from,
+                                              port_t from_port) {
+    auto header = decode_header(datagram);
+    if (!header || (header->type != PacketType::data && header->type != PacketType::heartbeat)) {
+        return;
+    }
+    bool is_data = header->type == PacketType::data;
+    auto now = std::chrono::steady_clock::now();
+
+    auto found = senders_.find(header->session);
+    if (found == senders_.end()) {
+        // Late join: start from the first packet seen
+        SenderState state;
+        state.next_expected = header->sequence;
+        state.highest_seen = header->sequence;
+        found = senders_.emplace(header->session, std::move(state)).first;
+    }
+    SenderState& state = found->second;
+    state.address = from;
+    state.port = from_port;
+    state.lowest_retained = std::max(state.lowest_retained, header->aux);
+
+    if (!is_data) {
+        note_known(state, header->sequence, now);
+        deliver(header->session, state);
+        return;
+    }
+
+    if (config_.simulated_loss > 0.0) {
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 7;
+        rng_state_ ^= rng_state_ << 17;
+        if (static_cast<double>(rng_state_ >> 11) / static_cast<double>(1ULL << 53) < config_.simulated_loss) {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++stats_.dropped_simulated;
+            return;
+        }
+    }
+
+    uint64_t sequence = header->sequence;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.packets_received;
+        if (sequence < state.next_expected || state.pending.count(sequence) != 0) {
+            ++stats_.duplicates;
+            return;
+        }
+    }
+
+    // A gap only if it was already known to be missing; anything new past the
+    // highest seen leaves the sequences before it missing, but not itself
+    bool repaired = state.missing.erase(sequence) != 0;
+    note_known(state, sequence, now);
+    state.highest_seen = std::max(state.highest_seen, sequence + 1);
+    if (repaired) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.recovered;
+    }
+    if (sequence != state.next_expected && state.pending.size() >= config_.reorder_window) {
+        // No room to hold it: ask again later rather than deliver out of order
+        state.missing[sequence] = Gap{now + config_.nack_interval, 0};
+        return;
+    }
+    state.pending.emplace(sequence, std::vector<std::byte>(datagram.begin() + HEADER_SIZE, datagram.end()));
+    deliver(header->session, state);
+}
+
+// Sequences below `end` exist; each one not yet seen becomes a gap to NACK
+void ReliableMulticastReceiver::note_known(SenderState& state, uint64_t end, std::chrono::steady_clock::time_point now) {
+    if (end <= state.highest_seen) {
+        return;
+    }
+    // Gaps wider than the reorder window are not chased; deliver() reports the older part lost
+    uint64_t first = std::max(state.highest_seen, end > config_.reorder_window ? end - config_.reorder_window : 0);
+    uint64_t backoff = static_cast<uint64_t>(config_.nack_delay.count()) + 1;
+    for (uint64_t sequence = first; sequence < end; ++sequence) {
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 7;
+        rng_state_ ^= rng_state_ << 17;
+        state.missing.emplace(sequence, Gap{now + std::chrono::milliseconds(rng_state_ % backoff), 0});
+    }
+    state.highest_seen = end;
+}
+
+void ReliableMulticastReceiver::deliver(uint64_t session, SenderState& state) {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t lost_first = 0;
+    uint64_t lost_count = 0;
+    auto report_lost = [&] {
+        if (lost_count == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.lost += lost_count;
+        }
+        if (loss_handler_) {
+            loss_handler_(session, lost_first, lost_count);
+        }
+        lost_count = 0;
+    };
+
+    while (state.next_expected < state.highest_seen) {
+        uint64_t sequence = state.next_expected;
+        auto ready = state.pending.find(sequence);
+        if (ready != state.pending.end()) {
+            report_lost();
+            if (message_handler_) {
+                message_handler_(session, sequence, ready->second);
+            }
+            state.pending.erase(ready);
+            ++state.next_expected;
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++stats_.delivered;
+            continue;
+        }
+
+        auto gap = state.missing.find(sequence);
+        uint64_t skip_to = sequence + 1;
+        if (gap == state.missing.end()) {
+            // Never chased: skip straight to the next sequence we hold or still chase
+            skip_to = state.highest_seen;
+            if (!state.pending.empty()) {
+                skip_to = std::min(skip_to, state.pending.begin()->first);
+            }
+            if (!state.missing.empty()) {
+                skip_to = std::min(skip_to, state.missing.begin()->first);
+            }
+        } else {
+            bool exhausted = gap->second.attempts >= config_.max_nack_attempts && gap->second.next_nack <= now;
+            if (sequence >= state.lowest_retained && !exhausted) {
+                break;
+            }
+            state.missing.erase(gap);
+        }
+
+        if (lost_count == 0) {
+            lost_first = sequence;
+        }
+        lost_count += skip_to - sequence;
+        state.next_expected = skip_to;
+    }
+    report_lost();
+}
+
+void ReliableMulticastReceiver::service_gaps(std::chrono::steady_clock::time_point now) {
+    size_t max_ranges = std::max<size_t>(1, config_.max_payload / NACK_RANGE_SIZE);
+    std::vector<std::byte> packet;
+
+    for (auto& [session, state] : senders_) {
+        bool exhausted = false;
+        std::vector<std::pair<uint64_t, uint32_t>> ranges;
+        for (auto& [sequence, gap] : state.missing) {
+            if (gap.attempts >= config_.max_nack_attempts) {
+                exhausted |= gap.next_nack <= now;
+                continue;
+            }
+            if (gap.next_nack > now) {
+                continue;
+            }
+            if (!ranges.empty() && ranges.back().first + ranges.back().second == sequence) {
+                ++ranges.back().second;
+            } else if (ranges.size() < max_ranges) {
+                ranges.emplace_back(sequence, 1);
+            } else {
+                continue;
+            }
+            ++gap.attempts;
+            gap.next_nack = now + config_.nack_interval;
+        }
+
+        if (!ranges.empty()) {
+            packet.assign(HEADER_SIZE + ranges.size() * NACK_RANGE_SIZE, std::byte{0});
+            encode_header({PacketType::nack, 0, session, 0, ranges.size()}, packet.data());
+            for (size_t i = 0; i < ranges.size(); ++i) {
+                put_u64(packet.data() + HEADER_SIZE + i * NACK_RANGE_SIZE, ranges[i].first);
+                put_u32(packet.data() + HEADER_SIZE + i * NACK_RANGE_SIZE + 8, ranges[i].second);
+            }
+            socket_.send_to(packet, state.address, state.port);
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++stats_.nacks_sent;
+        }
+        if (exhausted) {
+            deliver(session, state);
+        }
+    }
+}
+
+std::chrono::milliseconds ReliableMulticastReceiver::next_timer(std::chrono::steady_clock::time_point now) const {
+    // Bounded so stop() is noticed promptly
+    auto wait = std::chrono::milliseconds(100);
+    for (const auto& [session, state] : senders_) {
+        for (const auto& [sequence, gap] : state.missing) {
+            if (gap.attempts >= config_.max_nack_attempts && gap.next_nack <= now) {
+                continue;       // Given up; waits for the gaps before it
+            }
+            auto until = std::chrono::duration_cast<std::chrono::milliseconds>(gap.next_nack - now);
+            wait = std::min(wait, std::max(until, std::chrono::milliseconds(0)));
+        }
+    }
+    return wait;
+}
+
+ReliableMulticastReceiverStats ReliableMulticastReceiver::get_stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+} // namespace multicast
+} // namespace network
+} // namespace dualstack
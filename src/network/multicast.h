@@ -0,0 +1,266 @@
+/**
+ * Amphisbaena 🐍 - Multicast Distribution
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * One send reaching every node that joined a group:
+ *   - MulticastSocket: dual-stack group membership (IGMP for IPv4, MLD for
+ *     IPv6) through the protocol-independent MCAST_* socket options, with
+ *     source-specific joins and per-interface selection
+ *   - ReliableMulticastSender / ReliableMulticastReceiver: sequenced
+ *     datagrams; receivers NACK gaps by unicast after a random backoff and
+ *     the sender repairs them by multicast from its retransmit window, so
+ *     one repair serves every receiver that missed the same packet.
+ *     Heartbeats expose tail loss and tell receivers what is still repairable.
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "../core/socket.h"
+#include "../core/ip_address.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef AMPHISBAENA_API
+#define AMPHISBAENA_API
+#endif
+
+namespace dualstack {
+namespace network {
+namespace multicast {
+
+/**
+ * @brief A group to join, optionally from a single source
+ */
+struct AMPHISBAENA_API MulticastGroup {
+    IPAddress group;
+    std::optional<IPAddress> source;        // Source-specific (232/8, ff3x::/32): only this sender is heard
+    uint32_t interface_index = 0;           // 0 lets the kernel pick by route
+};
+
+AMPHISBAENA_API bool is_multicast(const IPAddress& address);
+AMPHISBAENA_API bool is_source_specific(const IPAddress& address);
+// 0 when there is no such interface
+AMPHISBAENA_API uint32_t interface_index(std::string_view name);
+
+/**
+ * @brief Datagram socket with group membership
+ *
+ * The socket's family must match its groups: IPv4 groups need an IPv4
+ * socket and IPv6 groups an IPv6 one. Several sockets on one host may bind
+ * the same group port; each receives its own copy. Groups still joined are
+ * left on close().
+ */
+class AMPHISBAENA_API MulticastSocket {
+public:
+    MulticastSocket() = default;
+    ~MulticastSocket();
+
+    MulticastSocket(MulticastSocket&& other) noexcept = default;
+    MulticastSocket& operator=(MulticastSocket&& other) noexcept;
+    MulticastSocket(const MulticastSocket&) = delete;
+    MulticastSocket& operator=(const MulticastSocket&) = delete;
+
+    // Bind to `bind_addr` (the wildcard of either family to receive groups) and `port` (0 = ephemeral)
+    [[nodiscard]] error_code open(const IPAddress& bind_addr, port_t port);
+    void close();
+
+    [[nodiscard]] error_code join(const MulticastGroup& group);
+    [[nodiscard]] error_code leave(const MulticastGroup& group);
+
+    // Outgoing group traffic
+    [[nodiscard]] error_code set_send_interface(uint32_t interface_index);
+    [[nodiscard]] error_code set_loopback(bool enabled);     // Deliver our own sends to local members
+    [[nodiscard]] error_code set_hops(int hops);             // TTL / hop limit; 1 stays on the link
+
+    size_t send_to(std::span<const std::byte> data, const IPAddress& address, port_t port);
+    // One datagram, waiting up to `timeout`; 0 on timeout
+    size_t receive_from(std::span<std::byte> buffer, IPAddress& address, port_t& port,
+                        std::chrono::milliseconds timeout);
+
+    bool is_open() const { return socket_.is_open(); }
+    bool is_ipv6() const { return ipv6_; }
+    port_t local_port() const { return socket_.local_port(); }
+    const std::vector<MulticastGroup>& groups() const { return groups_; }
+    Socket& socket() { return socket_; }
+
+private:
+    error_code change_membership(const MulticastGroup& group, bool join);
+
+    Socket socket_;
+    bool ipv6_ = false;
+    std::vector<MulticastGroup> groups_;
+};
+
+/**
+ * @brief Reliable Multicast Configuration, shared by sender and receivers
+ */
+struct AMPHISBAENA_API ReliableMulticastConfig {
+    MulticastGroup group;
+    port_t port = 0;                                        // Group port receivers bind
+    uint32_t send_interface = 0;
+    int hops = 1;
+    bool loopback = true;                                   // Receivers on the sender's host hear it too
+
+    size_t max_payload = 1400;                              // Stay under the path MTU
+    size_t retransmit_window = 4096;                        // Packets the sender keeps for repair
+    std::chrono::milliseconds heartbeat_interval{100};
+    std::chrono::milliseconds nack_delay{10};               // Random backoff before a receiver NACKs
+    std::chrono::milliseconds nack_interval{50};            // Until it NACKs a still-open gap again
+    uint32_t max_nack_attempts = 10;                        // Then the gap is reported lost
+    size_t reorder_window = 4096;                           // Packets a receiver holds ahead of a gap
+
+    double simulated_loss = 0.0;                            // Receiver drops this fraction of data (testing)
+};
+
+/**
+ * @brief Sender Statistics
+ */
+struct AMPHISBAENA_API ReliableMulticastSenderStats {
+    uint64_t packets_sent = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t heartbeats_sent = 0;
+    uint64_t nacks_received = 0;
+    uint64_t retransmissions = 0;
+    uint64_t repairs_unavailable = 0;       // NACKed packets already out of the window
+};
+
+/**
+ * @brief Receiver Statistics
+ */
+struct AMPHISBAENA_API ReliableMulticastReceiverStats {
+    uint64_t packets_received = 0;
+    uint64_t delivered = 0;
+    uint64_t duplicates = 0;
+    uint64_t nacks_sent = 0;
+    uint64_t recovered = 0;                 // Gaps filled by a repair
+    uint64_t lost = 0;                      // Packets given up on
+    uint64_t dropped_simulated = 0;
+};
+
+/**
+ * @brief Sends sequenced datagrams to a group and repairs NACKed gaps
+ */
+class AMPHISBAENA_API ReliableMulticastSender {
+public:
+    explicit ReliableMulticastSender(ReliableMulticastConfig config);
+    ~ReliableMulticastSender();
+
+    ReliableMulticastSender(const ReliableMulticastSender&) = delete;
+    ReliableMulticastSender& operator=(const ReliableMulticastSender&) = delete;
+
+    bool start();
+    void stop();
+    bool is_running() const { return running_; }
+
+    // Sequence number sent, or nullopt when stopped or the payload exceeds max_payload
+    std::optional<uint64_t> send(std::span<const std::byte> payload);
+
+    uint64_t session_id() const { return session_; }
+    ReliableMulticastSenderStats get_stats() const;
+
+private:
+    struct Retained {
+        uint64_t sequence = 0;
+        std::vector<std::byte> packet;                      // Header and payload as sent
+        std::chrono::steady_clock::time_point last_sent;
+    };
+
+    void service_loop();
+    void handle_nack(std::span<const std::byte> datagram);
+    void send_heartbeat_locked();
+
+    ReliableMulticastConfig config_;
+    uint64_t session_;
+    MulticastSocket socket_;
+
+    mutable std::mutex mutex_;                              // Guards window_, next_sequence_ and sends
+    std::deque<Retained> window_;
+    uint64_t next_sequence_ = 0;
+    std::chrono::steady_clock::time_point last_send_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    ReliableMulticastSenderStats stats_;                    // Guarded by mutex_
+};
+
+/**
+ * @brief Receives a group's sequenced datagrams and delivers them in order
+ *
+ * Each sender session is tracked on its own; a receiver joining late starts
+ * from the first packet it sees. Handlers run on the receiver thread.
+ */
+class AMPHISBAENA_API ReliableMulticastReceiver {
+public:
+    using MessageHandler = std::function<void(uint64_t session, uint64_t sequence, std::span<const std::byte> payload)>;
+    using LossHandler = std::function<void(uint64_t session, uint64_t first, uint64_t count)>;
+
+    explicit ReliableMulticastReceiver(ReliableMulticastConfig config);
+    ~ReliableMulticastReceiver();
+
+    ReliableMulticastReceiver(const ReliableMulticastReceiver&) = delete;
+    ReliableMulticastReceiver& operator=(const ReliableMulticastReceiver&) = delete;
+
+    void set_message_handler(MessageHandler handler) { message_handler_ = std::move(handler); }
+    void set_loss_handler(LossHandler handler) { loss_handler_ = std::move(handler); }
+
+    bool start();
+    void stop();
+    bool is_running() const { return running_; }
+
+    ReliableMulticastReceiverStats get_stats() const;
+
+private:
+    struct Gap {
+        std::chrono::steady_clock::time_point next_nack;
+        uint32_t attempts = 0;
+    };
+
+    struct SenderState {
+        IPAddress address;
+        port_t port = 0;
+        uint64_t next_expected = 0;                         // Next sequence to deliver
+        uint64_t highest_seen = 0;                          // One past the highest sequence known to exist
+        uint64_t lowest_retained = 0;                       // Sender's oldest repairable packet
+        std::map<uint64_t, std::vector<std::byte>> pending; // Arrived ahead of a gap
+        std::map<uint64_t, Gap> missing;
+    };
+
+    void receive_loop();
+    void handle_packet(std::span<const std::byte> datagram, const IPAddress& from, port_t from_port);
+    void note_known(SenderState& state, uint64_t end, std::chrono::steady_clock::time_point now);
+    void deliver(uint64_t session, SenderState& state);
+    void service_gaps(std::chrono::steady_clock::time_point now);
+    std::chrono::milliseconds next_timer(std::chrono::steady_clock::time_point now) const;
+
+    ReliableMulticastConfig config_;
+    MulticastSocket socket_;
+    MessageHandler message_handler_;
+    LossHandler loss_handler_;
+
+    std::unordered_map<uint64_t, SenderState> senders_;     // Receiver thread only
+    uint64_t rng_state_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    mutable std::mutex stats_mutex_;
+    ReliableMulticastReceiverStats stats_;
+};
+
+} // namespace multicast
+} // namespace network
+} // namespace dualstack
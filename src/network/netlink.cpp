@@ -0,0 +1,587 @@
+/**
+ * Amphisbaena 🐍 - Host Interface State over Netlink Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "../../include/dualstack_net26/network/netlink.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace dualstack {
+namespace network {
+
+// ============================================================================
+// HostNetworkState Implementation
+// ============================================================================
+
+namespace {
+
+auto same_route(const RouteInfo& a, const RouteInfo& b) -> bool {
+    return a.table == b.table && a.destination == b.destination && a.prefix_length == b.prefix_length &&
+           a.priority == b.priority && a.interface_index == b.interface_index && a.gateway == b.gateway;
+}
+
+} // namespace
+
+auto HostNetworkState::apply(const NetlinkEvent& event) -> void {
+    switch (event.type) {
+        case NetlinkEventType::LINK_CHANGED:
+            links[event.link.index] = event.link;
+            break;
+        case NetlinkEventType::LINK_REMOVED:
+            // IPv4 routes through a removed link go without notification
+            links.erase(event.link.index);
+            std::erase_if(addresses, [&](const AddressInfo& a) { return a.interface_index == event.link.index; });
+            std::erase_if(routes, [&](const RouteInfo& r) { return r.interface_index == event.link.index; });
+            break;
+        case NetlinkEventType::ADDRESS_ADDED:
+        case NetlinkEventType::ADDRESS_REMOVED: {
+            const AddressInfo& changed = event.address;
+            std::erase_if(addresses, [&](const AddressInfo& a) {
+                return a.interface_index == changed.interface_index && a.address == changed.address &&
+                       a.prefix_length == changed.prefix_length;
+            });
+            if (event.type == NetlinkEventType::ADDRESS_ADDED) {
+                addresses.push_back(changed);
+            }
+            break;
+        }
+        case NetlinkEventType::ROUTE_ADDED:
+        case NetlinkEventType::ROUTE_REMOVED:
+            std::erase_if(routes, [&](const RouteInfo& r) { return same_route(r, event.route); });
+            if (event.type == NetlinkEventType::ROUTE_ADDED) {
+                routes.push_back(event.route);
+            }
+            break;
+        case NetlinkEventType::OVERRUN:
+            break;
+    }
+}
+
+auto HostNetworkState::find_link(const std::string& name) const -> const LinkInfo* {
+    for (const auto& [index, link] : links) {
+        if (link.name == name) {
+            return &link;
+        }
+    }
+    return nullptr;
+}
+
+auto HostNetworkState::to_network_interfaces() const -> std::vector<NetworkInterface> {
+    std::vector<NetworkInterface> interfaces;
+    interfaces.reserve(links.size());
+    std::map<int, std::size_t> position;
+
+    for (const auto& [index, link] : links) {
+        NetworkInterface iface{};
+        iface.name = link.name;
+        iface.description = link.name;
+        iface.type = AdapterType::REAL;
+#ifdef __linux__
+        iface.state = (link.flags & IFF_RUNNING) ? AdapterState::CONNECTED
+                    : (link.flags & IFF_UP) ? AdapterState::ENABLED : AdapterState::DISABLED;
+        iface.is_physical = !(link.flags & IFF_LOOPBACK) && link.kind.empty();
+#else
+        iface.state = AdapterState::ENABLED;
+        iface.is_physical = link.kind.empty();
+#endif
+        iface.mac_address = link.mac_address;
+        iface.driver_name = link.kind;
+        iface.bytes_sent = link.bytes_sent;
+        iface.bytes_received = link.bytes_received;
+        iface.packets_sent = link.packets_sent;
+        iface.packets_received = link.packets_received;
+        position[index] = interfaces.size();
+        interfaces.push_back(std::move(iface));
+    }
+
+    for (const auto& address : addresses) {
+        auto it = position.find(address.interface_index);
+        if (it == position.end()) {
+            continue;
+        }
+        if (address.address.is_ipv4()) {
+            interfaces[it->second].ipv4_addresses.push_back(address.address.get_ipv4());
+        } else {
+            interfaces[it->second].ipv6_addresses.push_back(address.address.get_ipv6());
+        }
+    }
+
+    // Lowest-metric default route of the main table, per interface and family
+    std::map<std::pair<int, bool>, std::uint32_t> best_metric;
+    for (const auto& route : routes) {
+        if (route.prefix_length != 0 || route.table != 254 || !route.gateway.has_value()) {
+            continue;
+        }
+        auto it = position.find(route.interface_index);
+        if (it == position.end()) {
+            continue;
+        }
+        bool ipv4 = route.gateway->is_ipv4();
+        auto key = std::make_pair(route.interface_index, ipv4);
+        auto best = best_metric.find(key);
+        if (best != best_metric.end() && best->second <= route.priority) {
+            continue;
+        }
+        best_metric[key] = route.priority;
+        if (ipv4) {
+            interfaces[it->second].ipv4_gateway = route.gateway->get_ipv4();
+        } else {
+            interfaces[it->second].ipv6_gateway = route.gateway->get_ipv6();
+        }
+    }
+    return interfaces;
+}
+
+#ifdef __linux__
+
+// ============================================================================
+// rtnetlink message parsing
+// ============================================================================
+
+namespace {
+
+constexpr std::size_t RECEIVE_BUFFER_SIZE = 64 * 1024;     // Large enough that dump batches are never truncated
+
+auto address_from(const rtattr* attr, int family) -> std::optional<IPAddress> {
+    const auto* bytes = static_cast<const unsigned char*>(RTA_DATA(attr));
+    if (family == AF_INET && RTA_PAYLOAD(attr) >= 4) {
+        std::uint32_t value = (std::uint32_t(bytes[0]) << 24) | (std::uint32_t(bytes[1]) << 16) |
+                              (std::uint32_t(bytes[2]) << 8) | std::uint32_t(bytes[3]);
+        return IPAddress(ipv4_address(value));
+    }
+    if (family == AF_INET6 && RTA_PAYLOAD(attr) >= 16) {
+        std::uint64_t high = 0;
+        std::uint64_t low = 0;
+        for (int i = 0; i < 8; ++i) {
+            high = (high << 8) | bytes[i];
+            low = (low << 8) | bytes[i + 8];
+        }
+        return IPAddress(ipv6_address(high, low));
+    }
+    return std::nullopt;
+}
+
+auto u32_from(const rtattr* attr) -> std::uint32_t {
+    std::uint32_t value = 0;
+    std::memcpy(&value, RTA_DATA(attr), std::min<std::size_t>(RTA_PAYLOAD(attr), sizeof(value)));
+    return value;
+}
+
+auto parse_link(const nlmsghdr* header, LinkInfo& link) -> bool {
+    if (header->nlmsg_len < NLMSG_LENGTH(sizeof(ifinfomsg))) {
+        return false;
+    }
+    const auto* info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+    link.index = info->ifi_index;
+    link.flags = info->ifi_flags;
+
+    int length = static_cast<int>(IFLA_PAYLOAD(header));
+    for (const rtattr* attr = IFLA_RTA(info); RTA_OK(attr, length); attr = RTA_NEXT(attr, length)) {
+        switch (attr->rta_type) {
+            case IFLA_IFNAME:
+                link.name.assign(static_cast<const char*>(RTA_DATA(attr)),
+                                 strnlen(static_cast<const char*>(RTA_DATA(attr)), RTA_PAYLOAD(attr)));
+                break;
+            case IFLA_MTU:
+                link.mtu = u32_from(attr);
+                break;
+            case IFLA_ADDRESS: {
+                const auto* bytes = static_cast<const unsigned char*>(RTA_DATA(attr));
+                std::stringstream mac_ss;
+                for (std::size_t i = 0; i < RTA_PAYLOAD(attr); ++i) {
+                    if (i > 0) mac_ss << ":";
+                    mac_ss << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(bytes[i]);
+                }
+                link.mac_address = mac_ss.str();
+                break;
+            }
+            case IFLA_STATS64:
+                if (RTA_PAYLOAD(attr) >= sizeof(rtnl_link_stats64)) {
+                    rtnl_link_stats64 stats;
+                    std::memcpy(&stats, RTA_DATA(attr), sizeof(stats));
+                    link.bytes_sent = stats.tx_bytes;
+                    link.bytes_received = stats.rx_bytes;
+                    link.packets_sent = stats.tx_packets;
+                    link.packets_received = stats.rx_packets;
+                }
+                break;
+            case IFLA_LINKINFO: {
+                int nested_length = static_cast<int>(RTA_PAYLOAD(attr));
+                for (const rtattr* nested = static_cast<const rtattr*>(RTA_DATA(attr)); RTA_OK(nested, nested_length);
+                     nested = RTA_NEXT(nested, nested_length)) {
+                    if (nested->rta_type == IFLA_INFO_KIND) {
+                        link.kind.assign(static_cast<const char*>(RTA_DATA(nested)),
+                                         strnlen(static_cast<const char*>(RTA_DATA(nested)), RTA_PAYLOAD(nested)));
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+auto parse_address(const nlmsghdr* header, AddressInfo& address) -> bool {
+    if (header->nlmsg_len < NLMSG_LENGTH(sizeof(ifaddrmsg))) {
+        return false;
+    }
+    const auto* info = static_cast<const ifaddrmsg*>(NLMSG_DATA(header));
+    address.interface_index = static_cast<int>(info->ifa_index);
+    address.prefix_length = info->ifa_prefixlen;
+    address.scope = info->ifa_scope;
+
+    // IFA_LOCAL is the local end of a point-to-point link; IFA_ADDRESS then names the peer
+    std::optional<IPAddress> local;
+    std::optional<IPAddress> peer;
+    int length = static_cast<int>(IFA_PAYLOAD(header));
+    for (const rtattr* attr = IFA_RTA(info); RTA_OK(attr, length); attr = RTA_NEXT(attr, length)) {
+        if (attr->rta_type == IFA_LOCAL) {
+            local = address_from(attr, info->ifa_family);
+        } else if (attr->rta_type == IFA_ADDRESS) {
+            peer = address_from(attr, info->ifa_family);
+        }
+    }
+    if (!local && !peer) {
+        return false;
+    }
+    address.address = local ? *local : *peer;
+    return true;
+}
+
+auto parse_routes(const nlmsghdr* header, std::vector<RouteInfo>& routes) -> void {
+    if (header->nlmsg_len < NLMSG_LENGTH(sizeof(rtmsg))) {
+        return;
+    }
+    const auto* info = static_cast<const rtmsg*>(NLMSG_DATA(header));
+    if (info->rtm_type != RTN_UNICAST || (info->rtm_family != AF_INET && info->rtm_family != AF_INET6)) {
+        return;     // Local, broadcast and multicast entries are not routes to follow
+    }
+
+    RouteInfo route;
+    route.destination = info->rtm_family == AF_INET ? IPAddress(ipv4_address(0)) : IPAddress(ipv6_address(0, 0));
+    route.prefix_length = info->rtm_dst_len;
+    route.table = info->rtm_table;
+    const rtattr* multipath = nullptr;
+
+    int length = static_cast<int>(RTM_PAYLOAD(header));
+    for (const rtattr* attr = RTM_RTA(info); RTA_OK(attr, length); attr = RTA_NEXT(attr, length)) {
+        switch (attr->rta_type) {
+            case RTA_DST:
+                if (auto destination = address_from(attr, info->rtm_family)) {
+                    route.destination = *destination;
+                }
+                break;
+            case RTA_GATEWAY:
+                route.gateway = address_from(attr, info->rtm_family);
+                break;
+            case RTA_OIF:
+                route.interface_index = static_cast<int>(u32_from(attr));
+                break;
+            case RTA_PRIORITY:
+                route.priority = u32_from(attr);
+                break;
+            case RTA_TABLE:
+                route.table = u32_from(attr);
+                break;
+            case RTA_MULTIPATH:
+                multipath = attr;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (!multipath) {
+        routes.push_back(route);
+        return;
+    }
+    int remaining = static_cast<int>(RTA_PAYLOAD(multipath));
+    for (const auto* hop = static_cast<const rtnexthop*>(RTA_DATA(multipath));
+         remaining >= static_cast<int>(sizeof(rtnexthop)) && hop->rtnh_len >= sizeof(rtnexthop) &&
+         static_cast<int>(hop->rtnh_len) <= remaining;
+         remaining -= RTNH_ALIGN(hop->rtnh_len), hop = RTNH_NEXT(hop)) {
+        RouteInfo path = route;
+        path.interface_index = hop->rtnh_ifindex;
+        path.gateway.reset();
+        int hop_length = static_cast<int>(hop->rtnh_len - sizeof(rtnexthop));
+        for (const rtattr* attr = RTNH_DATA(hop); RTA_OK(attr, hop_length); attr = RTA_NEXT(attr, hop_length)) {
+            if (attr->rta_type == RTA_GATEWAY) {
+                path.gateway = address_from(attr, info->rtm_family);
+            }
+        }
+        routes.push_back(path);
+    }
+}
+
+auto open_route_socket(std::uint32_t groups) -> std::expected<int, std::string> {
+    int fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | (groups ? SOCK_NONBLOCK : 0), NETLINK_ROUTE);
+    if (fd < 0) {
+        return std::unexpected(std::string("Netlink socket failed: ") + std::strerror(errno));
+    }
+    sockaddr_nl local{};
+    local.nl_family = AF_NETLINK;
+    local.nl_groups = groups;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+        std::string error = std::string("Netlink bind failed: ") + std::strerror(errno);
+        ::close(fd);
+        return std::unexpected(error);
+    }
+    return fd;
+}
+
+// Receive one datagram from the kernel; 0 when a non-blocking socket has nothing queued,
+// EMSGSIZE when it did not fit the buffer and its tail was discarded
+auto receive_from_kernel(int fd, std::vector<std::byte>& buffer) -> std::expected<std::size_t, int> {
+    while (true) {
+        sockaddr_nl sender{};
+        iovec iov{buffer.data(), buffer.size()};
+        msghdr message{};
+        message.msg_name = &sender;
+        message.msg_namelen = sizeof(sender);
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        ssize_t received = ::recvmsg(fd, &message, 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            return std::unexpected(errno);
+        }
+        if (sender.nl_pid != 0) {
+            continue;       // Only the kernel speaks on this socket
+        }
+        if (message.msg_flags & MSG_TRUNC) {
+            return std::unexpected(EMSGSIZE);
+        }
+        return static_cast<std::size_t>(received);
+    }
+}
+
+auto request_dump(int fd, std::uint16_t type, std::uint32_t sequence) -> bool {
+    struct {
+        nlmsghdr header;
+        union {
+            ifinfomsg link;
+            ifaddrmsg address;
+            rtmsg route;
+        } body;
+    } request{};
+    std::size_t body_size = type == RTM_GETLINK ? sizeof(ifinfomsg) : type == RTM_GETADDR ? sizeof(ifaddrmsg) : sizeof(rtmsg);
+    request.header.nlmsg_len = NLMSG_LENGTH(body_size);
+    request.header.nlmsg_type = type;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = sequence;
+    // AF_UNSPEC in the first byte of every body: all families
+
+    sockaddr_nl kernel{};
+    kernel.nl_family = AF_NETLINK;
+    return ::sendto(fd, &request, request.header.nlmsg_len, 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) >= 0;
+}
+
+} // namespace
+
+auto netlink_dump() -> std::expected<HostNetworkState, std::string> {
+    auto socket = open_route_socket(0);
+    if (!socket.has_value()) {
+        return std::unexpected(socket.error());
+    }
+    int fd = socket.value();
+    std::vector<std::byte> buffer(RECEIVE_BUFFER_SIZE);
+    HostNetworkState state;
+
+    // The kernel runs one dump per socket at a time, so the three follow each other
+    const std::uint16_t requests[] = {RTM_GETLINK, RTM_GETADDR, RTM_GETROUTE};
+    std::uint32_t sequence = 1;
+    for (std::uint16_t type : requests) {
+        if (!request_dump(fd, type, sequence)) {
+            std::string error = std::string("Netlink dump request failed: ") + std::strerror(errno);
+            ::close(fd);
+            return std::unexpected(error);
+        }
+        bool done = false;
+        while (!done) {
+            auto received = receive_from_kernel(fd, buffer);
+            if (!received.has_value()) {
+                ::close(fd);
+                return std::unexpected(std::string("Netlink dump failed: ") + std::strerror(received.error()));
+            }
+            auto length = static_cast<unsigned int>(received.value());
+            for (const auto* header = reinterpret_cast<const nlmsghdr*>(buffer.data()); NLMSG_OK(header, length);
+                 header = NLMSG_NEXT(header, length)) {
+                if (header->nlmsg_seq != sequence) {
+                    continue;
+                }
+                if (header->nlmsg_type == NLMSG_DONE) {
+                    done = true;
+                    break;
+                }
+                if (header->nlmsg_type == NLMSG_ERROR) {
+                    const auto* error = static_cast<const nlmsgerr*>(NLMSG_DATA(header));
+                    ::close(fd);
+                    return std::unexpected(std::string("Netlink dump refused: ") + std::strerror(-error->error));
+                }
+                if (header->nlmsg_type == RTM_NEWLINK) {
+                    LinkInfo link;
+                    if (parse_link(header, link)) {
+                        state.links[link.index] = std::move(link);
+                    }
+                } else if (header->nlmsg_type == RTM_NEWADDR) {
+                    AddressInfo address;
+                    if (parse_address(header, address)) {
+                        state.addresses.push_back(address);
+                    }
+                } else if (header->nlmsg_type == RTM_NEWROUTE) {
+                    parse_routes(header, state.routes);
+                }
+            }
+        }
+        ++sequence;
+    }
+    ::close(fd);
+    return state;
+}
+
+// ============================================================================
+// NetlinkMonitor Implementation
+// ============================================================================
+
+NetlinkMonitor::~NetlinkMonitor() {
+    close();
+}
+
+auto NetlinkMonitor::open() -> std::expected<void, std::string> {
+    if (is_open()) {
+        return {};
+    }
+    auto socket = open_route_socket(RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR |
+                                    RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE);
+    if (!socket.has_value()) {
+        return std::unexpected(socket.error());
+    }
+    fd_ = socket.value();
+
+    // Room for a burst of changes (an interface flapping with many addresses) between loop turns
+    int receive_buffer = 1 << 20;
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));
+    buffer_.resize(RECEIVE_BUFFER_SIZE);
+    return {};
+}
+
+auto NetlinkMonitor::close() -> void {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+auto NetlinkMonitor::process(const std::function<void(const NetlinkEvent&)>& handler)
+    -> std::expected<std::size_t, std::string> {
+    if (!is_open()) {
+        return std::unexpected(std::string("Netlink monitor not open"));
+    }
+    std::size_t delivered = 0;
+    std::vector<RouteInfo> routes;
+    while (true) {
+        auto received = receive_from_kernel(fd_, buffer_);
+        if (!received.has_value()) {
+            // Either way events were lost: the kernel's queue overflowed, or a batch was cut short
+            if (received.error() == ENOBUFS || received.error() == EMSGSIZE) {
+                NetlinkEvent event{};
+                event.type = NetlinkEventType::OVERRUN;
+                handler(event);
+                ++delivered;
+                continue;
+            }
+            return std::unexpected(std::string("Netlink receive failed: ") + std::strerror(received.error()));
+        }
+        if (received.value() == 0) {
+            return delivered;
+        }
+
+        auto length = static_cast<unsigned int>(received.value());
+        for (const auto* header = reinterpret_cast<const nlmsghdr*>(buffer_.data()); NLMSG_OK(header, length);
+             header = NLMSG_NEXT(header, length)) {
+            NetlinkEvent event{};
+            switch (header->nlmsg_type) {
+                case RTM_NEWLINK:
+                case RTM_DELLINK:
+                    if (!parse_link(header, event.link)) {
+                        continue;
+                    }
+                    event.type = header->nlmsg_type == RTM_NEWLINK ? NetlinkEventType::LINK_CHANGED
+                                                                   : NetlinkEventType::LINK_REMOVED;
+                    handler(event);
+                    ++delivered;
+                    break;
+                case RTM_NEWADDR:
+                case RTM_DELADDR:
+                    if (!parse_address(header, event.address)) {
+                        continue;
+                    }
+                    event.type = header->nlmsg_type == RTM_NEWADDR ? NetlinkEventType::ADDRESS_ADDED
+                                                                   : NetlinkEventType::ADDRESS_REMOVED;
+                    handler(event);
+                    ++delivered;
+                    break;
+                case RTM_NEWROUTE:
+                case RTM_DELROUTE:
+                    routes.clear();
+                    parse_routes(header, routes);
+                    event.type = header->nlmsg_type == RTM_NEWROUTE ? NetlinkEventType::ROUTE_ADDED
+                                                                    : NetlinkEventType::ROUTE_REMOVED;
+                    for (const auto& route : routes) {
+                        event.route = route;
+                        handler(event);
+                        ++delivered;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+#else
+
+auto netlink_dump() -> std::expected<HostNetworkState, std::string> {
+    return std::unexpected(std::string("Netlink is only available on Linux"));
+}
+
+NetlinkMonitor::~NetlinkMonitor() = default;
+
+auto NetlinkMonitor::open() -> std::expected<void, std::string> {
+    return std::unexpected(std::string("Netlink is only available on Linux"));
+}
+
+auto NetlinkMonitor::close() -> void {}
+
+auto NetlinkMonitor::process(const std::function<void(const NetlinkEvent&)>& handler [[maybe_unused]])
+    -> std::expected<std::size_t, std::string> {
+    return std::unexpected(std::string("Netlink monitor not open"));
+}
+
+#endif
+
+} // namespace network
+} // namespace dualstack
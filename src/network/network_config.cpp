@@ -17,12 +17,14 @@
 #include <algorithm>
 #include <iomanip>
 #include <fstream>
+#include <iterator>
 #include <cstring>
 #include <regex>
 #include <mutex>
 #include <functional>
 #include "../../include/dualstack_net26/network/network_config.h"
 #include "../core/ip_address.h"
+#include "../reflect/serializer.h"
 
 using ::make_unexpected_value;
 
@@ -567,24 +569,64 @@ void NetworkConfigEditor::clear() {
     current_profile_ = std::make_unique<NetworkProfile>("default");
 }
 
-bool NetworkConfigEditor::load_from_file(const std::string& filepath [[maybe_unused]]) {
-    // TODO: Implement file loading
-    return false;
+bool NetworkConfigEditor::load_from_file(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return import_from_json(json);
 }
 
-bool NetworkConfigEditor::save_to_file(const std::string& filepath [[maybe_unused]]) const {
-    // TODO: Implement file saving
-    return false;
+bool NetworkConfigEditor::save_to_file(const std::string& filepath) const {
+    std::string json = export_to_json();
+    
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return static_cast<bool>(file);
 }
 
 std::string NetworkConfigEditor::export_to_json() const {
-    // TODO: Implement JSON export
-    return "{}";
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    
+    if (!current_profile_) {
+        return "{}";
+    }
+    
+    // Member names and order come from NetworkProfile::reflect
+    return reflect::to_json(*current_profile_);
 }
 
-bool NetworkConfigEditor::import_from_json(const std::string& json [[maybe_unused]]) {
-    // TODO: Implement JSON import
-    return false;
+bool NetworkConfigEditor::import_from_json(const std::string& json) {
+    NetworkProfile profile;
+    if (!reflect::from_json(json, profile)) {
+        return false;
+    }
+    
+    for (const auto& subnet : profile.subnets) {
+        if (!validate_subnet(subnet)) {
+            return false;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    current_profile_ = std::make_unique<NetworkProfile>(std::move(profile));
+    
+    // Rebuild subnet indexes
+    subnets_by_cidr_.clear();
+    subnets_by_type_.clear();
+    
+    for (const auto& subnet : current_profile_->subnets) {
+        subnets_by_cidr_.emplace(subnet.to_cidr(), subnet);
+    }
+    
+    update_subnet_indexes();
+    return true;
 }
 
 size_t NetworkConfigEditor::get_subnet_count(NetworkType type) const {
@@ -0,0 +1,222 @@
+/**
+ * Amphisbaena 🐍 - Notification Aggregator Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * PUBLIC LIBRARY IMPLEMENTATION
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "../../include/dualstack_net26/network/notification_aggregator.h"
+#include <algorithm>
+
+namespace dualstack {
+namespace network {
+namespace notifications {
+
+NotificationAggregator::NotificationAggregator(AggregationConfig config)
+    : config_(std::move(config))
+    , next_sweep_(clock::now() + config_.window)
+{
+}
+
+std::string NotificationAggregator::make_key(const Notification& notification) {
+    // Unit separator keeps ("ab","c") and ("a","bc") distinct
+    std::string key;
+    key.reserve(notification.source_id.size() + notification.source_component.size() +
+                notification.error_code.size() + 4);
+    key.append(notification.source_id).push_back('\x1f');
+    key.append(notification.source_component).push_back('\x1f');
+    key.append(notification.error_code).push_back('\x1f');
+    key.push_back(static_cast<char>(notification.severity));
+    if (notification.error_code.empty()) {
+        // Without an error code only identical notifications may share a window
+        key.push_back('\x1f');
+        key.append(notification.title).push_back('\x1f');
+        key.append(notification.message);
+    }
+    return key;
+}
+
+const RateLimit& NotificationAggregator::limit_for(Category category) const {
+    auto it = config_.category_limits.find(category);
+    return it != config_.category_limits.end() ? it->second : config_.default_limit;
+}
+
+bool NotificationAggregator::try_consume(Category category, clock::time_point now) {
+    const RateLimit& limit = limit_for(category);
+    if (limit.is_unlimited()) {
+        return true;
+    }
+    auto [it, inserted] = buckets_.try_emplace(static_cast<uint16_t>(category),
+                                               TokenBucket{limit.burst, now});
+    TokenBucket& bucket = it->second;
+
+    if (!inserted && now > bucket.last_refill) {
+        double elapsed = std::chrono::duration<double>(now - bucket.last_refill).count();
+        bucket.tokens = std::min(limit.burst, bucket.tokens + elapsed * limit.tokens_per_second);
+        bucket.last_refill = now;
+    }
+
+    if (bucket.tokens < 1.0) {
+        return false;
+    }
+    bucket.tokens -= 1.0;
+    return true;
+}
+
+bool NotificationAggregator::admit(const Notification& notification, clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return true;
+    }
+
+    std::string key = make_key(notification);
+    bool coalesce = !notification.error_code.empty();
+    auto it = windows_.find(key);
+
+    if (coalesce && it != windows_.end()) {
+        Window& window = it->second;
+        // A window with pending repeats keeps counting until the sweep reports it
+        if (now - window.window_start < config_.window || window.suppressed > 0) {
+            ++window.suppressed;
+            window.last_seen = now;
+            ++suppressed_count_;
+            return false;
+        }
+    }
+
+    bool exempt = config_.exempt_critical && notification.severity == Severity::CRITICAL;
+    if (!exempt && !try_consume(notification.category, now)) {
+        ++rate_limited_count_;
+        ++suppressed_count_;
+        if (it == windows_.end()) {
+            if (windows_.size() >= config_.max_tracked_keys) {
+                return false;
+            }
+            it = windows_.emplace(key, Window{notification, now, now}).first;
+        }
+        ++it->second.suppressed;
+        ++it->second.rate_limited;
+        it->second.last_seen = now;
+        return false;
+    }
+
+    if (coalesce) {
+        if (it != windows_.end()) {
+            it->second = Window{notification, now, now};
+        } else if (windows_.size() < config_.max_tracked_keys) {
+            windows_.emplace(std::move(key), Window{notification, now, now});
+        }
+    }
+
+    return true;
+}
+
+Notification NotificationAggregator::make_summary(const Window& window, clock::time_point now) {
+    Notification summary;
+    std::string summary_id = std::move(summary.notification_id);
+    summary = window.first;
+    summary.notification_id = std::move(summary_id);
+    summary.timestamp = std::chrono::system_clock::now();
+
+    auto window_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - window.window_start).count();
+    // Coalesced occurrences share source, component, code and severity, not
+    // necessarily the message, so the summary only claims what the key matched
+    std::string noun = window.suppressed == 1 ? "notification" : "notifications";
+    std::string matched = window.first.error_code.empty() ? "identical " + noun
+                                                          : noun + " with error code " + window.first.error_code;
+    summary.message = window.first.message + " (" + std::to_string(window.suppressed) + " more " + matched +
+                      " suppressed in " + std::to_string(window_ms) + "ms)";
+    summary.metadata["aggregated"] = "true";
+    summary.metadata["occurrence_count"] = std::to_string(window.suppressed);
+    summary.metadata["rate_limited_count"] = std::to_string(window.rate_limited);
+    summary.metadata["window_ms"] = std::to_string(window_ms);
+    summary.metadata["first_notification_id"] = window.first.notification_id;
+    return summary;
+}
+
+std::vector<Notification> NotificationAggregator::sweep(clock::time_point now, bool force) {
+    std::vector<Notification> summaries;
+    if (!force && now < next_sweep_) {
+        return summaries;
+    }
+
+    clock::time_point next = now + config_.window;
+    for (auto it = windows_.begin(); it != windows_.end();) {
+        Window& window = it->second;
+        clock::time_point closes_at = window.window_start + config_.window;
+
+        if (!force && now < closes_at) {
+            next = std::min(next, closes_at);
+            ++it;
+            continue;
+        }
+
+        if (window.suppressed == 0) {
+            it = windows_.erase(it);
+            continue;
+        }
+
+        summaries.push_back(make_summary(window, now));
+        if (force) {
+            it = windows_.erase(it);
+            continue;
+        }
+
+        // Storm still running: keep the key and open a fresh window
+        window.window_start = now;
+        window.suppressed = 0;
+        window.rate_limited = 0;
+        ++it;
+    }
+
+    next_sweep_ = next;
+    return summaries;
+}
+
+std::vector<Notification> NotificationAggregator::collect_summaries(clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sweep(now, false);
+}
+
+std::vector<Notification> NotificationAggregator::drain(clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sweep(now, true);
+}
+
+void NotificationAggregator::set_config(const AggregationConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    buckets_.clear();  // New limits take effect with full buckets
+    next_sweep_ = clock::time_point::min();
+}
+
+AggregationConfig NotificationAggregator::get_config() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+bool NotificationAggregator::is_enabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_.enabled;
+}
+
+size_t NotificationAggregator::get_suppressed_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return suppressed_count_;
+}
+
+size_t NotificationAggregator::get_rate_limited_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rate_limited_count_;
+}
+
+size_t NotificationAggregator::get_tracked_key_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return windows_.size();
+}
+
+} // namespace notifications
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,140 @@
+/**
+ * Amphisbaena 🐍 - Notification Dispatch Ring Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * PUBLIC LIBRARY IMPLEMENTATION
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "../../include/dualstack_net26/network/notification_ring.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+
+namespace dualstack {
+namespace network {
+namespace notifications {
+
+namespace {
+
+// Copy up to capacity-1 bytes and NUL-terminate; returns true if the source was cut
+template<typename Length>
+bool copy_bounded(char* slot, size_t capacity, const char* source, Length& length) {
+    size_t n = source ? strnlen(source, capacity) : 0;
+    bool truncated = n == capacity;
+    if (truncated) {
+        --n;
+    }
+    std::memcpy(slot, source ? source : "", n);
+    slot[n] = '\0';
+    length = static_cast<Length>(n);
+    return truncated;
+}
+
+} // anonymous namespace
+
+NotificationRing::NotificationRing(size_t capacity)
+    : slots_(std::make_unique<Slot[]>(std::bit_ceil(std::max<size_t>(capacity, 2))))
+    , mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+{
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+NotificationRecord* NotificationRing::try_acquire() {
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Slot& slot = slots_[pos & mask_];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence - pos);
+
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return &slot.record;
+            }
+        } else if (diff < 0) {
+            return nullptr;  // Full: the consumer has not released this slot yet
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void NotificationRing::publish(NotificationRecord* record) {
+    auto* slot = reinterpret_cast<Slot*>(reinterpret_cast<char*>(record) - offsetof(Slot, record));
+    // The claiming producer is the only writer until this store
+    uint64_t claimed = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(claimed + 1, std::memory_order_release);
+}
+
+bool NotificationRing::try_push(const char* source_id, const char* source_component, uint16_t category,
+                                uint8_t severity, const char* title, const char* message) {
+    NotificationRecord* record = try_acquire();
+    if (!record) {
+        return false;
+    }
+    fill(*record, source_id, source_component, category, severity, title, message);
+    publish(record);
+    return true;
+}
+
+bool NotificationRing::empty() const {
+    uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    return slots_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+}
+
+void NotificationRing::fill(NotificationRecord& record, const char* source_id, const char* source_component,
+                            uint16_t category, uint8_t severity, const char* title, const char* message) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    record.timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    record.category = category;
+    record.severity = severity;
+    record.truncated = 0;
+
+    if (copy_bounded(record.source_id, sizeof(record.source_id), source_id ? source_id : "unknown",
+                     record.source_id_length)) {
+        record.truncated |= NOTIFICATION_TRUNCATED_SOURCE_ID;
+    }
+    if (copy_bounded(record.source_component, sizeof(record.source_component),
+                     source_component ? source_component : "unknown", record.source_component_length)) {
+        record.truncated |= NOTIFICATION_TRUNCATED_COMPONENT;
+    }
+    if (copy_bounded(record.title, sizeof(record.title), title, record.title_length)) {
+        record.truncated |= NOTIFICATION_TRUNCATED_TITLE;
+    }
+    if (copy_bounded(record.message, sizeof(record.message), message, record.message_length)) {
+        record.truncated |= NOTIFICATION_TRUNCATED_MESSAGE;
+    }
+}
+
+Notification NotificationRing::to_notification(const NotificationRecord& record) {
+    // Lengths are clamped so a caller-filled record cannot read past its slot
+    auto bounded = [](const char* slot, size_t length, size_t capacity) {
+        return std::string(slot, std::min(length, capacity - 1));
+    };
+
+    Notification notification;
+    notification.source_id = bounded(record.source_id, record.source_id_length, sizeof(record.source_id));
+    notification.source_component = bounded(record.source_component, record.source_component_length,
+                                            sizeof(record.source_component));
+    notification.category = static_cast<Category>(record.category);
+    notification.severity = static_cast<Severity>(record.severity);
+    notification.title = bounded(record.title, record.title_length, sizeof(record.title));
+    notification.message = bounded(record.message, record.message_length, sizeof(record.message));
+    notification.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(record.timestamp_ns)));
+
+    if (record.truncated) {
+        notification.metadata["truncated"] = "true";
+    }
+    return notification;
+}
+
+} // namespace notifications
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,1025 @@
+/**
+ * Amphisbaena 🐍 - Notification Server Transport Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * PUBLIC LIBRARY IMPLEMENTATION
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "../../include/dualstack_net26/network/notification_transport.h"
+#include "async_connection_manager.h"
+#include "event_poller.h"
+#include "../reflect/serializer.h"
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <io.h>
+#include <share.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <process.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace dualstack {
+namespace network {
+namespace notifications {
+
+// ============================================================================
+// Wire Encoding
+// ============================================================================
+
+namespace wire {
+
+namespace {
+
+void put_u8(std::vector<std::byte>& out, uint8_t value) {
+    out.push_back(static_cast<std::byte>(value));
+}
+
+void put_le(std::vector<std::byte>& out, uint64_t value, size_t width) {
+    for (size_t i = 0; i < width; ++i) {
+        out.push_back(static_cast<std::byte>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+void put_varint(std::vector<std::byte>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::byte>(value));
+}
+
+// Bounds-checked reader over a record; any overrun marks the reader failed
+struct Reader {
+    std::span<const std::byte> data;
+    size_t pos = 0;
+    bool ok = true;
+
+    uint64_t le(size_t width) {
+        if (!ok || data.size() - pos < width) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < width; ++i) {
+            value |= static_cast<uint64_t>(data[pos + i]) << (i * 8);
+        }
+        pos += width;
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!ok || pos >= data.size()) {
+                ok = false;
+                return 0;
+            }
+            auto byte = static_cast<uint8_t>(data[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+} // namespace
+
+// Record layout is Notification's reflected member order
+void encode_notification(const Notification& notification, std::vector<std::byte>& out) {
+    reflect::to_binary(notification, out);
+}
+
+std::optional<Notification> decode_notification(std::span<const std::byte> record) {
+    Notification notification;
+    if (!reflect::from_binary(record, notification)) {
+        return std::nullopt;
+    }
+    return notification;
+}
+
+void begin_batch(std::vector<std::byte>& out) {
+    out.clear();
+    put_le(out, BATCH_MAGIC, 4);
+    put_u8(out, BATCH_VERSION);
+    put_u8(out, 0);
+    put_le(out, 0, 2);  // Count patched by finish_batch
+}
+
+void append_record(std::vector<std::byte>& batch, std::span<const std::byte> record) {
+    put_varint(batch, record.size());
+    batch.insert(batch.end(), record.begin(), record.end());
+}
+
+void finish_batch(std::vector<std::byte>& batch, uint16_t count) {
+    batch[6] = static_cast<std::byte>(count & 0xFF);
+    batch[7] = static_cast<std::byte>(count >> 8);
+}
+
+std::optional<std::vector<Notification>> decode_batch(std::span<const std::byte> payload) {
+    Reader in{payload};
+    if (in.le(4) != BATCH_MAGIC || in.le(1) != BATCH_VERSION) {
+        return std::nullopt;
+    }
+    in.le(1);
+    auto count = static_cast<uint16_t>(in.le(2));
+
+    std::vector<Notification> notifications;
+    notifications.reserve(count);
+    for (uint16_t i = 0; i < count; ++i) {
+        uint64_t length = in.varint();
+        if (!in.ok || payload.size() - in.pos < length) {
+            return std::nullopt;
+        }
+        auto decoded = decode_notification(payload.subspan(in.pos, length));
+        if (!decoded) {
+            return std::nullopt;
+        }
+        notifications.push_back(std::move(*decoded));
+        in.pos += length;
+    }
+
+    if (in.pos != payload.size()) {
+        return std::nullopt;
+    }
+    return notifications;
+}
+
+} // namespace wire
+
+// ============================================================================
+// NotificationTransport Implementation
+// ============================================================================
+
+namespace {
+
+std::optional<IPAddress> resolve_host(const std::string& host) {
+    auto parsed = IPAddress::from_string(host);
+    if (parsed.has_value()) {
+        return parsed.value();
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    if (::getaddrinfo(host.c_str(), nullptr, &hints, &results) != 0 || !results) {
+        return std::nullopt;
+    }
+
+    std::optional<IPAddress> resolved;
+    if (results->ai_family == AF_INET) {
+        const auto* addr4 = reinterpret_cast<const sockaddr_in*>(results->ai_addr);
+        resolved = IPAddress(ipv4_address(ntohl(addr4->sin_addr.s_addr)));
+    } else if (results->ai_family == AF_INET6) {
+        const auto* addr6 = reinterpret_cast<const sockaddr_in6*>(results->ai_addr);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&addr6->sin6_addr);
+        uint64_t high = 0;
+        uint64_t low = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            high |= static_cast<uint64_t>(bytes[i]) << (56 - i * 8);
+            low |= static_cast<uint64_t>(bytes[8 + i]) << (56 - i * 8);
+        }
+        resolved = IPAddress(ipv6_address(high, low));
+    }
+    ::freeaddrinfo(results);
+    return resolved;
+}
+
+// Wait until the socket can take more data or the deadline passes; false on timeout or error
+bool wait_writable(Socket& socket, std::chrono::steady_clock::time_point deadline) {
+    for (;;) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
+#ifdef _WIN32
+        WSAPOLLFD pfd{};
+        pfd.fd = static_cast<SOCKET>(socket.get_native_handle());
+        pfd.events = POLLWRNORM;
+        int result = WSAPoll(&pfd, 1, static_cast<INT>(remaining.count()));
+#else
+        pollfd pfd{};
+        pfd.fd = socket.get_native_handle();
+        pfd.events = POLLOUT;
+        int result = ::poll(&pfd, 1, static_cast<int>(remaining.count()));
+#endif
+        if (result < 0 && last_error_interrupted()) {
+            continue;
+        }
+        return result > 0;
+    }
+}
+
+// The connection socket is non-blocking: a server that stops reading costs at
+// most the deadline, never a worker (and stop()) stuck in send()
+bool send_all(Socket& socket, const std::vector<std::byte>& data, std::chrono::steady_clock::time_point deadline) {
+#ifdef MSG_NOSIGNAL
+    constexpr int send_flags = MSG_NOSIGNAL;
+#else
+    constexpr int send_flags = 0;
+#endif
+    size_t offset = 0;
+    while (offset < data.size()) {
+#ifdef _WIN32
+        int sent = ::send(static_cast<SOCKET>(socket.get_native_handle()),
+                          reinterpret_cast<const char*>(data.data() + offset),
+                          static_cast<int>(data.size() - offset), send_flags);
+#else
+        ssize_t sent = ::send(socket.get_native_handle(), data.data() + offset, data.size() - offset, send_flags);
+#endif
+        if (sent > 0) {
+            offset += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && last_error_interrupted()) {
+            continue;
+        }
+        if (sent < 0 && last_error_would_block() && wait_writable(socket, deadline)) {
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+// Wait up to timeout for the socket to become readable; -1 on error/hangup
+int wait_readable(Socket& socket, std::chrono::milliseconds timeout) {
+#ifdef _WIN32
+    WSAPOLLFD pfd{};
+    pfd.fd = static_cast<SOCKET>(socket.get_native_handle());
+    pfd.events = POLLRDNORM;
+    int result = WSAPoll(&pfd, 1, static_cast<INT>(timeout.count()));
+#else
+    pollfd pfd{};
+    pfd.fd = socket.get_native_handle();
+    pfd.events = POLLIN;
+    int result = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+#endif
+    if (result < 0) {
+        return -1;
+    }
+    return result;
+}
+
+// Non-blocking connect; completion is polled with connect_finished()
+std::optional<Socket> start_connect(const IPAddress& address, uint16_t port) {
+    auto handle = ::socket(address.is_ipv4() ? AF_INET : AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == static_cast<decltype(handle)>(-1)) {
+        return std::nullopt;
+    }
+    Socket socket(static_cast<native_socket_handle>(handle), true);
+    if (socket.set_non_blocking(true) != error_code::success) {
+        return std::nullopt;
+    }
+    sockaddr_storage storage;
+    socklen_t length;
+    ip_to_sockaddr(address, port, storage, length);
+    if (::connect(handle, reinterpret_cast<const sockaddr*>(&storage), length) != 0) {
+#ifdef _WIN32
+        bool in_progress = WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+        bool in_progress = errno == EINPROGRESS;
+#endif
+        if (!in_progress) {
+            return std::nullopt;
+        }
+    }
+    return socket;
+}
+
+// 1 when the connect completed, 0 while still pending, -1 if it failed
+int connect_finished(Socket& socket) {
+#ifdef _WIN32
+    WSAPOLLFD pfd{};
+    pfd.fd = static_cast<SOCKET>(socket.get_native_handle());
+    pfd.events = POLLWRNORM;
+    int result = WSAPoll(&pfd, 1, 0);
+#else
+    pollfd pfd{};
+    pfd.fd = socket.get_native_handle();
+    pfd.events = POLLOUT;
+    int result = ::poll(&pfd, 1, 0);
+#endif
+    if (result == 0) {
+        return 0;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (result < 0 || ::getsockopt(socket.get_native_handle(), SOL_SOCKET, SO_ERROR,
+                                   reinterpret_cast<char*>(&error), &length) != 0 || error != 0) {
+        return -1;
+    }
+    return 1;
+}
+
+// Spill file I/O at explicit offsets, so reads and appends share one descriptor
+#ifdef _WIN32
+constexpr int SPILL_NOFOLLOW = 0;       // Windows has no symlink-following open to refuse
+
+int open_spill_file(const std::string& path, bool exclusive) {
+    int fd = -1;
+    int flags = _O_RDWR | _O_CREAT | _O_BINARY | _O_NOINHERIT | (exclusive ? _O_EXCL : 0);
+    return ::_sopen_s(&fd, path.c_str(), flags, _SH_DENYWR, _S_IREAD | _S_IWRITE) == 0 ? fd : -1;
+}
+
+bool write_at(int fd, uint64_t offset, const void* data, size_t size) {
+    return ::_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) >= 0 &&
+           ::_write(fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+}
+
+bool read_at(int fd, uint64_t offset, void* data, size_t size) {
+    return ::_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) >= 0 &&
+           ::_read(fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+}
+
+bool truncate_to(int fd, uint64_t size) {
+    return ::_chsize_s(fd, static_cast<__int64>(size)) == 0;
+}
+
+void close_file(int fd) {
+    ::_close(fd);
+}
+
+unsigned long process_id() {
+    return static_cast<unsigned long>(::_getpid());
+}
+#else
+constexpr int SPILL_NOFOLLOW = O_NOFOLLOW;
+
+int open_spill_file(const std::string& path, bool exclusive) {
+    int flags = O_RDWR | O_CREAT | O_CLOEXEC | SPILL_NOFOLLOW | (exclusive ? O_EXCL : 0);
+    return ::open(path.c_str(), flags, 0600);
+}
+
+bool write_at(int fd, uint64_t offset, const void* data, size_t size) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        offset += static_cast<uint64_t>(written);
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool read_at(int fd, uint64_t offset, void* data, size_t size) {
+    auto* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = ::pread(fd, bytes, size, static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        offset += static_cast<uint64_t>(got);
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+bool truncate_to(int fd, uint64_t size) {
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+}
+
+void close_file(int fd) {
+    ::close(fd);
+}
+
+unsigned long process_id() {
+    return static_cast<unsigned long>(::getpid());
+}
+#endif
+
+constexpr size_t SPILL_PREFIX_SIZE = 6;     // u32 payload length, u16 notification count
+
+void encode_spill_prefix(uint8_t (&prefix)[SPILL_PREFIX_SIZE], const std::vector<std::byte>& payload, uint16_t count) {
+    auto length = static_cast<uint32_t>(payload.size());
+    for (size_t i = 0; i < 4; ++i) {
+        prefix[i] = static_cast<uint8_t>((length >> (i * 8)) & 0xFF);
+    }
+    prefix[4] = static_cast<uint8_t>(count & 0xFF);
+    prefix[5] = static_cast<uint8_t>(count >> 8);
+}
+
+} // namespace
+
+NotificationTransport::NotificationTransport(NotificationTransportConfig config)
+    : config_(std::move(config))
+    , backoff_(config_.reconnect_initial)
+{
+    spill_owned_ = config_.spill_path.empty();
+    config_.max_batch_notifications = std::clamp<size_t>(config_.max_batch_notifications, 1, UINT16_MAX);
+    config_.max_in_flight_batches = std::max<size_t>(config_.max_in_flight_batches, 1);
+}
+
+NotificationTransport::~NotificationTransport() {
+    stop();
+}
+
+bool NotificationTransport::start() {
+    if (running_) {
+        return true;
+    }
+    if (config_.host.empty() || config_.port == 0) {
+        return false;
+    }
+
+    connection_manager_ = std::make_unique<AsyncConnectionManager>();
+    if (!connection_manager_->initialize()) {
+        connection_manager_.reset();
+        return false;
+    }
+
+    if (!open_spill()) {
+        std::cerr << "❌ Cannot open notification spill file " << config_.spill_path
+                  << ", batches will be dropped while the server is unreachable" << std::endl;
+    }
+    next_connect_attempt_ = std::chrono::steady_clock::now();
+    backoff_ = config_.reconnect_initial;
+
+    running_ = true;
+    worker_ = std::thread(&NotificationTransport::worker_loop, this);
+    return true;
+}
+
+void NotificationTransport::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    queue_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    close_spill();
+    connection_manager_.reset();
+}
+
+bool NotificationTransport::enqueue(const Notification& notification) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+
+    if (ready_.size() >= config_.max_total_memory_batches) {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        if (stats_.dropped++ % 1000 == 0) {
+            std::cerr << "❌ Notification transport queue full, dropping notifications (total dropped: "
+                      << stats_.dropped << ")" << std::endl;
+        }
+        return false;
+    }
+
+    if (open_count_ == 0) {
+        wire::begin_batch(open_batch_);
+        open_since_ = std::chrono::steady_clock::now();
+    }
+
+    std::vector<std::byte> record;
+    wire::encode_notification(notification, record);
+    wire::append_record(open_batch_, record);
+    ++open_count_;
+
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        ++stats_.enqueued;
+    }
+
+    if (open_count_ >= config_.max_batch_notifications || open_batch_.size() >= config_.max_batch_bytes) {
+        seal_open_batch_locked();
+        queue_cv_.notify_one();
+    }
+    return true;
+}
+
+void NotificationTransport::flush() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        seal_open_batch_locked();
+    }
+    queue_cv_.notify_one();
+}
+
+void NotificationTransport::seal_open_batch_locked() {
+    if (open_count_ == 0) {
+        return;
+    }
+
+    wire::finish_batch(open_batch_, open_count_);
+    Batch batch;
+    batch.count = open_count_;
+    batch.payload = std::move(open_batch_);
+    ready_.push_back(std::move(batch));
+
+    open_batch_ = {};
+    open_count_ = 0;
+}
+
+NotificationTransportStats NotificationTransport::get_stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+size_t NotificationTransport::get_pending_batch_count() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return ready_.size() + (open_count_ > 0 ? 1 : 0);
+}
+
+void NotificationTransport::worker_loop() {
+    while (true) {
+        bool stopping = false;
+        std::deque<Batch> incoming;
+        bool connected = !connection_id_.empty();
+        bool window_full = connected && in_flight_.size() >= config_.max_in_flight_batches;
+
+        if (window_full) {
+            // Nothing can be sent until the server acknowledges; wait on the socket instead
+            process_acks(config_.flush_interval);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            if (!window_full) {
+                auto timeout = connected ? config_.flush_interval
+                                         : std::min(config_.flush_interval, backoff_);
+                queue_cv_.wait_for(lock, timeout, [this] { return !running_ || !ready_.empty(); });
+            }
+
+            stopping = !running_;
+            if (stopping || (open_count_ > 0 &&
+                             std::chrono::steady_clock::now() - open_since_ >= config_.flush_interval)) {
+                seal_open_batch_locked();
+            }
+            incoming.swap(ready_);
+        }
+
+        for (auto& batch : incoming) {
+            memory_queue_.push_back(std::move(batch));
+        }
+
+        if (connection_id_.empty()) {
+            if (connecting_) {
+                finish_connect();
+            } else if (std::chrono::steady_clock::now() >= next_connect_attempt_) {
+                try_connect();
+            }
+        }
+
+        if (!connection_id_.empty()) {
+            process_acks(std::chrono::milliseconds(0));
+        }
+
+        // Keep memory bounded; spilled batches stay older than anything in memory
+        if (connection_id_.empty() || memory_queue_.size() > config_.max_memory_batches) {
+            while (!memory_queue_.empty()) {
+                spill(std::move(memory_queue_.front()));
+                memory_queue_.pop_front();
+            }
+        }
+
+        while (!connection_id_.empty() && in_flight_.size() < config_.max_in_flight_batches) {
+            auto batch = next_batch_to_send();
+            if (!batch) {
+                break;
+            }
+            if (!send_batch(*batch)) {
+                retransmit_.push_front(std::move(*batch));
+                handle_disconnect();
+                break;
+            }
+            in_flight_.push_back(std::move(*batch));
+        }
+
+        if (stopping) {
+            break;
+        }
+    }
+
+    // Give outstanding batches a short grace period to be acknowledged
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!connection_id_.empty() && !in_flight_.empty() && std::chrono::steady_clock::now() < deadline) {
+        process_acks(std::chrono::milliseconds(50));
+    }
+
+    // Anything still unacknowledged is persisted for the next start, ahead of
+    // the spilled batches that were never sent so replay keeps the original order
+    connecting_.reset();
+    while (!in_flight_.empty()) {
+        retransmit_.push_front(std::move(in_flight_.back()));
+        in_flight_.pop_back();
+    }
+    spill_ahead(retransmit_);
+    while (!memory_queue_.empty()) {
+        spill(std::move(memory_queue_.front()));
+        memory_queue_.pop_front();
+    }
+
+    if (!connection_id_.empty()) {
+        connection_manager_->close_connection(connection_id_);
+        connection_id_.clear();
+    }
+}
+
+bool NotificationTransport::try_connect() {
+    auto address = resolve_host(config_.host);
+    if (address.has_value()) {
+        connecting_ = start_connect(address.value(), config_.port);
+    }
+    if (!connecting_) {
+        back_off();
+        return false;
+    }
+
+    connect_address_ = address.value();
+    connect_deadline_ = std::chrono::steady_clock::now() + config_.connect_timeout;
+    return finish_connect();
+}
+
+bool NotificationTransport::finish_connect() {
+    int state = connect_finished(*connecting_);
+    if (state == 0 && std::chrono::steady_clock::now() < connect_deadline_) {
+        return false;   // Still connecting; checked again on the next pass
+    }
+    if (state <= 0) {
+        connecting_.reset();
+        back_off();
+        return false;
+    }
+
+    connection_id_ = connection_manager_->adopt_connection(std::move(*connecting_), connect_address_, config_.port);
+    connecting_.reset();
+
+    backoff_ = config_.reconnect_initial;
+    receive_buffer_.clear();
+    next_sequence_ = 1;
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ++stats_.reconnects;
+    stats_.connected = true;
+    return true;
+}
+
+void NotificationTransport::back_off() {
+    next_connect_attempt_ = std::chrono::steady_clock::now() + backoff_;
+    backoff_ = std::min(backoff_ * 2, config_.reconnect_max);
+}
+
+void NotificationTransport::handle_disconnect() {
+    if (!connection_id_.empty()) {
+        connection_manager_->close_connection(connection_id_);
+        connection_id_.clear();
+    }
+
+    // Unacknowledged batches are retransmitted first after reconnect
+    // (at-least-once). They were sent before anything still spilled or queued,
+    // so they are held in memory rather than appended behind the spill file.
+    size_t retransmit = in_flight_.size();
+    while (!in_flight_.empty()) {
+        retransmit_.push_front(std::move(in_flight_.back()));
+        in_flight_.pop_back();
+    }
+
+    back_off();
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.batches_retransmitted += retransmit;
+    stats_.connected = false;
+}
+
+bool NotificationTransport::send_batch(Batch& batch) {
+    auto* connection = connection_manager_->get_connection(connection_id_);
+    if (!connection || !connection->socket || !connection->socket->is_open()) {
+        return false;
+    }
+
+    batch.sequence = next_sequence_++;
+
+    GalaxyCDN::ProtocolHeader header{};
+    header.magic = GalaxyCDN::PROTOCOL_MAGIC;
+    header.version = GalaxyCDN::PROTOCOL_VERSION;
+    header.flags = wire::FLAG_NOTIFICATION_BATCH;
+    header.payload_length = static_cast<uint32_t>(batch.payload.size());
+    header.request_id = batch.sequence;
+
+    // Header and payload go out in one write so batches pipeline back to back
+    std::vector<std::byte> frame(sizeof(header) + batch.payload.size());
+    std::memcpy(frame.data(), &header, sizeof(header));
+    std::memcpy(frame.data() + sizeof(header), batch.payload.data(), batch.payload.size());
+
+    if (!send_all(*connection->socket, frame, std::chrono::steady_clock::now() + config_.send_timeout)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ++stats_.batches_sent;
+    return true;
+}
+
+void NotificationTransport::process_acks(std::chrono::milliseconds timeout) {
+    auto* connection = connection_manager_->get_connection(connection_id_);
+    if (!connection || !connection->socket || !connection->socket->is_open()) {
+        handle_disconnect();
+        return;
+    }
+
+    // Frames are small and parsed below, so one pass never needs to buffer more than this
+    constexpr size_t MAX_RECEIVE_PER_PASS = 64 * 1024;
+
+    Socket& socket = *connection->socket;
+    int readable = wait_readable(socket, timeout);
+    bool closed = readable < 0;
+    while (readable > 0 && receive_buffer_.size() < MAX_RECEIVE_PER_PASS) {
+        std::byte chunk[4096];
+        size_t received = socket.receive(buffer_t(chunk, sizeof(chunk)));
+        if (received == 0) {
+            closed = true;      // Acknowledgements already buffered still count
+            break;
+        }
+        receive_buffer_.insert(receive_buffer_.end(), chunk, chunk + received);
+        readable = wait_readable(socket, std::chrono::milliseconds(0));
+        closed = readable < 0;
+    }
+
+    size_t consumed = 0;
+    uint64_t acked_batches = 0;
+    uint64_t acked_notifications = 0;
+    while (receive_buffer_.size() - consumed >= sizeof(GalaxyCDN::ProtocolHeader)) {
+        GalaxyCDN::ProtocolHeader header{};
+        std::memcpy(&header, receive_buffer_.data() + consumed, sizeof(header));
+        if (header.magic != GalaxyCDN::PROTOCOL_MAGIC || header.payload_length > wire::MAX_SERVER_PAYLOAD) {
+            std::cerr << "❌ Notification server sent an invalid frame, reconnecting" << std::endl;
+            closed = true;
+            break;
+        }
+        if (receive_buffer_.size() - consumed < sizeof(header) + header.payload_length) {
+            break;
+        }
+        consumed += sizeof(header) + header.payload_length;
+
+        if (header.flags & wire::FLAG_NOTIFICATION_ACK) {
+            while (!in_flight_.empty() && in_flight_.front().sequence <= header.request_id) {
+                ++acked_batches;
+                acked_notifications += in_flight_.front().count;
+                in_flight_.pop_front();
+            }
+        }
+    }
+    receive_buffer_.erase(receive_buffer_.begin(), receive_buffer_.begin() + consumed);
+
+    if (acked_batches > 0) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.batches_acked += acked_batches;
+        stats_.notifications_acked += acked_notifications;
+    }
+    if (closed) {
+        handle_disconnect();
+    }
+}
+
+std::optional<NotificationTransport::Batch> NotificationTransport::next_batch_to_send() {
+    if (!retransmit_.empty()) {
+        Batch batch = std::move(retransmit_.front());
+        retransmit_.pop_front();
+        return batch;
+    }
+    if (spill_read_offset_ < spill_size_) {
+        auto batch = read_spilled();
+        if (batch) {
+            return batch;
+        }
+    }
+    if (memory_queue_.empty()) {
+        return std::nullopt;
+    }
+    Batch batch = std::move(memory_queue_.front());
+    memory_queue_.pop_front();
+    return batch;
+}
+
+// ============================================================================
+// Spill Queue
+// ============================================================================
+
+bool NotificationTransport::open_spill() {
+    spill_read_offset_ = 0;
+    spill_size_ = 0;
+
+    if (spill_owned_) {
+        // Unpredictable name, created exclusively, so nothing else shares or pre-plants it
+        std::error_code ec;
+        auto directory = std::filesystem::temp_directory_path(ec);
+        std::random_device random;
+        for (int attempt = 0; attempt < 8 && spill_fd_ < 0; ++attempt) {
+            config_.spill_path = (directory / ("amphisbaena_notifications_" + std::to_string(process_id()) + "_" +
+                                               std::to_string(random()) + ".spill")).string();
+            spill_fd_ = open_spill_file(config_.spill_path, true);
+        }
+        return spill_fd_ >= 0;
+    }
+
+    spill_fd_ = open_spill_file(config_.spill_path, false);
+    if (spill_fd_ < 0) {
+        return false;
+    }
+    std::error_code ec;
+    auto size = std::filesystem::file_size(config_.spill_path, ec);
+    spill_size_ = ec ? 0 : size;
+    return true;
+}
+
+void NotificationTransport::close_spill() {
+    if (spill_fd_ < 0) {
+        return;
+    }
+    close_file(spill_fd_);
+    spill_fd_ = -1;
+    if (spill_owned_ && spill_size_ == 0) {
+        std::error_code ec;
+        std::filesystem::remove(config_.spill_path, ec);
+    }
+}
+
+void NotificationTransport::spill(Batch batch) {
+    if (spill_fd_ < 0 || spill_size_ + batch.payload.size() + SPILL_PREFIX_SIZE > config_.max_spill_bytes) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.dropped += batch.count;
+        std::cerr << "❌ Notification spill queue full, dropped " << batch.count
+                  << " notifications (total dropped: " << stats_.dropped << ")" << std::endl;
+        return;
+    }
+
+    uint8_t prefix[SPILL_PREFIX_SIZE];
+    encode_spill_prefix(prefix, batch.payload, batch.count);
+    if (!write_at(spill_fd_, spill_size_, prefix, sizeof(prefix)) ||
+        !write_at(spill_fd_, spill_size_ + sizeof(prefix), batch.payload.data(), batch.payload.size())) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.dropped += batch.count;
+        std::cerr << "❌ Failed to write notification spill file " << config_.spill_path
+                  << ", dropped " << batch.count << " notifications" << std::endl;
+        return;
+    }
+
+    spill_size_ += sizeof(prefix) + batch.payload.size();
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ++stats_.batches_spilled;
+}
+
+void NotificationTransport::spill_ahead(std::deque<Batch>& batches) {
+    if (spill_read_offset_ >= spill_size_) {
+        // Nothing unread on disk, so appending keeps the order
+        while (!batches.empty()) {
+            spill(std::move(batches.front()));
+            batches.pop_front();
+        }
+        return;
+    }
+
+    uint64_t needed = 0;
+    for (const auto& batch : batches) {
+        needed += SPILL_PREFIX_SIZE + batch.payload.size();
+    }
+
+    // Moving the unread region back grows the file to needed + unread: hold
+    // that to max_spill_bytes, as spill() does, dropping the newest batches
+    uint64_t unread = spill_size_ - spill_read_offset_;
+    size_t over_limit = 0;
+    while (!batches.empty() && needed > spill_read_offset_ && needed + unread > config_.max_spill_bytes) {
+        needed -= SPILL_PREFIX_SIZE + batches.back().payload.size();
+        over_limit += batches.back().count;
+        batches.pop_back();
+    }
+    if (over_limit > 0) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.dropped += over_limit;
+        std::cerr << "❌ Notification spill queue full, dropped " << over_limit
+                  << " unacknowledged notifications (total dropped: " << stats_.dropped << ")" << std::endl;
+    }
+    if (batches.empty()) {
+        return;
+    }
+
+    // Make room in front of the unread region, moving it back if the replayed
+    // prefix is too short, then write the batches into the gap in order
+    uint64_t start = 0;
+    bool moved = true;
+    if (needed <= spill_read_offset_) {
+        start = spill_read_offset_ - needed;
+    } else {
+        std::vector<std::byte> chunk(64 * 1024);
+        uint64_t remaining = unread;
+        while (moved && remaining > 0) {
+            size_t step = static_cast<size_t>(std::min<uint64_t>(remaining, chunk.size()));
+            remaining -= step;
+            moved = read_at(spill_fd_, spill_read_offset_ + remaining, chunk.data(), step) &&
+                    write_at(spill_fd_, needed + remaining, chunk.data(), step);
+        }
+    }
+
+    uint64_t offset = start;
+    for (const auto& batch : batches) {
+        uint8_t prefix[SPILL_PREFIX_SIZE];
+        encode_spill_prefix(prefix, batch.payload, batch.count);
+        moved = moved && write_at(spill_fd_, offset, prefix, sizeof(prefix)) &&
+                write_at(spill_fd_, offset + sizeof(prefix), batch.payload.data(), batch.payload.size());
+        offset += SPILL_PREFIX_SIZE + batch.payload.size();
+    }
+
+    if (!moved) {
+        size_t dropped = 0;
+        for (const auto& batch : batches) {
+            dropped += batch.count;
+        }
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.dropped += dropped;
+        std::cerr << "❌ Failed to write notification spill file " << config_.spill_path
+                  << ", dropped " << dropped << " unacknowledged notifications" << std::endl;
+        batches.clear();
+        return;
+    }
+
+    // Consumed records before the new start are dead space; drop them when
+    // the unread region was moved to the front
+    if (start == 0) {
+        spill_size_ = needed + unread;
+        truncate_to(spill_fd_, spill_size_);
+    }
+    spill_read_offset_ = start;
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.batches_spilled += batches.size();
+    batches.clear();
+}
+
+std::optional<NotificationTransport::Batch> NotificationTransport::read_spilled() {
+    uint8_t prefix[SPILL_PREFIX_SIZE];
+    Batch batch;
+    bool ok = spill_fd_ >= 0 && read_at(spill_fd_, spill_read_offset_, prefix, sizeof(prefix));
+    if (ok) {
+        uint32_t length = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            length |= static_cast<uint32_t>(prefix[i]) << (i * 8);
+        }
+        batch.count = static_cast<uint16_t>(prefix[4] | (prefix[5] << 8));
+        ok = spill_size_ - spill_read_offset_ >= sizeof(prefix) + length;
+        if (ok) {
+            batch.payload.resize(length);
+            ok = read_at(spill_fd_, spill_read_offset_ + sizeof(prefix), batch.payload.data(), length);
+        }
+    }
+
+    if (!ok) {
+        // Truncated or unreadable tail: discard it rather than wedging the queue
+        std::cerr << "❌ Notification spill file " << config_.spill_path << " is corrupt, discarding remainder"
+                  << std::endl;
+        batch.payload.clear();
+        spill_read_offset_ = spill_size_;
+    } else {
+        spill_read_offset_ += sizeof(prefix) + batch.payload.size();
+    }
+
+    if (spill_read_offset_ >= spill_size_) {
+        // Fully replayed: reset the file so it does not grow without bound
+        if (spill_fd_ >= 0) {
+            truncate_to(spill_fd_, 0);
+        }
+        spill_size_ = 0;
+        spill_read_offset_ = 0;
+    }
+
+    if (batch.payload.empty()) {
+        return std::nullopt;
+    }
+    return batch;
+}
+
+} // namespace notifications
+} // namespace network
+} // namespace dualstack
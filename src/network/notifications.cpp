@@ -8,11 +8,15 @@
 // Include format header fix BEFORE any standard headers
 #include "../../include/dualstack_net26/fix_format_header.h"
 #include "../../include/dualstack_net26/network/notifications.h"
+#include "../../include/dualstack_net26/network/notification_aggregator.h"
+#include "../../include/dualstack_net26/network/notification_transport.h"
+#include "../../include/dualstack_net26/network/notification_ring.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <ctime>
 #include <cstring>
+#include <algorithm>
 
 namespace dualstack {
 namespace network {
@@ -85,6 +89,7 @@ NotificationManager::NotificationManager()
     : initialized_(false)
     , lamia_context_(nullptr)
     , notification_server_port_(0)
+    , aggregator_(std::make_unique<NotificationAggregator>())
 {
 }
 
@@ -101,6 +106,13 @@ bool NotificationManager::initialize() {
         // Initialize default handler
         register_handler(std::make_shared<DefaultNotificationHandler>());
         
+        // Start the summary flusher so repeats are reported even when traffic stops
+        {
+            std::lock_guard<std::mutex> lock(aggregation_mutex_);
+            aggregation_running_ = true;
+        }
+        aggregation_thread_ = std::thread(&NotificationManager::aggregation_loop, this);
+        
         initialized_ = true;
         std::cout << "🐍 NotificationManager initialized" << std::endl;
         return true;
@@ -115,6 +127,29 @@ void NotificationManager::shutdown() {
         return;
     }
     
+    {
+        std::lock_guard<std::mutex> lock(aggregation_mutex_);
+        aggregation_running_ = false;
+    }
+    aggregation_cv_.notify_all();
+    if (aggregation_thread_.joinable()) {
+        aggregation_thread_.join();
+    }
+    
+    // Report outstanding repeats before handlers go away
+    for (const auto& summary : aggregator_->drain()) {
+        process_notification(summary);
+    }
+    
+    // Flush the server transport; undelivered batches persist in its spill queue
+    {
+        std::lock_guard<std::mutex> lock(endpoint_mutex_);
+        if (transport_) {
+            transport_->stop();
+            transport_.reset();
+        }
+    }
+    
     {
         std::lock_guard<std::mutex> lock(handlers_mutex_);
         handlers_.clear();
@@ -161,9 +196,60 @@ void NotificationManager::send_notification(const Notification& notification) {
         return;
     }
     
+    if (aggregator_->is_enabled()) {
+        auto now = NotificationAggregator::clock::now();
+        for (const auto& summary : aggregator_->collect_summaries(now)) {
+            process_notification(summary);
+        }
+        if (!aggregator_->admit(notification, now)) {
+            return;
+        }
+    }
+    
     process_notification(notification);
 }
 
+size_t NotificationManager::get_suppressed_count() const {
+    return aggregator_->get_suppressed_count();
+}
+
+void NotificationManager::set_aggregation_config(const AggregationConfig& config) {
+    aggregator_->set_config(config);
+    aggregation_cv_.notify_all();
+}
+
+AggregationConfig NotificationManager::get_aggregation_config() const {
+    return aggregator_->get_config();
+}
+
+void NotificationManager::flush_aggregated() {
+    if (!initialized_) {
+        return;
+    }
+    
+    for (const auto& summary : aggregator_->collect_summaries()) {
+        process_notification(summary);
+    }
+}
+
+void NotificationManager::aggregation_loop() {
+    std::unique_lock<std::mutex> lock(aggregation_mutex_);
+    while (aggregation_running_) {
+        // Wake a few times per window so summaries go out close to window close
+        auto interval = std::max(std::chrono::milliseconds(10), aggregator_->get_config().window / 4);
+        aggregation_cv_.wait_for(lock, interval);
+        if (!aggregation_running_) {
+            break;
+        }
+        
+        lock.unlock();
+        for (const auto& summary : aggregator_->collect_summaries()) {
+            process_notification(summary);
+        }
+        lock.lock();
+    }
+}
+
 void NotificationManager::send_session_event(const std::string& session_id, const std::string& event_type,
                                             const std::string& message, Severity severity) {
     Notification notification;
@@ -274,9 +360,30 @@ void NotificationManager::send_warning(const std::string& source_component, cons
 }
 
 void NotificationManager::set_notification_server_endpoint(const std::string& host, uint16_t port) {
+    NotificationTransportConfig config;
+    config.host = host;
+    config.port = port;
+    set_notification_transport_config(config);
+}
+
+void NotificationManager::set_notification_transport_config(const NotificationTransportConfig& config) {
     std::lock_guard<std::mutex> lock(endpoint_mutex_);
-    notification_server_host_ = host;
-    notification_server_port_ = port;
+    notification_server_host_ = config.host;
+    notification_server_port_ = config.port;
+    
+    if (transport_) {
+        transport_->stop();
+        transport_.reset();
+    }
+    
+    if (!config.host.empty() && config.port > 0) {
+        transport_ = std::make_unique<NotificationTransport>(config);
+        if (!transport_->start()) {
+            std::cerr << "❌ Failed to start notification transport to " << config.host
+                      << ":" << config.port << std::endl;
+            transport_.reset();
+        }
+    }
 }
 
 void NotificationManager::enable_lamia_backend(bool enable) {
@@ -322,7 +429,7 @@ void NotificationManager::process_notification(const Notification& notification)
     // Send to notification server if configured
     {
         std::lock_guard<std::mutex> lock(endpoint_mutex_);
-        if (!notification_server_host_.empty() && notification_server_port_ > 0) {
+        if (transport_) {
             send_to_notification_server(notification);
         }
     }
@@ -348,17 +455,15 @@ void NotificationManager::send_to_lamia_backend(const Notification& notification
         notification.message.c_str()
     );
     
-    if (result != 0) {
+    // Ring overflow is counted by the context (notification_context_dropped), not logged per event
+    if (result != NOTIFICATION_OK && result != NOTIFICATION_ERROR_RING_FULL) {
         std::cerr << "❌ Failed to send notification to Lamia backend: " << result << std::endl;
     }
 }
 
-void NotificationManager::send_to_notification_server(const Notification& notification [[maybe_unused]]) {
-    // TODO: Implement actual network send to MedusaServ Notification Server
-    // This will use the async connection manager to send the notification
-    // For now, just log that it would be sent
-    std::cout << "📤 Would send notification to " << notification_server_host_ 
-              << ":" << notification_server_port_ << std::endl;
+void NotificationManager::send_to_notification_server(const Notification& notification) {
+    // Caller holds endpoint_mutex_; enqueue only encodes, the transport worker does the I/O
+    transport_->enqueue(notification);
 }
 
 } // namespace notifications
@@ -370,25 +475,149 @@ void NotificationManager::send_to_notification_server(const Notification& notifi
 // ============================================================================
 // Must be in global namespace for C interface
 
+namespace {
+
+using dualstack::network::notifications::NotificationManager;
+using dualstack::network::notifications::NotificationRing;
+
+/**
+ * Process-wide Lamia dispatcher: one ring, one drain thread and one
+ * NotificationManager shared by every context. Contexts only hold a
+ * reference, so creating one no longer stands up a whole manager.
+ */
+class LamiaDispatcher {
+public:
+    static constexpr size_t RING_CAPACITY = 8192;
+    static constexpr size_t DRAIN_BATCH = 256;
+
+    static std::shared_ptr<LamiaDispatcher> acquire() {
+        static std::mutex instance_mutex;
+        static std::weak_ptr<LamiaDispatcher> instance;
+
+        std::lock_guard<std::mutex> lock(instance_mutex);
+        auto dispatcher = instance.lock();
+        if (!dispatcher) {
+            dispatcher = std::make_shared<LamiaDispatcher>();
+            if (!dispatcher->start()) {
+                return nullptr;
+            }
+            instance = dispatcher;
+        }
+        return dispatcher;
+    }
+
+    LamiaDispatcher() : ring_(RING_CAPACITY) {}
+
+    ~LamiaDispatcher() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            running_ = false;
+        }
+        wake_cv_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+        manager_.shutdown();
+    }
+
+    NotificationRing& ring() { return ring_; }
+
+    // Called after every publish; only touches the mutex when the drain thread is idle
+    void notify_published() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idle_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_cv_.notify_one();
+        }
+    }
+
+    void record_dropped() {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t get_dropped_count() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    void flush() {
+        uint64_t target = ring_.get_published_position();
+        notify_published();
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        drained_cv_.wait(lock, [&] {
+            return !running_ || ring_.get_consumed_position() >= target;
+        });
+    }
+
+private:
+    NotificationRing ring_;
+    NotificationManager manager_;
+    std::thread worker_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable drained_cv_;
+    bool running_ = false;
+    std::atomic<bool> idle_{false};
+    std::atomic<uint64_t> dropped_{0};
+
+    bool start() {
+        if (!manager_.initialize()) {
+            return false;
+        }
+        running_ = true;
+        worker_ = std::thread(&LamiaDispatcher::drain_loop, this);
+        return true;
+    }
+
+    void drain_loop() {
+        for (;;) {
+            size_t drained = ring_.consume([this](const NotificationRecord& record) {
+                manager_.send_notification(NotificationRing::to_notification(record));
+            }, DRAIN_BATCH);
+
+            if (drained > 0) {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                drained_cv_.notify_all();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            idle_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (ring_.empty()) {
+                if (!running_) {
+                    break;
+                }
+                // Timeout only guards against a producer stalled between acquire and publish
+                wake_cv_.wait_for(lock, std::chrono::milliseconds(100));
+            }
+            idle_.store(false, std::memory_order_relaxed);
+        }
+        drained_cv_.notify_all();
+    }
+};
+
+} // anonymous namespace
+
 // Define the NotificationContext struct (forward declared in header)
 struct NotificationContext {
-    dualstack::network::notifications::NotificationManager* manager;
+    std::shared_ptr<LamiaDispatcher> dispatcher;
     std::atomic<bool> active;
     
-    NotificationContext() : manager(nullptr), active(true) {}
+    NotificationContext() : active(true) {}
 };
 
 extern "C" {
 
 NotificationContextHandle notification_context_create() {
     try {
-        NotificationContext* ctx = new NotificationContext();
-        ctx->manager = new dualstack::network::notifications::NotificationManager();
-        if (!ctx->manager->initialize()) {
-            delete ctx->manager;
-            delete ctx;
+        auto dispatcher = LamiaDispatcher::acquire();
+        if (!dispatcher) {
             return nullptr;
         }
+        NotificationContext* ctx = new NotificationContext();
+        ctx->dispatcher = std::move(dispatcher);
         return ctx;
     } catch (...) {
         return nullptr;
@@ -401,9 +630,8 @@ void notification_context_destroy(NotificationContextHandle ctx) {
     }
     
     ctx->active = false;
-    if (ctx->manager) {
-        ctx->manager->shutdown();
-        delete ctx->manager;
+    if (ctx->dispatcher) {
+        ctx->dispatcher->flush();
     }
     delete ctx;
 }
@@ -415,25 +643,62 @@ int notification_send(NotificationContextHandle ctx,
                      uint8_t severity,
                      const char* title,
                      const char* message) {
-    if (!ctx || !ctx->active || !ctx->manager) {
-        return -1;
+    if (!ctx || !ctx->active) {
+        return NOTIFICATION_ERROR_INVALID;
     }
     
-    try {
-        dualstack::network::notifications::Notification notification;
-        notification.source_id = source_id ? source_id : "unknown";
-        notification.source_component = source_component ? source_component : "unknown";
-        notification.category = static_cast<dualstack::network::notifications::Category>(category);
-        notification.severity = static_cast<dualstack::network::notifications::Severity>(severity);
-        notification.title = title ? title : "";
-        notification.message = message ? message : "";
-        notification.timestamp = std::chrono::system_clock::now();
-        
-        ctx->manager->send_notification(notification);
+    auto& dispatcher = *ctx->dispatcher;
+    if (!dispatcher.ring().try_push(source_id, source_component, category, severity, title, message)) {
+        dispatcher.record_dropped();
+        return NOTIFICATION_ERROR_RING_FULL;
+    }
+    dispatcher.notify_published();
+    return NOTIFICATION_OK;
+}
+
+NotificationRecord* notification_record_acquire(NotificationContextHandle ctx) {
+    if (!ctx || !ctx->active) {
+        return nullptr;
+    }
+    
+    NotificationRecord* record = ctx->dispatcher->ring().try_acquire();
+    if (!record) {
+        ctx->dispatcher->record_dropped();
+        return nullptr;
+    }
+    // Start from empty strings and a current timestamp; callers fill what they need
+    NotificationRing::fill(*record, nullptr, nullptr,
+                           static_cast<uint16_t>(dualstack::network::notifications::Category::SYSTEM),
+                           static_cast<uint8_t>(dualstack::network::notifications::Severity::INFO),
+                           nullptr, nullptr);
+    return record;
+}
+
+int notification_record_publish(NotificationContextHandle ctx, NotificationRecord* record) {
+    if (!ctx || !record) {
+        return NOTIFICATION_ERROR_INVALID;
+    }
+    
+    // Publish even after destroy began so a claimed slot never blocks the ring
+    ctx->dispatcher->ring().publish(record);
+    ctx->dispatcher->notify_published();
+    return NOTIFICATION_OK;
+}
+
+int notification_context_flush(NotificationContextHandle ctx) {
+    if (!ctx || !ctx->dispatcher) {
+        return NOTIFICATION_ERROR_INVALID;
+    }
+    
+    ctx->dispatcher->flush();
+    return NOTIFICATION_OK;
+}
+
+uint64_t notification_context_dropped(NotificationContextHandle ctx) {
+    if (!ctx || !ctx->dispatcher) {
         return 0;
-    } catch (...) {
-        return -1;
     }
+    return ctx->dispatcher->get_dropped_count();
 }
 
-} // extern "C"
\ No newline at end of file
+} // extern "C"
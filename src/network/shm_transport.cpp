@@ -0,0 +1,746 @@
+/**
+ * Amphisbaena 🐍 - Shared-Memory Frame Transport Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "shm_transport.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace dualstack {
+namespace network {
+namespace shm {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "Ring positions are shared between processes");
+
+// Shared header at the start of every region; the data ring follows it
+struct ShmRing::Region {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    uint32_t mode;
+    alignas(64) std::atomic<uint64_t> head;                 // Next byte producers reserve
+    alignas(64) std::atomic<uint64_t> tail;                 // Next byte the consumer reads
+    alignas(64) std::atomic<uint32_t> consumer_sleeping;    // Futex words
+    alignas(64) std::atomic<uint32_t> producers_sleeping;
+};
+
+namespace {
+
+constexpr size_t DATA_OFFSET = (sizeof(ShmRing::Region) + 63) & ~size_t(63);
+constexpr size_t RECORD_ALIGN = 8;
+constexpr uint32_t PADDING_BIT = 0x80000000u;               // Skip to the end of the ring
+constexpr size_t MIN_CAPACITY = 4096;
+constexpr size_t MAX_CAPACITY = size_t(1) << 30;            // Record sizes fit the 31-bit commit word
+
+constexpr uint32_t OFFER_MAGIC = 0x53484D4F;                // "SHMO"
+constexpr uint32_t OFFER_VERSION = 1;
+constexpr auto HANDSHAKE_TIMEOUT = std::chrono::milliseconds(5000);
+constexpr auto PEER_CHECK_INTERVAL = std::chrono::milliseconds(100);
+
+// Written in place ahead of each payload. `size` is the commit word: zero
+// until the producer publishes, then the padded record length
+struct RecordHeader {
+    uint32_t size;
+    uint16_t flags;
+    uint16_t reserved;
+    uint32_t payload_length;
+    uint32_t reserved2;
+    uint64_t request_id;
+};
+static_assert(sizeof(RecordHeader) == 24 && sizeof(RecordHeader) % RECORD_ALIGN == 0);
+
+struct Offer {
+    uint32_t magic;
+    uint32_t version;
+};
+
+auto record_size_for(size_t payload_length) -> size_t {
+    return (sizeof(RecordHeader) + payload_length + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Spinning only helps when the peer runs on another CPU meanwhile
+auto spin_budget(std::chrono::microseconds configured) -> std::chrono::microseconds {
+    static const bool multiprocessor = std::thread::hardware_concurrency() > 1;
+    return multiprocessor ? configured : std::chrono::microseconds(0);
+}
+
+// Sleep while *word == expected, at most `timeout`; spurious returns are fine
+void sleep_on(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout) {
+#if defined(__linux__)
+    // Not FUTEX_PRIVATE: the word lives in memory shared between processes
+    timespec relative{};
+    relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+#else
+    if (word.load(std::memory_order_acquire) == expected) {
+        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::microseconds(100)));
+    }
+#endif
+}
+
+void wake_all(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+#ifndef _WIN32
+auto create_region_descriptor(size_t size) -> int {
+#if defined(__linux__)
+    int fd = ::memfd_create("amphisbaena-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    // A peer must not be able to shrink the region under our mapping (SIGBUS)
+    ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+    return fd;
+#else
+    static std::atomic<uint64_t> counter{0};
+    std::string name = "/amphisbaena-ring-" + std::to_string(::getpid()) + "-" + std::to_string(counter++);
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        return -1;
+    }
+    ::shm_unlink(name.c_str());
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+#endif
+}
+
+auto wait_readable(int fd, std::chrono::milliseconds timeout) -> bool {
+    pollfd entry{};
+    entry.fd = fd;
+    entry.events = POLLIN;
+    return ::poll(&entry, 1, static_cast<int>(timeout.count())) > 0;
+}
+#endif
+
+} // anonymous namespace
+
+// ===== ShmRing =====
+
+std::expected<ShmRing, error_code> ShmRing::create(const ShmRingConfig& config) {
+#ifdef _WIN32
+    (void)config;
+    return std::unexpected(error_code::invalid_address);
+#else
+    size_t capacity = std::bit_ceil(std::clamp(config.capacity, MIN_CAPACITY, MAX_CAPACITY));
+    size_t size = DATA_OFFSET + capacity;
+    int fd = create_region_descriptor(size);
+    if (fd < 0) {
+        std::cerr << "❌ Failed to create shared-memory ring: " << std::strerror(errno) << std::endl;
+        return std::unexpected(error_code::connection_failed);
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        return std::unexpected(error_code::connection_failed);
+    }
+
+    // The region starts zeroed: every commit word reads "unpublished"
+    auto* region = new (mapping) Region{};
+    region->magic = REGION_MAGIC;
+    region->version = REGION_VERSION;
+    region->capacity = capacity;
+    region->mode = static_cast<uint32_t>(config.mode);
+    return ShmRing(fd, mapping, size, config);
+#endif
+}
+
+std::expected<ShmRing, error_code> ShmRing::attach(native_socket_handle descriptor, const ShmRingConfig& config) {
+#ifdef _WIN32
+    (void)descriptor;
+    (void)config;
+    return std::unexpected(error_code::invalid_address);
+#else
+    int fd = static_cast<int>(descriptor);
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < DATA_OFFSET + MIN_CAPACITY) {
+        ::close(fd);
+        return std::unexpected(error_code::invalid_address);
+    }
+#if defined(__linux__)
+    int seals = ::fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || !(seals & F_SEAL_SHRINK)) {
+        ::close(fd);
+        return std::unexpected(error_code::invalid_address);
+    }
+#endif
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        return std::unexpected(error_code::connection_failed);
+    }
+    const auto* region = static_cast<const Region*>(mapping);
+    if (region->magic != REGION_MAGIC || region->version != REGION_VERSION ||
+        !std::has_single_bit(region->capacity) || DATA_OFFSET + region->capacity != size ||
+        region->mode > static_cast<uint32_t>(RingMode::mpsc)) {
+        ::munmap(mapping, size);
+        ::close(fd);
+        return std::unexpected(error_code::invalid_address);
+    }
+    // Producers must agree on how to reserve, so the creator's mode wins
+    ShmRingConfig attached = config;
+    attached.mode = static_cast<RingMode>(region->mode);
+    return ShmRing(fd, mapping, size, attached);
+#endif
+}
+
+ShmRing::ShmRing(int descriptor, void* mapping, size_t mapping_size, const ShmRingConfig& config)
+    : descriptor_(descriptor)
+    , mapping_(mapping)
+    , mapping_size_(mapping_size)
+    , region_(static_cast<Region*>(mapping))
+    , data_(static_cast<std::byte*>(mapping) + DATA_OFFSET)
+    , mask_(static_cast<size_t>(region_->capacity) - 1)
+    , config_(config)
+    , counters_(std::make_unique<Counters>())
+{
+}
+
+ShmRing::~ShmRing() {
+    release();
+}
+
+ShmRing::ShmRing(ShmRing&& other) noexcept
+    : descriptor_(std::exchange(other.descriptor_, -1))
+    , mapping_(std::exchange(other.mapping_, nullptr))
+    , mapping_size_(std::exchange(other.mapping_size_, 0))
+    , region_(std::exchange(other.region_, nullptr))
+    , data_(std::exchange(other.data_, nullptr))
+    , mask_(std::exchange(other.mask_, 0))
+    , config_(other.config_)
+    , counters_(std::move(other.counters_))
+{
+}
+
+ShmRing& ShmRing::operator=(ShmRing&& other) noexcept {
+    if (this != &other) {
+        release();
+        descriptor_ = std::exchange(other.descriptor_, -1);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+        region_ = std::exchange(other.region_, nullptr);
+        data_ = std::exchange(other.data_, nullptr);
+        mask_ = std::exchange(other.mask_, 0);
+        config_ = other.config_;
+        counters_ = std::move(other.counters_);
+    }
+    return *this;
+}
+
+void ShmRing::release() {
+#ifndef _WIN32
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    if (descriptor_ >= 0) {
+        ::close(descriptor_);
+    }
+#endif
+    mapping_ = nullptr;
+    region_ = nullptr;
+    data_ = nullptr;
+    descriptor_ = -1;
+}
+
+size_t ShmRing::max_payload() const {
+    // Half the ring, so a record plus the padding before it always fits
+    return region_ ? capacity() / 2 - sizeof(RecordHeader) : 0;
+}
+
+bool ShmRing::reserve(size_t record_size, uint64_t& position) {
+    uint64_t head = region_->head.load(std::memory_order_relaxed);
+    size_t total = 0;
+    size_t contiguous = 0;
+    for (;;) {
+        contiguous = capacity() - (head & mask_);
+        total = record_size <= contiguous ? record_size : contiguous + record_size;
+        // Acquire: the consumer has finished zeroing everything before tail
+        uint64_t tail = region_->tail.load(std::memory_order_acquire);
+        if (head + total - tail > capacity()) {
+            return false;
+        }
+        if (config_.mode == RingMode::spsc) {
+            region_->head.store(head + total, std::memory_order_relaxed);
+            break;
+        }
+        if (region_->head.compare_exchange_weak(head, head + total, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (total != record_size) {
+        // The record does not fit before the end: claim the rest of the ring as padding
+        std::atomic_ref<uint32_t> commit(*reinterpret_cast<uint32_t*>(data_ + (head & mask_)));
+        commit.store(static_cast<uint32_t>(contiguous) | PADDING_BIT, std::memory_order_release);
+    }
+    position = head + total - record_size;
+    return true;
+}
+
+bool ShmRing::try_send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload) {
+    if (!region_ || payload.size() > max_payload()) {
+        return false;
+    }
+    if (!write_frame(flags, request_id, payload)) {
+        counters_->full.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool ShmRing::write_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload) {
+    size_t record_size = record_size_for(payload.size());
+    uint64_t position = 0;
+    if (!reserve(record_size, position)) {
+        return false;
+    }
+
+    std::byte* record = data_ + (position & mask_);
+    RecordHeader header{};
+    header.flags = flags;
+    header.payload_length = static_cast<uint32_t>(payload.size());
+    header.request_id = request_id;
+    // Everything but the commit word, which publishes the record
+    std::memcpy(record + sizeof(uint32_t), reinterpret_cast<const std::byte*>(&header) + sizeof(uint32_t),
+                sizeof(header) - sizeof(uint32_t));
+    if (!payload.empty()) {
+        std::memcpy(record + sizeof(header), payload.data(), payload.size());
+    }
+    std::atomic_ref<uint32_t> commit(*reinterpret_cast<uint32_t*>(record));
+    commit.store(static_cast<uint32_t>(record_size), std::memory_order_release);
+
+    counters_->frames_sent.fetch_add(1, std::memory_order_relaxed);
+    counters_->bytes_sent.fetch_add(payload.size(), std::memory_order_relaxed);
+    wake_consumer();
+    return true;
+}
+
+bool ShmRing::send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload) {
+    if (try_send_frame(flags, request_id, payload)) {
+        return true;
+    }
+    if (!region_ || payload.size() > max_payload()) {
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto spin_until = start + spin_budget(config_.spin);
+    auto deadline = start + config_.send_timeout;
+    for (;;) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        if (now < spin_until) {
+            cpu_relax();
+        } else {
+            // Announce before the final attempt, so a consumer freeing space now sees us
+            region_->producers_sleeping.store(1, std::memory_order_seq_cst);
+            if (write_frame(flags, request_id, payload)) {
+                return true;
+            }
+            counters_->sleeps.fetch_add(1, std::memory_order_relaxed);
+            sleep_on(region_->producers_sleeping, 1, deadline - now);
+        }
+        if (write_frame(flags, request_id, payload)) {
+            return true;
+        }
+    }
+}
+
+bool ShmRing::has_frame() const {
+    uint64_t tail = region_->tail.load(std::memory_order_relaxed);
+    std::atomic_ref<uint32_t> commit(*reinterpret_cast<uint32_t*>(data_ + (tail & mask_)));
+    return commit.load(std::memory_order_acquire) != 0;
+}
+
+std::expected<GalaxyCDN::ProtocolHeader, error_code> ShmRing::try_receive_frame(std::vector<std::byte>& payload) {
+    if (!region_) {
+        return std::unexpected(error_code::connection_failed);
+    }
+    uint64_t tail = region_->tail.load(std::memory_order_relaxed);
+    bool freed = false;
+    for (;;) {
+        size_t offset = tail & mask_;
+        std::byte* record = data_ + offset;
+        std::atomic_ref<uint32_t> commit(*reinterpret_cast<uint32_t*>(record));
+        uint32_t word = commit.load(std::memory_order_acquire);
+        if (word == 0) {
+            // Empty, or the producer that reserved this record has not published yet
+            if (freed) {
+                wake_producers();
+            }
+            return std::unexpected(error_code::timeout);
+        }
+
+        size_t size = word & ~PADDING_BIT;
+        if (size == 0 || size > capacity() - offset || size % RECORD_ALIGN != 0) {
+            return std::unexpected(error_code::invalid_address);
+        }
+        if (word & PADDING_BIT) {
+            commit.store(0, std::memory_order_relaxed);
+            std::memset(record + sizeof(uint32_t), 0, size - sizeof(uint32_t));
+            tail += size;
+            region_->tail.store(tail, std::memory_order_release);
+            freed = true;
+            continue;
+        }
+
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+        if (size < sizeof(header) || header.payload_length > size - sizeof(header)) {
+            return std::unexpected(error_code::invalid_address);
+        }
+        payload.resize(header.payload_length);
+        if (header.payload_length != 0) {
+            std::memcpy(payload.data(), record + sizeof(header), header.payload_length);
+        }
+
+        // Zero the record before releasing it: any offset may hold a later commit word
+        commit.store(0, std::memory_order_relaxed);
+        std::memset(record + sizeof(uint32_t), 0, size - sizeof(uint32_t));
+        region_->tail.store(tail + size, std::memory_order_release);
+        wake_producers();
+
+        counters_->frames_received.fetch_add(1, std::memory_order_relaxed);
+        counters_->bytes_received.fetch_add(header.payload_length, std::memory_order_relaxed);
+
+        GalaxyCDN::ProtocolHeader frame{};
+        frame.magic = GalaxyCDN::PROTOCOL_MAGIC;
+        frame.version = GalaxyCDN::PROTOCOL_VERSION;
+        frame.flags = header.flags;
+        frame.payload_length = header.payload_length;
+        frame.request_id = header.request_id;
+        return frame;
+    }
+}
+
+std::expected<GalaxyCDN::ProtocolHeader, error_code> ShmRing::receive_frame(std::vector<std::byte>& payload,
+                                                                           std::chrono::milliseconds timeout) {
+    auto start = std::chrono::steady_clock::now();
+    auto spin_until = start + spin_budget(config_.spin);
+    auto deadline = start + timeout;
+    for (;;) {
+        auto frame = try_receive_frame(payload);
+        if (frame || frame.error() != error_code::timeout) {
+            return frame;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return frame;
+        }
+        if (now < spin_until) {
+            cpu_relax();
+            continue;
+        }
+        // Announce before the final check, so a producer publishing now sees us
+        region_->consumer_sleeping.store(1, std::memory_order_seq_cst);
+        if (!has_frame()) {
+            counters_->sleeps.fetch_add(1, std::memory_order_relaxed);
+            sleep_on(region_->consumer_sleeping, 1, deadline - now);
+        }
+        region_->consumer_sleeping.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ShmRing::wake_consumer() {
+    // Pairs with the consumer's announce-then-check: one of the two sees the other
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (region_->consumer_sleeping.load(std::memory_order_relaxed) != 0 &&
+        region_->consumer_sleeping.exchange(0, std::memory_order_seq_cst) != 0) {
+        wake_all(region_->consumer_sleeping);
+        counters_->wakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ShmRing::wake_producers() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (region_->producers_sleeping.load(std::memory_order_relaxed) != 0 &&
+        region_->producers_sleeping.exchange(0, std::memory_order_seq_cst) != 0) {
+        wake_all(region_->producers_sleeping);
+        counters_->wakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+ShmRingStats ShmRing::get_stats() const {
+    ShmRingStats stats;
+    if (!counters_) {
+        return stats;
+    }
+    stats.frames_sent = counters_->frames_sent.load(std::memory_order_relaxed);
+    stats.frames_received = counters_->frames_received.load(std::memory_order_relaxed);
+    stats.bytes_sent = counters_->bytes_sent.load(std::memory_order_relaxed);
+    stats.bytes_received = counters_->bytes_received.load(std::memory_order_relaxed);
+    stats.full = counters_->full.load(std::memory_order_relaxed);
+    stats.wakeups = counters_->wakeups.load(std::memory_order_relaxed);
+    stats.sleeps = counters_->sleeps.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ===== SocketFrameTransport =====
+
+SocketFrameTransport::SocketFrameTransport(AsyncConnectionManager& manager, std::string connection_id)
+    : manager_(manager)
+    , connection_id_(std::move(connection_id))
+{
+}
+
+SocketFrameTransport::~SocketFrameTransport() {
+    manager_.close_connection(connection_id_);
+}
+
+bool SocketFrameTransport::send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload) {
+    return manager_.send_galaxycdn_frame(connection_id_, flags, request_id, payload);
+}
+
+std::expected<GalaxyCDN::ProtocolHeader, error_code> SocketFrameTransport::receive_frame(std::vector<std::byte>& payload) {
+    return manager_.receive_galaxycdn_frame(connection_id_, payload);
+}
+
+// ===== ShmFrameTransport =====
+
+ShmFrameTransport::ShmFrameTransport(Socket control, ShmRing outbound, ShmRing inbound)
+    : control_(std::move(control))
+    , outbound_(std::move(outbound))
+    , inbound_(std::move(inbound))
+{
+}
+
+std::expected<std::unique_ptr<ShmFrameTransport>, error_code> ShmFrameTransport::offer(Socket control,
+                                                                                      const ShmRingConfig& config) {
+#ifdef _WIN32
+    (void)control;
+    (void)config;
+    return std::unexpected(error_code::invalid_address);
+#else
+    auto outbound = ShmRing::create(config);
+    if (!outbound) {
+        return std::unexpected(outbound.error());
+    }
+    auto inbound = ShmRing::create(config);
+    if (!inbound) {
+        return std::unexpected(inbound.error());
+    }
+
+    // The peer sends on our inbound ring and reads our outbound one
+    Offer offer{OFFER_MAGIC, OFFER_VERSION};
+    int descriptors[2] = {static_cast<int>(inbound->descriptor()), static_cast<int>(outbound->descriptor())};
+    iovec vector{&offer, sizeof(offer)};
+    alignas(cmsghdr) char control_buffer[CMSG_SPACE(sizeof(descriptors))] = {};
+    msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control_buffer;
+    message.msg_controllen = sizeof(control_buffer);
+    cmsghdr* rights = CMSG_FIRSTHDR(&message);
+    rights->cmsg_level = SOL_SOCKET;
+    rights->cmsg_type = SCM_RIGHTS;
+    rights->cmsg_len = CMSG_LEN(sizeof(descriptors));
+    std::memcpy(CMSG_DATA(rights), descriptors, sizeof(descriptors));
+
+    int fd = static_cast<int>(control.get_native_handle());
+    if (::sendmsg(fd, &message, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(offer))) {
+        return std::unexpected(error_code::send_failed);
+    }
+    char ready = 0;
+    if (!wait_readable(fd, HANDSHAKE_TIMEOUT) || ::recv(fd, &ready, 1, 0) != 1 || ready != 'R') {
+        return std::unexpected(error_code::connection_failed);
+    }
+    return std::unique_ptr<ShmFrameTransport>(
+        new ShmFrameTransport(std::move(control), std::move(*outbound), std::move(*inbound)));
+#endif
+}
+
+std::expected<std::unique_ptr<ShmFrameTransport>, error_code> ShmFrameTransport::accept_offer(Socket control,
+                                                                                             const ShmRingConfig& config) {
+#ifdef _WIN32
+    (void)control;
+    (void)config;
+    return std::unexpected(error_code::invalid_address);
+#else
+    int fd = static_cast<int>(control.get_native_handle());
+    if (!wait_readable(fd, HANDSHAKE_TIMEOUT)) {
+        return std::unexpected(error_code::timeout);
+    }
+
+    Offer offer{};
+    iovec vector{&offer, sizeof(offer)};
+    alignas(cmsghdr) char control_buffer[CMSG_SPACE(sizeof(int) * 2)] = {};
+    msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control_buffer;
+    message.msg_controllen = sizeof(control_buffer);
+#if defined(MSG_CMSG_CLOEXEC)
+    constexpr int receive_flags = MSG_CMSG_CLOEXEC;
+#else
+    constexpr int receive_flags = 0;
+#endif
+    ssize_t received = ::recvmsg(fd, &message, receive_flags);
+
+    std::vector<int> descriptors;
+    for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+            size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < count; ++i) {
+                int descriptor = -1;
+                std::memcpy(&descriptor, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+                descriptors.push_back(descriptor);
+            }
+        }
+    }
+    if (received != static_cast<ssize_t>(sizeof(offer)) || offer.magic != OFFER_MAGIC ||
+        offer.version != OFFER_VERSION || descriptors.size() != 2 || (message.msg_flags & MSG_CTRUNC)) {
+        for (int descriptor : descriptors) {
+            ::close(descriptor);
+        }
+        return std::unexpected(error_code::invalid_address);
+    }
+
+    auto outbound = ShmRing::attach(descriptors[0], config);
+    auto inbound = ShmRing::attach(descriptors[1], config);
+    if (!outbound || !inbound) {
+        return std::unexpected(error_code::invalid_address);
+    }
+    char ready = 'R';
+    if (::send(fd, &ready, 1, MSG_NOSIGNAL) != 1) {
+        return std::unexpected(error_code::send_failed);
+    }
+    return std::unique_ptr<ShmFrameTransport>(
+        new ShmFrameTransport(std::move(control), std::move(*outbound), std::move(*inbound)));
+#endif
+}
+
+bool ShmFrameTransport::send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload) {
+    return outbound_.send_frame(flags, request_id, payload);
+}
+
+std::expected<GalaxyCDN::ProtocolHeader, error_code> ShmFrameTransport::receive_frame(std::vector<std::byte>& payload) {
+    for (;;) {
+        auto frame = inbound_.receive_frame(payload, PEER_CHECK_INTERVAL);
+        if (frame || frame.error() != error_code::timeout) {
+            return frame;
+        }
+        if (peer_closed()) {
+            return std::unexpected(error_code::receive_failed);
+        }
+    }
+}
+
+std::expected<GalaxyCDN::ProtocolHeader, error_code> ShmFrameTransport::receive_frame(std::vector<std::byte>& payload,
+                                                                                     std::chrono::milliseconds timeout) {
+    auto frame = inbound_.receive_frame(payload, timeout);
+    if (!frame && frame.error() == error_code::timeout && peer_closed()) {
+        return std::unexpected(error_code::receive_failed);
+    }
+    return frame;
+}
+
+bool ShmFrameTransport::peer_closed() {
+#ifdef _WIN32
+    return true;
+#else
+    // Nothing else is ever sent on the control socket after the handshake
+    pollfd entry{};
+    entry.fd = static_cast<int>(control_.get_native_handle());
+    entry.events = POLLIN;
+    if (::poll(&entry, 1, 0) <= 0) {
+        return false;
+    }
+    char byte = 0;
+    return (entry.revents & (POLLHUP | POLLERR)) || ::recv(entry.fd, &byte, 1, MSG_DONTWAIT) == 0;
+#endif
+}
+
+// ===== Configuration =====
+
+std::expected<std::unique_ptr<IFrameTransport>, error_code> connect_frame_transport(
+    AsyncConnectionManager& manager, const FrameTransportConfig& config) {
+    if (config.kind == FrameTransportKind::socket) {
+        try {
+            std::string connection_id = manager.create_local_connection(config.endpoint);
+            return std::make_unique<SocketFrameTransport>(manager, std::move(connection_id));
+        } catch (const std::exception&) {
+            return std::unexpected(error_code::connection_failed);
+        }
+    }
+
+    Socket control;
+    auto result = control.connect(config.endpoint);
+    if (result != error_code::success) {
+        return std::unexpected(result);
+    }
+    auto transport = ShmFrameTransport::accept_offer(std::move(control), config.ring);
+    if (!transport) {
+        return std::unexpected(transport.error());
+    }
+    return std::unique_ptr<IFrameTransport>(std::move(*transport));
+}
+
+std::expected<std::unique_ptr<IFrameTransport>, error_code> accept_frame_transport(
+    AsyncConnectionManager& manager, Socket accepted, const FrameTransportConfig& config) {
+    if (config.kind == FrameTransportKind::socket) {
+        std::string connection_id = manager.adopt_connection(std::move(accepted), IPAddress{}, 0);
+        return std::make_unique<SocketFrameTransport>(manager, std::move(connection_id));
+    }
+
+    auto transport = ShmFrameTransport::offer(std::move(accepted), config.ring);
+    if (!transport) {
+        return std::unexpected(transport.error());
+    }
+    return std::unique_ptr<IFrameTransport>(std::move(*transport));
+}
+
+} // namespace shm
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,223 @@
+/**
+ * Amphisbaena 🐍 - Shared-Memory Frame Transport
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Same-host GalaxyCDN frames without a syscall per message:
+ *   - each direction is a byte ring in its own memfd region, shared by
+ *     passing the descriptor over a Unix socket (SCM_RIGHTS)
+ *   - producers reserve space with one CAS (MPSC) or a plain store (SPSC),
+ *     write the frame in place and publish it with a release store
+ *   - a consumer that finds the ring empty spins briefly, then sleeps on a
+ *     futex; producers only make the wake syscall when it is asleep
+ *   - IFrameTransport puts these rings and a socket connection behind one
+ *     interface, so a service picks its transport by configuration
+ *
+ * Linux only for memfd and futex; other POSIX systems use shm_open and
+ * timed polling, and Windows reports error_code::invalid_address.
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "async_connection_manager.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace shm {
+
+enum class RingMode : uint32_t {
+    spsc,       // One producing thread: reservation is a plain store
+    mpsc        // Any number of producing threads or processes
+};
+
+/**
+ * @brief Shared-Memory Ring Configuration
+ */
+struct AMPHISBAENA_API ShmRingConfig {
+    size_t capacity = 1 << 20;                          // Bytes, rounded up to a power of two
+    RingMode mode = RingMode::mpsc;
+    std::chrono::microseconds spin{20};                 // Busy-wait before sleeping; skipped on one CPU
+    std::chrono::milliseconds send_timeout{1000};       // send_frame() wait for space
+};
+
+/**
+ * @brief Per-endpoint ring statistics (this process's view)
+ */
+struct AMPHISBAENA_API ShmRingStats {
+    uint64_t frames_sent = 0;
+    uint64_t frames_received = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+    uint64_t full = 0;                  // Sends that found no space
+    uint64_t wakeups = 0;               // Wake syscalls made for a sleeping peer
+    uint64_t sleeps = 0;                // Waits that went past the spin phase
+};
+
+/**
+ * @brief One direction of shared-memory frames
+ *
+ * Frames larger than half the capacity are refused. In MPSC mode producers
+ * may be threads of several processes; there is always a single consumer.
+ */
+class AMPHISBAENA_API ShmRing {
+public:
+    static constexpr uint32_t REGION_MAGIC = 0x52494E47;   // "RING"
+    static constexpr uint32_t REGION_VERSION = 1;
+
+    // New zeroed region backed by an anonymous memfd
+    static std::expected<ShmRing, error_code> create(const ShmRingConfig& config = {});
+    // Map a region received from the creating process; takes ownership of the descriptor
+    static std::expected<ShmRing, error_code> attach(native_socket_handle descriptor, const ShmRingConfig& config = {});
+
+    ShmRing() = default;
+    ~ShmRing();
+    ShmRing(ShmRing&& other) noexcept;
+    ShmRing& operator=(ShmRing&& other) noexcept;
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Producer side: false when the ring stays full, or the frame is too large
+    bool try_send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload);
+    bool send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload);
+
+    // Consumer side: reuses the caller's payload buffer; timeout error when nothing arrived
+    std::expected<GalaxyCDN::ProtocolHeader, error_code> try_receive_frame(std::vector<std::byte>& payload);
+    std::expected<GalaxyCDN::ProtocolHeader, error_code> receive_frame(std::vector<std::byte>& payload,
+                                                                       std::chrono::milliseconds timeout);
+
+    bool is_valid() const { return region_ != nullptr; }
+    native_socket_handle descriptor() const { return descriptor_; }
+    size_t capacity() const { return mask_ + 1; }
+    size_t max_payload() const;
+    ShmRingStats get_stats() const;
+
+    struct Region;      // Shared layout, defined with the implementation
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> frames_sent{0};
+        std::atomic<uint64_t> frames_received{0};
+        std::atomic<uint64_t> bytes_sent{0};
+        std::atomic<uint64_t> bytes_received{0};
+        std::atomic<uint64_t> full{0};
+        std::atomic<uint64_t> wakeups{0};
+        std::atomic<uint64_t> sleeps{0};
+    };
+
+    ShmRing(int descriptor, void* mapping, size_t mapping_size, const ShmRingConfig& config);
+    void release();
+
+    // Claim record_size bytes at `position`; false when the ring is full
+    bool reserve(size_t record_size, uint64_t& position);
+    bool write_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload);
+    bool has_frame() const;
+    void wake_consumer();
+    void wake_producers();
+
+    int descriptor_ = -1;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    Region* region_ = nullptr;
+    std::byte* data_ = nullptr;
+    size_t mask_ = 0;
+    ShmRingConfig config_;
+    std::unique_ptr<Counters> counters_;        // Heap-allocated so the ring stays movable
+};
+
+/**
+ * @brief GalaxyCDN frame I/O, whatever carries it
+ */
+class AMPHISBAENA_API IFrameTransport {
+public:
+    virtual ~IFrameTransport() = default;
+    virtual bool send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload) = 0;
+    virtual std::expected<GalaxyCDN::ProtocolHeader, error_code> receive_frame(std::vector<std::byte>& payload) = 0;
+};
+
+/**
+ * @brief Frames over an AsyncConnectionManager connection (TCP or Unix socket)
+ */
+class AMPHISBAENA_API SocketFrameTransport : public IFrameTransport {
+public:
+    SocketFrameTransport(AsyncConnectionManager& manager, std::string connection_id);
+    ~SocketFrameTransport() override;
+
+    bool send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload) override;
+    std::expected<GalaxyCDN::ProtocolHeader, error_code> receive_frame(std::vector<std::byte>& payload) override;
+
+    const std::string& connection_id() const { return connection_id_; }
+
+private:
+    AsyncConnectionManager& manager_;
+    std::string connection_id_;
+};
+
+/**
+ * @brief Frames over a pair of shared-memory rings
+ *
+ * The accepting side creates both rings and offers them over the Unix
+ * socket it accepted; the connecting side maps them. The socket stays open
+ * so either side notices when the other goes away: receive_frame() then
+ * fails with receive_failed, as on a socket, instead of waiting forever.
+ */
+class AMPHISBAENA_API ShmFrameTransport : public IFrameTransport {
+public:
+    static std::expected<std::unique_ptr<ShmFrameTransport>, error_code> offer(Socket control,
+                                                                              const ShmRingConfig& config = {});
+    static std::expected<std::unique_ptr<ShmFrameTransport>, error_code> accept_offer(Socket control,
+                                                                                     const ShmRingConfig& config = {});
+
+    bool send_frame(uint16_t flags, uint64_t request_id, std::span<const std::byte> payload) override;
+    // Waits until a frame arrives or the peer closes the control socket
+    std::expected<GalaxyCDN::ProtocolHeader, error_code> receive_frame(std::vector<std::byte>& payload) override;
+    std::expected<GalaxyCDN::ProtocolHeader, error_code> receive_frame(std::vector<std::byte>& payload,
+                                                                       std::chrono::milliseconds timeout);
+
+    ShmRing& outbound() { return outbound_; }
+    ShmRing& inbound() { return inbound_; }
+
+private:
+    ShmFrameTransport(Socket control, ShmRing outbound, ShmRing inbound);
+    bool peer_closed();
+
+    Socket control_;
+    ShmRing outbound_;
+    ShmRing inbound_;
+};
+
+enum class FrameTransportKind : uint8_t {
+    socket,
+    shared_memory
+};
+
+/**
+ * @brief Transport selection for a same-host service; both ends must agree
+ */
+struct AMPHISBAENA_API FrameTransportConfig {
+    FrameTransportKind kind = FrameTransportKind::socket;
+    UnixEndpoint endpoint;                  // Where the accepting side listens
+    ShmRingConfig ring;
+};
+
+// Connecting side; socket transports are tracked in `manager`
+AMPHISBAENA_API std::expected<std::unique_ptr<IFrameTransport>, error_code> connect_frame_transport(
+    AsyncConnectionManager& manager, const FrameTransportConfig& config);
+// Accepting side, for a socket accepted on config.endpoint
+AMPHISBAENA_API std::expected<std::unique_ptr<IFrameTransport>, error_code> accept_frame_transport(
+    AsyncConnectionManager& manager, Socket accepted, const FrameTransportConfig& config);
+
+} // namespace shm
+} // namespace network
+} // namespace dualstack
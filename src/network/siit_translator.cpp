@@ -0,0 +1,620 @@
+/**
+ * Amphisbaena 🐍 - Stateless IPv4/IPv6 Translation Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "../../include/dualstack_net26/network/siit_translator.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+
+namespace dualstack {
+namespace network {
+
+namespace {
+
+constexpr std::uint8_t PROTO_HOP_BY_HOP = 0;
+constexpr std::uint8_t PROTO_ICMP = 1;
+constexpr std::uint8_t PROTO_TCP = 6;
+constexpr std::uint8_t PROTO_UDP = 17;
+constexpr std::uint8_t PROTO_ROUTING = 43;
+constexpr std::uint8_t PROTO_FRAGMENT = 44;
+constexpr std::uint8_t PROTO_ICMPV6 = 58;
+constexpr std::uint8_t PROTO_DEST_OPTIONS = 60;
+
+constexpr std::size_t IPV4_HEADER = 20;
+constexpr std::size_t IPV6_HEADER = 40;
+constexpr std::size_t FRAGMENT_HEADER = 8;
+
+auto load16(const std::byte* p) -> std::uint16_t {
+    return static_cast<std::uint16_t>((std::to_integer<unsigned>(p[0]) << 8) | std::to_integer<unsigned>(p[1]));
+}
+
+auto load32(const std::byte* p) -> std::uint32_t {
+    return (std::uint32_t(load16(p)) << 16) | load16(p + 2);
+}
+
+auto load64(const std::byte* p) -> std::uint64_t {
+    return (std::uint64_t(load32(p)) << 32) | load32(p + 4);
+}
+
+auto store16(std::byte* p, std::uint16_t value) -> void {
+    p[0] = static_cast<std::byte>(value >> 8);
+    p[1] = static_cast<std::byte>(value);
+}
+
+auto store32(std::byte* p, std::uint32_t value) -> void {
+    store16(p, static_cast<std::uint16_t>(value >> 16));
+    store16(p + 2, static_cast<std::uint16_t>(value));
+}
+
+auto store64(std::byte* p, std::uint64_t value) -> void {
+    store32(p, static_cast<std::uint32_t>(value >> 32));
+    store32(p + 4, static_cast<std::uint32_t>(value));
+}
+
+// One's-complement arithmetic (RFC 1071); sums are folded before use
+auto fold(std::uint64_t sum) -> std::uint16_t {
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<std::uint16_t>(sum);
+}
+
+auto sum_bytes(const std::byte* data, std::size_t length) -> std::uint64_t {
+    std::uint64_t sum = 0;
+    std::size_t i = 0;
+    for (; i + 1 < length; i += 2) {
+        sum += load16(data + i);
+    }
+    if (i < length) {
+        sum += std::to_integer<std::uint64_t>(data[i]) << 8;
+    }
+    return sum;
+}
+
+auto sum_ipv4(std::uint32_t address) -> std::uint64_t {
+    return (address >> 16) + (address & 0xFFFF);
+}
+
+auto sum_ipv6(const ipv6_address& address) -> std::uint64_t {
+    std::uint64_t sum = 0;
+    for (int shift = 0; shift < 64; shift += 16) {
+        sum += (address.high >> shift) & 0xFFFF;
+        sum += (address.low >> shift) & 0xFFFF;
+    }
+    return sum;
+}
+
+// RFC 1624 eqn. 3: HC' = ~(~HC + ~m + m'), with m and m' the removed and added word sums
+auto adjust_checksum(std::uint16_t checksum, std::uint64_t removed, std::uint64_t added) -> std::uint16_t {
+    std::uint64_t sum = std::uint16_t(~checksum);
+    sum += std::uint16_t(~fold(removed));
+    sum += fold(added);
+    return static_cast<std::uint16_t>(~fold(sum));
+}
+
+auto load_ipv6(const std::byte* p) -> ipv6_address {
+    return ipv6_address(load64(p), load64(p + 8));
+}
+
+auto store_ipv6(std::byte* p, const ipv6_address& address) -> void {
+    store64(p, address.high);
+    store64(p + 8, address.low);
+}
+
+auto to_bytes(const ipv6_address& address) -> std::array<std::uint8_t, 16> {
+    std::array<std::uint8_t, 16> bytes{};
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(address.high >> (56 - i * 8));
+        bytes[8 + i] = static_cast<std::uint8_t>(address.low >> (56 - i * 8));
+    }
+    return bytes;
+}
+
+auto from_bytes(const std::array<std::uint8_t, 16>& bytes) -> ipv6_address {
+    ipv6_address address;
+    for (int i = 0; i < 8; ++i) {
+        address.high = (address.high << 8) | bytes[i];
+        address.low = (address.low << 8) | bytes[8 + i];
+    }
+    return address;
+}
+
+auto valid_prefix_length(int length) -> bool {
+    return length == 32 || length == 40 || length == 48 || length == 56 || length == 64 || length == 96;
+}
+
+// Positions of the four IPv4 bytes: straight after the prefix, skipping the reserved octet 8
+auto ipv4_positions(int prefix_length) -> std::array<int, 4> {
+    std::array<int, 4> positions{};
+    int position = prefix_length / 8;
+    for (int& slot : positions) {
+        if (position == 8) {
+            ++position;
+        }
+        slot = position++;
+    }
+    return positions;
+}
+
+// Word of an ICMP header holding type and code
+auto type_word(const std::byte* icmp) -> std::uint16_t {
+    return load16(icmp);
+}
+
+} // namespace
+
+auto to_string(TranslationError error) -> const char* {
+    switch (error) {
+        case TranslationError::MALFORMED: return "malformed packet";
+        case TranslationError::NO_MAPPING: return "no address mapping";
+        case TranslationError::TTL_EXPIRED: return "TTL expired";
+        case TranslationError::UNSUPPORTED: return "unsupported packet";
+        case TranslationError::TOO_BIG: return "packet too big";
+    }
+    return "unknown";
+}
+
+auto embed_ipv4(const ipv6_address& prefix, int prefix_length, const ipv4_address& ipv4) -> ipv6_address {
+    auto bytes = to_bytes(prefix);
+    std::fill(bytes.begin() + prefix_length / 8, bytes.end(), 0);
+    auto positions = ipv4_positions(prefix_length);
+    for (int i = 0; i < 4; ++i) {
+        bytes[positions[i]] = static_cast<std::uint8_t>(ipv4.address >> (24 - i * 8));
+    }
+    return from_bytes(bytes);
+}
+
+auto extract_ipv4(const ipv6_address& prefix, int prefix_length, const ipv6_address& ipv6) -> std::optional<ipv4_address> {
+    auto want = to_bytes(prefix);
+    auto bytes = to_bytes(ipv6);
+    if (!std::equal(bytes.begin(), bytes.begin() + prefix_length / 8, want.begin()) ||
+        (prefix_length < 96 && bytes[8] != 0)) {
+        return std::nullopt;
+    }
+    std::uint32_t address = 0;
+    for (int position : ipv4_positions(prefix_length)) {
+        address = (address << 8) | bytes[position];
+    }
+    return ipv4_address(address);
+}
+
+// ============================================================================
+// PacketBatch Implementation
+// ============================================================================
+
+auto PacketBatch::clear() -> void {
+    used_ = 0;
+    packets_.clear();
+}
+
+auto PacketBatch::add(std::span<const std::byte> packet) -> void {
+    auto space = prepare(packet.size());
+    std::memcpy(space.data(), packet.data(), packet.size());
+    commit(packet.size());
+}
+
+auto PacketBatch::prepare(std::size_t max_length) -> std::span<std::byte> {
+    if (data_.size() < used_ + max_length) {
+        data_.resize(std::max(used_ + max_length, data_.size() * 2));
+    }
+    return {data_.data() + used_, max_length};
+}
+
+auto PacketBatch::commit(std::size_t length) -> void {
+    packets_.emplace_back(static_cast<std::uint32_t>(used_), static_cast<std::uint32_t>(length));
+    used_ += length;
+}
+
+// ============================================================================
+// SiitTranslator Implementation
+// ============================================================================
+
+SiitTranslator::SiitTranslator(SiitConfig config) : config_(std::move(config)) {
+    if (config_.prefix && !valid_prefix_length(config_.prefix_length)) {
+        config_.prefix.reset();
+    }
+}
+
+auto SiitTranslator::set_prefix(const ipv6_address& prefix, int prefix_length) -> bool {
+    if (!valid_prefix_length(prefix_length)) {
+        return false;
+    }
+    std::unique_lock lock(mutex_);
+    config_.prefix = prefix;
+    config_.prefix_length = prefix_length;
+    return true;
+}
+
+auto SiitTranslator::clear_prefix() -> void {
+    std::unique_lock lock(mutex_);
+    config_.prefix.reset();
+}
+
+auto SiitTranslator::add_mapping(const ipv4_address& ipv4, const ipv6_address& ipv6) -> void {
+    std::unique_lock lock(mutex_);
+    if (const ipv6_address* old = ipv4_to_ipv6_.find(ipv4.address)) {
+        ipv6_to_ipv4_.erase(*old);
+    }
+    if (const std::uint32_t* old = ipv6_to_ipv4_.find(ipv6)) {
+        ipv4_to_ipv6_.erase(*old);
+    }
+    ipv4_to_ipv6_.insert(ipv4.address, ipv6);
+    ipv6_to_ipv4_.insert(ipv6, ipv4.address);
+}
+
+auto SiitTranslator::remove_mapping(const ipv4_address& ipv4) -> bool {
+    std::unique_lock lock(mutex_);
+    const ipv6_address* ipv6 = ipv4_to_ipv6_.find(ipv4.address);
+    if (!ipv6) {
+        return false;
+    }
+    ipv6_to_ipv4_.erase(*ipv6);
+    ipv4_to_ipv6_.erase(ipv4.address);
+    return true;
+}
+
+auto SiitTranslator::find_mapping(const ipv4_address& ipv4) const -> std::optional<ipv6_address> {
+    std::shared_lock lock(mutex_);
+    if (const ipv6_address* ipv6 = ipv4_to_ipv6_.find(ipv4.address)) {
+        return *ipv6;
+    }
+    return std::nullopt;
+}
+
+auto SiitTranslator::find_mapping(const ipv6_address& ipv6) const -> std::optional<ipv4_address> {
+    std::shared_lock lock(mutex_);
+    if (const std::uint32_t* ipv4 = ipv6_to_ipv4_.find(ipv6)) {
+        return ipv4_address(*ipv4);
+    }
+    return std::nullopt;
+}
+
+auto SiitTranslator::mapping_count() const -> std::size_t {
+    std::shared_lock lock(mutex_);
+    return ipv4_to_ipv6_.size();
+}
+
+auto SiitTranslator::map_to_ipv6(std::uint32_t ipv4) const -> std::optional<ipv6_address> {
+    if (const ipv6_address* mapped = ipv4_to_ipv6_.find(ipv4)) {
+        return *mapped;
+    }
+    if (config_.prefix) {
+        return embed_ipv4(*config_.prefix, config_.prefix_length, ipv4_address(ipv4));
+    }
+    return std::nullopt;
+}
+
+auto SiitTranslator::map_to_ipv4(const ipv6_address& ipv6) const -> std::optional<std::uint32_t> {
+    if (const std::uint32_t* mapped = ipv6_to_ipv4_.find(ipv6)) {
+        return *mapped;
+    }
+    if (config_.prefix) {
+        if (auto extracted = extract_ipv4(*config_.prefix, config_.prefix_length, ipv6)) {
+            return extracted->address;
+        }
+    }
+    return std::nullopt;
+}
+
+auto SiitTranslator::translate_address(const ipv4_address& ipv4) const -> std::optional<ipv6_address> {
+    std::shared_lock lock(mutex_);
+    return map_to_ipv6(ipv4.address);
+}
+
+auto SiitTranslator::translate_address(const ipv6_address& ipv6) const -> std::optional<ipv4_address> {
+    std::shared_lock lock(mutex_);
+    if (auto ipv4 = map_to_ipv4(ipv6)) {
+        return ipv4_address(*ipv4);
+    }
+    return std::nullopt;
+}
+
+// RFC 7915 section 4
+auto SiitTranslator::ipv4_to_ipv6_locked(std::span<const std::byte> packet, std::span<std::byte> out) const
+    -> std::expected<std::size_t, TranslationError> {
+    const std::byte* in = packet.data();
+    if (packet.size() < IPV4_HEADER || (std::to_integer<unsigned>(in[0]) >> 4) != 4) {
+        return std::unexpected(TranslationError::MALFORMED);
+    }
+    std::size_t header_length = (std::to_integer<unsigned>(in[0]) & 0x0F) * 4;
+    std::size_t total_length = load16(in + 2);
+    if (header_length < IPV4_HEADER || total_length < header_length || total_length > packet.size()) {
+        return std::unexpected(TranslationError::MALFORMED);
+    }
+    unsigned ttl = std::to_integer<unsigned>(in[8]);
+    if (ttl <= 1) {
+        return std::unexpected(TranslationError::TTL_EXPIRED);
+    }
+
+    std::uint8_t protocol = std::to_integer<std::uint8_t>(in[9]);
+    std::uint16_t fragment_field = load16(in + 6);
+    bool more_fragments = (fragment_field & 0x2000) != 0;
+    std::uint16_t fragment_offset = fragment_field & 0x1FFF;
+    bool fragmented = more_fragments || fragment_offset != 0;
+    if (protocol == PROTO_ICMP && fragmented) {
+        return std::unexpected(TranslationError::UNSUPPORTED);     // The ICMPv6 pseudo-header needs the whole length
+    }
+    if (protocol == PROTO_ICMPV6) {
+        return std::unexpected(TranslationError::UNSUPPORTED);
+    }
+
+    std::uint32_t source4 = load32(in + 12);
+    std::uint32_t destination4 = load32(in + 16);
+    auto source6 = map_to_ipv6(source4);
+    auto destination6 = map_to_ipv6(destination4);
+    if (!source6 || !destination6) {
+        return std::unexpected(TranslationError::NO_MAPPING);
+    }
+
+    const std::byte* payload = in + header_length;
+    std::size_t payload_length = total_length - header_length;
+    std::size_t extension_length = fragmented ? FRAGMENT_HEADER : 0;
+    std::size_t out_length = IPV6_HEADER + extension_length + payload_length;
+    if (out_length > out.size()) {
+        return std::unexpected(TranslationError::TOO_BIG);
+    }
+
+    std::uint8_t next_header = protocol == PROTO_ICMP ? PROTO_ICMPV6 : protocol;
+    std::byte* o = out.data();
+    unsigned traffic_class = std::to_integer<unsigned>(in[1]);
+    store32(o, (6u << 28) | (traffic_class << 20));
+    store16(o + 4, static_cast<std::uint16_t>(extension_length + payload_length));
+    o[6] = static_cast<std::byte>(fragmented ? PROTO_FRAGMENT : next_header);
+    o[7] = static_cast<std::byte>(ttl - 1);
+    store_ipv6(o + 8, *source6);
+    store_ipv6(o + 24, *destination6);
+    if (fragmented) {
+        std::byte* fragment = o + IPV6_HEADER;
+        fragment[0] = static_cast<std::byte>(next_header);
+        fragment[1] = std::byte{0};
+        store16(fragment + 2, static_cast<std::uint16_t>((fragment_offset << 3) | (more_fragments ? 1 : 0)));
+        store32(fragment + 4, load16(in + 4));
+    }
+    std::byte* upper = o + IPV6_HEADER + extension_length;
+    std::memcpy(upper, payload, payload_length);
+
+    // Only the first fragment carries the transport header
+    if (fragment_offset == 0) {
+        std::uint64_t removed = sum_ipv4(source4) + sum_ipv4(destination4);
+        std::uint64_t added = sum_ipv6(*source6) + sum_ipv6(*destination6);
+        if (protocol == PROTO_TCP && payload_length >= 20) {
+            store16(upper + 16, adjust_checksum(load16(upper + 16), removed, added));
+        } else if (protocol == PROTO_UDP && payload_length >= 8) {
+            std::uint16_t checksum = load16(upper + 6);
+            if (checksum == 0) {
+                // Optional over IPv4, mandatory over IPv6: the one case computed in full
+                if (fragmented) {
+                    return std::unexpected(TranslationError::UNSUPPORTED);
+                }
+                checksum = static_cast<std::uint16_t>(~fold(added + payload_length + PROTO_UDP +
+                                                             sum_bytes(upper, payload_length)));
+            } else {
+                checksum = adjust_checksum(checksum, removed, added);
+            }
+            store16(upper + 6, checksum == 0 ? 0xFFFF : checksum);
+        } else if (protocol == PROTO_ICMP) {
+            if (payload_length < 8) {
+                return std::unexpected(TranslationError::MALFORMED);
+            }
+            // Echo request / reply only; errors would need their inner packet translated too
+            unsigned type = std::to_integer<unsigned>(upper[0]);
+            if (type != 8 && type != 0) {
+                return std::unexpected(TranslationError::UNSUPPORTED);
+            }
+            std::uint16_t old_word = type_word(upper);
+            upper[0] = static_cast<std::byte>(type == 8 ? 128 : 129);
+            // ICMPv6 covers a pseudo-header ICMPv4 does not
+            std::uint64_t pseudo = added + (payload_length >> 16) + (payload_length & 0xFFFF) + PROTO_ICMPV6;
+            store16(upper + 2, adjust_checksum(load16(upper + 2), old_word, type_word(upper) + pseudo));
+        }
+    }
+    return out_length;
+}
+
+// RFC 7915 section 5
+auto SiitTranslator::ipv6_to_ipv4_locked(std::span<const std::byte> packet, std::span<std::byte> out) const
+    -> std::expected<std::size_t, TranslationError> {
+    const std::byte* in = packet.data();
+    if (packet.size() < IPV6_HEADER || (std::to_integer<unsigned>(in[0]) >> 4) != 6) {
+        return std::unexpected(TranslationError::MALFORMED);
+    }
+    std::size_t end = IPV6_HEADER + load16(in + 4);
+    if (end > packet.size()) {
+        return std::unexpected(TranslationError::MALFORMED);
+    }
+    unsigned hop_limit = std::to_integer<unsigned>(in[7]);
+    if (hop_limit <= 1) {
+        return std::unexpected(TranslationError::TTL_EXPIRED);
+    }
+
+    // Skip extension headers; a Fragment header becomes the IPv4 fragment fields
+    std::uint8_t next_header = std::to_integer<std::uint8_t>(in[6]);
+    std::size_t offset = IPV6_HEADER;
+    bool fragmented = false;
+    bool more_fragments = false;
+    std::uint16_t fragment_offset = 0;
+    std::uint32_t identification = 0;
+    while (next_header == PROTO_HOP_BY_HOP || next_header == PROTO_ROUTING ||
+           next_header == PROTO_DEST_OPTIONS || next_header == PROTO_FRAGMENT) {
+        if (offset + 8 > end) {
+            return std::unexpected(TranslationError::MALFORMED);
+        }
+        const std::byte* extension = in + offset;
+        std::uint8_t following = std::to_integer<std::uint8_t>(extension[0]);
+        if (next_header == PROTO_FRAGMENT) {
+            std::uint16_t field = load16(extension + 2);
+            fragmented = true;
+            fragment_offset = field >> 3;
+            more_fragments = (field & 1) != 0;
+            identification = load32(extension + 4);
+            offset += FRAGMENT_HEADER;
+        } else {
+            if (next_header == PROTO_ROUTING && std::to_integer<unsigned>(extension[3]) != 0) {
+                return std::unexpected(TranslationError::UNSUPPORTED);     // Segments left: not ours to finish
+            }
+            offset += (std::to_integer<std::size_t>(extension[1]) + 1) * 8;
+        }
+        next_header = following;
+    }
+    if (offset > end) {
+        return std::unexpected(TranslationError::MALFORMED);
+    }
+    if (next_header == PROTO_ICMP || (next_header == PROTO_ICMPV6 && fragmented)) {
+        return std::unexpected(TranslationError::UNSUPPORTED);
+    }
+
+    ipv6_address source6 = load_ipv6(in + 8);
+    ipv6_address destination6 = load_ipv6(in + 24);
+    auto source4 = map_to_ipv4(source6);
+    auto destination4 = map_to_ipv4(destination6);
+    if (!source4 || !destination4) {
+        return std::unexpected(TranslationError::NO_MAPPING);
+    }
+
+    const std::byte* payload = in + offset;
+    std::size_t payload_length = end - offset;
+    std::size_t out_length = IPV4_HEADER + payload_length;
+    if (out_length > 0xFFFF || out_length > out.size()) {
+        return std::unexpected(TranslationError::TOO_BIG);
+    }
+
+    std::uint8_t protocol = next_header == PROTO_ICMPV6 ? PROTO_ICMP : next_header;
+    std::byte* o = out.data();
+    o[0] = std::byte{0x45};
+    o[1] = static_cast<std::byte>((load16(in) >> 4) & 0xFF);
+    store16(o + 2, static_cast<std::uint16_t>(out_length));
+    if (fragmented) {
+        store16(o + 4, static_cast<std::uint16_t>(identification));
+        store16(o + 6, static_cast<std::uint16_t>((more_fragments ? 0x2000 : 0) | fragment_offset));
+    } else {
+        store16(o + 4, 0);
+        store16(o + 6, 0x4000);                                 // DF
+    }
+    o[8] = static_cast<std::byte>(hop_limit - 1);
+    o[9] = static_cast<std::byte>(protocol);
+    store16(o + 10, 0);
+    store32(o + 12, *source4);
+    store32(o + 16, *destination4);
+    store16(o + 10, static_cast<std::uint16_t>(~fold(sum_bytes(o, IPV4_HEADER))));
+    std::byte* upper = o + IPV4_HEADER;
+    std::memcpy(upper, payload, payload_length);
+
+    if (fragment_offset == 0) {
+        std::uint64_t removed = sum_ipv6(source6) + sum_ipv6(destination6);
+        std::uint64_t added = sum_ipv4(*source4) + sum_ipv4(*destination4);
+        if (protocol == PROTO_TCP && payload_length >= 20) {
+            store16(upper + 16, adjust_checksum(load16(upper + 16), removed, added));
+        } else if (protocol == PROTO_UDP && payload_length >= 8) {
+            std::uint16_t checksum = adjust_checksum(load16(upper + 6), removed, added);
+            store16(upper + 6, checksum == 0 ? 0xFFFF : checksum);
+        } else if (protocol == PROTO_ICMP) {
+            if (payload_length < 8) {
+                return std::unexpected(TranslationError::MALFORMED);
+            }
+            unsigned type = std::to_integer<unsigned>(upper[0]);
+            if (type != 128 && type != 129) {
+                return std::unexpected(TranslationError::UNSUPPORTED);
+            }
+            std::uint16_t old_word = type_word(upper);
+            upper[0] = static_cast<std::byte>(type == 128 ? 8 : 0);
+            std::uint64_t pseudo = removed + (payload_length >> 16) + (payload_length & 0xFFFF) + PROTO_ICMPV6;
+            store16(upper + 2, adjust_checksum(load16(upper + 2), old_word + pseudo, type_word(upper)));
+        }
+    }
+    return out_length;
+}
+
+auto SiitTranslator::translate_to_ipv6(std::span<const std::byte> packet, std::span<std::byte> out)
+    -> std::expected<std::size_t, TranslationError> {
+    std::shared_lock lock(mutex_);
+    auto result = ipv4_to_ipv6_locked(packet, out);
+    if (result) {
+        translated_to_ipv6_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        dropped_[static_cast<int>(result.error())].fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+auto SiitTranslator::translate_to_ipv4(std::span<const std::byte> packet, std::span<std::byte> out)
+    -> std::expected<std::size_t, TranslationError> {
+    std::shared_lock lock(mutex_);
+    auto result = ipv6_to_ipv4_locked(packet, out);
+    if (result) {
+        translated_to_ipv4_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        dropped_[static_cast<int>(result.error())].fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+auto SiitTranslator::translate_to_ipv6(const PacketBatch& ipv4_packets, PacketBatch& out) -> std::size_t {
+    std::size_t translated = 0;
+    std::uint64_t dropped[5] = {};
+    {
+        std::shared_lock lock(mutex_);
+        for (std::size_t i = 0; i < ipv4_packets.size(); ++i) {
+            auto packet = ipv4_packets[i];
+            auto result = ipv4_to_ipv6_locked(packet, out.prepare(packet.size() + IPV6_HEADER + FRAGMENT_HEADER - IPV4_HEADER));
+            if (result) {
+                out.commit(*result);
+                ++translated;
+            } else {
+                ++dropped[static_cast<int>(result.error())];
+            }
+        }
+    }
+    // Counters touched once per batch
+    translated_to_ipv6_.fetch_add(translated, std::memory_order_relaxed);
+    for (int i = 0; i < 5; ++i) {
+        if (dropped[i]) {
+            dropped_[i].fetch_add(dropped[i], std::memory_order_relaxed);
+        }
+    }
+    return translated;
+}
+
+auto SiitTranslator::translate_to_ipv4(const PacketBatch& ipv6_packets, PacketBatch& out) -> std::size_t {
+    std::size_t translated = 0;
+    std::uint64_t dropped[5] = {};
+    {
+        std::shared_lock lock(mutex_);
+        for (std::size_t i = 0; i < ipv6_packets.size(); ++i) {
+            auto packet = ipv6_packets[i];
+            auto result = ipv6_to_ipv4_locked(packet, out.prepare(packet.size()));
+            if (result) {
+                out.commit(*result);
+                ++translated;
+            } else {
+                ++dropped[static_cast<int>(result.error())];
+            }
+        }
+    }
+    translated_to_ipv4_.fetch_add(translated, std::memory_order_relaxed);
+    for (int i = 0; i < 5; ++i) {
+        if (dropped[i]) {
+            dropped_[i].fetch_add(dropped[i], std::memory_order_relaxed);
+        }
+    }
+    return translated;
+}
+
+auto SiitTranslator::get_stats() const -> SiitStats {
+    SiitStats stats{};
+    stats.translated_to_ipv6 = translated_to_ipv6_.load(std::memory_order_relaxed);
+    stats.translated_to_ipv4 = translated_to_ipv4_.load(std::memory_order_relaxed);
+    stats.dropped_malformed = dropped_[static_cast<int>(TranslationError::MALFORMED)].load(std::memory_order_relaxed);
+    stats.dropped_no_mapping = dropped_[static_cast<int>(TranslationError::NO_MAPPING)].load(std::memory_order_relaxed);
+    stats.dropped_ttl_expired = dropped_[static_cast<int>(TranslationError::TTL_EXPIRED)].load(std::memory_order_relaxed);
+    stats.dropped_unsupported = dropped_[static_cast<int>(TranslationError::UNSUPPORTED)].load(std::memory_order_relaxed);
+    stats.dropped_too_big = dropped_[static_cast<int>(TranslationError::TOO_BIG)].load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace network
+} // namespace dualstack
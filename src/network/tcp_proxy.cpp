@@ -0,0 +1,790 @@
+/**
+ * Amphisbaena 🐍 - L4 TCP Proxy Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "tcp_proxy.h"
+#include "event_poller.h"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0      // I/O threads block SIGPIPE instead
+#endif
+
+namespace dualstack {
+namespace network {
+namespace proxy {
+
+namespace {
+
+constexpr size_t SPLICE_CHUNK = 64 * 1024;      // Default pipe capacity
+constexpr int PUMP_ROUNDS = 16;                 // Per readiness event, so one busy session cannot starve the rest
+constexpr int TICK_MS = 100;                    // Connect timeouts are checked at this granularity
+
+auto connect_in_progress() -> bool {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EINPROGRESS;
+#endif
+}
+
+auto socket_error(native_socket_handle fd) -> int {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length) != 0) {
+        return -1;
+    }
+    return error;
+}
+
+auto set_no_delay(native_socket_handle fd) -> void {
+    int no_delay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay), sizeof(no_delay));
+}
+
+auto shutdown_write(native_socket_handle fd) -> void {
+#ifdef _WIN32
+    ::shutdown(static_cast<SOCKET>(fd), SD_SEND);
+#else
+    ::shutdown(fd, SHUT_WR);
+#endif
+}
+
+// Non-blocking connect; the result is reported when the socket becomes writable
+auto start_connect(const BackendEndpoint& endpoint) -> std::optional<Socket> {
+    auto handle = ::socket(endpoint.address.is_ipv4() ? AF_INET : AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == static_cast<decltype(handle)>(-1)) {
+        return std::nullopt;
+    }
+    Socket socket(static_cast<native_socket_handle>(handle), true);
+    if (socket.set_non_blocking(true) != error_code::success) {
+        return std::nullopt;
+    }
+    sockaddr_storage address;
+    socklen_t length;
+    ip_to_sockaddr(endpoint.address, endpoint.port, address, length);
+    if (::connect(handle, reinterpret_cast<const sockaddr*>(&address), length) != 0 && !connect_in_progress()) {
+        return std::nullopt;
+    }
+    return socket;
+}
+
+auto describe(const BackendEndpoint& endpoint) -> std::string {
+    return "[" + endpoint.address.to_string() + "]:" + std::to_string(endpoint.port);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Backends and Sessions
+// ============================================================================
+
+struct TcpProxy::Backend {
+    BackendEndpoint endpoint;
+    std::atomic<bool> healthy{true};
+    std::atomic<uint32_t> outstanding{0};
+    std::atomic<uint32_t> consecutive_failures{0};
+    std::atomic<uint32_t> consecutive_successes{0};
+    std::atomic<uint64_t> sessions{0};
+    std::atomic<uint64_t> connect_failures{0};
+    std::atomic<uint64_t> health_checks_failed{0};
+};
+
+// One direction of a session: bytes read from `from` wait in a pipe (or
+// buffer) until `to` accepts them
+struct Direction {
+    native_socket_handle from = 0;
+    native_socket_handle to = 0;
+    size_t pending = 0;
+    bool eof = false;               // `from` has shut down its write side
+    bool done = false;              // ...and everything was forwarded, `to` shut down in turn
+#if defined(__linux__)
+    int pipe_read = -1;
+    int pipe_write = -1;
+#else
+    std::vector<char> buffer;
+    size_t begin = 0;
+#endif
+
+    Direction() = default;
+    Direction(const Direction&) = delete;
+    Direction& operator=(const Direction&) = delete;
+
+    ~Direction() {
+#if defined(__linux__)
+        if (pipe_read >= 0) ::close(pipe_read);
+        if (pipe_write >= 0) ::close(pipe_write);
+#endif
+    }
+
+    bool open(native_socket_handle source, native_socket_handle destination, size_t buffer_bytes) {
+        from = source;
+        to = destination;
+#if defined(__linux__)
+        (void)buffer_bytes;
+        int fds[2];
+        if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+            return false;
+        }
+        pipe_read = fds[0];
+        pipe_write = fds[1];
+#else
+        buffer.resize(buffer_bytes);
+#endif
+        return true;
+    }
+
+    // Read from the source into the pipe: > 0 bytes, 0 at EOF, < 0 on error
+    auto fill() -> long long {
+#if defined(__linux__)
+        return ::splice(from, nullptr, pipe_write, nullptr, SPLICE_CHUNK, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+#else
+        begin = 0;
+        return ::recv(from, buffer.data(), static_cast<int>(buffer.size()), 0);
+#endif
+    }
+
+    // Write pending bytes to the destination
+    auto drain() -> long long {
+#if defined(__linux__)
+        return ::splice(pipe_read, nullptr, to, nullptr, pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+#else
+        auto sent = ::send(to, buffer.data() + begin, static_cast<int>(pending), MSG_NOSIGNAL);
+        if (sent > 0) {
+            begin += static_cast<size_t>(sent);
+        }
+        return sent;
+#endif
+    }
+};
+
+struct TcpProxy::Session {
+    std::string client_id;
+    native_socket_handle client = 0;
+    Socket backend;
+    native_socket_handle backend_fd = 0;
+    std::optional<size_t> backend_index;
+    std::optional<size_t> failed_backend;      // Not retried for this client
+    uint64_t affinity = 0;                      // Client address hash, for client_hash
+    uint32_t attempts = 0;
+    bool connecting = false;
+    std::chrono::steady_clock::time_point deadline;
+    std::chrono::steady_clock::time_point last_active;
+    Direction upstream;                         // Client -> backend
+    Direction downstream;                       // Backend -> client
+    uint64_t progress = 0;                      // Bytes moved plus EOFs seen
+    int client_interest = -1;                   // Cached poller interest: bit 0 read, bit 1 write
+    int backend_interest = -1;
+};
+
+// ============================================================================
+// I/O Threads
+// ============================================================================
+
+class TcpProxy::IoThread {
+public:
+    explicit IoThread(TcpProxy& owner) : owner_(owner) {}
+    ~IoThread() { stop(); }
+
+    bool start() {
+        if (!poller_.open()) {
+            return false;
+        }
+        running_ = true;
+        thread_ = std::thread(&IoThread::run, this);
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        poller_.wake();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void adopt(std::unique_ptr<Session> session) {
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            pending_.push_back(std::move(session));
+        }
+        poller_.wake();
+    }
+
+private:
+    void run() {
+#ifndef _WIN32
+        // splice has no MSG_NOSIGNAL; a reset peer must surface as EPIPE
+        sigset_t pipe_set;
+        sigemptyset(&pipe_set);
+        sigaddset(&pipe_set, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipe_set, nullptr);
+#endif
+        std::vector<PollEvent> events;
+        auto next_sweep = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+        while (running_) {
+            poller_.wait(events, std::min(TICK_MS, Poller::MAX_WAIT_MS));
+            for (const PollEvent& event : events) {
+                auto it = by_fd_.find(event.fd);
+                if (it != by_fd_.end()) {
+                    on_event(*it->second, event);
+                }
+            }
+            adopt_pending();
+
+            auto now = std::chrono::steady_clock::now();
+            if (connecting_ > 0) {
+                expire_connects(now);
+            }
+            if (now >= next_sweep) {
+                close_idle(now);
+                next_sweep = now + std::chrono::seconds(1);
+            }
+        }
+
+        adopt_pending();
+        while (!sessions_.empty()) {
+            close_session(*sessions_.begin()->second);
+        }
+    }
+
+    void adopt_pending() {
+        std::vector<std::unique_ptr<Session>> adopted;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            adopted.swap(pending_);
+        }
+        for (auto& owned : adopted) {
+            Session& session = *owned;
+            session.last_active = std::chrono::steady_clock::now();
+            sessions_.emplace(owned.get(), std::move(owned));
+            if (!poller_.add(session.client)) {
+                ++owner_.rejected_;
+                close_session(session);
+                continue;
+            }
+            by_fd_[session.client] = &session;
+            set_interest(session.client, session.client_interest, false, false);    // Until the backend is up
+            connect_backend(session);
+        }
+    }
+
+    // Returns false if the session was closed
+    bool connect_backend(Session& session) {
+        const TcpProxyConfig& config = owner_.config_;
+        while (session.attempts < config.connect_attempts) {
+            ++session.attempts;
+            auto index = owner_.choose_backend(session.failed_backend, session.affinity);
+            if (!index) {
+                break;
+            }
+            auto socket = start_connect(owner_.backends_[*index]->endpoint);
+            if (!socket) {
+                owner_.record_connect(*index, false);
+                --owner_.backends_[*index]->outstanding;
+                session.failed_backend = index;
+                continue;
+            }
+            session.backend_index = index;
+            session.backend = std::move(*socket);
+            session.backend_fd = session.backend.get_native_handle();
+            if (!poller_.add(session.backend_fd)) {
+                release_backend(session);
+                break;
+            }
+            by_fd_[session.backend_fd] = &session;
+            session.backend_interest = -1;
+            set_interest(session.backend_fd, session.backend_interest, false, true);
+            session.connecting = true;
+            session.deadline = std::chrono::steady_clock::now() + config.connect_timeout;
+            ++connecting_;
+            return true;
+        }
+        ++owner_.rejected_;
+        close_session(session);
+        return false;
+    }
+
+    void finish_connect(Session& session) {
+        session.connecting = false;
+        --connecting_;
+        if (socket_error(session.backend_fd) != 0) {
+            backend_failed(session);
+            return;
+        }
+        owner_.record_connect(*session.backend_index, true);
+        ++owner_.sessions_;
+        set_no_delay(session.backend_fd);
+        size_t buffer_bytes = owner_.config_.buffer_bytes;
+        if (!session.upstream.open(session.client, session.backend_fd, buffer_bytes) ||
+            !session.downstream.open(session.backend_fd, session.client, buffer_bytes)) {
+            close_session(session);
+            return;
+        }
+        update_interest(session);
+    }
+
+    void backend_failed(Session& session) {
+        if (session.connecting) {
+            session.connecting = false;
+            --connecting_;
+        }
+        owner_.record_connect(*session.backend_index, false);
+        session.failed_backend = session.backend_index;
+        release_backend(session);
+        connect_backend(session);
+    }
+
+    void release_backend(Session& session) {
+        poller_.remove(session.backend_fd);
+        by_fd_.erase(session.backend_fd);
+        session.backend = Socket();
+        session.backend_fd = 0;
+        --owner_.backends_[*session.backend_index]->outstanding;
+        session.backend_index.reset();
+    }
+
+    void close_session(Session& session) {
+        if (session.connecting) {
+            --connecting_;
+        }
+        if (auto it = by_fd_.find(session.client); it != by_fd_.end() && it->second == &session) {
+            poller_.remove(session.client);
+            by_fd_.erase(it);
+        }
+        if (session.backend_index) {
+            release_backend(session);
+        }
+        owner_.server_.close_connection(session.client_id);
+        --owner_.active_sessions_;
+        sessions_.erase(&session);
+    }
+
+    void on_event(Session& session, const PollEvent& event) {
+        bool from_client = event.fd == session.client;
+        if (session.connecting) {
+            if (!from_client) {
+                finish_connect(session);
+            } else if (event.failed) {
+                close_session(session);     // Client gone before the backend answered
+            }
+            return;
+        }
+
+        // Input on this socket feeds one direction; writability drains the other
+        Direction& inbound = from_client ? session.upstream : session.downstream;
+        Direction& outbound = from_client ? session.downstream : session.upstream;
+        uint64_t progress = session.progress;
+        bool ok = true;
+        if (event.readable || event.failed) {
+            ok = pump(session, inbound);
+        }
+        if (ok && (event.writable || event.failed)) {
+            ok = pump(session, outbound);
+        }
+        // A hang-up that moves nothing would otherwise be reported forever
+        if (ok && event.failed && session.progress == progress) {
+            ok = false;
+        }
+
+        if (!ok || (session.upstream.done && session.downstream.done)) {
+            close_session(session);
+            return;
+        }
+        session.last_active = std::chrono::steady_clock::now();
+        update_interest(session);
+    }
+
+    // Move bytes until the source or destination would block; false on a fatal error
+    bool pump(Session& session, Direction& direction) {
+        std::atomic<uint64_t>& counter =
+            &direction == &session.upstream ? owner_.bytes_upstream_ : owner_.bytes_downstream_;
+        for (int round = 0; round < PUMP_ROUNDS && !direction.done; ++round) {
+            while (direction.pending > 0) {
+                auto sent = direction.drain();
+                if (sent < 0) {
+                    if (last_error_interrupted()) {
+                        continue;
+                    }
+                    return last_error_would_block();
+                }
+                direction.pending -= static_cast<size_t>(sent);
+                session.progress += static_cast<uint64_t>(sent);
+                counter += static_cast<uint64_t>(sent);
+#if defined(__linux__)
+                owner_.bytes_spliced_ += static_cast<uint64_t>(sent);
+#endif
+            }
+            if (direction.eof) {
+                shutdown_write(direction.to);
+                direction.done = true;
+                return true;
+            }
+            auto received = direction.fill();
+            if (received < 0) {
+                if (last_error_interrupted()) {
+                    continue;
+                }
+                return last_error_would_block();
+            }
+            if (received == 0) {
+                direction.eof = true;
+                ++session.progress;
+                continue;
+            }
+            direction.pending = static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+    // A socket reads while its inbound direction has room and writes while its outbound one has bytes
+    void update_interest(Session& session) {
+        set_interest(session.client, session.client_interest,
+                     !session.upstream.eof && session.upstream.pending == 0, session.downstream.pending > 0);
+        set_interest(session.backend_fd, session.backend_interest,
+                     !session.downstream.eof && session.downstream.pending == 0, session.upstream.pending > 0);
+    }
+
+    void set_interest(native_socket_handle fd, int& cached, bool read, bool write) {
+        int wanted = (read ? 1 : 0) | (write ? 2 : 0);
+        if (wanted != cached) {
+            poller_.set_interest(fd, read, write);
+            cached = wanted;
+        }
+    }
+
+    void expire_connects(std::chrono::steady_clock::time_point now) {
+        std::vector<Session*> expired;
+        for (auto& [key, session] : sessions_) {
+            if (session->connecting && now >= session->deadline) {
+                expired.push_back(session.get());
+            }
+        }
+        for (Session* session : expired) {
+            backend_failed(*session);
+        }
+    }
+
+    void close_idle(std::chrono::steady_clock::time_point now) {
+        std::vector<Session*> idle;
+        for (auto& [key, session] : sessions_) {
+            if (!session->connecting && now - session->last_active > owner_.config_.idle_timeout) {
+                idle.push_back(session.get());
+            }
+        }
+        for (Session* session : idle) {
+            close_session(*session);
+        }
+    }
+
+    TcpProxy& owner_;
+    Poller poller_;
+    std::unordered_map<Session*, std::unique_ptr<Session>> sessions_;
+    std::unordered_map<native_socket_handle, Session*> by_fd_;     // Client and backend sockets
+    size_t connecting_ = 0;
+    std::mutex pending_mutex_;
+    std::vector<std::unique_ptr<Session>> pending_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+// ============================================================================
+// TcpProxy
+// ============================================================================
+
+TcpProxy::TcpProxy(AsyncDualStackServer& server, TcpProxyConfig config)
+    : server_(server), config_(std::move(config)) {
+    for (const BackendEndpoint& endpoint : config_.backends) {
+        auto backend = std::make_unique<Backend>();
+        backend->endpoint = endpoint;
+        backend_by_name_.emplace(describe(endpoint), backends_.size());
+        backends_.push_back(std::move(backend));
+    }
+    if (config_.balance == BalancePolicy::client_hash) {
+        ring_ = std::make_unique<GalaxyCDN::MaglevRing>();
+    }
+}
+
+TcpProxy::~TcpProxy() {
+    stop();
+}
+
+bool TcpProxy::start() {
+    if (running_) {
+        return true;
+    }
+    if (backends_.empty()) {
+        std::cerr << "❌ TcpProxy has no backends" << std::endl;
+        return false;
+    }
+    size_t threads = config_.io_threads ? config_.io_threads : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < threads; ++i) {
+        auto io_thread = std::make_unique<IoThread>(*this);
+        if (!io_thread->start()) {
+            std::cerr << "❌ Failed to start proxy I/O thread" << std::endl;
+            io_threads_.clear();
+            return false;
+        }
+        io_threads_.push_back(std::move(io_thread));
+    }
+
+    if (ring_ && !ring_->wait_for(ring_->update(healthy_nodes()), std::chrono::seconds(1))) {
+        std::cerr << "⚠️  Client hash table not built yet; balancing by outstanding sessions" << std::endl;
+    }
+    running_ = true;
+    health_thread_ = std::thread(&TcpProxy::health_loop, this);
+    server_.set_connection_handler([this](std::string connection_id, Socket& socket, const IPAddress& address) {
+        adopt(std::move(connection_id), socket, address);
+    });
+    if (!server_.is_running() && !server_.start()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void TcpProxy::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(health_mutex_);
+    }
+    health_cv_.notify_all();
+    if (health_thread_.joinable()) {
+        health_thread_.join();
+    }
+    // I/O threads close their sessions first; the server owns the client sockets
+    for (auto& io_thread : io_threads_) {
+        io_thread->stop();
+    }
+    server_.stop();
+    server_.set_connection_handler(nullptr);
+    io_threads_.clear();
+}
+
+void TcpProxy::adopt(std::string connection_id, Socket& socket, const IPAddress& address) {
+    if (!running_ || socket.set_non_blocking(true) != error_code::success) {
+        server_.close_connection(connection_id);
+        return;
+    }
+    set_no_delay(socket.get_native_handle());
+
+    auto session = std::make_unique<Session>();
+    session->client_id = std::move(connection_id);
+    session->client = socket.get_native_handle();
+    if (ring_) {
+        session->affinity = GalaxyCDN::maglev_hash(address.to_string());
+    }
+    ++active_sessions_;
+    io_threads_[next_thread_++ % io_threads_.size()]->adopt(std::move(session));
+}
+
+std::optional<size_t> TcpProxy::choose_backend(std::optional<size_t> exclude, uint64_t affinity) {
+    if (ring_) {
+        auto table = ring_->table();
+        if (const GalaxyCDN::MaglevNode* node = table->find(affinity)) {
+            size_t index = backend_by_name_.at(node->name);
+            // The table may lag a health change by one rebuild
+            if (backends_[index]->healthy && index != exclude) {
+                ++backends_[index]->outstanding;
+                return index;
+            }
+        }
+    }
+
+    thread_local std::minstd_rand random(std::random_device{}());
+    thread_local std::vector<size_t> candidates;
+    candidates.clear();
+    for (size_t i = 0; i < backends_.size(); ++i) {
+        if (backends_[i]->healthy && i != exclude) {
+            candidates.push_back(i);
+        }
+    }
+    if (candidates.empty()) {
+        return std::nullopt;
+    }
+
+    size_t chosen = candidates[0];
+    if (candidates.size() > 1) {
+        // Two distinct random candidates; the one with fewer outstanding sessions wins
+        size_t first = random() % candidates.size();
+        size_t second = random() % (candidates.size() - 1);
+        if (second >= first) {
+            ++second;
+        }
+        size_t a = candidates[first];
+        size_t b = candidates[second];
+        chosen = backends_[b]->outstanding < backends_[a]->outstanding ? b : a;
+    }
+    ++backends_[chosen]->outstanding;
+    return chosen;
+}
+
+void TcpProxy::record_connect(size_t index, bool connected) {
+    Backend& backend = *backends_[index];
+    if (connected) {
+        ++backend.sessions;
+        backend.consecutive_failures = 0;
+        return;
+    }
+    ++backend.connect_failures;
+    backend.consecutive_successes = 0;
+    if (++backend.consecutive_failures >= config_.health.unhealthy_threshold && backend.healthy.exchange(false)) {
+        std::cerr << "⚠️  Backend " << describe(backend.endpoint) << " marked unhealthy after failed connects"
+                  << std::endl;
+        refresh_ring();
+    }
+}
+
+void TcpProxy::health_loop() {
+    std::unique_lock<std::mutex> lock(health_mutex_);
+    while (running_) {
+        health_cv_.wait_for(lock, config_.health.interval, [this] { return !running_; });
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        run_health_checks();
+        lock.lock();
+    }
+}
+
+// Connect to every backend at once and wait for all of them, up to the timeout
+void TcpProxy::run_health_checks() {
+    std::vector<std::optional<Socket>> probes;
+    for (const auto& backend : backends_) {
+        probes.push_back(start_connect(backend->endpoint));
+    }
+    std::vector<bool> passed(backends_.size(), false);
+    std::vector<bool> finished(backends_.size(), false);
+    for (size_t i = 0; i < probes.size(); ++i) {
+        finished[i] = !probes[i];
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + config_.health.timeout;
+    for (;;) {
+#ifdef _WIN32
+        std::vector<WSAPOLLFD> fds;
+#else
+        std::vector<pollfd> fds;
+#endif
+        std::vector<size_t> owners;
+        for (size_t i = 0; i < probes.size(); ++i) {
+            if (!finished[i]) {
+                fds.push_back({});
+                fds.back().fd = probes[i]->get_native_handle();
+                fds.back().events = POLLOUT;
+                owners.push_back(i);
+            }
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (fds.empty() || remaining.count() <= 0) {
+            break;
+        }
+#ifdef _WIN32
+        int ready = WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), static_cast<int>(remaining.count()));
+#else
+        int ready = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), static_cast<int>(remaining.count()));
+#endif
+        if (ready < 0 && !last_error_interrupted()) {
+            break;
+        }
+        for (size_t j = 0; j < fds.size(); ++j) {
+            if (fds[j].revents != 0) {
+                finished[owners[j]] = true;
+                passed[owners[j]] = socket_error(fds[j].fd) == 0;
+            }
+        }
+    }
+
+    const HealthCheckConfig& health = config_.health;
+    bool changed = false;
+    for (size_t i = 0; i < backends_.size(); ++i) {
+        Backend& backend = *backends_[i];
+        if (passed[i]) {
+            backend.consecutive_failures = 0;
+            if (++backend.consecutive_successes >= health.healthy_threshold && !backend.healthy.exchange(true)) {
+                changed = true;
+                std::cout << "🐍 Backend " << describe(backend.endpoint) << " healthy again" << std::endl;
+            }
+            continue;
+        }
+        ++backend.health_checks_failed;
+        backend.consecutive_successes = 0;
+        if (++backend.consecutive_failures >= health.unhealthy_threshold && backend.healthy.exchange(false)) {
+            changed = true;
+            std::cerr << "⚠️  Backend " << describe(backend.endpoint) << " failed health checks" << std::endl;
+        }
+    }
+    if (changed) {
+        refresh_ring();
+    }
+}
+
+void TcpProxy::refresh_ring() {
+    if (ring_) {
+        ring_->update(healthy_nodes());
+    }
+}
+
+std::vector<GalaxyCDN::MaglevNode> TcpProxy::healthy_nodes() const {
+    std::vector<GalaxyCDN::MaglevNode> nodes;
+    for (const auto& backend : backends_) {
+        if (backend->healthy) {
+            nodes.push_back({describe(backend->endpoint), backend->endpoint.weight});
+        }
+    }
+    return nodes;
+}
+
+TcpProxyStats TcpProxy::get_stats() const {
+    TcpProxyStats stats;
+    stats.sessions = sessions_.load();
+    stats.rejected = rejected_.load();
+    stats.bytes_upstream = bytes_upstream_.load();
+    stats.bytes_downstream = bytes_downstream_.load();
+    stats.bytes_spliced = bytes_spliced_.load();
+    stats.active_sessions = active_sessions_.load();
+    for (const auto& backend : backends_) {
+        BackendStats entry;
+        entry.endpoint = backend->endpoint;
+        entry.healthy = backend->healthy.load();
+        entry.outstanding = backend->outstanding.load();
+        entry.sessions = backend->sessions.load();
+        entry.connect_failures = backend->connect_failures.load();
+        entry.health_checks_failed = backend->health_checks_failed.load();
+        stats.backends.push_back(entry);
+    }
+    return stats;
+}
+
+} // namespace proxy
+} // namespace network
+} // namespace dualstack
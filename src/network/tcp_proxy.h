@@ -0,0 +1,160 @@
+/**
+ * Amphisbaena 🐍 - L4 TCP Proxy
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Pairs each connection accepted by an AsyncDualStackServer with a backend
+ * connection and forwards bytes both ways:
+ *   - on Linux bytes move socket -> pipe -> socket with splice, never
+ *     entering user space; elsewhere through a per-direction buffer
+ *   - half-closes are propagated, so request/response protocols that
+ *     shut down their write side work through the proxy
+ *   - backends are chosen by power-of-two-choices on outstanding sessions,
+ *     or pinned per client address with a Maglev table
+ *   - active TCP health checks, plus passive marking on failed connects
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "async_connection_manager.h"
+#include "galaxycdn_maglev.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace proxy {
+
+struct BackendEndpoint {
+    IPAddress address;
+    port_t port = 0;
+    uint32_t weight = 1;            // Share of the client_hash table
+};
+
+enum class BalancePolicy : uint8_t {
+    least_outstanding,      // Power of two choices on outstanding sessions
+    client_hash             // Maglev on the client address; least_outstanding when its backend is down
+};
+
+/**
+ * @brief Active health checking: a TCP connect to each backend every interval
+ */
+struct AMPHISBAENA_API HealthCheckConfig {
+    std::chrono::milliseconds interval{2000};
+    std::chrono::milliseconds timeout{1000};
+    uint32_t unhealthy_threshold = 3;       // Consecutive failures before a backend is taken out
+    uint32_t healthy_threshold = 2;         // Consecutive successes before it is put back
+};
+
+/**
+ * @brief TCP Proxy Configuration
+ */
+struct AMPHISBAENA_API TcpProxyConfig {
+    std::vector<BackendEndpoint> backends;
+    size_t io_threads = 0;                                  // 0 = one per hardware thread
+    std::chrono::milliseconds connect_timeout{3000};
+    uint32_t connect_attempts = 2;                          // Backends tried per client before giving up
+    BalancePolicy balance = BalancePolicy::least_outstanding;
+    std::chrono::seconds idle_timeout{300};
+    size_t buffer_bytes = 64 * 1024;                        // Per direction, where splice is unavailable
+    HealthCheckConfig health;
+};
+
+/**
+ * @brief Per-backend statistics
+ */
+struct AMPHISBAENA_API BackendStats {
+    BackendEndpoint endpoint;
+    bool healthy = true;
+    uint32_t outstanding = 0;       // Sessions connecting or open
+    uint64_t sessions = 0;          // Sessions established
+    uint64_t connect_failures = 0;
+    uint64_t health_checks_failed = 0;
+};
+
+/**
+ * @brief TCP Proxy Statistics
+ */
+struct AMPHISBAENA_API TcpProxyStats {
+    uint64_t sessions = 0;                  // Client connections paired with a backend
+    uint64_t rejected = 0;                  // Clients closed because no backend could be reached
+    uint64_t bytes_upstream = 0;            // Client -> backend
+    uint64_t bytes_downstream = 0;          // Backend -> client
+    uint64_t bytes_spliced = 0;             // Of the above, moved with splice
+    size_t active_sessions = 0;
+    std::vector<BackendStats> backends;
+};
+
+/**
+ * @brief Layer 4 proxy on an AsyncDualStackServer
+ *
+ * Installs itself as the server's connection handler. Forwarding runs on
+ * the proxy's own non-blocking I/O threads; health checks on one more.
+ */
+class AMPHISBAENA_API TcpProxy {
+public:
+    explicit TcpProxy(AsyncDualStackServer& server, TcpProxyConfig config);
+    ~TcpProxy();
+
+    TcpProxy(const TcpProxy&) = delete;
+    TcpProxy& operator=(const TcpProxy&) = delete;
+
+    // Start the health checker and I/O threads, then the AsyncDualStackServer if it is not running
+    bool start();
+    // Close all sessions and stop the AsyncDualStackServer, which owns the client sockets
+    void stop();
+    bool is_running() const { return running_; }
+
+    TcpProxyStats get_stats() const;
+
+private:
+    class IoThread;
+    struct Session;
+    struct Backend;
+
+    void adopt(std::string connection_id, Socket& socket, const IPAddress& address);
+    // The client's Maglev backend, else power of two choices among healthy backends, skipping `exclude`
+    std::optional<size_t> choose_backend(std::optional<size_t> exclude, uint64_t affinity);
+    void record_connect(size_t backend, bool connected);
+    // Rebuild the client_hash table over the backends now healthy
+    void refresh_ring();
+    std::vector<GalaxyCDN::MaglevNode> healthy_nodes() const;
+    void health_loop();
+    void run_health_checks();
+
+    AsyncDualStackServer& server_;
+    TcpProxyConfig config_;
+    std::vector<std::unique_ptr<Backend>> backends_;
+    std::unique_ptr<GalaxyCDN::MaglevRing> ring_;                       // client_hash only
+    std::unordered_map<std::string, size_t> backend_by_name_;           // Maglev node name -> backends_ index
+    std::vector<std::unique_ptr<IoThread>> io_threads_;
+    std::atomic<size_t> next_thread_{0};
+    std::atomic<bool> running_{false};
+
+    std::thread health_thread_;
+    std::mutex health_mutex_;
+    std::condition_variable health_cv_;
+
+    std::atomic<uint64_t> sessions_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> bytes_upstream_{0};
+    std::atomic<uint64_t> bytes_downstream_{0};
+    std::atomic<uint64_t> bytes_spliced_{0};
+    std::atomic<size_t> active_sessions_{0};
+};
+
+} // namespace proxy
+} // namespace network
+} // namespace dualstack
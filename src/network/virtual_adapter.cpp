@@ -8,6 +8,7 @@
 // Include format header fix BEFORE any standard headers
 #include "../../include/dualstack_net26/fix_format_header.h"
 #include "../../include/dualstack_net26/network/virtual_adapter.h"
+#include "../../include/dualstack_net26/network/netlink.h"
 #include <algorithm>
 #include <random>
 #include <sstream>
@@ -425,27 +426,27 @@ auto VirtualAdapter::disconnect_from_hub() -> void {
 }
 
 auto VirtualAdapter::link_addresses(const ipv4_address& ipv4, const ipv6_address& ipv6) -> void {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
-    ipv4_to_ipv6_map_[ipv4] = ipv6;
-    ipv6_to_ipv4_map_[ipv6] = ipv4;
+    translator_.add_mapping(ipv4, ipv6);
 }
 
 auto VirtualAdapter::get_ipv6_for_ipv4(const ipv4_address& ipv4) -> std::optional<ipv6_address> {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
-    auto it = ipv4_to_ipv6_map_.find(ipv4);
-    if (it != ipv4_to_ipv6_map_.end()) {
-        return it->second;
-    }
-    return std::nullopt;
+    return translator_.find_mapping(ipv4);
 }
 
 auto VirtualAdapter::get_ipv4_for_ipv6(const ipv6_address& ipv6) -> std::optional<ipv4_address> {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
-    auto it = ipv6_to_ipv4_map_.find(ipv6);
-    if (it != ipv6_to_ipv4_map_.end()) {
-        return it->second;
-    }
-    return std::nullopt;
+    return translator_.find_mapping(ipv6);
+}
+
+auto VirtualAdapter::set_translation_prefix(const ipv6_address& prefix, int prefix_length) -> bool {
+    return translator_.set_prefix(prefix, prefix_length);
+}
+
+auto VirtualAdapter::translate_to_ipv6(const PacketBatch& ipv4_packets, PacketBatch& out) -> std::size_t {
+    return translator_.translate_to_ipv6(ipv4_packets, out);
+}
+
+auto VirtualAdapter::translate_to_ipv4(const PacketBatch& ipv6_packets, PacketBatch& out) -> std::size_t {
+    return translator_.translate_to_ipv4(ipv6_packets, out);
 }
 
 auto VirtualAdapter::get_statistics() const -> NetworkInterface {
@@ -512,12 +513,52 @@ auto VirtualAdapterManager::create_virtual_adapter(const VirtualAdapterConfig& c
     
     std::string adapter_id = "vadapter_" + std::to_string(adapter_counter_.fetch_add(1));
     
-    auto adapter = std::make_unique<VirtualAdapter>(adapter_id, config);
+    // Addresses in a VPC come from (or are recorded in) its pool
+    VirtualAdapterConfig adapter_config = config;
+    IpamPool* pool = nullptr;
+    if (config.vpc_id.has_value()) {
+        auto ipam_it = vpc_ipam_.find(config.vpc_id.value());
+        if (ipam_it != vpc_ipam_.end()) {
+            pool = ipam_it->second.get();
+        }
+    }
+    std::optional<ipv4_address> pooled;
+    if (pool && !adapter_config.ipv4_addr.has_value()) {
+        bool dual_stack = pool->is_dual_stack() && !adapter_config.ipv6_addr.has_value();
+        auto lease = dual_stack ? pool->allocate_dual_stack() : pool->allocate();
+        if (!lease.has_value()) {
+            return std::unexpected(std::string(lease.error()));
+        }
+        adapter_config.ipv4_addr = lease->ipv4;
+        adapter_config.ipv4_subnet_mask = pool->subnet_mask();
+        if (!adapter_config.ipv4_gateway.has_value()) {
+            adapter_config.ipv4_gateway = pool->gateway();
+        }
+        if (lease->ipv6.has_value()) {
+            adapter_config.ipv6_addr = lease->ipv6;
+            adapter_config.ipv6_prefix_length = pool->get_config().ipv6_prefix_length;
+        }
+        pooled = lease->ipv4;
+    } else if (pool && pool->contains(adapter_config.ipv4_addr.value())) {
+        auto reserved = pool->reserve(adapter_config.ipv4_addr.value());
+        if (!reserved.has_value()) {
+            return std::unexpected(std::string(reserved.error()));
+        }
+        pooled = adapter_config.ipv4_addr;
+    }
+    
+    auto adapter = std::make_unique<VirtualAdapter>(adapter_id, adapter_config);
     auto enable_result = adapter->enable();
     if (!enable_result.has_value()) {
+        if (pooled.has_value()) {
+            pool->release(pooled.value());
+        }
         return std::unexpected(std::string(enable_result.error()));
     }
     
+    if (pool && adapter_config.ipv4_addr.has_value() && adapter_config.ipv6_addr.has_value()) {
+        adapter->link_addresses(adapter_config.ipv4_addr.value(), adapter_config.ipv6_addr.value());
+    }
     adapters_[adapter_id] = std::move(adapter);
     
     // Register with gateway if available
@@ -536,6 +577,20 @@ auto VirtualAdapterManager::delete_virtual_adapter(const std::string& adapter_id
         return false;
     }
     
+    // Return a VPC address to its pool
+    const auto& config = it->second->get_config();
+    if (config.vpc_id.has_value()) {
+        auto ipam_it = vpc_ipam_.find(config.vpc_id.value());
+        if (ipam_it != vpc_ipam_.end() && config.ipv4_addr.has_value()) {
+            ipam_it->second->release(config.ipv4_addr.value());
+        }
+        auto vpc_it = vpc_adapters_.find(config.vpc_id.value());
+        if (vpc_it != vpc_adapters_.end()) {
+            auto& members = vpc_it->second;
+            members.erase(std::remove(members.begin(), members.end(), adapter_id), members.end());
+        }
+    }
+    
     // Unregister from gateway
     if (gateway_) {
         gateway_->unregister_virtual_adapter(adapter_id);
@@ -629,13 +684,28 @@ auto VirtualAdapterManager::list_hubs() const -> std::vector<std::string> {
     return ids;
 }
 
-auto VirtualAdapterManager::create_vpc(const std::string& vpc_id, const ipv4_address& base_address [[maybe_unused]], int prefix_length [[maybe_unused]]) -> std::expected<void, std::string> {
+auto VirtualAdapterManager::create_vpc(const std::string& vpc_id, const ipv4_address& base_address, int prefix_length,
+                                       std::optional<ipv6_address> ipv6_prefix, int ipv6_prefix_length) -> std::expected<void, std::string> {
     std::lock_guard<std::mutex> lock(manager_mutex_);
     
     if (vpc_adapters_.find(vpc_id) != vpc_adapters_.end()) {
         return std::unexpected(std::string("VPC already exists: " + vpc_id));
     }
     
+    // Prefixes the pool cannot cover still make a VPC, just without address management
+    if (prefix_length >= IpamPool::MIN_PREFIX_LENGTH && prefix_length <= IpamPool::MAX_PREFIX_LENGTH) {
+        IpamConfig ipam_config;
+        ipam_config.base = base_address;
+        ipam_config.prefix_length = prefix_length;
+        ipam_config.ipv6_prefix = ipv6_prefix;
+        ipam_config.ipv6_prefix_length = ipv6_prefix_length;
+        auto pool = IpamPool::create(ipam_config);
+        if (!pool.has_value()) {
+            return std::unexpected(std::string(pool.error()));
+        }
+        vpc_ipam_[vpc_id] = std::move(pool.value());
+    }
+    
     vpc_adapters_[vpc_id] = std::vector<std::string>();
     return {};
 }
@@ -684,6 +754,15 @@ auto VirtualAdapterManager::get_vpc_adapters(const std::string& vpc_id) const ->
     return it->second;
 }
 
+auto VirtualAdapterManager::get_vpc_ipam(const std::string& vpc_id) -> IpamPool* {
+    std::lock_guard<std::mutex> lock(manager_mutex_);
+    auto it = vpc_ipam_.find(vpc_id);
+    if (it == vpc_ipam_.end()) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
 auto VirtualAdapterManager::enumerate_real_adapters() -> std::vector<NetworkInterface> {
     std::vector<NetworkInterface> interfaces;
     
@@ -751,7 +830,13 @@ auto VirtualAdapterManager::enumerate_real_adapters() -> std::vector<NetworkInte
         }
     }
 #else
-    // Linux implementation using getifaddrs
+#ifdef __linux__
+    // One netlink dump covers links, addresses and the default routes behind gateways
+    if (auto state = netlink_dump(); state.has_value()) {
+        return state->to_network_interfaces();
+    }
+#endif
+    // getifaddrs fallback for other Unix systems, or when netlink is unavailable
     struct ifaddrs* ifaddrs_list = nullptr;
     if (getifaddrs(&ifaddrs_list) == 0) {
         std::map<std::string, NetworkInterface*> interface_map;
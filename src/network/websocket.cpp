@@ -0,0 +1,1351 @@
+/**
+ * Amphisbaena 🐍 - WebSocket Layer Implementation
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "websocket.h"
+#include "event_poller.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define DUALSTACK_WS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define DUALSTACK_TARGET_AVX2
+    #else
+        #define DUALSTACK_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define DUALSTACK_WS_SSE2 1
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define DUALSTACK_WS_NEON 1
+    #include <arm_neon.h>
+#endif
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <csignal>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0      // I/O threads block SIGPIPE instead
+#endif
+
+namespace dualstack {
+namespace network {
+namespace websocket {
+
+namespace {
+
+constexpr uint16_t NO_STATUS_RECEIVED = 1005;       // Close frame without a code; never sent on the wire
+constexpr uint16_t ABNORMAL_CLOSURE = 1006;         // Connection lost without a close frame
+constexpr size_t MAX_CONTROL_PAYLOAD = 125;
+constexpr size_t MAX_GATHER = 64;
+constexpr size_t INITIAL_INPUT_BYTES = 4096;
+// Room past the largest message for the next frame's header and interleaved control frames
+constexpr size_t CONTROL_SLACK = 64 * 1024;
+// Fragment ranges held before an unfinished message is compacted into one run
+constexpr size_t MAX_FRAGMENT_RUNS = 64;
+
+constexpr std::string_view GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+auto lower(char c) -> char {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+auto iequals(std::string_view a, std::string_view b) -> bool {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) { return lower(x) == lower(y); });
+}
+
+// Whether a comma-separated header value lists token (case-insensitive)
+auto has_token(std::string_view list, std::string_view token) -> bool {
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) item.remove_prefix(1);
+        while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) item.remove_suffix(1);
+        if (iequals(item, token)) {
+            return true;
+        }
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+    }
+    return false;
+}
+
+// ============================================================================
+// SHA-1 and Base64 (handshake only)
+// ============================================================================
+
+auto rotl(uint32_t value, int bits) -> uint32_t {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+auto sha1(std::string_view text) -> std::array<uint8_t, 20> {
+    std::string message(text);
+    uint64_t bit_length = static_cast<uint64_t>(text.size()) * 8;
+    message.push_back(static_cast<char>(0x80));
+    while (message.size() % 64 != 56) {
+        message.push_back('\0');
+    }
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        message.push_back(static_cast<char>(bit_length >> shift));
+    }
+
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    for (size_t block = 0; block < message.size(); block += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const auto* p = reinterpret_cast<const uint8_t*>(message.data() + block + 4 * i);
+            w[i] = (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | p[3];
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest{};
+    for (int i = 0; i < 20; ++i) {
+        digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - 8 * (i % 4)));
+    }
+    return digest;
+}
+
+constexpr char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+auto base64_encode(std::span<const uint8_t> data) -> std::string {
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3) {
+        uint32_t group = uint32_t{data[i]} << 16;
+        if (i + 1 < data.size()) group |= uint32_t{data[i + 1]} << 8;
+        if (i + 2 < data.size()) group |= data[i + 2];
+        out.push_back(BASE64[(group >> 18) & 0x3F]);
+        out.push_back(BASE64[(group >> 12) & 0x3F]);
+        out.push_back(i + 1 < data.size() ? BASE64[(group >> 6) & 0x3F] : '=');
+        out.push_back(i + 2 < data.size() ? BASE64[group & 0x3F] : '=');
+    }
+    return out;
+}
+
+// Sec-WebSocket-Key must be the base64 encoding of 16 bytes
+auto valid_client_key(std::string_view key) -> bool {
+    if (key.size() != 24 || !key.ends_with("==")) {
+        return false;
+    }
+    return std::all_of(key.begin(), key.end() - 2, [](char c) {
+        return std::memchr(BASE64, c, sizeof(BASE64) - 1) != nullptr;
+    });
+}
+
+// ============================================================================
+// Masking kernels
+// Each masks `length` bytes whose first byte lines up with pattern[0]; the
+// pattern is the (phase-rotated) key repeated eight times.
+// ============================================================================
+
+using MaskKernel = void (*)(std::byte* data, size_t length, const std::byte* pattern);
+
+void mask_scalar(std::byte* data, size_t length, const std::byte* pattern) {
+    uint64_t key;
+    std::memcpy(&key, pattern, sizeof(key));
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        word ^= key;
+        std::memcpy(data + i, &word, sizeof(word));
+    }
+    for (; i < length; ++i) {
+        data[i] ^= pattern[i & 3];
+    }
+}
+
+#if defined(DUALSTACK_WS_SSE2)
+void mask_sse2(std::byte* data, size_t length, const std::byte* pattern) {
+    const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        auto* p = reinterpret_cast<__m128i*>(data + i);
+        __m128i a = _mm_loadu_si128(p);
+        __m128i b = _mm_loadu_si128(p + 1);
+        __m128i c = _mm_loadu_si128(p + 2);
+        __m128i d = _mm_loadu_si128(p + 3);
+        _mm_storeu_si128(p, _mm_xor_si128(a, key));
+        _mm_storeu_si128(p + 1, _mm_xor_si128(b, key));
+        _mm_storeu_si128(p + 2, _mm_xor_si128(c, key));
+        _mm_storeu_si128(p + 3, _mm_xor_si128(d, key));
+    }
+    for (; i + 16 <= length; i += 16) {
+        auto* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), key));
+    }
+    mask_scalar(data + i, length - i, pattern);
+}
+#endif
+
+#if defined(DUALSTACK_WS_X86)
+DUALSTACK_TARGET_AVX2
+void mask_avx2(std::byte* data, size_t length, const std::byte* pattern) {
+    const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern));
+    size_t i = 0;
+    for (; i + 128 <= length; i += 128) {
+        auto* p = reinterpret_cast<__m256i*>(data + i);
+        __m256i a = _mm256_loadu_si256(p);
+        __m256i b = _mm256_loadu_si256(p + 1);
+        __m256i c = _mm256_loadu_si256(p + 2);
+        __m256i d = _mm256_loadu_si256(p + 3);
+        _mm256_storeu_si256(p, _mm256_xor_si256(a, key));
+        _mm256_storeu_si256(p + 1, _mm256_xor_si256(b, key));
+        _mm256_storeu_si256(p + 2, _mm256_xor_si256(c, key));
+        _mm256_storeu_si256(p + 3, _mm256_xor_si256(d, key));
+    }
+    for (; i + 32 <= length; i += 32) {
+        auto* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), key));
+    }
+    mask_scalar(data + i, length - i, pattern);
+}
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif // DUALSTACK_WS_X86
+
+#if defined(DUALSTACK_WS_NEON)
+void mask_neon(std::byte* data, size_t length, const std::byte* pattern) {
+    const uint8x16_t key = vld1q_u8(reinterpret_cast<const uint8_t*>(pattern));
+    auto* bytes = reinterpret_cast<uint8_t*>(data);
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        uint8x16_t a = vld1q_u8(bytes + i);
+        uint8x16_t b = vld1q_u8(bytes + i + 16);
+        uint8x16_t c = vld1q_u8(bytes + i + 32);
+        uint8x16_t d = vld1q_u8(bytes + i + 48);
+        vst1q_u8(bytes + i, veorq_u8(a, key));
+        vst1q_u8(bytes + i + 16, veorq_u8(b, key));
+        vst1q_u8(bytes + i + 32, veorq_u8(c, key));
+        vst1q_u8(bytes + i + 48, veorq_u8(d, key));
+    }
+    for (; i + 16 <= length; i += 16) {
+        vst1q_u8(bytes + i, veorq_u8(vld1q_u8(bytes + i), key));
+    }
+    mask_scalar(data + i, length - i, pattern);
+}
+#endif
+
+auto select_mask_kernel() -> MaskKernel {
+#if defined(DUALSTACK_WS_X86)
+    if (cpu_has_avx2()) {
+        return mask_avx2;
+    }
+#endif
+#if defined(DUALSTACK_WS_SSE2)
+    return mask_sse2;
+#elif defined(DUALSTACK_WS_NEON)
+    return mask_neon;
+#else
+    return mask_scalar;
+#endif
+}
+
+auto valid_close_code(uint16_t code) -> bool {
+    return (code >= 1000 && code <= 1003) || (code >= 1007 && code <= 1011) || (code >= 3000 && code <= 4999);
+}
+
+auto encode_close(uint16_t code, std::string_view reason) -> SharedFrame {
+    std::string payload;
+    if (code != NO_STATUS_RECEIVED) {
+        payload.push_back(static_cast<char>(code >> 8));
+        payload.push_back(static_cast<char>(code & 0xFF));
+        payload.append(reason.substr(0, MAX_CONTROL_PAYLOAD - 2));
+    }
+    return encode_frame(Opcode::close, payload);
+}
+
+auto rejection(uint16_t status) -> SharedFrame {
+    std::string_view line;
+    switch (status) {
+        case 403: line = "HTTP/1.1 403 Forbidden\r\n"; break;
+        case 413: line = "HTTP/1.1 413 Payload Too Large\r\n"; break;
+        case 431: line = "HTTP/1.1 431 Request Header Fields Too Large\r\n"; break;
+        case 501: line = "HTTP/1.1 501 Not Implemented\r\n"; break;
+        case 505: line = "HTTP/1.1 505 HTTP Version Not Supported\r\n"; break;
+        default: line = "HTTP/1.1 400 Bad Request\r\n"; break;
+    }
+    std::string response(line);
+    response.append("Sec-WebSocket-Version: 13\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    return std::make_shared<const std::string>(std::move(response));
+}
+
+} // anonymous namespace
+
+const char* describe(WebSocketError error) {
+    switch (error) {
+        case WebSocketError::incomplete: return "Incomplete frame";
+        case WebSocketError::bad_handshake: return "Not a WebSocket upgrade request";
+        case WebSocketError::protocol_error: return "WebSocket protocol error";
+        case WebSocketError::message_too_big: return "Message too big";
+        case WebSocketError::invalid_utf8: return "Text message is not valid UTF-8";
+    }
+    return "Unknown WebSocket error";
+}
+
+CloseCode close_code_for(WebSocketError error) {
+    switch (error) {
+        case WebSocketError::message_too_big: return CloseCode::message_too_big;
+        case WebSocketError::invalid_utf8: return CloseCode::invalid_payload;
+        default: return CloseCode::protocol_error;
+    }
+}
+
+// ============================================================================
+// Handshake
+// ============================================================================
+
+std::string accept_key(std::string_view client_key) {
+    std::string text(client_key);
+    text.append(GUID);
+    auto digest = sha1(text);
+    return base64_encode(digest);
+}
+
+std::expected<std::string_view, WebSocketError> check_upgrade(const http::HttpRequest& request) {
+    std::string_view key = request.header("sec-websocket-key");
+    if (request.method != "GET" || request.version_minor < 1 || !has_token(request.header("upgrade"), "websocket") ||
+        !has_token(request.header("connection"), "upgrade") || request.header("sec-websocket-version") != "13" ||
+        !valid_client_key(key)) {
+        return std::unexpected(WebSocketError::bad_handshake);
+    }
+    return key;
+}
+
+// ============================================================================
+// Frames
+// ============================================================================
+
+std::expected<size_t, WebSocketError> parse_frame(std::span<std::byte> buffer, Frame& frame, size_t max_payload,
+                                                  bool require_mask) {
+    if (buffer.size() < 2) {
+        return std::unexpected(WebSocketError::incomplete);
+    }
+    auto first = static_cast<uint8_t>(buffer[0]);
+    auto second = static_cast<uint8_t>(buffer[1]);
+    uint8_t opcode = first & 0x0F;
+    bool control = (opcode & 0x08) != 0;
+    size_t length_code = second & 0x7F;
+
+    frame.fin = (first & 0x80) != 0;
+    frame.masked = (second & 0x80) != 0;
+    if ((first & 0x70) != 0 || frame.masked != require_mask) {
+        return std::unexpected(WebSocketError::protocol_error);     // No extensions are negotiated
+    }
+    if (opcode > 0x2 && (opcode < 0x8 || opcode > 0xA)) {
+        return std::unexpected(WebSocketError::protocol_error);
+    }
+    if (control && (!frame.fin || length_code > MAX_CONTROL_PAYLOAD)) {
+        return std::unexpected(WebSocketError::protocol_error);
+    }
+    frame.opcode = static_cast<Opcode>(opcode);
+
+    size_t position = 2;
+    uint64_t length = length_code;
+    if (length_code >= 126) {
+        size_t bytes = length_code == 126 ? 2 : 8;
+        if (buffer.size() < position + bytes) {
+            return std::unexpected(WebSocketError::incomplete);
+        }
+        length = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            length = (length << 8) | static_cast<uint8_t>(buffer[position + i]);
+        }
+        position += bytes;
+        // RFC 6455 section 5.2: the minimal number of bytes must encode the length
+        if ((length >> 63) || (length_code == 126 && length < 126) || (length_code == 127 && length <= 0xFFFF)) {
+            return std::unexpected(WebSocketError::protocol_error);
+        }
+    }
+    if (!control && length > max_payload) {
+        return std::unexpected(WebSocketError::message_too_big);   // Before buffering any of it
+    }
+    if (frame.masked) {
+        if (buffer.size() < position + 4) {
+            return std::unexpected(WebSocketError::incomplete);
+        }
+        std::memcpy(frame.mask.data(), buffer.data() + position, 4);
+        position += 4;
+    }
+    if (buffer.size() - position < length) {
+        return std::unexpected(WebSocketError::incomplete);
+    }
+    frame.payload = buffer.subspan(position, static_cast<size_t>(length));
+    frame.header_size = position;
+    return position + static_cast<size_t>(length);
+}
+
+void apply_mask(std::span<std::byte> data, const MaskKey& mask, size_t phase) {
+    static const MaskKernel kernel = select_mask_kernel();
+    alignas(32) std::byte pattern[32];
+    for (size_t i = 0; i < sizeof(pattern); ++i) {
+        pattern[i] = mask[(phase + i) & 3];
+    }
+    kernel(data.data(), data.size(), pattern);
+}
+
+void write_frame_header(std::string& out, Opcode opcode, uint64_t payload_length, bool fin,
+                        const std::optional<MaskKey>& mask) {
+    char header[14];
+    size_t size = 2;
+    header[0] = static_cast<char>((fin ? 0x80 : 0x00) | static_cast<uint8_t>(opcode));
+    if (payload_length < 126) {
+        header[1] = static_cast<char>(payload_length);
+    } else if (payload_length <= 0xFFFF) {
+        header[1] = 126;
+        header[2] = static_cast<char>(payload_length >> 8);
+        header[3] = static_cast<char>(payload_length);
+        size = 4;
+    } else {
+        header[1] = 127;
+        for (int i = 0; i < 8; ++i) {
+            header[2 + i] = static_cast<char>(payload_length >> (56 - 8 * i));
+        }
+        size = 10;
+    }
+    if (mask) {
+        header[1] = static_cast<char>(header[1] | 0x80);
+        std::memcpy(header + size, mask->data(), 4);
+        size += 4;
+    }
+    out.append(header, size);
+}
+
+SharedFrame encode_frame(Opcode opcode, std::span<const std::byte> payload, bool fin,
+                         const std::optional<MaskKey>& mask) {
+    std::string out;
+    out.reserve(payload.size() + 14);
+    write_frame_header(out, opcode, payload.size(), fin, mask);
+    size_t start = out.size();
+    out.append(reinterpret_cast<const char*>(payload.data()), payload.size());
+    if (mask) {
+        apply_mask(std::span<std::byte>(reinterpret_cast<std::byte*>(out.data()) + start, payload.size()), *mask);
+    }
+    return std::make_shared<const std::string>(std::move(out));
+}
+
+SharedFrame encode_frame(Opcode opcode, std::string_view payload, bool fin, const std::optional<MaskKey>& mask) {
+    return encode_frame(opcode, std::as_bytes(std::span<const char>(payload.data(), payload.size())), fin, mask);
+}
+
+bool Utf8Validator::feed(std::span<const std::byte> data) {
+    const auto* p = reinterpret_cast<const uint8_t*>(data.data());
+    const uint8_t* end = p + data.size();
+    while (p < end) {
+        if (needed_ > 0) {
+            uint8_t byte = *p++;
+            if (byte < lower_ || byte > upper_) {
+                return false;
+            }
+            lower_ = 0x80;
+            upper_ = 0xBF;
+            --needed_;
+            continue;
+        }
+
+        // ASCII runs eight bytes at a time
+        while (end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if (word & 0x8080808080808080ull) {
+                break;
+            }
+            p += 8;
+        }
+        if (p == end) {
+            break;
+        }
+        uint8_t lead = *p++;
+        if (lead < 0x80) {
+            continue;
+        }
+        // Bounds on the second byte exclude overlongs, surrogates and code points above U+10FFFF
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            needed_ = 1;
+        } else if (lead == 0xE0) {
+            needed_ = 2;
+            lower_ = 0xA0;
+        } else if (lead == 0xED) {
+            needed_ = 2;
+            upper_ = 0x9F;
+        } else if (lead >= 0xE1 && lead <= 0xEF) {
+            needed_ = 2;
+        } else if (lead == 0xF0) {
+            needed_ = 3;
+            lower_ = 0x90;
+        } else if (lead >= 0xF1 && lead <= 0xF3) {
+            needed_ = 3;
+        } else if (lead == 0xF4) {
+            needed_ = 3;
+            upper_ = 0x8F;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string Message::to_string() const {
+    std::string text;
+    text.reserve(size);
+    for (std::span<const std::byte> fragment : fragments) {
+        text.append(reinterpret_cast<const char*>(fragment.data()), fragment.size());
+    }
+    return text;
+}
+
+// ============================================================================
+// Connections and I/O Threads
+// ============================================================================
+
+struct WebSocketServer::Connection {
+    std::string id;
+    native_socket_handle fd = 0;
+    bool upgraded = false;
+    std::vector<std::byte> input;
+    size_t input_used = 0;
+    size_t parse_offset = 0;                // Frames before this have been handled
+
+    // Message being reassembled: payload ranges in `input`, kept there until it completes
+    bool in_message = false;
+    Opcode message_opcode = Opcode::binary;
+    size_t message_size = 0;
+    size_t fragment_count = 0;              // Frames in the message, however many runs they now occupy
+    std::vector<std::pair<size_t, size_t>> fragments;
+    std::vector<std::span<const std::byte>> views;
+    Utf8Validator utf8;
+
+    std::deque<SharedFrame> output;         // Queued frames, possibly shared with other connections
+    size_t output_progress = 0;             // Bytes of output.front() already written
+    size_t queued_bytes = 0;
+    bool dirty = false;                     // Queued by the current command batch
+    bool want_write = false;
+    bool close_sent = false;
+    bool closing = false;                   // Close once the output drains
+    uint16_t close_code = ABNORMAL_CLOSURE;
+    std::chrono::steady_clock::time_point accepted;
+    std::chrono::steady_clock::time_point last_active;
+};
+
+class WebSocketServer::IoThread {
+public:
+    struct Command {
+        std::string connection_id;          // Empty for a broadcast
+        SharedFrame frame;
+        bool close_after = false;
+        uint16_t code = 0;
+    };
+
+    explicit IoThread(WebSocketServer& owner) : owner_(owner) {}
+    ~IoThread() { stop(); }
+
+    bool start() {
+        if (!poller_.open()) {
+            return false;
+        }
+        running_ = true;
+        thread_ = std::thread(&IoThread::run, this);
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        poller_.wake();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void adopt(std::unique_ptr<Connection> connection) {
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            pending_.push_back(std::move(connection));
+        }
+        poller_.wake();
+    }
+
+    void post(Command command) {
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            commands_.push_back(std::move(command));
+        }
+        poller_.wake();
+    }
+
+private:
+    void run() {
+#ifndef _WIN32
+        // Platforms without MSG_NOSIGNAL must see a reset peer as EPIPE
+        sigset_t pipe_set;
+        sigemptyset(&pipe_set);
+        sigaddset(&pipe_set, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipe_set, nullptr);
+#endif
+        std::vector<PollEvent> events;
+        auto next_sweep = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+        while (running_) {
+            poller_.wait(events, Poller::MAX_WAIT_MS);
+            for (const PollEvent& event : events) {
+                auto it = connections_.find(event.fd);
+                if (it == connections_.end()) {
+                    continue;
+                }
+                Connection& connection = *it->second;
+                if (event.writable && !flush(connection)) {
+                    continue;
+                }
+                if (event.readable && !connection.want_write) {
+                    on_readable(connection);
+                } else if (event.failed && !event.readable && !event.writable) {
+                    close(connection, ABNORMAL_CLOSURE);
+                }
+            }
+            adopt_pending();
+            run_commands();
+
+            auto now = std::chrono::steady_clock::now();
+            if (now >= next_sweep) {
+                close_idle(now);
+                next_sweep = now + std::chrono::seconds(1);
+            }
+        }
+
+        // Best-effort close frames, then drop whatever is left
+        adopt_pending();
+        std::vector<Connection*> open;
+        for (auto& [fd, connection] : connections_) {
+            open.push_back(connection.get());
+        }
+        for (Connection* connection : open) {
+            if (connection->upgraded) {
+                send_close(*connection, static_cast<uint16_t>(CloseCode::going_away));
+            }
+            connection->closing = true;
+            flush(*connection);
+        }
+        while (!connections_.empty()) {
+            Connection& connection = *connections_.begin()->second;
+            close(connection, connection.close_sent ? connection.close_code : ABNORMAL_CLOSURE);
+        }
+    }
+
+    void adopt_pending() {
+        std::vector<std::unique_ptr<Connection>> adopted;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            adopted.swap(pending_);
+        }
+        for (auto& connection : adopted) {
+            connection->accepted = connection->last_active = std::chrono::steady_clock::now();
+            native_socket_handle fd = connection->fd;
+            if (!poller_.add(fd)) {
+                owner_.release(*connection, ABNORMAL_CLOSURE);
+                continue;
+            }
+            by_id_[connection->id] = connection.get();
+            connections_.emplace(fd, std::move(connection));
+        }
+    }
+
+    // Queue frames posted by other threads (and by handlers); each
+    // connection is flushed once per batch, so the batch leaves in one write
+    void run_commands() {
+        std::vector<Command> commands;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            commands.swap(commands_);
+        }
+        if (commands.empty()) {
+            return;
+        }
+
+        std::vector<Connection*> touched;
+        auto enqueue = [&](Connection& connection, const SharedFrame& frame) {
+            if (!connection.upgraded || connection.close_sent) {
+                return false;
+            }
+            push(connection, frame);
+            ++owner_.frames_sent_;
+            if (!connection.dirty) {
+                connection.dirty = true;
+                touched.push_back(&connection);
+            }
+            return true;
+        };
+        for (const Command& command : commands) {
+            if (command.connection_id.empty()) {
+                for (auto& [fd, connection] : connections_) {
+                    enqueue(*connection, command.frame);
+                }
+                continue;
+            }
+            auto it = by_id_.find(command.connection_id);
+            if (it == by_id_.end()) {
+                continue;
+            }
+            Connection& connection = *it->second;
+            if (enqueue(connection, command.frame) && command.close_after) {
+                connection.close_sent = true;
+                connection.closing = true;
+                connection.close_code = command.code;
+            }
+        }
+        for (Connection* connection : touched) {
+            connection->dirty = false;
+            flush(*connection);
+        }
+    }
+
+    void close_idle(std::chrono::steady_clock::time_point now) {
+        const WebSocketServerConfig& config = owner_.config_;
+        std::vector<Connection*> idle;
+        for (auto& [fd, connection] : connections_) {
+            bool stalled_handshake = !connection->upgraded && now - connection->accepted > config.handshake_timeout;
+            bool idle_connection = connection->output.empty() && now - connection->last_active > config.idle_timeout;
+            if (stalled_handshake || idle_connection) {
+                idle.push_back(connection.get());
+            }
+        }
+        for (Connection* connection : idle) {
+            close(*connection, ABNORMAL_CLOSURE);
+        }
+    }
+
+    void close(Connection& connection, uint16_t code) {
+        native_socket_handle fd = connection.fd;
+        poller_.remove(fd);
+        by_id_.erase(connection.id);
+        owner_.release(connection, code);
+        connections_.erase(fd);
+    }
+
+    void on_readable(Connection& connection) {
+        const WebSocketServerConfig& config = owner_.config_;
+        if (connection.input_used == connection.input.size()) {
+            size_t cap = connection.upgraded ? config.max_message_bytes + CONTROL_SLACK
+                                             : config.handshake_limits.max_header_bytes + 1;
+            if (connection.in_message && connection.input.size() >= cap) {
+                compact_message(connection);        // Only the reassembled payload counts toward the cap
+            }
+            if (connection.input_used < connection.input.size()) {
+                // Compaction made room
+            } else if (connection.input.size() >= cap) {
+                if (!connection.upgraded) {
+                    close(connection, ABNORMAL_CLOSURE);
+                    return;
+                }
+                fail(connection, WebSocketError::message_too_big);
+                flush(connection);
+                return;
+            } else {
+                connection.input.resize(std::min(cap, std::max(connection.input.size() * 2, INITIAL_INPUT_BYTES)));
+            }
+        }
+
+        auto received = ::recv(connection.fd, reinterpret_cast<char*>(connection.input.data() + connection.input_used),
+                               static_cast<int>(connection.input.size() - connection.input_used), 0);
+        if (received < 0 && (last_error_would_block() || last_error_interrupted())) {
+            return;
+        }
+        if (received <= 0) {
+            close(connection, connection.close_sent ? connection.close_code : ABNORMAL_CLOSURE);
+            return;
+        }
+        connection.input_used += static_cast<size_t>(received);
+        connection.last_active = std::chrono::steady_clock::now();
+        owner_.bytes_received_ += static_cast<uint64_t>(received);
+
+        if (!connection.upgraded) {
+            handshake(connection);
+        }
+        if (connection.upgraded && !connection.closing) {
+            read_frames(connection);
+        }
+        if (!connection.output.empty()) {
+            flush(connection);
+        } else if (connection.closing) {
+            close(connection, connection.close_code);
+        }
+    }
+
+    void handshake(Connection& connection) {
+        std::string_view pending(reinterpret_cast<const char*>(connection.input.data()), connection.input_used);
+        auto parsed = http::parse_request(pending, request_, owner_.config_.handshake_limits);
+        if (!parsed) {
+            if (parsed.error() != http::HttpError::incomplete) {
+                reject(connection, http::status_for(parsed.error()));
+            }
+            return;
+        }
+        auto key = check_upgrade(request_);
+        if (!key) {
+            reject(connection, 400);
+            return;
+        }
+
+        // Registered before the open handler runs, so the handler can send
+        {
+            std::lock_guard<std::mutex> lock(owner_.registry_mutex_);
+            owner_.registry_[connection.id] = this;
+        }
+        bool accepted = true;
+        if (owner_.open_handler_) {
+            try {
+                accepted = owner_.open_handler_(connection.id, request_);
+            } catch (const std::exception& e) {
+                std::cerr << "❌ WebSocket open handler error: " << e.what() << std::endl;
+                accepted = false;
+            }
+        }
+        if (!accepted) {
+            {
+                std::lock_guard<std::mutex> lock(owner_.registry_mutex_);
+                owner_.registry_.erase(connection.id);
+            }
+            reject(connection, 403);
+            return;
+        }
+
+        std::string response =
+            "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: ";
+        response.append(accept_key(*key));
+        response.append("\r\n\r\n");
+        push(connection, std::make_shared<const std::string>(std::move(response)));
+        connection.upgraded = true;
+        ++owner_.connections_;
+
+        // Frames may follow the request in the same read
+        std::memmove(connection.input.data(), connection.input.data() + *parsed, connection.input_used - *parsed);
+        connection.input_used -= *parsed;
+    }
+
+    void reject(Connection& connection, uint16_t status) {
+        ++owner_.handshakes_rejected_;
+        push(connection, rejection(status));
+        connection.closing = true;
+    }
+
+    void read_frames(Connection& connection) {
+        const size_t max_message = owner_.config_.max_message_bytes;
+        while (!connection.closing && connection.parse_offset < connection.input_used) {
+            std::span<std::byte> pending(connection.input.data() + connection.parse_offset,
+                                         connection.input_used - connection.parse_offset);
+            Frame frame;
+            size_t limit = connection.in_message ? max_message - connection.message_size : max_message;
+            auto parsed = parse_frame(pending, frame, limit);
+            if (!parsed) {
+                if (parsed.error() != WebSocketError::incomplete) {
+                    fail(connection, parsed.error());
+                }
+                break;
+            }
+            ++owner_.frames_received_;
+            if (frame.masked) {
+                apply_mask(frame.payload, frame.mask);
+            }
+            size_t payload_offset = connection.parse_offset + frame.header_size;
+            connection.parse_offset += *parsed;
+            if (!handle_frame(connection, frame, payload_offset)) {
+                break;
+            }
+        }
+
+        if (connection.in_message && connection.fragments.size() >= MAX_FRAGMENT_RUNS) {
+            compact_message(connection);
+        }
+
+        // Keep an unfinished message's fragments, and any partial frame, at the front of the buffer
+        size_t keep = connection.in_message ? connection.fragments.front().first : connection.parse_offset;
+        if (keep > 0) {
+            std::memmove(connection.input.data(), connection.input.data() + keep, connection.input_used - keep);
+            connection.input_used -= keep;
+            connection.parse_offset -= keep;
+            for (auto& fragment : connection.fragments) {
+                fragment.first -= keep;
+            }
+        }
+    }
+
+    // Squeeze the frame headers and control frames out from between an unfinished
+    // message's fragments, leaving its payload as one run followed by unparsed input
+    void compact_message(Connection& connection) {
+        std::byte* data = connection.input.data();
+        size_t start = connection.fragments.front().first;
+        size_t write = start;
+        for (auto [offset, length] : connection.fragments) {
+            if (offset != write) {
+                std::memmove(data + write, data + offset, length);
+            }
+            write += length;
+        }
+        size_t unparsed = connection.input_used - connection.parse_offset;
+        if (connection.parse_offset != write) {
+            std::memmove(data + write, data + connection.parse_offset, unparsed);
+        }
+        connection.fragments.assign(1, {start, write - start});
+        connection.parse_offset = write;
+        connection.input_used = write + unparsed;
+    }
+
+    // Returns false when no further frames should be read
+    bool handle_frame(Connection& connection, const Frame& frame, size_t payload_offset) {
+        switch (frame.opcode) {
+            case Opcode::text:
+            case Opcode::binary:
+                if (connection.in_message) {
+                    fail(connection, WebSocketError::protocol_error);
+                    return false;
+                }
+                connection.in_message = true;
+                connection.message_opcode = frame.opcode;
+                connection.message_size = 0;
+                connection.fragment_count = 0;
+                connection.utf8.reset();
+                [[fallthrough]];
+            case Opcode::continuation:
+                if (!connection.in_message) {
+                    fail(connection, WebSocketError::protocol_error);
+                    return false;
+                }
+                connection.fragments.emplace_back(payload_offset, frame.payload.size());
+                connection.message_size += frame.payload.size();
+                ++connection.fragment_count;
+                if (connection.message_opcode == Opcode::text && !connection.utf8.feed(frame.payload)) {
+                    fail(connection, WebSocketError::invalid_utf8);
+                    return false;
+                }
+                return !frame.fin || deliver(connection);
+            case Opcode::ping:
+                push(connection, encode_frame(Opcode::pong, frame.payload));
+                ++owner_.frames_sent_;
+                return true;
+            case Opcode::pong:
+                return true;
+            case Opcode::close:
+                on_close_frame(connection, frame.payload);
+                return false;
+        }
+        return true;
+    }
+
+    bool deliver(Connection& connection) {
+        connection.in_message = false;
+        if (connection.message_opcode == Opcode::text && !connection.utf8.complete()) {
+            connection.fragments.clear();
+            fail(connection, WebSocketError::invalid_utf8);
+            return false;
+        }
+        ++owner_.messages_received_;
+        if (connection.fragment_count > 1) {
+            ++owner_.fragmented_messages_;
+        }
+
+        connection.views.clear();
+        for (auto [offset, length] : connection.fragments) {
+            connection.views.emplace_back(connection.input.data() + offset, length);
+        }
+        connection.fragments.clear();
+        if (!owner_.message_handler_) {
+            return true;
+        }
+        Message message;
+        message.opcode = connection.message_opcode;
+        message.fragments = connection.views;
+        message.size = connection.message_size;
+        try {
+            owner_.message_handler_(connection.id, message);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ WebSocket message handler error: " << e.what() << std::endl;
+            send_close(connection, static_cast<uint16_t>(CloseCode::internal_error));
+            return false;
+        }
+        return true;
+    }
+
+    void on_close_frame(Connection& connection, std::span<const std::byte> payload) {
+        uint16_t code = NO_STATUS_RECEIVED;
+        if (payload.size() == 1) {
+            fail(connection, WebSocketError::protocol_error);
+            return;
+        }
+        if (payload.size() >= 2) {
+            code = static_cast<uint16_t>((static_cast<uint8_t>(payload[0]) << 8) | static_cast<uint8_t>(payload[1]));
+            Utf8Validator reason;
+            if (!valid_close_code(code)) {
+                fail(connection, WebSocketError::protocol_error);
+                return;
+            }
+            if (!reason.feed(payload.subspan(2)) || !reason.complete()) {
+                fail(connection, WebSocketError::invalid_utf8);
+                return;
+            }
+        }
+        send_close(connection, code);       // Echo the peer's code
+        connection.close_code = code;
+    }
+
+    void fail(Connection& connection, WebSocketError error) {
+        ++owner_.protocol_errors_;
+        send_close(connection, static_cast<uint16_t>(close_code_for(error)));
+    }
+
+    void send_close(Connection& connection, uint16_t code) {
+        connection.closing = true;
+        if (connection.close_sent) {
+            return;
+        }
+        push(connection, encode_close(code, {}));
+        ++owner_.frames_sent_;
+        connection.close_sent = true;
+        connection.close_code = code;
+    }
+
+    void push(Connection& connection, SharedFrame frame) {
+        connection.queued_bytes += frame->size();
+        connection.output.push_back(std::move(frame));
+    }
+
+    // Advance past `sent` bytes of queued output
+    void advance(Connection& connection, size_t sent) {
+        while (sent > 0) {
+            size_t remaining = connection.output.front()->size() - connection.output_progress;
+            if (sent < remaining) {
+                connection.output_progress += sent;
+                connection.queued_bytes -= sent;
+                return;
+            }
+            sent -= remaining;
+            connection.queued_bytes -= remaining;
+            connection.output.pop_front();
+            connection.output_progress = 0;
+        }
+    }
+
+    // Returns false if the connection was closed
+    bool flush(Connection& connection) {
+        while (!connection.output.empty()) {
+            auto sent = send_gathered(connection);
+            if (sent < 0) {
+                if (last_error_interrupted()) {
+                    continue;
+                }
+                if (last_error_would_block()) {
+                    if (connection.queued_bytes > owner_.config_.max_queued_bytes) {
+                        ++owner_.slow_consumers_;
+                        close(connection, static_cast<uint16_t>(CloseCode::policy_violation));
+                        return false;
+                    }
+                    if (!connection.want_write) {
+                        poller_.watch(connection.fd, true);
+                        connection.want_write = true;
+                    }
+                    return true;
+                }
+                close(connection, ABNORMAL_CLOSURE);
+                return false;
+            }
+            owner_.bytes_sent_ += static_cast<uint64_t>(sent);
+            advance(connection, static_cast<size_t>(sent));
+        }
+
+        connection.last_active = std::chrono::steady_clock::now();
+        if (connection.want_write) {
+            poller_.watch(connection.fd, false);
+            connection.want_write = false;
+        }
+        if (connection.closing) {
+            close(connection, connection.close_code);
+            return false;
+        }
+        return true;
+    }
+
+    // One gathered write of the frames at the head of the queue
+    auto send_gathered(Connection& connection) -> long long {
+        size_t count = 0;
+#ifdef _WIN32
+        WSABUF buffers[MAX_GATHER];
+#else
+        iovec buffers[MAX_GATHER];
+#endif
+        for (auto it = connection.output.begin(); it != connection.output.end() && count < MAX_GATHER; ++it) {
+            const char* data = (*it)->data();
+            size_t length = (*it)->size();
+            if (count == 0) {
+                data += connection.output_progress;
+                length -= connection.output_progress;
+            }
+#ifdef _WIN32
+            buffers[count].buf = const_cast<char*>(data);
+            buffers[count].len = static_cast<ULONG>(length);
+#else
+            buffers[count].iov_base = const_cast<char*>(data);
+            buffers[count].iov_len = length;
+#endif
+            ++count;
+        }
+#ifdef _WIN32
+        DWORD sent = 0;
+        if (WSASend(static_cast<SOCKET>(connection.fd), buffers, static_cast<DWORD>(count), &sent, 0, nullptr,
+                    nullptr) != 0) {
+            return -1;
+        }
+        return static_cast<long long>(sent);
+#else
+        msghdr message{};
+        message.msg_iov = buffers;
+        message.msg_iovlen = count;
+        return ::sendmsg(connection.fd, &message, MSG_NOSIGNAL);
+#endif
+    }
+
+    WebSocketServer& owner_;
+    Poller poller_;
+    std::unordered_map<native_socket_handle, std::unique_ptr<Connection>> connections_;
+    std::unordered_map<std::string, Connection*> by_id_;
+    http::HttpRequest request_;             // Handshake scratch; views into one connection's input
+    std::mutex pending_mutex_;
+    std::vector<std::unique_ptr<Connection>> pending_;
+    std::vector<Command> commands_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+// ============================================================================
+// WebSocketServer
+// ============================================================================
+
+WebSocketServer::WebSocketServer(AsyncDualStackServer& server, WebSocketServerConfig config)
+    : server_(server), config_(std::move(config)) {}
+
+WebSocketServer::~WebSocketServer() {
+    stop();
+}
+
+void WebSocketServer::set_open_handler(OpenHandler handler) {
+    open_handler_ = std::move(handler);
+}
+
+void WebSocketServer::set_message_handler(MessageHandler handler) {
+    message_handler_ = std::move(handler);
+}
+
+void WebSocketServer::set_close_handler(CloseHandler handler) {
+    close_handler_ = std::move(handler);
+}
+
+bool WebSocketServer::start() {
+    if (running_) {
+        return true;
+    }
+    size_t threads = config_.io_threads ? config_.io_threads : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < threads; ++i) {
+        auto io_thread = std::make_unique<IoThread>(*this);
+        if (!io_thread->start()) {
+            std::cerr << "❌ Failed to start WebSocket I/O thread" << std::endl;
+            io_threads_.clear();
+            return false;
+        }
+        io_threads_.push_back(std::move(io_thread));
+    }
+
+    running_ = true;
+    server_.set_connection_handler([this](std::string connection_id, Socket& socket, const IPAddress&) {
+        adopt(std::move(connection_id), socket);
+    });
+    if (!server_.is_running() && !server_.start()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void WebSocketServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // I/O threads close their connections first; the server owns the sockets
+    for (auto& io_thread : io_threads_) {
+        io_thread->stop();
+    }
+    server_.stop();
+    server_.set_connection_handler(nullptr);
+
+    std::vector<std::unique_ptr<IoThread>> stopped;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        registry_.clear();
+        stopped.swap(io_threads_);
+    }
+}
+
+bool WebSocketServer::send(const std::string& connection_id, SharedFrame frame) {
+    if (!frame) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto it = registry_.find(connection_id);
+    if (!running_ || it == registry_.end()) {
+        return false;
+    }
+    it->second->post({connection_id, std::move(frame)});
+    return true;
+}
+
+bool WebSocketServer::send_text(const std::string& connection_id, std::string_view text) {
+    return send(connection_id, encode_frame(Opcode::text, text));
+}
+
+bool WebSocketServer::send_binary(const std::string& connection_id, std::span<const std::byte> data) {
+    return send(connection_id, encode_frame(Opcode::binary, data));
+}
+
+size_t WebSocketServer::broadcast(SharedFrame frame) {
+    if (!frame) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    if (!running_) {
+        return 0;
+    }
+    ++broadcasts_;
+    for (auto& io_thread : io_threads_) {
+        io_thread->post({{}, frame});
+    }
+    return io_threads_.size();
+}
+
+bool WebSocketServer::close(const std::string& connection_id, CloseCode code, std::string_view reason) {
+    auto frame = encode_close(static_cast<uint16_t>(code), reason);
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto it = registry_.find(connection_id);
+    if (!running_ || it == registry_.end()) {
+        return false;
+    }
+    it->second->post({connection_id, std::move(frame), true, static_cast<uint16_t>(code)});
+    return true;
+}
+
+void WebSocketServer::adopt(std::string connection_id, Socket& socket) {
+    if (!running_ || socket.set_non_blocking(true) != error_code::success) {
+        server_.close_connection(connection_id);
+        return;
+    }
+    int no_delay = 1;
+    ::setsockopt(socket.get_native_handle(), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay),
+                 sizeof(no_delay));
+
+    auto connection = std::make_unique<Connection>();
+    connection->id = std::move(connection_id);
+    connection->fd = socket.get_native_handle();
+    connection->input.resize(INITIAL_INPUT_BYTES);
+    ++open_connections_;
+    io_threads_[next_thread_++ % io_threads_.size()]->adopt(std::move(connection));
+}
+
+void WebSocketServer::release(Connection& connection, uint16_t code) {
+    server_.close_connection(connection.id);
+    --open_connections_;
+    if (!connection.upgraded) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        registry_.erase(connection.id);
+    }
+    if (close_handler_) {
+        try {
+            close_handler_(connection.id, code);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ WebSocket close handler error: " << e.what() << std::endl;
+        }
+    }
+}
+
+WebSocketStats WebSocketServer::get_stats() const {
+    WebSocketStats stats;
+    stats.connections = connections_.load();
+    stats.handshakes_rejected = handshakes_rejected_.load();
+    stats.frames_received = frames_received_.load();
+    stats.messages_received = messages_received_.load();
+    stats.fragmented_messages = fragmented_messages_.load();
+    stats.frames_sent = frames_sent_.load();
+    stats.bytes_received = bytes_received_.load();
+    stats.bytes_sent = bytes_sent_.load();
+    stats.broadcasts = broadcasts_.load();
+    stats.protocol_errors = protocol_errors_.load();
+    stats.slow_consumers = slow_consumers_.load();
+    stats.open_connections = open_connections_.load();
+    return stats;
+}
+
+} // namespace websocket
+} // namespace network
+} // namespace dualstack
@@ -0,0 +1,282 @@
+/**
+ * Amphisbaena 🐍 - WebSocket Layer (RFC 6455)
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * WebSocket on top of AsyncDualStackServer connections:
+ *   - upgrade handshake parsed with the HTTP/1.1 request parser
+ *   - zero-copy frame parser over the connection receive buffer; payloads
+ *     are unmasked in place (AVX2 selected at runtime, SSE2 / NEON otherwise)
+ *   - fragmented messages are delivered as a chain of payload views into
+ *     the receive buffer, never copied into one contiguous buffer
+ *   - outbound frames queued in one I/O pass leave in one gathered write
+ *   - broadcast encodes a frame once; every connection queues a reference
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ */
+
+#pragma once
+
+// Include format header fix BEFORE any standard headers to prevent GCC 14.2.0 format header bug
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "async_connection_manager.h"
+#include "http_server.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dualstack {
+namespace network {
+namespace websocket {
+
+enum class Opcode : uint8_t {
+    continuation = 0x0,
+    text = 0x1,
+    binary = 0x2,
+    close = 0x8,
+    ping = 0x9,
+    pong = 0xA
+};
+
+enum class CloseCode : uint16_t {
+    normal = 1000,
+    going_away = 1001,
+    protocol_error = 1002,
+    unsupported_data = 1003,
+    invalid_payload = 1007,         // Text message that is not UTF-8
+    policy_violation = 1008,
+    message_too_big = 1009,
+    internal_error = 1011
+};
+
+enum class WebSocketError : uint8_t {
+    incomplete,             // Need more bytes; not an error on the connection
+    bad_handshake,          // Not a valid version 13 upgrade request
+    protocol_error,         // Reserved bits, unknown opcode, unmasked client frame, bad control frame
+    message_too_big,
+    invalid_utf8
+};
+
+AMPHISBAENA_API const char* describe(WebSocketError error);
+AMPHISBAENA_API CloseCode close_code_for(WebSocketError error);
+
+using MaskKey = std::array<std::byte, 4>;
+
+// ============================================================================
+// Handshake
+// ============================================================================
+
+/**
+ * @brief Sec-WebSocket-Accept value for a client's Sec-WebSocket-Key
+ */
+AMPHISBAENA_API std::string accept_key(std::string_view client_key);
+
+/**
+ * @brief Check that a parsed request is a version 13 upgrade
+ * @return The client's Sec-WebSocket-Key
+ */
+AMPHISBAENA_API std::expected<std::string_view, WebSocketError> check_upgrade(const http::HttpRequest& request);
+
+// ============================================================================
+// Frames
+// ============================================================================
+
+/**
+ * @brief One parsed frame; payload points into the parsed buffer
+ */
+struct AMPHISBAENA_API Frame {
+    bool fin = true;
+    Opcode opcode = Opcode::binary;
+    bool masked = false;
+    MaskKey mask{};
+    std::span<std::byte> payload;   // Still masked if `masked`
+    size_t header_size = 0;
+};
+
+/**
+ * @brief Parse one frame from the start of buffer
+ * @param require_mask Servers require masked frames, clients unmasked ones
+ * @return Bytes consumed (header + payload); WebSocketError::incomplete if the buffer ends first
+ */
+AMPHISBAENA_API std::expected<size_t, WebSocketError> parse_frame(std::span<std::byte> buffer, Frame& frame,
+                                                                  size_t max_payload, bool require_mask = true);
+
+/**
+ * @brief XOR data with a repeating mask key in place (masking and unmasking are the same)
+ * @param phase Offset of data[0] within the masked payload, for payloads processed in pieces
+ */
+AMPHISBAENA_API void apply_mask(std::span<std::byte> data, const MaskKey& mask, size_t phase = 0);
+
+/**
+ * @brief Append a frame header to out
+ */
+AMPHISBAENA_API void write_frame_header(std::string& out, Opcode opcode, uint64_t payload_length, bool fin = true,
+                                        const std::optional<MaskKey>& mask = std::nullopt);
+
+// Encoded outbound frame; immutable, so one copy can be queued on any number of connections
+using SharedFrame = std::shared_ptr<const std::string>;
+
+/**
+ * @brief Encode a complete frame (clients pass a mask, servers do not)
+ */
+AMPHISBAENA_API SharedFrame encode_frame(Opcode opcode, std::span<const std::byte> payload, bool fin = true,
+                                         const std::optional<MaskKey>& mask = std::nullopt);
+AMPHISBAENA_API SharedFrame encode_frame(Opcode opcode, std::string_view payload, bool fin = true,
+                                         const std::optional<MaskKey>& mask = std::nullopt);
+
+/**
+ * @brief Incremental UTF-8 validator; text messages arrive in fragments
+ */
+class AMPHISBAENA_API Utf8Validator {
+public:
+    bool feed(std::span<const std::byte> data);
+    bool complete() const { return needed_ == 0; }
+    void reset() { needed_ = 0; lower_ = 0x80; upper_ = 0xBF; }
+
+private:
+    uint8_t needed_ = 0;            // Continuation bytes still expected
+    uint8_t lower_ = 0x80;          // Bounds for the next continuation byte
+    uint8_t upper_ = 0xBF;
+};
+
+// ============================================================================
+// Server
+// ============================================================================
+
+/**
+ * @brief A complete data message; fragments point into the connection's
+ * receive buffer and are valid only during the message handler. Runs of
+ * frames the buffer had to squeeze together arrive as one fragment.
+ */
+struct AMPHISBAENA_API Message {
+    Opcode opcode = Opcode::binary;     // text or binary
+    std::span<const std::span<const std::byte>> fragments;
+    size_t size = 0;
+
+    // Copies the fragments into one string
+    std::string to_string() const;
+};
+
+/**
+ * @brief WebSocket Server Configuration
+ */
+struct AMPHISBAENA_API WebSocketServerConfig {
+    size_t io_threads = 0;                              // 0 = one per hardware thread
+    size_t max_message_bytes = 16 * 1024 * 1024;        // Also the largest single frame
+    size_t max_queued_bytes = 8 * 1024 * 1024;          // Outbound backlog before a slow reader is dropped
+    http::HttpLimits handshake_limits{8 * 1024, 0};
+    std::chrono::seconds handshake_timeout{10};
+    std::chrono::seconds idle_timeout{120};
+};
+
+/**
+ * @brief WebSocket Server Statistics
+ */
+struct AMPHISBAENA_API WebSocketStats {
+    uint64_t connections = 0;           // Completed handshakes
+    uint64_t handshakes_rejected = 0;
+    uint64_t frames_received = 0;
+    uint64_t messages_received = 0;
+    uint64_t fragmented_messages = 0;
+    uint64_t frames_sent = 0;
+    uint64_t bytes_received = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t broadcasts = 0;
+    uint64_t protocol_errors = 0;
+    uint64_t slow_consumers = 0;        // Dropped for exceeding max_queued_bytes
+    size_t open_connections = 0;
+};
+
+/**
+ * @brief WebSocket server on an AsyncDualStackServer
+ *
+ * Installs itself as the server's connection handler and runs accepted
+ * sockets non-blocking on its own I/O threads. Handlers run on those
+ * threads and must not block; send(), broadcast() and close() may be
+ * called from any thread, including from inside a handler.
+ */
+class AMPHISBAENA_API WebSocketServer {
+public:
+    // Return false to refuse the upgrade (answered with 403)
+    using OpenHandler = std::function<bool(const std::string& connection_id, const http::HttpRequest& request)>;
+    using MessageHandler = std::function<void(const std::string& connection_id, const Message& message)>;
+    using CloseHandler = std::function<void(const std::string& connection_id, uint16_t code)>;
+
+    explicit WebSocketServer(AsyncDualStackServer& server, WebSocketServerConfig config = {});
+    ~WebSocketServer();
+
+    WebSocketServer(const WebSocketServer&) = delete;
+    WebSocketServer& operator=(const WebSocketServer&) = delete;
+
+    void set_open_handler(OpenHandler handler);
+    void set_message_handler(MessageHandler handler);
+    void set_close_handler(CloseHandler handler);
+
+    // Start the I/O threads, then the AsyncDualStackServer if it is not running
+    bool start();
+    // Close WebSocket connections and stop the AsyncDualStackServer, which owns their sockets
+    void stop();
+    bool is_running() const { return running_; }
+
+    // Queue a frame; false if the connection is unknown
+    bool send(const std::string& connection_id, SharedFrame frame);
+    bool send_text(const std::string& connection_id, std::string_view text);
+    bool send_binary(const std::string& connection_id, std::span<const std::byte> data);
+
+    // Queue one encoded frame on every open connection; returns the number of I/O threads reached
+    size_t broadcast(SharedFrame frame);
+
+    // Send a close frame, then close once it has been written
+    bool close(const std::string& connection_id, CloseCode code = CloseCode::normal, std::string_view reason = {});
+
+    WebSocketStats get_stats() const;
+
+private:
+    class IoThread;
+    struct Connection;
+
+    void adopt(std::string connection_id, Socket& socket);
+    void release(Connection& connection, uint16_t code);
+
+    AsyncDualStackServer& server_;
+    WebSocketServerConfig config_;
+    OpenHandler open_handler_;
+    MessageHandler message_handler_;
+    CloseHandler close_handler_;
+    std::vector<std::unique_ptr<IoThread>> io_threads_;
+    std::atomic<size_t> next_thread_{0};
+    std::atomic<bool> running_{false};
+
+    // Connection id -> owning I/O thread, for sends from other threads
+    std::mutex registry_mutex_;
+    std::unordered_map<std::string, IoThread*> registry_;
+
+    std::atomic<uint64_t> connections_{0};
+    std::atomic<uint64_t> handshakes_rejected_{0};
+    std::atomic<uint64_t> frames_received_{0};
+    std::atomic<uint64_t> messages_received_{0};
+    std::atomic<uint64_t> fragmented_messages_{0};
+    std::atomic<uint64_t> frames_sent_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> broadcasts_{0};
+    std::atomic<uint64_t> protocol_errors_{0};
+    std::atomic<uint64_t> slow_consumers_{0};
+    std::atomic<size_t> open_connections_{0};
+};
+
+} // namespace websocket
+} // namespace network
+} // namespace dualstack
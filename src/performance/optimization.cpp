@@ -86,10 +86,15 @@ auto simd_validate_packets(std::span<const Packet> packets) -> bool {
 #endif // __cpp_lib_hazard_pointers
 
 // Thread pool implementation
+namespace {
+thread_local const thread_pool* current_pool = nullptr;     // Pool whose worker this thread is
+}
+
 thread_pool::thread_pool(std::size_t num_threads) {
     stop_ = false;
     for (std::size_t i = 0; i < num_threads; ++i) {
         workers_.emplace_back([this] {
+            current_pool = this;
             while (true) {
                 std::function<void()> task;
                 
@@ -117,6 +122,10 @@ thread_pool::~thread_pool() {
     }
 }
 
+auto thread_pool::is_worker() const -> bool {
+    return current_pool == this;
+}
+
 // enqueue is now defined inline in the header
 
 // Memory pool implementation
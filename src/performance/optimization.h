@@ -166,6 +166,11 @@ public:
     explicit thread_pool(std::size_t num_threads = std::thread::hardware_concurrency());
     ~thread_pool();
     
+    auto size() const -> std::size_t { return workers_.size(); }
+    // True on one of this pool's workers: a task that waits on work queued to
+    // the same pool from there can deadlock it
+    auto is_worker() const -> bool;
+    
     template<typename F>
     auto enqueue(F&& f) -> std::future<std::invoke_result_t<F>> {
         using return_type = std::invoke_result_t<F>;
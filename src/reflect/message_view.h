@@ -0,0 +1,655 @@
+#pragma once
+
+// Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+
+#include "serializer.h"
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Zero-copy message views driven by the reflect(Reflection&) hooks
+//
+// Message layout (little-endian; offsets are relative to the start of the
+// message they appear in):
+//
+//   u32 fixed size | one slot per reflected member, in order | data
+//
+// Booleans, integers, enums, floats, durations and time points live in their
+// slot at full width (durations as int64 ticks, time points as int64 ms).
+// Strings, text values, vectors and nested structs take an 8-byte slot
+// {u32 offset, u32 length} into the data area: the byte length for strings
+// and structs, the element count for vectors. Vector elements are slots laid
+// out back to back; a nested struct is a complete message of its own.
+//
+// References are 32-bit, so building a message whose data area passes 4 GiB
+// fails with SerialError::too_large.
+//
+// Slot offsets come from the reflect hook at compile time. validate() checks
+// every reference once, after which view.get<&Msg::member>() is a direct load
+// from the received buffer. Members appended to a schema fall beyond an older
+// sender's fixed size and read as value-initialized.
+//
+// Schemas must be default-constructible in constant expressions (plain
+// structs of the member types above; maps have no view form).
+
+namespace dualstack::reflect {
+
+template<typename T> class MessageView;
+template<typename Item> class ListView;
+
+namespace detail {
+
+inline constexpr std::size_t VIEW_HEADER_SIZE = 4;
+inline constexpr std::size_t VIEW_REF_SIZE = 8;
+inline constexpr std::size_t NOT_REFLECTED = static_cast<std::size_t>(-1);
+
+// A message with no fields; views of absent nested members point here
+inline constexpr std::array<std::byte, VIEW_HEADER_SIZE> EMPTY_MESSAGE{};
+
+template<typename T> struct member_pointer_traits;
+template<typename C, typename M>
+struct member_pointer_traits<M C::*> {
+    using owner = C;
+    using member = M;
+};
+
+template<typename V>
+constexpr auto is_view_scalar() -> bool {
+    constexpr Kind kind = kind_of<V>();
+    return kind == Kind::boolean || kind == Kind::enumeration || kind == Kind::integer ||
+           kind == Kind::floating || kind == Kind::duration || kind == Kind::time_point;
+}
+
+template<typename V>
+constexpr auto slot_size() -> std::size_t {
+    constexpr Kind kind = kind_of<V>();
+    static_assert(kind != Kind::string_map && kind != Kind::unsupported, "member type has no message view form");
+    if constexpr (kind == Kind::boolean) return 1;
+    else if constexpr (kind == Kind::enumeration || kind == Kind::integer || kind == Kind::floating) return sizeof(V);
+    else if constexpr (kind == Kind::duration || kind == Kind::time_point) return 8;
+    else if constexpr (kind == Kind::fixed_array) {
+        static_assert(is_view_scalar<typename V::value_type>(), "message views hold arrays of scalars only");
+        return std::tuple_size_v<V> * slot_size<typename V::value_type>();
+    } else {
+        return VIEW_REF_SIZE;
+    }
+}
+
+// Slots whose bytes validate() has to look at
+template<typename V>
+constexpr auto slot_needs_check() -> bool {
+    constexpr Kind kind = kind_of<V>();
+    if constexpr (kind == Kind::boolean) return true;
+    else if constexpr (kind == Kind::fixed_array) return kind_of<typename V::value_type>() == Kind::boolean;
+    else return !is_view_scalar<V>();
+}
+
+template<typename V>
+constexpr auto view_type_tag() {
+    constexpr Kind kind = kind_of<V>();
+    if constexpr (kind == Kind::string || kind == Kind::text) return std::type_identity<std::string_view>{};
+    else if constexpr (kind == Kind::sequence) return std::type_identity<ListView<typename V::value_type>>{};
+    else if constexpr (kind == Kind::structure) return std::type_identity<MessageView<V>>{};
+    else return std::type_identity<V>{};
+}
+
+// What get() returns for a member of type V
+template<typename V>
+using view_t = typename decltype(view_type_tag<V>())::type;
+
+inline auto load_le(const std::byte* in, std::size_t width) -> std::uint64_t {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < width; ++i) {
+        value |= std::to_integer<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+inline void store_le(std::byte* out, std::uint64_t value, std::size_t width) {
+    for (std::size_t i = 0; i < width; ++i) {
+        out[i] = static_cast<std::byte>(value >> (8 * i));
+    }
+}
+
+// ============================================================================
+// Compile-time layout
+// ============================================================================
+
+struct SlotCounter {
+    std::size_t count = 0;
+    std::size_t size = 0;
+
+    template<typename V>
+    constexpr void reflect(V&, std::string_view) {
+        ++count;
+        size += slot_size<V>();
+    }
+};
+
+template<std::size_t N>
+struct SlotOffsets {
+    std::array<std::size_t, N> offsets{};
+    std::size_t index = 0;
+    std::size_t next = 0;
+
+    template<typename V>
+    constexpr void reflect(V&, std::string_view) {
+        offsets[index++] = next;
+        next += slot_size<V>();
+    }
+};
+
+struct MemberFinder {
+    const void* target;
+    std::size_t index = 0;
+    std::size_t found = NOT_REFLECTED;
+
+    template<typename V>
+    constexpr void reflect(V& member, std::string_view) {
+        if (static_cast<const void*>(&member) == target) {
+            found = index;
+        }
+        ++index;
+    }
+};
+
+template<typename T>
+struct MessageLayout {
+    static constexpr SlotCounter counted = [] {
+        T prototype{};
+        SlotCounter counter;
+        prototype.reflect(counter);
+        return counter;
+    }();
+
+    static constexpr std::size_t field_count = counted.count;
+    static constexpr std::size_t fixed_size = counted.size;
+
+    static constexpr std::array<std::size_t, field_count> offsets = [] {
+        T prototype{};
+        SlotOffsets<field_count> slots;
+        prototype.reflect(slots);
+        return slots.offsets;
+    }();
+
+    template<auto Member>
+    static constexpr std::size_t index_of = [] {
+        T prototype{};
+        MemberFinder finder{static_cast<const void*>(&(prototype.*Member))};
+        prototype.reflect(finder);
+        return finder.found;
+    }();
+};
+
+// Instance whose reflect hook drives the runtime walks; never written
+template<typename T>
+auto prototype() -> T& {
+    static T instance{};
+    return instance;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+struct ViewAccess {
+    template<typename T>
+    static auto message(std::span<const std::byte> data) -> MessageView<T> {
+        return MessageView<T>(data);
+    }
+
+    template<typename Item>
+    static auto list(std::span<const std::byte> message, std::size_t offset, std::size_t count) -> ListView<Item> {
+        return ListView<Item>(message, offset, count);
+    }
+};
+
+// Slot at byte position `at` of an already validated message
+template<typename V>
+auto read_slot(std::span<const std::byte> message, std::size_t at) -> view_t<V> {
+    constexpr Kind kind = kind_of<V>();
+    const std::byte* in = message.data() + at;
+    if constexpr (kind == Kind::boolean) {
+        return *in != std::byte{0};
+    } else if constexpr (kind == Kind::enumeration || kind == Kind::integer) {
+        return static_cast<V>(static_cast<integer_of<V>>(load_le(in, sizeof(V))));
+    } else if constexpr (kind == Kind::floating) {
+        return std::bit_cast<V>(static_cast<float_bits<V>>(load_le(in, sizeof(V))));
+    } else if constexpr (kind == Kind::duration) {
+        return V(static_cast<typename V::rep>(static_cast<std::int64_t>(load_le(in, 8))));
+    } else if constexpr (kind == Kind::time_point) {
+        return from_epoch_millis<V>(static_cast<std::int64_t>(load_le(in, 8)));
+    } else if constexpr (kind == Kind::fixed_array) {
+        using Item = typename V::value_type;
+        V value{};
+        for (std::size_t i = 0; i < value.size(); ++i) {
+            value[i] = read_slot<Item>(message, at + i * slot_size<Item>());
+        }
+        return value;
+    } else {
+        auto offset = static_cast<std::size_t>(load_le(in, 4));
+        auto length = static_cast<std::size_t>(load_le(in + 4, 4));
+        if constexpr (kind == Kind::string || kind == Kind::text) {
+            return std::string_view(reinterpret_cast<const char*>(message.data() + offset), length);
+        } else if constexpr (kind == Kind::sequence) {
+            return ViewAccess::list<typename V::value_type>(message, offset, length);
+        } else {
+            return ViewAccess::message<V>(message.subspan(offset, length));
+        }
+    }
+}
+
+// Owning copy of a slot
+template<typename V>
+void materialize_slot(std::span<const std::byte> message, std::size_t at, V& value) {
+    constexpr Kind kind = kind_of<V>();
+    if constexpr (kind == Kind::string) {
+        value = std::string(read_slot<V>(message, at));
+    } else if constexpr (kind == Kind::text) {
+        if (auto parsed = V::from_string(read_slot<V>(message, at))) {
+            value = *parsed;
+        }
+    } else if constexpr (kind == Kind::sequence) {
+        auto list = read_slot<V>(message, at);
+        value.clear();
+        value.reserve(list.size());
+        for (std::size_t i = 0; i < list.size(); ++i) {
+            typename V::value_type item{};
+            materialize_slot(message, list.slot_offset(i), item);
+            value.push_back(std::move(item));
+        }
+    } else if constexpr (kind == Kind::structure) {
+        value = read_slot<V>(message, at).decode();
+    } else {
+        value = read_slot<V>(message, at);
+    }
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+class ViewEncoder {
+public:
+    explicit ViewEncoder(std::vector<std::byte>& out) : out_(out) {}
+
+    // Append value as a message; returns where it starts
+    template<typename T>
+    auto message(const T& value) -> std::size_t {
+        using Layout = MessageLayout<T>;
+        std::size_t base = out_.size();
+        out_.resize(base + VIEW_HEADER_SIZE + Layout::fixed_size);
+        store_le(out_.data() + base, Layout::fixed_size, 4);
+        SlotWriter writer{*this, base, base + VIEW_HEADER_SIZE};
+        const_cast<T&>(value).reflect(writer);
+        return base;
+    }
+
+    auto ok() const -> bool { return !error_; }
+    auto error() const -> SerialError { return error_.value_or(SerialError::too_large); }
+
+private:
+    struct SlotWriter {
+        ViewEncoder& encoder;
+        std::size_t base;
+        std::size_t cursor;
+
+        template<typename V>
+        void reflect(V& value, std::string_view) {
+            encoder.slot(cursor, base, value);
+            cursor += slot_size<V>();
+        }
+    };
+
+    template<typename V>
+    void slot(std::size_t at, std::size_t base, const V& value) {
+        constexpr Kind kind = kind_of<V>();
+        if constexpr (kind == Kind::boolean) {
+            out_[at] = value ? std::byte{1} : std::byte{0};
+        } else if constexpr (kind == Kind::enumeration || kind == Kind::integer) {
+            store_le(out_.data() + at, static_cast<std::uint64_t>(static_cast<integer_of<V>>(value)), sizeof(V));
+        } else if constexpr (kind == Kind::floating) {
+            store_le(out_.data() + at, std::bit_cast<float_bits<V>>(value), sizeof(V));
+        } else if constexpr (kind == Kind::duration) {
+            store_le(out_.data() + at, static_cast<std::uint64_t>(static_cast<std::int64_t>(value.count())), 8);
+        } else if constexpr (kind == Kind::time_point) {
+            store_le(out_.data() + at, static_cast<std::uint64_t>(to_epoch_millis(value)), 8);
+        } else if constexpr (kind == Kind::fixed_array) {
+            using Item = typename V::value_type;
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                const Item& item = value[i];
+                slot(at + i * slot_size<Item>(), base, item);
+            }
+        } else if constexpr (kind == Kind::string) {
+            reference(at, base, append(value), value.size());
+        } else if constexpr (kind == Kind::text) {
+            std::string text = value.to_string();
+            reference(at, base, append(text), text.size());
+        } else if constexpr (kind == Kind::sequence) {
+            using Item = typename V::value_type;
+            std::size_t start = out_.size();
+            out_.resize(start + value.size() * slot_size<Item>());
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                const Item& item = value[i];
+                slot(start + i * slot_size<Item>(), base, item);
+            }
+            reference(at, base, start, value.size());
+        } else if constexpr (kind == Kind::structure) {
+            std::size_t start = message(value);
+            reference(at, base, start, out_.size() - start);
+        }
+    }
+
+    auto append(std::string_view bytes) -> std::size_t {
+        std::size_t start = out_.size();
+        out_.resize(start + bytes.size());
+        std::memcpy(out_.data() + start, bytes.data(), bytes.size());
+        return start;
+    }
+
+    void reference(std::size_t at, std::size_t base, std::size_t start, std::size_t length) {
+        if (start - base > UINT32_MAX || length > UINT32_MAX) {
+            error_ = SerialError::too_large;
+            return;
+        }
+        store_le(out_.data() + at, start - base, 4);
+        store_le(out_.data() + at + 4, length, 4);
+    }
+
+    std::vector<std::byte>& out_;
+    std::optional<SerialError> error_;
+};
+
+// ============================================================================
+// Validation
+// ============================================================================
+
+// Walks every reference once. Each slot or message header visited in a
+// well-formed message occupies bytes no other visit touches, so the walk is
+// capped at one visit per input byte; references aliased to multiply the work
+// run out of budget instead.
+class ViewValidator {
+public:
+    explicit ViewValidator(std::size_t budget) : budget_(budget) {}
+
+    template<typename T>
+    auto message(std::span<const std::byte> data, std::size_t depth) -> bool {
+        if (depth > MAX_SERIAL_DEPTH) return fail(SerialError::too_deep);
+        if (!spend()) return false;
+        if (data.size() < VIEW_HEADER_SIZE) return fail(SerialError::truncated);
+        auto fixed = static_cast<std::size_t>(load_le(data.data(), 4));
+        if (fixed > data.size() - VIEW_HEADER_SIZE) return fail(SerialError::truncated);
+
+        FieldChecker checker{*this, data, fixed, depth};
+        prototype<T>().reflect(checker);
+        return !error_;
+    }
+
+    auto error() const -> SerialError { return error_.value_or(SerialError::invalid_value); }
+
+private:
+    struct FieldChecker {
+        ViewValidator& validator;
+        std::span<const std::byte> data;
+        std::size_t fixed;
+        std::size_t depth;
+        std::size_t cursor = 0;
+
+        template<typename V>
+        void reflect(V&, std::string_view) {
+            std::size_t at = cursor;
+            cursor += slot_size<V>();
+            if (validator.error_ || at >= fixed) {
+                return;     // Member added after the sender's schema
+            }
+            if (cursor > fixed) {
+                validator.fail(SerialError::truncated);
+                return;
+            }
+            if constexpr (slot_needs_check<V>()) {
+                validator.slot<V>(data, VIEW_HEADER_SIZE + at, depth);
+            }
+        }
+    };
+
+    template<typename V>
+    auto slot(std::span<const std::byte> data, std::size_t at, std::size_t depth) -> bool {
+        constexpr Kind kind = kind_of<V>();
+        if (!spend()) return false;
+        if constexpr (kind == Kind::boolean) {
+            return data[at] <= std::byte{1} || fail(SerialError::invalid_value);
+        } else if constexpr (kind == Kind::fixed_array) {
+            for (std::size_t i = 0; i < std::tuple_size_v<V>; ++i) {
+                if (data[at + i] > std::byte{1}) return fail(SerialError::invalid_value);
+            }
+            return true;
+        } else {
+            auto offset = static_cast<std::size_t>(load_le(data.data() + at, 4));
+            auto length = static_cast<std::size_t>(load_le(data.data() + at + 4, 4));
+            if (offset > data.size()) return fail(SerialError::truncated);
+            std::size_t available = data.size() - offset;
+
+            if constexpr (kind == Kind::sequence) {
+                using Item = typename V::value_type;
+                if (length > available / slot_size<Item>()) return fail(SerialError::truncated);
+                if constexpr (slot_needs_check<Item>()) {
+                    for (std::size_t i = 0; i < length; ++i) {
+                        if (!slot<Item>(data, offset + i * slot_size<Item>(), depth)) return false;
+                    }
+                }
+                return true;
+            } else {
+                if (length > available) return fail(SerialError::truncated);
+                if constexpr (kind == Kind::structure) {
+                    return message<V>(data.subspan(offset, length), depth + 1);
+                }
+                return true;
+            }
+        }
+    }
+
+    auto spend() -> bool {
+        if (budget_ == 0) return fail(SerialError::invalid_value);
+        --budget_;
+        return true;
+    }
+
+    auto fail(SerialError error) -> bool {
+        if (!error_) error_ = error;
+        return false;
+    }
+
+    std::size_t budget_;
+    std::optional<SerialError> error_;
+};
+
+} // namespace detail
+
+// ============================================================================
+// Views
+// ============================================================================
+
+// Read-only view of a vector member; elements are read in place
+template<typename Item>
+class ListView {
+public:
+    using value_type = detail::view_t<Item>;
+
+    class iterator {
+    public:
+        using value_type = detail::view_t<Item>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const ListView* list, std::size_t index) : list_(list), index_(index) {}
+
+        auto operator*() const -> value_type { return (*list_)[index_]; }
+        auto operator++() -> iterator& { ++index_; return *this; }
+        auto operator++(int) -> iterator { iterator previous = *this; ++index_; return previous; }
+        auto operator==(const iterator& other) const -> bool = default;
+
+    private:
+        const ListView* list_ = nullptr;
+        std::size_t index_ = 0;
+    };
+
+    ListView() = default;
+
+    auto size() const -> std::size_t { return count_; }
+    auto empty() const -> bool { return count_ == 0; }
+
+    auto operator[](std::size_t index) const -> value_type {
+        return detail::read_slot<Item>(message_, slot_offset(index));
+    }
+
+    auto begin() const -> iterator { return iterator(this, 0); }
+    auto end() const -> iterator { return iterator(this, count_); }
+
+    // Element slots as stored; for byte vectors this is the payload itself
+    auto bytes() const -> std::span<const std::byte> {
+        return message_.subspan(offset_, count_ * detail::slot_size<Item>());
+    }
+
+    auto slot_offset(std::size_t index) const -> std::size_t {
+        return offset_ + index * detail::slot_size<Item>();
+    }
+
+private:
+    friend struct detail::ViewAccess;
+
+    ListView(std::span<const std::byte> message, std::size_t offset, std::size_t count)
+        : message_(message), offset_(offset), count_(count) {}
+
+    std::span<const std::byte> message_;
+    std::size_t offset_ = 0;
+    std::size_t count_ = 0;
+};
+
+// Read-only view of a message of schema T, backed by the caller's buffer
+template<typename T>
+class MessageView {
+public:
+    using Layout = detail::MessageLayout<T>;
+
+    // View with every member absent
+    MessageView() : data_(detail::EMPTY_MESSAGE), fixed_(0) {}
+
+    // Check every reference in data; the view borrows data
+    static auto validate(std::span<const std::byte> data) -> std::expected<MessageView, SerialError> {
+        detail::ViewValidator validator(data.size());
+        if (!validator.template message<T>(data, 0)) {
+            return std::unexpected(validator.error());
+        }
+        return MessageView(data);
+    }
+
+    template<auto Member>
+    auto get() const -> detail::view_t<typename detail::member_pointer_traits<decltype(Member)>::member> {
+        using Traits = detail::member_pointer_traits<decltype(Member)>;
+        using V = typename Traits::member;
+        static_assert(std::is_same_v<typename Traits::owner, T>, "member belongs to another schema");
+        constexpr std::size_t index = Layout::template index_of<Member>;
+        static_assert(index != detail::NOT_REFLECTED, "member is not listed in the reflect hook");
+        constexpr std::size_t at = Layout::offsets[index];
+
+        if (at + detail::slot_size<V>() > fixed_) {
+            return detail::view_t<V>{};
+        }
+        return detail::read_slot<V>(data_, detail::VIEW_HEADER_SIZE + at);
+    }
+
+    // False when the sender's schema predates the member
+    template<auto Member>
+    auto has() const -> bool {
+        using V = typename detail::member_pointer_traits<decltype(Member)>::member;
+        constexpr std::size_t at = Layout::offsets[Layout::template index_of<Member>];
+        return at + detail::slot_size<V>() <= fixed_;
+    }
+
+    // Owning copy of the whole message
+    auto decode() const -> T {
+        T value{};
+        Decoder decoder{data_, fixed_};
+        value.reflect(decoder);
+        return value;
+    }
+
+    auto bytes() const -> std::span<const std::byte> { return data_; }
+
+private:
+    friend struct detail::ViewAccess;
+
+    struct Decoder {
+        std::span<const std::byte> data;
+        std::size_t fixed;
+        std::size_t cursor = 0;
+
+        template<typename V>
+        void reflect(V& value, std::string_view) {
+            std::size_t at = cursor;
+            cursor += detail::slot_size<V>();
+            if (cursor <= fixed) {
+                detail::materialize_slot(data, detail::VIEW_HEADER_SIZE + at, value);
+            }
+        }
+    };
+
+    explicit MessageView(std::span<const std::byte> data)
+        : data_(data), fixed_(static_cast<std::size_t>(detail::load_le(data.data(), 4))) {}
+
+    std::span<const std::byte> data_;
+    std::size_t fixed_;
+};
+
+// Append obj to out in message view form; on failure out is left as it was
+template<reflectable T>
+auto build_message(const T& obj, std::vector<std::byte>& out) -> std::expected<void, SerialError> {
+    std::size_t original = out.size();
+    detail::ViewEncoder encoder(out);
+    encoder.message(obj);
+    if (!encoder.ok()) {
+        out.resize(original);
+        return std::unexpected(encoder.error());
+    }
+    return {};
+}
+
+template<reflectable T>
+auto build_message(const T& obj) -> std::expected<std::vector<std::byte>, SerialError> {
+    std::vector<std::byte> out;
+    if (auto built = build_message(obj, out); !built) {
+        return std::unexpected(built.error());
+    }
+    return out;
+}
+
+// Point an empty byte-vector member of a message built at the start of
+// `message` at `length` bytes the caller sends straight after it, so large
+// bodies can go out with sendfile instead of being copied into the message
+template<auto Member>
+auto attach_trailing_bytes(std::vector<std::byte>& message, std::size_t length) -> std::expected<void, SerialError> {
+    using Traits = detail::member_pointer_traits<decltype(Member)>;
+    using Layout = detail::MessageLayout<typename Traits::owner>;
+    using V = typename Traits::member;
+    static_assert(detail::kind_of<V>() == detail::Kind::sequence && detail::slot_size<typename V::value_type>() == 1,
+                  "trailing bytes attach to byte-vector members only");
+    constexpr std::size_t at = detail::VIEW_HEADER_SIZE + Layout::offsets[Layout::template index_of<Member>];
+    if (message.size() > UINT32_MAX || length > UINT32_MAX) {
+        return std::unexpected(SerialError::too_large);
+    }
+    detail::store_le(message.data() + at, message.size(), 4);
+    detail::store_le(message.data() + at + 4, length, 4);
+    return {};
+}
+
+} // namespace dualstack::reflect
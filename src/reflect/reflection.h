@@ -12,12 +12,28 @@
 #include <meta>
 #endif
 
+namespace dualstack {
+class IPAddress;
+class Socket;
+class Acceptor;
+}
+
 namespace dualstack::reflect {
 
+namespace detail {
+
+// Accepts any member; used to detect reflect hooks
+struct ReflectionProbe {
+    template<typename V>
+    constexpr void reflect(V&, std::string_view) {}
+};
+
+} // namespace detail
+
 // Concepts for reflection-capable types
 template<typename T>
-concept reflectable = requires(T t) {
-    t.reflect(std::declval<auto&>());
+concept reflectable = requires(T& t, detail::ReflectionProbe& r) {
+    t.reflect(r);
 };
 
 template<typename T>
@@ -68,21 +84,7 @@ constexpr auto generate_ip_bindings() {
     return std::meta::members_of(config_info);
 }
 
-// Reflection-based serialization
-template<reflectable T>
-constexpr auto serialize(const T& obj) -> std::string {
-    std::string result;
-    // This would use reflection to serialize all members
-    return result;
-}
-
-// Reflection-based deserialization
-template<reflectable T>
-constexpr auto deserialize(std::string_view data) -> T {
-    T obj{};
-    // This would use reflection to deserialize into members
-    return obj;
-}
+// Serialization over the reflect(Reflection&) hooks lives in serializer.h
 
 #endif
 
@@ -114,11 +116,15 @@ constexpr auto member_names() -> std::array<std::string_view, 0> {
 // Compile-time configuration generation
 template<typename ConfigType>
 constexpr auto generate_config_bindings() {
+#if __cpp_lib_meta >= 202207L
     if constexpr (reflectable<ConfigType>) {
         return generate_ip_bindings<ConfigType>();
     } else {
         return std::array<int, 0>{};
     }
+#else
+    return std::array<int, 0>{};
+#endif
 }
 
 // Type traits for networking types
@@ -126,13 +132,13 @@ template<typename T>
 struct is_network_type : std::false_type {};
 
 template<>
-struct is_network_type<class IPAddress> : std::true_type {};
+struct is_network_type<::dualstack::IPAddress> : std::true_type {};
 
 template<>
-struct is_network_type<class Socket> : std::true_type {};
+struct is_network_type<::dualstack::Socket> : std::true_type {};
 
 template<>
-struct is_network_type<class Acceptor> : std::true_type {};
+struct is_network_type<::dualstack::Acceptor> : std::true_type {};
 
 template<typename T>
 constexpr bool is_network_type_v = is_network_type<T>::value;
@@ -0,0 +1,861 @@
+#pragma once
+
+// Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+
+#include "reflection.h"
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Serialization driven by the reflect(Reflection&) hooks
+//
+// A type opts in by listing its members once:
+//
+//     template<typename Reflection>
+//     constexpr void reflect(Reflection& r) {
+//         DUALSTACK_REFLECT_MEMBER(port);
+//         DUALSTACK_REFLECT_MEMBER(name);
+//     }
+//
+// Each format below is a Reflection whose reflect(member, name) is resolved
+// per member type at compile time, so encoding and decoding inline into
+// straight-line code with no runtime type inspection.
+//
+// Binary: members in declaration order with no names or tags. Booleans,
+// integers and enums are fixed-width little-endian; floats are their IEEE
+// bits; strings, vectors and maps carry a LEB128 count. Durations are the
+// int64 tick count; time points are int64 milliseconds since the epoch.
+//
+// JSON: one object per reflected type, keyed by member name. Unknown keys are
+// skipped and missing keys keep their defaults, so either side may add members.
+// Types with to_string()/from_string() (IPAddress) travel as strings.
+
+namespace dualstack::reflect {
+
+enum class SerialError : std::uint8_t {
+    truncated,          // Input ended inside a value
+    invalid_value,      // Value out of range for its member
+    trailing_data,      // Bytes left after the top-level value
+    syntax_error,       // Malformed JSON
+    too_deep,           // Nesting beyond MAX_SERIAL_DEPTH
+    too_large           // Offset or length past a 32-bit message view reference
+};
+
+inline constexpr std::size_t MAX_SERIAL_DEPTH = 64;
+
+inline auto describe(SerialError error) -> const char* {
+    switch (error) {
+        case SerialError::truncated: return "input truncated";
+        case SerialError::invalid_value: return "value out of range";
+        case SerialError::trailing_data: return "trailing data after value";
+        case SerialError::syntax_error: return "malformed JSON";
+        case SerialError::too_deep: return "nesting too deep";
+        case SerialError::too_large: return "message too large";
+    }
+    return "unknown serialization error";
+}
+
+// Value types carried in their text form
+template<typename T>
+concept text_convertible = !reflectable<T> && requires(const T& t, std::string_view s) {
+    { t.to_string() } -> std::convertible_to<std::string>;
+    { static_cast<bool>(T::from_string(s)) };
+    { *T::from_string(s) } -> std::convertible_to<T>;
+};
+
+namespace detail {
+
+template<typename T> struct is_vector : std::false_type {};
+template<typename T, typename A> struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template<typename T> struct is_std_array : std::false_type {};
+template<typename T, std::size_t N> struct is_std_array<std::array<T, N>> : std::true_type {};
+
+template<typename T> struct is_string_map : std::false_type {};
+template<typename V, typename C, typename A>
+struct is_string_map<std::map<std::string, V, C, A>> : std::true_type {};
+template<typename V, typename H, typename E, typename A>
+struct is_string_map<std::unordered_map<std::string, V, H, E, A>> : std::true_type {};
+
+template<typename T> struct is_duration : std::false_type {};
+template<typename R, typename P> struct is_duration<std::chrono::duration<R, P>> : std::true_type {};
+
+template<typename T> struct is_time_point : std::false_type {};
+template<typename C, typename D> struct is_time_point<std::chrono::time_point<C, D>> : std::true_type {};
+
+enum class Kind {
+    boolean,
+    enumeration,
+    integer,
+    floating,
+    string,
+    duration,
+    time_point,
+    fixed_array,
+    sequence,
+    string_map,
+    text,
+    structure,
+    unsupported
+};
+
+template<typename V>
+constexpr auto kind_of() -> Kind {
+    if constexpr (std::is_same_v<V, bool>) return Kind::boolean;
+    else if constexpr (std::is_enum_v<V>) return Kind::enumeration;
+    else if constexpr (std::is_integral_v<V>) return Kind::integer;
+    else if constexpr (std::is_floating_point_v<V>) return Kind::floating;
+    else if constexpr (std::is_same_v<V, std::string>) return Kind::string;
+    else if constexpr (is_duration<V>::value) return Kind::duration;
+    else if constexpr (is_time_point<V>::value) return Kind::time_point;
+    else if constexpr (is_std_array<V>::value) return Kind::fixed_array;
+    else if constexpr (is_vector<V>::value) return Kind::sequence;
+    else if constexpr (is_string_map<V>::value) return Kind::string_map;
+    else if constexpr (reflectable<V>) return Kind::structure;
+    else if constexpr (text_convertible<V>) return Kind::text;
+    else return Kind::unsupported;
+}
+
+// Integer storage for enums and integers
+template<typename V, bool = std::is_enum_v<V>>
+struct integer_storage { using type = V; };
+template<typename V>
+struct integer_storage<V, true> { using type = std::underlying_type_t<V>; };
+
+template<typename V>
+using integer_of = typename integer_storage<V>::type;
+
+template<typename V>
+using float_bits = std::conditional_t<sizeof(V) == 4, std::uint32_t, std::uint64_t>;
+
+template<typename TimePoint>
+auto to_epoch_millis(const TimePoint& value) -> std::int64_t {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(value.time_since_epoch()).count();
+}
+
+template<typename TimePoint>
+auto from_epoch_millis(std::int64_t millis) -> TimePoint {
+    return TimePoint(std::chrono::duration_cast<typename TimePoint::duration>(std::chrono::milliseconds(millis)));
+}
+
+constexpr auto varint_size(std::uint64_t value) -> std::size_t {
+    std::size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+// ============================================================================
+// Binary
+// ============================================================================
+
+// Exact encoded size, so the writer can size its output once
+class BinarySizer {
+public:
+    template<typename V>
+    constexpr void reflect(V& value, std::string_view) { add(value); }
+
+    template<typename V>
+    constexpr void add(const V& value) {
+        constexpr Kind kind = kind_of<V>();
+        static_assert(kind != Kind::unsupported, "member type has no serialized form");
+        if constexpr (kind == Kind::boolean) size_ += 1;
+        else if constexpr (kind == Kind::enumeration || kind == Kind::integer || kind == Kind::floating) size_ += sizeof(V);
+        else if constexpr (kind == Kind::string) size_ += varint_size(value.size()) + value.size();
+        else if constexpr (kind == Kind::duration || kind == Kind::time_point) size_ += 8;
+        else if constexpr (kind == Kind::fixed_array) for (const auto& item : value) add(item);
+        else if constexpr (kind == Kind::sequence) {
+            size_ += varint_size(value.size());
+            using Item = typename V::value_type;
+            if constexpr (kind_of<Item>() == Kind::integer || kind_of<Item>() == Kind::enumeration) {
+                size_ += value.size() * sizeof(Item);
+            } else {
+                for (const auto& item : value) add(item);
+            }
+        } else if constexpr (kind == Kind::string_map) {
+            size_ += varint_size(value.size());
+            for (const auto& [key, item] : value) {
+                add(key);
+                add(item);
+            }
+        } else if constexpr (kind == Kind::text) add(value.to_string());
+        else if constexpr (kind == Kind::structure) const_cast<V&>(value).reflect(*this);
+    }
+
+    constexpr auto size() const -> std::size_t { return size_; }
+
+private:
+    std::size_t size_ = 0;
+};
+
+// Writes into a buffer already sized by BinarySizer
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::byte* out) : out_(out) {}
+
+    template<typename V>
+    void reflect(V& value, std::string_view) { write(value); }
+
+    template<typename V>
+    void write(const V& value) {
+        constexpr Kind kind = kind_of<V>();
+        if constexpr (kind == Kind::boolean) put(std::uint64_t{value ? 1u : 0u}, 1);
+        else if constexpr (kind == Kind::enumeration || kind == Kind::integer) {
+            put(static_cast<std::uint64_t>(static_cast<integer_of<V>>(value)), sizeof(V));
+        } else if constexpr (kind == Kind::floating) put(std::bit_cast<float_bits<V>>(value), sizeof(V));
+        else if constexpr (kind == Kind::string) {
+            put_varint(value.size());
+            std::memcpy(out_, value.data(), value.size());
+            out_ += value.size();
+        } else if constexpr (kind == Kind::duration) put(static_cast<std::uint64_t>(static_cast<std::int64_t>(value.count())), 8);
+        else if constexpr (kind == Kind::time_point) put(static_cast<std::uint64_t>(to_epoch_millis(value)), 8);
+        else if constexpr (kind == Kind::fixed_array) for (const auto& item : value) write(item);
+        else if constexpr (kind == Kind::sequence) {
+            put_varint(value.size());
+            for (const auto& item : value) write(item);
+        } else if constexpr (kind == Kind::string_map) {
+            put_varint(value.size());
+            for (const auto& [key, item] : value) {
+                write(key);
+                write(item);
+            }
+        } else if constexpr (kind == Kind::text) write(value.to_string());
+        else if constexpr (kind == Kind::structure) const_cast<V&>(value).reflect(*this);
+    }
+
+    auto position() const -> std::byte* { return out_; }
+
+private:
+    void put(std::uint64_t value, std::size_t width) {
+        for (std::size_t i = 0; i < width; ++i) {
+            out_[i] = static_cast<std::byte>(value >> (8 * i));
+        }
+        out_ += width;
+    }
+
+    void put_varint(std::uint64_t value) {
+        while (value >= 0x80) {
+            *out_++ = static_cast<std::byte>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        *out_++ = static_cast<std::byte>(value);
+    }
+
+    std::byte* out_;
+};
+
+// Bounds-checked reader; after the first error every read is a no-op
+class BinaryReader {
+public:
+    explicit BinaryReader(std::span<const std::byte> data) : data_(data) {}
+
+    template<typename V>
+    void reflect(V& value, std::string_view) { read(value); }
+
+    template<typename V>
+    void read(V& value) {
+        constexpr Kind kind = kind_of<V>();
+        static_assert(kind != Kind::unsupported, "member type has no serialized form");
+        if (error_) {
+            return;
+        }
+        if constexpr (kind == Kind::boolean) {
+            std::uint64_t raw = take(1);
+            if (raw > 1) fail(SerialError::invalid_value);
+            value = raw != 0;
+        } else if constexpr (kind == Kind::enumeration || kind == Kind::integer) {
+            value = static_cast<V>(static_cast<integer_of<V>>(take(sizeof(V))));
+        } else if constexpr (kind == Kind::floating) {
+            value = std::bit_cast<V>(static_cast<float_bits<V>>(take(sizeof(V))));
+        } else if constexpr (kind == Kind::string) {
+            std::uint64_t length = take_varint();
+            if (!error_ && length > remaining()) fail(SerialError::truncated);
+            if (error_) return;
+            value.assign(reinterpret_cast<const char*>(data_.data() + pos_), static_cast<std::size_t>(length));
+            pos_ += static_cast<std::size_t>(length);
+        } else if constexpr (kind == Kind::duration) {
+            value = V(static_cast<typename V::rep>(static_cast<std::int64_t>(take(8))));
+        } else if constexpr (kind == Kind::time_point) {
+            value = from_epoch_millis<V>(static_cast<std::int64_t>(take(8)));
+        } else if constexpr (kind == Kind::fixed_array) {
+            for (auto& item : value) read(item);
+        } else if constexpr (kind == Kind::sequence) {
+            std::uint64_t count = take_varint();
+            // Every element takes at least one byte, which bounds hostile counts
+            if (!error_ && count > remaining()) fail(SerialError::truncated);
+            if (error_) return;
+            value.clear();
+            value.resize(static_cast<std::size_t>(count));
+            for (auto& item : value) read(item);
+        } else if constexpr (kind == Kind::string_map) {
+            std::uint64_t count = take_varint();
+            if (!error_ && count > remaining()) fail(SerialError::truncated);
+            value.clear();
+            for (std::uint64_t i = 0; !error_ && i < count; ++i) {
+                std::string key;
+                read(key);
+                read(value[std::move(key)]);
+            }
+        } else if constexpr (kind == Kind::text) {
+            std::string text;
+            read(text);
+            if (error_) return;
+            auto parsed = V::from_string(text);
+            if (!parsed) {
+                fail(SerialError::invalid_value);
+                return;
+            }
+            value = *parsed;
+        } else if constexpr (kind == Kind::structure) {
+            if (++depth_ > MAX_SERIAL_DEPTH) {
+                fail(SerialError::too_deep);
+                return;
+            }
+            value.reflect(*this);
+            --depth_;
+        }
+    }
+
+    auto finish() const -> std::expected<void, SerialError> {
+        if (error_) return std::unexpected(*error_);
+        if (pos_ != data_.size()) return std::unexpected(SerialError::trailing_data);
+        return {};
+    }
+
+private:
+    auto remaining() const -> std::size_t { return data_.size() - pos_; }
+
+    void fail(SerialError error) {
+        if (!error_) error_ = error;
+    }
+
+    auto take(std::size_t width) -> std::uint64_t {
+        if (remaining() < width) {
+            fail(SerialError::truncated);
+            return 0;
+        }
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            value |= std::to_integer<std::uint64_t>(data_[pos_ + i]) << (8 * i);
+        }
+        pos_ += width;
+        return value;
+    }
+
+    auto take_varint() -> std::uint64_t {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= data_.size()) {
+                fail(SerialError::truncated);
+                return 0;
+            }
+            auto byte = std::to_integer<std::uint64_t>(data_[pos_++]);
+            value |= (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        fail(SerialError::invalid_value);
+        return 0;
+    }
+
+    std::span<const std::byte> data_;
+    std::size_t pos_ = 0;
+    std::size_t depth_ = 0;
+    std::optional<SerialError> error_;
+};
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    template<typename V>
+    void reflect(V& value, std::string_view name) {
+        if (!first_) out_ += ',';
+        first_ = false;
+        write_string(name);
+        out_ += ':';
+        write(value);
+    }
+
+    template<typename V>
+    void write(const V& value) {
+        constexpr Kind kind = kind_of<V>();
+        static_assert(kind != Kind::unsupported, "member type has no serialized form");
+        if constexpr (kind == Kind::boolean) out_ += value ? "true" : "false";
+        else if constexpr (kind == Kind::enumeration || kind == Kind::integer) {
+            write_number(static_cast<std::conditional_t<std::is_signed_v<integer_of<V>>, std::int64_t, std::uint64_t>>(
+                static_cast<integer_of<V>>(value)));
+        } else if constexpr (kind == Kind::floating) {
+            if (std::isfinite(value)) write_number(value);
+            else out_ += "null";
+        } else if constexpr (kind == Kind::string) write_string(value);
+        else if constexpr (kind == Kind::duration) write_number(static_cast<std::int64_t>(value.count()));
+        else if constexpr (kind == Kind::time_point) write_number(to_epoch_millis(value));
+        else if constexpr (kind == Kind::fixed_array || kind == Kind::sequence) {
+            out_ += '[';
+            bool first = true;
+            for (const auto& item : value) {
+                if (!first) out_ += ',';
+                first = false;
+                write(item);
+            }
+            out_ += ']';
+        } else if constexpr (kind == Kind::string_map) {
+            out_ += '{';
+            bool first = true;
+            for (const auto& [key, item] : value) {
+                if (!first) out_ += ',';
+                first = false;
+                write_string(key);
+                out_ += ':';
+                write(item);
+            }
+            out_ += '}';
+        } else if constexpr (kind == Kind::text) write_string(value.to_string());
+        else if constexpr (kind == Kind::structure) {
+            bool outer_first = first_;
+            first_ = true;
+            out_ += '{';
+            const_cast<V&>(value).reflect(*this);
+            out_ += '}';
+            first_ = outer_first;
+        }
+    }
+
+private:
+    template<typename N>
+    void write_number(N value) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out_.append(buffer, result.ptr);
+    }
+
+    void write_string(std::string_view text) {
+        constexpr char hex[] = "0123456789abcdef";
+        out_ += '"';
+        std::size_t run = 0;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            auto c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out_.append(text.data() + run, i - run);
+            run = i + 1;
+            switch (c) {
+                case '"': out_ += "\\\""; break;
+                case '\\': out_ += "\\\\"; break;
+                case '\n': out_ += "\\n"; break;
+                case '\r': out_ += "\\r"; break;
+                case '\t': out_ += "\\t"; break;
+                default:
+                    out_ += "\\u00";
+                    out_ += hex[c >> 4];
+                    out_ += hex[c & 0xF];
+            }
+        }
+        out_.append(text.data() + run, text.size() - run);
+        out_ += '"';
+    }
+
+    std::string& out_;
+    bool first_ = true;
+};
+
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text) : in_(text) {}
+
+    template<typename V>
+    void read(V& value) {
+        constexpr Kind kind = kind_of<V>();
+        static_assert(kind != Kind::unsupported, "member type has no serialized form");
+        skip_space();
+        if (error_) return;
+        if (consume_literal("null")) return;   // Keep the default
+
+        if constexpr (kind == Kind::boolean) {
+            if (consume_literal("true")) value = true;
+            else if (consume_literal("false")) value = false;
+            else fail(SerialError::syntax_error);
+        } else if constexpr (kind == Kind::enumeration || kind == Kind::integer) {
+            integer_of<V> number{};
+            if (parse_number(number)) value = static_cast<V>(number);
+        } else if constexpr (kind == Kind::floating) {
+            V number{};
+            if (parse_number(number)) value = number;
+        } else if constexpr (kind == Kind::string) {
+            parse_string(value);
+        } else if constexpr (kind == Kind::duration) {
+            std::int64_t count = 0;
+            if (parse_number(count)) value = V(static_cast<typename V::rep>(count));
+        } else if constexpr (kind == Kind::time_point) {
+            std::int64_t millis = 0;
+            if (parse_number(millis)) value = from_epoch_millis<V>(millis);
+        } else if constexpr (kind == Kind::fixed_array) {
+            std::size_t index = 0;
+            read_array([&] {
+                if (index == value.size()) {
+                    fail(SerialError::invalid_value);
+                    return;
+                }
+                read(value[index++]);
+            });
+        } else if constexpr (kind == Kind::sequence) {
+            value.clear();
+            read_array([&] { read(value.emplace_back()); });
+        } else if constexpr (kind == Kind::string_map) {
+            value.clear();
+            read_object([&](std::string&& key) { read(value[std::move(key)]); });
+        } else if constexpr (kind == Kind::text) {
+            std::string text;
+            if (!parse_string(text)) return;
+            auto parsed = V::from_string(text);
+            if (!parsed) {
+                fail(SerialError::invalid_value);
+                return;
+            }
+            value = *parsed;
+        } else if constexpr (kind == Kind::structure) {
+            read_object([&](std::string&& key) {
+                MemberSetter setter{*this, key};
+                value.reflect(setter);
+                if (!setter.found) skip_value();
+            });
+        }
+    }
+
+    auto finish() -> std::expected<void, SerialError> {
+        skip_space();
+        if (error_) return std::unexpected(*error_);
+        if (pos_ != in_.size()) return std::unexpected(SerialError::trailing_data);
+        return {};
+    }
+
+private:
+    // Routes one object key to the member of that name
+    struct MemberSetter {
+        JsonReader& reader;
+        std::string_view key;
+        bool found = false;
+
+        template<typename V>
+        void reflect(V& value, std::string_view name) {
+            if (!found && name == key) {
+                found = true;
+                reader.read(value);
+            }
+        }
+    };
+
+    void fail(SerialError error) {
+        if (!error_) error_ = error;
+    }
+
+    void skip_space() {
+        while (pos_ < in_.size() && (in_[pos_] == ' ' || in_[pos_] == '\n' || in_[pos_] == '\r' || in_[pos_] == '\t')) {
+            ++pos_;
+        }
+    }
+
+    auto consume(char c) -> bool {
+        skip_space();
+        if (pos_ < in_.size() && in_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    auto consume_literal(std::string_view literal) -> bool {
+        if (in_.substr(pos_, literal.size()) == literal) {
+            pos_ += literal.size();
+            return true;
+        }
+        return false;
+    }
+
+    template<typename Fn>
+    void read_array(Fn&& element) {
+        if (!enter('[')) return;
+        if (!consume(']')) {
+            do {
+                element();
+            } while (!error_ && consume(','));
+            if (!error_ && !consume(']')) fail(pos_ >= in_.size() ? SerialError::truncated : SerialError::syntax_error);
+        }
+        --depth_;
+    }
+
+    template<typename Fn>
+    void read_object(Fn&& member) {
+        if (!enter('{')) return;
+        if (!consume('}')) {
+            do {
+                std::string key;
+                skip_space();
+                if (!parse_string(key)) break;
+                if (!consume(':')) {
+                    fail(SerialError::syntax_error);
+                    break;
+                }
+                member(std::move(key));
+            } while (!error_ && consume(','));
+            if (!error_ && !consume('}')) fail(pos_ >= in_.size() ? SerialError::truncated : SerialError::syntax_error);
+        }
+        --depth_;
+    }
+
+    auto enter(char open) -> bool {
+        if (!consume(open)) {
+            fail(pos_ >= in_.size() ? SerialError::truncated : SerialError::syntax_error);
+            return false;
+        }
+        if (++depth_ > MAX_SERIAL_DEPTH) {
+            fail(SerialError::too_deep);
+            return false;
+        }
+        return true;
+    }
+
+    template<typename N>
+    auto parse_number(N& value) -> bool {
+        const char* first = in_.data() + pos_;
+        const char* last = in_.data() + in_.size();
+        std::from_chars_result result{};
+        if constexpr (std::is_floating_point_v<N>) {
+            result = std::from_chars(first, last, value);
+        } else {
+            result = std::from_chars(first, last, value);
+            // Integers must not carry a fraction or exponent
+            if (result.ec == std::errc{} && result.ptr != last &&
+                (*result.ptr == '.' || *result.ptr == 'e' || *result.ptr == 'E')) {
+                fail(SerialError::invalid_value);
+                return false;
+            }
+        }
+        if (result.ec == std::errc::result_out_of_range) {
+            fail(SerialError::invalid_value);
+            return false;
+        }
+        if (result.ec != std::errc{}) {
+            fail(pos_ >= in_.size() ? SerialError::truncated : SerialError::syntax_error);
+            return false;
+        }
+        pos_ = static_cast<std::size_t>(result.ptr - in_.data());
+        return true;
+    }
+
+    auto parse_hex4(std::uint32_t& value) -> bool {
+        if (in_.size() - pos_ < 4) {
+            fail(SerialError::truncated);
+            return false;
+        }
+        auto result = std::from_chars(in_.data() + pos_, in_.data() + pos_ + 4, value, 16);
+        if (result.ptr != in_.data() + pos_ + 4) {
+            fail(SerialError::syntax_error);
+            return false;
+        }
+        pos_ += 4;
+        return true;
+    }
+
+    static void append_utf8(std::string& out, std::uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    auto parse_string(std::string& out) -> bool {
+        if (pos_ >= in_.size() || in_[pos_] != '"') {
+            fail(pos_ >= in_.size() ? SerialError::truncated : SerialError::syntax_error);
+            return false;
+        }
+        ++pos_;
+        out.clear();
+        while (true) {
+            // Copy the run up to the next quote or escape in one go
+            std::size_t run = in_.find_first_of("\"\\", pos_);
+            if (run == std::string_view::npos) {
+                fail(SerialError::truncated);
+                return false;
+            }
+            out.append(in_.data() + pos_, run - pos_);
+            pos_ = run + 1;
+            if (in_[run] == '"') {
+                return true;
+            }
+            if (pos_ >= in_.size()) {
+                fail(SerialError::truncated);
+                return false;
+            }
+            char escape = in_[pos_++];
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    std::uint32_t code = 0;
+                    if (!parse_hex4(code)) return false;
+                    if (code >= 0xD800 && code < 0xDC00) {
+                        std::uint32_t low = 0;
+                        if (!consume_literal("\\u") || !parse_hex4(low) || low < 0xDC00 || low >= 0xE000) {
+                            fail(SerialError::syntax_error);
+                            return false;
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    append_utf8(out, code);
+                    break;
+                }
+                default:
+                    fail(SerialError::syntax_error);
+                    return false;
+            }
+        }
+    }
+
+    void skip_value() {
+        skip_space();
+        if (error_) return;
+        if (pos_ >= in_.size()) {
+            fail(SerialError::truncated);
+            return;
+        }
+        char c = in_[pos_];
+        if (c == '"') {
+            std::string ignored;
+            parse_string(ignored);
+        } else if (c == '{') {
+            read_object([&](std::string&&) { skip_value(); });
+        } else if (c == '[') {
+            read_array([&] { skip_value(); });
+        } else if (!consume_literal("true") && !consume_literal("false") && !consume_literal("null")) {
+            double ignored = 0;
+            parse_number(ignored);
+        }
+    }
+
+    std::string_view in_;
+    std::size_t pos_ = 0;
+    std::size_t depth_ = 0;
+    std::optional<SerialError> error_;
+};
+
+} // namespace detail
+
+// Append the binary encoding of obj to out
+template<reflectable T>
+auto to_binary(const T& obj, std::vector<std::byte>& out) -> void {
+    detail::BinarySizer sizer;
+    sizer.add(obj);
+    std::size_t start = out.size();
+    out.resize(start + sizer.size());
+    detail::BinaryWriter writer(out.data() + start);
+    writer.write(obj);
+}
+
+template<reflectable T>
+auto to_binary(const T& obj) -> std::vector<std::byte> {
+    std::vector<std::byte> out;
+    to_binary(obj, out);
+    return out;
+}
+
+// Decode into obj; the input must hold exactly one encoded value
+template<reflectable T>
+auto from_binary(std::span<const std::byte> data, T& obj) -> std::expected<void, SerialError> {
+    detail::BinaryReader reader(data);
+    reader.read(obj);
+    return reader.finish();
+}
+
+template<reflectable T>
+auto from_binary(std::span<const std::byte> data) -> std::expected<T, SerialError> {
+    T obj{};
+    if (auto decoded = from_binary(data, obj); !decoded) {
+        return std::unexpected(decoded.error());
+    }
+    return obj;
+}
+
+// Append obj as a compact JSON object
+template<reflectable T>
+auto to_json(const T& obj, std::string& out) -> void {
+    detail::JsonWriter writer(out);
+    writer.write(obj);
+}
+
+template<reflectable T>
+auto to_json(const T& obj) -> std::string {
+    std::string out;
+    to_json(obj, out);
+    return out;
+}
+
+// Parse into obj; members absent from the text keep their current values
+template<reflectable T>
+auto from_json(std::string_view text, T& obj) -> std::expected<void, SerialError> {
+    detail::JsonReader reader(text);
+    reader.read(obj);
+    return reader.finish();
+}
+
+template<reflectable T>
+auto from_json(std::string_view text) -> std::expected<T, SerialError> {
+    T obj{};
+    if (auto parsed = from_json(text, obj); !parsed) {
+        return std::unexpected(parsed.error());
+    }
+    return obj;
+}
+
+// Text form used by reflection.h callers
+template<reflectable T>
+auto serialize(const T& obj) -> std::string {
+    return to_json(obj);
+}
+
+template<reflectable T>
+auto deserialize(std::string_view data) -> std::expected<T, SerialError> {
+    return from_json<T>(data);
+}
+
+} // namespace dualstack::reflect
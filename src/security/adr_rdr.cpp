@@ -1,11 +1,14 @@
 // Include format header fix BEFORE any standard headers
 #include "../../include/dualstack_net26/fix_format_header.h"
 #include "adr_rdr.h"
+#include "signature_codec.h"
+#include "png_codec.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <cstring>
 #include <algorithm>
+#include <stdexcept>
 
 namespace dualstack::security::visualization {
 
@@ -53,6 +56,17 @@ auto ADRReader::read_signature_image(const std::vector<std::byte>& image_data) -
     ReadResult result{};
     
     try {
+        // Binary-encoded signatures carry no image, decode them directly
+        if (codec::is_encoded_signature(image_data)) {
+            auto decoded = codec::deserialize(image_data);
+            if (!decoded) {
+                result.success = false;
+                result.error_message = std::string("Invalid binary signature: ") + codec::describe(decoded.error());
+                return result;
+            }
+            return extract_information(*decoded);
+        }
+        
         // Parse image data
         SignatureVisualizer::VisualSignature sig = extract_visual_data_from_image(image_data);
         return extract_information(sig);
@@ -63,6 +77,33 @@ auto ADRReader::read_signature_image(const std::vector<std::byte>& image_data) -
     }
 }
 
+auto ADRReader::open_signature_store(const std::string& filepath, std::size_t cache_capacity)
+    -> std::expected<std::size_t, StoreError> {
+    auto store = SignatureStore::open(filepath, cache_capacity);
+    if (!store) {
+        return std::unexpected(store.error());
+    }
+    store_ = std::move(*store);
+    return store_->size();
+}
+
+auto ADRReader::read_stored_signature(std::size_t index) -> ReadResult {
+    ReadResult result{};
+    if (!store_) {
+        result.success = false;
+        result.error_message = "No signature store open";
+        return result;
+    }
+    
+    auto sig = store_->get(index);
+    if (!sig) {
+        result.success = false;
+        result.error_message = std::string("Cannot read stored signature: ") + describe(sig.error());
+        return result;
+    }
+    return extract_information(**sig);
+}
+
 auto ADRReader::authenticate_signature(const SignatureVisualizer::VisualSignature& sig,
                                      const SignatureVisualizer::VisualSignature& reference) -> bool {
     try {
@@ -139,6 +180,10 @@ auto ADRReader::export_signature_data(const SignatureVisualizer::VisualSignature
         for (char c : svg) {
             result.push_back(static_cast<std::byte>(static_cast<unsigned char>(c)));
         }
+    } else if (format == "png") {
+        result = visualizer_->to_png(sig);
+    } else if (format == "binary") {
+        result = codec::serialize(sig);
     } else if (format == "string") {
         std::string str = visualizer_->to_string(sig);
         result.reserve(str.size());
@@ -168,11 +213,21 @@ auto ADRReader::parse_svg_file(const std::string& filepath [[maybe_unused]]) ->
     return sig;
 }
 
-auto ADRReader::parse_png_data(const std::vector<std::byte>& data [[maybe_unused]]) -> SignatureVisualizer::VisualSignature {
-    // Placeholder implementation - in reality this would parse PNG content
-    SignatureVisualizer::VisualSignature sig;
-    // Parse PNG and extract visual signature data
-    return sig;
+auto ADRReader::parse_png_data(const std::vector<std::byte>& data) -> SignatureVisualizer::VisualSignature {
+    auto decoded = png::decode(data);
+    if (!decoded) {
+        throw std::runtime_error(png::describe(decoded.error()));
+    }
+    
+    // The raster alone cannot reproduce the points exactly; the signature rides in its own chunk
+    if (decoded->signature_chunk.empty()) {
+        throw std::runtime_error("PNG carries no embedded signature");
+    }
+    auto sig = codec::deserialize(decoded->signature_chunk);
+    if (!sig) {
+        throw std::runtime_error(codec::describe(sig.error()));
+    }
+    return std::move(*sig);
 }
 
 auto ADRReader::extract_visual_data_from_image(const std::vector<std::byte>& image_data) -> SignatureVisualizer::VisualSignature {
@@ -195,13 +250,7 @@ auto ADRReader::calculate_similarity(const SignatureVisualizer::VisualSignature&
         return 1.0f; // Both empty, considered identical
     }
     
-    float total_distance = 0.0f;
-    for (size_t i = 0; i < sig1.points.size(); ++i) {
-        float dx = sig1.points[i][0] - sig2.points[i][0];
-        float dy = sig1.points[i][1] - sig2.points[i][1];
-        total_distance += std::sqrt(dx * dx + dy * dy);
-    }
-    
+    float total_distance = kernels::distance_sum(sig1.points, sig2.points);
     float avg_distance = total_distance / sig1.points.size();
     return std::max(0.0f, 1.0f - avg_distance); // Convert distance to similarity
 }
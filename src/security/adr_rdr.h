@@ -12,6 +12,7 @@
  */
 
 #include "signature_visualizer.h"
+#include "signature_store.h"
 
 using dualstack::security::visualization::SignatureVisualizer;
 #include <string>
@@ -21,6 +22,7 @@ using dualstack::security::visualization::SignatureVisualizer;
 #include <cstdint>
 #include <cstddef>
 #include <optional>
+#include <expected>
 
 // Define std::byte if not available
 #if __cplusplus >= 201703L
@@ -42,6 +44,7 @@ class ADRReader {
 private:
     std::unique_ptr<SignatureVisualizer> visualizer_;
     std::optional<SignatureVisualizer::SecureDataReader> secure_reader_;
+    std::unique_ptr<SignatureStore> store_;
     
 public:
     // Reader configuration
@@ -93,6 +96,15 @@ public:
     // Read visual signature from image data
     auto read_signature_image(const std::vector<std::byte>& image_data) -> ReadResult;
     
+    // Map an append-only signature store once; records are decoded lazily by index
+    auto open_signature_store(const std::string& filepath, std::size_t cache_capacity = 256)
+        -> std::expected<std::size_t, StoreError>;
+    
+    // Read one record of the open store (hot records come from the store's LRU)
+    auto read_stored_signature(std::size_t index) -> ReadResult;
+    
+    auto signature_store() -> SignatureStore* { return store_.get(); }
+    
     // Authenticate signature against reference
     auto authenticate_signature(const SignatureVisualizer::VisualSignature& sig,
                                const SignatureVisualizer::VisualSignature& reference) -> bool;
@@ -0,0 +1,1188 @@
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "png_codec.h"
+#include "signature_codec.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// SSE2 is part of the x86-64 baseline, so these paths need no runtime dispatch
+#if defined(__SSE2__) || defined(_M_X64)
+    #define DUALSTACK_PNG_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace dualstack::security::visualization::png {
+
+namespace {
+
+constexpr std::array<std::uint8_t, 8> PNG_SIGNATURE = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+
+// Deflate length and distance alphabets (RFC 1951 3.2.5)
+constexpr std::array<std::uint16_t, 29> LENGTH_BASE = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<std::uint8_t, 29> LENGTH_EXTRA = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<std::uint16_t, 30> DIST_BASE = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<std::uint8_t, 30> DIST_EXTRA = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr std::array<std::uint8_t, 19> CODE_LENGTH_ORDER = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+constexpr std::size_t MAX_MATCH = 258;
+constexpr std::size_t MAX_DISTANCE = 32768;
+constexpr int HASH_BITS = 15;
+
+constexpr auto reverse_bits(std::uint32_t code, int length) -> std::uint32_t {
+    std::uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) {
+        reversed = (reversed << 1) | ((code >> i) & 1u);
+    }
+    return reversed;
+}
+
+struct FixedCode {
+    std::uint16_t bits;     // Bit-reversed for LSB-first output
+    std::uint8_t length;
+};
+
+constexpr auto make_fixed_literal_codes() -> std::array<FixedCode, 288> {
+    std::array<FixedCode, 288> codes{};
+    for (std::uint32_t symbol = 0; symbol < 288; ++symbol) {
+        std::uint32_t code;
+        int length;
+        if (symbol < 144) {
+            code = 0x30 + symbol;
+            length = 8;
+        } else if (symbol < 256) {
+            code = 0x190 + (symbol - 144);
+            length = 9;
+        } else if (symbol < 280) {
+            code = symbol - 256;
+            length = 7;
+        } else {
+            code = 0xC0 + (symbol - 280);
+            length = 8;
+        }
+        codes[symbol] = {static_cast<std::uint16_t>(reverse_bits(code, length)), static_cast<std::uint8_t>(length)};
+    }
+    return codes;
+}
+
+// Match length (3..258) to its length symbol index
+constexpr auto make_length_symbols() -> std::array<std::uint8_t, MAX_MATCH + 1> {
+    std::array<std::uint8_t, MAX_MATCH + 1> symbols{};
+    for (std::size_t symbol = 0; symbol < LENGTH_BASE.size(); ++symbol) {
+        std::size_t last = symbol + 1 < LENGTH_BASE.size() ? LENGTH_BASE[symbol + 1] : MAX_MATCH + 1;
+        for (std::size_t length = LENGTH_BASE[symbol]; length < last; ++length) {
+            symbols[length] = static_cast<std::uint8_t>(symbol);
+        }
+    }
+    return symbols;
+}
+
+// zlib's split table: distance - 1 below 256 directly, above via (distance - 1) >> 7
+constexpr auto make_distance_codes() -> std::array<std::uint8_t, 512> {
+    std::array<std::uint8_t, 512> codes{};
+    for (std::size_t code = 0; code < DIST_BASE.size(); ++code) {
+        std::size_t first = DIST_BASE[code] - 1u;
+        std::size_t last = first + (std::size_t{1} << DIST_EXTRA[code]);
+        for (std::size_t d = first; d < last; ++d) {
+            codes[d < 256 ? d : 256 + (d >> 7)] = static_cast<std::uint8_t>(code);
+        }
+    }
+    return codes;
+}
+
+constexpr auto FIXED_LITERAL_CODES = make_fixed_literal_codes();
+constexpr auto LENGTH_SYMBOLS = make_length_symbols();
+constexpr auto DISTANCE_CODES = make_distance_codes();
+
+auto load_be32(const std::byte* p) -> std::uint32_t {
+    return (std::to_integer<std::uint32_t>(p[0]) << 24) | (std::to_integer<std::uint32_t>(p[1]) << 16) |
+           (std::to_integer<std::uint32_t>(p[2]) << 8) | std::to_integer<std::uint32_t>(p[3]);
+}
+
+auto append_be32(std::vector<std::byte>& out, std::uint32_t value) -> void {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<std::byte>(value >> shift));
+    }
+}
+
+auto load_u32(const std::uint8_t* p) -> std::uint32_t {
+    std::uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Length of the common prefix of a and b, up to limit
+auto match_length(const std::uint8_t* a, const std::uint8_t* b, std::size_t limit) -> std::size_t {
+    std::size_t length = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+        while (length + 8 <= limit) {
+            std::uint64_t x, y;
+            std::memcpy(&x, a + length, 8);
+            std::memcpy(&y, b + length, 8);
+            if (x != y) {
+                return length + static_cast<std::size_t>(std::countr_zero(x ^ y) / 8);
+            }
+            length += 8;
+        }
+    }
+    while (length < limit && a[length] == b[length]) {
+        ++length;
+    }
+    return length;
+}
+
+// LSB-first bit packer
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<std::byte>& out) : out_(out) {}
+
+    auto put(std::uint32_t bits, int count) -> void {
+        accumulator_ |= static_cast<std::uint64_t>(bits) << count_;
+        count_ += count;
+        if (count_ >= 32) {
+            for (int i = 0; i < 4; ++i) {
+                out_.push_back(static_cast<std::byte>(accumulator_ >> (8 * i)));
+            }
+            accumulator_ >>= 32;
+            count_ -= 32;
+        }
+    }
+
+    auto finish() -> void {
+        for (; count_ > 0; count_ -= 8) {
+            out_.push_back(static_cast<std::byte>(accumulator_));
+            accumulator_ >>= 8;
+        }
+        count_ = 0;
+    }
+
+private:
+    std::vector<std::byte>& out_;
+    std::uint64_t accumulator_ = 0;
+    int count_ = 0;
+};
+
+// LSB-first bit reader; reads past the end yield zeros and are detected by exhausted()
+class BitReader {
+public:
+    explicit BitReader(std::span<const std::byte> input) : input_(input) {}
+
+    // Resume over a new buffer with bits left over from the previous one
+    BitReader(std::span<const std::byte> input, std::uint64_t accumulator, int count)
+        : input_(input), accumulator_(accumulator), count_(count) {}
+
+    auto need(int count) -> void {
+        while (count_ < count) {
+            std::uint64_t next = 0;
+            if (position_ < input_.size()) {
+                next = std::to_integer<std::uint64_t>(input_[position_++]);
+            } else {
+                ++padding_;
+            }
+            accumulator_ |= next << count_;
+            count_ += 8;
+        }
+    }
+
+    auto peek(int count) const -> std::uint32_t {
+        return static_cast<std::uint32_t>(accumulator_ & ((std::uint64_t{1} << count) - 1));
+    }
+
+    auto consume(int count) -> void {
+        accumulator_ >>= count;
+        count_ -= count;
+    }
+
+    auto bits(int count) -> std::uint32_t {
+        need(count);
+        std::uint32_t value = peek(count);
+        consume(count);
+        return value;
+    }
+
+    auto align() -> void {
+        consume(count_ % 8);
+    }
+
+    // Copy whole bytes after align(); false if the input runs out
+    auto take_bytes(std::byte* out, std::size_t count) -> bool {
+        while (count > 0 && count_ >= 8) {
+            *out++ = static_cast<std::byte>(accumulator_);
+            consume(8);
+            --count;
+        }
+        if (input_.size() - position_ < count) {
+            return false;
+        }
+        std::memcpy(out, input_.data() + position_, count);
+        position_ += count;
+        return true;
+    }
+
+    auto exhausted() const -> bool {
+        return padding_ * 8 > static_cast<std::size_t>(count_);
+    }
+
+    // Copy up to max whole bytes after align(), as many as the input holds
+    auto take_available(std::uint8_t* out, std::size_t max) -> std::size_t {
+        std::size_t taken = 0;
+        while (taken < max && count_ - static_cast<int>(padding_ * 8) >= 8) {
+            out[taken++] = static_cast<std::uint8_t>(accumulator_);
+            consume(8);
+        }
+        std::size_t direct = std::min(max - taken, input_.size() - position_);
+        std::memcpy(out + taken, input_.data() + position_, direct);
+        position_ += direct;
+        return taken + direct;
+    }
+
+    // Bytes of input consumed so far, and the real (non-padding) bits still
+    // buffered, for resuming once more input arrives
+    auto position() const -> std::size_t { return position_; }
+    auto buffered_bits() const -> int { return count_ - static_cast<int>(padding_ * 8); }
+    auto buffered() const -> std::uint64_t {
+        int bits = buffered_bits();
+        return bits >= 64 ? accumulator_ : accumulator_ & ((std::uint64_t{1} << bits) - 1);
+    }
+
+private:
+    std::span<const std::byte> input_;
+    std::size_t position_ = 0;
+    std::size_t padding_ = 0;
+    std::uint64_t accumulator_ = 0;
+    int count_ = 0;
+};
+
+// Canonical Huffman decoder with a single lookup table of 2^max_bits entries
+class HuffmanTable {
+public:
+    auto build(const std::uint8_t* lengths, std::size_t count) -> bool {
+        std::array<int, 16> length_count{};
+        for (std::size_t i = 0; i < count; ++i) {
+            ++length_count[lengths[i]];
+        }
+        length_count[0] = 0;
+
+        max_bits_ = 0;
+        int left = 1;
+        for (int length = 1; length < 16; ++length) {
+            left = (left << 1) - length_count[length];
+            if (left < 0) {
+                return false;  // Over-subscribed
+            }
+            if (length_count[length] != 0) {
+                max_bits_ = length;
+            }
+        }
+
+        std::array<std::uint32_t, 16> next_code{};
+        for (int length = 1; length < 16; ++length) {
+            next_code[length] = (next_code[length - 1] + length_count[length - 1]) << 1;
+        }
+
+        // Entries left at zero mark codes an incomplete table does not define
+        table_.assign(std::size_t{1} << max_bits_, 0);
+        for (std::size_t symbol = 0; symbol < count; ++symbol) {
+            int length = lengths[symbol];
+            if (length == 0) {
+                continue;
+            }
+            std::uint32_t entry = static_cast<std::uint32_t>(symbol << 4) | static_cast<std::uint32_t>(length);
+            for (std::size_t k = reverse_bits(next_code[length]++, length); k < table_.size(); k += std::size_t{1} << length) {
+                table_[k] = entry;
+            }
+        }
+        return true;
+    }
+
+    auto decode(BitReader& reader) const -> int {
+        reader.need(max_bits_);
+        std::uint32_t entry = table_[reader.peek(max_bits_)];
+        if ((entry & 0xF) == 0) {
+            return -1;
+        }
+        reader.consume(static_cast<int>(entry & 0xF));
+        return static_cast<int>(entry >> 4);
+    }
+
+private:
+    std::vector<std::uint32_t> table_{0};
+    int max_bits_ = 0;
+};
+
+auto build_fixed_tables(HuffmanTable& literals, HuffmanTable& distances) -> void {
+    std::array<std::uint8_t, 288> lengths{};
+    std::fill(lengths.begin(), lengths.begin() + 144, 8);
+    std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+    std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+    std::fill(lengths.begin() + 280, lengths.end(), 8);
+    literals.build(lengths.data(), lengths.size());
+
+    std::array<std::uint8_t, 30> distance_lengths;
+    distance_lengths.fill(5);
+    distances.build(distance_lengths.data(), distance_lengths.size());
+}
+
+auto read_dynamic_tables(BitReader& reader, HuffmanTable& literals, HuffmanTable& distances) -> bool {
+    std::size_t literal_count = reader.bits(5) + 257;
+    std::size_t distance_count = reader.bits(5) + 1;
+    std::size_t code_length_count = reader.bits(4) + 4;
+
+    std::array<std::uint8_t, 19> code_length_lengths{};
+    for (std::size_t i = 0; i < code_length_count; ++i) {
+        code_length_lengths[CODE_LENGTH_ORDER[i]] = static_cast<std::uint8_t>(reader.bits(3));
+    }
+    HuffmanTable code_lengths;
+    if (!code_lengths.build(code_length_lengths.data(), code_length_lengths.size())) {
+        return false;
+    }
+
+    std::array<std::uint8_t, 320> lengths{};
+    std::size_t total = literal_count + distance_count;
+    for (std::size_t i = 0; i < total;) {
+        int symbol = code_lengths.decode(reader);
+        if (symbol < 0) {
+            return false;
+        }
+        if (symbol < 16) {
+            lengths[i++] = static_cast<std::uint8_t>(symbol);
+            continue;
+        }
+
+        std::uint8_t value = 0;
+        std::size_t repeat;
+        if (symbol == 16) {
+            if (i == 0) {
+                return false;
+            }
+            value = lengths[i - 1];
+            repeat = 3 + reader.bits(2);
+        } else if (symbol == 17) {
+            repeat = 3 + reader.bits(3);
+        } else {
+            repeat = 11 + reader.bits(7);
+        }
+        if (i + repeat > total) {
+            return false;
+        }
+        std::fill_n(lengths.begin() + static_cast<std::ptrdiff_t>(i), repeat, value);
+        i += repeat;
+    }
+
+    return !reader.exhausted() && lengths[256] != 0 &&
+           literals.build(lengths.data(), literal_count) &&
+           distances.build(lengths.data() + literal_count, distance_count);
+}
+
+auto paeth(int a, int b, int c) -> int {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Reverse one scanline filter in place; prior is the previous unfiltered row (or zeros)
+auto unfilter_row(std::uint8_t filter, std::uint8_t* row, const std::uint8_t* prior,
+                  std::size_t length, std::size_t bpp) -> bool {
+    switch (filter) {
+        case 0:
+            return true;
+        case 1:
+            for (std::size_t i = bpp; i < length; ++i) {
+                row[i] = static_cast<std::uint8_t>(row[i] + row[i - bpp]);
+            }
+            return true;
+        case 2:
+            for (std::size_t i = 0; i < length; ++i) {
+                row[i] = static_cast<std::uint8_t>(row[i] + prior[i]);
+            }
+            return true;
+        case 3:
+            for (std::size_t i = 0; i < length; ++i) {
+                int left = i >= bpp ? row[i - bpp] : 0;
+                row[i] = static_cast<std::uint8_t>(row[i] + ((left + prior[i]) >> 1));
+            }
+            return true;
+        case 4:
+            for (std::size_t i = 0; i < length; ++i) {
+                int left = i >= bpp ? row[i - bpp] : 0;
+                int upper_left = i >= bpp ? prior[i - bpp] : 0;
+                row[i] = static_cast<std::uint8_t>(row[i] + paeth(left, prior[i], upper_left));
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// |value| read as a signed byte, kept in 8-bit arithmetic so the cost loops vectorize
+auto magnitude(std::uint8_t value) -> std::uint8_t {
+    return std::min(value, static_cast<std::uint8_t>(-value));
+}
+
+// Filter one RGBA row with the cheapest of None, Sub and Up (minimum sum of absolute differences)
+auto filter_row(const std::uint8_t* row, const std::uint8_t* prior, const std::uint8_t* zero_row,
+                std::size_t length, std::uint8_t* out) -> void {
+    constexpr std::size_t bpp = 4;
+
+    // Zero-cost rows need no scoring: blank canvas (None) or a repeat of the row above (Up)
+    if (std::memcmp(row, zero_row, length) == 0) {
+        out[0] = 0;
+        std::memset(out + 1, 0, length);
+        return;
+    }
+    if (std::memcmp(row, prior, length) == 0) {
+        out[0] = 2;
+        std::memset(out + 1, 0, length);
+        return;
+    }
+    std::uint32_t cost_none = 0;
+    std::uint32_t cost_sub = 0;
+    std::uint32_t cost_up = 0;
+
+    for (std::size_t i = 0; i < bpp && i < length; ++i) {
+        cost_none += magnitude(row[i]);
+        cost_sub += magnitude(row[i]);
+        cost_up += magnitude(static_cast<std::uint8_t>(row[i] - prior[i]));
+    }
+
+    std::size_t i = bpp;
+#if defined(DUALSTACK_PNG_SSE2)
+    // psadbw against zero sums 16 byte magnitudes per instruction
+    const __m128i zero = _mm_setzero_si128();
+    auto abs8 = [zero](__m128i v) { return _mm_min_epu8(v, _mm_sub_epi8(zero, v)); };
+    __m128i sum_none = zero;
+    __m128i sum_sub = zero;
+    __m128i sum_up = zero;
+    for (; i + 16 <= length; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i - bpp));
+        __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prior + i));
+        sum_none = _mm_add_epi64(sum_none, _mm_sad_epu8(abs8(x), zero));
+        sum_sub = _mm_add_epi64(sum_sub, _mm_sad_epu8(abs8(_mm_sub_epi8(x, left)), zero));
+        sum_up = _mm_add_epi64(sum_up, _mm_sad_epu8(abs8(_mm_sub_epi8(x, up)), zero));
+    }
+    auto lanes = [](__m128i v) {
+        return static_cast<std::uint32_t>(_mm_cvtsi128_si32(v) + _mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+    };
+    cost_none += lanes(sum_none);
+    cost_sub += lanes(sum_sub);
+    cost_up += lanes(sum_up);
+#endif
+    for (; i < length; ++i) {
+        cost_none += magnitude(row[i]);
+        cost_sub += magnitude(static_cast<std::uint8_t>(row[i] - row[i - bpp]));
+        cost_up += magnitude(static_cast<std::uint8_t>(row[i] - prior[i]));
+    }
+
+    if (cost_none <= cost_sub && cost_none <= cost_up) {
+        out[0] = 0;
+        std::memcpy(out + 1, row, length);
+    } else if (cost_sub <= cost_up) {
+        out[0] = 1;
+        for (std::size_t i = 0; i < length; ++i) {
+            out[1 + i] = static_cast<std::uint8_t>(row[i] - (i >= bpp ? row[i - bpp] : 0));
+        }
+    } else {
+        out[0] = 2;
+        for (std::size_t i = 0; i < length; ++i) {
+            out[1 + i] = static_cast<std::uint8_t>(row[i] - prior[i]);
+        }
+    }
+}
+
+auto append_chunk(std::vector<std::byte>& out, std::array<char, 4> type, std::span<const std::byte> data) -> void {
+    append_be32(out, static_cast<std::uint32_t>(data.size()));
+    std::size_t start = out.size();
+    for (char c : type) {
+        out.push_back(static_cast<std::byte>(c));
+    }
+    out.insert(out.end(), data.begin(), data.end());
+    append_be32(out, codec::crc32(std::span<const std::byte>(out).subspan(start)));
+}
+
+} // anonymous namespace
+
+auto describe(PngError error) -> const char* {
+    switch (error) {
+        case PngError::invalid_signature: return "not a PNG file";
+        case PngError::truncated: return "PNG stream truncated";
+        case PngError::crc_mismatch: return "PNG chunk CRC mismatch";
+        case PngError::bad_header: return "missing or invalid PNG header";
+        case PngError::unsupported_format: return "unsupported PNG format";
+        case PngError::corrupt_data: return "corrupt PNG image data";
+        case PngError::too_large: return "PNG image too large";
+    }
+    return "unknown PNG error";
+}
+
+auto Image::pixel(std::uint32_t x, std::uint32_t y) const -> std::array<std::uint8_t, 4> {
+    std::array<std::uint8_t, 4> rgba;
+    std::memcpy(rgba.data(), &pixels[std::size_t{y} * width + x], rgba.size());
+    return rgba;
+}
+
+auto rasterize(const SignatureVisualizer::VisualSignature& sig, std::uint32_t width, std::uint32_t height,
+               Image& out) -> void {
+    out.width = width;
+    out.height = height;
+    out.pixels.assign(std::size_t{width} * height, 0);
+
+    // Radius-2 disc as five horizontal runs, matching the SVG circles
+    constexpr std::array<int, 5> HALF_WIDTH = {1, 2, 2, 2, 1};
+
+    auto fw = static_cast<float>(width);
+    auto fh = static_cast<float>(height);
+    std::size_t count = std::min(sig.points.size(), sig.colors.size());
+
+    for (std::size_t i = 0; i < count; ++i) {
+        float cx = sig.points[i][0] * fw;
+        float cy = sig.points[i][1] * fh;
+        if (!(cx > -3.0f && cx < fw + 3.0f && cy > -3.0f && cy < fh + 3.0f)) {
+            continue;  // Off canvas (or NaN)
+        }
+
+        std::uint32_t color = sig.colors[i];
+        std::array<std::uint8_t, 4> rgba = {static_cast<std::uint8_t>(color >> 16), static_cast<std::uint8_t>(color >> 8),
+                                            static_cast<std::uint8_t>(color), 0xFF};
+        std::uint32_t value;
+        std::memcpy(&value, rgba.data(), sizeof(value));
+
+        auto ix = static_cast<long>(std::floor(cx));
+        auto iy = static_cast<long>(std::floor(cy));
+        for (int dy = -2; dy <= 2; ++dy) {
+            long y = iy + dy;
+            if (y < 0 || y >= static_cast<long>(height)) {
+                continue;
+            }
+            long x0 = std::max(ix - HALF_WIDTH[dy + 2], 0L);
+            long x1 = std::min(ix + HALF_WIDTH[dy + 2], static_cast<long>(width) - 1);
+            if (x0 <= x1) {
+                std::uint32_t* row = out.pixels.data() + static_cast<std::size_t>(y) * width;
+                std::fill(row + x0, row + x1 + 1, value);
+            }
+        }
+    }
+}
+
+auto encode(const Image& image, std::span<const std::byte> signature_chunk) -> std::vector<std::byte> {
+    std::vector<std::byte> out;
+    out.reserve(64 + signature_chunk.size() + image.pixels.size());
+    for (std::uint8_t b : PNG_SIGNATURE) {
+        out.push_back(static_cast<std::byte>(b));
+    }
+
+    std::array<std::byte, 13> header{};
+    for (int i = 0; i < 4; ++i) {
+        header[i] = static_cast<std::byte>(image.width >> (24 - 8 * i));
+        header[4 + i] = static_cast<std::byte>(image.height >> (24 - 8 * i));
+    }
+    header[8] = std::byte{8};   // Bit depth
+    header[9] = std::byte{6};   // Truecolor with alpha
+    append_chunk(out, {'I', 'H', 'D', 'R'}, header);
+
+    if (!signature_chunk.empty()) {
+        append_chunk(out, SIGNATURE_CHUNK, signature_chunk);
+    }
+
+    // Filtered scanlines, each prefixed by its filter type
+    std::size_t row_bytes = std::size_t{image.width} * 4;
+    std::vector<std::uint8_t> filtered(std::size_t{image.height} * (row_bytes + 1));
+    std::vector<std::uint8_t> zero_row(row_bytes, 0);
+    const auto* pixels = reinterpret_cast<const std::uint8_t*>(image.pixels.data());
+    for (std::size_t y = 0; y < image.height; ++y) {
+        const std::uint8_t* prior = y == 0 ? zero_row.data() : pixels + (y - 1) * row_bytes;
+        filter_row(pixels + y * row_bytes, prior, zero_row.data(), row_bytes, filtered.data() + y * (row_bytes + 1));
+    }
+
+    // IDAT is deflated straight into the output, then its length and CRC patched in
+    std::size_t length_offset = out.size();
+    append_be32(out, 0);
+    for (char c : {'I', 'D', 'A', 'T'}) {
+        out.push_back(static_cast<std::byte>(c));
+    }
+    deflate_fast(std::as_bytes(std::span(filtered)), out);
+    auto length = static_cast<std::uint32_t>(out.size() - length_offset - 8);
+    for (int i = 0; i < 4; ++i) {
+        out[length_offset + static_cast<std::size_t>(i)] = static_cast<std::byte>(length >> (24 - 8 * i));
+    }
+    append_be32(out, codec::crc32(std::span<const std::byte>(out).subspan(length_offset + 4)));
+
+    append_chunk(out, {'I', 'E', 'N', 'D'}, {});
+    return out;
+}
+
+auto deflate_fast(std::span<const std::byte> input, std::vector<std::byte>& out) -> void {
+    out.push_back(std::byte{0x78});  // 32K window, deflate
+    out.push_back(std::byte{0x01});  // Fastest compression level, check bits
+
+    BitWriter writer(out);
+    writer.put(1, 1);  // Final block
+    writer.put(1, 2);  // Fixed Huffman codes
+
+    const auto* data = reinterpret_cast<const std::uint8_t*>(input.data());
+    std::size_t size = input.size();
+    std::vector<std::int32_t> head(std::size_t{1} << HASH_BITS, -1);
+
+    auto emit_literal = [&](std::uint8_t literal) {
+        writer.put(FIXED_LITERAL_CODES[literal].bits, FIXED_LITERAL_CODES[literal].length);
+    };
+
+    std::size_t i = 0;
+    while (i + 4 <= size) {
+        std::uint32_t word = load_u32(data + i);
+        std::size_t hash = (word * 2654435761u) >> (32 - HASH_BITS);
+        std::int32_t candidate = head[hash];
+        head[hash] = static_cast<std::int32_t>(i);
+
+        // Single probe: take the most recent position with the same hash if its bytes match
+        if (candidate >= 0 && i - static_cast<std::size_t>(candidate) <= MAX_DISTANCE &&
+            load_u32(data + candidate) == word) {
+            std::size_t distance = i - static_cast<std::size_t>(candidate);
+            std::size_t length = 4 + match_length(data + candidate + 4, data + i + 4,
+                                                  std::min(MAX_MATCH, size - i) - 4);
+
+            std::uint8_t symbol = LENGTH_SYMBOLS[length];
+            const FixedCode& code = FIXED_LITERAL_CODES[257 + symbol];
+            writer.put(code.bits, code.length);
+            writer.put(static_cast<std::uint32_t>(length - LENGTH_BASE[symbol]), LENGTH_EXTRA[symbol]);
+
+            std::size_t d = distance - 1;
+            std::uint8_t distance_code = DISTANCE_CODES[d < 256 ? d : 256 + (d >> 7)];
+            writer.put(reverse_bits(distance_code, 5), 5);
+            writer.put(static_cast<std::uint32_t>(distance - DIST_BASE[distance_code]), DIST_EXTRA[distance_code]);
+
+            i += length;
+            continue;
+        }
+
+        emit_literal(data[i++]);
+    }
+    while (i < size) {
+        emit_literal(data[i++]);
+    }
+
+    writer.put(FIXED_LITERAL_CODES[256].bits, FIXED_LITERAL_CODES[256].length);
+    writer.finish();
+    append_be32(out, adler32(input));
+}
+
+// Resumable zlib inflater. Each step (block header, one literal or match, a
+// run of stored bytes, the trailer) is decoded from a copy of the bit reader
+// and only committed if the input held all of it; otherwise the step is
+// retried once more input arrives. Output accumulates in a window that keeps
+// the last 32 KiB for back-references after the caller has taken it.
+class Inflater {
+public:
+    enum class Status : std::uint8_t {
+        need_input,
+        output_ready,       // At least OUTPUT_CHUNK bytes are waiting to be taken
+        done
+    };
+
+    static constexpr std::size_t OUTPUT_CHUNK = 64 * 1024;
+
+    explicit Inflater(std::size_t max_output) : max_output_(max_output) {}
+
+    auto feed(std::span<const std::byte> data) -> void {
+        input_.insert(input_.end(), data.begin(), data.end());
+    }
+
+    auto run() -> std::expected<Status, PngError>;
+
+    // Output not yet taken by the caller
+    auto available() const -> std::span<const std::uint8_t> {
+        return std::span(window_).subspan(taken_);
+    }
+
+    auto take(std::size_t count) -> void {
+        taken_ += count;
+    }
+
+    auto finished() const -> bool { return state_ == State::done; }
+
+private:
+    enum class State : std::uint8_t { zlib_header, block_header, codes, stored, trailer, done };
+
+    auto produced(std::size_t count) -> bool {
+        total_ += count;
+        return total_ <= max_output_;
+    }
+
+    auto compact() -> void;
+
+    std::size_t max_output_;
+    std::vector<std::byte> input_;              // Unconsumed input, starting at the resume point
+    std::uint64_t bits_ = 0;                    // Bits already pulled from consumed input
+    int bit_count_ = 0;
+    State state_ = State::zlib_header;
+    bool final_block_ = false;
+    std::size_t stored_remaining_ = 0;
+    HuffmanTable literals_;
+    HuffmanTable distances_;
+    std::vector<std::uint8_t> window_;
+    std::size_t taken_ = 0;
+    std::size_t checked_ = 0;                   // Window bytes already folded into adler_
+    std::size_t total_ = 0;
+    std::uint32_t adler_ = 1;
+};
+
+auto Inflater::compact() -> void {
+    adler_ = adler32(std::as_bytes(std::span(window_).subspan(checked_)), adler_);
+    checked_ = window_.size();
+
+    // Keep a full deflate window behind anything the caller has not taken
+    std::size_t keep_from = std::min(taken_, window_.size() > MAX_DISTANCE ? window_.size() - MAX_DISTANCE : 0);
+    if (keep_from >= OUTPUT_CHUNK) {
+        window_.erase(window_.begin(), window_.begin() + static_cast<std::ptrdiff_t>(keep_from));
+        taken_ -= keep_from;
+        checked_ -= keep_from;
+    }
+}
+
+auto Inflater::run() -> std::expected<Status, PngError> {
+    compact();
+    BitReader reader(input_, bits_, bit_count_);
+
+    auto suspend = [&](const BitReader& at) {
+        bits_ = at.buffered();
+        bit_count_ = at.buffered_bits();
+        input_.erase(input_.begin(), input_.begin() + static_cast<std::ptrdiff_t>(at.position()));
+    };
+
+    for (;;) {
+        if (window_.size() - taken_ >= OUTPUT_CHUNK && state_ != State::done) {
+            suspend(reader);
+            return Status::output_ready;
+        }
+
+        BitReader step = reader;
+        switch (state_) {
+            case State::zlib_header: {
+                std::uint32_t cmf = step.bits(8);
+                std::uint32_t flg = step.bits(8);
+                if (step.exhausted()) {
+                    break;
+                }
+                if ((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20) != 0) {
+                    return std::unexpected(PngError::corrupt_data);
+                }
+                state_ = State::block_header;
+                reader = step;
+                continue;
+            }
+
+            case State::block_header: {
+                bool final_block = step.bits(1) != 0;
+                std::uint32_t type = step.bits(2);
+                bool tables_ok = true;
+                std::uint32_t length = 0;
+                std::uint32_t complement = 0;
+                if (type == 0) {
+                    step.align();
+                    length = step.bits(16);
+                    complement = step.bits(16);
+                } else if (type == 1) {
+                    build_fixed_tables(literals_, distances_);
+                } else if (type == 2) {
+                    tables_ok = read_dynamic_tables(step, literals_, distances_);
+                }
+                if (step.exhausted()) {
+                    break;
+                }
+                if (type == 3 || !tables_ok || (type == 0 && (length ^ 0xFFFF) != complement)) {
+                    return std::unexpected(PngError::corrupt_data);
+                }
+                final_block_ = final_block;
+                stored_remaining_ = length;
+                state_ = type == 0 ? State::stored : State::codes;
+                reader = step;
+                continue;
+            }
+
+            case State::stored: {
+                if (stored_remaining_ == 0) {
+                    state_ = final_block_ ? State::trailer : State::block_header;
+                    continue;
+                }
+                std::size_t before = window_.size();
+                window_.resize(before + std::min(stored_remaining_, OUTPUT_CHUNK));
+                std::size_t copied = reader.take_available(window_.data() + before, window_.size() - before);
+                window_.resize(before + copied);
+                stored_remaining_ -= copied;
+                if (!produced(copied)) {
+                    return std::unexpected(PngError::corrupt_data);
+                }
+                if (copied == 0) {
+                    break;
+                }
+                continue;
+            }
+
+            case State::codes: {
+                int symbol = literals_.decode(step);
+                if (step.exhausted()) {
+                    break;
+                }
+                if (symbol < 0) {
+                    return std::unexpected(PngError::corrupt_data);
+                }
+                if (symbol < 256) {
+                    if (!produced(1)) {
+                        return std::unexpected(PngError::corrupt_data);
+                    }
+                    window_.push_back(static_cast<std::uint8_t>(symbol));
+                    reader = step;
+                    continue;
+                }
+                if (symbol == 256) {
+                    state_ = final_block_ ? State::trailer : State::block_header;
+                    reader = step;
+                    continue;
+                }
+
+                std::size_t length_symbol = static_cast<std::size_t>(symbol) - 257;
+                if (length_symbol >= LENGTH_BASE.size()) {
+                    return std::unexpected(PngError::corrupt_data);
+                }
+                std::size_t length = LENGTH_BASE[length_symbol] + step.bits(LENGTH_EXTRA[length_symbol]);
+                int distance_symbol = distances_.decode(step);
+                std::size_t distance = 0;
+                if (distance_symbol >= 0 && distance_symbol < static_cast<int>(DIST_BASE.size())) {
+                    distance = DIST_BASE[distance_symbol] + step.bits(DIST_EXTRA[distance_symbol]);
+                }
+                if (step.exhausted()) {
+                    break;
+                }
+                // Distances reach back through the whole stream, not just the retained window
+                if (distance == 0 || distance > total_ || distance > window_.size() || !produced(length)) {
+                    return std::unexpected(PngError::corrupt_data);
+                }
+
+                std::size_t start = window_.size();
+                window_.resize(start + length);
+                std::uint8_t* target = window_.data() + start;
+                const std::uint8_t* source = target - distance;
+                if (distance >= length) {
+                    std::memcpy(target, source, length);
+                } else if (distance == 1) {
+                    std::memset(target, *source, length);
+                } else {
+                    for (std::size_t k = 0; k < length; ++k) {
+                        target[k] = source[k];
+                    }
+                }
+                reader = step;
+                continue;
+            }
+
+            case State::trailer: {
+                step.align();
+                std::uint32_t expected_adler = 0;
+                for (int i = 0; i < 4; ++i) {
+                    expected_adler = (expected_adler << 8) | step.bits(8);
+                }
+                if (step.exhausted()) {
+                    break;
+                }
+                compact();
+                if (expected_adler != adler_) {
+                    return std::unexpected(PngError::corrupt_data);
+                }
+                state_ = State::done;
+                reader = step;
+                continue;
+            }
+
+            case State::done:
+                suspend(reader);
+                return Status::done;
+        }
+
+        // The step ran out of input: resume from its start next time
+        suspend(reader);
+        return Status::need_input;
+    }
+}
+
+auto inflate(std::span<const std::byte> zlib_stream, std::span<std::byte> out) -> std::expected<std::size_t, PngError> {
+    Inflater inflater(out.size());
+    inflater.feed(zlib_stream);
+    std::size_t written = 0;
+    for (;;) {
+        auto status = inflater.run();
+        if (!status) {
+            return std::unexpected(status.error());
+        }
+        auto ready = inflater.available();
+        std::memcpy(out.data() + written, ready.data(), ready.size());
+        written += ready.size();
+        inflater.take(ready.size());
+        if (*status == Inflater::Status::done) {
+            return written;
+        }
+        if (*status == Inflater::Status::need_input) {
+            return std::unexpected(PngError::corrupt_data);     // Stream ended early
+        }
+    }
+}
+
+auto adler32(std::span<const std::byte> data, std::uint32_t adler) -> std::uint32_t {
+    constexpr std::uint32_t MOD = 65521;
+    constexpr std::size_t NMAX = 5552;  // Largest block before the sums can overflow 32 bits
+
+    std::uint32_t a = adler & 0xFFFF;
+    std::uint32_t b = adler >> 16;
+    const auto* p = reinterpret_cast<const std::uint8_t*>(data.data());
+    std::size_t remaining = data.size();
+
+    while (remaining > 0) {
+        std::size_t block = std::min(remaining, NMAX);
+        remaining -= block;
+
+#if defined(DUALSTACK_PNG_SSE2)
+        // 16 bytes at a time: psadbw accumulates a, pmaddwd the position-weighted bytes for b;
+        // prefix sums of a are kept per lane and folded in as 16 * sum at the end of the block
+        if (block >= 16) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i weights_low = _mm_set_epi16(9, 10, 11, 12, 13, 14, 15, 16);
+            const __m128i weights_high = _mm_set_epi16(1, 2, 3, 4, 5, 6, 7, 8);
+            __m128i sum_a = zero;
+            __m128i prefix_a = zero;
+            __m128i sum_b = zero;
+            std::size_t chunks = block / 16;
+            for (std::size_t c = 0; c < chunks; ++c, p += 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                prefix_a = _mm_add_epi32(prefix_a, sum_a);
+                sum_a = _mm_add_epi32(sum_a, _mm_sad_epu8(v, zero));
+                sum_b = _mm_add_epi32(sum_b, _mm_madd_epi16(_mm_unpacklo_epi8(v, zero), weights_low));
+                sum_b = _mm_add_epi32(sum_b, _mm_madd_epi16(_mm_unpackhi_epi8(v, zero), weights_high));
+            }
+            auto total = [](__m128i v) {
+                alignas(16) std::array<std::uint32_t, 4> lane;
+                _mm_store_si128(reinterpret_cast<__m128i*>(lane.data()), v);
+                return std::uint64_t{lane[0]} + lane[1] + lane[2] + lane[3];
+            };
+            std::uint64_t new_b = b + 16 * (chunks * std::uint64_t{a} + total(prefix_a)) + total(sum_b);
+            a = static_cast<std::uint32_t>((a + total(sum_a)) % MOD);
+            b = static_cast<std::uint32_t>(new_b % MOD);
+            block -= chunks * 16;
+        }
+#else
+        // 32 bytes at a time: b advances by 32a plus the position-weighted byte sum,
+        // which breaks the serial a -> b dependency
+        for (; block >= 32; block -= 32, p += 32) {
+            std::uint32_t sum = 0;
+            std::uint32_t weighted = 0;
+            for (std::uint32_t k = 0; k < 32; ++k) {
+                sum += p[k];
+                weighted += (32 - k) * p[k];
+            }
+            b += 32 * a + weighted;
+            a += sum;
+        }
+#endif
+        for (; block > 0; --block) {
+            a += *p++;
+            b += a;
+        }
+        a %= MOD;
+        b %= MOD;
+    }
+    return (b << 16) | a;
+}
+
+auto PngDecoder::feed(std::span<const std::byte> data) -> std::expected<bool, PngError> {
+    if (done_) {
+        return true;
+    }
+
+    // Parse straight from the caller's buffer unless a partial chunk is pending
+    std::span<const std::byte> input = data;
+    if (!pending_.empty()) {
+        pending_.insert(pending_.end(), data.begin(), data.end());
+        input = pending_;
+    }
+
+    std::size_t position = 0;
+    if (!signature_seen_) {
+        if (input.size() < PNG_SIGNATURE.size()) {
+            if (pending_.empty()) {
+                pending_.assign(input.begin(), input.end());
+            }
+            return false;
+        }
+        for (std::size_t i = 0; i < PNG_SIGNATURE.size(); ++i) {
+            if (std::to_integer<std::uint8_t>(input[i]) != PNG_SIGNATURE[i]) {
+                return std::unexpected(PngError::invalid_signature);
+            }
+        }
+        signature_seen_ = true;
+        position = PNG_SIGNATURE.size();
+    }
+
+    while (!done_ && input.size() - position >= 12) {
+        std::uint32_t length = load_be32(input.data() + position);
+        if (length > 0x7FFFFFFFu) {
+            return std::unexpected(PngError::corrupt_data);
+        }
+        if (input.size() - position - 12 < length) {
+            break;  // Wait for the rest of this chunk
+        }
+
+        auto type_and_data = input.subspan(position + 4, std::size_t{length} + 4);
+        if (codec::crc32(type_and_data) != load_be32(input.data() + position + 8 + length)) {
+            return std::unexpected(PngError::crc_mismatch);
+        }
+
+        std::array<char, 4> type;
+        for (std::size_t i = 0; i < type.size(); ++i) {
+            type[i] = static_cast<char>(type_and_data[i]);
+        }
+        auto result = process_chunk(type, type_and_data.subspan(4));
+        if (!result) {
+            return std::unexpected(result.error());
+        }
+        position += std::size_t{length} + 12;
+    }
+
+    if (input.data() == pending_.data()) {
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(position));
+    } else if (!done_) {
+        pending_.assign(input.begin() + static_cast<std::ptrdiff_t>(position), input.end());
+    }
+    return done_;
+}
+
+auto PngDecoder::process_chunk(std::array<char, 4> type, std::span<const std::byte> data) -> std::expected<void, PngError> {
+    auto is = [&type](const char* name) { return std::equal(type.begin(), type.end(), name); };
+
+    if (is("IHDR")) {
+        if (header_seen_ || data.size() != 13) {
+            return std::unexpected(PngError::bad_header);
+        }
+        image_.width = load_be32(data.data());
+        image_.height = load_be32(data.data() + 4);
+        auto depth = std::to_integer<std::uint8_t>(data[8]);
+        color_type_ = std::to_integer<std::uint8_t>(data[9]);
+        if (image_.width == 0 || image_.height == 0) {
+            return std::unexpected(PngError::bad_header);
+        }
+        if (image_.width > MAX_DIMENSION || image_.height > MAX_DIMENSION ||
+            std::uint64_t{image_.width} * image_.height > MAX_PIXELS) {
+            return std::unexpected(PngError::too_large);
+        }
+        if (depth != 8 || (color_type_ != 6 && color_type_ != 2) || data[10] != std::byte{0} ||
+            data[11] != std::byte{0} || data[12] != std::byte{0}) {
+            return std::unexpected(PngError::unsupported_format);
+        }
+
+        std::size_t row_bytes = std::size_t{image_.width} * (color_type_ == 6 ? 4 : 3);
+        inflater_ = std::make_unique<Inflater>(std::size_t{image_.height} * (row_bytes + 1));
+        row_.resize(row_bytes + 1);
+        prior_row_.assign(row_bytes, 0);
+        header_seen_ = true;
+        return {};
+    }
+
+    if (!header_seen_) {
+        return std::unexpected(PngError::bad_header);  // IHDR must come first
+    }
+
+    if (is("IDAT")) {
+        return inflate_rows(data);
+    } else if (is("IEND")) {
+        if (!inflater_->finished() || rows_done_ != image_.height) {
+            return std::unexpected(PngError::corrupt_data);     // Image data ended early
+        }
+        done_ = true;
+    } else if (type == SIGNATURE_CHUNK) {
+        signature_chunk_.assign(data.begin(), data.end());
+    } else if (!is("PLTE") && (type[0] & 0x20) == 0) {
+        return std::unexpected(PngError::unsupported_format);  // Unknown critical chunk
+    }
+    return {};
+}
+
+auto PngDecoder::inflate_rows(std::span<const std::byte> data) -> std::expected<void, PngError> {
+    if (inflater_->finished()) {
+        return data.empty() ? std::expected<void, PngError>{} : std::unexpected(PngError::corrupt_data);
+    }
+    inflater_->feed(data);
+
+    std::size_t bpp = color_type_ == 6 ? 4 : 3;
+    std::size_t row_bytes = prior_row_.size();
+    for (;;) {
+        auto status = inflater_->run();
+        if (!status) {
+            return std::unexpected(status.error());
+        }
+
+        // Filtered rows are copied out: the deflate window must keep them as sent
+        auto ready = inflater_->available();
+        std::size_t offset = 0;
+        for (; ready.size() - offset >= row_.size(); offset += row_.size()) {
+            std::memcpy(row_.data(), ready.data() + offset, row_.size());
+            if (!unfilter_row(row_[0], row_.data() + 1, prior_row_.data(), row_bytes, bpp)) {
+                return std::unexpected(PngError::corrupt_data);
+            }
+            std::memcpy(prior_row_.data(), row_.data() + 1, row_bytes);
+
+            std::size_t first = image_.pixels.size();
+            image_.pixels.resize(first + image_.width);
+            auto* target = reinterpret_cast<std::uint8_t*>(image_.pixels.data() + first);
+            if (bpp == 4) {
+                std::memcpy(target, prior_row_.data(), row_bytes);
+            } else {
+                for (std::size_t x = 0; x < image_.width; ++x) {
+                    std::memcpy(target + x * 4, prior_row_.data() + x * 3, 3);
+                    target[x * 4 + 3] = 0xFF;
+                }
+            }
+            ++rows_done_;
+        }
+        inflater_->take(offset);
+
+        if (*status != Inflater::Status::output_ready) {
+            return {};
+        }
+    }
+}
+
+PngDecoder::PngDecoder() = default;
+PngDecoder::~PngDecoder() = default;
+PngDecoder::PngDecoder(PngDecoder&&) noexcept = default;
+auto PngDecoder::operator=(PngDecoder&&) noexcept -> PngDecoder& = default;
+
+auto PngDecoder::release() -> DecodedPng {
+    return DecodedPng{std::move(image_), std::move(signature_chunk_)};
+}
+
+auto decode(std::span<const std::byte> data) -> std::expected<DecodedPng, PngError> {
+    PngDecoder decoder;
+    auto complete = decoder.feed(data);
+    if (!complete) {
+        return std::unexpected(complete.error());
+    }
+    if (!*complete) {
+        return std::unexpected(PngError::truncated);
+    }
+    return decoder.release();
+}
+
+} // namespace dualstack::security::visualization::png
@@ -0,0 +1,124 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "signature_visualizer.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Self-contained PNG support for visual signatures
+// Encoding rasterizes the point cloud into 8-bit RGBA, filters each row with
+// the cheapest of None/Sub/Up and compresses with a single-probe LZ77 deflate
+// using the fixed Huffman code. The exact signature travels alongside the
+// pixels in a private "avSg" chunk (signature_codec.h format), so readers do
+// not have to recover points from the raster.
+
+namespace dualstack::security::visualization::png {
+
+// Ancillary, private, safe-to-copy chunk carrying the encoded signature
+inline constexpr std::array<char, 4> SIGNATURE_CHUNK = {'a', 'v', 'S', 'g'};
+
+// Largest image the decoder will allocate for: each side, and in total
+// (16M pixels, 64 MiB of RGBA)
+inline constexpr std::uint32_t MAX_DIMENSION = 16384;
+inline constexpr std::uint64_t MAX_PIXELS = std::uint64_t{1} << 24;
+
+enum class PngError : std::uint8_t {
+    invalid_signature,      // Missing the 8-byte PNG signature
+    truncated,              // Stream ended before IEND
+    crc_mismatch,
+    bad_header,             // IHDR missing, repeated or inconsistent
+    unsupported_format,     // Only 8-bit RGB/RGBA, non-interlaced
+    corrupt_data,           // Invalid deflate stream, filter type or chunk order
+    too_large
+};
+
+auto describe(PngError error) -> const char*;
+
+// 8-bit RGBA image; each pixel holds bytes (r, g, b, a) in memory order
+struct Image {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::vector<std::uint32_t> pixels;
+
+    auto bytes() const -> std::span<const std::byte> { return std::as_bytes(std::span(pixels)); }
+    auto pixel(std::uint32_t x, std::uint32_t y) const -> std::array<std::uint8_t, 4>;
+};
+
+// Draw each point as a radius-2 dot of its color on a transparent canvas
+auto rasterize(const SignatureVisualizer::VisualSignature& sig, std::uint32_t width, std::uint32_t height,
+               Image& out) -> void;
+
+// Encode to PNG, optionally embedding the signature chunk payload
+auto encode(const Image& image, std::span<const std::byte> signature_chunk = {}) -> std::vector<std::byte>;
+
+// Append a zlib stream (RFC 1950) wrapping a fast fixed-Huffman deflate
+auto deflate_fast(std::span<const std::byte> input, std::vector<std::byte>& out) -> void;
+
+// Inflate a zlib stream into out; returns the number of bytes produced
+auto inflate(std::span<const std::byte> zlib_stream, std::span<std::byte> out) -> std::expected<std::size_t, PngError>;
+
+auto adler32(std::span<const std::byte> data, std::uint32_t adler = 1) -> std::uint32_t;
+
+struct DecodedPng {
+    Image image;
+    std::vector<std::byte> signature_chunk;     // Empty if the PNG carries no signature
+};
+
+class Inflater;
+
+// Incremental PNG decoder: feed the file in pieces of any size. IDAT data is
+// inflated as it arrives and each scanline is unfiltered once complete, so
+// beyond the image itself only a 32 KiB deflate window and two rows are held.
+class PngDecoder {
+public:
+    PngDecoder();
+    ~PngDecoder();
+    PngDecoder(PngDecoder&&) noexcept;
+    auto operator=(PngDecoder&&) noexcept -> PngDecoder&;
+
+    // Consume more input; true once IEND has been reached and the image decoded
+    auto feed(std::span<const std::byte> data) -> std::expected<bool, PngError>;
+
+    auto done() const -> bool { return done_; }
+    auto image() const -> const Image& { return image_; }
+    auto signature_chunk() const -> std::span<const std::byte> { return signature_chunk_; }
+
+    // Move the decoded image and chunk out (call once done())
+    auto release() -> DecodedPng;
+
+private:
+    auto process_chunk(std::array<char, 4> type, std::span<const std::byte> data) -> std::expected<void, PngError>;
+    auto inflate_rows(std::span<const std::byte> data) -> std::expected<void, PngError>;
+
+    std::vector<std::byte> pending_;            // Bytes of an incomplete chunk
+    std::unique_ptr<Inflater> inflater_;        // Created by IHDR
+    std::vector<std::uint8_t> row_;             // Filter byte and scanline being unfiltered
+    std::vector<std::uint8_t> prior_row_;       // Previous unfiltered scanline (zeros for the first)
+    std::uint32_t rows_done_ = 0;
+    std::vector<std::byte> signature_chunk_;
+    Image image_;
+    std::uint8_t color_type_ = 0;
+    bool signature_seen_ = false;
+    bool header_seen_ = false;
+    bool done_ = false;
+};
+
+// Decode a complete PNG held in memory
+auto decode(std::span<const std::byte> data) -> std::expected<DecodedPng, PngError>;
+
+} // namespace dualstack::security::visualization::png
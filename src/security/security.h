@@ -59,12 +59,12 @@ public:
     // Construction with security constraints
     SecureSocket(const class IPAddress& addr, std::uint16_t port);
     
-    ~SecureSocket();
+    virtual ~SecureSocket();
     
-    // Secure data transfer with bounds checking
-    auto secure_send(secure_span<const std::byte> data) -> std::size_t;
+    // Secure data transfer with bounds checking (TLSSecureSocket layers TLS over these)
+    virtual auto secure_send(secure_span<const std::byte> data) -> std::size_t;
     
-    auto secure_receive(secure_span<std::byte> buffer) -> std::size_t;
+    virtual auto secure_receive(secure_span<std::byte> buffer) -> std::size_t;
     
     // Connection security
     auto enable_encryption() -> bool;
@@ -0,0 +1,289 @@
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "signature_codec.h"
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace dualstack::security::visualization::codec {
+
+namespace {
+
+static_assert(sizeof(std::array<float, 2>) == 8, "points are encoded as packed float32 pairs");
+static_assert(sizeof(float) == sizeof(std::uint32_t), "float32 payload requires 32-bit float");
+
+constexpr bool NATIVE_LITTLE_ENDIAN = std::endian::native == std::endian::little;
+
+// Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero bytes
+constexpr auto make_crc_tables() -> std::array<std::array<std::uint32_t, 256>, 8> {
+    std::array<std::array<std::uint32_t, 256>, 8> tables{};
+    for (std::uint32_t b = 0; b < 256; ++b) {
+        std::uint32_t crc = b;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+        tables[0][b] = crc;
+    }
+    for (std::size_t k = 1; k < 8; ++k) {
+        for (std::size_t b = 0; b < 256; ++b) {
+            tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr auto CRC_TABLES = make_crc_tables();
+
+auto load_u16(const std::byte* p) -> std::uint16_t {
+    return static_cast<std::uint16_t>(std::to_integer<std::uint16_t>(p[0]) |
+                                      (std::to_integer<std::uint16_t>(p[1]) << 8));
+}
+
+auto load_u32(const std::byte* p) -> std::uint32_t {
+    return std::to_integer<std::uint32_t>(p[0]) | (std::to_integer<std::uint32_t>(p[1]) << 8) |
+           (std::to_integer<std::uint32_t>(p[2]) << 16) | (std::to_integer<std::uint32_t>(p[3]) << 24);
+}
+
+auto load_u64(const std::byte* p) -> std::uint64_t {
+    return static_cast<std::uint64_t>(load_u32(p)) | (static_cast<std::uint64_t>(load_u32(p + 4)) << 32);
+}
+
+auto store_u16(std::byte* p, std::uint16_t v) -> void {
+    p[0] = static_cast<std::byte>(v);
+    p[1] = static_cast<std::byte>(v >> 8);
+}
+
+auto store_u32(std::byte* p, std::uint32_t v) -> void {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<std::byte>(v >> (8 * i));
+    }
+}
+
+auto store_u64(std::byte* p, std::uint64_t v) -> void {
+    store_u32(p, static_cast<std::uint32_t>(v));
+    store_u32(p + 4, static_cast<std::uint32_t>(v >> 32));
+}
+
+// Copy 32-bit words between native memory and the little-endian payload
+auto copy_words_out(std::byte* out, const void* words, std::size_t count) -> void {
+    if constexpr (NATIVE_LITTLE_ENDIAN) {
+        std::memcpy(out, words, count * 4);
+    } else {
+        const auto* src = static_cast<const std::byte*>(words);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint32_t word;
+            std::memcpy(&word, src + i * 4, 4);
+            store_u32(out + i * 4, word);
+        }
+    }
+}
+
+auto copy_words_in(void* words, const std::byte* in, std::size_t count) -> void {
+    if constexpr (NATIVE_LITTLE_ENDIAN) {
+        std::memcpy(words, in, count * 4);
+    } else {
+        auto* dst = static_cast<std::byte*>(words);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint32_t word = load_u32(in + i * 4);
+            std::memcpy(dst + i * 4, &word, 4);
+        }
+    }
+}
+
+struct Header {
+    std::uint16_t version;
+    std::uint16_t header_size;
+    std::uint32_t point_count;
+    std::uint32_t color_count;
+    std::uint64_t complexity;
+    std::uint64_t visual_checksum;
+    std::uint32_t payload_crc;
+};
+
+// Structural checks shared by view() and deserialize(); the CRC is checked by the caller
+auto parse_header(std::span<const std::byte> data) -> std::expected<Header, CodecError> {
+    if (data.size() < SIGNATURE_HEADER_SIZE) {
+        return std::unexpected(CodecError::truncated);
+    }
+
+    const std::byte* p = data.data();
+    if (load_u32(p) != SIGNATURE_MAGIC) {
+        return std::unexpected(CodecError::bad_magic);
+    }
+
+    Header header{};
+    header.version = load_u16(p + 4);
+    header.header_size = load_u16(p + 6);
+    if (header.version != SIGNATURE_VERSION || header.header_size != SIGNATURE_HEADER_SIZE) {
+        return std::unexpected(CodecError::unsupported_version);
+    }
+
+    header.point_count = load_u32(p + 8);
+    header.color_count = load_u32(p + 12);
+    header.complexity = load_u64(p + 16);
+    header.visual_checksum = load_u64(p + 24);
+    header.payload_crc = load_u32(p + 32);
+
+    // 64-bit arithmetic: 2^32 points * 8 bytes cannot overflow here
+    std::uint64_t needed = SIGNATURE_HEADER_SIZE + std::uint64_t{header.point_count} * 8 +
+                           std::uint64_t{header.color_count} * 4;
+    if (data.size() < needed) {
+        return std::unexpected(CodecError::truncated);
+    }
+    return header;
+}
+
+auto payload_of(std::span<const std::byte> data, const Header& header) -> std::span<const std::byte> {
+    return data.subspan(SIGNATURE_HEADER_SIZE,
+                        std::size_t{header.point_count} * 8 + std::size_t{header.color_count} * 4);
+}
+
+} // anonymous namespace
+
+auto describe(CodecError error) -> const char* {
+    switch (error) {
+        case CodecError::buffer_too_small: return "output buffer too small";
+        case CodecError::truncated: return "encoded signature truncated";
+        case CodecError::bad_magic: return "not an encoded signature";
+        case CodecError::unsupported_version: return "unsupported signature format version";
+        case CodecError::checksum_mismatch: return "signature payload checksum mismatch";
+        case CodecError::misaligned: return "buffer not suitable for a zero-copy view";
+        case CodecError::too_large: return "signature too large to encode";
+    }
+    return "unknown codec error";
+}
+
+auto SignatureView::to_signature() const -> SignatureVisualizer::VisualSignature {
+    SignatureVisualizer::VisualSignature sig{};
+    sig.points.assign(points.begin(), points.end());
+    sig.colors.assign(colors.begin(), colors.end());
+    sig.complexity = complexity;
+    sig.visual_checksum = visual_checksum;
+    return sig;
+}
+
+auto encoded_size(const SignatureVisualizer::VisualSignature& sig) -> std::size_t {
+    return encoded_size(sig.points.size(), sig.colors.size());
+}
+
+auto serialize(const SignatureVisualizer::VisualSignature& sig,
+               std::span<std::byte> out) -> std::expected<std::size_t, CodecError> {
+    constexpr auto count_limit = std::numeric_limits<std::uint32_t>::max();
+    if (sig.points.size() > count_limit || sig.colors.size() > count_limit) {
+        return std::unexpected(CodecError::too_large);
+    }
+
+    std::size_t size = encoded_size(sig);
+    if (out.size() < size) {
+        return std::unexpected(CodecError::buffer_too_small);
+    }
+
+    std::byte* p = out.data();
+    std::byte* payload = p + SIGNATURE_HEADER_SIZE;
+    copy_words_out(payload, sig.points.data(), sig.points.size() * 2);
+    copy_words_out(payload + sig.points.size() * 8, sig.colors.data(), sig.colors.size());
+
+    store_u32(p, SIGNATURE_MAGIC);
+    store_u16(p + 4, SIGNATURE_VERSION);
+    store_u16(p + 6, static_cast<std::uint16_t>(SIGNATURE_HEADER_SIZE));
+    store_u32(p + 8, static_cast<std::uint32_t>(sig.points.size()));
+    store_u32(p + 12, static_cast<std::uint32_t>(sig.colors.size()));
+    store_u64(p + 16, sig.complexity);
+    store_u64(p + 24, sig.visual_checksum);
+    store_u32(p + 32, crc32({payload, size - SIGNATURE_HEADER_SIZE}));
+    store_u32(p + 36, 0);
+
+    return size;
+}
+
+auto serialize(const SignatureVisualizer::VisualSignature& sig) -> std::vector<std::byte> {
+    std::vector<std::byte> out(encoded_size(sig));
+    if (!serialize(sig, out)) {
+        out.clear();
+    }
+    return out;
+}
+
+auto view(std::span<const std::byte> data) -> std::expected<SignatureView, CodecError> {
+    auto header = parse_header(data);
+    if (!header) {
+        return std::unexpected(header.error());
+    }
+
+    if (!NATIVE_LITTLE_ENDIAN || reinterpret_cast<std::uintptr_t>(data.data()) % alignof(std::uint32_t) != 0) {
+        return std::unexpected(CodecError::misaligned);
+    }
+
+    auto payload = payload_of(data, *header);
+    if (crc32(payload) != header->payload_crc) {
+        return std::unexpected(CodecError::checksum_mismatch);
+    }
+
+    // The payload was written as float32/uint32 words, so it is read back in place
+    const std::byte* points = payload.data();
+    const std::byte* colors = points + std::size_t{header->point_count} * 8;
+
+    SignatureView result{};
+    result.version = header->version;
+    result.complexity = static_cast<std::size_t>(header->complexity);
+    result.visual_checksum = header->visual_checksum;
+    result.points = {reinterpret_cast<const std::array<float, 2>*>(points), header->point_count};
+    result.colors = {reinterpret_cast<const std::uint32_t*>(colors), header->color_count};
+    return result;
+}
+
+auto deserialize(std::span<const std::byte> data) -> std::expected<SignatureVisualizer::VisualSignature, CodecError> {
+    auto header = parse_header(data);
+    if (!header) {
+        return std::unexpected(header.error());
+    }
+
+    auto payload = payload_of(data, *header);
+    if (crc32(payload) != header->payload_crc) {
+        return std::unexpected(CodecError::checksum_mismatch);
+    }
+
+    SignatureVisualizer::VisualSignature sig{};
+    sig.points.resize(header->point_count);
+    sig.colors.resize(header->color_count);
+    copy_words_in(sig.points.data(), payload.data(), sig.points.size() * 2);
+    copy_words_in(sig.colors.data(), payload.data() + sig.points.size() * 8, sig.colors.size());
+    sig.complexity = static_cast<std::size_t>(header->complexity);
+    sig.visual_checksum = header->visual_checksum;
+    return sig;
+}
+
+auto record_size(std::span<const std::byte> data) -> std::expected<std::size_t, CodecError> {
+    auto header = parse_header(data);
+    if (!header) {
+        return std::unexpected(header.error());
+    }
+    return encoded_size(header->point_count, header->color_count);
+}
+
+auto is_encoded_signature(std::span<const std::byte> data) -> bool {
+    return data.size() >= 4 && load_u32(data.data()) == SIGNATURE_MAGIC;
+}
+
+auto crc32(std::span<const std::byte> data, std::uint32_t crc) -> std::uint32_t {
+    const std::byte* p = data.data();
+    std::size_t n = data.size();
+    crc = ~crc;
+
+    while (n >= 8) {
+        std::uint32_t lo = load_u32(p) ^ crc;
+        std::uint32_t hi = load_u32(p + 4);
+        crc = CRC_TABLES[7][lo & 0xFF] ^ CRC_TABLES[6][(lo >> 8) & 0xFF] ^
+              CRC_TABLES[5][(lo >> 16) & 0xFF] ^ CRC_TABLES[4][lo >> 24] ^
+              CRC_TABLES[3][hi & 0xFF] ^ CRC_TABLES[2][(hi >> 8) & 0xFF] ^
+              CRC_TABLES[1][(hi >> 16) & 0xFF] ^ CRC_TABLES[0][hi >> 24];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) {
+        crc = (crc >> 8) ^ CRC_TABLES[0][(crc ^ std::to_integer<std::uint32_t>(*p++)) & 0xFF];
+    }
+    return ~crc;
+}
+
+} // namespace dualstack::security::visualization::codec
@@ -0,0 +1,98 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "signature_visualizer.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <vector>
+
+// Versioned binary wire format for VisualSignature
+//
+//   offset  size  field
+//        0     4  magic "AVSG"
+//        4     2  version
+//        6     2  header size (bytes from start to payload)
+//        8     4  point count
+//       12     4  color count
+//       16     8  complexity
+//       24     8  visual checksum
+//       32     4  CRC-32 of the payload
+//       36     4  reserved (zero)
+//       40        points as float32 (x, y) pairs, then colors as uint32 ARGB
+//
+// All fields are little-endian. The payload starts 8-byte aligned, so a buffer
+// that is itself 4-byte aligned can be read in place on little-endian hosts.
+
+namespace dualstack::security::visualization::codec {
+
+inline constexpr std::uint32_t SIGNATURE_MAGIC = 0x47535641;  // "AVSG" read little-endian
+inline constexpr std::uint16_t SIGNATURE_VERSION = 1;
+inline constexpr std::size_t SIGNATURE_HEADER_SIZE = 40;
+
+enum class CodecError : std::uint8_t {
+    buffer_too_small,       // Output span cannot hold encoded_size() bytes
+    truncated,              // Input shorter than its header claims
+    bad_magic,
+    unsupported_version,
+    checksum_mismatch,      // Payload CRC-32 does not match the header
+    misaligned,             // Zero-copy view needs 4-byte alignment on a little-endian host
+    too_large               // Point or color count does not fit the 32-bit header fields
+};
+
+auto describe(CodecError error) -> const char*;
+
+// Read-only view over an encoded signature; spans point into the caller's buffer
+struct SignatureView {
+    std::uint16_t version;
+    std::size_t complexity;
+    std::uint64_t visual_checksum;
+    std::span<const std::array<float, 2>> points;
+    std::span<const std::uint32_t> colors;
+
+    // Copy into an owning signature (metadata fields are not part of the wire format)
+    auto to_signature() const -> SignatureVisualizer::VisualSignature;
+};
+
+// Bytes needed to encode a signature with these counts
+constexpr auto encoded_size(std::size_t point_count, std::size_t color_count) -> std::size_t {
+    return SIGNATURE_HEADER_SIZE + point_count * 8 + color_count * 4;
+}
+
+auto encoded_size(const SignatureVisualizer::VisualSignature& sig) -> std::size_t;
+
+// Encode into a caller-owned buffer; returns the number of bytes written
+auto serialize(const SignatureVisualizer::VisualSignature& sig,
+               std::span<std::byte> out) -> std::expected<std::size_t, CodecError>;
+
+// Encode into a freshly sized vector
+auto serialize(const SignatureVisualizer::VisualSignature& sig) -> std::vector<std::byte>;
+
+// Validate and view an encoded signature without copying the payload
+auto view(std::span<const std::byte> data) -> std::expected<SignatureView, CodecError>;
+
+// Validate and decode into an owning signature (works on any alignment or endianness)
+auto deserialize(std::span<const std::byte> data) -> std::expected<SignatureVisualizer::VisualSignature, CodecError>;
+
+// Size of the encoded signature at the start of data, from its header alone (payload not checked)
+auto record_size(std::span<const std::byte> data) -> std::expected<std::size_t, CodecError>;
+
+// True if the buffer starts with the signature magic
+auto is_encoded_signature(std::span<const std::byte> data) -> bool;
+
+// CRC-32 (IEEE 802.3, reflected 0xEDB88320); pass a previous result to continue
+auto crc32(std::span<const std::byte> data, std::uint32_t crc = 0) -> std::uint32_t;
+
+} // namespace dualstack::security::visualization::codec
@@ -0,0 +1,163 @@
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "signature_index.h"
+#include "signature_kernels.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace dualstack::security::visualization {
+
+auto SignatureReferenceSet::make_sketch(std::span<const std::uint32_t> colors) -> Sketch {
+    Sketch sketch{};
+    std::size_t n = colors.size();
+    for (std::size_t segment = 0; segment < SKETCH_SEGMENTS; ++segment) {
+        std::size_t begin = segment * n / SKETCH_SEGMENTS;
+        std::size_t end = (segment + 1) * n / SKETCH_SEGMENTS;
+        if (begin == end) {
+            continue;
+        }
+        std::uint64_t r = 0, g = 0, b = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            r += (colors[i] >> 16) & 0xFF;
+            g += (colors[i] >> 8) & 0xFF;
+            b += colors[i] & 0xFF;
+        }
+        std::uint64_t count = end - begin;
+        sketch[segment * 3] = static_cast<std::uint8_t>((r + count / 2) / count);
+        sketch[segment * 3 + 1] = static_cast<std::uint8_t>((g + count / 2) / count);
+        sketch[segment * 3 + 2] = static_cast<std::uint8_t>((b + count / 2) / count);
+    }
+    return sketch;
+}
+
+auto SignatureReferenceSet::sketches_compatible(const Sketch& a, const Sketch& b) -> bool {
+    for (std::size_t segment = 0; segment < SKETCH_SEGMENTS; ++segment) {
+        int diff = 0;
+        for (std::size_t channel = 0; channel < 3; ++channel) {
+            diff += std::abs(static_cast<int>(a[segment * 3 + channel]) - static_cast<int>(b[segment * 3 + channel]));
+        }
+        if (diff > SKETCH_TOLERANCE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto SignatureReferenceSet::add(const SignatureVisualizer::VisualSignature& sig) -> std::size_t {
+    Reference reference{};
+    reference.point_offset = xs_.size();
+    reference.point_count = sig.points.size();
+    reference.color_offset = colors_.size();
+    reference.color_count = sig.colors.size();
+    reference.sketch = make_sketch(sig.colors);
+
+    for (const auto& point : sig.points) {
+        xs_.push_back(point[0]);
+        ys_.push_back(point[1]);
+    }
+    colors_.insert(colors_.end(), sig.colors.begin(), sig.colors.end());
+
+    std::size_t index = references_.size();
+    references_.push_back(reference);
+    by_point_count_[reference.point_count].push_back(index);
+    return index;
+}
+
+auto SignatureReferenceSet::clear() -> void {
+    references_.clear();
+    xs_.clear();
+    ys_.clear();
+    colors_.clear();
+    by_point_count_.clear();
+}
+
+auto SignatureReferenceSet::authenticate(const SignatureVisualizer::VisualSignature& probe,
+                                         SearchStats* stats) const -> std::optional<std::size_t> {
+    SearchStats local{};
+    SearchStats& counters = stats ? *stats : local;
+    counters = {};
+
+    auto bucket = by_point_count_.find(probe.points.size());
+    if (bucket == by_point_count_.end()) {
+        return std::nullopt;
+    }
+
+    auto probe_soa = SignatureVisualizer::PointSoA::from_points(probe.points);
+    Sketch probe_sketch = make_sketch(probe.colors);
+    float max_squared = tolerance_ * tolerance_;
+    std::size_t n = probe.points.size();
+
+    for (std::size_t index : bucket->second) {
+        const Reference& reference = references_[index];
+        ++counters.candidates;
+        if (reference.color_count != probe.colors.size() || !sketches_compatible(reference.sketch, probe_sketch)) {
+            continue;
+        }
+        ++counters.sketch_passed;
+
+        std::span<const float> xs(xs_.data() + reference.point_offset, n);
+        std::span<const float> ys(ys_.data() + reference.point_offset, n);
+        if (!kernels::points_within_soa(probe_soa.x, probe_soa.y, xs, ys, max_squared)) {
+            continue;
+        }
+        ++counters.points_passed;
+
+        const std::uint32_t* colors = colors_.data() + reference.color_offset;
+        bool colors_ok = true;
+        for (std::size_t i = 0; i < reference.color_count && colors_ok; ++i) {
+            colors_ok = SignatureVisualizer::VisualPassword::colors_match(probe.colors[i], colors[i]);
+        }
+        if (colors_ok) {
+            return index;
+        }
+    }
+    return std::nullopt;
+}
+
+auto SignatureReferenceSet::nearest(const SignatureVisualizer::VisualSignature& probe, float min_score,
+                                    SearchStats* stats) const -> std::optional<Match> {
+    SearchStats local{};
+    SearchStats& counters = stats ? *stats : local;
+    counters = {};
+
+    auto bucket = by_point_count_.find(probe.points.size());
+    if (bucket == by_point_count_.end() || bucket->second.empty()) {
+        return std::nullopt;
+    }
+
+    std::size_t n = probe.points.size();
+    if (n == 0) {
+        counters.candidates = 1;
+        return Match{bucket->second.front(), 1.0f};
+    }
+
+    // score = 1 - total / (n * tolerance), so the bound on the total distance
+    // tightens as better matches are found and each scan stops once it is exceeded
+    float scale = static_cast<float>(n) * tolerance_;
+    float limit = min_score > 0.0f ? (1.0f - min_score) * scale : std::numeric_limits<float>::infinity();
+    auto probe_soa = SignatureVisualizer::PointSoA::from_points(probe.points);
+
+    std::optional<std::size_t> best;
+    float best_total = limit;
+    for (std::size_t index : bucket->second) {
+        const Reference& reference = references_[index];
+        ++counters.candidates;
+
+        std::span<const float> xs(xs_.data() + reference.point_offset, n);
+        std::span<const float> ys(ys_.data() + reference.point_offset, n);
+        float total = kernels::distance_sum_soa(probe_soa.x, probe_soa.y, xs, ys, best_total);
+        if (total < best_total || (!best && total <= best_total)) {
+            ++counters.points_passed;
+            best = index;
+            best_total = total;
+        }
+    }
+
+    if (!best) {
+        return std::nullopt;
+    }
+    return Match{*best, std::max(0.0f, 1.0f - best_total / scale)};
+}
+
+} // namespace dualstack::security::visualization
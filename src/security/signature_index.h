@@ -0,0 +1,91 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "signature_visualizer.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// Search over many stored reference signatures
+// References are bucketed by point count (VisualPassword only accepts equal
+// sizes) and their coordinates kept in SoA arenas for the vectorized distance
+// kernels. Each reference also carries a color sketch: the rounded mean RGB
+// of eight color segments. Two signatures whose colors all match within
+// VisualPassword's tolerance cannot differ by more than SKETCH_TOLERANCE in
+// any segment, so the sketch rejects most candidates without false negatives.
+
+namespace dualstack::security::visualization {
+
+class SignatureReferenceSet {
+public:
+    static constexpr std::size_t SKETCH_SEGMENTS = 8;
+
+    // Colour tolerance (30) plus one unit of rounding per channel
+    static constexpr int SKETCH_TOLERANCE = 33;
+
+    using Sketch = std::array<std::uint8_t, SKETCH_SEGMENTS * 3>;
+
+    struct Match {
+        std::size_t index;
+        float score;        // Same scale as VisualPassword::get_similarity_score
+    };
+
+    // Work done by one search, for tuning the coarse index
+    struct SearchStats {
+        std::size_t candidates = 0;         // References with the probe's point count
+        std::size_t sketch_passed = 0;
+        std::size_t points_passed = 0;
+    };
+
+    explicit SignatureReferenceSet(float tolerance = 0.1f) : tolerance_(tolerance) {}
+
+    // Store a reference; returns its index
+    auto add(const SignatureVisualizer::VisualSignature& sig) -> std::size_t;
+
+    auto size() const -> std::size_t { return references_.size(); }
+    auto tolerance() const -> float { return tolerance_; }
+    auto clear() -> void;
+
+    // First reference the probe authenticates against (VisualPassword semantics)
+    auto authenticate(const SignatureVisualizer::VisualSignature& probe,
+                      SearchStats* stats = nullptr) const -> std::optional<std::size_t>;
+
+    // Reference with the best similarity score, if any reaches min_score
+    auto nearest(const SignatureVisualizer::VisualSignature& probe, float min_score = 0.0f,
+                 SearchStats* stats = nullptr) const -> std::optional<Match>;
+
+    static auto make_sketch(std::span<const std::uint32_t> colors) -> Sketch;
+
+private:
+    struct Reference {
+        std::size_t point_offset;
+        std::size_t point_count;
+        std::size_t color_offset;
+        std::size_t color_count;
+        Sketch sketch;
+    };
+
+    static auto sketches_compatible(const Sketch& a, const Sketch& b) -> bool;
+
+    float tolerance_;
+    std::vector<Reference> references_;
+    std::vector<float> xs_;
+    std::vector<float> ys_;
+    std::vector<std::uint32_t> colors_;
+    std::unordered_map<std::size_t, std::vector<std::size_t>> by_point_count_;
+};
+
+} // namespace dualstack::security::visualization
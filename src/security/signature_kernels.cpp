@@ -0,0 +1,940 @@
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "signature_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define DUALSTACK_KERNELS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define DUALSTACK_TARGET_AVX2
+    #else
+        #define DUALSTACK_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define DUALSTACK_KERNELS_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// NOTE: this file must be compiled without floating-point contraction
+// (-ffp-contract=off, set in CMakeLists.txt); a fused multiply-add in one
+// path but not another would make signatures differ between machines.
+
+namespace dualstack::security::visualization::kernels {
+
+namespace {
+
+constexpr bool little_endian = std::endian::native == std::endian::little;
+
+// Starting x for each orbit; all orbits start at y = 0.1
+constexpr float LANE_SEED_X[ORBIT_LANES] = {0.10f, 0.11f, 0.12f, 0.13f, 0.14f, 0.15f, 0.16f, 0.17f};
+constexpr float SEED_Y = 0.1f;
+
+// Cody-Waite split of pi/2 and minimax sin/cos on [-pi/4, pi/4] (Cephes single precision)
+constexpr float TWO_OVER_PI = 0.636619772367581f;
+constexpr float PIO2_1 = 1.5703125f;
+constexpr float PIO2_2 = 4.837512969970703125e-4f;
+constexpr float PIO2_3 = 7.54978995489188216e-8f;
+constexpr float SIN_1 = -1.6666654611e-1f;
+constexpr float SIN_2 = 8.3321608736e-3f;
+constexpr float SIN_3 = -1.9515295891e-4f;
+constexpr float COS_1 = 4.166664568298827e-2f;
+constexpr float COS_2 = -1.388731625493765e-3f;
+constexpr float COS_3 = 2.443315711809948e-5f;
+
+// Largest value whose float -> uint32 truncation every ISA agrees on
+constexpr float CHECKSUM_LIMIT = 2147483648.0f;
+
+// ============================================================================
+// Scalar reference
+// The vector kernels repeat these exact operations in the same order.
+// ============================================================================
+
+inline void sincos_scalar(float t, float& sin_out, float& cos_out) {
+    float k = std::nearbyint(t * TWO_OVER_PI);
+    float r = t - k * PIO2_1;
+    r = r - k * PIO2_2;
+    r = r - k * PIO2_3;
+    float z = r * r;
+
+    float ps = z * SIN_3;
+    ps = SIN_2 + ps;
+    ps = z * ps;
+    ps = SIN_1 + ps;
+    float rz = r * z;
+    float s = r + rz * ps;
+
+    float pc = z * COS_3;
+    pc = COS_2 + pc;
+    pc = z * pc;
+    pc = COS_1 + pc;
+    float zz = z * z;
+    float c = 1.0f - 0.5f * z;
+    c = c + zz * pc;
+
+    // Quadrant: sin = [s, c, -s, -c][q], cos = [c, -s, -c, s][q]
+    int q = static_cast<int>(k);
+    float sin_v = (q & 1) ? c : s;
+    float cos_v = (q & 1) ? s : c;
+    sin_out = (q & 2) ? -sin_v : sin_v;
+    cos_out = ((q + 1) & 2) ? -cos_v : cos_v;
+}
+
+inline float normalize_scalar(float v) {
+    float n = (v + 5.0f) / 10.0f;
+    n = n < 1.0f ? n : 1.0f;
+    return n > 0.0f ? n : 0.0f;
+}
+
+// Ikeda map step for one orbit; returns the normalized point
+inline void ikeda_step_scalar(float a, float b, float& x, float& y, float& norm_x, float& norm_y) {
+    float r2 = x * x + y * y;
+    float t = 0.4f - 6.0f / (1.0f + r2);
+    float s, c;
+    sincos_scalar(t, s, c);
+    float x_new = 1.0f + a * (x * c - y * s);
+    float y_new = b * (x * s + y * c);
+    norm_x = normalize_scalar(x_new);
+    norm_y = normalize_scalar(y_new);
+    x = x_new;
+    y = y_new;
+}
+
+template<typename Store>
+void orbits_scalar(float a, float b, std::size_t count, Store&& store) {
+    float x[ORBIT_LANES];
+    float y[ORBIT_LANES];
+    for (std::size_t lane = 0; lane < ORBIT_LANES; ++lane) {
+        x[lane] = LANE_SEED_X[lane];
+        y[lane] = SEED_Y;
+    }
+
+    for (std::size_t k = 0; k < count; ++k) {
+        std::size_t lane = k % ORBIT_LANES;
+        float nx, ny;
+        ikeda_step_scalar(a, b, x[lane], y[lane], nx, ny);
+        store(k, nx, ny);
+    }
+}
+
+void chaotic_orbits_scalar(float a, float b, std::span<float> xs, std::span<float> ys) {
+    orbits_scalar(a, b, xs.size(), [&](std::size_t k, float nx, float ny) {
+        xs[k] = nx;
+        ys[k] = ny;
+    });
+}
+
+void chaotic_orbits_interleaved_scalar(float a, float b, std::span<std::array<float, 2>> points) {
+    orbits_scalar(a, b, points.size(), [&](std::size_t k, float nx, float ny) {
+        points[k] = {nx, ny};
+    });
+}
+
+inline std::uint32_t pack_color(const std::byte* data, std::size_t available) {
+    std::uint8_t r = static_cast<std::uint8_t>(data[0]);
+    std::uint8_t g = available > 1 ? static_cast<std::uint8_t>(data[1]) : 0;
+    std::uint8_t b = available > 2 ? static_cast<std::uint8_t>(data[2]) : 0;
+    std::uint8_t a = available > 3 ? static_cast<std::uint8_t>(data[3]) : 255;
+    return (static_cast<std::uint32_t>(a) << 24) |
+           (static_cast<std::uint32_t>(r) << 16) |
+           (static_cast<std::uint32_t>(g) << 8) |
+           static_cast<std::uint32_t>(b);
+}
+
+void encode_colors_scalar(std::span<const std::byte> data, std::span<std::uint32_t> colors, std::size_t from = 0) {
+    for (std::size_t i = from * 4, c = from; i < data.size(); i += 4, ++c) {
+        colors[c] = pack_color(data.data() + i, data.size() - i);
+    }
+}
+
+void decode_colors_scalar(std::span<const std::uint32_t> colors, std::span<std::byte> data, std::size_t from = 0) {
+    for (std::size_t c = from; c < colors.size(); ++c) {
+        std::uint32_t color = colors[c];
+        data[c * 4] = static_cast<std::byte>((color >> 16) & 0xFF);
+        data[c * 4 + 1] = static_cast<std::byte>((color >> 8) & 0xFF);
+        data[c * 4 + 2] = static_cast<std::byte>(color & 0xFF);
+        data[c * 4 + 3] = static_cast<std::byte>((color >> 24) & 0xFF);
+    }
+}
+
+std::uint64_t checksum_coordinates_scalar(const float* coords, std::size_t count) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += static_cast<std::uint64_t>(coords[i] * 1000);
+    }
+    return sum;
+}
+
+std::uint64_t checksum_colors_scalar(const std::uint32_t* colors, std::size_t count) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += colors[i];
+    }
+    return sum;
+}
+
+std::uint64_t checksum_scalar(std::span<const std::array<float, 2>> points, std::span<const std::uint32_t> colors) {
+    return checksum_coordinates_scalar(points.empty() ? nullptr : points.data()->data(), points.size() * 2) +
+           checksum_colors_scalar(colors.data(), colors.size());
+}
+
+// Distance sums test their budget once per this many points
+constexpr std::size_t BUDGET_CHECK_POINTS = 64;
+
+// Point comparisons over strided coordinates: stride 2 for interleaved points, 1 for SoA
+bool points_within_scalar(const float* ax, const float* ay, const float* bx, const float* by,
+                          std::size_t stride, std::size_t count, float max_squared) {
+    for (std::size_t i = 0; i < count; ++i) {
+        float dx = ax[i * stride] - bx[i * stride];
+        float dy = ay[i * stride] - by[i * stride];
+        if (!(dx * dx + dy * dy <= max_squared)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+float distance_sum_scalar(const float* ax, const float* ay, const float* bx, const float* by,
+                          std::size_t stride, std::size_t count, float budget) {
+    float total = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        float dx = ax[i * stride] - bx[i * stride];
+        float dy = ay[i * stride] - by[i * stride];
+        total += std::sqrt(dx * dx + dy * dy);
+        if ((i + 1) % BUDGET_CHECK_POINTS == 0 && total > budget) {
+            return total;
+        }
+    }
+    return total;
+}
+
+// ============================================================================
+// AVX2 (x86, selected at runtime)
+// ============================================================================
+
+#if defined(DUALSTACK_KERNELS_X86)
+
+DUALSTACK_TARGET_AVX2
+inline void sincos_avx2(__m256 t, __m256& sin_out, __m256& cos_out) {
+    __m256 k = _mm256_round_ps(_mm256_mul_ps(t, _mm256_set1_ps(TWO_OVER_PI)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_sub_ps(t, _mm256_mul_ps(k, _mm256_set1_ps(PIO2_1)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(k, _mm256_set1_ps(PIO2_2)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(k, _mm256_set1_ps(PIO2_3)));
+    __m256 z = _mm256_mul_ps(r, r);
+
+    __m256 ps = _mm256_mul_ps(z, _mm256_set1_ps(SIN_3));
+    ps = _mm256_add_ps(_mm256_set1_ps(SIN_2), ps);
+    ps = _mm256_mul_ps(z, ps);
+    ps = _mm256_add_ps(_mm256_set1_ps(SIN_1), ps);
+    __m256 rz = _mm256_mul_ps(r, z);
+    __m256 s = _mm256_add_ps(r, _mm256_mul_ps(rz, ps));
+
+    __m256 pc = _mm256_mul_ps(z, _mm256_set1_ps(COS_3));
+    pc = _mm256_add_ps(_mm256_set1_ps(COS_2), pc);
+    pc = _mm256_mul_ps(z, pc);
+    pc = _mm256_add_ps(_mm256_set1_ps(COS_1), pc);
+    __m256 zz = _mm256_mul_ps(z, z);
+    __m256 c = _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), z));
+    c = _mm256_add_ps(c, _mm256_mul_ps(zz, pc));
+
+    __m256i q = _mm256_cvtps_epi32(k);
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)),
+                                                         _mm256_set1_epi32(1)));
+    __m256 sin_v = _mm256_blendv_ps(s, c, swap);
+    __m256 cos_v = _mm256_blendv_ps(c, s, swap);
+
+    // Negate by flipping the sign bit where the quadrant calls for it
+    __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+    __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+    sin_out = _mm256_xor_ps(sin_v, sin_sign);
+    cos_out = _mm256_xor_ps(cos_v, cos_sign);
+}
+
+DUALSTACK_TARGET_AVX2
+inline __m256 normalize_avx2(__m256 v) {
+    __m256 n = _mm256_div_ps(_mm256_add_ps(v, _mm256_set1_ps(5.0f)), _mm256_set1_ps(10.0f));
+    n = _mm256_min_ps(n, _mm256_set1_ps(1.0f));
+    return _mm256_max_ps(n, _mm256_setzero_ps());
+}
+
+DUALSTACK_TARGET_AVX2
+inline void ikeda_step_avx2(__m256 a, __m256 b, __m256& x, __m256& y, __m256& norm_x, __m256& norm_y) {
+    __m256 r2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+    __m256 t = _mm256_sub_ps(_mm256_set1_ps(0.4f),
+                             _mm256_div_ps(_mm256_set1_ps(6.0f), _mm256_add_ps(_mm256_set1_ps(1.0f), r2)));
+    __m256 s, c;
+    sincos_avx2(t, s, c);
+    __m256 x_new = _mm256_add_ps(_mm256_set1_ps(1.0f),
+                                 _mm256_mul_ps(a, _mm256_sub_ps(_mm256_mul_ps(x, c), _mm256_mul_ps(y, s))));
+    __m256 y_new = _mm256_mul_ps(b, _mm256_add_ps(_mm256_mul_ps(x, s), _mm256_mul_ps(y, c)));
+    norm_x = normalize_avx2(x_new);
+    norm_y = normalize_avx2(y_new);
+    x = x_new;
+    y = y_new;
+}
+
+DUALSTACK_TARGET_AVX2
+void chaotic_orbits_avx2(float a, float b, std::span<float> xs, std::span<float> ys) {
+    __m256 va = _mm256_set1_ps(a);
+    __m256 vb = _mm256_set1_ps(b);
+    __m256 x = _mm256_loadu_ps(LANE_SEED_X);
+    __m256 y = _mm256_set1_ps(SEED_Y);
+
+    std::size_t count = xs.size();
+    std::size_t k = 0;
+    for (; k + ORBIT_LANES <= count; k += ORBIT_LANES) {
+        __m256 nx, ny;
+        ikeda_step_avx2(va, vb, x, y, nx, ny);
+        _mm256_storeu_ps(xs.data() + k, nx);
+        _mm256_storeu_ps(ys.data() + k, ny);
+    }
+    if (k < count) {
+        alignas(32) float tail_x[ORBIT_LANES];
+        alignas(32) float tail_y[ORBIT_LANES];
+        __m256 nx, ny;
+        ikeda_step_avx2(va, vb, x, y, nx, ny);
+        _mm256_store_ps(tail_x, nx);
+        _mm256_store_ps(tail_y, ny);
+        std::copy(tail_x, tail_x + (count - k), xs.data() + k);
+        std::copy(tail_y, tail_y + (count - k), ys.data() + k);
+    }
+}
+
+DUALSTACK_TARGET_AVX2
+void chaotic_orbits_interleaved_avx2(float a, float b, std::span<std::array<float, 2>> points) {
+    __m256 va = _mm256_set1_ps(a);
+    __m256 vb = _mm256_set1_ps(b);
+    __m256 x = _mm256_loadu_ps(LANE_SEED_X);
+    __m256 y = _mm256_set1_ps(SEED_Y);
+    float* out = points.empty() ? nullptr : points.data()->data();
+
+    std::size_t count = points.size();
+    for (std::size_t k = 0; k < count; k += ORBIT_LANES) {
+        __m256 nx, ny;
+        ikeda_step_avx2(va, vb, x, y, nx, ny);
+
+        // SoA registers -> interleaved (x, y) pairs
+        __m256 lo = _mm256_unpacklo_ps(nx, ny);   // x0 y0 x1 y1 | x4 y4 x5 y5
+        __m256 hi = _mm256_unpackhi_ps(nx, ny);   // x2 y2 x3 y3 | x6 y6 x7 y7
+        __m256 first = _mm256_permute2f128_ps(lo, hi, 0x20);
+        __m256 second = _mm256_permute2f128_ps(lo, hi, 0x31);
+
+        if (k + ORBIT_LANES <= count) {
+            _mm256_storeu_ps(out + k * 2, first);
+            _mm256_storeu_ps(out + k * 2 + 8, second);
+        } else {
+            alignas(32) float tail[ORBIT_LANES * 2];
+            _mm256_store_ps(tail, first);
+            _mm256_store_ps(tail + 8, second);
+            std::copy(tail, tail + (count - k) * 2, out + k * 2);
+        }
+    }
+}
+
+// Swaps bytes 0 and 2 of every 32-bit group: (r, g, b, a) <-> ARGB little-endian (b, g, r, a)
+DUALSTACK_TARGET_AVX2
+inline __m256i swap_red_blue_avx2(__m256i v) {
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                             2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+DUALSTACK_TARGET_AVX2
+void encode_colors_avx2(std::span<const std::byte> data, std::span<std::uint32_t> colors) {
+    std::size_t c = 0;
+    for (; (c + 8) * 4 <= data.size(); c += 8) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data.data() + c * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors.data() + c), swap_red_blue_avx2(bytes));
+    }
+    encode_colors_scalar(data, colors, c);
+}
+
+DUALSTACK_TARGET_AVX2
+void decode_colors_avx2(std::span<const std::uint32_t> colors, std::span<std::byte> data) {
+    std::size_t c = 0;
+    for (; c + 8 <= colors.size(); c += 8) {
+        __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colors.data() + c));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data.data() + c * 4), swap_red_blue_avx2(words));
+    }
+    decode_colors_scalar(colors, data, c);
+}
+
+DUALSTACK_TARGET_AVX2
+inline __m256i widen_add_avx2(__m256i acc, __m256i words) {
+    acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(words)));
+    return _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(words, 1)));
+}
+
+DUALSTACK_TARGET_AVX2
+inline std::uint64_t horizontal_sum_avx2(__m256i acc) {
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+DUALSTACK_TARGET_AVX2
+std::uint64_t checksum_avx2(std::span<const std::array<float, 2>> points, std::span<const std::uint32_t> colors) {
+    const float* coords = points.empty() ? nullptr : points.data()->data();
+    std::size_t coord_count = points.size() * 2;
+    __m256i acc = _mm256_setzero_si256();
+    std::uint64_t scalar_sum = 0;
+
+    const __m256 scale = _mm256_set1_ps(1000.0f);
+    const __m256 limit = _mm256_set1_ps(CHECKSUM_LIMIT);
+    std::size_t i = 0;
+    for (; i + 8 <= coord_count; i += 8) {
+        __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(coords + i), scale);
+        // Only [0, 2^31) truncates identically everywhere; anything else takes the reference path
+        __m256 in_range = _mm256_and_ps(_mm256_cmp_ps(scaled, _mm256_setzero_ps(), _CMP_GE_OQ),
+                                        _mm256_cmp_ps(scaled, limit, _CMP_LT_OQ));
+        if (_mm256_movemask_ps(in_range) != 0xFF) {
+            scalar_sum += checksum_coordinates_scalar(coords + i, 8);
+            continue;
+        }
+        acc = widen_add_avx2(acc, _mm256_cvttps_epi32(scaled));
+    }
+    scalar_sum += checksum_coordinates_scalar(coords + i, coord_count - i);
+
+    std::size_t c = 0;
+    for (; c + 8 <= colors.size(); c += 8) {
+        acc = widen_add_avx2(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colors.data() + c)));
+    }
+    scalar_sum += checksum_colors_scalar(colors.data() + c, colors.size() - c);
+
+    return horizontal_sum_avx2(acc) + scalar_sum;
+}
+
+DUALSTACK_TARGET_AVX2
+inline float horizontal_sum_ps_avx2(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+// Squared distances of four interleaved points, each in both lanes of its (x, y) pair
+DUALSTACK_TARGET_AVX2
+inline __m256 pair_distance_squared_avx2(const float* a, const float* b) {
+    __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b));
+    __m256 squared = _mm256_mul_ps(d, d);
+    return _mm256_add_ps(squared, _mm256_permute_ps(squared, 0xB1));
+}
+
+DUALSTACK_TARGET_AVX2
+bool points_within_avx2(const float* a, const float* b, std::size_t count, float max_squared) {
+    const __m256 limit = _mm256_set1_ps(max_squared);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256 within = _mm256_cmp_ps(pair_distance_squared_avx2(a + 2 * i, b + 2 * i), limit, _CMP_LE_OQ);
+        if (_mm256_movemask_ps(within) != 0xFF) {
+            return false;
+        }
+    }
+    return points_within_scalar(a + 2 * i, a + 2 * i + 1, b + 2 * i, b + 2 * i + 1, 2, count - i, max_squared);
+}
+
+DUALSTACK_TARGET_AVX2
+bool points_within_soa_avx2(const float* ax, const float* ay, const float* bx, const float* by,
+                            std::size_t count, float max_squared) {
+    const __m256 limit = _mm256_set1_ps(max_squared);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(ax + i), _mm256_loadu_ps(bx + i));
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ay + i), _mm256_loadu_ps(by + i));
+        __m256 squared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        if (_mm256_movemask_ps(_mm256_cmp_ps(squared, limit, _CMP_LE_OQ)) != 0xFF) {
+            return false;
+        }
+    }
+    return points_within_scalar(ax + i, ay + i, bx + i, by + i, 1, count - i, max_squared);
+}
+
+DUALSTACK_TARGET_AVX2
+float distance_sum_avx2(const float* a, const float* b, std::size_t count, float budget) {
+    float total = 0.0f;
+    std::size_t i = 0;
+    while (i + 4 <= count) {
+        __m256 acc = _mm256_setzero_ps();
+        std::size_t block_end = std::min(count & ~std::size_t{3}, i + BUDGET_CHECK_POINTS);
+        for (; i < block_end; i += 4) {
+            // Keep one copy of each distance (even lanes)
+            __m256 distance = _mm256_sqrt_ps(pair_distance_squared_avx2(a + 2 * i, b + 2 * i));
+            acc = _mm256_add_ps(acc, _mm256_blend_ps(distance, _mm256_setzero_ps(), 0xAA));
+        }
+        total += horizontal_sum_ps_avx2(acc);
+        if (total > budget) {
+            return total;
+        }
+    }
+    return total + distance_sum_scalar(a + 2 * i, a + 2 * i + 1, b + 2 * i, b + 2 * i + 1, 2, count - i, budget - total);
+}
+
+DUALSTACK_TARGET_AVX2
+float distance_sum_soa_avx2(const float* ax, const float* ay, const float* bx, const float* by,
+                            std::size_t count, float budget) {
+    float total = 0.0f;
+    std::size_t i = 0;
+    while (i + 8 <= count) {
+        __m256 acc = _mm256_setzero_ps();
+        std::size_t block_end = std::min(count & ~std::size_t{7}, i + BUDGET_CHECK_POINTS);
+        for (; i < block_end; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(ax + i), _mm256_loadu_ps(bx + i));
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ay + i), _mm256_loadu_ps(by + i));
+            acc = _mm256_add_ps(acc, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy))));
+        }
+        total += horizontal_sum_ps_avx2(acc);
+        if (total > budget) {
+            return total;
+        }
+    }
+    return total + distance_sum_scalar(ax + i, ay + i, bx + i, by + i, 1, count - i, budget - total);
+}
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // DUALSTACK_KERNELS_X86
+
+// ============================================================================
+// NEON (AArch64, always available)
+// ============================================================================
+
+#if defined(DUALSTACK_KERNELS_NEON)
+
+inline void sincos_neon(float32x4_t t, float32x4_t& sin_out, float32x4_t& cos_out) {
+    float32x4_t k = vrndnq_f32(vmulq_f32(t, vdupq_n_f32(TWO_OVER_PI)));
+    float32x4_t r = vsubq_f32(t, vmulq_f32(k, vdupq_n_f32(PIO2_1)));
+    r = vsubq_f32(r, vmulq_f32(k, vdupq_n_f32(PIO2_2)));
+    r = vsubq_f32(r, vmulq_f32(k, vdupq_n_f32(PIO2_3)));
+    float32x4_t z = vmulq_f32(r, r);
+
+    float32x4_t ps = vmulq_f32(z, vdupq_n_f32(SIN_3));
+    ps = vaddq_f32(vdupq_n_f32(SIN_2), ps);
+    ps = vmulq_f32(z, ps);
+    ps = vaddq_f32(vdupq_n_f32(SIN_1), ps);
+    float32x4_t rz = vmulq_f32(r, z);
+    float32x4_t s = vaddq_f32(r, vmulq_f32(rz, ps));
+
+    float32x4_t pc = vmulq_f32(z, vdupq_n_f32(COS_3));
+    pc = vaddq_f32(vdupq_n_f32(COS_2), pc);
+    pc = vmulq_f32(z, pc);
+    pc = vaddq_f32(vdupq_n_f32(COS_1), pc);
+    float32x4_t zz = vmulq_f32(z, z);
+    float32x4_t c = vsubq_f32(vdupq_n_f32(1.0f), vmulq_f32(vdupq_n_f32(0.5f), z));
+    c = vaddq_f32(c, vmulq_f32(zz, pc));
+
+    int32x4_t q = vcvtq_s32_f32(k);
+    uint32x4_t swap = vtstq_s32(q, vdupq_n_s32(1));
+    float32x4_t sin_v = vbslq_f32(swap, c, s);
+    float32x4_t cos_v = vbslq_f32(swap, s, c);
+
+    uint32x4_t sin_sign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(q, vdupq_n_s32(2))), 30);
+    uint32x4_t cos_sign = vshlq_n_u32(vreinterpretq_u32_s32(
+        vandq_s32(vaddq_s32(q, vdupq_n_s32(1)), vdupq_n_s32(2))), 30);
+    sin_out = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sin_v), sin_sign));
+    cos_out = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cos_v), cos_sign));
+}
+
+inline float32x4_t normalize_neon(float32x4_t v) {
+    float32x4_t n = vdivq_f32(vaddq_f32(v, vdupq_n_f32(5.0f)), vdupq_n_f32(10.0f));
+    // Written as compare+select to match the scalar reference exactly
+    n = vbslq_f32(vcltq_f32(n, vdupq_n_f32(1.0f)), n, vdupq_n_f32(1.0f));
+    return vbslq_f32(vcgtq_f32(n, vdupq_n_f32(0.0f)), n, vdupq_n_f32(0.0f));
+}
+
+inline void ikeda_step_neon(float32x4_t a, float32x4_t b, float32x4_t& x, float32x4_t& y,
+                            float32x4_t& norm_x, float32x4_t& norm_y) {
+    float32x4_t r2 = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+    float32x4_t t = vsubq_f32(vdupq_n_f32(0.4f),
+                              vdivq_f32(vdupq_n_f32(6.0f), vaddq_f32(vdupq_n_f32(1.0f), r2)));
+    float32x4_t s, c;
+    sincos_neon(t, s, c);
+    float32x4_t x_new = vaddq_f32(vdupq_n_f32(1.0f),
+                                  vmulq_f32(a, vsubq_f32(vmulq_f32(x, c), vmulq_f32(y, s))));
+    float32x4_t y_new = vmulq_f32(b, vaddq_f32(vmulq_f32(x, s), vmulq_f32(y, c)));
+    norm_x = normalize_neon(x_new);
+    norm_y = normalize_neon(y_new);
+    x = x_new;
+    y = y_new;
+}
+
+// Eight orbits as two 4-lane halves; store(k, nx, ny) receives each half
+template<typename Store>
+void orbits_neon(float a, float b, std::size_t count, Store&& store) {
+    float32x4_t va = vdupq_n_f32(a);
+    float32x4_t vb = vdupq_n_f32(b);
+    float32x4_t x[2] = {vld1q_f32(LANE_SEED_X), vld1q_f32(LANE_SEED_X + 4)};
+    float32x4_t y[2] = {vdupq_n_f32(SEED_Y), vdupq_n_f32(SEED_Y)};
+
+    for (std::size_t k = 0; k < count; k += ORBIT_LANES) {
+        for (std::size_t half = 0; half < 2; ++half) {
+            float32x4_t nx, ny;
+            ikeda_step_neon(va, vb, x[half], y[half], nx, ny);
+            store(k + half * 4, nx, ny);
+        }
+    }
+}
+
+void chaotic_orbits_neon(float a, float b, std::span<float> xs, std::span<float> ys) {
+    std::size_t count = xs.size();
+    orbits_neon(a, b, count, [&](std::size_t k, float32x4_t nx, float32x4_t ny) {
+        if (k + 4 <= count) {
+            vst1q_f32(xs.data() + k, nx);
+            vst1q_f32(ys.data() + k, ny);
+        } else if (k < count) {
+            float tail_x[4], tail_y[4];
+            vst1q_f32(tail_x, nx);
+            vst1q_f32(tail_y, ny);
+            std::copy(tail_x, tail_x + (count - k), xs.data() + k);
+            std::copy(tail_y, tail_y + (count - k), ys.data() + k);
+        }
+    });
+}
+
+void chaotic_orbits_interleaved_neon(float a, float b, std::span<std::array<float, 2>> points) {
+    std::size_t count = points.size();
+    float* out = points.empty() ? nullptr : points.data()->data();
+    orbits_neon(a, b, count, [&](std::size_t k, float32x4_t nx, float32x4_t ny) {
+        float32x4x2_t pair = {{nx, ny}};
+        if (k + 4 <= count) {
+            vst2q_f32(out + k * 2, pair);
+        } else if (k < count) {
+            float tail[8];
+            vst2q_f32(tail, pair);
+            std::copy(tail, tail + (count - k) * 2, out + k * 2);
+        }
+    });
+}
+
+inline uint8x16_t swap_red_blue_neon(uint8x16_t v) {
+    static const uint8_t shuffle[16] = {2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15};
+    return vqtbl1q_u8(v, vld1q_u8(shuffle));
+}
+
+void encode_colors_neon(std::span<const std::byte> data, std::span<std::uint32_t> colors) {
+    auto* in = reinterpret_cast<const std::uint8_t*>(data.data());
+    auto* out = reinterpret_cast<std::uint8_t*>(colors.data());
+    std::size_t c = 0;
+    for (; (c + 8) * 4 <= data.size(); c += 8) {
+        vst1q_u8(out + c * 4, swap_red_blue_neon(vld1q_u8(in + c * 4)));
+        vst1q_u8(out + c * 4 + 16, swap_red_blue_neon(vld1q_u8(in + c * 4 + 16)));
+    }
+    encode_colors_scalar(data, colors, c);
+}
+
+void decode_colors_neon(std::span<const std::uint32_t> colors, std::span<std::byte> data) {
+    auto* in = reinterpret_cast<const std::uint8_t*>(colors.data());
+    auto* out = reinterpret_cast<std::uint8_t*>(data.data());
+    std::size_t c = 0;
+    for (; c + 8 <= colors.size(); c += 8) {
+        vst1q_u8(out + c * 4, swap_red_blue_neon(vld1q_u8(in + c * 4)));
+        vst1q_u8(out + c * 4 + 16, swap_red_blue_neon(vld1q_u8(in + c * 4 + 16)));
+    }
+    decode_colors_scalar(colors, data, c);
+}
+
+std::uint64_t checksum_neon(std::span<const std::array<float, 2>> points, std::span<const std::uint32_t> colors) {
+    const float* coords = points.empty() ? nullptr : points.data()->data();
+    std::size_t coord_count = points.size() * 2;
+    uint64x2_t acc = vdupq_n_u64(0);
+    std::uint64_t scalar_sum = 0;
+
+    std::size_t i = 0;
+    for (; i + 4 <= coord_count; i += 4) {
+        float32x4_t scaled = vmulq_f32(vld1q_f32(coords + i), vdupq_n_f32(1000.0f));
+        uint32x4_t in_range = vandq_u32(vcgeq_f32(scaled, vdupq_n_f32(0.0f)),
+                                        vcltq_f32(scaled, vdupq_n_f32(CHECKSUM_LIMIT)));
+        if (vminvq_u32(in_range) == 0) {
+            scalar_sum += checksum_coordinates_scalar(coords + i, 4);
+            continue;
+        }
+        acc = vpadalq_u32(acc, vcvtq_u32_f32(scaled));
+    }
+    scalar_sum += checksum_coordinates_scalar(coords + i, coord_count - i);
+
+    std::size_t c = 0;
+    for (; c + 4 <= colors.size(); c += 4) {
+        acc = vpadalq_u32(acc, vld1q_u32(colors.data() + c));
+    }
+    scalar_sum += checksum_colors_scalar(colors.data() + c, colors.size() - c);
+
+    return vaddvq_u64(acc) + scalar_sum;
+}
+
+bool points_within_neon(const float* a, const float* b, std::size_t count, float max_squared) {
+    const float32x4_t limit = vdupq_n_f32(max_squared);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4x2_t pa = vld2q_f32(a + 2 * i);  // Deinterleaves into x and y
+        float32x4x2_t pb = vld2q_f32(b + 2 * i);
+        float32x4_t dx = vsubq_f32(pa.val[0], pb.val[0]);
+        float32x4_t dy = vsubq_f32(pa.val[1], pb.val[1]);
+        float32x4_t squared = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+        if (vminvq_u32(vcleq_f32(squared, limit)) == 0) {
+            return false;
+        }
+    }
+    return points_within_scalar(a + 2 * i, a + 2 * i + 1, b + 2 * i, b + 2 * i + 1, 2, count - i, max_squared);
+}
+
+bool points_within_soa_neon(const float* ax, const float* ay, const float* bx, const float* by,
+                            std::size_t count, float max_squared) {
+    const float32x4_t limit = vdupq_n_f32(max_squared);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(ax + i), vld1q_f32(bx + i));
+        float32x4_t dy = vsubq_f32(vld1q_f32(ay + i), vld1q_f32(by + i));
+        float32x4_t squared = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+        if (vminvq_u32(vcleq_f32(squared, limit)) == 0) {
+            return false;
+        }
+    }
+    return points_within_scalar(ax + i, ay + i, bx + i, by + i, 1, count - i, max_squared);
+}
+
+float distance_sum_neon(const float* a, const float* b, std::size_t count, float budget) {
+    float total = 0.0f;
+    std::size_t i = 0;
+    while (i + 4 <= count) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        std::size_t block_end = std::min(count & ~std::size_t{3}, i + BUDGET_CHECK_POINTS);
+        for (; i < block_end; i += 4) {
+            float32x4x2_t pa = vld2q_f32(a + 2 * i);
+            float32x4x2_t pb = vld2q_f32(b + 2 * i);
+            float32x4_t dx = vsubq_f32(pa.val[0], pb.val[0]);
+            float32x4_t dy = vsubq_f32(pa.val[1], pb.val[1]);
+            acc = vaddq_f32(acc, vsqrtq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy))));
+        }
+        total += vaddvq_f32(acc);
+        if (total > budget) {
+            return total;
+        }
+    }
+    return total + distance_sum_scalar(a + 2 * i, a + 2 * i + 1, b + 2 * i, b + 2 * i + 1, 2, count - i, budget - total);
+}
+
+float distance_sum_soa_neon(const float* ax, const float* ay, const float* bx, const float* by,
+                            std::size_t count, float budget) {
+    float total = 0.0f;
+    std::size_t i = 0;
+    while (i + 4 <= count) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        std::size_t block_end = std::min(count & ~std::size_t{3}, i + BUDGET_CHECK_POINTS);
+        for (; i < block_end; i += 4) {
+            float32x4_t dx = vsubq_f32(vld1q_f32(ax + i), vld1q_f32(bx + i));
+            float32x4_t dy = vsubq_f32(vld1q_f32(ay + i), vld1q_f32(by + i));
+            acc = vaddq_f32(acc, vsqrtq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy))));
+        }
+        total += vaddvq_f32(acc);
+        if (total > budget) {
+            return total;
+        }
+    }
+    return total + distance_sum_scalar(ax + i, ay + i, bx + i, by + i, 1, count - i, budget - total);
+}
+
+#endif // DUALSTACK_KERNELS_NEON
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+auto is_supported(KernelIsa isa) -> bool {
+    switch (isa) {
+        case KernelIsa::scalar:
+            return true;
+        case KernelIsa::avx2:
+#if defined(DUALSTACK_KERNELS_X86)
+            return cpu_has_avx2();
+#else
+            return false;
+#endif
+        case KernelIsa::neon:
+#if defined(DUALSTACK_KERNELS_NEON)
+            return little_endian;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+auto isa_state() -> std::atomic<KernelIsa>& {
+    static std::atomic<KernelIsa> isa{detected_isa()};
+    return isa;
+}
+
+} // anonymous namespace
+
+auto detected_isa() -> KernelIsa {
+    if (is_supported(KernelIsa::avx2)) {
+        return KernelIsa::avx2;
+    }
+    if (is_supported(KernelIsa::neon)) {
+        return KernelIsa::neon;
+    }
+    return KernelIsa::scalar;
+}
+
+auto active_isa() -> KernelIsa {
+    return isa_state().load(std::memory_order_relaxed);
+}
+
+auto set_active_isa(KernelIsa isa) -> KernelIsa {
+    KernelIsa applied = is_supported(isa) ? isa : KernelIsa::scalar;
+    isa_state().store(applied, std::memory_order_relaxed);
+    return applied;
+}
+
+auto chaotic_orbits(float param_a, float param_b, std::span<float> xs, std::span<float> ys) -> void {
+    switch (active_isa()) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return chaotic_orbits_avx2(param_a, param_b, xs, ys);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return chaotic_orbits_neon(param_a, param_b, xs, ys);
+#endif
+        default: return chaotic_orbits_scalar(param_a, param_b, xs, ys);
+    }
+}
+
+auto chaotic_orbits_interleaved(float param_a, float param_b, std::span<std::array<float, 2>> points) -> void {
+    switch (active_isa()) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return chaotic_orbits_interleaved_avx2(param_a, param_b, points);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return chaotic_orbits_interleaved_neon(param_a, param_b, points);
+#endif
+        default: return chaotic_orbits_interleaved_scalar(param_a, param_b, points);
+    }
+}
+
+auto encode_colors(std::span<const std::byte> data, std::span<std::uint32_t> colors) -> void {
+    // Byte-shuffle kernels assume the ARGB word is stored little-endian
+    switch (little_endian ? active_isa() : KernelIsa::scalar) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return encode_colors_avx2(data, colors);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return encode_colors_neon(data, colors);
+#endif
+        default: return encode_colors_scalar(data, colors);
+    }
+}
+
+auto decode_colors(std::span<const std::uint32_t> colors, std::span<std::byte> data) -> void {
+    switch (little_endian ? active_isa() : KernelIsa::scalar) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return decode_colors_avx2(colors, data);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return decode_colors_neon(colors, data);
+#endif
+        default: return decode_colors_scalar(colors, data);
+    }
+}
+
+auto checksum(std::span<const std::array<float, 2>> points, std::span<const std::uint32_t> colors) -> std::uint64_t {
+    switch (active_isa()) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return checksum_avx2(points, colors);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return checksum_neon(points, colors);
+#endif
+        default: return checksum_scalar(points, colors);
+    }
+}
+
+auto points_within(std::span<const std::array<float, 2>> a, std::span<const std::array<float, 2>> b,
+                   float max_squared) -> bool {
+    std::size_t count = std::min(a.size(), b.size());
+    if (count == 0) {
+        return true;
+    }
+    const float* pa = a.data()->data();
+    const float* pb = b.data()->data();
+    switch (active_isa()) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return points_within_avx2(pa, pb, count, max_squared);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return points_within_neon(pa, pb, count, max_squared);
+#endif
+        default: return points_within_scalar(pa, pa + 1, pb, pb + 1, 2, count, max_squared);
+    }
+}
+
+auto points_within_soa(std::span<const float> ax, std::span<const float> ay,
+                       std::span<const float> bx, std::span<const float> by, float max_squared) -> bool {
+    std::size_t count = std::min({ax.size(), ay.size(), bx.size(), by.size()});
+    switch (active_isa()) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return points_within_soa_avx2(ax.data(), ay.data(), bx.data(), by.data(), count, max_squared);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return points_within_soa_neon(ax.data(), ay.data(), bx.data(), by.data(), count, max_squared);
+#endif
+        default: return points_within_scalar(ax.data(), ay.data(), bx.data(), by.data(), 1, count, max_squared);
+    }
+}
+
+auto distance_sum(std::span<const std::array<float, 2>> a, std::span<const std::array<float, 2>> b,
+                  float budget) -> float {
+    std::size_t count = std::min(a.size(), b.size());
+    if (count == 0) {
+        return 0.0f;
+    }
+    const float* pa = a.data()->data();
+    const float* pb = b.data()->data();
+    switch (active_isa()) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return distance_sum_avx2(pa, pb, count, budget);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return distance_sum_neon(pa, pb, count, budget);
+#endif
+        default: return distance_sum_scalar(pa, pa + 1, pb, pb + 1, 2, count, budget);
+    }
+}
+
+auto distance_sum_soa(std::span<const float> ax, std::span<const float> ay,
+                      std::span<const float> bx, std::span<const float> by, float budget) -> float {
+    std::size_t count = std::min({ax.size(), ay.size(), bx.size(), by.size()});
+    switch (active_isa()) {
+#if defined(DUALSTACK_KERNELS_X86)
+        case KernelIsa::avx2: return distance_sum_soa_avx2(ax.data(), ay.data(), bx.data(), by.data(), count, budget);
+#endif
+#if defined(DUALSTACK_KERNELS_NEON)
+        case KernelIsa::neon: return distance_sum_soa_neon(ax.data(), ay.data(), bx.data(), by.data(), count, budget);
+#endif
+        default: return distance_sum_scalar(ax.data(), ay.data(), bx.data(), by.data(), 1, count, budget);
+    }
+}
+
+} // namespace dualstack::security::visualization::kernels
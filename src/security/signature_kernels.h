@@ -0,0 +1,77 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+// Vectorized kernels behind SignatureVisualizer
+// Every ISA produces bit-identical signatures to the scalar reference, so a
+// signature generated on one machine verifies on any other. The comparison
+// kernels only feed thresholds and may differ from scalar in the last bits.
+
+namespace dualstack::security::visualization::kernels {
+
+// Independent chaotic orbits iterated side by side; point k belongs to
+// orbit (k % ORBIT_LANES) at step (k / ORBIT_LANES)
+inline constexpr std::size_t ORBIT_LANES = 8;
+
+enum class KernelIsa : std::uint8_t {
+    scalar,
+    avx2,
+    neon
+};
+
+// Best ISA supported by this CPU
+auto detected_isa() -> KernelIsa;
+
+// ISA currently used by the dispatched kernels
+auto active_isa() -> KernelIsa;
+
+// Force an ISA (falls back to scalar if unsupported); returns the ISA now active
+auto set_active_isa(KernelIsa isa) -> KernelIsa;
+
+// Ikeda map orbits, SoA output (xs.size() == ys.size())
+auto chaotic_orbits(float param_a, float param_b, std::span<float> xs, std::span<float> ys) -> void;
+
+// Same orbits written as interleaved (x, y) points
+auto chaotic_orbits_interleaved(float param_a, float param_b, std::span<std::array<float, 2>> points) -> void;
+
+// Bytes (r, g, b, a) to ARGB words; colors.size() must be (data.size() + 3) / 4
+auto encode_colors(std::span<const std::byte> data, std::span<std::uint32_t> colors) -> void;
+
+// ARGB words back to (r, g, b, a) bytes; data.size() must be colors.size() * 4
+auto decode_colors(std::span<const std::uint32_t> colors, std::span<std::byte> data) -> void;
+
+// Visual checksum over point coordinates (scaled by 1000) and colors
+auto checksum(std::span<const std::array<float, 2>> points, std::span<const std::uint32_t> colors) -> std::uint64_t;
+
+// True if every pair a[i], b[i] lies within sqrt(max_squared); stops at the first miss (a.size() == b.size())
+auto points_within(std::span<const std::array<float, 2>> a, std::span<const std::array<float, 2>> b,
+                   float max_squared) -> bool;
+
+// Same test on structure-of-arrays coordinates
+auto points_within_soa(std::span<const float> ax, std::span<const float> ay,
+                       std::span<const float> bx, std::span<const float> by, float max_squared) -> bool;
+
+// Sum of pairwise distances; once the running sum exceeds budget it returns early with a value above budget
+auto distance_sum(std::span<const std::array<float, 2>> a, std::span<const std::array<float, 2>> b,
+                  float budget = std::numeric_limits<float>::infinity()) -> float;
+
+auto distance_sum_soa(std::span<const float> ax, std::span<const float> ay,
+                      std::span<const float> bx, std::span<const float> by,
+                      float budget = std::numeric_limits<float>::infinity()) -> float;
+
+} // namespace dualstack::security::visualization::kernels
@@ -0,0 +1,467 @@
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "signature_store.h"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <share.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dualstack::security::visualization {
+
+namespace {
+
+auto load_u16(const std::byte* p) -> std::uint16_t {
+    return static_cast<std::uint16_t>(std::to_integer<std::uint16_t>(p[0]) |
+                                      (std::to_integer<std::uint16_t>(p[1]) << 8));
+}
+
+auto load_u32(const std::byte* p) -> std::uint32_t {
+    return std::to_integer<std::uint32_t>(p[0]) | (std::to_integer<std::uint32_t>(p[1]) << 8) |
+           (std::to_integer<std::uint32_t>(p[2]) << 16) | (std::to_integer<std::uint32_t>(p[3]) << 24);
+}
+
+auto load_u64(const std::byte* p) -> std::uint64_t {
+    return static_cast<std::uint64_t>(load_u32(p)) | (static_cast<std::uint64_t>(load_u32(p + 4)) << 32);
+}
+
+auto store_u16(std::byte* p, std::uint16_t v) -> void {
+    p[0] = static_cast<std::byte>(v);
+    p[1] = static_cast<std::byte>(v >> 8);
+}
+
+auto store_u32(std::byte* p, std::uint32_t v) -> void {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<std::byte>(v >> (8 * i));
+    }
+}
+
+auto store_u64(std::byte* p, std::uint64_t v) -> void {
+    store_u32(p, static_cast<std::uint32_t>(v));
+    store_u32(p + 4, static_cast<std::uint32_t>(v >> 32));
+}
+
+constexpr auto padded(std::uint64_t size) -> std::uint64_t {
+    return (size + 7) & ~std::uint64_t{7};
+}
+
+// Record offsets from the index when it matches the header, else from a scan of record headers
+auto load_offsets(std::span<const std::byte> file, std::vector<std::uint64_t>& offsets,
+                  std::uint64_t& records_end, bool& indexed) -> std::expected<void, StoreError> {
+    if (file.size() < STORE_HEADER_SIZE || load_u32(file.data()) != STORE_MAGIC) {
+        return std::unexpected(StoreError::bad_header);
+    }
+    if (load_u16(file.data() + 4) != STORE_VERSION || load_u16(file.data() + 6) != STORE_HEADER_SIZE) {
+        return std::unexpected(StoreError::unsupported_version);
+    }
+
+    std::uint64_t count = load_u64(file.data() + 8);
+    std::uint64_t index_offset = load_u64(file.data() + 16);
+    offsets.clear();
+
+    if (index_offset >= STORE_HEADER_SIZE && index_offset % 8 == 0 && index_offset <= file.size() &&
+        count <= (file.size() - index_offset) / 8 &&
+        (file.size() - index_offset) - count * 8 >= 8) {
+        const std::byte* index = file.data() + index_offset;
+        std::span<const std::byte> table(index, count * 8);
+        if (load_u32(index + count * 8 + 4) == STORE_INDEX_MAGIC &&
+            load_u32(index + count * 8) == codec::crc32(table)) {
+            offsets.resize(count);
+            for (std::uint64_t i = 0; i < count; ++i) {
+                offsets[i] = load_u64(index + i * 8);
+            }
+            records_end = index_offset;
+            indexed = true;
+            return {};
+        }
+    }
+
+    // No usable index: walk the records until one fails its header checks
+    std::uint64_t offset = STORE_HEADER_SIZE;
+    while (offset < file.size()) {
+        auto size = codec::record_size(file.subspan(offset));
+        if (!size) {
+            break;
+        }
+        offsets.push_back(offset);
+        offset += padded(*size);
+    }
+    records_end = std::min<std::uint64_t>(offset, padded(file.size()));
+    indexed = false;
+    return {};
+}
+
+// Writer I/O at explicit offsets; the file is created but never truncated
+#ifdef _WIN32
+auto open_store_file(const std::string& path) -> int {
+    int fd = -1;
+    int flags = _O_RDWR | _O_CREAT | _O_BINARY | _O_NOINHERIT;
+    return ::_sopen_s(&fd, path.c_str(), flags, _SH_DENYNO, _S_IREAD | _S_IWRITE) == 0 ? fd : -1;
+}
+
+auto write_at(int fd, std::uint64_t offset, const std::byte* data, std::size_t size) -> bool {
+    return ::_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) >= 0 &&
+           ::_write(fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+}
+
+auto sync_file(int fd) -> bool {
+    return ::_commit(fd) == 0;
+}
+
+auto close_file(int fd) -> void {
+    ::_close(fd);
+}
+#else
+auto open_store_file(const std::string& path) -> int {
+    return ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+}
+
+auto write_at(int fd, std::uint64_t offset, const std::byte* data, std::size_t size) -> bool {
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        offset += static_cast<std::uint64_t>(written);
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+auto sync_file(int fd) -> bool {
+    return ::fsync(fd) == 0;
+}
+
+auto close_file(int fd) -> void {
+    ::close(fd);
+}
+#endif
+
+} // anonymous namespace
+
+auto describe(StoreError error) -> const char* {
+    switch (error) {
+        case StoreError::open_failed: return "cannot open signature store";
+        case StoreError::map_failed: return "cannot map signature store";
+        case StoreError::bad_header: return "not a signature store";
+        case StoreError::unsupported_version: return "unsupported signature store version";
+        case StoreError::corrupt_record: return "corrupt signature record";
+        case StoreError::out_of_range: return "signature index out of range";
+        case StoreError::io_error: return "signature store write failed";
+    }
+    return "unknown store error";
+}
+
+// ============================================================================
+// SignatureStore
+// ============================================================================
+
+auto SignatureStore::open(const std::string& path, std::size_t cache_capacity)
+    -> std::expected<std::unique_ptr<SignatureStore>, StoreError> {
+    auto mapped = map_file(path);
+    if (!mapped) {
+        return std::unexpected(mapped.error());
+    }
+    std::unique_ptr<SignatureStore> store(new SignatureStore(path, cache_capacity));
+    store->mapping_ = *mapped;      // Unmapped by the destructor from here on
+    auto loaded = load_offsets({mapped->data, mapped->size}, store->offsets_, store->records_end_, store->indexed_);
+    if (!loaded) {
+        return std::unexpected(loaded.error());
+    }
+    return store;
+}
+
+SignatureStore::~SignatureStore() {
+    unmap(mapping_);
+    for (auto& retired : retired_) {
+        unmap(retired);
+    }
+}
+
+auto SignatureStore::map_file(const std::string& path) -> std::expected<Mapping, StoreError> {
+    Mapping mapping;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::unexpected(StoreError::open_failed);
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(STORE_HEADER_SIZE)) {
+        CloseHandle(file);
+        return std::unexpected(StoreError::bad_header);
+    }
+    HANDLE handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!handle) {
+        return std::unexpected(StoreError::map_failed);
+    }
+    void* view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(handle);
+        return std::unexpected(StoreError::map_failed);
+    }
+    mapping.handle = handle;
+    mapping.data = static_cast<const std::byte*>(view);
+    mapping.size = static_cast<std::size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::unexpected(StoreError::open_failed);
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(STORE_HEADER_SIZE)) {
+        ::close(fd);
+        return std::unexpected(StoreError::bad_header);
+    }
+    void* view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);     // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        return std::unexpected(StoreError::map_failed);
+    }
+    mapping.data = static_cast<const std::byte*>(view);
+    mapping.size = static_cast<std::size_t>(info.st_size);
+#endif
+    return mapping;
+}
+
+auto SignatureStore::unmap(Mapping& mapping) -> void {
+    if (!mapping.data) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping.data);
+    CloseHandle(mapping.handle);
+    mapping.handle = nullptr;
+#else
+    ::munmap(const_cast<std::byte*>(mapping.data), mapping.size);
+#endif
+    mapping.data = nullptr;
+    mapping.size = 0;
+}
+
+auto SignatureStore::size() const -> std::size_t {
+    std::shared_lock<std::shared_mutex> lock(map_mutex_);
+    return offsets_.size();
+}
+
+auto SignatureStore::indexed() const -> bool {
+    std::shared_lock<std::shared_mutex> lock(map_mutex_);
+    return indexed_;
+}
+
+auto SignatureStore::view(std::size_t index) const -> std::expected<codec::SignatureView, StoreError> {
+    std::shared_lock<std::shared_mutex> lock(map_mutex_);
+    if (index >= offsets_.size()) {
+        return std::unexpected(StoreError::out_of_range);
+    }
+    std::uint64_t offset = offsets_[index];
+    if (offset >= mapping_.size) {
+        return std::unexpected(StoreError::corrupt_record);
+    }
+    auto record = codec::view({mapping_.data + offset, mapping_.size - static_cast<std::size_t>(offset)});
+    if (!record) {
+        return std::unexpected(StoreError::corrupt_record);
+    }
+    return *record;
+}
+
+auto SignatureStore::get(std::size_t index)
+    -> std::expected<std::shared_ptr<const SignatureVisualizer::VisualSignature>, StoreError> {
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (auto found = cache_lookup_.find(index); found != cache_lookup_.end()) {
+            cache_.splice(cache_.begin(), cache_, found->second);
+            ++cache_stats_.hits;
+            return found->second->second;
+        }
+        ++cache_stats_.misses;
+    }
+
+    // Decode outside the lock; records are immutable, so racing decoders agree
+    auto record = view(index);
+    if (!record) {
+        return std::unexpected(record.error());
+    }
+    auto sig = std::make_shared<const SignatureVisualizer::VisualSignature>(record->to_signature());
+
+    if (cache_capacity_ == 0) {
+        return sig;
+    }
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (cache_lookup_.find(index) == cache_lookup_.end()) {
+        cache_.emplace_front(index, sig);
+        cache_lookup_[index] = cache_.begin();
+        if (cache_.size() > cache_capacity_) {
+            cache_lookup_.erase(cache_.back().first);
+            cache_.pop_back();
+        }
+    }
+    return sig;
+}
+
+auto SignatureStore::refresh() -> std::expected<std::size_t, StoreError> {
+    // One refresh at a time; readers only wait for the final swap
+    std::lock_guard<std::mutex> refreshing(refresh_mutex_);
+    const Mapping current = mapping_;   // Only refresh() replaces it, so no reader lock needed to copy
+
+    std::error_code ec;
+    auto file_size = std::filesystem::file_size(path_, ec);
+    if (ec) {
+        return std::unexpected(StoreError::open_failed);
+    }
+    if (file_size < current.size) {
+        return std::unexpected(StoreError::bad_header);     // Truncated: keep serving the old mapping
+    }
+
+    // An unchanged size needs no new mapping: MAP_SHARED already shows the rewritten index and header
+    Mapping fresh = current;
+    if (file_size != current.size) {
+        auto mapped = map_file(path_);
+        if (!mapped) {
+            return std::unexpected(mapped.error());
+        }
+        fresh = *mapped;
+        if (fresh.size < current.size) {
+            unmap(fresh);
+            return std::unexpected(StoreError::bad_header);
+        }
+    }
+
+    std::vector<std::uint64_t> offsets;
+    std::uint64_t records_end = STORE_HEADER_SIZE;
+    bool indexed = false;
+    if (auto loaded = load_offsets({fresh.data, fresh.size}, offsets, records_end, indexed); !loaded) {
+        if (fresh.data != current.data) {
+            unmap(fresh);
+        }
+        return std::unexpected(loaded.error());
+    }
+
+    // Cached records stay valid: existing records never change. Views into the
+    // old mapping stay valid too, so it is retired rather than unmapped.
+    std::unique_lock<std::shared_mutex> lock(map_mutex_);
+    if (fresh.data != current.data) {
+        retired_.push_back(current);
+        mapping_ = fresh;
+    }
+    offsets_ = std::move(offsets);
+    records_end_ = records_end;
+    indexed_ = indexed;
+    return offsets_.size();
+}
+
+auto SignatureStore::cache_stats() const -> CacheStats {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return cache_stats_;
+}
+
+// ============================================================================
+// SignatureStoreWriter
+// ============================================================================
+
+auto SignatureStoreWriter::open(const std::string& path)
+    -> std::expected<std::unique_ptr<SignatureStoreWriter>, StoreError> {
+    std::unique_ptr<SignatureStoreWriter> writer(new SignatureStoreWriter());
+
+    std::error_code ec;
+    bool existing = std::filesystem::exists(path, ec) && std::filesystem::file_size(path, ec) > 0;
+    if (existing) {
+        // Pick up where the last writer stopped, trusting the index only if it is intact
+        auto store = SignatureStore::open(path, 0);
+        if (!store) {
+            return std::unexpected(store.error());
+        }
+        writer->offsets_ = std::move((*store)->offsets_);
+        writer->records_end_ = (*store)->records_end_;
+    }
+
+    writer->fd_ = open_store_file(path);
+    if (writer->fd_ < 0) {
+        return std::unexpected(StoreError::open_failed);
+    }
+    if (!existing) {
+        writer->dirty_ = true;
+        if (auto flushed = writer->flush(); !flushed) {
+            return std::unexpected(flushed.error());
+        }
+    }
+    return writer;
+}
+
+SignatureStoreWriter::~SignatureStoreWriter() {
+    if (fd_ >= 0) {
+        (void)flush();
+        close_file(fd_);
+    }
+}
+
+auto SignatureStoreWriter::write(std::uint64_t offset, std::span<const std::byte> bytes) -> bool {
+    return write_at(fd_, offset, bytes.data(), bytes.size());
+}
+
+auto SignatureStoreWriter::append(const SignatureVisualizer::VisualSignature& sig)
+    -> std::expected<std::size_t, StoreError> {
+    std::size_t size = codec::encoded_size(sig);
+    scratch_.assign(padded(size), std::byte{0});
+    if (auto written = codec::serialize(sig, scratch_); !written) {
+        return std::unexpected(StoreError::corrupt_record);
+    }
+
+    if (!write(records_end_, scratch_)) {
+        return std::unexpected(StoreError::io_error);
+    }
+
+    offsets_.push_back(records_end_);
+    records_end_ += scratch_.size();
+    dirty_ = true;
+    return offsets_.size() - 1;
+}
+
+auto SignatureStoreWriter::flush() -> std::expected<void, StoreError> {
+    if (!dirty_) {
+        return {};
+    }
+
+    scratch_.assign(offsets_.size() * 8 + 8, std::byte{0});
+    for (std::size_t i = 0; i < offsets_.size(); ++i) {
+        store_u64(scratch_.data() + i * 8, offsets_[i]);
+    }
+    store_u32(scratch_.data() + offsets_.size() * 8, codec::crc32({scratch_.data(), offsets_.size() * 8}));
+    store_u32(scratch_.data() + offsets_.size() * 8 + 4, STORE_INDEX_MAGIC);
+
+    std::array<std::byte, STORE_HEADER_SIZE> header{};
+    store_u32(header.data(), STORE_MAGIC);
+    store_u16(header.data() + 4, STORE_VERSION);
+    store_u16(header.data() + 6, static_cast<std::uint16_t>(STORE_HEADER_SIZE));
+    store_u64(header.data() + 8, offsets_.size());
+    store_u64(header.data() + 16, records_end_);
+
+    // Records, then index, then header, each durable before the next is written:
+    // a reader opening in between falls back to a record scan, and after a crash
+    // the header never points at an index or records that did not reach the disk
+    if (!sync_file(fd_) || !write(records_end_, scratch_) || !sync_file(fd_) ||
+        !write(0, header) || !sync_file(fd_)) {
+        return std::unexpected(StoreError::io_error);
+    }
+    dirty_ = false;
+    return {};
+}
+
+} // namespace dualstack::security::visualization
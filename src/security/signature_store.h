@@ -0,0 +1,171 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "signature_codec.h"
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Append-only signature store file
+//
+//   offset  size  field
+//        0     4  magic "AVST"
+//        4     2  version
+//        6     2  header size
+//        8     8  record count covered by the index
+//       16     8  index offset (0 if no index has been written)
+//       24     8  reserved (zero)
+//       32        records: signature_codec.h encodings, each padded to 8 bytes
+//                 index: record offsets as u64, CRC-32 of the offsets, magic "AVSI"
+//
+// Records are only ever appended; the index is rewritten after the last
+// record and the header patched last, with an fsync between each step so
+// the header never reaches the disk ahead of what it points at. A reader
+// that finds the header and index out of step (writer crashed mid-append)
+// rebuilds the offsets by walking record headers, so the store never needs
+// a repair step.
+//
+// The file must only grow while readers have it mapped: truncating a mapped
+// file turns reads past the new end into SIGBUS. The writer never shrinks
+// the file, and refresh() refuses a file shorter than the one it mapped.
+
+namespace dualstack::security::visualization {
+
+inline constexpr std::uint32_t STORE_MAGIC = 0x54535641;        // "AVST" read little-endian
+inline constexpr std::uint32_t STORE_INDEX_MAGIC = 0x49535641;  // "AVSI"
+inline constexpr std::uint16_t STORE_VERSION = 1;
+inline constexpr std::size_t STORE_HEADER_SIZE = 32;
+
+enum class StoreError : std::uint8_t {
+    open_failed,
+    map_failed,
+    bad_header,             // Not a signature store, or header inconsistent with the file
+    unsupported_version,
+    corrupt_record,         // Record fails its codec checks
+    out_of_range,
+    io_error
+};
+
+auto describe(StoreError error) -> const char*;
+
+// Read side: maps the file once and decodes records on demand
+// view(), get(), size() and indexed() may run concurrently with refresh().
+// Views returned by view() point into a mapping and stay valid until the
+// store is destroyed: refresh() swaps in a new mapping but keeps superseded
+// ones until then. get() returns owning copies kept in an LRU.
+class SignatureStore {
+public:
+    static auto open(const std::string& path, std::size_t cache_capacity = 256)
+        -> std::expected<std::unique_ptr<SignatureStore>, StoreError>;
+
+    ~SignatureStore();
+    SignatureStore(const SignatureStore&) = delete;
+    SignatureStore& operator=(const SignatureStore&) = delete;
+
+    auto size() const -> std::size_t;
+
+    // True if the offsets came from the on-disk index rather than a record scan
+    auto indexed() const -> bool;
+
+    // Zero-copy view of a record (payload CRC checked on every call)
+    auto view(std::size_t index) const -> std::expected<codec::SignatureView, StoreError>;
+
+    // Decoded record, served from the LRU when hot
+    auto get(std::size_t index) -> std::expected<std::shared_ptr<const SignatureVisualizer::VisualSignature>, StoreError>;
+
+    // Remap to pick up records appended since open(); returns the new record count.
+    // On failure the previous mapping and record count stay in use.
+    auto refresh() -> std::expected<std::size_t, StoreError>;
+
+    struct CacheStats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+    };
+    auto cache_stats() const -> CacheStats;
+
+private:
+    SignatureStore(std::string path, std::size_t cache_capacity)
+        : path_(std::move(path)), cache_capacity_(cache_capacity) {}
+
+    struct Mapping {
+        const std::byte* data = nullptr;
+        std::size_t size = 0;
+#ifdef _WIN32
+        void* handle = nullptr;
+#endif
+    };
+
+    static auto map_file(const std::string& path) -> std::expected<Mapping, StoreError>;
+    static auto unmap(Mapping& mapping) -> void;
+
+    friend class SignatureStoreWriter;
+
+    using CacheEntry = std::pair<std::size_t, std::shared_ptr<const SignatureVisualizer::VisualSignature>>;
+
+    std::string path_;
+
+    // Guards the mapping and offsets: readers share it, refresh() takes it exclusively to swap
+    mutable std::shared_mutex map_mutex_;
+    std::mutex refresh_mutex_;
+    Mapping mapping_;
+    std::vector<Mapping> retired_;      // Superseded by refresh(), unmapped on destruction
+    std::vector<std::uint64_t> offsets_;
+    std::uint64_t records_end_ = STORE_HEADER_SIZE;
+    bool indexed_ = false;
+
+    std::size_t cache_capacity_;
+    mutable std::mutex cache_mutex_;
+    std::list<CacheEntry> cache_;       // Most recently used first
+    std::unordered_map<std::size_t, std::list<CacheEntry>::iterator> cache_lookup_;
+    CacheStats cache_stats_;
+};
+
+// Write side: creates the store or reopens it to append
+class SignatureStoreWriter {
+public:
+    static auto open(const std::string& path) -> std::expected<std::unique_ptr<SignatureStoreWriter>, StoreError>;
+
+    // Flushes the index
+    ~SignatureStoreWriter();
+    SignatureStoreWriter(const SignatureStoreWriter&) = delete;
+    SignatureStoreWriter& operator=(const SignatureStoreWriter&) = delete;
+
+    // Append a record; returns its index. Readers see it after flush() and refresh().
+    auto append(const SignatureVisualizer::VisualSignature& sig) -> std::expected<std::size_t, StoreError>;
+
+    // Write the index after the last record, then patch the header
+    auto flush() -> std::expected<void, StoreError>;
+
+    auto size() const -> std::size_t { return offsets_.size(); }
+
+private:
+    SignatureStoreWriter() = default;
+
+    auto write(std::uint64_t offset, std::span<const std::byte> bytes) -> bool;
+
+    int fd_ = -1;
+    std::vector<std::uint64_t> offsets_;
+    std::uint64_t records_end_ = STORE_HEADER_SIZE;
+    std::vector<std::byte> scratch_;
+    bool dirty_ = false;
+};
+
+} // namespace dualstack::security::visualization
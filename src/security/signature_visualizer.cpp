@@ -1,6 +1,16 @@
 // Include format header fix BEFORE any standard headers
 #include "../../include/dualstack_net26/fix_format_header.h"
 #include "signature_visualizer.h"
+#include "signature_kernels.h"
+#include "svg_writer.h"
+#include "png_codec.h"
+#include "signature_codec.h"
+#include "../performance/optimization.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <thread>
 #include <random>
 #include <sstream>
 #include <iomanip>
@@ -29,6 +39,124 @@ auto SignatureVisualizer::generate_visual_signature(const std::vector<std::byte>
     return sig;
 }
 
+auto SignatureVisualizer::generate_batch(std::span<const std::vector<std::byte>> crypto_data) -> SignatureBatch {
+    SignatureBatch batch;
+    batch.entries.resize(crypto_data.size());
+    if (crypto_data.empty()) {
+        return batch;
+    }
+    
+    // Output sizes are known up front, so the arena is laid out once and
+    // every worker writes its own disjoint slices without allocating
+    std::size_t point_total = 0;
+    std::size_t color_total = 0;
+    for (std::size_t i = 0; i < crypto_data.size(); ++i) {
+        auto& entry = batch.entries[i];
+        entry.point_offset = point_total;
+        entry.point_count = iteration_count_;
+        entry.color_offset = color_total;
+        entry.color_count = encoded_color_count(crypto_data[i].size());
+        entry.complexity = iteration_count_;
+        point_total += entry.point_count;
+        color_total += entry.color_count;
+    }
+    batch.points.resize(point_total);
+    batch.colors.resize(color_total);
+    
+    // The orbit depends only on the chaos parameters: iterate it once into the
+    // first slot and copy it into the rest
+    chaotic_map_into(std::span(batch.points.data(), iteration_count_));
+    std::span<const std::array<float, 2>> orbit(batch.points.data(), iteration_count_);
+    
+    auto fill_range = [&batch, &crypto_data, orbit](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& entry = batch.entries[i];
+            std::span<std::array<float, 2>> points(batch.points.data() + entry.point_offset, entry.point_count);
+            std::span<std::uint32_t> colors(batch.colors.data() + entry.color_offset, entry.color_count);
+            
+            if (i > 0) {
+                std::copy(orbit.begin(), orbit.end(), points.begin());
+            }
+            encode_colors_into(crypto_data[i], colors);
+            entry.visual_checksum = checksum_of(points, colors);
+        }
+    };
+    
+    std::size_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t chunk_count = std::min(crypto_data.size(), hardware_threads * 4);
+    if (chunk_count <= 1) {
+        fill_range(0, crypto_data.size());
+        return batch;
+    }
+    
+    std::shared_ptr<performance::thread_pool> pool;
+    {
+        std::lock_guard<std::mutex> lock(batch_pool_.mutex);
+        if (!batch_pool_.pool) {
+            batch_pool_.pool = std::make_shared<performance::thread_pool>(hardware_threads);
+        }
+        pool = batch_pool_.pool;
+    }
+    
+    // On one of the pool's own workers, waiting for tasks queued behind this
+    // one could deadlock a shared pool: do the whole batch here instead
+    if (pool->is_worker()) {
+        fill_range(0, crypto_data.size());
+        return batch;
+    }
+    
+    // Each helper (and this thread) claims chunks from a shared cursor until
+    // none are left, so the pool takes one task per worker, not one per chunk
+    std::size_t chunk_size = (crypto_data.size() + chunk_count - 1) / chunk_count;
+    std::atomic<std::size_t> next_chunk{0};
+    auto drain = [&fill_range, &next_chunk, &crypto_data, chunk_size] {
+        for (;;) {
+            std::size_t begin = next_chunk.fetch_add(1, std::memory_order_relaxed) * chunk_size;
+            if (begin >= crypto_data.size()) {
+                return;
+            }
+            fill_range(begin, std::min(begin + chunk_size, crypto_data.size()));
+        }
+    };
+    
+    std::size_t helpers = std::min(pool->size(), chunk_count - 1);
+    std::vector<std::future<void>> pending;
+    pending.reserve(helpers);
+    for (std::size_t i = 0; i < helpers; ++i) {
+        pending.push_back(pool->enqueue(drain));
+    }
+    std::exception_ptr failure;
+    try {
+        drain();
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    
+    // Wait for every helper before rethrowing so none outlives the arena
+    for (auto& helper : pending) {
+        helper.wait();
+    }
+    for (auto& helper : pending) {
+        helper.get();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    
+    return batch;
+}
+
+auto SignatureVisualizer::SignatureBatch::signature(std::size_t index) const -> VisualSignature {
+    VisualSignature sig;
+    auto batch_points = points_of(index);
+    auto batch_colors = colors_of(index);
+    sig.points.assign(batch_points.begin(), batch_points.end());
+    sig.colors.assign(batch_colors.begin(), batch_colors.end());
+    sig.complexity = entries[index].complexity;
+    sig.visual_checksum = entries[index].visual_checksum;
+    return sig;
+}
+
 auto SignatureVisualizer::create_guarantee_seal(const std::vector<std::byte>& crypto_data, 
                                                const std::string& issuer) -> GuaranteeSeal {
     GuaranteeSeal seal;
@@ -118,59 +246,33 @@ auto SignatureVisualizer::domain_verification_to_signature(const DomainVerificat
 }
 
 auto SignatureVisualizer::to_svg(const VisualSignature& sig, std::size_t width, std::size_t height) -> std::string {
-    std::stringstream svg;
+    SvgOptions options;
+    options.width = width;
+    options.height = height;
     
-    svg << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
-    svg << "<svg width=\"" << width << "\" height=\"" << height << "\" xmlns=\"http://www.w3.org/2000/svg\">\n";
-    svg << "  <title>Amphisbaena Visual Signature</title>\n";
-    svg << "  <desc>Generated visual signature containing encrypted metadata</desc>\n";
-    
-    // Draw points as circles
-    for (size_t i = 0; i < sig.points.size() && i < sig.colors.size(); ++i) {
-        float x = sig.points[i][0] * width;
-        float y = sig.points[i][1] * height;
-        
-        uint32_t color = static_cast<uint32_t>(sig.colors[i]);
-        uint8_t r = (color >> 16) & 0xFF;
-        uint8_t g = (color >> 8) & 0xFF;
-        uint8_t b = color & 0xFF;
-        
-        svg << "  <circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"2\" fill=\"rgb("
-            << static_cast<int>(r) << "," << static_cast<int>(g) << "," << static_cast<int>(b) << ")\"/>\n";
-    }
-    
-    svg << "</svg>\n";
-    
-    return svg.str();
+    std::string svg;
+    SvgWriter(options).render(sig, svg);
+    return svg;
 }
 
-auto SignatureVisualizer::to_png(const VisualSignature& sig [[maybe_unused]], std::size_t width [[maybe_unused]], std::size_t height [[maybe_unused]]) -> std::vector<std::byte> {
-    // Placeholder implementation - in reality this would generate actual PNG data
-    std::vector<std::byte> png_data;
-    
-    // PNG signature
-    png_data.push_back(static_cast<std::byte>(0x89));
-    png_data.push_back(static_cast<std::byte>(0x50)); // P
-    png_data.push_back(static_cast<std::byte>(0x4E)); // N
-    png_data.push_back(static_cast<std::byte>(0x47)); // G
-    png_data.push_back(static_cast<std::byte>(0x0D)); // CR
-    png_data.push_back(static_cast<std::byte>(0x0A)); // LF
-    png_data.push_back(static_cast<std::byte>(0x1A)); // EOF
-    png_data.push_back(static_cast<std::byte>(0x0A)); // LF
-    
-    // Add signature data as metadata
-    // This is a simplified representation
-    std::string sig_str = "VISUAL_SIG_DATA:";
-    for (const auto& byte : png_data) {
-        sig_str += std::to_string(static_cast<uint8_t>(byte)) + ";";
-    }
-    
-    // Convert string to bytes
-    for (char c : sig_str) {
-        png_data.push_back(static_cast<std::byte>(static_cast<uint8_t>(c)));
+auto SignatureVisualizer::to_png(const VisualSignature& sig, std::size_t width, std::size_t height) -> std::vector<std::byte> {
+    auto clamp_dimension = [](std::size_t value) {
+        return static_cast<std::uint32_t>(std::clamp<std::size_t>(value, 1, png::MAX_DIMENSION));
+    };
+    
+    // Scale down to the decoder's pixel budget, keeping the aspect ratio
+    std::uint32_t w = clamp_dimension(width);
+    std::uint32_t h = clamp_dimension(height);
+    if (std::uint64_t{w} * h > png::MAX_PIXELS) {
+        double scale = std::sqrt(static_cast<double>(png::MAX_PIXELS) / (static_cast<double>(w) * h));
+        w = std::max<std::uint32_t>(1, static_cast<std::uint32_t>(w * scale));
+        h = std::max<std::uint32_t>(1, static_cast<std::uint32_t>(h * scale));
     }
     
-    return png_data;
+    // Pixels for viewers, plus the exact signature in the private chunk for readers
+    png::Image image;
+    png::rasterize(sig, w, h, image);
+    return png::encode(image, codec::serialize(sig));
 }
 
 auto SignatureVisualizer::to_string(const VisualSignature& sig) -> std::string {
@@ -296,89 +398,68 @@ auto SignatureVisualizer::generate_default_keys() -> void {
 }
 
 auto SignatureVisualizer::chaotic_map_generator(std::size_t iterations) -> std::vector<std::array<float, 2>> {
-    std::vector<std::array<float, 2>> points;
-    points.reserve(iterations);
-    
-    // Initialize chaotic map
-    float x = 0.1f;
-    float y = 0.1f;
-    
-    for (std::size_t i = 0; i < iterations; ++i) {
-        // Ikeda map equations (simplified)
-        float t = 0.4f - 6.0f / (1.0f + x*x + y*y);
-        float x_new = 1.0f + chaos_parameter_a_ * (x * std::cos(t) - y * std::sin(t));
-        float y_new = chaos_parameter_b_ * (x * std::sin(t) + y * std::cos(t));
-        
-        // Normalize to [0,1] range
-        float norm_x = (x_new + 5.0f) / 10.0f;
-        float norm_y = (y_new + 5.0f) / 10.0f;
-        
-        // Clamp to valid range
-        norm_x = std::max(0.0f, std::min(1.0f, norm_x));
-        norm_y = std::max(0.0f, std::min(1.0f, norm_y));
-        
-        points.push_back({norm_x, norm_y});
-        
-        x = x_new;
-        y = y_new;
+    std::vector<std::array<float, 2>> points(iterations);
+    chaotic_map_into(points);
+    return points;
+}
+
+auto SignatureVisualizer::chaotic_map_into(std::span<std::array<float, 2>> points) const -> void {
+    // Ikeda map (simplified), kernels::ORBIT_LANES independent orbits interleaved
+    kernels::chaotic_orbits_interleaved(chaos_parameter_a_, chaos_parameter_b_, points);
+}
+
+auto SignatureVisualizer::chaotic_map_soa(std::size_t iterations) const -> PointSoA {
+    PointSoA points;
+    points.x.resize(iterations);
+    points.y.resize(iterations);
+    kernels::chaotic_orbits(chaos_parameter_a_, chaos_parameter_b_, points.x, points.y);
+    return points;
+}
+
+auto SignatureVisualizer::PointSoA::from_points(std::span<const std::array<float, 2>> points) -> PointSoA {
+    PointSoA soa;
+    soa.x.resize(points.size());
+    soa.y.resize(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        soa.x[i] = points[i][0];
+        soa.y[i] = points[i][1];
+    }
+    return soa;
+}
+
+auto SignatureVisualizer::PointSoA::to_points() const -> std::vector<std::array<float, 2>> {
+    std::vector<std::array<float, 2>> points(x.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = {x[i], y[i]};
     }
-    
     return points;
 }
 
 auto SignatureVisualizer::encode_data_in_colors(const std::vector<std::byte>& data) -> std::vector<std::uint32_t> {
-    std::vector<std::uint32_t> colors;
-    colors.reserve(data.size());
-    
-    // Simple encoding - each byte becomes a color component
-    for (size_t i = 0; i < data.size(); i += 4) {
-        uint8_t r = i < data.size() ? static_cast<uint8_t>(data[i]) : 0;
-        uint8_t g = (i + 1) < data.size() ? static_cast<uint8_t>(data[i + 1]) : 0;
-        uint8_t b = (i + 2) < data.size() ? static_cast<uint8_t>(data[i + 2]) : 0;
-        uint8_t a = (i + 3) < data.size() ? static_cast<uint8_t>(data[i + 3]) : 255;
-        
-        uint32_t color = (static_cast<uint32_t>(a) << 24) |
-                        (static_cast<uint32_t>(r) << 16) |
-                        (static_cast<uint32_t>(g) << 8) |
-                        static_cast<uint32_t>(b);
-        colors.push_back(color);
-    }
-    
+    std::vector<std::uint32_t> colors(encoded_color_count(data.size()));
+    encode_colors_into(data, colors);
     return colors;
 }
 
+auto SignatureVisualizer::encode_colors_into(std::span<const std::byte> data, std::span<std::uint32_t> colors) -> void {
+    // Each group of four bytes (r, g, b, a) becomes one ARGB color; a short tail pads g, b with 0 and a with 255
+    kernels::encode_colors(data, colors);
+}
+
 auto SignatureVisualizer::decode_data_from_colors(const std::vector<std::uint32_t>& colors) -> std::vector<std::byte> {
-    std::vector<std::byte> data;
-    
-    // Decode colors back to bytes
-    for (uint32_t color : colors) {
-        uint8_t a = (color >> 24) & 0xFF;
-        uint8_t r = (color >> 16) & 0xFF;
-        uint8_t g = (color >> 8) & 0xFF;
-        uint8_t b = color & 0xFF;
-        
-        data.push_back(static_cast<std::byte>(r));
-        data.push_back(static_cast<std::byte>(g));
-        data.push_back(static_cast<std::byte>(b));
-        data.push_back(static_cast<std::byte>(a));
-    }
-    
+    std::vector<std::byte> data(colors.size() * 4);
+    kernels::decode_colors(colors, data);
     return data;
 }
 
 auto SignatureVisualizer::calculate_checksum(const VisualSignature& sig) -> std::uint64_t {
-    std::uint64_t checksum = 0;
-    
-    // Simple checksum calculation based on points and colors
-    for (const auto& point : sig.points) {
-        checksum += static_cast<std::uint64_t>(point[0] * 1000) + static_cast<std::uint64_t>(point[1] * 1000);
-    }
-    
-    for (const auto& color : sig.colors) {
-        checksum += static_cast<std::uint64_t>(color);
-    }
-    
-    return checksum;
+    return checksum_of(sig.points, sig.colors);
+}
+
+auto SignatureVisualizer::checksum_of(std::span<const std::array<float, 2>> points,
+                                      std::span<const std::uint32_t> colors) -> std::uint64_t {
+    // Sum of coordinates scaled by 1000 plus every color
+    return kernels::checksum(points, colors);
 }
 
 // SecureDataReader implementation
@@ -414,17 +495,7 @@ auto SignatureVisualizer::SecureDataReader::extract_domain_verification(const Vi
 
 auto SignatureVisualizer::SecureDataReader::verify_integrity(const VisualSignature& sig) -> bool {
     // Verify the visual checksum
-    uint64_t calculated_checksum = 0;
-    
-    for (const auto& point : sig.points) {
-        calculated_checksum += static_cast<std::uint64_t>(point[0] * 1000) + static_cast<std::uint64_t>(point[1] * 1000);
-    }
-    
-    for (const auto& color : sig.colors) {
-        calculated_checksum += static_cast<std::uint64_t>(color);
-    }
-    
-    return calculated_checksum == sig.visual_checksum;
+    return checksum_of(sig.points, sig.colors) == sig.visual_checksum;
 }
 
 // Utility functions implementation
@@ -16,11 +16,14 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <functional>
 #include <map>
 #include <cmath>
 #include <bitset>
 #include <cstddef>
+#include <span>
+#include "signature_kernels.h"
 
 // Define std::byte if not available
 #if __cplusplus >= 201703L
@@ -39,6 +42,10 @@ namespace dualstack::security::tls::pqc {
     class AES256Encryption;
 }
 
+namespace dualstack::performance {
+    class thread_pool;
+}
+
 namespace dualstack::security::visualization {
 
 // Unique signature visualization system
@@ -76,6 +83,46 @@ public:
         DomainVerification domain_info;                     // Domain verification details
     };
     
+    // Structure-of-arrays point storage for vectorized consumers
+    struct PointSoA {
+        std::vector<float> x;
+        std::vector<float> y;
+        
+        auto size() const -> std::size_t { return x.size(); }
+        
+        static auto from_points(std::span<const std::array<float, 2>> points) -> PointSoA;
+        auto to_points() const -> std::vector<std::array<float, 2>>;
+    };
+    
+    // Batch output - every signature's points and colors in one contiguous arena
+    struct SignatureBatch {
+        struct Entry {
+            std::size_t point_offset;
+            std::size_t point_count;
+            std::size_t color_offset;
+            std::size_t color_count;
+            std::size_t complexity;
+            std::uint64_t visual_checksum;
+        };
+        
+        std::vector<std::array<float, 2>> points;           // All signatures back to back
+        std::vector<std::uint32_t> colors;
+        std::vector<Entry> entries;                         // One per input, in input order
+        
+        auto size() const -> std::size_t { return entries.size(); }
+        
+        auto points_of(std::size_t index) const -> std::span<const std::array<float, 2>> {
+            return {points.data() + entries[index].point_offset, entries[index].point_count};
+        }
+        
+        auto colors_of(std::size_t index) const -> std::span<const std::uint32_t> {
+            return {colors.data() + entries[index].color_offset, entries[index].color_count};
+        }
+        
+        // Materialize one entry as a standalone signature
+        auto signature(std::size_t index) const -> VisualSignature;
+    };
+    
     // Guarantee seal properties - readable image containing all information
     struct GuaranteeSeal {
         VisualSignature visual_sig;
@@ -156,36 +203,15 @@ public:
                 return false;
             }
             
-            // Compare points with tolerance
-            for (std::size_t i = 0; i < input_sig.points.size(); ++i) {
-                float dx = input_sig.points[i][0] - reference_points_[i][0];
-                float dy = input_sig.points[i][1] - reference_points_[i][1];
-                float distance = std::sqrt(dx * dx + dy * dy);
-                
-                if (distance > tolerance_) {
-                    return false;
-                }
+            // Compare points with tolerance (squared distances, stops at the first miss)
+            if (!kernels::points_within(input_sig.points, reference_points_, tolerance_ * tolerance_)) {
+                return false;
             }
             
             // Compare colors (allowing for slight variations)
             for (std::size_t i = 0; i < input_sig.colors.size(); ++i) {
-                if (input_sig.colors[i] != reference_colors_[i]) {
-                    // Allow for color tolerance (simple RGB difference)
-                    std::uint32_t ref_color = reference_colors_[i];
-                    std::uint32_t inp_color = static_cast<std::uint32_t>(input_sig.colors[i]);
-                    
-                    std::uint8_t ref_r = (ref_color >> 16) & 0xFF;
-                    std::uint8_t ref_g = (ref_color >> 8) & 0xFF;
-                    std::uint8_t ref_b = ref_color & 0xFF;
-                    
-                    std::uint8_t inp_r = (inp_color >> 16) & 0xFF;
-                    std::uint8_t inp_g = (inp_color >> 8) & 0xFF;
-                    std::uint8_t inp_b = inp_color & 0xFF;
-                    
-                    int color_diff = std::abs(ref_r - inp_r) + std::abs(ref_g - inp_g) + std::abs(ref_b - inp_b);
-                    if (color_diff > 30) { // Allow ~10% color variation
-                        return false;
-                    }
+                if (!colors_match(input_sig.colors[i], reference_colors_[i])) {
+                    return false;
                 }
             }
             
@@ -197,16 +223,23 @@ public:
                 return 0.0f;
             }
             
-            float total_distance = 0.0f;
-            for (std::size_t i = 0; i < input_sig.points.size(); ++i) {
-                float dx = input_sig.points[i][0] - reference_points_[i][0];
-                float dy = input_sig.points[i][1] - reference_points_[i][1];
-                total_distance += std::sqrt(dx * dx + dy * dy);
-            }
-            
+            float total_distance = kernels::distance_sum(input_sig.points, reference_points_);
             float average_distance = total_distance / input_sig.points.size();
             return std::max(0.0f, 1.0f - average_distance / tolerance_);
         }
+        
+        auto tolerance() const -> float { return tolerance_; }
+        
+        // Colors match when their RGB channels differ by at most 30 in total (~10% variation)
+        static auto colors_match(std::uint32_t input, std::uint32_t reference) -> bool {
+            if (input == reference) {
+                return true;
+            }
+            int color_diff = std::abs(static_cast<int>((input >> 16) & 0xFF) - static_cast<int>((reference >> 16) & 0xFF)) +
+                             std::abs(static_cast<int>((input >> 8) & 0xFF) - static_cast<int>((reference >> 8) & 0xFF)) +
+                             std::abs(static_cast<int>(input & 0xFF) - static_cast<int>(reference & 0xFF));
+            return color_diff <= 30;
+        }
     };
 
 private:
@@ -223,6 +256,32 @@ private:
     std::vector<std::byte> kyber_private_key_;
     std::vector<std::byte> aes_key_;
     
+    // Worker pool for generate_batch; the mutex covers creation and replacement,
+    // and each batch holds its own reference while it runs. Copies of the
+    // visualizer share the pool, each with its own mutex.
+    struct BatchPoolSlot {
+        mutable std::mutex mutex;
+        std::shared_ptr<performance::thread_pool> pool;
+        
+        BatchPoolSlot() = default;
+        BatchPoolSlot(const BatchPoolSlot& other) : pool(other.get()) {}
+        auto operator=(const BatchPoolSlot& other) -> BatchPoolSlot& {
+            if (this != &other) {
+                set(other.get());
+            }
+            return *this;
+        }
+        auto get() const -> std::shared_ptr<performance::thread_pool> {
+            std::lock_guard<std::mutex> lock(mutex);
+            return pool;
+        }
+        auto set(std::shared_ptr<performance::thread_pool> replacement) -> void {
+            std::lock_guard<std::mutex> lock(mutex);
+            pool = std::move(replacement);
+        }
+    };
+    BatchPoolSlot batch_pool_;
+    
 public:
     explicit SignatureVisualizer(float param_a = 3.7f, float param_b = 0.3f, std::size_t iterations = 1000)
         : chaos_parameter_a_(param_a), chaos_parameter_b_(param_b), iteration_count_(iterations), bits_per_pixel_(4) {
@@ -233,6 +292,12 @@ public:
     // Generate visual signature from cryptographic data - image holds all information transparently
     auto generate_visual_signature(const std::vector<std::byte>& crypto_data) -> VisualSignature;
     
+    // Generate signatures for many inputs across a thread pool into one contiguous arena
+    auto generate_batch(std::span<const std::vector<std::byte>> crypto_data) -> SignatureBatch;
+    
+    // Chaotic map points in structure-of-arrays layout (same values as VisualSignature::points)
+    auto chaotic_map_soa(std::size_t iterations) const -> PointSoA;
+    
     // Create guarantee seal with visual representation - readable image containing all information
     auto create_guarantee_seal(const std::vector<std::byte>& crypto_data, 
                               const std::string& issuer) -> GuaranteeSeal;
@@ -245,15 +310,17 @@ public:
     auto domain_verification_to_signature(const DomainVerification& domain_info) -> VisualSignature;
     
     // Convert visual signature to SVG for display - human readable image
+    // (SvgWriter in svg_writer.h streams to sockets and offers a compact <path> form)
     auto to_svg(const VisualSignature& sig, std::size_t width = 512, std::size_t height = 512) -> std::string;
     
-    // Convert visual signature to PNG data - binary image format
+    // Convert visual signature to PNG data - RGBA raster with the signature embedded (png_codec.h)
     auto to_png(const VisualSignature& sig, std::size_t width = 512, std::size_t height = 512) -> std::vector<std::byte>;
     
-    // Convert visual signature to compact string representation
+    // Convert visual signature to human-readable text (debugging only; storage and
+    // transport use the binary format in signature_codec.h)
     auto to_string(const VisualSignature& sig) -> std::string;
     
-    // Parse visual signature from string representation
+    // Parse visual signature from the debug text representation
     auto from_string(const std::string& str) -> VisualSignature;
     
     // Extract embedded data from visual signature (requires special reader)
@@ -292,6 +359,12 @@ public:
         aes_key_ = key;
     }
     
+    // Share a pool with the caller; otherwise generate_batch creates one on first use
+    // (a batch started on one of the pool's own workers runs on that thread)
+    auto set_thread_pool(std::shared_ptr<performance::thread_pool> pool) -> void {
+        batch_pool_.set(std::move(pool));
+    }
+    
     // Get special readers/writers
     auto get_secure_reader() const -> SecureDataReader {
         return SecureDataReader(kyber_private_key_, aes_key_);
@@ -308,6 +381,13 @@ private:
     auto encode_data_in_colors(const std::vector<std::byte>& data) -> std::vector<std::uint32_t>;
     auto decode_data_from_colors(const std::vector<std::uint32_t>& colors) -> std::vector<std::byte>;
     auto calculate_checksum(const VisualSignature& sig) -> std::uint64_t;
+    
+    // Allocation-free kernels shared by the single and batch paths
+    auto chaotic_map_into(std::span<std::array<float, 2>> points) const -> void;
+    static auto encode_colors_into(std::span<const std::byte> data, std::span<std::uint32_t> colors) -> void;
+    static auto checksum_of(std::span<const std::array<float, 2>> points,
+                            std::span<const std::uint32_t> colors) -> std::uint64_t;
+    static auto encoded_color_count(std::size_t data_size) -> std::size_t { return (data_size + 3) / 4; }
 };
 
 // Utility functions for signature visualization
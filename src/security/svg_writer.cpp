@@ -0,0 +1,217 @@
+// Include format header fix BEFORE any standard headers
+#include "../../include/dualstack_net26/fix_format_header.h"
+#include "svg_writer.h"
+#include "../core/socket.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace dualstack::security::visualization {
+
+namespace {
+
+// Longest fixed-notation float: sign, 39 integer digits, point, 6 fractional digits
+constexpr std::size_t MAX_NUMBER = 48;
+
+// Worst case for any single element written between capacity checks
+constexpr std::size_t MAX_ELEMENT = 2 * MAX_NUMBER + 128;
+
+constexpr std::string_view DOCUMENT_HEAD = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n<svg width=\"";
+constexpr std::string_view DOCUMENT_INFO = "\" xmlns=\"http://www.w3.org/2000/svg\">\n"
+                                           "  <title>Amphisbaena Visual Signature</title>\n"
+                                           "  <desc>Generated visual signature containing encrypted metadata</desc>\n";
+constexpr std::string_view DOCUMENT_TAIL = "</svg>\n";
+
+// Writes into buffer[used..]; grows the buffer, or hands full chunks to the sink
+class Emitter {
+public:
+    Emitter(std::string& buffer, std::size_t used, const SvgSink* sink, int precision)
+        : buffer_(buffer), used_(used), sink_(sink), precision_(precision) {}
+
+    // Make room for n more bytes; false once the sink has aborted
+    auto ensure(std::size_t n) -> bool {
+        if (buffer_.size() - used_ >= n) {
+            return true;
+        }
+        if (sink_) {
+            return flush();
+        }
+        buffer_.resize(std::max(buffer_.size() * 2, used_ + n));
+        return true;
+    }
+
+    auto flush() -> bool {
+        if (sink_ && used_ > 0) {
+            aborted_ = aborted_ || !(*sink_)(std::string_view(buffer_.data(), used_));
+            used_ = 0;
+        }
+        return !aborted_;
+    }
+
+    auto put(std::string_view text) -> void {
+        std::copy(text.begin(), text.end(), buffer_.data() + used_);
+        used_ += text.size();
+    }
+
+    auto put(char c) -> void {
+        buffer_[used_++] = c;
+    }
+
+    auto put_number(float value) -> void {
+        if (!std::isfinite(value)) {
+            value = 0.0f;
+        }
+        char* first = buffer_.data() + used_;
+        auto result = std::to_chars(first, first + MAX_NUMBER, value, std::chars_format::fixed, precision_);
+        used_ += static_cast<std::size_t>(result.ptr - first);
+    }
+
+    auto put_integer(std::size_t value) -> void {
+        char* first = buffer_.data() + used_;
+        auto result = std::to_chars(first, first + MAX_NUMBER, value);
+        used_ += static_cast<std::size_t>(result.ptr - first);
+    }
+
+    auto put_hex_color(std::uint32_t color) -> void {
+        constexpr char digits[] = "0123456789abcdef";
+        put('#');
+        for (int shift = 20; shift >= 0; shift -= 4) {
+            put(digits[(color >> shift) & 0xF]);
+        }
+    }
+
+    auto used() const -> std::size_t { return used_; }
+
+private:
+    std::string& buffer_;
+    std::size_t used_;
+    const SvgSink* sink_;
+    int precision_;
+    bool aborted_ = false;
+};
+
+auto emit_document(Emitter& out, const SignatureVisualizer::VisualSignature& sig, const SvgOptions& options) -> bool {
+    if (!out.ensure(DOCUMENT_HEAD.size() + DOCUMENT_INFO.size() + MAX_ELEMENT)) {
+        return false;
+    }
+    out.put(DOCUMENT_HEAD);
+    out.put_integer(options.width);
+    out.put("\" height=\"");
+    out.put_integer(options.height);
+    out.put(DOCUMENT_INFO);
+
+    auto width = static_cast<float>(options.width);
+    auto height = static_cast<float>(options.height);
+    std::size_t count = std::min(sig.points.size(), sig.colors.size());
+
+    if (options.compact_path) {
+        // A zero-length segment with round caps and width 4 draws the same dot as <circle r="2">
+        out.put("  <g fill=\"none\" stroke-width=\"4\" stroke-linecap=\"round\">\n");
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!out.ensure(MAX_ELEMENT)) {
+                return false;
+            }
+            std::uint32_t rgb = sig.colors[i] & 0xFFFFFF;
+            if (i == 0 || rgb != (sig.colors[i - 1] & 0xFFFFFF)) {
+                if (i != 0) {
+                    out.put("\"/>\n");
+                }
+                out.put("    <path stroke=\"");
+                out.put_hex_color(rgb);
+                out.put("\" d=\"");
+            }
+            out.put('M');
+            out.put_number(sig.points[i][0] * width);
+            out.put(' ');
+            out.put_number(sig.points[i][1] * height);
+            out.put("h0");
+        }
+        if (!out.ensure(MAX_ELEMENT)) {
+            return false;
+        }
+        if (count != 0) {
+            out.put("\"/>\n");
+        }
+        out.put("  </g>\n");
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!out.ensure(MAX_ELEMENT)) {
+                return false;
+            }
+            std::uint32_t color = sig.colors[i];
+            out.put("  <circle cx=\"");
+            out.put_number(sig.points[i][0] * width);
+            out.put("\" cy=\"");
+            out.put_number(sig.points[i][1] * height);
+            out.put("\" r=\"2\" fill=\"rgb(");
+            out.put_integer((color >> 16) & 0xFF);
+            out.put(',');
+            out.put_integer((color >> 8) & 0xFF);
+            out.put(',');
+            out.put_integer(color & 0xFF);
+            out.put(")\"/>\n");
+        }
+    }
+
+    if (!out.ensure(DOCUMENT_TAIL.size())) {
+        return false;
+    }
+    out.put(DOCUMENT_TAIL);
+    return true;
+}
+
+auto clamped(SvgOptions options) -> SvgOptions {
+    options.precision = std::clamp(options.precision, 0, 6);
+    return options;
+}
+
+} // anonymous namespace
+
+auto SvgWriter::estimate_size(const SignatureVisualizer::VisualSignature& sig) const -> std::size_t {
+    auto options = clamped(options_);
+
+    // Typical coordinate: integer digits of the canvas size, the point and the fraction
+    std::size_t canvas_digits = std::to_string(std::max(options.width, options.height)).size();
+    std::size_t number = canvas_digits + 1 + static_cast<std::size_t>(options.precision);
+    std::size_t count = std::min(sig.points.size(), sig.colors.size());
+
+    // Per point: circle markup and rgb() triple, or one dot plus a path per color change
+    std::size_t per_point = options.compact_path ? 2 * number + 4 + 30 : 2 * number + 48;
+    return DOCUMENT_HEAD.size() + DOCUMENT_INFO.size() + DOCUMENT_TAIL.size() + 96 + count * per_point;
+}
+
+auto SvgWriter::render(const SignatureVisualizer::VisualSignature& sig, std::string& out) const -> void {
+    std::size_t start = out.size();
+    out.resize(start + estimate_size(sig));
+
+    Emitter emitter(out, start, nullptr, clamped(options_).precision);
+    emit_document(emitter, sig, clamped(options_));
+    out.resize(emitter.used());
+}
+
+auto SvgWriter::render(const SignatureVisualizer::VisualSignature& sig, const SvgSink& sink,
+                       std::size_t chunk_size) const -> bool {
+    std::string chunk(std::max(chunk_size, 2 * MAX_ELEMENT + DOCUMENT_HEAD.size() + DOCUMENT_INFO.size()), '\0');
+
+    Emitter emitter(chunk, 0, &sink, clamped(options_).precision);
+    bool complete = emit_document(emitter, sig, clamped(options_));
+    return emitter.flush() && complete;
+}
+
+auto SvgWriter::socket_sink(Socket& socket) -> SvgSink {
+    return [&socket](std::string_view chunk) {
+        const auto* data = reinterpret_cast<const std::byte*>(chunk.data());
+        std::size_t remaining = chunk.size();
+        while (remaining > 0) {
+            std::size_t sent = socket.send(buffer_t(data, remaining));
+            if (sent == 0) {
+                return false;
+            }
+            data += sent;
+            remaining -= sent;
+        }
+        return true;
+    };
+}
+
+} // namespace dualstack::security::visualization
@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "signature_visualizer.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace dualstack {
+    class Socket;
+}
+
+namespace dualstack::security::visualization {
+
+// SVG rendering options
+struct SvgOptions {
+    std::size_t width = 512;
+    std::size_t height = 512;
+    int precision = 2;              // Fractional digits for coordinates (clamped to 0..6)
+    bool compact_path = false;      // Runs of same-colored points become one <path> of round-capped dots
+};
+
+// Receives rendered output in order; returning false aborts rendering
+using SvgSink = std::function<bool(std::string_view)>;
+
+// Streaming SVG renderer
+// Numbers are formatted with std::to_chars into one growing buffer (string
+// output) or a fixed chunk handed to a sink, so rendering never touches
+// iostreams or locales.
+class SvgWriter {
+public:
+    explicit SvgWriter(SvgOptions options = {}) : options_(options) {}
+
+    // Approximate rendered size; render() reserves this up front
+    auto estimate_size(const SignatureVisualizer::VisualSignature& sig) const -> std::size_t;
+
+    // Append the document to out
+    auto render(const SignatureVisualizer::VisualSignature& sig, std::string& out) const -> void;
+
+    // Stream the document to sink in chunks of at most chunk_size bytes; false if the sink aborted
+    auto render(const SignatureVisualizer::VisualSignature& sig, const SvgSink& sink,
+                std::size_t chunk_size = 16384) const -> bool;
+
+    // Sink that writes each chunk to a connected socket, retrying partial sends
+    static auto socket_sink(Socket& socket) -> SvgSink;
+
+    auto options() const -> const SvgOptions& { return options_; }
+
+private:
+    SvgOptions options_;
+};
+
+} // namespace dualstack::security::visualization
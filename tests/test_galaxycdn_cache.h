@@ -0,0 +1,948 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../src/network/galaxycdn_cache.h"
+#include "../src/network/galaxycdn_fetcher.h"
+#include "../src/network/galaxycdn_maglev.h"
+#include "../src/core/acceptor.h"
+#include <cmath>
+#include <filesystem>
+#include <set>
+#include <thread>
+
+namespace dualstack {
+namespace test {
+
+// Scratch segment directory, removed when the test finishes
+struct CacheTestDirectory {
+    std::filesystem::path path;
+
+    explicit CacheTestDirectory(const std::string& name)
+        : path(std::filesystem::temp_directory_path() /
+               ("amphisbaena-" + name + "-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))) {}
+
+    ~CacheTestDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+inline auto make_cache_object(size_t size, uint8_t seed) -> std::vector<std::byte> {
+    std::vector<std::byte> body(size);
+    for (size_t i = 0; i < size; ++i) {
+        body[i] = static_cast<std::byte>((i * 31 + seed) & 0xFF);
+    }
+    return body;
+}
+
+inline auto test_object_cache_put_find_reopen() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("cache-reopen");
+    ObjectCacheConfig config;
+    config.segment_directory = directory.path.string();
+    config.segment_bytes = 64 * 1024;
+
+    auto body = make_cache_object(5000, 7);
+    ObjectMetadata metadata;
+    metadata.content_type = "image/png";
+    ContentHash hash;
+    {
+        auto cache = ObjectCache::open(config);
+        if (!cache) {
+            return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+        }
+        auto stored = (*cache)->put(body, metadata);
+        if (!stored || *stored != ContentHash::of(body)) {
+            return TestResult(false, "Object was not stored under its content hash", std::chrono::milliseconds(0));
+        }
+        hash = *stored;
+        if (ContentHash::from_string(hash.to_string()) != hash) {
+            return TestResult(false, "Content hash text form does not round trip", std::chrono::milliseconds(0));
+        }
+
+        auto warm = (*cache)->find(hash);
+        auto hot = (*cache)->find(hash);
+        if (!warm || warm->in_memory() || !hot || !hot->in_memory()) {
+            return TestResult(false, "Second lookup should be served from the hot tier", std::chrono::milliseconds(0));
+        }
+        if (!std::ranges::equal(hot->body(), body) || !std::ranges::equal(warm->body(), body)) {
+            return TestResult(false, "Cached body differs from stored body", std::chrono::milliseconds(0));
+        }
+        if ((*cache)->find(ContentHash::of(make_cache_object(10, 1)))) {
+            return TestResult(false, "Lookup of unknown content should miss", std::chrono::milliseconds(0));
+        }
+    }
+
+    auto reopened = ObjectCache::open(config);
+    if (!reopened || !(*reopened)->contains(hash)) {
+        return TestResult(false, "Reopened cache lost its segment contents", std::chrono::milliseconds(0));
+    }
+    auto handle = (*reopened)->find(hash);
+    if (!handle || !std::ranges::equal(handle->body(), body) || handle->metadata().content_type != "image/png") {
+        return TestResult(false, "Reloaded object differs from stored object", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_content_hash_is_sha256() -> TestResult {
+    using namespace network::GalaxyCDN;
+    auto digest = [](std::string_view text) {
+        return ContentHash::of(std::as_bytes(std::span<const char>(text.data(), text.size()))).to_string();
+    };
+    // FIPS 180-2 examples, covering the one- and two-block padding cases
+    if (digest("") != "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" ||
+        digest("abc") != "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" ||
+        digest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") !=
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1") {
+        return TestResult(false, "Content hash does not match SHA-256", std::chrono::milliseconds(0));
+    }
+    return assert_true(!ContentHash::from_string(std::string(32, '0')).has_value(),
+                       "Short hex should not parse as a content hash");
+}
+
+inline auto test_object_cache_duplicate_put_persists_metadata() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("cache-metadata");
+    ObjectCacheConfig config;
+    config.segment_directory = directory.path.string();
+    config.segment_bytes = 64 * 1024;
+
+    auto body = make_cache_object(3000, 5);
+    ObjectMetadata first;
+    first.content_type = "text/plain";
+    ObjectMetadata second;
+    second.content_type = "application/json";
+    {
+        auto cache = ObjectCache::open(config);
+        if (!cache || !(*cache)->put(body, first) || !(*cache)->put(body, second)) {
+            return TestResult(false, "Could not store test object", std::chrono::milliseconds(0));
+        }
+        auto handle = (*cache)->find(ContentHash::of(body));
+        if (!handle || handle->metadata().content_type != "application/json") {
+            return TestResult(false, "Second put should replace the metadata", std::chrono::milliseconds(0));
+        }
+    }
+
+    auto reopened = ObjectCache::open(config);
+    auto handle = reopened ? (*reopened)->find(ContentHash::of(body)) : std::nullopt;
+    if (!handle || !std::ranges::equal(handle->body(), body)) {
+        return TestResult(false, "Reopened cache lost the object", std::chrono::milliseconds(0));
+    }
+    return assert_true(handle->metadata().content_type == "application/json",
+                       "Replaced metadata should survive a reopen");
+}
+
+inline auto test_object_cache_tinylfu_admission() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("cache-admission");
+    ObjectCacheConfig config;
+    config.segment_directory = directory.path.string();
+    config.shard_count = 1;
+    config.hot_capacity_bytes = 2000;          // Room for two of the objects below
+    config.segment_bytes = 64 * 1024;
+
+    auto cache = ObjectCache::open(config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+    auto a = (*cache)->put(make_cache_object(1000, 1), {});
+    auto b = (*cache)->put(make_cache_object(1000, 2), {});
+    auto c = (*cache)->put(make_cache_object(1000, 3), {});
+    if (!a || !b || !c) {
+        return TestResult(false, "Could not store test objects", std::chrono::milliseconds(0));
+    }
+    for (int i = 0; i < 4; ++i) {
+        (*cache)->find(*a);
+        (*cache)->find(*b);
+    }
+
+    // A one-hit wonder must not displace popular objects
+    auto once = (*cache)->find(*c);
+    if (!once || once->in_memory() || (*cache)->get_stats().rejected == 0) {
+        return TestResult(false, "Cold object should be refused by TinyLFU", std::chrono::milliseconds(0));
+    }
+
+    // Once it is more popular than the LRU victim it gets in
+    for (int i = 0; i < 8; ++i) {
+        (*cache)->find(*c);
+    }
+    auto hot = (*cache)->find(*c);
+    auto stats = (*cache)->get_stats();
+    if (!hot || !hot->in_memory() || stats.hot_evictions == 0 || stats.hot_bytes > config.hot_capacity_bytes) {
+        return TestResult(false, "Popular object should be admitted by evicting the LRU victim",
+                          std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_object_cache_segment_eviction() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("cache-segments");
+    ObjectCacheConfig config;
+    config.segment_directory = directory.path.string();
+    config.segment_bytes = 4096;
+    config.warm_capacity_bytes = 3 * 4096;
+    config.max_hot_object_bytes = 0;           // Keep every handle on the segment mapping
+
+    auto cache = ObjectCache::open(config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+    auto first_body = make_cache_object(2000, 0);
+    auto first = (*cache)->put(first_body, {});
+    auto held = first ? (*cache)->find(*first) : std::nullopt;
+
+    std::vector<ContentHash> hashes;
+    for (uint8_t i = 1; i < 10; ++i) {
+        auto stored = (*cache)->put(make_cache_object(2000, i), {});
+        if (!stored) {
+            return TestResult(false, describe(stored.error()), std::chrono::milliseconds(0));
+        }
+        hashes.push_back(*stored);
+    }
+
+    auto stats = (*cache)->get_stats();
+    if (stats.segments_evicted == 0 || stats.warm_bytes > config.warm_capacity_bytes) {
+        return TestResult(false, "Warm tier exceeded its capacity", std::chrono::milliseconds(0));
+    }
+    if ((*cache)->contains(*first) || !(*cache)->contains(hashes.back())) {
+        return TestResult(false, "Oldest segment should be evicted first", std::chrono::milliseconds(0));
+    }
+    if (!held || !std::ranges::equal(held->body(), first_body)) {
+        return TestResult(false, "Handle must stay readable after its segment is evicted", std::chrono::milliseconds(0));
+    }
+    held.reset();
+
+    size_t files = 0;
+    for ([[maybe_unused]] const auto& entry : std::filesystem::directory_iterator(directory.path)) {
+        ++files;
+    }
+    return assert_true(files <= 3, "Evicted segment files are deleted");
+}
+
+inline auto test_object_cache_serves_range() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("cache-serve");
+    ObjectCacheConfig config;
+    config.segment_directory = directory.path.string();
+    config.max_hot_object_bytes = 0;           // Force the sendfile path
+
+    auto cache = ObjectCache::open(config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+    auto body = make_cache_object(64 * 1024, 9);
+    ObjectMetadata metadata;
+    metadata.content_type = "application/octet-stream";
+    auto hash = (*cache)->put(body, metadata);
+    if (!hash) {
+        return TestResult(false, describe(hash.error()), std::chrono::milliseconds(0));
+    }
+
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+    std::expected<uint64_t, CacheError> served = std::unexpected(CacheError::send_failed);
+    bool unsatisfiable = false;
+    std::thread edge([&] {
+        auto client = acceptor.accept();
+        if (!client.has_value()) {
+            return;
+        }
+        Socket socket = std::move(client.value());
+        auto refused = (*cache)->serve(socket, *hash, ByteRange{body.size(), UINT64_MAX}, 1);
+        unsatisfiable = !refused && refused.error() == CacheError::range_not_satisfiable;
+        served = (*cache)->serve(socket, *hash, ByteRange{1000, 40999}, 7);
+    });
+
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::string connection_id;
+    try {
+        connection_id = manager.create_async_connection(IPAddress::from_string("::1").value(), acceptor.local_port());
+    } catch (const std::exception&) {
+        acceptor.stop_listening();
+        edge.join();
+        return TestResult(false, "Could not connect to loopback edge", std::chrono::milliseconds(0));
+    }
+
+    std::vector<std::byte> payload;
+    auto header = manager.receive_galaxycdn_frame(connection_id, payload);
+    edge.join();
+    if (!header || header->request_id != 7 || !served || !unsatisfiable) {
+        return TestResult(false, "Range response was not served", std::chrono::milliseconds(0));
+    }
+
+    auto response = view_message<ObjectResponse>(*header, payload);
+    if (!response || response->get<&ObjectResponse::status>() != 206 ||
+        response->get<&ObjectResponse::content_length>() != body.size() ||
+        response->get<&ObjectResponse::etag>() != hash->to_string()) {
+        return TestResult(false, "Range response failed validation", std::chrono::milliseconds(0));
+    }
+    auto range = response->get<&ObjectResponse::body>().bytes();
+    if (!std::ranges::equal(range, std::span<const std::byte>(body).subspan(1000, 40000))) {
+        return TestResult(false, "Range body differs from the stored bytes", std::chrono::milliseconds(0));
+    }
+#if defined(__linux__)
+    return assert_true((*cache)->get_stats().bytes_sendfile == 40000, "Warm body is sent with sendfile");
+#else
+    return TestResult(true, "", std::chrono::milliseconds(0));
+#endif
+}
+
+// Origin stand-in: answers every ObjectRequest on one connection with body after
+// delay, or 304 when If-None-Match already names it
+inline auto run_test_origin(Acceptor& acceptor, const std::vector<std::byte>& body, std::atomic<int>& requests,
+                            std::chrono::milliseconds delay) -> void {
+    using namespace network::GalaxyCDN;
+    auto client = acceptor.accept();
+    if (!client.has_value()) {
+        return;
+    }
+    Socket socket = std::move(client.value());
+    auto read_exact = [&socket](std::byte* data, size_t size) {
+        for (size_t offset = 0; offset < size;) {
+            size_t got = socket.receive(buffer_t(data + offset, size - offset));
+            if (got == 0) return false;
+            offset += got;
+        }
+        return true;
+    };
+    std::string etag = ContentHash::of(body).to_string();
+    for (;;) {
+        ProtocolHeader header{};
+        std::vector<std::byte> payload;
+        if (!read_exact(reinterpret_cast<std::byte*>(&header), sizeof(header))) {
+            return;
+        }
+        payload.resize(header.payload_length);
+        if (!read_exact(payload.data(), payload.size())) {
+            return;
+        }
+        auto request = view_message<ObjectRequest>(header, payload);
+        if (!request) {
+            return;
+        }
+        ++requests;
+        std::this_thread::sleep_for(delay);
+
+        ObjectResponse response;
+        response.status = 304;
+        if (request->get<&ObjectRequest::if_none_match>() != etag) {
+            response.status = 200;
+            response.content_type = "video/mp4";
+            response.content_length = body.size();
+            response.body = body;
+        }
+        std::vector<std::byte> reply;
+        reflect::build_message(response, reply);
+        ProtocolHeader reply_header{PROTOCOL_MAGIC, PROTOCOL_VERSION, message_flags<ObjectResponse>(),
+                                    static_cast<uint32_t>(reply.size()), header.request_id};
+        (void)socket.send(buffer_t(reinterpret_cast<const std::byte*>(&reply_header), sizeof(reply_header)));
+        (void)socket.send(buffer_t(reply.data(), reply.size()));
+    }
+}
+
+inline auto test_fetcher_coalesces_concurrent_misses() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("fetch-coalesce");
+    ObjectCacheConfig cache_config;
+    cache_config.segment_directory = directory.path.string();
+    auto cache = ObjectCache::open(cache_config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+    auto body = make_cache_object(4096, 5);
+    std::atomic<int> requests{0};
+    std::thread origin([&] { run_test_origin(acceptor, body, requests, std::chrono::milliseconds(100)); });
+
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::string connection_id;
+    try {
+        connection_id = manager.create_async_connection(IPAddress::from_string("::1").value(), acceptor.local_port());
+    } catch (const std::exception&) {
+        acceptor.stop_listening();
+        origin.join();
+        return TestResult(false, "Could not connect to loopback origin", std::chrono::milliseconds(0));
+    }
+
+    std::atomic<int> matched{0};
+    FetcherStats stats;
+    {
+        CoalescingFetcher fetcher(**cache, manager, FetcherConfig{connection_id});
+        std::vector<std::thread> clients;
+        for (int i = 0; i < 16; ++i) {
+            clients.emplace_back([&] {
+                auto result = fetcher.fetch("cdn.example", "/video/intro.mp4");
+                if (result && result->hash == ContentHash::of(body)) {
+                    ++matched;
+                }
+            });
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+        stats = fetcher.get_stats();
+    }
+    manager.close_connection(connection_id);
+    origin.join();
+
+    if (matched != 16) {
+        return TestResult(false, "Every client should resolve to the fetched object", std::chrono::milliseconds(0));
+    }
+    if (requests != 1 || stats.origin_fetches != 1 || stats.coalesced + stats.fresh_hits != 15) {
+        return TestResult(false, "Concurrent misses should share one origin fetch", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_fetcher_stale_while_revalidate() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("fetch-stale");
+    ObjectCacheConfig cache_config;
+    cache_config.segment_directory = directory.path.string();
+    auto cache = ObjectCache::open(cache_config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+    auto body = make_cache_object(2048, 6);
+    std::atomic<int> requests{0};
+    std::thread origin([&] { run_test_origin(acceptor, body, requests, std::chrono::milliseconds(0)); });
+
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::string connection_id;
+    try {
+        connection_id = manager.create_async_connection(IPAddress::from_string("::1").value(), acceptor.local_port());
+    } catch (const std::exception&) {
+        acceptor.stop_listening();
+        origin.join();
+        return TestResult(false, "Could not connect to loopback origin", std::chrono::milliseconds(0));
+    }
+
+    bool served_stale = false;
+    FetcherStats stats;
+    {
+        // Zero TTL: everything is stale at once, but inside the grace period
+        CoalescingFetcher fetcher(**cache, manager,
+                                  FetcherConfig{connection_id, std::chrono::seconds(0), std::chrono::seconds(60)});
+        auto first = fetcher.fetch("cdn.example", "/index.html");
+        auto second = fetcher.fetch("cdn.example", "/index.html");
+        served_stale = first && first->source == FetchSource::origin && second &&
+                       second->source == FetchSource::stale_hit && second->hash == first->hash;
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (fetcher.get_stats().not_modified == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        stats = fetcher.get_stats();
+    }
+    manager.close_connection(connection_id);
+    origin.join();
+
+    if (!served_stale) {
+        return TestResult(false, "Expired object should be served stale", std::chrono::milliseconds(0));
+    }
+    if (stats.revalidations != 1 || stats.not_modified != 1 || requests != 2) {
+        return TestResult(false, "Stale hit should trigger one conditional revalidation", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_fetcher_keys_do_not_collide() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("fetch-keys");
+    ObjectCacheConfig cache_config;
+    cache_config.segment_directory = directory.path.string();
+    auto cache = ObjectCache::open(cache_config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+    auto body = make_cache_object(1024, 7);
+    std::atomic<int> requests{0};
+    std::thread origin([&] { run_test_origin(acceptor, body, requests, std::chrono::milliseconds(0)); });
+
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::string connection_id;
+    try {
+        connection_id = manager.create_async_connection(IPAddress::from_string("::1").value(), acceptor.local_port());
+    } catch (const std::exception&) {
+        acceptor.stop_listening();
+        origin.join();
+        return TestResult(false, "Could not connect to loopback origin", std::chrono::milliseconds(0));
+    }
+
+    bool separate = false;
+    {
+        // Same concatenation, different objects
+        CoalescingFetcher fetcher(**cache, manager, FetcherConfig{connection_id});
+        auto first = fetcher.fetch("cdn.example", "/app.js");
+        auto second = fetcher.fetch("cdn.exampl", "e/app.js");
+        separate = first && first->source == FetchSource::origin && second &&
+                   second->source == FetchSource::origin;
+    }
+    manager.close_connection(connection_id);
+    origin.join();
+
+    return assert_true(separate && requests == 2, "Distinct host/key pairs should not share a catalog entry");
+}
+
+// Origin that misbehaves on its first connections, then serves normally on the next:
+// a silent connection never answers, a desynchronised one answers another request id
+inline auto run_faulty_origin(Acceptor& acceptor, const std::vector<std::byte>& body, std::atomic<int>& requests)
+    -> void {
+    using namespace network::GalaxyCDN;
+    for (bool silent : {true, false}) {
+        auto client = acceptor.accept();
+        if (!client.has_value()) {
+            return;
+        }
+        Socket socket = std::move(client.value());
+        ProtocolHeader header{};
+        std::vector<std::byte> payload;
+        auto read_exact = [&socket](std::byte* data, size_t size) {
+            for (size_t offset = 0; offset < size;) {
+                size_t got = socket.receive(buffer_t(data + offset, size - offset));
+                if (got == 0) return false;
+                offset += got;
+            }
+            return true;
+        };
+        if (!read_exact(reinterpret_cast<std::byte*>(&header), sizeof(header))) {
+            return;
+        }
+        payload.resize(header.payload_length);
+        if (!read_exact(payload.data(), payload.size())) {
+            return;
+        }
+        ++requests;
+        if (!silent) {
+            ObjectResponse response;
+            response.status = 200;
+            response.body = body;
+            std::vector<std::byte> reply;
+            reflect::build_message(response, reply);
+            ProtocolHeader reply_header{PROTOCOL_MAGIC, PROTOCOL_VERSION, message_flags<ObjectResponse>(),
+                                        static_cast<uint32_t>(reply.size()), header.request_id + 100};
+            (void)socket.send(buffer_t(reinterpret_cast<const std::byte*>(&reply_header), sizeof(reply_header)));
+            (void)socket.send(buffer_t(reply.data(), reply.size()));
+        }
+        // Hold the connection until the fetcher drops it
+        std::byte sink[64];
+        while (socket.receive(buffer_t(sink, sizeof(sink))) > 0) {
+        }
+    }
+    run_test_origin(acceptor, body, requests, std::chrono::milliseconds(0));
+}
+
+inline auto test_fetcher_resets_faulty_origin() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("fetch-reset");
+    ObjectCacheConfig cache_config;
+    cache_config.segment_directory = directory.path.string();
+    auto cache = ObjectCache::open(cache_config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+    auto body = make_cache_object(1024, 8);
+    std::atomic<int> requests{0};
+    std::thread origin([&] { run_faulty_origin(acceptor, body, requests); });
+
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::string connection_id;
+    try {
+        connection_id = manager.create_async_connection(IPAddress::from_string("::1").value(), acceptor.local_port());
+    } catch (const std::exception&) {
+        acceptor.stop_listening();
+        origin.join();
+        return TestResult(false, "Could not connect to loopback origin", std::chrono::milliseconds(0));
+    }
+
+    bool timed_out = false;
+    bool mismatched = false;
+    bool recovered = false;
+    FetcherStats stats;
+    {
+        FetcherConfig config{connection_id};
+        config.response_timeout = std::chrono::milliseconds(200);
+        CoalescingFetcher fetcher(**cache, manager, config);
+
+        auto start = std::chrono::steady_clock::now();
+        auto silent = fetcher.fetch("cdn.example", "/slow");
+        timed_out = !silent && silent.error() == FetchError::origin_unavailable &&
+                    std::chrono::steady_clock::now() - start < std::chrono::seconds(5);
+
+        auto desync = fetcher.fetch("cdn.example", "/slow");
+        mismatched = !desync && desync.error() == FetchError::invalid_response;
+
+        auto healthy = fetcher.fetch("cdn.example", "/slow");
+        recovered = healthy && healthy->hash == ContentHash::of(body);
+        stats = fetcher.get_stats();
+    }
+    manager.close_connection(connection_id);
+    acceptor.stop_listening();
+    origin.join();
+
+    if (!timed_out) {
+        return TestResult(false, "Silent origin should time out", std::chrono::milliseconds(0));
+    }
+    if (!mismatched) {
+        return TestResult(false, "Response to another request should be rejected", std::chrono::milliseconds(0));
+    }
+    return assert_true(recovered && requests == 3 && stats.errors == 2,
+                       "Fetcher should redial the origin after a broken exchange");
+}
+
+// Origin that reads two requests before answering either, then answers them in
+// reverse order; the body for a key is make_cache_object(1000, key length)
+inline auto run_reordering_origin(Acceptor& acceptor) -> void {
+    using namespace network::GalaxyCDN;
+    auto client = acceptor.accept();
+    if (!client.has_value()) {
+        return;
+    }
+    Socket socket = std::move(client.value());
+    auto read_exact = [&socket](std::byte* data, size_t size) {
+        for (size_t offset = 0; offset < size;) {
+            size_t got = socket.receive(buffer_t(data + offset, size - offset));
+            if (got == 0) return false;
+            offset += got;
+        }
+        return true;
+    };
+    std::vector<std::pair<uint64_t, size_t>> received;      // request id, key length
+    while (received.size() < 2) {
+        ProtocolHeader header{};
+        std::vector<std::byte> payload;
+        if (!read_exact(reinterpret_cast<std::byte*>(&header), sizeof(header))) {
+            return;
+        }
+        payload.resize(header.payload_length);
+        if (!read_exact(payload.data(), payload.size())) {
+            return;
+        }
+        auto request = view_message<ObjectRequest>(header, payload);
+        if (!request) {
+            return;
+        }
+        received.emplace_back(header.request_id, request->get<&ObjectRequest::key>().size());
+    }
+    for (auto it = received.rbegin(); it != received.rend(); ++it) {
+        ObjectResponse response;
+        response.status = 200;
+        response.body = make_cache_object(1000, static_cast<uint8_t>(it->second));
+        std::vector<std::byte> reply;
+        reflect::build_message(response, reply);
+        ProtocolHeader reply_header{PROTOCOL_MAGIC, PROTOCOL_VERSION, message_flags<ObjectResponse>(),
+                                    static_cast<uint32_t>(reply.size()), it->first};
+        (void)socket.send(buffer_t(reinterpret_cast<const std::byte*>(&reply_header), sizeof(reply_header)));
+        (void)socket.send(buffer_t(reply.data(), reply.size()));
+    }
+    std::byte sink[64];
+    while (socket.receive(buffer_t(sink, sizeof(sink))) > 0) {
+    }
+}
+
+inline auto test_fetcher_multiplexes_origin() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("fetch-multiplex");
+    ObjectCacheConfig cache_config;
+    cache_config.segment_directory = directory.path.string();
+    auto cache = ObjectCache::open(cache_config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+    std::thread origin([&] { run_reordering_origin(acceptor); });
+
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::string connection_id;
+    try {
+        connection_id = manager.create_async_connection(IPAddress::from_string("::1").value(), acceptor.local_port());
+    } catch (const std::exception&) {
+        acceptor.stop_listening();
+        origin.join();
+        return TestResult(false, "Could not connect to loopback origin", std::chrono::milliseconds(0));
+    }
+
+    // Each exchange's response only comes once the other request is out, so
+    // an origin held for a whole round trip would time out both
+    std::optional<std::expected<FetchResult, FetchError>> short_key;
+    std::optional<std::expected<FetchResult, FetchError>> long_key;
+    {
+        FetcherConfig config{connection_id};
+        config.response_timeout = std::chrono::milliseconds(2000);
+        CoalescingFetcher fetcher(**cache, manager, config);
+        std::thread first([&] { short_key = fetcher.fetch("cdn.example", "/a"); });
+        std::thread second([&] { long_key = fetcher.fetch("cdn.example", "/long"); });
+        first.join();
+        second.join();
+    }
+    manager.close_connection(connection_id);
+    origin.join();
+
+    bool answered = short_key && *short_key && long_key && *long_key;
+    if (!answered) {
+        return TestResult(false, "Overlapping origin exchanges should both complete", std::chrono::milliseconds(0));
+    }
+    return assert_true((*short_key)->hash == ContentHash::of(make_cache_object(1000, 2)) &&
+                       (*long_key)->hash == ContentHash::of(make_cache_object(1000, 5)),
+                       "Responses should reach the exchange whose request id they carry");
+}
+
+inline auto test_fetcher_rejects_multiple_ranges() -> TestResult {
+    using namespace network::GalaxyCDN;
+    CacheTestDirectory directory("fetch-ranges");
+    ObjectCacheConfig cache_config;
+    cache_config.segment_directory = directory.path.string();
+    auto cache = ObjectCache::open(cache_config);
+    if (!cache) {
+        return TestResult(false, describe(cache.error()), std::chrono::milliseconds(0));
+    }
+
+    Acceptor origin_acceptor;
+    Acceptor client_acceptor;
+    if (origin_acceptor.listen(0) != error_code::success || client_acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+    auto body = make_cache_object(4096, 9);
+    std::atomic<int> requests{0};
+    std::thread origin([&] { run_test_origin(origin_acceptor, body, requests, std::chrono::milliseconds(0)); });
+
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::string origin_id;
+    std::string client_id;
+    std::optional<Socket> client;
+    try {
+        auto loopback = IPAddress::from_string("::1").value();
+        origin_id = manager.create_async_connection(loopback, origin_acceptor.local_port());
+        client_id = manager.create_async_connection(loopback, client_acceptor.local_port());
+        if (auto accepted = client_acceptor.accept(); accepted.has_value()) {
+            client.emplace(std::move(accepted.value()));
+        }
+    } catch (const std::exception&) {
+    }
+    if (!client) {
+        manager.close_connection(origin_id);
+        origin_acceptor.stop_listening();
+        origin.join();
+        return TestResult(false, "Could not connect loopback origin and client", std::chrono::milliseconds(0));
+    }
+
+    bool sent = false;
+    {
+        CoalescingFetcher fetcher(**cache, manager, FetcherConfig{origin_id});
+        ObjectRequest request;
+        request.host = "cdn.example";
+        request.key = "/ranges.bin";
+        request.ranges = {ByteRange{0, 99}, ByteRange{200, 299}};
+        sent = fetcher.handle(manager, client_id, request, 42);
+    }
+    manager.close_connection(origin_id);
+    origin.join();
+
+    ProtocolHeader header{};
+    std::vector<std::byte> payload;
+    auto read_exact = [&client](std::byte* data, size_t size) {
+        for (size_t offset = 0; offset < size;) {
+            size_t got = client->receive(buffer_t(data + offset, size - offset));
+            if (got == 0) return false;
+            offset += got;
+        }
+        return true;
+    };
+    bool received = sent && read_exact(reinterpret_cast<std::byte*>(&header), sizeof(header));
+    if (received) {
+        payload.resize(header.payload_length);
+        received = read_exact(payload.data(), payload.size());
+    }
+    manager.close_connection(client_id);
+    auto response = received ? view_message<ObjectResponse>(header, payload)
+                             : std::unexpected(reflect::SerialError::truncated);
+    return assert_true(response && header.request_id == 42 && response->get<&ObjectResponse::status>() == 416,
+                       "A request for several ranges should be answered with 416");
+}
+
+inline auto test_maglev_table_weights_and_disruption() -> TestResult {
+    using namespace network::GalaxyCDN;
+    if (MaglevTable::next_prime(65536) != 65537 || MaglevTable::next_prime(100) != 101) {
+        return TestResult(false, "Table sizes must be prime", std::chrono::milliseconds(0));
+    }
+    std::vector<MaglevNode> nodes;
+    for (int i = 0; i < 10; ++i) {
+        nodes.push_back({"edge-" + std::to_string(i), i == 0 ? 3u : 1u});
+    }
+    MaglevTable before(nodes);
+    std::vector<size_t> slots(nodes.size(), 0);
+    for (uint32_t entry : before.entries()) {
+        if (entry == MaglevTable::NO_NODE) {
+            return TestResult(false, "Table left a slot unassigned", std::chrono::milliseconds(0));
+        }
+        ++slots[entry];
+    }
+    // 12 shares in all: three for edge-0, one for each of the rest
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        double share = static_cast<double>(slots[i]) * 12.0 / static_cast<double>(before.size());
+        if (std::abs(share - (i == 0 ? 3.0 : 1.0)) > 0.01) {
+            return TestResult(false, "Slots not proportional to weight for " + nodes[i].name,
+                              std::chrono::milliseconds(0));
+        }
+    }
+
+    // Dropping one node reassigns its slots and barely touches anyone else's
+    nodes.erase(nodes.begin() + 5);
+    MaglevTable after(nodes);
+    size_t moved = 0;
+    for (size_t slot = 0; slot < before.size(); ++slot) {
+        const std::string& owner = before.nodes()[before.entries()[slot]].name;
+        if (owner != "edge-5" && owner != after.nodes()[after.entries()[slot]].name) {
+            ++moved;
+        }
+    }
+    if (moved * 50 > before.size()) {
+        return TestResult(false, "Membership change moved " + std::to_string(moved) + " surviving slots",
+                          std::chrono::milliseconds(0));
+    }
+    const MaglevNode* owner = after.find(maglev_hash("cdn.example", "/logo.svg"));
+    return assert_true(MaglevTable().find(1) == nullptr && owner && owner->name != "edge-5" &&
+                       owner == after.find(maglev_hash("cdn.example", "/logo.svg")),
+                       "Lookups are stable and never reach a removed node");
+}
+
+inline auto test_maglev_edge_router() -> TestResult {
+    using namespace network::GalaxyCDN;
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::vector<EdgeNode> nodes;
+    try {
+        for (const char* name : {"leeds", "york", "hull"}) {
+            nodes.push_back({name, manager.create_async_connection(IPAddress::from_string("::1").value(),
+                                                                   acceptor.local_port())});
+        }
+    } catch (const std::exception&) {
+        return TestResult(false, "Could not connect edge nodes", std::chrono::milliseconds(0));
+    }
+
+    EdgeRouter router(manager);
+    if (router.route("cdn.example", "/a") || !router.wait_for(router.set_nodes(nodes), std::chrono::seconds(5))) {
+        return TestResult(false, "Routing before the first table, or table never built", std::chrono::milliseconds(0));
+    }
+    std::vector<std::string> owners;
+    std::set<std::string> used;
+    for (int i = 0; i < 300; ++i) {
+        auto connection = router.route("cdn.example", "/object/" + std::to_string(i));
+        owners.push_back(router.node_for("cdn.example", "/object/" + std::to_string(i)).value_or(""));
+        used.insert(connection.value_or(""));
+    }
+
+    // Readers keep routing while the node set changes underneath them
+    std::atomic<bool> reading{true};
+    std::atomic<int> unroutable{0};
+    std::thread reader([&] {
+        for (int i = 0; reading; ++i) {
+            if (!router.node_for("cdn.example", "/object/" + std::to_string(i % 300))) {
+                ++unroutable;
+            }
+        }
+    });
+    manager.close_connection(nodes[1].connection_id);
+    bool closed_unrouted = true;
+    for (int i = 0; i < 300; ++i) {
+        if (owners[i] == "york") {
+            closed_unrouted &= !router.route("cdn.example", "/object/" + std::to_string(i)).has_value();
+        }
+    }
+    nodes.erase(nodes.begin() + 1);
+    bool rebuilt = router.wait_for(router.set_nodes(nodes), std::chrono::seconds(5));
+    reading = false;
+    reader.join();
+
+    size_t kept = 0;
+    size_t surviving = 0;
+    for (int i = 0; i < 300; ++i) {
+        auto owner = router.node_for("cdn.example", "/object/" + std::to_string(i));
+        if (owners[i] != "york") {
+            ++surviving;
+            kept += owner == owners[i];
+        } else if (owner == "york") {
+            rebuilt = false;
+        }
+    }
+    manager.shutdown();
+    acceptor.stop_listening();
+
+    if (used.size() != 3 || used.contains("")) {
+        return TestResult(false, "Keys not spread over every connected node", std::chrono::milliseconds(0));
+    }
+    return assert_true(closed_unrouted && rebuilt && kept == surviving && unroutable == 0,
+                       "Closed nodes unrouted, surviving keys stay put across the swap");
+}
+
+inline auto run_galaxycdn_cache_tests() -> bool {
+    TestSuite suite("GalaxyCDN Object Cache Tests");
+
+    suite.add_test("Put, Find and Reopen", test_object_cache_put_find_reopen);
+    suite.add_test("Content Hash Is SHA-256", test_content_hash_is_sha256);
+    suite.add_test("Duplicate Put Persists Metadata", test_object_cache_duplicate_put_persists_metadata);
+    suite.add_test("TinyLFU Admission", test_object_cache_tinylfu_admission);
+    suite.add_test("Segment Eviction", test_object_cache_segment_eviction);
+    suite.add_test("Range Served From Segment", test_object_cache_serves_range);
+    suite.add_test("Coalesced Origin Fetch", test_fetcher_coalesces_concurrent_misses);
+    suite.add_test("Stale While Revalidate", test_fetcher_stale_while_revalidate);
+    suite.add_test("Fetcher Keys Do Not Collide", test_fetcher_keys_do_not_collide);
+    suite.add_test("Fetcher Resets Faulty Origin", test_fetcher_resets_faulty_origin);
+    suite.add_test("Fetcher Multiplexes Origin", test_fetcher_multiplexes_origin);
+    suite.add_test("Fetcher Rejects Multiple Ranges", test_fetcher_rejects_multiple_ranges);
+    suite.add_test("Maglev Weights and Disruption", test_maglev_table_weights_and_disruption);
+    suite.add_test("Maglev Edge Routing", test_maglev_edge_router);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
@@ -0,0 +1,287 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "test_http_server.h"
+#include "../src/network/hot_restart.h"
+#include <filesystem>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace dualstack {
+namespace test {
+
+inline auto hot_restart_socket_path(const std::string& name) -> std::string {
+    return (std::filesystem::temp_directory_path() /
+            ("amphisbaena-" + name + "-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) +
+             ".sock")).string();
+}
+
+inline auto test_hot_restart_without_predecessor() -> TestResult {
+    using namespace network::hot_restart;
+    HotRestartConfig config;
+    config.socket_path = hot_restart_socket_path("orphan");
+    Successor successor(config);
+    auto inherited = successor.inherit();
+#ifdef _WIN32
+    return assert_true(!inherited && inherited.error() == HotRestartError::unsupported, "Windows reports unsupported");
+#else
+    return assert_true(!inherited && inherited.error() == HotRestartError::no_predecessor && !successor.confirm(),
+                       "A first start finds no predecessor");
+#endif
+}
+
+#ifndef _WIN32
+inline auto test_hot_restart_handoff() -> TestResult {
+    using namespace network::hot_restart;
+    HotRestartConfig config;
+    config.socket_path = hot_restart_socket_path("handoff");
+    config.drain_timeout = std::chrono::seconds(5);
+
+    // Old process: answers "A", holding its first connection open to exercise draining
+    network::AsyncDualStackServer old_server(0);
+    std::mutex mutex;
+    std::string held_id;
+    old_server.set_connection_handler([&](std::string id, Socket& socket, const IPAddress&) {
+        http_send(socket, "A");
+        std::lock_guard<std::mutex> lock(mutex);
+        if (held_id.empty()) {
+            held_id = id;
+        } else {
+            old_server.close_connection(id);
+        }
+    });
+    if (!old_server.start()) {
+        return TestResult(false, "Old server failed to start", std::chrono::milliseconds(0));
+    }
+    port_t port = old_server.local_port();
+    auto held = http_connect(port);
+    bool held_answered = held && http_receive_until(*held, [](const std::string& text) { return !text.empty(); }) == "A";
+
+    // An idle pooled connection to an origin travels with the listener
+    Acceptor origin;
+    if (origin.listen(0) != error_code::success) {
+        return TestResult(false, "Origin failed to listen", std::chrono::milliseconds(0));
+    }
+    network::AsyncConnectionManager old_pool;
+    old_pool.initialize();
+    std::string old_origin_id = old_pool.create_async_connection(IPAddress::from_string("::1").value(),
+                                                                 origin.local_port());
+    auto origin_peer = origin.accept();
+
+    Predecessor predecessor(old_server, config);
+    std::string snapshot = "routes=42;warm=true";
+    predecessor.set_snapshot({reinterpret_cast<const std::byte*>(snapshot.data()),
+                              reinterpret_cast<const std::byte*>(snapshot.data()) + snapshot.size()});
+    predecessor.share_pool(&old_pool);
+    std::atomic<int> drained{-1};
+    predecessor.set_drained_handler([&](bool all_closed) { drained = all_closed ? 1 : 0; });
+    if (!predecessor.start()) {
+        old_server.stop();
+        return TestResult(false, "Predecessor failed to listen", std::chrono::milliseconds(0));
+    }
+
+    // New process: inherit, start on the inherited listener, confirm
+    network::AsyncConnectionManager new_pool;
+    new_pool.initialize();
+    Successor successor(config);
+    auto inherited = successor.inherit(&new_pool);
+    if (!inherited) {
+        predecessor.stop();
+        old_server.stop();
+        return TestResult(false, std::string("Inherit failed: ") + describe(inherited.error()),
+                          std::chrono::milliseconds(0));
+    }
+    std::string received_snapshot(reinterpret_cast<const char*>(inherited->snapshot.data()), inherited->snapshot.size());
+    network::AsyncDualStackServer new_server(0);
+    new_server.set_connection_handler([&](std::string id, Socket& socket, const IPAddress&) {
+        http_send(socket, "B");
+        new_server.close_connection(id);
+    });
+    bool started = new_server.start(std::move(inherited->listener)) && new_server.local_port() == port;
+    bool confirmed = successor.confirm();
+
+    // While both processes hold the listener, every client is answered by one of them
+    bool never_refused = true;
+    for (int i = 0; i < 20; ++i) {
+        auto client = http_connect(port);
+        std::string answer = client ? http_receive_until(*client, [](const std::string&) { return false; }) : "";
+        never_refused &= answer == "A" || answer == "B";
+    }
+    for (int i = 0; i < 200 && !predecessor.handed_off(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));      // Past the old accept thread's last wait
+    auto late = http_connect(port);
+    bool successor_serving = late && http_receive_until(*late, [](const std::string&) { return false; }) == "B";
+
+    // The pooled connection now belongs to the new process
+    bool pool_moved = false;
+    auto moved = inherited->pooled.find(old_origin_id);
+    if (moved != inherited->pooled.end() && origin_peer && old_pool.get_all_connection_ids().empty()) {
+        network::ConnectionState* state = new_pool.get_connection(moved->second);
+        pool_moved = state && http_send(*state->socket, "ping") &&
+                     http_receive_until(*origin_peer, [](const std::string& text) { return text.size() >= 4; }) == "ping";
+    }
+
+    // Draining waits for the held connection
+    bool waited = drained == -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        old_server.close_connection(held_id);
+    }
+    for (int i = 0; i < 200 && drained == -1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    new_server.stop();
+    predecessor.stop();
+    origin.stop_listening();
+    old_pool.shutdown();
+    new_pool.shutdown();
+
+    if (!held_answered || !started || !confirmed) {
+        return TestResult(false, "Successor did not start on the inherited listener", std::chrono::milliseconds(0));
+    }
+    if (!never_refused || !successor_serving) {
+        return TestResult(false, "Clients refused or still served by the old process", std::chrono::milliseconds(0));
+    }
+    return assert_true(received_snapshot == snapshot && pool_moved && waited && drained == 1 &&
+                       !std::filesystem::exists(config.socket_path),
+                       "Snapshot and pooled connection inherited, old process drained");
+}
+
+inline auto test_hot_restart_busy_pool() -> TestResult {
+    using namespace network::hot_restart;
+    HotRestartConfig config;
+    config.socket_path = hot_restart_socket_path("busy");
+    config.drain_timeout = std::chrono::seconds(5);
+
+    network::AsyncDualStackServer old_server(0);
+    if (!old_server.start()) {
+        return TestResult(false, "Old server failed to start", std::chrono::milliseconds(0));
+    }
+    Acceptor origin;
+    if (origin.listen(0) != error_code::success) {
+        old_server.stop();
+        return TestResult(false, "Origin failed to listen", std::chrono::milliseconds(0));
+    }
+    network::AsyncConnectionManager old_pool;
+    old_pool.initialize();
+    auto loopback = IPAddress::from_string("::1").value();
+    std::string idle_id = old_pool.create_async_connection(loopback, origin.local_port());
+    auto idle_peer = origin.accept();
+    std::string busy_id = old_pool.create_async_connection(loopback, origin.local_port());
+    auto busy_peer = origin.accept();
+
+    Predecessor predecessor(old_server, config);
+    predecessor.share_pool(&old_pool);
+    std::atomic<int> drained{-1};
+    predecessor.set_drained_handler([&](bool all_closed) { drained = all_closed ? 1 : 0; });
+    if (!predecessor.start()) {
+        old_server.stop();
+        return TestResult(false, "Predecessor failed to listen", std::chrono::milliseconds(0));
+    }
+
+    // One pooled connection is mid-exchange, waiting for the origin's reply
+    std::atomic<bool> replied{false};
+    std::thread exchange([&] {
+        std::vector<std::byte> payload;
+        replied = old_pool.receive_galaxycdn_frame(busy_id, payload, std::chrono::steady_clock::now() +
+                                                   std::chrono::seconds(5), 1024).has_value();
+    });
+    for (int i = 0; i < 200; ++i) {
+        network::ConnectionState* state = old_pool.get_connection(busy_id);
+        if (state && state->in_use != 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    network::AsyncConnectionManager new_pool;
+    new_pool.initialize();
+    Successor successor(config);
+    auto inherited = successor.inherit(&new_pool);
+    bool only_idle = inherited && inherited->pooled.size() == 1 && inherited->pooled.contains(idle_id);
+    bool confirmed = inherited && successor.confirm();
+
+    // Draining waits for the exchange, then closes the busy connection here
+    for (int i = 0; i < 200 && !predecessor.handed_off(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    bool waited = drained == -1 && old_pool.get_connection(busy_id) != nullptr;
+    network::GalaxyCDN::ProtocolHeader reply{};
+    reply.magic = network::GalaxyCDN::PROTOCOL_MAGIC;
+    reply.version = network::GalaxyCDN::PROTOCOL_VERSION;
+    bool sent = busy_peer && http_send(*busy_peer, std::string_view(reinterpret_cast<const char*>(&reply), sizeof(reply)));
+    exchange.join();
+    for (int i = 0; i < 200 && drained == -1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    bool busy_closed = busy_peer && http_receive_until(*busy_peer, [](const std::string&) { return false; }).empty();
+
+    predecessor.stop();
+    old_server.stop();
+    origin.stop_listening();
+    old_pool.shutdown();
+    new_pool.shutdown();
+
+    if (!idle_peer || !only_idle || !confirmed) {
+        return TestResult(false, "Busy pooled connection handed over", std::chrono::milliseconds(0));
+    }
+    return assert_true(waited && sent && replied && drained == 1 && busy_closed,
+                       "Busy pooled connection finished its exchange, then drained");
+}
+
+inline auto test_hot_restart_unexpected_successor() -> TestResult {
+    using namespace network::hot_restart;
+    HotRestartConfig config;
+    config.socket_path = hot_restart_socket_path("stranger");
+    config.successor_pid = static_cast<int32_t>(::getpid()) + 1;      // Some other process
+
+    network::AsyncDualStackServer old_server(0);
+    if (!old_server.start()) {
+        return TestResult(false, "Old server failed to start", std::chrono::milliseconds(0));
+    }
+    Predecessor predecessor(old_server, config);
+    bool listening = predecessor.start();
+    Successor successor(config);
+    auto inherited = successor.inherit();
+    bool still_serving = !predecessor.handed_off() && old_server.listener_handle().has_value();
+    predecessor.stop();
+    old_server.stop();
+
+    return assert_true(listening && !inherited && inherited.error() != HotRestartError::no_predecessor && still_serving,
+                       "A process other than the expected successor gets nothing");
+}
+#endif
+
+inline auto run_hot_restart_tests() -> bool {
+    TestSuite suite("Hot Restart Tests");
+
+    suite.add_test("No Predecessor", test_hot_restart_without_predecessor);
+#ifndef _WIN32
+    suite.add_test("Listener and Pool Handoff", test_hot_restart_handoff);
+    suite.add_test("Busy Pooled Connections Drain", test_hot_restart_busy_pool);
+    suite.add_test("Unexpected Successor Refused", test_hot_restart_unexpected_successor);
+#endif
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
@@ -0,0 +1,292 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../src/network/http_server.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace dualstack {
+namespace test {
+
+inline auto test_http_parse_requests() -> TestResult {
+    using namespace network::http;
+    HttpRequest request;
+
+    // Header values longer than one SIMD block, and two pipelined requests
+    std::string_view pipelined =
+        "POST /upload?name=logo.svg HTTP/1.1\r\n"
+        "Host: cdn.example\r\n"
+        "User-Agent: amphisbaena-test-client/1.0 (dual-stack; yorkshire)\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "hello"
+        "GET / HTTP/1.0\r\n\r\n";
+    auto first = parse_request(pipelined, request);
+    if (!first || request.method != "POST" || request.path != "/upload" || request.query != "name=logo.svg" ||
+        request.header_count != 3 || request.header("user-agent") != "amphisbaena-test-client/1.0 (dual-stack; yorkshire)" ||
+        request.body != "hello" || !request.keep_alive) {
+        return TestResult(false, "First pipelined request parsed incorrectly", std::chrono::milliseconds(0));
+    }
+    auto second = parse_request(pipelined.substr(*first), request);
+    if (!second || *first + *second != pipelined.size() || request.version_minor != 0 || request.keep_alive) {
+        return TestResult(false, "Second pipelined request parsed incorrectly", std::chrono::milliseconds(0));
+    }
+
+    // Incomplete input, including a head whose body is still in flight
+    std::string_view expecting = "PUT /a HTTP/1.1\r\nHost: x\r\nExpect: 100-continue\r\nContent-Length: 10\r\n\r\nabc";
+    for (size_t cut = 0; cut < expecting.size(); ++cut) {
+        auto partial = parse_request(expecting.substr(0, cut), request);
+        if (partial || partial.error() != HttpError::incomplete) {
+            return TestResult(false, "Truncated request should be incomplete", std::chrono::milliseconds(0));
+        }
+    }
+    if (request.head_size == 0 || !request.expect_continue) {
+        return TestResult(false, "Complete head should be reported before its body", std::chrono::milliseconds(0));
+    }
+
+    struct Rejected {
+        std::string_view text;
+        HttpError error;
+    };
+    const Rejected rejected[] = {
+        {"GET /\r\n\r\n", HttpError::bad_request},
+        {"GET / HTTP/1.1\r\n\r\n", HttpError::bad_request},                                     // No Host
+        {"GET / HTTP/1.1\r\nHost: x\r\nHost: y\r\n\r\n", HttpError::bad_request},                 // Two Hosts
+        {"GET / HTTP/1.1\r\nHost: x\r\n folded\r\n\r\n", HttpError::bad_request},
+        {"GET / HTTP/1.1\r\nHost : x\r\n\r\n", HttpError::bad_request},
+        {"GET / HTTP/1.1\r\nHost: x\x01y\r\n\r\n", HttpError::bad_request},
+        {"GET / HTTP/1.1\r\nHost: x\nAccept: */*\r\n\r\n", HttpError::bad_request},
+        {"POST / HTTP/1.1\r\nHost: x\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n", HttpError::bad_request},
+        {"POST / HTTP/1.1\r\nHost: x\r\nContent-Length: -1\r\n\r\n", HttpError::bad_request},
+        {"POST / HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: chunked\r\n\r\n", HttpError::not_implemented},
+        {"GET / HTTP/2.0\r\nHost: x\r\n\r\n", HttpError::version_not_supported},
+    };
+    for (const Rejected& entry : rejected) {
+        auto result = parse_request(entry.text, request);
+        if (result || result.error() != entry.error) {
+            return TestResult(false, "Malformed request accepted: " + std::string(entry.text),
+                              std::chrono::milliseconds(0));
+        }
+    }
+
+    HttpLimits limits;
+    limits.max_header_bytes = 64;
+    limits.max_body_bytes = 4;
+    std::string oversized = "GET / HTTP/1.1\r\nHost: x\r\nCookie: " + std::string(100, 'c') + "\r\n\r\n";
+    auto too_large = parse_request(oversized, request, limits);
+    auto body_too_large = parse_request("POST / HTTP/1.1\r\nHost: x\r\nContent-Length: 5\r\n\r\n", request, limits);
+    if (too_large || too_large.error() != HttpError::header_too_large || body_too_large ||
+        body_too_large.error() != HttpError::body_too_large) {
+        return TestResult(false, "Limits were not enforced", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+// Blocking client helpers
+inline auto http_connect(port_t port) -> std::optional<Socket> {
+    Socket client;
+    if (client.connect(IPAddress::from_string("::1").value(), port) != error_code::success) {
+        return std::nullopt;
+    }
+    return client;
+}
+
+inline auto http_send(Socket& client, std::string_view text) -> bool {
+    return client.send(buffer_t(reinterpret_cast<const std::byte*>(text.data()), text.size())) == text.size();
+}
+
+// Read until `predicate(received)` holds or the peer closes
+template<typename Predicate>
+auto http_receive_until(Socket& client, Predicate predicate) -> std::string {
+    std::string received;
+    char chunk[4096];
+    while (!predicate(received)) {
+        size_t got = client.receive(buffer_t(reinterpret_cast<const std::byte*>(chunk), sizeof(chunk)));
+        if (got == 0) {
+            break;
+        }
+        received.append(chunk, got);
+    }
+    return received;
+}
+
+inline auto count_occurrences(std::string_view text, std::string_view needle) -> size_t {
+    size_t count = 0;
+    for (size_t at = text.find(needle); at != std::string_view::npos; at = text.find(needle, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+inline auto test_http_server_pipelining_and_sendfile() -> TestResult {
+    using namespace network::http;
+    auto file_path = std::filesystem::temp_directory_path() / "amphisbaena-http-test.bin";
+    std::string file_body(100000, '\0');
+    for (size_t i = 0; i < file_body.size(); ++i) {
+        file_body[i] = static_cast<char>('a' + i % 26);
+    }
+    std::ofstream(file_path, std::ios::binary) << file_body;
+
+    network::AsyncDualStackServer server(0);
+    HttpServerConfig config;
+    config.io_threads = 2;
+    HttpServer http(server, config);
+    http.set_handler([&](const HttpRequest& request, HttpResponse& response) {
+        if (request.path == "/hello") {
+            response.add_header("Content-Type", "text/plain");
+            response.set_body("hello " + std::string(request.query));
+        } else if (request.path == "/file") {
+            response.send_file(file_path, 1000, 50000);
+        } else {
+            response.set_status(404);
+        }
+    });
+    if (!http.start()) {
+        std::filesystem::remove(file_path);
+        return TestResult(false, "HTTP server failed to start", std::chrono::milliseconds(0));
+    }
+
+    std::string received;
+    if (auto client = http_connect(server.local_port())) {
+        http_send(*client,
+                  "GET /hello?one HTTP/1.1\r\nHost: x\r\n\r\n"
+                  "GET /file HTTP/1.1\r\nHost: x\r\n\r\n"
+                  "HEAD /hello?two HTTP/1.1\r\nHost: x\r\n\r\n"
+                  "GET /missing HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n");
+        received = http_receive_until(*client, [](const std::string&) { return false; });
+    }
+    auto stats = http.get_stats();
+    http.stop();
+    std::filesystem::remove(file_path);
+
+    size_t hello = received.find("\r\n\r\nhello one");
+    size_t file = received.find(file_body.substr(1000, 50000));
+    size_t head = received.find("Content-Length: 9\r\n", file);
+    size_t missing = received.find("HTTP/1.1 404 Not Found\r\n");
+    if (hello == std::string::npos || file == std::string::npos || head == std::string::npos ||
+        missing == std::string::npos || !(hello < file && file < head && head < missing)) {
+        return TestResult(false, "Pipelined responses missing or out of order", std::chrono::milliseconds(0));
+    }
+    if (count_occurrences(received, "HTTP/1.1 200 OK\r\n") != 3 || received.find("hello two") != std::string::npos ||
+        !received.ends_with("Connection: close\r\n\r\n")) {
+        return TestResult(false, "Response framing incorrect", std::chrono::milliseconds(0));
+    }
+    if (stats.requests != 4 || stats.pipelined == 0) {
+        return TestResult(false, "Pipelined requests not counted", std::chrono::milliseconds(0));
+    }
+#if defined(__linux__)
+    return assert_true(stats.bytes_sendfile == 50000, "File body is sent with sendfile");
+#else
+    return TestResult(true, "", std::chrono::milliseconds(0));
+#endif
+}
+
+inline auto test_http_server_keep_alive_and_errors() -> TestResult {
+    using namespace network::http;
+    network::AsyncDualStackServer server(0);
+    HttpServerConfig config;
+    config.io_threads = 1;
+    HttpServer http(server, config);
+    http.set_handler([](const HttpRequest& request, HttpResponse& response) {
+        response.set_body(request.body);
+    });
+    if (!http.start()) {
+        return TestResult(false, "HTTP server failed to start", std::chrono::milliseconds(0));
+    }
+
+    auto client = http_connect(server.local_port());
+    bool continued = false;
+    bool echoed = false;
+    bool rejected = false;
+    if (client) {
+        // Expect: 100-continue gets an interim response before the body is sent
+        http_send(*client, "POST /echo HTTP/1.1\r\nHost: x\r\nExpect: 100-continue\r\nContent-Length: 4\r\n\r\n");
+        std::string interim = http_receive_until(*client, [](const std::string& text) {
+            return text.ends_with("\r\n\r\n");
+        });
+        continued = interim == "HTTP/1.1 100 Continue\r\n\r\n";
+
+        // Body arriving in pieces on the kept-alive connection
+        http_send(*client, "pi");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        http_send(*client, "ng");
+        std::string reply = http_receive_until(*client, [](const std::string& text) { return text.ends_with("ping"); });
+        echoed = reply.starts_with("HTTP/1.1 200 OK\r\n") && reply.find("Connection: keep-alive\r\n") != std::string::npos;
+
+        // A malformed request is answered and the connection closed
+        http_send(*client, "GET / HTTP/1.1\r\nBroken header\r\n\r\n");
+        std::string error = http_receive_until(*client, [](const std::string&) { return false; });
+        rejected = error.starts_with("HTTP/1.1 400 Bad Request\r\n") && error.ends_with("Connection: close\r\n\r\n");
+    }
+    auto stats = http.get_stats();
+    http.stop();
+
+    if (!client || !continued || !echoed || !rejected) {
+        return TestResult(false, "Keep-alive exchange failed", std::chrono::milliseconds(0));
+    }
+    return assert_true(stats.parse_errors == 1 && stats.requests == 1, "Statistics count requests and parse errors");
+}
+
+inline auto test_http_server_write_timeout() -> TestResult {
+    using namespace network::http;
+    network::AsyncDualStackServer server(0);
+    HttpServerConfig config;
+    config.io_threads = 1;
+    config.write_timeout = std::chrono::seconds(1);
+    HttpServer http(server, config);
+    std::string body(32 * 1024 * 1024, 'x');
+    http.set_handler([&body](const HttpRequest&, HttpResponse& response) {
+        response.set_body(body);
+    });
+    if (!http.start()) {
+        return TestResult(false, "HTTP server failed to start", std::chrono::milliseconds(0));
+    }
+
+    // The client asks for far more than the socket buffers hold, then stops reading
+    auto client = http_connect(server.local_port());
+    bool sent = client && http_send(*client, "GET /large HTTP/1.1\r\nHost: x\r\n\r\n");
+    bool opened = false;
+    bool closed = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (sent && std::chrono::steady_clock::now() < deadline) {
+        size_t open = http.get_stats().open_connections;
+        opened |= open == 1;
+        if (opened && open == 0) {
+            closed = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    http.stop();
+
+    if (!sent || !opened) {
+        return TestResult(false, "Request was not delivered", std::chrono::milliseconds(0));
+    }
+    return assert_true(closed, "A stalled reader should be disconnected after the write timeout");
+}
+
+inline auto run_http_server_tests() -> bool {
+    TestSuite suite("HTTP Server Tests");
+
+    suite.add_test("Request Parsing", test_http_parse_requests);
+    suite.add_test("Pipelining and sendfile", test_http_server_pipelining_and_sendfile);
+    suite.add_test("Keep-Alive and Errors", test_http_server_keep_alive_and_errors);
+    suite.add_test("Write Timeout", test_http_server_write_timeout);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
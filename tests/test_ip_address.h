@@ -84,6 +84,15 @@ inline auto test_ipv6_parsing() -> TestResult {
         }
     }
     
+    // Test canonical text form of compressed addresses
+    for (const char* text : {"2001:db8::1", "2001:db8::", "fe80::", "::1", "2001:4860:4860::8888"}) {
+        auto parsed = IPAddress::from_string(text);
+        if (!parsed.has_value() || parsed.value().to_string() != text) {
+            return TestResult(false, std::string("IPv6 text form not preserved for ") + text,
+                             std::chrono::milliseconds(0));
+        }
+    }
+
     return TestResult(true, "", std::chrono::milliseconds(0));
 }
 
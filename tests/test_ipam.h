@@ -0,0 +1,270 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../include/dualstack_net26/network/virtual_adapter.h"
+#include <set>
+#include <vector>
+
+namespace dualstack {
+namespace test {
+
+inline auto ipam_v4(const char* text) -> ipv4_address {
+    return IPAddress::from_string(text).value().get_ipv4();
+}
+
+inline auto ipam_v6(const char* text) -> ipv6_address {
+    return IPAddress::from_string(text).value().get_ipv6();
+}
+
+inline auto test_ipam_allocate_and_reserve() -> TestResult {
+    using namespace network;
+    IpamConfig config;
+    config.base = ipam_v4("192.168.7.0");
+    auto pool = IpamPool::create(config);
+    if (!pool.has_value()) {
+        return TestResult(false, "Pool not created: " + pool.error(), std::chrono::milliseconds(0));
+    }
+    auto& ipam = *pool.value();
+    // Network, broadcast and gateway are held back
+    if (!(ipam.capacity() == 256 && ipam.available() == 253)) {
+        return TestResult(false, "Wrong usable address count", std::chrono::milliseconds(0));
+    }
+    if (!(ipam.gateway() == ipam_v4("192.168.7.1") && ipam.subnet_mask() == ipam_v4("255.255.255.0"))) {
+        return TestResult(false, "Wrong gateway or mask", std::chrono::milliseconds(0));
+    }
+
+    auto reserved = ipam.reserve(ipam_v4("192.168.7.2"));
+    if (!reserved.has_value() || ipam.reserve(ipam_v4("192.168.7.2")).has_value() ||
+        ipam.reserve(ipam_v4("192.168.8.2")).has_value()) {
+        return TestResult(false, "Reservation not exclusive", std::chrono::milliseconds(0));
+    }
+    auto first = ipam.allocate();
+    if (!first.has_value() || first->ipv4 != ipam_v4("192.168.7.3") || first->ipv6.has_value()) {
+        return TestResult(false, "Reserved address handed out", std::chrono::milliseconds(0));
+    }
+
+    std::set<uint32_t> seen{first->ipv4.address};
+    std::vector<IpamLease> batch;
+    size_t got = ipam.allocate_batch(1000, false, std::chrono::seconds(0), batch);
+    for (const auto& lease : batch) {
+        seen.insert(lease.ipv4.address);
+    }
+    if (!(got == 251 && seen.size() == 252 && ipam.available() == 0)) {
+        return TestResult(false, "Pool not exhausted exactly", std::chrono::milliseconds(0));
+    }
+    if (ipam.allocate().has_value() || ipam.get_stats().exhausted != 2) {
+        return TestResult(false, "Allocation from an empty pool", std::chrono::milliseconds(0));
+    }
+
+    // A freed address is the next one handed out
+    if (!ipam.release(ipam_v4("192.168.7.100")) || ipam.release(ipam_v4("192.168.7.100")) ||
+        ipam.release(ipam_v4("192.168.7.255"))) {
+        return TestResult(false, "Release not idempotent", std::chrono::milliseconds(0));
+    }
+    auto reused = ipam.allocate();
+    if (!reused.has_value() || reused->ipv4 != ipam_v4("192.168.7.100")) {
+        return TestResult(false, "Freed address not reused", std::chrono::milliseconds(0));
+    }
+
+    // The gateway cannot be freed into the pool, but can be claimed once and handed back
+    auto gateway = ipam_v4("192.168.7.1");
+    if (ipam.release(gateway) || ipam.release(ipam_v4("192.168.7.0")) || ipam.available() != 0) {
+        return TestResult(false, "Fixed address released", std::chrono::milliseconds(0));
+    }
+    if (!ipam.reserve(gateway).has_value() || ipam.reserve(gateway).has_value()) {
+        return TestResult(false, "Gateway claim not exclusive", std::chrono::milliseconds(0));
+    }
+    if (!ipam.release(gateway) || ipam.release(gateway) || !ipam.is_allocated(gateway) || ipam.available() != 0) {
+        return TestResult(false, "Released gateway entered the free set", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "Allocation, exhaustion and reservation behave", std::chrono::milliseconds(0));
+}
+
+inline auto test_ipam_lease_expiry() -> TestResult {
+    using namespace network;
+    IpamConfig config;
+    config.base = ipam_v4("10.20.0.0");
+    config.wheel_slots = 64;                // 1000s leases wrap the wheel many times
+    auto ipam = std::move(IpamPool::create(config).value());
+    auto start = std::chrono::steady_clock::now();
+
+    auto short_lease = ipam->allocate(std::chrono::seconds(2));
+    auto long_lease = ipam->allocate(std::chrono::seconds(1000));
+    auto renewed = ipam->allocate(std::chrono::seconds(2));
+    auto released = ipam->allocate(std::chrono::seconds(2));
+    auto held = ipam->allocate();
+    if (!short_lease || !long_lease || !renewed || !released || !held) {
+        return TestResult(false, "Leases not allocated", std::chrono::milliseconds(0));
+    }
+    if (!ipam->renew(renewed->ipv4, std::chrono::seconds(30)) || ipam->renew(ipam_v4("10.20.0.200"), std::chrono::seconds(30))) {
+        return TestResult(false, "Renew accepted the wrong address", std::chrono::milliseconds(0));
+    }
+    ipam->release(released->ipv4);
+
+    std::vector<IpamLease> expired;
+    ipam->expire_leases(start + std::chrono::seconds(5), &expired);
+    if (expired.size() != 1 || expired[0].ipv4 != short_lease->ipv4 || ipam->is_allocated(short_lease->ipv4)) {
+        return TestResult(false, "Short lease not expired alone", std::chrono::milliseconds(0));
+    }
+    expired.clear();
+    ipam->expire_leases(start + std::chrono::seconds(40), &expired);
+    if (expired.size() != 1 || expired[0].ipv4 != renewed->ipv4) {
+        return TestResult(false, "Renewed lease expired on the old deadline", std::chrono::milliseconds(0));
+    }
+    expired.clear();
+    ipam->expire_leases(start + std::chrono::seconds(990), &expired);
+    if (!expired.empty() || !ipam->is_allocated(long_lease->ipv4)) {
+        return TestResult(false, "Long lease expired a revolution early", std::chrono::milliseconds(0));
+    }
+    ipam->expire_leases(start + std::chrono::seconds(1002), &expired);
+    if (expired.size() != 1 || expired[0].ipv4 != long_lease->ipv4 || !ipam->is_allocated(held->ipv4)) {
+        return TestResult(false, "Long lease not expired", std::chrono::milliseconds(0));
+    }
+    if (!(ipam->get_stats().expirations == 3 && ipam->available() == 252)) {
+        return TestResult(false, "Expiry statistics mismatch", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "Leases expire on the wheel", std::chrono::milliseconds(0));
+}
+
+inline auto test_ipam_vpc_burst() -> TestResult {
+    using namespace network;
+    VirtualAdapterManager manager;
+    if (!manager.create_vpc("vpc-burst", ipam_v4("10.64.0.0"), 16, ipam_v6("fd00:10::"), 64).has_value() ||
+        manager.create_vpc("vpc-burst", ipam_v4("10.65.0.0"), 16).has_value()) {
+        return TestResult(false, "VPC validation failed", std::chrono::milliseconds(0));
+    }
+    // Too wide for a pool: still a VPC, with membership only
+    if (!manager.create_vpc("vpc-wide", ipam_v4("10.0.0.0"), 8).has_value() ||
+        manager.get_vpc_ipam("vpc-wide") != nullptr) {
+        return TestResult(false, "Wide VPC should be created without a pool", std::chrono::milliseconds(0));
+    }
+
+    constexpr size_t adapters = 2000;
+    std::vector<std::string> ids;
+    ids.reserve(adapters);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < adapters; ++i) {
+        VirtualAdapterConfig config{};
+        config.name = "burst" + std::to_string(i);
+        config.type = AdapterType::VIRTUAL;
+        config.vpc_id = "vpc-burst";
+        auto id = manager.create_virtual_adapter(config);
+        if (!id.has_value() || !manager.add_adapter_to_vpc(id.value(), "vpc-burst")) {
+            return TestResult(false, "Adapter not created in the VPC", std::chrono::milliseconds(0));
+        }
+        ids.push_back(id.value());
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "VPC burst: " << adapters << " dual-stack adapters in " << elapsed * 1e3 << " ms" << std::endl;
+
+    std::set<uint32_t> addresses;
+    for (const auto& id : ids) {
+        const auto& config = manager.get_virtual_adapter(id)->get_config();
+        if (!config.ipv4_addr || !config.ipv6_addr || config.ipv4_gateway != ipam_v4("10.64.0.1") ||
+            config.ipv6_prefix_length != 64) {
+            return TestResult(false, "Adapter missing pooled configuration", std::chrono::milliseconds(0));
+        }
+        if (config.ipv6_addr->high != ipam_v6("fd00:10::").high || config.ipv6_addr->low != config.ipv4_addr->address ||
+            manager.get_virtual_adapter(id)->get_ipv6_for_ipv4(*config.ipv4_addr) != config.ipv6_addr) {
+            return TestResult(false, "IPv6 address not paired with IPv4", std::chrono::milliseconds(0));
+        }
+        addresses.insert(config.ipv4_addr->address);
+    }
+    IpamPool* ipam = manager.get_vpc_ipam("vpc-burst");
+    if (addresses.size() != adapters || ipam == nullptr || manager.get_vpc_adapters("vpc-burst").size() != adapters) {
+        return TestResult(false, "Addresses not unique", std::chrono::milliseconds(0));
+    }
+
+    // Hand-assigned addresses inside the VPC are claimed from the pool
+    VirtualAdapterConfig fixed{};
+    fixed.name = "fixed";
+    fixed.type = AdapterType::VIRTUAL;
+    fixed.vpc_id = "vpc-burst";
+    fixed.ipv4_addr = manager.get_virtual_adapter(ids[0])->get_config().ipv4_addr;
+    if (manager.create_virtual_adapter(fixed).has_value()) {
+        return TestResult(false, "Duplicate address accepted", std::chrono::milliseconds(0));
+    }
+
+    // The adapter that is the gateway may take its address, once
+    VirtualAdapterConfig router = fixed;
+    router.name = "router";
+    router.ipv4_addr = ipam_v4("10.64.0.1");
+    auto router_id = manager.create_virtual_adapter(router);
+    if (!router_id.has_value() || manager.create_virtual_adapter(router).has_value()) {
+        return TestResult(false, "Gateway address not claimable exactly once", std::chrono::milliseconds(0));
+    }
+    manager.delete_virtual_adapter(router_id.value());
+    if (!ipam->is_allocated(ipam_v4("10.64.0.1"))) {
+        return TestResult(false, "Gateway returned to the free set", std::chrono::milliseconds(0));
+    }
+
+    size_t before = ipam->available();
+    for (size_t i = 0; i < adapters; i += 2) {
+        manager.delete_virtual_adapter(ids[i]);
+    }
+    if (!(ipam->available() == before + adapters / 2 &&
+          manager.get_vpc_adapters("vpc-burst").size() == adapters / 2)) {
+        return TestResult(false, "Deleted adapters kept addresses", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "VPC adapters allocated from the pool", std::chrono::milliseconds(0));
+}
+
+inline auto test_ipam_allocation_rate() -> TestResult {
+    using namespace network;
+    IpamConfig config;
+    config.base = ipam_v4("172.16.0.0");
+    config.prefix_length = 16;
+    config.ipv6_prefix = ipam_v6("2001:db8:16::");
+    auto ipam = std::move(IpamPool::create(config).value());
+
+    std::vector<IpamLease> leases;
+    leases.reserve(ipam->capacity());
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        auto lease = ipam->allocate_dual_stack();
+        if (!lease.has_value()) {
+            break;
+        }
+        leases.push_back(*lease);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "IPAM /16: " << leases.size() << " allocations, " << elapsed * 1e9 / leases.size() << " ns each" << std::endl;
+
+    if (!(leases.size() == 65533 && leases.back().ipv4 == ipam_v4("172.16.255.254"))) {
+        return TestResult(false, "Full /16 not allocated", std::chrono::milliseconds(0));
+    }
+    // Freeing from the middle of a full pool: the next allocation finds the hole
+    for (size_t i = 30000; i < 30000 + 4096; i += 64) {
+        ipam->release(leases[i].ipv4);
+    }
+    auto hole = ipam->allocate_dual_stack();
+    if (!hole.has_value() || hole->ipv4 != leases[30000].ipv4 || hole->ipv6 != ipam->ipv6_for(hole->ipv4)) {
+        return TestResult(false, "Freed address not found", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, "Full /16 allocated", std::chrono::milliseconds(0));
+}
+
+inline auto run_ipam_tests() -> bool {
+    TestSuite suite("IPAM Tests");
+
+    suite.add_test("Allocate, Exhaust and Reserve", test_ipam_allocate_and_reserve);
+    suite.add_test("Lease Expiry", test_ipam_lease_expiry);
+    suite.add_test("VPC Adapter Burst", test_ipam_vpc_burst);
+    suite.add_test("Allocation Rate", test_ipam_allocation_rate);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
@@ -13,6 +13,19 @@
 #include "test_ip_address.h"
 #include "test_socket.h"
 #include "test_performance.h"
+#include "test_notifications.h"
+#include "test_signature_visualizer.h"
+#include "test_reflection.h"
+#include "test_galaxycdn_cache.h"
+#include "test_http_server.h"
+#include "test_websocket.h"
+#include "test_tcp_proxy.h"
+#include "test_hot_restart.h"
+#include "test_shm_transport.h"
+#include "test_multicast.h"
+#include "test_siit.h"
+#include "test_ipam.h"
+#include "test_netlink.h"
 
 using namespace dualstack::test;
 
@@ -31,6 +44,45 @@ auto main() -> int {
     // Run Performance tests
     all_passed &= run_performance_tests();
     
+    // Run Notification tests
+    all_passed &= run_notification_tests();
+    
+    // Run Signature Visualizer tests
+    all_passed &= run_signature_visualizer_tests();
+    
+    // Run Reflection Serializer tests
+    all_passed &= run_reflection_tests();
+    
+    // Run GalaxyCDN Object Cache tests
+    all_passed &= run_galaxycdn_cache_tests();
+    
+    // Run HTTP Server tests
+    all_passed &= run_http_server_tests();
+    
+    // Run WebSocket tests
+    all_passed &= run_websocket_tests();
+    
+    // Run TCP Proxy tests
+    all_passed &= run_tcp_proxy_tests();
+    
+    // Run Hot Restart tests
+    all_passed &= run_hot_restart_tests();
+    
+    // Run Shared-Memory Transport tests
+    all_passed &= run_shm_transport_tests();
+    
+    // Run Multicast tests
+    all_passed &= run_multicast_tests();
+    
+    // Run SIIT Translation tests
+    all_passed &= run_siit_tests();
+    
+    // Run IPAM tests
+    all_passed &= run_ipam_tests();
+    
+    // Run Netlink tests
+    all_passed &= run_netlink_tests();
+    
     std::cout << std::endl;
     if (all_passed) {
         std::cout << "🎉 All test suites passed!" << std::endl;
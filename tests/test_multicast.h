@@ -0,0 +1,290 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../src/network/multicast.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dualstack {
+namespace test {
+
+#if defined(__linux__)
+// Loopback is enough: IPv4 group traffic on "lo" never leaves the host
+inline auto multicast_test_port() -> port_t {
+    return static_cast<port_t>(40000 + std::chrono::steady_clock::now().time_since_epoch().count() % 20000);
+}
+
+inline auto multicast_sender(const std::string& source) -> std::optional<network::multicast::MulticastSocket> {
+    network::multicast::MulticastSocket sender;
+    if (sender.open(IPAddress::from_string(source).value(), 0) != error_code::success ||
+        sender.set_send_interface(network::multicast::interface_index("lo")) != error_code::success ||
+        sender.set_loopback(true) != error_code::success) {
+        return std::nullopt;
+    }
+    return sender;
+}
+
+inline auto multicast_receive_text(network::multicast::MulticastSocket& socket) -> std::string {
+    std::vector<std::byte> buffer(256);
+    IPAddress from;
+    port_t from_port = 0;
+    size_t received = socket.receive_from(buffer, from, from_port, std::chrono::milliseconds(300));
+    return std::string(reinterpret_cast<const char*>(buffer.data()), received);
+}
+
+inline auto multicast_send_text(network::multicast::MulticastSocket& socket, const std::string& text,
+                                const IPAddress& group, port_t port) -> bool {
+    return socket.send_to(std::span<const std::byte>(reinterpret_cast<const std::byte*>(text.data()), text.size()),
+                          group, port) == text.size();
+}
+
+inline auto test_multicast_join_leave() -> TestResult {
+    using namespace network::multicast;
+    port_t port = multicast_test_port();
+    MulticastGroup group{IPAddress::from_string("239.255.42.1").value(), std::nullopt, interface_index("lo")};
+
+    // Two members on one port, as two daemons on one host would be
+    MulticastSocket first;
+    MulticastSocket second;
+    if (first.open(IPAddress(ipv4_address()), port) != error_code::success ||
+        second.open(IPAddress(ipv4_address()), port) != error_code::success ||
+        first.join(group) != error_code::success || second.join(group) != error_code::success) {
+        return TestResult(false, "Failed to join group", std::chrono::milliseconds(0));
+    }
+    auto sender = multicast_sender("127.0.0.1");
+    if (!sender) {
+        return TestResult(false, "Failed to open sender", std::chrono::milliseconds(0));
+    }
+
+    bool both = multicast_send_text(*sender, "config-1", group.group, port) &&
+                multicast_receive_text(first) == "config-1" && multicast_receive_text(second) == "config-1";
+
+    bool left = second.leave(group) == error_code::success && second.groups().empty();
+    bool only_first = multicast_send_text(*sender, "config-2", group.group, port) &&
+                      multicast_receive_text(first) == "config-2" && multicast_receive_text(second).empty();
+
+    MulticastGroup unicast{IPAddress::from_string("127.0.0.1").value(), std::nullopt, 0};
+    MulticastGroup wrong_family{IPAddress::from_string("ff15::42").value(), std::nullopt, 0};
+    bool refused = first.join(unicast) == error_code::invalid_address &&
+                   first.join(wrong_family) == error_code::invalid_address;
+
+    if (!both || !left) {
+        return TestResult(false, "A member missed a group send", std::chrono::milliseconds(0));
+    }
+    return assert_true(only_first && refused, "Leaving stops delivery; non-group joins refused");
+}
+
+inline auto test_multicast_source_specific() -> TestResult {
+    using namespace network::multicast;
+    port_t port = multicast_test_port();
+    MulticastGroup group{IPAddress::from_string("232.1.42.1").value(), IPAddress::from_string("127.0.0.1").value(),
+                         interface_index("lo")};
+    if (!is_source_specific(group.group) || is_source_specific(IPAddress::from_string("239.1.1.1").value())) {
+        return TestResult(false, "SSM range misclassified", std::chrono::milliseconds(0));
+    }
+
+    MulticastSocket receiver;
+    if (receiver.open(IPAddress(ipv4_address()), port) != error_code::success ||
+        receiver.join(group) != error_code::success) {
+        return TestResult(false, "Failed to join source-specific group", std::chrono::milliseconds(0));
+    }
+    auto trusted = multicast_sender("127.0.0.1");
+    auto other = multicast_sender("127.0.0.2");
+    if (!trusted || !other) {
+        return TestResult(false, "Failed to open senders", std::chrono::milliseconds(0));
+    }
+
+    bool sent = multicast_send_text(*other, "forged", group.group, port) &&
+                multicast_send_text(*trusted, "genuine", group.group, port);
+    std::string first = multicast_receive_text(receiver);
+    std::string next = multicast_receive_text(receiver);
+    return assert_true(sent && first == "genuine" && next.empty(), "Only the joined source is heard");
+}
+
+inline auto test_reliable_multicast_repairs_loss() -> TestResult {
+    using namespace network::multicast;
+    ReliableMulticastConfig config;
+    config.group = MulticastGroup{IPAddress::from_string("239.255.42.2").value(), std::nullopt, interface_index("lo")};
+    config.port = multicast_test_port();
+    config.send_interface = config.group.interface_index;
+    config.heartbeat_interval = std::chrono::milliseconds(20);
+
+    constexpr int receiver_count = 3;
+    constexpr uint64_t messages = 300;
+    std::mutex mutex;
+    std::vector<std::vector<uint64_t>> delivered(receiver_count);
+    std::atomic<uint64_t> reported_lost{0};
+    std::vector<std::unique_ptr<ReliableMulticastReceiver>> receivers;
+    for (int i = 0; i < receiver_count; ++i) {
+        ReliableMulticastConfig receiver_config = config;
+        receiver_config.simulated_loss = 0.2;
+        auto receiver = std::make_unique<ReliableMulticastReceiver>(receiver_config);
+        receiver->set_message_handler([&, i](uint64_t, uint64_t sequence, std::span<const std::byte> payload) {
+            uint64_t value = 0;
+            if (payload.size() == sizeof(value)) {
+                std::memcpy(&value, payload.data(), sizeof(value));
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            delivered[i].push_back(value == sequence ? sequence : ~0ULL);
+        });
+        receiver->set_loss_handler([&](uint64_t, uint64_t, uint64_t count) { reported_lost += count; });
+        if (!receiver->start()) {
+            return TestResult(false, "Receiver failed to join", std::chrono::milliseconds(0));
+        }
+        receivers.push_back(std::move(receiver));
+    }
+
+    ReliableMulticastSender sender(config);
+    if (!sender.start()) {
+        return TestResult(false, "Sender failed to start", std::chrono::milliseconds(0));
+    }
+    bool all_sent = true;
+    for (uint64_t i = 0; i < messages; ++i) {
+        std::span<const std::byte> payload(reinterpret_cast<const std::byte*>(&i), sizeof(i));
+        all_sent &= sender.send(payload) == i;
+        if (i % 50 == 49) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    // Tail losses surface through heartbeats
+    auto complete = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& list : delivered) {
+            if (list.size() < messages) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (int i = 0; i < 300 && !complete(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    auto sender_stats = sender.get_stats();
+    uint64_t dropped = 0;
+    bool recovered_bounded = true;
+    for (auto& receiver : receivers) {
+        auto stats = receiver->get_stats();
+        dropped += stats.dropped_simulated;
+        // Every gap needed a repair; a dropped repair leaves its gap open for the next one
+        recovered_bounded &= stats.recovered > 0 && stats.recovered <= stats.dropped_simulated;
+        receiver->stop();
+    }
+    sender.stop();
+
+    bool in_order = true;
+    for (const auto& list : delivered) {
+        in_order &= list.size() == messages;
+        for (uint64_t i = 0; i < list.size() && in_order; ++i) {
+            in_order &= list[i] == i;
+        }
+    }
+    if (!all_sent || !in_order) {
+        return TestResult(false, "A receiver missed or reordered messages", std::chrono::milliseconds(0));
+    }
+    return assert_true(dropped > 0 && recovered_bounded && sender_stats.retransmissions > 0 && reported_lost == 0 &&
+                       sender_stats.packets_sent == messages,
+                       "Every receiver got every message in order despite loss");
+}
+
+// A DATA packet in the reliable multicast wire format, carrying its sequence as the payload
+inline auto reliable_multicast_data(uint64_t session, uint64_t sequence, bool repair) -> std::vector<std::byte> {
+    std::vector<std::byte> packet(32 + sizeof(sequence));
+    auto put = [&](size_t offset, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            packet[offset + i] = static_cast<std::byte>(value >> ((bytes - 1 - i) * 8));
+        }
+    };
+    put(0, 0x524D4331, 4);                      // "RMC1"
+    packet[4] = std::byte{1};                   // DATA
+    packet[5] = repair ? std::byte{1} : std::byte{0};
+    put(8, session, 8);
+    put(16, sequence, 8);
+    std::memcpy(packet.data() + 32, &sequence, sizeof(sequence));
+    return packet;
+}
+
+inline auto test_reliable_multicast_recovered_count() -> TestResult {
+    using namespace network::multicast;
+    ReliableMulticastConfig config;
+    config.group = MulticastGroup{IPAddress::from_string("239.255.42.3").value(), std::nullopt, interface_index("lo")};
+    config.port = multicast_test_port();
+    ReliableMulticastReceiver receiver(config);
+    std::atomic<uint64_t> delivered{0};
+    receiver.set_message_handler([&](uint64_t, uint64_t, std::span<const std::byte>) { ++delivered; });
+    auto sender = multicast_sender("127.0.0.1");
+    if (!sender || !receiver.start()) {
+        return TestResult(false, "Receiver or sender failed to start", std::chrono::milliseconds(0));
+    }
+    auto send = [&](uint64_t sequence, bool repair) {
+        auto packet = reliable_multicast_data(7, sequence, repair);
+        sender->send_to(packet, config.group.group, config.port);
+    };
+    auto wait_for = [&](uint64_t count) {
+        for (int i = 0; i < 200 && delivered < count; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return delivered == count;
+    };
+
+    // A lossless stream fills no gaps
+    for (uint64_t sequence = 0; sequence < 20; ++sequence) {
+        send(sequence, false);
+    }
+    bool lossless = wait_for(20);
+    auto clean = receiver.get_stats();
+
+    // Three packets lost, then repaired
+    for (uint64_t sequence : {21, 23, 24, 26, 27}) {
+        send(sequence, false);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (uint64_t sequence : {20, 22, 25}) {
+        send(sequence, true);
+    }
+    bool repaired = wait_for(28);
+    auto stats = receiver.get_stats();
+    receiver.stop();
+
+    if (!lossless || clean.recovered != 0) {
+        return TestResult(false, "In-order packets counted as recovered", std::chrono::milliseconds(0));
+    }
+    return assert_true(repaired && stats.recovered == 3 && stats.lost == 0 && stats.duplicates == 0,
+                       "Only repaired gaps count as recovered");
+}
+#endif
+
+inline auto run_multicast_tests() -> bool {
+    TestSuite suite("Multicast Tests");
+
+#if defined(__linux__)
+    suite.add_test("Group Join and Leave", test_multicast_join_leave);
+    suite.add_test("Source-Specific Join", test_multicast_source_specific);
+    suite.add_test("Reliable Delivery Under Loss", test_reliable_multicast_repairs_loss);
+    suite.add_test("Recovered Counts Only Repairs", test_reliable_multicast_recovered_count);
+#endif
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
@@ -0,0 +1,208 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../include/dualstack_net26/network/netlink.h"
+#include "../src/network/event_poller.h"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <net/if.h>
+#include <sched.h>
+#endif
+
+namespace dualstack {
+namespace test {
+
+inline auto netlink_v4(const char* text) -> ipv4_address {
+    return IPAddress::from_string(text).value().get_ipv4();
+}
+
+inline auto test_netlink_state_apply() -> TestResult {
+    using namespace network;
+    HostNetworkState state;
+
+    NetlinkEvent event{};
+    event.type = NetlinkEventType::LINK_CHANGED;
+    event.link.index = 7;
+    event.link.name = "uplink0";
+    event.link.mac_address = "02:00:00:00:00:07";
+    state.apply(event);
+
+    event = NetlinkEvent{};
+    event.type = NetlinkEventType::ADDRESS_ADDED;
+    event.address.interface_index = 7;
+    event.address.address = IPAddress(netlink_v4("198.51.100.20"));
+    event.address.prefix_length = 24;
+    state.apply(event);
+    state.apply(event);                 // Seen in the dump and again as an event
+
+    event = NetlinkEvent{};
+    event.type = NetlinkEventType::ROUTE_ADDED;
+    event.route.destination = IPAddress(ipv4_address(0));
+    event.route.gateway = IPAddress(netlink_v4("198.51.100.1"));
+    event.route.interface_index = 7;
+    event.route.table = 254;
+    event.route.priority = 100;
+    state.apply(event);
+    event.route.gateway = IPAddress(netlink_v4("198.51.100.254"));
+    event.route.priority = 50;          // Preferred: lower metric
+    state.apply(event);
+
+    auto interfaces = state.to_network_interfaces();
+    if (interfaces.size() != 1 || interfaces[0].name != "uplink0" || interfaces[0].ipv4_addresses.size() != 1 ||
+        interfaces[0].ipv4_gateway != netlink_v4("198.51.100.254") || state.find_link("uplink0") == nullptr) {
+        return TestResult(false, "Applied changes not reflected", std::chrono::milliseconds(0));
+    }
+
+    event.type = NetlinkEventType::ROUTE_REMOVED;
+    state.apply(event);
+    if (state.routes.size() != 1 || state.to_network_interfaces()[0].ipv4_gateway != netlink_v4("198.51.100.1")) {
+        return TestResult(false, "Route removal not applied", std::chrono::milliseconds(0));
+    }
+
+    event = NetlinkEvent{};
+    event.type = NetlinkEventType::LINK_REMOVED;
+    event.link.index = 7;
+    state.apply(event);
+    return assert_true(state.links.empty() && state.addresses.empty() && state.routes.empty(),
+                       "Removing a link drops its addresses and routes");
+}
+
+inline auto test_netlink_dump() -> TestResult {
+#ifdef __linux__
+    using namespace network;
+    auto state = netlink_dump();
+    if (!state.has_value()) {
+        return TestResult(false, "Dump failed: " + state.error(), std::chrono::milliseconds(0));
+    }
+    const LinkInfo* loopback = state->find_link("lo");
+    if (loopback == nullptr || !(loopback->flags & IFF_LOOPBACK) ||
+        static_cast<unsigned>(loopback->index) != if_nametoindex("lo")) {
+        return TestResult(false, "Loopback link missing", std::chrono::milliseconds(0));
+    }
+    bool has_loopback_address = std::any_of(state->addresses.begin(), state->addresses.end(), [&](const AddressInfo& a) {
+        return a.interface_index == loopback->index && a.address == IPAddress(netlink_v4("127.0.0.1")) && a.prefix_length == 8;
+    });
+    if (!has_loopback_address) {
+        return TestResult(false, "Loopback address missing", std::chrono::milliseconds(0));
+    }
+
+    // Every kernel interface is present, and enumeration agrees with the dump
+    struct if_nameindex* names = if_nameindex();
+    size_t kernel_links = 0;
+    for (auto* entry = names; entry && entry->if_index != 0; ++entry) {
+        ++kernel_links;
+    }
+    if_freenameindex(names);
+    auto adapters = VirtualAdapterManager{}.enumerate_real_adapters();
+    auto lo = std::find_if(adapters.begin(), adapters.end(), [](const NetworkInterface& i) { return i.name == "lo"; });
+    if (state->links.size() != kernel_links || adapters.size() != kernel_links || lo == adapters.end() ||
+        std::find(lo->ipv4_addresses.begin(), lo->ipv4_addresses.end(), netlink_v4("127.0.0.1")) == lo->ipv4_addresses.end() ||
+        lo->is_physical) {
+        return TestResult(false, "Enumeration disagrees with the dump", std::chrono::milliseconds(0));
+    }
+    return TestResult(true, std::to_string(kernel_links) + " links, " + std::to_string(state->addresses.size()) +
+                      " addresses, " + std::to_string(state->routes.size()) + " routes", std::chrono::milliseconds(0));
+#else
+    return TestResult(true, "Netlink is Linux-only", std::chrono::milliseconds(0));
+#endif
+}
+
+#ifdef __linux__
+// Runs on a thread with its own network namespace, so only that namespace's lo changes
+inline auto netlink_monitor_events_isolated() -> TestResult {
+    using namespace network;
+    NetlinkMonitor monitor;
+    if (!monitor.open().has_value()) {
+        return TestResult(false, "Monitor not opened", std::chrono::milliseconds(0));
+    }
+    auto state = netlink_dump();
+    Poller poller;
+    if (!state.has_value() || !poller.open() || !poller.add(monitor.native_handle())) {
+        return TestResult(false, "Poller registration failed", std::chrono::milliseconds(0));
+    }
+
+    // Changing host addresses needs CAP_NET_ADMIN
+    if (std::system("ip addr add 127.0.0.77/8 dev lo 2>/dev/null") != 0) {
+        return TestResult(true, "Address changes not permitted here; subscription opened", std::chrono::milliseconds(0));
+    }
+    int loopback = static_cast<int>(if_nametoindex("lo"));
+    IPAddress added(netlink_v4("127.0.0.77"));
+    auto wait_for = [&](NetlinkEventType type) {
+        bool seen = false;
+        std::vector<PollEvent> events;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!seen && std::chrono::steady_clock::now() < deadline) {
+            poller.wait(events, 100);
+            if (events.empty()) {
+                continue;
+            }
+            monitor.process([&](const NetlinkEvent& event) {
+                state->apply(event);
+                seen |= event.type == type && event.address.interface_index == loopback && event.address.address == added;
+            });
+        }
+        return seen;
+    };
+
+    bool added_seen = wait_for(NetlinkEventType::ADDRESS_ADDED);
+    auto interfaces = state->to_network_interfaces();
+    auto lo = std::find_if(interfaces.begin(), interfaces.end(), [](const NetworkInterface& i) { return i.name == "lo"; });
+    bool applied = lo != interfaces.end() &&
+                   std::find(lo->ipv4_addresses.begin(), lo->ipv4_addresses.end(), added.get_ipv4()) != lo->ipv4_addresses.end();
+    std::system("ip addr del 127.0.0.77/8 dev lo 2>/dev/null");
+    bool removed_seen = wait_for(NetlinkEventType::ADDRESS_REMOVED);
+
+    if (!added_seen || !applied || !removed_seen) {
+        return TestResult(false, "Address change not delivered", std::chrono::milliseconds(0));
+    }
+    bool gone = std::none_of(state->addresses.begin(), state->addresses.end(),
+                             [&](const AddressInfo& a) { return a.address == added; });
+    return assert_true(gone, "Address changes delivered through the poller");
+}
+#endif
+
+inline auto test_netlink_monitor_events() -> TestResult {
+#ifdef __linux__
+    TestResult result(false, "Namespace thread did not run", std::chrono::milliseconds(0));
+    std::thread isolated([&] {
+        // Namespaces belong to the thread, and the ip commands it forks inherit this one
+        if (::unshare(CLONE_NEWNET) != 0) {
+            result = TestResult(true, "Network namespaces not permitted here; skipped", std::chrono::milliseconds(0));
+            return;
+        }
+        result = netlink_monitor_events_isolated();
+    });
+    isolated.join();
+    return result;
+#else
+    return TestResult(true, "Netlink is Linux-only", std::chrono::milliseconds(0));
+#endif
+}
+
+inline auto run_netlink_tests() -> bool {
+    TestSuite suite("Netlink Interface Tests");
+
+    suite.add_test("Incremental State", test_netlink_state_apply);
+    suite.add_test("Link, Address and Route Dump", test_netlink_dump);
+    suite.add_test("Change Subscription", test_netlink_monitor_events);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
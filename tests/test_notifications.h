@@ -0,0 +1,665 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../include/dualstack_net26/network/notifications.h"
+#include "../include/dualstack_net26/network/notification_aggregator.h"
+#include "../include/dualstack_net26/network/notification_transport.h"
+#include "../include/dualstack_net26/network/notification_ring.h"
+#include "../src/network/async_connection_manager.h"
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+
+namespace dualstack {
+namespace test {
+
+using namespace dualstack::network::notifications;
+
+inline auto make_error_notification(const std::string& code) -> Notification {
+    Notification notification;
+    notification.source_id = "psiforcedb";
+    notification.source_component = "session_manager";
+    notification.category = Category::ERROR_REPORT;
+    notification.severity = Severity::ERROR;
+    notification.error_code = code;
+    notification.title = "Error: " + code;
+    notification.message = "connection refused";
+    return notification;
+}
+
+inline auto test_aggregator_coalesces_repeats() -> TestResult {
+    NotificationAggregator aggregator;
+    auto start = NotificationAggregator::clock::now();
+    auto error = make_error_notification("NETWORK_DOWN");
+
+    if (!aggregator.admit(error, start)) {
+        return TestResult(false, "First occurrence should be forwarded", std::chrono::milliseconds(0));
+    }
+
+    for (int i = 0; i < 999; ++i) {
+        if (aggregator.admit(error, start + std::chrono::microseconds(i))) {
+            return TestResult(false, "Repeat inside window was forwarded", std::chrono::milliseconds(0));
+        }
+    }
+
+    if (!aggregator.collect_summaries(start + std::chrono::milliseconds(10)).empty()) {
+        return TestResult(false, "Summary emitted before window closed", std::chrono::milliseconds(0));
+    }
+
+    auto summaries = aggregator.collect_summaries(start + std::chrono::seconds(2));
+    if (summaries.size() != 1) {
+        return TestResult(false, "Expected exactly one summary", std::chrono::milliseconds(0));
+    }
+    if (summaries[0].metadata["occurrence_count"] != "999") {
+        return TestResult(false, "Summary count mismatch: " + summaries[0].metadata["occurrence_count"],
+                         std::chrono::milliseconds(0));
+    }
+
+    // Quiet window: key is forgotten and the next occurrence goes straight through
+    if (!aggregator.collect_summaries(start + std::chrono::seconds(4)).empty()) {
+        return TestResult(false, "Quiet window should not produce a summary", std::chrono::milliseconds(0));
+    }
+    return assert_true(aggregator.admit(error, start + std::chrono::seconds(5)),
+                       "Occurrence after quiet window should be forwarded");
+}
+
+inline auto test_aggregator_distinct_keys() -> TestResult {
+    NotificationAggregator aggregator;
+    auto now = NotificationAggregator::clock::now();
+
+    auto network = make_error_notification("NETWORK_DOWN");
+    auto auth = make_error_notification("AUTH_FAILED");
+    auto warning = make_error_notification("NETWORK_DOWN");
+    warning.severity = Severity::WARNING;
+
+    bool all_forwarded = aggregator.admit(network, now) && aggregator.admit(auth, now) &&
+                         aggregator.admit(warning, now);
+    return assert_true(all_forwarded, "Different code or severity must not be coalesced");
+}
+
+inline auto test_aggregator_default_no_throttle() -> TestResult {
+    NotificationAggregator aggregator;
+    auto now = NotificationAggregator::clock::now();
+
+    // No limit is configured by default, and messages without an error code
+    // are never folded together
+    for (int i = 0; i < 5000; ++i) {
+        Notification event;
+        event.source_id = "lamia";
+        event.severity = Severity::INFO;
+        event.message = "event " + std::to_string(i);
+        if (!aggregator.admit(event, now)) {
+            return TestResult(false, "Default config dropped event " + std::to_string(i),
+                             std::chrono::milliseconds(0));
+        }
+    }
+    return assert_equal(aggregator.get_tracked_key_count(), static_cast<size_t>(0));
+}
+
+inline auto test_aggregator_rate_limited_distinct() -> TestResult {
+    AggregationConfig config;
+    config.default_limit.tokens_per_second = 1.0;
+    config.default_limit.burst = 1.0;
+    NotificationAggregator aggregator(config);
+    auto now = NotificationAggregator::clock::now();
+
+    for (const char* message : {"disk full", "link down", "link down"}) {
+        Notification event;
+        event.source_id = "node";
+        event.message = message;
+        aggregator.admit(event, now);
+    }
+
+    // "link down" twice was dropped; it must not be reported as a repeat of "disk full"
+    auto summaries = aggregator.drain(now + std::chrono::milliseconds(10));
+    if (summaries.size() != 1 || summaries[0].metadata["occurrence_count"] != "2" ||
+        summaries[0].message.rfind("link down", 0) != 0) {
+        return TestResult(false, "Rate-limited summary should cover only identical notifications",
+                         std::chrono::milliseconds(0));
+    }
+    return assert_true(summaries[0].message.find("identical") != std::string::npos,
+                       "Summary should say what was matched");
+}
+
+inline auto test_aggregator_token_bucket() -> TestResult {
+    AggregationConfig config;
+    config.default_limit.tokens_per_second = 10.0;
+    config.default_limit.burst = 5.0;
+    NotificationAggregator aggregator(config);
+    auto now = NotificationAggregator::clock::now();
+
+    // Events without an error code are not coalesced, only rate limited
+    size_t forwarded = 0;
+    for (int i = 0; i < 20; ++i) {
+        Notification event;
+        event.source_id = "galaxycdn";
+        event.category = Category::CDN;
+        if (aggregator.admit(event, now)) {
+            ++forwarded;
+        }
+    }
+    if (forwarded != 5) {
+        return TestResult(false, "Burst should cap forwarding at 5, got " + std::to_string(forwarded),
+                         std::chrono::milliseconds(0));
+    }
+
+    Notification critical;
+    critical.category = Category::CDN;
+    critical.severity = Severity::CRITICAL;
+    if (!aggregator.admit(critical, now)) {
+        return TestResult(false, "CRITICAL should bypass the token bucket", std::chrono::milliseconds(0));
+    }
+
+    Notification later;
+    later.source_id = "galaxycdn";
+    later.category = Category::CDN;
+    if (!aggregator.admit(later, now + std::chrono::milliseconds(200))) {
+        return TestResult(false, "Bucket should refill over time", std::chrono::milliseconds(0));
+    }
+
+    auto summaries = aggregator.drain(now + std::chrono::milliseconds(300));
+    if (summaries.size() != 1 || summaries[0].metadata["rate_limited_count"] != "15") {
+        return TestResult(false, "Rate-limited events should be reported in a summary",
+                         std::chrono::milliseconds(0));
+    }
+    return assert_equal(aggregator.get_rate_limited_count(), static_cast<size_t>(15));
+}
+
+inline auto test_wire_round_trip() -> TestResult {
+    auto original = make_error_notification("DB_TIMEOUT");
+    original.metadata["attempt"] = "3";
+    original.affected_components = {"pool", "replica"};
+
+    std::vector<std::byte> batch;
+    wire::begin_batch(batch);
+    for (int i = 0; i < 3; ++i) {
+        std::vector<std::byte> record;
+        wire::encode_notification(original, record);
+        wire::append_record(batch, record);
+    }
+    wire::finish_batch(batch, 3);
+
+    auto decoded = wire::decode_batch(batch);
+    if (!decoded || decoded->size() != 3) {
+        return TestResult(false, "Batch failed to decode", std::chrono::milliseconds(0));
+    }
+
+    const auto& first = decoded->front();
+    bool matches = first.notification_id == original.notification_id &&
+                   first.error_code == original.error_code &&
+                   first.severity == original.severity &&
+                   first.category == original.category &&
+                   first.affected_components == original.affected_components &&
+                   first.metadata.at("attempt") == "3";
+    if (!matches) {
+        return TestResult(false, "Decoded notification differs", std::chrono::milliseconds(0));
+    }
+
+    batch.pop_back();
+    return assert_false(wire::decode_batch(batch).has_value(), "Truncated batch must be rejected");
+}
+
+// Stand-in notification server: decodes batches and acknowledges each one
+class StandInNotificationServer {
+public:
+    explicit StandInNotificationServer(port_t port = 0) {
+        listening_ = acceptor_.listen(port) == error_code::success;
+        if (listening_) {
+            worker_ = std::thread([this] { serve(); });
+        }
+    }
+
+    ~StandInNotificationServer() {
+        running_ = false;
+        acceptor_.stop_listening();
+        if (client_fd_ >= 0) {
+            ::shutdown(client_fd_, SHUT_RDWR);
+        }
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    bool listening() const { return listening_; }
+    port_t port() const { return acceptor_.local_port(); }
+    size_t received() const { return received_.load(); }
+
+private:
+    Acceptor acceptor_;
+    bool listening_ = false;
+    std::atomic<bool> running_{true};
+    std::atomic<size_t> received_{0};
+    std::atomic<int> client_fd_{-1};
+    std::thread worker_;
+
+    static bool read_exact(Socket& socket, std::byte* data, size_t size) {
+        size_t offset = 0;
+        while (offset < size) {
+            size_t got = socket.receive(buffer_t(data + offset, size - offset));
+            if (got == 0) {
+                return false;
+            }
+            offset += got;
+        }
+        return true;
+    }
+
+    void serve() {
+        auto client = acceptor_.accept();
+        if (!client.has_value() || !running_) {
+            return;
+        }
+        Socket socket = std::move(client.value());
+        client_fd_ = socket.get_native_handle();
+
+        while (running_) {
+            network::GalaxyCDN::ProtocolHeader header{};
+            if (!read_exact(socket, reinterpret_cast<std::byte*>(&header), sizeof(header))) {
+                return;
+            }
+            std::vector<std::byte> payload(header.payload_length);
+            if (!read_exact(socket, payload.data(), payload.size())) {
+                return;
+            }
+            auto batch = wire::decode_batch(payload);
+            if (!batch) {
+                return;
+            }
+            received_ += batch->size();
+
+            network::GalaxyCDN::ProtocolHeader ack{};
+            ack.magic = network::GalaxyCDN::PROTOCOL_MAGIC;
+            ack.version = network::GalaxyCDN::PROTOCOL_VERSION;
+            ack.flags = wire::FLAG_NOTIFICATION_ACK;
+            ack.request_id = header.request_id;
+            (void)socket.send(buffer_t(reinterpret_cast<const std::byte*>(&ack), sizeof(ack)));
+        }
+    }
+};
+
+inline auto wait_for_acked(NotificationTransport& transport, uint64_t expected) -> bool {
+    for (int i = 0; i < 200; ++i) {
+        if (transport.get_stats().notifications_acked >= expected) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+inline auto test_transport_delivers_batches() -> TestResult {
+    StandInNotificationServer server;
+    if (!server.listening()) {
+        return TestResult(false, "Stand-in server failed to listen", std::chrono::milliseconds(0));
+    }
+
+    NotificationTransportConfig config;
+    config.host = "::1";
+    config.port = server.port();
+    config.max_batch_notifications = 32;
+    config.spill_path = (std::filesystem::temp_directory_path() / "amphisbaena_test_deliver.spill").string();
+    std::filesystem::remove(config.spill_path);
+
+    NotificationTransport transport(config);
+    if (!transport.start()) {
+        return TestResult(false, "Transport failed to start", std::chrono::milliseconds(0));
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        transport.enqueue(make_error_notification("E" + std::to_string(i)));
+    }
+    transport.flush();
+
+    if (!wait_for_acked(transport, 1000)) {
+        return TestResult(false, "Only " + std::to_string(transport.get_stats().notifications_acked) +
+                         " of 1000 notifications acknowledged", std::chrono::milliseconds(0));
+    }
+    transport.stop();
+
+    auto stats = transport.get_stats();
+    if (stats.batches_sent < 1000 / 32) {
+        return TestResult(false, "Notifications were not batched", std::chrono::milliseconds(0));
+    }
+    return assert_equal(server.received(), static_cast<size_t>(1000), "Server-side count");
+}
+
+inline auto test_transport_spills_while_server_down() -> TestResult {
+    // Reserve a port, then release it so the first connection attempts are refused
+    port_t port = 0;
+    {
+        Acceptor probe;
+        if (probe.listen(0) != error_code::success) {
+            return TestResult(false, "Could not reserve a port", std::chrono::milliseconds(0));
+        }
+        port = probe.local_port();
+    }
+
+    NotificationTransportConfig config;
+    config.host = "::1";
+    config.port = port;
+    config.reconnect_initial = std::chrono::milliseconds(20);
+    config.reconnect_max = std::chrono::milliseconds(40);
+    config.spill_path = (std::filesystem::temp_directory_path() / "amphisbaena_test_spill.spill").string();
+    std::filesystem::remove(config.spill_path);
+
+    NotificationTransport transport(config);
+    if (!transport.start()) {
+        return TestResult(false, "Transport failed to start", std::chrono::milliseconds(0));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        transport.enqueue(make_error_notification("SPILL"));
+    }
+    transport.flush();
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    if (transport.get_stats().batches_spilled == 0) {
+        return TestResult(false, "Batches should spill to disk while the server is down",
+                         std::chrono::milliseconds(0));
+    }
+
+    StandInNotificationServer server(port);
+    if (!server.listening()) {
+        return TestResult(false, "Stand-in server failed to listen on reserved port", std::chrono::milliseconds(0));
+    }
+
+    if (!wait_for_acked(transport, 100)) {
+        return TestResult(false, "Spilled notifications were not replayed", std::chrono::milliseconds(0));
+    }
+    transport.stop();
+    std::filesystem::remove(config.spill_path);
+
+    return assert_equal(server.received(), static_cast<size_t>(100), "Replayed count");
+}
+
+inline auto test_transport_stalled_server() -> TestResult {
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+
+    // A server that accepts and never reads: the socket buffers fill and sends stall
+    std::atomic<bool> done{false};
+    std::thread server([&] {
+        auto client = acceptor.accept();
+        while (!done.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    NotificationTransportConfig config;
+    config.host = "::1";
+    config.port = acceptor.local_port();
+    config.max_in_flight_batches = 1024;
+    config.send_timeout = std::chrono::milliseconds(200);
+    config.max_spill_bytes = 1024 * 1024;
+
+    auto start = std::chrono::steady_clock::now();
+    bool stopped_promptly = false;
+    {
+        NotificationTransport transport(config);
+        if (!transport.start()) {
+            done = true;
+            acceptor.stop_listening();
+            server.join();
+            return TestResult(false, "Transport failed to start", std::chrono::milliseconds(0));
+        }
+        std::string padding(4096, 'x');
+        for (int i = 0; i < 8000; ++i) {
+            auto notification = make_error_notification("E" + std::to_string(i));
+            notification.message = padding;
+            transport.enqueue(std::move(notification));
+        }
+        transport.flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        auto stopping = std::chrono::steady_clock::now();
+        transport.stop();
+        stopped_promptly = std::chrono::steady_clock::now() - stopping < std::chrono::seconds(3);
+    }
+    done = true;
+    acceptor.stop_listening();
+    server.join();
+
+    return assert_true(stopped_promptly && std::chrono::steady_clock::now() - start < std::chrono::seconds(10),
+                       "A server that stops reading must not hang the sender or stop()");
+}
+
+inline auto test_transport_order_across_reconnect() -> TestResult {
+    port_t port = 0;
+    {
+        Acceptor probe;
+        if (probe.listen(0) != error_code::success) {
+            return TestResult(false, "Could not reserve a port", std::chrono::milliseconds(0));
+        }
+        port = probe.local_port();
+    }
+
+    // Ten spilled batches, only two of which fit in the send window
+    NotificationTransportConfig config;
+    config.host = "::1";
+    config.port = port;
+    config.max_batch_notifications = 10;
+    config.max_in_flight_batches = 2;
+    config.reconnect_initial = std::chrono::milliseconds(20);
+    config.reconnect_max = std::chrono::milliseconds(40);
+    config.spill_path = (std::filesystem::temp_directory_path() / "amphisbaena_test_order.spill").string();
+    std::filesystem::remove(config.spill_path);
+
+    NotificationTransport transport(config);
+    if (!transport.start()) {
+        return TestResult(false, "Transport failed to start", std::chrono::milliseconds(0));
+    }
+    for (int i = 0; i < 100; ++i) {
+        transport.enqueue(make_error_notification("E" + std::to_string(i)));
+    }
+    transport.flush();
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    // First connection takes the two in-flight batches and drops without
+    // acknowledging; the second records what is replayed
+    Acceptor acceptor;
+    if (acceptor.listen(port) != error_code::success) {
+        return TestResult(false, "Could not listen on reserved port", std::chrono::milliseconds(0));
+    }
+    auto read_frame = [](Socket& socket, network::GalaxyCDN::ProtocolHeader& header, std::vector<std::byte>& payload) {
+        auto read_exact = [&socket](std::byte* data, size_t size) {
+            for (size_t offset = 0; offset < size;) {
+                size_t got = socket.receive(buffer_t(data + offset, size - offset));
+                if (got == 0) {
+                    return false;
+                }
+                offset += got;
+            }
+            return true;
+        };
+        if (!read_exact(reinterpret_cast<std::byte*>(&header), sizeof(header))) {
+            return false;
+        }
+        payload.resize(header.payload_length);
+        return read_exact(payload.data(), payload.size());
+    };
+
+    std::vector<std::string> replayed;
+    std::thread server([&] {
+        network::GalaxyCDN::ProtocolHeader header{};
+        std::vector<std::byte> payload;
+        {
+            auto first = acceptor.accept();
+            if (!first.has_value()) {
+                return;
+            }
+            for (int i = 0; i < 2 && read_frame(first.value(), header, payload); ++i) {
+            }
+        }
+        auto second = acceptor.accept();
+        if (!second.has_value()) {
+            return;
+        }
+        while (replayed.size() < 100 && read_frame(second.value(), header, payload)) {
+            auto batch = wire::decode_batch(payload);
+            if (!batch) {
+                return;
+            }
+            for (const auto& notification : *batch) {
+                replayed.push_back(notification.error_code);
+            }
+            network::GalaxyCDN::ProtocolHeader ack{};
+            ack.magic = network::GalaxyCDN::PROTOCOL_MAGIC;
+            ack.version = network::GalaxyCDN::PROTOCOL_VERSION;
+            ack.flags = wire::FLAG_NOTIFICATION_ACK;
+            ack.request_id = header.request_id;
+            (void)second.value().send(buffer_t(reinterpret_cast<const std::byte*>(&ack), sizeof(ack)));
+        }
+    });
+
+    bool acked = wait_for_acked(transport, 100);
+    transport.stop();
+    acceptor.stop_listening();
+    server.join();
+    std::filesystem::remove(config.spill_path);
+    if (!acked || replayed.size() != 100) {
+        return TestResult(false, "Replay after reconnect incomplete: " + std::to_string(replayed.size()),
+                         std::chrono::milliseconds(0));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        if (replayed[i] != "E" + std::to_string(i)) {
+            return TestResult(false, "Replay out of order at " + std::to_string(i) + ": " + replayed[i],
+                             std::chrono::milliseconds(0));
+        }
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_ring_multi_producer() -> TestResult {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+    NotificationRing ring(1024);
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&ring, &go, p] {
+            while (!go) {}
+            std::string source = "producer" + std::to_string(p);
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                std::string title = std::to_string(i);
+                while (!ring.try_push(source.c_str(), "bench", 0x0004, 0, title.c_str(), "event")) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Records from one producer must arrive complete and in order
+    std::vector<int> next(PRODUCERS, 0);
+    bool in_order = true;
+    size_t total = 0;
+    go = true;
+    while (total < static_cast<size_t>(PRODUCERS * PER_PRODUCER)) {
+        total += ring.consume([&](const NotificationRecord& record) {
+            int producer = record.source_id[8] - '0';
+            if (std::atoi(record.title) != next[producer]++ || std::strcmp(record.message, "event") != 0) {
+                in_order = false;
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    if (!in_order) {
+        return TestResult(false, "Records were lost, reordered or torn", std::chrono::milliseconds(0));
+    }
+    return assert_true(ring.empty(), "Ring should be empty after draining");
+}
+
+inline auto test_ring_bounded_strings() -> TestResult {
+    NotificationRing ring(2);
+    std::string long_message(1000, 'x');
+
+    if (!ring.try_push(nullptr, "auth", 0x0005, 2, "Title", long_message.c_str()) ||
+        !ring.try_push("a", "b", 0x0005, 2, "c", "d")) {
+        return TestResult(false, "Pushes into an empty ring should succeed", std::chrono::milliseconds(0));
+    }
+    if (ring.try_push("a", "b", 0x0005, 2, "c", "d")) {
+        return TestResult(false, "Full ring must refuse instead of overwriting", std::chrono::milliseconds(0));
+    }
+
+    std::vector<Notification> received;
+    ring.consume([&](const NotificationRecord& record) {
+        received.push_back(NotificationRing::to_notification(record));
+    });
+
+    const auto& first = received.front();
+    bool ok = received.size() == 2 &&
+              first.source_id == "unknown" &&
+              first.message.size() == NOTIFICATION_RECORD_MESSAGE_SIZE - 1 &&
+              first.metadata.count("truncated") == 1 &&
+              first.category == Category::SECURITY &&
+              received[1].metadata.count("truncated") == 0;
+    return assert_true(ok, "Strings must be bounded and truncation flagged");
+}
+
+inline auto test_c_interface_fast_path() -> TestResult {
+    NotificationContextHandle first = notification_context_create();
+    NotificationContextHandle second = notification_context_create();
+    if (!first || !second) {
+        return TestResult(false, "Context creation failed", std::chrono::milliseconds(0));
+    }
+
+    int sent = notification_send(first, "lamia", "script", 0x0004, 0, "Started", "lamia fast path");
+
+    NotificationRecord* record = notification_record_acquire(second);
+    bool acquired = record != nullptr;
+    if (acquired) {
+        std::strcpy(record->title, "Direct");
+        record->title_length = 6;
+        notification_record_publish(second, record);
+    }
+
+    int flushed = notification_context_flush(first);
+    uint64_t dropped = notification_context_dropped(first);
+    notification_context_destroy(first);
+    notification_context_destroy(second);
+
+    bool ok = sent == NOTIFICATION_OK && acquired && flushed == NOTIFICATION_OK && dropped == 0 &&
+              notification_send(nullptr, "a", "b", 0, 0, "c", "d") == NOTIFICATION_ERROR_INVALID;
+    return assert_true(ok, "C fast path should accept, dispatch and flush records");
+}
+
+inline auto run_notification_tests() -> bool {
+    TestSuite suite("Notification Tests");
+
+    suite.add_test("Aggregator Coalesces Repeats", test_aggregator_coalesces_repeats);
+    suite.add_test("Aggregator Distinct Keys", test_aggregator_distinct_keys);
+    suite.add_test("Aggregator Token Bucket", test_aggregator_token_bucket);
+    suite.add_test("Aggregator Default No Throttle", test_aggregator_default_no_throttle);
+    suite.add_test("Aggregator Rate Limited Distinct", test_aggregator_rate_limited_distinct);
+    suite.add_test("Wire Round Trip", test_wire_round_trip);
+    suite.add_test("Transport Delivers Batches", test_transport_delivers_batches);
+    suite.add_test("Transport Spills While Server Down", test_transport_spills_while_server_down);
+    suite.add_test("Transport Order Across Reconnect", test_transport_order_across_reconnect);
+    suite.add_test("Transport Stalled Server", test_transport_stalled_server);
+    suite.add_test("Ring Multi Producer", test_ring_multi_producer);
+    suite.add_test("Ring Bounded Strings", test_ring_bounded_strings);
+    suite.add_test("C Interface Fast Path", test_c_interface_fast_path);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
@@ -0,0 +1,520 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../src/reflect/serializer.h"
+#include "../src/reflect/message_view.h"
+#include "../src/network/galaxycdn_messages.h"
+#include "../src/security/tls_protocol.h"
+#include "../src/network/async_connection_manager.h"
+#include "../include/dualstack_net26/network/network_config.h"
+#include "../include/dualstack_net26/network/notifications.h"
+#include <cstring>
+#include <thread>
+
+namespace dualstack {
+namespace test {
+
+inline auto make_reflection_profile() -> network::config::NetworkProfile {
+    using namespace network::config;
+    NetworkProfile profile("edge");
+    profile.description = "edge \"pop\"\n\ttabbed \xC2\xA3";
+    profile.firewall_enabled = true;
+    profile.nat_enabled = false;
+    profile.vpc_id = "vpc-1";
+
+    auto v4 = SubnetConfig::from_cidr("10.20.0.0/16", NetworkType::VPC);
+    auto v6 = SubnetConfig::from_cidr("2001:db8::/32", NetworkType::PUBLIC);
+    if (v4) profile.subnets.push_back(*v4);
+    if (v6) profile.subnets.push_back(*v6);
+
+    InterfaceConfig iface;
+    iface.name = "eth0";
+    iface.ip_address = IPAddress::from_string("10.20.0.5").value_or(IPAddress{});
+    iface.dns_servers.push_back(IPAddress::from_string("2001:4860:4860::8888").value_or(IPAddress{}));
+    iface.mtu = 9000;
+    profile.interfaces.push_back(iface);
+    return profile;
+}
+
+// Two revisions of one schema, for reading across versions
+struct ViewSchemaV1 {
+    uint32_t id = 0;
+    std::string name;
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(id);
+        DUALSTACK_REFLECT_MEMBER(name);
+    }
+};
+
+struct ViewSchemaV2 {
+    uint32_t id = 0;
+    std::string name;
+    bool enabled = false;
+    std::vector<std::string> aliases;
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(id);
+        DUALSTACK_REFLECT_MEMBER(name);
+        DUALSTACK_REFLECT_MEMBER(enabled);
+        DUALSTACK_REFLECT_MEMBER(aliases);
+    }
+};
+
+// Recursive schema used to build self-referencing (hostile) messages
+struct ViewTreeNode {
+    std::vector<ViewTreeNode> children;
+
+    template<typename Reflection>
+    constexpr void reflect(Reflection& r) {
+        DUALSTACK_REFLECT_MEMBER(children);
+    }
+};
+
+inline auto test_reflection_binary_round_trip() -> TestResult {
+    using namespace dualstack::reflect;
+    security::tls::TLSConfiguration config;
+    config.min_version = security::tls::Version::TLS_1_3;
+    config.preferred_suites = {security::tls::CipherSuite::TLS_CHACHA20_POLY1305_SHA256};
+    config.require_pqc = true;
+    config.session_timeout = std::chrono::minutes(5);
+
+    auto bytes = to_binary(config);
+    auto decoded = from_binary<security::tls::TLSConfiguration>(bytes);
+    if (!decoded) {
+        return TestResult(false, "TLSConfiguration binary decode failed", std::chrono::milliseconds(0));
+    }
+    if (decoded->min_version != config.min_version || decoded->preferred_suites != config.preferred_suites ||
+        !decoded->require_pqc || decoded->session_timeout != config.session_timeout) {
+        return TestResult(false, "TLSConfiguration binary round trip changed fields", std::chrono::milliseconds(0));
+    }
+
+    // ProtocolHeader is packed: 4 + 2 + 2 + 4 + 8 bytes, little-endian
+    network::GalaxyCDN::ProtocolHeader header{network::GalaxyCDN::PROTOCOL_MAGIC, 1, 0x0102, 77, 0x1122334455667788ULL};
+    auto header_bytes = to_binary(header);
+    if (header_bytes.size() != 20 || header_bytes[0] != std::byte{0x58} || header_bytes[12] != std::byte{0x88}) {
+        return TestResult(false, "ProtocolHeader encoding is not packed little-endian", std::chrono::milliseconds(0));
+    }
+    auto header_back = from_binary<network::GalaxyCDN::ProtocolHeader>(header_bytes);
+    if (!header_back || header_back->request_id != header.request_id || header_back->flags != header.flags) {
+        return TestResult(false, "ProtocolHeader round trip failed", std::chrono::milliseconds(0));
+    }
+
+    auto profile = make_reflection_profile();
+    auto profile_bytes = to_binary(profile);
+    auto profile_back = from_binary<network::config::NetworkProfile>(profile_bytes);
+    if (!profile_back || profile_back->subnets.size() != 2 ||
+        profile_back->subnets[1].to_cidr() != profile.subnets[1].to_cidr() ||
+        profile_back->interfaces[0].dns_servers[0].to_string() != profile.interfaces[0].dns_servers[0].to_string() ||
+        profile_back->description != profile.description) {
+        return TestResult(false, "NetworkProfile binary round trip failed", std::chrono::milliseconds(0));
+    }
+
+    network::notifications::Notification notification;
+    notification.title = "disk";
+    notification.metadata["volume"] = "/var";
+    notification.affected_components = {"store", "index"};
+    auto notification_back = from_binary<network::notifications::Notification>(to_binary(notification));
+    if (!notification_back || notification_back->metadata != notification.metadata ||
+        notification_back->affected_components != notification.affected_components ||
+        std::chrono::duration_cast<std::chrono::milliseconds>(notification_back->timestamp.time_since_epoch()) !=
+            std::chrono::duration_cast<std::chrono::milliseconds>(notification.timestamp.time_since_epoch())) {
+        return TestResult(false, "Notification binary round trip failed", std::chrono::milliseconds(0));
+    }
+
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_reflection_json_round_trip() -> TestResult {
+    using namespace dualstack::reflect;
+    auto profile = make_reflection_profile();
+    std::string json = to_json(profile);
+    if (json.find("\"network_address\":\"10.20.0.0\"") == std::string::npos ||
+        json.find("\\\"pop\\\"\\n\\t") == std::string::npos) {
+        return TestResult(false, "JSON output missing address text or escapes: " + json, std::chrono::milliseconds(0));
+    }
+
+    auto back = from_json<network::config::NetworkProfile>(json);
+    if (!back || back->profile_name != "edge" || back->description != profile.description ||
+        back->subnets.size() != 2 || back->subnets[0].type != network::config::NetworkType::VPC ||
+        back->interfaces[0].mtu != 9000) {
+        return TestResult(false, "NetworkProfile JSON round trip failed", std::chrono::milliseconds(0));
+    }
+
+    // Unknown keys are skipped, missing keys keep their defaults, \u escapes decode
+    auto tls = from_json<security::tls::TLSConfiguration>(
+        R"({ "future_field": {"a": [1, 2, null]}, "require_pqc": true, "session_timeout": 7, "ignored": "\u00e9\ud83d\ude00" })");
+    if (!tls || !tls->require_pqc || tls->session_timeout != std::chrono::minutes(7) || !tls->enable_icewall) {
+        return TestResult(false, "TLSConfiguration JSON with unknown keys failed", std::chrono::milliseconds(0));
+    }
+
+    network::notifications::Notification notification;
+    notification.message = "caf\xC3\xA9 \x01";
+    auto notification_back = from_json<network::notifications::Notification>(to_json(notification));
+    if (!notification_back || notification_back->message != notification.message ||
+        notification_back->notification_id != notification.notification_id) {
+        return TestResult(false, "Notification JSON round trip failed", std::chrono::milliseconds(0));
+    }
+
+    // NetworkConfigEditor persistence goes through the same serializer
+    network::config::NetworkConfigEditor editor;
+    editor.create_profile("office", "second floor");
+    editor.add_subnet("192.168.10.0/24", network::config::NetworkType::PRIVATE, "lan");
+    std::string exported = editor.export_to_json();
+
+    network::config::NetworkConfigEditor restored;
+    if (!restored.import_from_json(exported)) {
+        return TestResult(false, "NetworkConfigEditor import failed", std::chrono::milliseconds(0));
+    }
+    auto lan = restored.get_subnet_for(IPAddress::from_string("192.168.10.42").value_or(IPAddress{}));
+    if (!lan || lan->name != "lan" || restored.export_to_json() != exported) {
+        return TestResult(false, "NetworkConfigEditor export/import lost the subnet", std::chrono::milliseconds(0));
+    }
+
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_reflection_rejects_malformed_input() -> TestResult {
+    using namespace dualstack::reflect;
+    auto bytes = to_binary(make_reflection_profile());
+
+    for (std::size_t cut : {std::size_t{0}, std::size_t{1}, bytes.size() / 2, bytes.size() - 1}) {
+        auto truncated = from_binary<network::config::NetworkProfile>(std::span(bytes.data(), cut));
+        if (truncated || truncated.error() != SerialError::truncated) {
+            return TestResult(false, "Truncated binary input was accepted at " + std::to_string(cut),
+                              std::chrono::milliseconds(0));
+        }
+    }
+
+    auto padded = bytes;
+    padded.push_back(std::byte{0});
+    auto trailing = from_binary<network::config::NetworkProfile>(padded);
+    if (trailing || trailing.error() != SerialError::trailing_data) {
+        return TestResult(false, "Trailing binary data was accepted", std::chrono::milliseconds(0));
+    }
+
+    // A string length far beyond the buffer must fail without allocating it
+    std::vector<std::byte> huge_length(8, std::byte{0xFF});
+    huge_length.push_back(std::byte{0x01});
+    if (from_binary<network::notifications::Notification>(huge_length)) {
+        return TestResult(false, "Oversized length prefix was accepted", std::chrono::milliseconds(0));
+    }
+
+    for (std::string_view bad : {"", "{", "{\"require_pqc\": tru}", "{\"session_timeout\": \"x\"}",
+                                 "{\"require_pqc\": true,}", "{} {}", "{\"a\": \"\\ud800\"}"}) {
+        if (from_json<security::tls::TLSConfiguration>(bad)) {
+            return TestResult(false, "Malformed JSON was accepted: " + std::string(bad), std::chrono::milliseconds(0));
+        }
+    }
+
+    std::string deep(MAX_SERIAL_DEPTH + 8, '[');
+    auto too_deep = from_json<security::tls::TLSConfiguration>("{\"x\":" + deep);
+    if (too_deep || too_deep.error() != SerialError::too_deep) {
+        return TestResult(false, "Deeply nested JSON was not rejected", std::chrono::milliseconds(0));
+    }
+
+    auto bad_address = from_json<network::config::SubnetConfig>(R"({"network_address": "not-an-ip"})");
+    if (bad_address || bad_address.error() != SerialError::invalid_value) {
+        return TestResult(false, "Invalid IP address text was accepted", std::chrono::milliseconds(0));
+    }
+
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_message_view_reads_in_place() -> TestResult {
+    using namespace network::GalaxyCDN;
+    using reflect::MessageView;
+
+    EdgeStatus status;
+    status.node_id = "edge-lhr-04";
+    status.region = "eu-west";
+    status.objects = 1234567;
+    status.bytes = 0x1122334455667788ULL;
+    status.hit_ratio = 0.975;
+    status.shard_load = {10, 20, 30, 40};
+    status.reported_at = std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000123));
+
+    auto buffer = reflect::build_message(status).value();
+    auto view = MessageView<EdgeStatus>::validate(buffer);
+    if (!view) {
+        return TestResult(false, std::string("EdgeStatus failed validation: ") + reflect::describe(view.error()),
+                         std::chrono::milliseconds(0));
+    }
+
+    std::string_view node = view->get<&EdgeStatus::node_id>();
+    const char* begin = reinterpret_cast<const char*>(buffer.data());
+    if (node != "edge-lhr-04" || node.data() < begin || node.data() >= begin + buffer.size()) {
+        return TestResult(false, "String member should be read from the buffer", std::chrono::milliseconds(0));
+    }
+    if (view->get<&EdgeStatus::bytes>() != status.bytes || view->get<&EdgeStatus::hit_ratio>() != 0.975 ||
+        view->get<&EdgeStatus::reported_at>() != status.reported_at) {
+        return TestResult(false, "Scalar members read incorrectly", std::chrono::milliseconds(0));
+    }
+
+    uint32_t load_total = 0;
+    for (uint32_t load : view->get<&EdgeStatus::shard_load>()) {
+        load_total += load;
+    }
+    if (view->get<&EdgeStatus::shard_load>().size() != 4 || load_total != 100) {
+        return TestResult(false, "Vector member read incorrectly", std::chrono::milliseconds(0));
+    }
+
+    ObjectRequest request;
+    request.host = "cdn.example";
+    request.key = "/video/intro.mp4";
+    request.ranges = {{0, 1023}, {4096, UINT64_MAX}};
+    request.max_stale = std::chrono::seconds(30);
+    auto request_buffer = reflect::build_message(request).value();
+    auto request_view = MessageView<ObjectRequest>::validate(request_buffer);
+    if (!request_view) {
+        return TestResult(false, "ObjectRequest failed validation", std::chrono::milliseconds(0));
+    }
+    auto ranges = request_view->get<&ObjectRequest::ranges>();
+    if (ranges.size() != 2 || ranges[1].get<&ByteRange::first>() != 4096 ||
+        ranges[0].get<&ByteRange::last>() != 1023 ||
+        request_view->get<&ObjectRequest::max_stale>() != std::chrono::seconds(30)) {
+        return TestResult(false, "Nested messages read incorrectly", std::chrono::milliseconds(0));
+    }
+
+    ObjectResponse response;
+    response.status = 206;
+    response.body = {std::byte{1}, std::byte{2}, std::byte{3}};
+    auto response_buffer = reflect::build_message(response).value();
+    auto response_view = MessageView<ObjectResponse>::validate(response_buffer);
+    auto body = response_view ? response_view->get<&ObjectResponse::body>().bytes() : std::span<const std::byte>();
+    if (body.size() != 3 || body[2] != std::byte{3}) {
+        return TestResult(false, "Byte vector should be exposed as a span", std::chrono::milliseconds(0));
+    }
+
+    EdgeStatus decoded = view->decode();
+    if (decoded.node_id != status.node_id || decoded.shard_load != status.shard_load ||
+        decoded.reported_at != status.reported_at) {
+        return TestResult(false, "decode() should produce an equal object", std::chrono::milliseconds(0));
+    }
+    ObjectRequest request_decoded = request_view->decode();
+    if (request_decoded.ranges.size() != 2 || request_decoded.ranges[1].last != UINT64_MAX) {
+        return TestResult(false, "decode() lost nested messages", std::chrono::milliseconds(0));
+    }
+
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_message_view_schema_evolution() -> TestResult {
+    using reflect::MessageView;
+
+    auto old_buffer = reflect::build_message(ViewSchemaV1{7, "origin"}).value();
+    auto newer_reader = MessageView<ViewSchemaV2>::validate(old_buffer);
+    if (!newer_reader || newer_reader->get<&ViewSchemaV2::id>() != 7 ||
+        newer_reader->get<&ViewSchemaV2::name>() != "origin") {
+        return TestResult(false, "Newer schema should read an older message", std::chrono::milliseconds(0));
+    }
+    if (newer_reader->has<&ViewSchemaV2::aliases>() || !newer_reader->get<&ViewSchemaV2::aliases>().empty() ||
+        newer_reader->get<&ViewSchemaV2::enabled>()) {
+        return TestResult(false, "Members the sender lacks should read as absent", std::chrono::milliseconds(0));
+    }
+
+    ViewSchemaV2 current{9, "edge", true, {"a", "b"}};
+    auto new_buffer = reflect::build_message(current).value();
+    auto older_reader = MessageView<ViewSchemaV1>::validate(new_buffer);
+    if (!older_reader || older_reader->get<&ViewSchemaV1::name>() != "edge") {
+        return TestResult(false, "Older schema should read a newer message", std::chrono::milliseconds(0));
+    }
+
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_message_view_rejects_malformed() -> TestResult {
+    using namespace network::GalaxyCDN;
+    using reflect::MessageView;
+    using reflect::SerialError;
+
+    PurgeRequest purge;
+    purge.keys = {"/a", "/b"};
+    purge.soft = true;
+    auto buffer = reflect::build_message(purge).value();
+
+    for (std::size_t cut = 0; cut < buffer.size(); ++cut) {
+        if (MessageView<PurgeRequest>::validate(std::span(buffer.data(), cut))) {
+            return TestResult(false, "Truncated message accepted at " + std::to_string(cut), std::chrono::milliseconds(0));
+        }
+    }
+
+    // Layout: u32 fixed | keys ref (4..11) | tags ref (12..19) | soft (20)
+    auto bad_bool = buffer;
+    bad_bool[20] = std::byte{2};
+    auto bool_result = MessageView<PurgeRequest>::validate(bad_bool);
+    if (bool_result || bool_result.error() != SerialError::invalid_value) {
+        return TestResult(false, "Boolean outside 0/1 accepted", std::chrono::milliseconds(0));
+    }
+
+    auto huge_count = buffer;
+    huge_count[8] = std::byte{0xFF};
+    huge_count[9] = std::byte{0xFF};
+    if (MessageView<PurgeRequest>::validate(huge_count)) {
+        return TestResult(false, "Vector count beyond the buffer accepted", std::chrono::milliseconds(0));
+    }
+
+    // A node whose children all point back at itself: unbounded work if followed
+    std::vector<std::byte> cycle(12 + 8 * 16);
+    reflect::detail::store_le(cycle.data(), 8, 4);
+    reflect::detail::store_le(cycle.data() + 4, 12, 4);
+    reflect::detail::store_le(cycle.data() + 8, 16, 4);
+    for (std::size_t i = 0; i < 16; ++i) {
+        reflect::detail::store_le(cycle.data() + 12 + i * 8, 0, 4);
+        reflect::detail::store_le(cycle.data() + 16 + i * 8, cycle.size(), 4);
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (MessageView<ViewTreeNode>::validate(cycle)) {
+        return TestResult(false, "Self-referencing message accepted", std::chrono::milliseconds(0));
+    }
+    if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(100)) {
+        return TestResult(false, "Aliased references should exhaust the validation budget quickly",
+                         std::chrono::milliseconds(0));
+    }
+
+    ProtocolHeader header{PROTOCOL_MAGIC, PROTOCOL_VERSION, message_flags<ObjectRequest>(), 0, 1};
+    auto wrong_type = view_message<PurgeRequest>(header, buffer);
+    if (wrong_type || wrong_type.error() != SerialError::invalid_value) {
+        return TestResult(false, "Payload viewed as the wrong message type", std::chrono::milliseconds(0));
+    }
+
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_message_view_rejects_oversized() -> TestResult {
+    using namespace network::GalaxyCDN;
+    using reflect::SerialError;
+
+    // References are 32-bit: a trailing body past 4 GiB must fail, not wrap
+    ObjectResponse response;
+    response.status = 200;
+    auto prefix = reflect::build_message(response).value();
+    auto original = prefix;
+    auto attached = reflect::attach_trailing_bytes<&ObjectResponse::body>(prefix, std::size_t{UINT32_MAX} + 1);
+    if (attached || attached.error() != SerialError::too_large) {
+        return TestResult(false, "Trailing length past 4 GiB accepted", std::chrono::milliseconds(0));
+    }
+    if (prefix != original) {
+        return TestResult(false, "Rejected attach should leave the message untouched", std::chrono::milliseconds(0));
+    }
+
+    auto fits = reflect::attach_trailing_bytes<&ObjectResponse::body>(prefix, UINT32_MAX);
+    return assert_true(fits.has_value(), "Trailing length of exactly 4 GiB - 1 should be accepted");
+}
+
+inline auto test_galaxycdn_messages_over_loopback() -> TestResult {
+    using namespace network::GalaxyCDN;
+
+    Acceptor acceptor;
+    if (acceptor.listen(0) != error_code::success) {
+        return TestResult(false, "Could not listen on loopback", std::chrono::milliseconds(0));
+    }
+
+    // Origin stand-in: answers one ObjectRequest with the requested key as the body
+    std::atomic<bool> origin_ok{false};
+    std::thread origin([&] {
+        auto client = acceptor.accept();
+        if (!client.has_value()) {
+            return;
+        }
+        Socket socket = std::move(client.value());
+        ProtocolHeader header{};
+        std::vector<std::byte> payload;
+        auto read_exact = [&socket](std::byte* data, size_t size) {
+            for (size_t offset = 0; offset < size;) {
+                size_t got = socket.receive(buffer_t(data + offset, size - offset));
+                if (got == 0) return false;
+                offset += got;
+            }
+            return true;
+        };
+        if (!read_exact(reinterpret_cast<std::byte*>(&header), sizeof(header))) {
+            return;
+        }
+        payload.resize(header.payload_length);
+        if (!read_exact(payload.data(), payload.size())) {
+            return;
+        }
+        auto request = view_message<ObjectRequest>(header, payload);
+        if (!request) {
+            return;
+        }
+        std::string_view key = request->get<&ObjectRequest::key>();
+        origin_ok = true;
+
+        ObjectResponse response;
+        response.status = 200;
+        response.content_length = key.size();
+        for (char c : key) {
+            response.body.push_back(static_cast<std::byte>(c));
+        }
+        std::vector<std::byte> reply;
+        reflect::build_message(response, reply);
+        ProtocolHeader reply_header{PROTOCOL_MAGIC, PROTOCOL_VERSION, message_flags<ObjectResponse>(),
+                                    static_cast<uint32_t>(reply.size()), header.request_id};
+        (void)socket.send(buffer_t(reinterpret_cast<const std::byte*>(&reply_header), sizeof(reply_header)));
+        (void)socket.send(buffer_t(reply.data(), reply.size()));
+    });
+
+    network::AsyncConnectionManager manager;
+    manager.initialize();
+    std::string connection_id;
+    try {
+        connection_id = manager.create_async_connection(IPAddress::from_string("::1").value(), acceptor.local_port());
+    } catch (const std::exception&) {
+        acceptor.stop_listening();
+        origin.join();
+        return TestResult(false, "Could not connect to loopback origin", std::chrono::milliseconds(0));
+    }
+
+    ObjectRequest request;
+    request.host = "cdn.example";
+    request.key = "/assets/logo.svg";
+    bool sent = send_message(manager, connection_id, request, 42);
+
+    std::vector<std::byte> payload;
+    auto header = manager.receive_galaxycdn_frame(connection_id, payload);
+    origin.join();
+    if (!sent || !header || header->request_id != 42 || !origin_ok) {
+        return TestResult(false, "Request/response exchange failed", std::chrono::milliseconds(0));
+    }
+
+    auto response = view_message<ObjectResponse>(*header, payload);
+    if (!response || response->get<&ObjectResponse::status>() != 200) {
+        return TestResult(false, "Response failed validation", std::chrono::milliseconds(0));
+    }
+    auto body = response->get<&ObjectResponse::body>().bytes();
+    std::string_view text(reinterpret_cast<const char*>(body.data()), body.size());
+    return assert_true(text == "/assets/logo.svg", "Response body echoes the requested key");
+}
+
+inline auto run_reflection_tests() -> bool {
+    TestSuite suite("Reflection Serializer Tests");
+
+    suite.add_test("Binary Round Trip", test_reflection_binary_round_trip);
+    suite.add_test("JSON Round Trip", test_reflection_json_round_trip);
+    suite.add_test("Malformed Input", test_reflection_rejects_malformed_input);
+    suite.add_test("Message View In Place", test_message_view_reads_in_place);
+    suite.add_test("Message View Schema Evolution", test_message_view_schema_evolution);
+    suite.add_test("Message View Malformed Input", test_message_view_rejects_malformed);
+    suite.add_test("Message View Oversized", test_message_view_rejects_oversized);
+    suite.add_test("GalaxyCDN Messages Over Loopback", test_galaxycdn_messages_over_loopback);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
@@ -0,0 +1,220 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../src/core/acceptor.h"
+#include "../src/network/shm_transport.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace dualstack {
+namespace test {
+
+#ifndef _WIN32
+inline auto test_shm_ring_mpsc() -> TestResult {
+    using namespace network::shm;
+    ShmRingConfig config;
+    config.capacity = 4096;                 // Small, so producers wrap and wait for space constantly
+    config.mode = RingMode::mpsc;
+    auto ring = ShmRing::create(config);
+    if (!ring) {
+        return TestResult(false, "Failed to create ring", std::chrono::milliseconds(0));
+    }
+
+    // Payload bytes and length derive from producer and sequence, so the consumer can check both
+    constexpr uint32_t producers = 4;
+    constexpr uint32_t frames = 20000;
+    auto expected_length = [](uint64_t id) { return static_cast<size_t>((id * 37) % 300); };
+    std::vector<std::thread> threads;
+    std::atomic<uint32_t> failed_sends{0};
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::vector<std::byte> payload;
+            for (uint32_t i = 0; i < frames; ++i) {
+                uint64_t id = (uint64_t(p) << 32) | i;
+                payload.assign(expected_length(id), static_cast<std::byte>(id * 13));
+                if (!ring->send_frame(static_cast<uint16_t>(p), id, payload)) {
+                    ++failed_sends;
+                }
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(producers, 0);
+    bool ordered = true;
+    bool intact = true;
+    std::vector<std::byte> payload;
+    for (uint32_t received = 0; received < producers * frames; ++received) {
+        auto frame = ring->receive_frame(payload, std::chrono::milliseconds(5000));
+        if (!frame) {
+            break;
+        }
+        uint32_t p = static_cast<uint32_t>(frame->request_id >> 32);
+        uint32_t i = static_cast<uint32_t>(frame->request_id);
+        ordered &= p < producers && frame->flags == p && i == next[p];
+        next[p] = i + 1;
+        intact &= frame->magic == network::GalaxyCDN::PROTOCOL_MAGIC && payload.size() == expected_length(frame->request_id);
+        for (std::byte b : payload) {
+            intact &= b == static_cast<std::byte>(frame->request_id * 13);
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<std::byte> oversized(ring->max_payload() + 1);
+    bool refused = !ring->try_send_frame(0, 0, oversized);
+    auto empty = ring->try_receive_frame(payload);
+    auto stats = ring->get_stats();
+
+    if (!ordered || !intact || failed_sends != 0) {
+        return TestResult(false, "Frames lost, reordered within a producer, or corrupted", std::chrono::milliseconds(0));
+    }
+    return assert_true(refused && !empty && empty.error() == error_code::timeout &&
+                       stats.frames_received == producers * frames && stats.frames_sent == producers * frames,
+                       "Every frame delivered once across wrap-arounds");
+}
+
+inline auto test_shm_ring_rejects_foreign_region() -> TestResult {
+    using namespace network::shm;
+    std::FILE* file = std::tmpfile();
+    if (!file) {
+        return TestResult(false, "Failed to create a temporary file", std::chrono::milliseconds(0));
+    }
+    std::vector<char> junk(64 * 1024, 'x');
+    std::fwrite(junk.data(), 1, junk.size(), file);
+    std::fflush(file);
+    auto attached = ShmRing::attach(::dup(::fileno(file)));
+    std::fclose(file);
+    return assert_true(!attached && attached.error() == error_code::invalid_address, "A non-ring region is refused");
+}
+#endif
+
+#if defined(__linux__)
+// Request/response over whichever transport the configuration names
+inline auto run_frame_transport_exchange(network::shm::FrameTransportKind kind, double& round_trip_us) -> TestResult {
+    using namespace network::shm;
+    FrameTransportConfig config;
+    config.kind = kind;
+    config.endpoint = UnixEndpoint("@amphisbaena-frames-" +
+                                   std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    Acceptor acceptor;
+    if (acceptor.listen(config.endpoint) != error_code::success) {
+        return TestResult(false, "Failed to listen", std::chrono::milliseconds(0));
+    }
+    network::AsyncConnectionManager server_manager;
+    network::AsyncConnectionManager client_manager;
+    server_manager.initialize();
+    client_manager.initialize();
+
+    std::unique_ptr<IFrameTransport> client;
+    std::thread connector([&] {
+        if (auto connected = connect_frame_transport(client_manager, config)) {
+            client = std::move(*connected);
+        }
+    });
+    auto accepted = acceptor.accept();
+    auto server = accepted ? accept_frame_transport(server_manager, std::move(*accepted), config)
+                           : std::unexpected(error_code::accept_failed);
+    connector.join();
+    if (!server || !client) {
+        return TestResult(false, "Transport setup failed", std::chrono::milliseconds(0));
+    }
+
+    // Echo server: answers each request with its payload reversed, until the client goes away
+    std::atomic<bool> peer_gone{false};
+    std::thread echo([&] {
+        std::vector<std::byte> request;
+        for (;;) {
+            auto frame = (*server)->receive_frame(request);
+            if (!frame) {
+                peer_gone = frame.error() == error_code::receive_failed;
+                return;
+            }
+            std::reverse(request.begin(), request.end());
+            (*server)->send_frame(frame->flags, frame->request_id, request);
+        }
+    });
+
+    constexpr int iterations = 20000;
+    std::vector<std::byte> request(64);
+    std::vector<std::byte> reply;
+    bool answered = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations && answered; ++i) {
+        request.front() = static_cast<std::byte>(i);
+        request.back() = static_cast<std::byte>(i >> 8);
+        auto frame = client->send_frame(7, static_cast<uint64_t>(i), request) ? client->receive_frame(reply)
+                                                                              : std::unexpected(error_code::send_failed);
+        answered = frame && frame->request_id == static_cast<uint64_t>(i) && frame->flags == 7 &&
+                   reply.size() == request.size() && reply.front() == request.back() && reply.back() == request.front();
+    }
+    round_trip_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    // An idle server falls asleep; the next request must still wake it
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    answered = answered && client->send_frame(0, 1, request) && client->receive_frame(reply).has_value();
+
+    client.reset();
+    echo.join();
+    acceptor.stop_listening();
+    server_manager.shutdown();
+    client_manager.shutdown();
+
+    if (!answered) {
+        return TestResult(false, "Request not answered", std::chrono::milliseconds(0));
+    }
+    return assert_true(peer_gone.load(), "Server notices the client closing");
+}
+
+inline auto test_frame_transport_by_configuration() -> TestResult {
+    using namespace network::shm;
+    double socket_us = 0;
+    double shm_us = 0;
+    auto over_socket = run_frame_transport_exchange(FrameTransportKind::socket, socket_us);
+    if (!over_socket.passed) {
+        return over_socket;
+    }
+    auto over_shm = run_frame_transport_exchange(FrameTransportKind::shared_memory, shm_us);
+    if (!over_shm.passed) {
+        return over_shm;
+    }
+    std::cout << "Unix socket round trip: " << socket_us << " μs, shared-memory round trip: " << shm_us << " μs"
+              << std::endl;
+    return TestResult(true, "Same exchange over both transports", std::chrono::milliseconds(0));
+}
+#endif
+
+inline auto run_shm_transport_tests() -> bool {
+    TestSuite suite("Shared-Memory Transport Tests");
+
+#ifndef _WIN32
+    suite.add_test("MPSC Ring Delivery", test_shm_ring_mpsc);
+    suite.add_test("Foreign Region Rejected", test_shm_ring_rejects_foreign_region);
+#endif
+#if defined(__linux__)
+    suite.add_test("Transport Chosen by Configuration", test_frame_transport_by_configuration);
+#endif
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
@@ -0,0 +1,782 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ * 
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ * 
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs, 
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../src/security/signature_visualizer.h"
+#include "../src/security/signature_kernels.h"
+#include "../src/security/signature_codec.h"
+#include "../src/security/svg_writer.h"
+#include "../src/security/png_codec.h"
+#include "../src/security/signature_index.h"
+#include "../src/security/signature_store.h"
+#include "../src/security/adr_rdr.h"
+#include "../src/performance/optimization.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <optional>
+#include <random>
+#include <thread>
+#include <type_traits>
+
+namespace dualstack {
+namespace test {
+
+using dualstack::security::visualization::SignatureVisualizer;
+namespace kernels = dualstack::security::visualization::kernels;
+namespace codec = dualstack::security::visualization::codec;
+
+inline auto make_signature_inputs(std::size_t count, std::uint32_t seed = 42) -> std::vector<std::vector<std::byte>> {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    std::uniform_int_distribution<std::size_t> size_dist(0, 257);
+
+    std::vector<std::vector<std::byte>> inputs(count);
+    for (auto& input : inputs) {
+        input.resize(size_dist(gen));
+        for (auto& b : input) {
+            b = static_cast<std::byte>(byte_dist(gen));
+        }
+    }
+    return inputs;
+}
+
+inline auto same_signature(const SignatureVisualizer::VisualSignature& a,
+                           const SignatureVisualizer::VisualSignature& b) -> bool {
+    return a.points == b.points && a.colors == b.colors &&
+           a.complexity == b.complexity && a.visual_checksum == b.visual_checksum;
+}
+
+inline auto test_batch_matches_single() -> TestResult {
+    SignatureVisualizer visualizer(3.7f, 0.3f, 300);
+    auto inputs = make_signature_inputs(257);
+
+    auto batch = visualizer.generate_batch(inputs);
+    if (batch.size() != inputs.size()) {
+        return TestResult(false, "Batch size mismatch", std::chrono::milliseconds(0));
+    }
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (!same_signature(batch.signature(i), visualizer.generate_visual_signature(inputs[i]))) {
+            return TestResult(false, "Batch entry " + std::to_string(i) + " differs from single generation",
+                             std::chrono::milliseconds(0));
+        }
+    }
+
+    // Entries are laid out back to back in one arena
+    const auto& last = batch.entries.back();
+    bool contiguous = last.point_offset + last.point_count == batch.points.size() &&
+                      last.color_offset + last.color_count == batch.colors.size();
+    return assert_true(contiguous, "Arena should be exactly filled");
+}
+
+inline auto test_batch_shared_pool() -> TestResult {
+    SignatureVisualizer visualizer(3.7f, 0.3f, 100);
+    visualizer.set_thread_pool(std::make_shared<dualstack::performance::thread_pool>(2));
+
+    if (visualizer.generate_batch({}).size() != 0) {
+        return TestResult(false, "Empty batch should produce no entries", std::chrono::milliseconds(0));
+    }
+
+    auto inputs = make_signature_inputs(64, 7);
+    auto first = visualizer.generate_batch(inputs);
+    auto second = visualizer.generate_batch(inputs);
+    return assert_true(first.points == second.points && first.colors == second.colors,
+                       "Repeated batches on a shared pool should be identical");
+}
+
+inline auto test_batch_concurrent_callers() -> TestResult {
+    // No pool set: concurrent first calls must agree on one lazily created pool
+    SignatureVisualizer visualizer(3.7f, 0.3f, 100);
+    auto inputs = make_signature_inputs(64, 11);
+    auto expected = visualizer.generate_visual_signature(inputs[5]);
+
+    std::vector<SignatureVisualizer::SignatureBatch> results(4);
+    std::vector<std::thread> callers;
+    for (auto& result : results) {
+        callers.emplace_back([&visualizer, &inputs, &result] { result = visualizer.generate_batch(inputs); });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    for (const auto& result : results) {
+        if (result.size() != inputs.size() || !same_signature(result.signature(5), expected)) {
+            return TestResult(false, "Concurrent batch differs from single generation", std::chrono::milliseconds(0));
+        }
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_batch_from_pool_worker() -> TestResult {
+    // A batch started on the only worker of its own pool must not wait on
+    // tasks queued behind itself
+    auto pool = std::make_shared<dualstack::performance::thread_pool>(1);
+    SignatureVisualizer visualizer(3.7f, 0.3f, 100);
+    visualizer.set_thread_pool(pool);
+    auto inputs = make_signature_inputs(64, 13);
+    auto expected = visualizer.generate_visual_signature(inputs[9]);
+
+    auto nested = pool->enqueue([&visualizer, &inputs] { return visualizer.generate_batch(inputs); });
+    if (nested.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+        // Leak the wedged pool rather than hang joining its worker
+        new std::shared_ptr<dualstack::performance::thread_pool>(pool);
+        return TestResult(false, "Batch on a pool worker deadlocked", std::chrono::milliseconds(0));
+    }
+    auto batch = nested.get();
+    return assert_true(batch.size() == inputs.size() && same_signature(batch.signature(9), expected),
+                       "Batch on a pool worker should match single generation");
+}
+
+inline auto test_visualizer_copyable() -> TestResult {
+    static_assert(std::is_copy_constructible_v<SignatureVisualizer>);
+    static_assert(std::is_copy_assignable_v<SignatureVisualizer>);
+
+    SignatureVisualizer original(3.7f, 0.3f, 100);
+    original.set_thread_pool(std::make_shared<dualstack::performance::thread_pool>(2));
+    auto inputs = make_signature_inputs(32, 17);
+
+    SignatureVisualizer copy(original);
+    SignatureVisualizer assigned;
+    assigned = original;
+    auto expected = original.generate_batch(inputs);
+    auto from_copy = copy.generate_batch(inputs);
+    auto from_assigned = assigned.generate_batch(inputs);
+    return assert_true(expected.points == from_copy.points && expected.colors == from_copy.colors &&
+                       expected.points == from_assigned.points && expected.colors == from_assigned.colors,
+                       "Copies should generate the same batches as the original");
+}
+
+// Runs fn once with the scalar reference and once with the detected ISA
+template<typename Fn>
+inline auto run_on_both_isas(Fn&& fn) {
+    kernels::set_active_isa(kernels::KernelIsa::scalar);
+    auto reference = fn();
+    kernels::set_active_isa(kernels::detected_isa());
+    auto vectorized = fn();
+    return std::make_pair(reference, vectorized);
+}
+
+inline auto test_kernels_match_reference() -> TestResult {
+    SignatureVisualizer visualizer(3.7f, 0.3f, 1003);   // Not a multiple of the lane count
+    auto inputs = make_signature_inputs(32, 99);
+    inputs.push_back(std::vector<std::byte>(1029, std::byte{0xA5}));
+
+    auto [scalar_sigs, vector_sigs] = run_on_both_isas([&] {
+        std::vector<SignatureVisualizer::VisualSignature> sigs;
+        for (const auto& input : inputs) {
+            sigs.push_back(visualizer.generate_visual_signature(input));
+        }
+        return sigs;
+    });
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (!same_signature(scalar_sigs[i], vector_sigs[i])) {
+            return TestResult(false, "Vector kernels differ from scalar reference on input " + std::to_string(i),
+                             std::chrono::milliseconds(0));
+        }
+    }
+
+    auto [scalar_soa, vector_soa] = run_on_both_isas([&] { return visualizer.chaotic_map_soa(1003); });
+    if (scalar_soa.x != vector_soa.x || scalar_soa.y != vector_soa.y ||
+        vector_soa.to_points() != vector_sigs[0].points) {
+        return TestResult(false, "SoA orbit differs from interleaved orbit", std::chrono::milliseconds(0));
+    }
+
+    // Coordinates beyond the int32 range take the reference path inside the vector checksum
+    SignatureVisualizer::VisualSignature odd = vector_sigs[0];
+    odd.points[3] = {3.0e6f, 7.25f};
+    odd.points[17] = {2.5e7f, 0.0f};
+    auto [scalar_sum, vector_sum] = run_on_both_isas([&] {
+        return SignatureVisualizer::SecureDataReader({}, {}).verify_integrity(odd);
+    });
+    return assert_true(scalar_sum == vector_sum, "Checksum must not depend on the ISA");
+}
+
+inline auto test_color_round_trip() -> TestResult {
+    for (std::size_t size : {0u, 1u, 3u, 4u, 31u, 32u, 33u, 255u, 1024u}) {
+        auto data = make_signature_inputs(1, static_cast<std::uint32_t>(size))[0];
+        data.resize(size, std::byte{0x5A});
+
+        SignatureVisualizer visualizer(3.7f, 0.3f, 8);
+        auto sig = visualizer.generate_visual_signature(data);
+        if (sig.colors.size() != (size + 3) / 4) {
+            return TestResult(false, "Wrong color count for " + std::to_string(size) + " bytes",
+                             std::chrono::milliseconds(0));
+        }
+        for (std::size_t i = 0; i + 4 <= size; i += 4) {
+            std::uint32_t expected = (static_cast<std::uint32_t>(data[i + 3]) << 24) |
+                                     (static_cast<std::uint32_t>(data[i]) << 16) |
+                                     (static_cast<std::uint32_t>(data[i + 1]) << 8) |
+                                     static_cast<std::uint32_t>(data[i + 2]);
+            if (sig.colors[i / 4] != expected) {
+                return TestResult(false, "Color packing mismatch", std::chrono::milliseconds(0));
+            }
+        }
+
+        std::vector<std::byte> decoded(sig.colors.size() * 4);
+        kernels::decode_colors(sig.colors, decoded);
+        if (!std::equal(data.begin(), data.end(), decoded.begin())) {
+            return TestResult(false, "Decode does not invert encode for " + std::to_string(size) + " bytes",
+                             std::chrono::milliseconds(0));
+        }
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+inline auto test_binary_round_trip() -> TestResult {
+    SignatureVisualizer visualizer(3.7f, 0.3f, 200);
+    auto sig = visualizer.generate_visual_signature(make_signature_inputs(1, 7)[0]);
+
+    // Known CRC-32 check value
+    const char* check = "123456789";
+    if (codec::crc32(std::as_bytes(std::span(check, 9))) != 0xCBF43926u) {
+        return TestResult(false, "CRC-32 check value mismatch", std::chrono::milliseconds(0));
+    }
+
+    // Encode into a caller buffer; too small a buffer is rejected without writing
+    std::vector<std::uint32_t> storage((codec::encoded_size(sig) + 3) / 4);
+    auto buffer = std::as_writable_bytes(std::span(storage));
+    if (codec::serialize(sig, buffer.first(codec::encoded_size(sig) - 1)).error() != codec::CodecError::buffer_too_small) {
+        return TestResult(false, "Short buffer should be rejected", std::chrono::milliseconds(0));
+    }
+    auto written = codec::serialize(sig, buffer);
+    if (!written || *written != codec::encoded_size(sig) ||
+        *written != codec::SIGNATURE_HEADER_SIZE + sig.points.size() * 8 + sig.colors.size() * 4) {
+        return TestResult(false, "Unexpected encoded size", std::chrono::milliseconds(0));
+    }
+    auto encoded = std::span<const std::byte>(buffer.first(*written));
+
+    // The view reads the caller's buffer in place
+    auto view = codec::view(encoded);
+    if (!view) {
+        return TestResult(false, std::string("View failed: ") + codec::describe(view.error()),
+                         std::chrono::milliseconds(0));
+    }
+    if (reinterpret_cast<const std::byte*>(view->points.data()) != encoded.data() + codec::SIGNATURE_HEADER_SIZE) {
+        return TestResult(false, "View should not copy the payload", std::chrono::milliseconds(0));
+    }
+    if (!same_signature(view->to_signature(), sig)) {
+        return TestResult(false, "View does not match the source signature", std::chrono::milliseconds(0));
+    }
+
+    // Owning decode works from any offset
+    std::vector<std::byte> shifted(encoded.size() + 1);
+    std::copy(encoded.begin(), encoded.end(), shifted.begin() + 1);
+    auto unaligned = std::span<const std::byte>(shifted).subspan(1);
+    auto decoded = codec::deserialize(unaligned);
+    if (!decoded || !same_signature(*decoded, sig)) {
+        return TestResult(false, "Decode of an unaligned copy failed", std::chrono::milliseconds(0));
+    }
+    return assert_true(codec::serialize(sig) == std::vector<std::byte>(encoded.begin(), encoded.end()),
+                       "Vector and span encoders should agree");
+}
+
+inline auto test_binary_rejects_corruption() -> TestResult {
+    SignatureVisualizer visualizer(3.7f, 0.3f, 64);
+    auto encoded = codec::serialize(visualizer.generate_visual_signature(make_signature_inputs(1, 3)[0]));
+
+    auto expect_error = [&](std::vector<std::byte> data, codec::CodecError expected) {
+        auto decoded = codec::deserialize(data);
+        return !decoded && decoded.error() == expected;
+    };
+
+    auto flipped = encoded;
+    flipped.back() ^= std::byte{0x01};
+    auto bad_magic = encoded;
+    bad_magic[0] = std::byte{'X'};
+    auto future = encoded;
+    future[4] = std::byte{2};
+    auto truncated = encoded;
+    truncated.resize(encoded.size() - 4);
+
+    bool ok = expect_error(flipped, codec::CodecError::checksum_mismatch) &&
+              expect_error(bad_magic, codec::CodecError::bad_magic) &&
+              expect_error(future, codec::CodecError::unsupported_version) &&
+              expect_error(truncated, codec::CodecError::truncated) &&
+              expect_error({encoded.begin(), encoded.begin() + 12}, codec::CodecError::truncated);
+    return assert_true(ok, "Corrupt encodings should be rejected with the matching error");
+}
+
+inline auto count_occurrences(const std::string& text, std::string_view needle) -> std::size_t {
+    std::size_t count = 0;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+inline auto test_svg_streaming_matches_buffer() -> TestResult {
+    using dualstack::security::visualization::SvgWriter;
+    using dualstack::security::visualization::SvgOptions;
+
+    SignatureVisualizer visualizer(3.7f, 0.3f, 1000);
+    auto sig = visualizer.generate_visual_signature(make_signature_inputs(1, 11)[0]);
+    sig.colors.resize(sig.points.size(), 0xFF102030u);  // Trailing run shares one color
+
+    for (bool compact : {false, true}) {
+        SvgOptions options;
+        options.compact_path = compact;
+        SvgWriter writer(options);
+
+        std::string buffered;
+        writer.render(sig, buffered);
+
+        std::string streamed;
+        std::size_t chunks = 0;
+        bool complete = writer.render(sig, [&](std::string_view chunk) {
+            streamed.append(chunk);
+            ++chunks;
+            return true;
+        }, 1024);
+        if (!complete || streamed != buffered || chunks < 2) {
+            return TestResult(false, "Chunked output differs from buffered output", std::chrono::milliseconds(0));
+        }
+        if (buffered.size() > writer.estimate_size(sig) * 2) {
+            return TestResult(false, "Size estimate far below actual output", std::chrono::milliseconds(0));
+        }
+        if (buffered.rfind("</svg>\n") != buffered.size() - 7) {
+            return TestResult(false, "Document not terminated", std::chrono::milliseconds(0));
+        }
+
+        // One element per point, or one path per color run
+        std::size_t expected_elements = compact ? 0 : sig.points.size();
+        if (compact) {
+            for (std::size_t i = 0; i < sig.colors.size(); ++i) {
+                expected_elements += i == 0 || (sig.colors[i] & 0xFFFFFF) != (sig.colors[i - 1] & 0xFFFFFF);
+            }
+        }
+        if (count_occurrences(buffered, compact ? "<path " : "<circle ") != expected_elements) {
+            return TestResult(false, "Unexpected element count", std::chrono::milliseconds(0));
+        }
+    }
+
+    std::size_t calls = 0;
+    bool aborted = !SvgWriter().render(sig, [&](std::string_view) { return ++calls < 2; }, 1024);
+    return assert_true(aborted && calls == 2, "Sink abort should stop rendering");
+}
+
+inline auto test_png_round_trip() -> TestResult {
+    namespace png = dualstack::security::visualization::png;
+
+    SignatureVisualizer visualizer(3.7f, 0.3f, 1000);
+    auto sig = visualizer.generate_visual_signature(make_signature_inputs(1, 19)[0]);
+    for (auto& point : sig.points) {
+        point = {point[0] * 0.3f + 0.3f, point[1] * 0.3f + 0.3f};  // Keep the orbit on canvas
+    }
+
+    auto encoded = visualizer.to_png(sig, 320, 200);
+    png::Image expected;
+    png::rasterize(sig, 320, 200, expected);
+
+    // Whole buffer, then fed in small uneven pieces
+    auto decoded = png::decode(encoded);
+    if (!decoded) {
+        return TestResult(false, std::string("Decode failed: ") + png::describe(decoded.error()),
+                         std::chrono::milliseconds(0));
+    }
+    png::PngDecoder incremental;
+    bool complete = false;
+    for (std::size_t offset = 0; offset < encoded.size(); offset += 7) {
+        auto piece = std::span<const std::byte>(encoded).subspan(offset, std::min<std::size_t>(7, encoded.size() - offset));
+        auto result = incremental.feed(piece);
+        if (!result) {
+            return TestResult(false, "Incremental decode failed", std::chrono::milliseconds(0));
+        }
+        complete = *result;
+    }
+
+    bool pixels_match = decoded->image.width == 320 && decoded->image.height == 200 &&
+                        decoded->image.pixels == expected.pixels &&
+                        complete && incremental.image().pixels == expected.pixels;
+    auto blank = static_cast<std::size_t>(std::count(expected.pixels.begin(), expected.pixels.end(), 0u));
+    if (!pixels_match || blank == expected.pixels.size()) {
+        return TestResult(false, "Decoded pixels differ from the rasterized signature", std::chrono::milliseconds(0));
+    }
+
+    // A raster much larger than the 32 KiB deflate window, streamed in IDAT-sized pieces
+    auto large = visualizer.to_png(sig, 1024, 768);
+    png::Image large_expected;
+    png::rasterize(sig, 1024, 768, large_expected);
+    png::PngDecoder streaming;
+    for (std::size_t offset = 0; offset < large.size(); offset += 4096) {
+        auto piece = std::span<const std::byte>(large).subspan(offset, std::min<std::size_t>(4096, large.size() - offset));
+        if (!streaming.feed(piece)) {
+            return TestResult(false, "Streaming decode of a large image failed", std::chrono::milliseconds(0));
+        }
+    }
+    if (!streaming.done() || streaming.image().pixels != large_expected.pixels) {
+        return TestResult(false, "Streamed large image differs from the raster", std::chrono::milliseconds(0));
+    }
+
+    auto embedded = codec::deserialize(decoded->signature_chunk);
+    return assert_true(embedded && same_signature(*embedded, sig), "Embedded signature should round trip exactly");
+}
+
+inline auto test_png_inflate_compatibility() -> TestResult {
+    namespace png = dualstack::security::visualization::png;
+
+    // zlib level 9 output for 400 bytes over "abcd ": a dynamic Huffman block
+    const std::uint8_t dynamic_stream[] = {
+        0x78, 0xda, 0x45, 0x50, 0x89, 0x11, 0x04, 0x31, 0x08, 0x6a, 0x85, 0xd6, 0x04, 0xfb, 0xaf, 0xe1,
+        0x00, 0x33, 0x7b, 0xfb, 0x44, 0x45, 0x03, 0x24, 0xe4, 0xec, 0xf8, 0x21, 0x46, 0x89, 0x62, 0x63,
+        0xb1, 0xe2, 0x7c, 0x28, 0x0d, 0x33, 0x65, 0x16, 0x82, 0x03, 0x14, 0x90, 0x9b, 0x7a, 0xf3, 0xeb,
+        0xce, 0x66, 0x46, 0xdd, 0xd8, 0x8f, 0x47, 0x3e, 0x87, 0x6d, 0xc8, 0xc1, 0x2b, 0xcd, 0x9a, 0x7f,
+        0x67, 0x61, 0x42, 0x22, 0x50, 0x9b, 0xf8, 0xcb, 0xf0, 0x4a, 0x86, 0x9a, 0xcc, 0xf4, 0x63, 0x8c,
+        0x88, 0x9a, 0x57, 0x1b, 0xe7, 0x36, 0x51, 0x1b, 0xaf, 0xf5, 0xe6, 0xe4, 0x31, 0x79, 0x5c, 0xf6,
+        0x36, 0x42, 0x5b, 0xc5, 0xa5, 0xc8, 0xc1, 0x6b, 0x94, 0x6e, 0x0d, 0x81, 0x8f, 0xf0, 0x9c, 0xa0,
+        0x66, 0x8d, 0x77, 0x57, 0x58, 0x9e, 0x7c, 0x34, 0x25, 0xf8, 0x4d, 0x6e, 0x3e, 0xd6, 0x37, 0xee,
+        0xf6, 0x3a, 0xa2, 0xd3, 0xfa, 0xa6, 0x9b, 0xea, 0xa8, 0x13, 0x91, 0x53, 0x9e, 0xbd, 0xbb, 0xe6,
+        0x5e, 0xce, 0x0f, 0x5f, 0xbd, 0x8f, 0xba};
+
+    std::vector<std::byte> out(400);
+    auto produced = png::inflate(std::as_bytes(std::span(dynamic_stream)), out);
+    std::string text(reinterpret_cast<const char*>(out.data()), 20);
+    if (!produced || *produced != 400 || text != "bbadaaaab acaaaacbac") {
+        return TestResult(false, "Dynamic Huffman stream decoded incorrectly", std::chrono::milliseconds(0));
+    }
+
+    // Our own deflate round-trips, and flipping a bit is caught
+    auto input = make_signature_inputs(1, 23)[0];
+    input.resize(5000, std::byte{0});
+    std::vector<std::byte> compressed;
+    png::deflate_fast(input, compressed);
+    std::vector<std::byte> restored(input.size());
+    auto round_trip = png::inflate(compressed, restored);
+    bool restored_ok = round_trip && *round_trip == input.size() && restored == input;
+    compressed[compressed.size() / 2] ^= std::byte{0x10};
+    auto corrupted = png::inflate(compressed, restored);
+
+    const char* check = "Wikipedia";
+    return assert_true(restored_ok && !corrupted &&
+                       png::adler32(std::as_bytes(std::span(check, 9))) == 0x11E60398u,
+                       "Deflate round trip and Adler-32 check value");
+}
+
+inline auto test_png_rejects_corruption() -> TestResult {
+    namespace png = dualstack::security::visualization::png;
+
+    SignatureVisualizer visualizer(3.7f, 0.3f, 64);
+    auto encoded = visualizer.to_png(visualizer.generate_visual_signature(make_signature_inputs(1, 29)[0]), 64, 64);
+
+    auto flipped = encoded;
+    flipped[encoded.size() - 20] ^= std::byte{0x01};  // Inside the IDAT payload
+    auto truncated = std::span<const std::byte>(encoded).first(encoded.size() - 12);
+    auto not_png = std::span<const std::byte>(encoded).subspan(1);
+
+    auto error_of = [](std::span<const std::byte> data) -> std::optional<png::PngError> {
+        auto result = png::decode(data);
+        if (result) {
+            return std::nullopt;
+        }
+        return result.error();
+    };
+    // 8192 x 8192 passes the per-side limit but not the pixel budget
+    auto oversized = encoded;
+    for (std::size_t offset : {16u, 20u}) {
+        oversized[offset + 2] = std::byte{0x20};
+        oversized[offset + 3] = std::byte{0x00};
+    }
+    auto header_crc = codec::crc32(std::span<const std::byte>(oversized).subspan(12, 17));
+    for (int i = 0; i < 4; ++i) {
+        oversized[29 + static_cast<std::size_t>(i)] = static_cast<std::byte>(header_crc >> (24 - 8 * i));
+    }
+
+    bool ok = error_of(flipped) == png::PngError::crc_mismatch &&
+              error_of(truncated) == png::PngError::truncated &&
+              error_of(not_png) == png::PngError::invalid_signature &&
+              error_of(oversized) == png::PngError::too_large;
+    return assert_true(ok, "Corrupt PNGs should be rejected with the matching error");
+}
+
+inline auto make_random_signature(std::mt19937& gen, std::size_t points, std::size_t colors)
+    -> SignatureVisualizer::VisualSignature {
+    std::uniform_real_distribution<float> coord(0.0f, 1.0f);
+    std::uniform_int_distribution<std::uint32_t> color(0, 0xFFFFFF);
+    SignatureVisualizer::VisualSignature sig{};
+    for (std::size_t i = 0; i < points; ++i) {
+        sig.points.push_back({coord(gen), coord(gen)});
+    }
+    for (std::size_t i = 0; i < colors; ++i) {
+        sig.colors.push_back(0xFF000000u | color(gen));
+    }
+    return sig;
+}
+
+// Copy of sig with every point moved by (offset, offset) and every channel raised by up to shade
+inline auto perturbed(SignatureVisualizer::VisualSignature sig, float offset, std::uint32_t shade)
+    -> SignatureVisualizer::VisualSignature {
+    for (auto& point : sig.points) {
+        point[0] += offset;
+        point[1] += offset;
+    }
+    for (auto& color : sig.colors) {
+        std::uint32_t r = std::min<std::uint32_t>(((color >> 16) & 0xFF) + shade, 255);
+        std::uint32_t g = std::min<std::uint32_t>(((color >> 8) & 0xFF) + shade, 255);
+        std::uint32_t b = std::min<std::uint32_t>((color & 0xFF) + shade, 255);
+        color = (color & 0xFF000000u) | (r << 16) | (g << 8) | b;
+    }
+    return sig;
+}
+
+inline auto test_comparison_kernels() -> TestResult {
+    std::mt19937 gen(7);
+    for (std::size_t n : {0, 1, 7, 8, 9, 63, 64, 65, 301}) {
+        auto a = make_random_signature(gen, n, 0);
+        auto near = perturbed(a, 0.05f, 0);
+        auto far = perturbed(a, 0.05f, 0);
+        if (n != 0) {
+            far.points[n - 1][1] += 1.0f;   // Only the last point (the scalar tail) is out of range
+        }
+        auto soa_a = SignatureVisualizer::PointSoA::from_points(a.points);
+        auto soa_far = SignatureVisualizer::PointSoA::from_points(far.points);
+
+        auto [scalar, vectorized] = run_on_both_isas([&] {
+            return std::make_tuple(kernels::points_within(a.points, near.points, 0.1f * 0.1f),
+                                   kernels::points_within(a.points, far.points, 0.1f * 0.1f),
+                                   kernels::points_within_soa(soa_a.x, soa_a.y, soa_far.x, soa_far.y, 0.1f * 0.1f),
+                                   kernels::distance_sum(a.points, far.points),
+                                   kernels::distance_sum_soa(soa_a.x, soa_a.y, soa_far.x, soa_far.y));
+        });
+        float expected_sum = 0.0f;
+        for (std::size_t i = 0; i < n; ++i) {
+            float dx = a.points[i][0] - far.points[i][0];
+            float dy = a.points[i][1] - far.points[i][1];
+            expected_sum += std::sqrt(dx * dx + dy * dy);
+        }
+        for (const auto& result : {scalar, vectorized}) {
+            auto [within_near, within_far, within_far_soa, sum, sum_soa] = result;
+            bool ok = within_near && within_far == (n == 0) && within_far_soa == (n == 0) &&
+                      std::abs(sum - expected_sum) <= 1e-4f * (1.0f + expected_sum) &&
+                      std::abs(sum_soa - expected_sum) <= 1e-4f * (1.0f + expected_sum);
+            if (!ok) {
+                return TestResult(false, "Comparison kernels disagree with scalar math for " + std::to_string(n) +
+                                  " points", std::chrono::milliseconds(0));
+            }
+        }
+    }
+
+    // A budget lets the sum stop early, but only ever above the budget
+    auto a = make_random_signature(gen, 1000, 0);
+    auto b = make_random_signature(gen, 1000, 0);
+    float full = kernels::distance_sum(a.points, b.points);
+    float capped = kernels::distance_sum(a.points, b.points, full / 4);
+    return assert_true(capped > full / 4 && capped < full, "Budgeted distance sum should stop early");
+}
+
+inline auto test_reference_set_search() -> TestResult {
+    using dualstack::security::visualization::SignatureReferenceSet;
+    std::mt19937 gen(11);
+    SignatureReferenceSet references(0.1f);
+    std::vector<SignatureVisualizer::VisualSignature> stored;
+    for (std::size_t i = 0; i < 400; ++i) {
+        stored.push_back(make_random_signature(gen, 300, 75));
+        references.add(stored.back());
+    }
+    references.add(make_random_signature(gen, 120, 30));   // Different size, never a candidate
+
+    auto probe = perturbed(stored[271], 0.03f, 9);
+    SignatureVisualizer::VisualPassword password(0.1f);
+    password.set_reference(stored[271]);
+
+    SignatureReferenceSet::SearchStats stats;
+    auto found = references.authenticate(probe, &stats);
+    if (!password.authenticate(probe) || found != std::optional<std::size_t>(271)) {
+        return TestResult(false, "Reference set should find the perturbed reference", std::chrono::milliseconds(0));
+    }
+    if (stats.candidates != 272 || stats.sketch_passed > 5) {
+        return TestResult(false, "Color sketch should prune nearly every candidate (" +
+                          std::to_string(stats.sketch_passed) + " passed)", std::chrono::milliseconds(0));
+    }
+
+    auto nearest = references.nearest(probe, 0.5f);
+    if (!nearest || nearest->index != 271 ||
+        std::abs(nearest->score - password.get_similarity_score(probe)) > 1e-4f) {
+        return TestResult(false, "Nearest reference should carry VisualPassword's score", std::chrono::milliseconds(0));
+    }
+
+    auto stranger = make_random_signature(gen, 300, 75);
+    bool rejected = !references.authenticate(stranger) && !references.nearest(stranger, 0.5f) &&
+                    !references.authenticate(make_random_signature(gen, 299, 75));
+    return assert_true(rejected, "Unknown signatures should not match any reference");
+}
+
+inline auto test_signature_store() -> TestResult {
+    using namespace dualstack::security::visualization;
+    std::string path = (std::filesystem::temp_directory_path() / "amphisbaena_test_signatures.avst").string();
+    std::filesystem::remove(path);
+
+    SignatureVisualizer visualizer(3.7f, 0.3f, 200);
+    auto inputs = make_signature_inputs(40, 5);
+    std::vector<SignatureVisualizer::VisualSignature> sigs;
+    for (const auto& input : inputs) {
+        sigs.push_back(visualizer.generate_visual_signature(input));
+    }
+
+    {
+        auto writer = SignatureStoreWriter::open(path);
+        if (!writer) {
+            return TestResult(false, "Cannot create store", std::chrono::milliseconds(0));
+        }
+        for (std::size_t i = 0; i < 30; ++i) {
+            (void)(*writer)->append(sigs[i]);
+        }
+    }
+
+    auto store = SignatureStore::open(path, 4);
+    if (!store || (*store)->size() != 30 || !(*store)->indexed()) {
+        return TestResult(false, "Store should reopen through its index", std::chrono::milliseconds(0));
+    }
+    auto& reader = **store;
+    for (std::size_t i : {7, 7, 29, 0, 7}) {
+        auto sig = reader.get(i);
+        if (!sig || !same_signature(**sig, sigs[i]) || !reader.view(i)) {
+            return TestResult(false, "Stored record " + std::to_string(i) + " differs", std::chrono::milliseconds(0));
+        }
+    }
+    auto stats = reader.cache_stats();
+    if (stats.hits != 2 || stats.misses != 3 || reader.get(30).has_value()) {
+        return TestResult(false, "LRU should serve repeated reads", std::chrono::milliseconds(0));
+    }
+
+    // Appending again: readers see new records after refresh()
+    {
+        auto writer = SignatureStoreWriter::open(path);
+        for (std::size_t i = 30; i < 35; ++i) {
+            (void)(*writer)->append(sigs[i]);
+        }
+    }
+    auto refreshed = reader.refresh();
+    auto last = reader.get(34);
+    if (!refreshed || *refreshed != 35 || !last || !same_signature(**last, sigs[34])) {
+        return TestResult(false, "Refresh should pick up appended records", std::chrono::milliseconds(0));
+    }
+
+    // A damaged index (writer stopped mid-append) falls back to walking the records
+    {
+        std::fstream raw(path, std::ios::in | std::ios::out | std::ios::binary);
+        raw.seekp(-1, std::ios::end);
+        raw.put('\0');
+    }
+    auto scanned = SignatureStore::open(path);
+    if (!scanned || (*scanned)->indexed() || (*scanned)->size() != 35 ||
+        !same_signature(**(*scanned)->get(34), sigs[34])) {
+        return TestResult(false, "Record scan should recover every record", std::chrono::milliseconds(0));
+    }
+    {
+        auto writer = SignatureStoreWriter::open(path);
+        (void)(*writer)->append(sigs[35]);
+    }
+    auto repaired = SignatureStore::open(path);
+    if (!repaired || !(*repaired)->indexed() || (*repaired)->size() != 36) {
+        return TestResult(false, "Appending after a scan should write a fresh index", std::chrono::milliseconds(0));
+    }
+
+    ADRReader adr({}, {});
+    auto opened = adr.open_signature_store(path);
+    auto result = adr.read_stored_signature(12);
+    bool ok = opened && *opened == 36 && result.success && same_signature(result.signature, sigs[12]) &&
+              !adr.read_stored_signature(99).success;
+    std::filesystem::remove(path);
+    return assert_true(ok, "ADRReader should read records from the store");
+}
+
+inline auto test_signature_store_concurrent_refresh() -> TestResult {
+    using namespace dualstack::security::visualization;
+    std::string path = (std::filesystem::temp_directory_path() / "amphisbaena_test_refresh.avst").string();
+    std::filesystem::remove(path);
+
+    SignatureVisualizer visualizer(3.7f, 0.3f, 200);
+    auto inputs = make_signature_inputs(24, 9);
+    std::vector<SignatureVisualizer::VisualSignature> sigs;
+    for (const auto& input : inputs) {
+        sigs.push_back(visualizer.generate_visual_signature(input));
+    }
+
+    auto writer = SignatureStoreWriter::open(path);
+    if (!writer) {
+        return TestResult(false, "Cannot create store", std::chrono::milliseconds(0));
+    }
+    (void)(*writer)->append(sigs[0]);
+    (void)(*writer)->flush();
+
+    auto store = SignatureStore::open(path, 0);
+    if (!store) {
+        return TestResult(false, "Cannot open store", std::chrono::milliseconds(0));
+    }
+    auto& reader = **store;
+    auto early = reader.view(0);
+
+    // Readers keep decoding while the writer appends and the store remaps
+    std::atomic<bool> done{false};
+    std::atomic<bool> mismatch{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                std::size_t count = reader.size();
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto record = reader.view(i);
+                    if (!record || !same_signature(record->to_signature(), sigs[i])) {
+                        mismatch = true;
+                    }
+                }
+            }
+        });
+    }
+    bool refreshed = true;
+    for (std::size_t i = 1; i < sigs.size(); ++i) {
+        (void)(*writer)->append(sigs[i]);
+        (void)(*writer)->flush();
+        auto count = reader.refresh();
+        refreshed = refreshed && count && *count == i + 1;
+    }
+    done = true;
+    for (auto& thread : readers) {
+        thread.join();
+    }
+
+    // A view taken before any refresh still points at live memory
+    bool early_valid = early && same_signature(early->to_signature(), sigs[0]);
+    writer->reset();
+    std::filesystem::remove(path);
+    return assert_true(refreshed && !mismatch && early_valid,
+                       "Views and reads should stay valid across concurrent refresh()");
+}
+
+inline auto run_signature_visualizer_tests() -> bool {
+    TestSuite suite("Signature Visualizer Tests");
+
+    suite.add_test("Batch Matches Single", test_batch_matches_single);
+    suite.add_test("Batch Shared Pool", test_batch_shared_pool);
+    suite.add_test("Batch Concurrent Callers", test_batch_concurrent_callers);
+    suite.add_test("Batch From Pool Worker", test_batch_from_pool_worker);
+    suite.add_test("Visualizer Copyable", test_visualizer_copyable);
+    suite.add_test("Kernels Match Reference", test_kernels_match_reference);
+    suite.add_test("Color Round Trip", test_color_round_trip);
+    suite.add_test("Binary Round Trip", test_binary_round_trip);
+    suite.add_test("Binary Rejects Corruption", test_binary_rejects_corruption);
+    suite.add_test("SVG Streaming Matches Buffer", test_svg_streaming_matches_buffer);
+    suite.add_test("PNG Round Trip", test_png_round_trip);
+    suite.add_test("PNG Inflate Compatibility", test_png_inflate_compatibility);
+    suite.add_test("PNG Rejects Corruption", test_png_rejects_corruption);
+    suite.add_test("Comparison Kernels", test_comparison_kernels);
+    suite.add_test("Reference Set Search", test_reference_set_search);
+    suite.add_test("Signature Store", test_signature_store);
+    suite.add_test("Signature Store Concurrent Refresh", test_signature_store_concurrent_refresh);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
@@ -0,0 +1,332 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "../include/dualstack_net26/network/virtual_adapter.h"
+#include <cstring>
+#include <vector>
+
+namespace dualstack {
+namespace test {
+
+inline auto siit_v6(const char* text) -> ipv6_address {
+    return IPAddress::from_string(text).value().get_ipv6();
+}
+
+inline auto siit_v4(const char* text) -> ipv4_address {
+    return IPAddress::from_string(text).value().get_ipv4();
+}
+
+// Full one's-complement sum, as a receiver would verify it
+inline auto siit_sum(const std::byte* data, size_t length, uint64_t sum = 0) -> uint64_t {
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        sum += (std::to_integer<uint64_t>(data[i]) << 8) | std::to_integer<uint64_t>(data[i + 1]);
+    }
+    if (length % 2) {
+        sum += std::to_integer<uint64_t>(data[length - 1]) << 8;
+    }
+    return sum;
+}
+
+inline auto siit_fold(uint64_t sum) -> uint16_t {
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(sum);
+}
+
+inline auto siit_put16(std::byte* p, uint16_t value) -> void {
+    p[0] = static_cast<std::byte>(value >> 8);
+    p[1] = static_cast<std::byte>(value);
+}
+
+inline auto siit_get16(const std::byte* p) -> uint16_t {
+    return static_cast<uint16_t>((std::to_integer<unsigned>(p[0]) << 8) | std::to_integer<unsigned>(p[1]));
+}
+
+// Offset of the checksum within a transport header; 0 when it has none we check
+inline auto siit_checksum_offset(uint8_t protocol) -> size_t {
+    return protocol == 6 ? 16 : protocol == 17 ? 6 : (protocol == 1 || protocol == 58) ? 2 : 0;
+}
+
+inline auto build_ipv4_packet(const ipv4_address& source, const ipv4_address& destination, uint8_t protocol,
+                              std::vector<std::byte> transport, uint8_t ttl = 64, uint16_t fragment_field = 0x4000,
+                              bool fill_checksum = true) -> std::vector<std::byte> {
+    std::vector<std::byte> packet(20 + transport.size());
+    std::byte* p = packet.data();
+    p[0] = std::byte{0x45};
+    p[1] = std::byte{0x28};                                 // Traffic class carried through
+    siit_put16(p + 2, static_cast<uint16_t>(packet.size()));
+    siit_put16(p + 4, 0x1234);
+    siit_put16(p + 6, fragment_field);
+    p[8] = static_cast<std::byte>(ttl);
+    p[9] = static_cast<std::byte>(protocol);
+    for (int i = 0; i < 4; ++i) {
+        p[12 + i] = static_cast<std::byte>(source.address >> (24 - i * 8));
+        p[16 + i] = static_cast<std::byte>(destination.address >> (24 - i * 8));
+    }
+    siit_put16(p + 10, static_cast<uint16_t>(~siit_fold(siit_sum(p, 20))));
+
+    size_t at = siit_checksum_offset(protocol);
+    if (fill_checksum && at != 0 && transport.size() >= at + 2) {
+        uint64_t pseudo = protocol == 1 ? 0 : siit_sum(p + 12, 8) + protocol + transport.size();
+        siit_put16(transport.data() + at, 0);
+        uint16_t checksum = static_cast<uint16_t>(~siit_fold(siit_sum(transport.data(), transport.size(), pseudo)));
+        siit_put16(transport.data() + at, protocol == 17 && checksum == 0 ? 0xFFFF : checksum);
+    }
+    std::memcpy(p + 20, transport.data(), transport.size());
+    return packet;
+}
+
+inline auto siit_transport(size_t length, uint8_t first = 0) -> std::vector<std::byte> {
+    std::vector<std::byte> transport(length);
+    for (size_t i = 0; i < length; ++i) {
+        transport[i] = static_cast<std::byte>(first + i * 7);
+    }
+    return transport;
+}
+
+// Transport checksum of an IPv6 packet verified from scratch; skips a Fragment header
+inline auto ipv6_transport_valid(std::span<const std::byte> packet) -> bool {
+    uint8_t next = std::to_integer<uint8_t>(packet[6]);
+    size_t offset = 40;
+    if (next == 44) {
+        next = std::to_integer<uint8_t>(packet[40]);
+        offset += 8;
+    }
+    size_t length = packet.size() - offset;
+    uint64_t pseudo = siit_sum(packet.data() + 8, 32) + (length >> 16) + (length & 0xFFFF) + next;
+    return siit_fold(siit_sum(packet.data() + offset, length, pseudo)) == 0xFFFF;
+}
+
+inline auto ipv4_packet_valid(std::span<const std::byte> packet) -> bool {
+    if (siit_fold(siit_sum(packet.data(), 20)) != 0xFFFF) {
+        return false;
+    }
+    uint8_t protocol = std::to_integer<uint8_t>(packet[9]);
+    size_t length = packet.size() - 20;
+    uint64_t pseudo = protocol == 1 ? 0 : siit_sum(packet.data() + 12, 8) + protocol + length;
+    return siit_fold(siit_sum(packet.data() + 20, length, pseudo)) == 0xFFFF;
+}
+
+inline auto test_siit_rfc6052_mapping() -> TestResult {
+    using namespace network;
+    // RFC 6052 section 2.4: 192.0.2.33 under each prefix length
+    ipv6_address prefix = siit_v6("2001:db8:122:344::");
+    ipv4_address host = siit_v4("192.0.2.33");
+    struct Case { int length; const char* expected; };
+    const Case cases[] = {
+        {32, "2001:db8:c000:221::"},
+        {40, "2001:db8:1c0:2:21::"},
+        {48, "2001:db8:122:c000:2:2100::"},
+        {56, "2001:db8:122:3c0:0:221::"},
+        {64, "2001:db8:122:344:c0:2:2100:0"},
+        {96, "2001:db8:122:344::c000:221"},
+    };
+    for (const auto& c : cases) {
+        ipv6_address embedded = embed_ipv4(prefix, c.length, host);
+        auto extracted = extract_ipv4(prefix, c.length, embedded);
+        if (!(embedded == siit_v6(c.expected)) || !extracted || !(*extracted == host)) {
+            return TestResult(false, "Prefix /" + std::to_string(c.length) + " mapped wrongly", std::chrono::milliseconds(0));
+        }
+    }
+
+    // Explicit mappings win over the prefix, and survive heavy churn in the flat tables
+    SiitTranslator translator;
+    bool well_known = translator.translate_address(host) == siit_v6("64:ff9b::c000:221");
+    for (uint32_t i = 0; i < 5000; ++i) {
+        translator.add_mapping(ipv4_address(0x0A000000 + i), ipv6_address(0x20010DB8ULL << 32, i));
+    }
+    for (uint32_t i = 0; i < 5000; i += 2) {
+        translator.remove_mapping(ipv4_address(0x0A000000 + i));
+    }
+    bool tables_consistent = translator.mapping_count() == 2500;
+    for (uint32_t i = 0; i < 5000 && tables_consistent; ++i) {
+        auto forward = translator.find_mapping(ipv4_address(0x0A000000 + i));
+        auto reverse = translator.find_mapping(ipv6_address(0x20010DB8ULL << 32, i));
+        tables_consistent = (i % 2 == 0) ? (!forward && !reverse)
+                                         : (forward && *forward == ipv6_address(0x20010DB8ULL << 32, i) &&
+                                            reverse && reverse->address == 0x0A000000 + i);
+    }
+    // Relinking an address drops its old partner
+    translator.add_mapping(ipv4_address(0x0A000001), siit_v6("2001:db8::beef"));
+    bool relinked = !translator.find_mapping(ipv6_address(0x20010DB8ULL << 32, 1)) &&
+                    translator.translate_address(siit_v6("2001:db8::beef")) == ipv4_address(0x0A000001);
+    bool invalid_refused = !translator.set_prefix(prefix, 80);
+
+    return assert_true(well_known && tables_consistent && relinked && invalid_refused,
+                       "RFC 6052 examples and explicit mappings");
+}
+
+inline auto test_siit_round_trip() -> TestResult {
+    using namespace network;
+    VirtualAdapterConfig config{};
+    config.name = "siit0";
+    VirtualAdapter adapter("va-siit", config);
+    // An IPv4-only client reaches an IPv6 server; the server is reached through the prefix
+    ipv4_address client4 = siit_v4("10.0.0.5");
+    ipv6_address client6 = siit_v6("2001:db8:1::5");
+    adapter.link_addresses(client4, client6);
+    ipv4_address server4 = siit_v4("198.51.100.7");
+    ipv6_address server6 = siit_v6("64:ff9b::c633:6407");
+
+    std::vector<std::byte> tcp = siit_transport(60, 3);
+    tcp[12] = std::byte{0x50};                              // Data offset
+    std::vector<std::byte> odd_udp = siit_transport(37, 9); // Odd length exercises the trailing byte
+    siit_put16(odd_udp.data() + 4, 37);
+    std::vector<std::byte> icmp = siit_transport(40, 1);
+    icmp[0] = std::byte{8};                                 // Echo request
+    icmp[1] = std::byte{0};
+    std::vector<std::byte> zero_udp = siit_transport(24, 5);
+    siit_put16(zero_udp.data() + 4, 24);
+    siit_put16(zero_udp.data() + 6, 0);                     // No checksum over IPv4
+
+    network::PacketBatch ipv4_in;
+    ipv4_in.add(build_ipv4_packet(client4, server4, 6, tcp));
+    ipv4_in.add(build_ipv4_packet(client4, server4, 17, odd_udp));
+    ipv4_in.add(build_ipv4_packet(client4, server4, 1, icmp));
+    ipv4_in.add(build_ipv4_packet(client4, server4, 17, zero_udp, 64, 0x4000, false));
+
+    network::PacketBatch ipv6_out;
+    if (adapter.translate_to_ipv6(ipv4_in, ipv6_out) != 4) {
+        return TestResult(false, "IPv4 packets not translated", std::chrono::milliseconds(0));
+    }
+    bool headers = true;
+    for (size_t i = 0; i < ipv6_out.size(); ++i) {
+        auto packet = ipv6_out[i];
+        headers &= packet.size() == ipv4_in[i].size() + 20 && std::to_integer<unsigned>(packet[0]) == 0x62 &&
+                   std::to_integer<unsigned>(packet[1]) == 0x80 && std::to_integer<unsigned>(packet[7]) == 63;
+        ipv6_address source;
+        ipv6_address destination;
+        for (int b = 0; b < 8; ++b) {
+            source.high = (source.high << 8) | std::to_integer<uint64_t>(packet[8 + b]);
+            source.low = (source.low << 8) | std::to_integer<uint64_t>(packet[16 + b]);
+            destination.high = (destination.high << 8) | std::to_integer<uint64_t>(packet[24 + b]);
+            destination.low = (destination.low << 8) | std::to_integer<uint64_t>(packet[32 + b]);
+        }
+        headers &= source == client6 && destination == server6 && ipv6_transport_valid(packet);
+    }
+    bool icmp_mapped = std::to_integer<unsigned>(ipv6_out[2][6]) == 58 && std::to_integer<unsigned>(ipv6_out[2][40]) == 128;
+    if (!headers || !icmp_mapped) {
+        return TestResult(false, "IPv6 headers or checksums wrong", std::chrono::milliseconds(0));
+    }
+
+    // Replies come back the other way
+    network::PacketBatch ipv4_back;
+    if (adapter.translate_to_ipv4(ipv6_out, ipv4_back) != 4) {
+        return TestResult(false, "IPv6 packets not translated back", std::chrono::milliseconds(0));
+    }
+    bool restored = true;
+    for (size_t i = 0; i < ipv4_back.size(); ++i) {
+        auto back = ipv4_back[i];
+        auto original = ipv4_in[i];
+        restored &= back.size() == original.size() && ipv4_packet_valid(back) && std::to_integer<unsigned>(back[8]) == 62 &&
+                    std::to_integer<unsigned>(back[1]) == 0x28 && std::memcmp(back.data() + 12, original.data() + 12, 8) == 0 &&
+                    std::memcmp(back.data() + 20 + 8, original.data() + 20 + 8, original.size() - 28) == 0;
+    }
+    auto stats = adapter.get_translator().get_stats();
+    return assert_true(restored && stats.translated_to_ipv6 == 4 && stats.translated_to_ipv4 == 4,
+                       "TCP, UDP and ICMP echo survive both directions with valid checksums");
+}
+
+inline auto test_siit_fragments_and_drops() -> TestResult {
+    using namespace network;
+    SiitTranslator translator;
+    ipv4_address client4 = siit_v4("192.0.2.10");
+    ipv4_address server4 = siit_v4("198.51.100.7");
+    std::vector<std::byte> out(2048);
+
+    // First fragment of a larger UDP datagram: Fragment header carries the offset, M flag and ID
+    std::vector<std::byte> udp = siit_transport(64, 2);
+    siit_put16(udp.data() + 4, 200);
+    auto first = build_ipv4_packet(client4, server4, 17, udp, 64, 0x2000, false);
+    auto to_v6 = translator.translate_to_ipv6(first, out);
+    bool fragment_header = to_v6 && *to_v6 == first.size() + 28 && std::to_integer<unsigned>(out[6]) == 44 &&
+                           std::to_integer<unsigned>(out[40]) == 17 && siit_get16(out.data() + 42) == 0x0001 &&
+                           siit_get16(out.data() + 46) == 0x1234;
+    std::vector<std::byte> back(2048);
+    auto to_v4 = fragment_header ? translator.translate_to_ipv4(std::span(out.data(), *to_v6), back)
+                                 : std::unexpected(TranslationError::MALFORMED);
+    bool fragment_restored = to_v4 && *to_v4 == first.size() && siit_get16(back.data() + 6) == 0x2000 &&
+                             siit_get16(back.data() + 4) == 0x1234;
+
+    auto expired = translator.translate_to_ipv6(build_ipv4_packet(client4, server4, 17, udp, 1), out);
+    std::vector<std::byte> unreachable = siit_transport(36);
+    unreachable[0] = std::byte{3};                          // ICMP destination unreachable
+    auto icmp_error = translator.translate_to_ipv6(build_ipv4_packet(client4, server4, 1, unreachable), out);
+    auto truncated = translator.translate_to_ipv6(std::span(first.data(), 12), out);
+
+    translator.clear_prefix();
+    auto unmapped = translator.translate_to_ipv6(build_ipv4_packet(client4, server4, 17, udp), out);
+
+    auto stats = translator.get_stats();
+    if (!fragment_header || !fragment_restored) {
+        return TestResult(false, "Fragment fields not carried across", std::chrono::milliseconds(0));
+    }
+    return assert_true(!expired && expired.error() == TranslationError::TTL_EXPIRED &&
+                       !icmp_error && icmp_error.error() == TranslationError::UNSUPPORTED &&
+                       !truncated && truncated.error() == TranslationError::MALFORMED &&
+                       !unmapped && unmapped.error() == TranslationError::NO_MAPPING &&
+                       stats.dropped_ttl_expired == 1 && stats.dropped_unsupported == 1 &&
+                       stats.dropped_malformed == 1 && stats.dropped_no_mapping == 1,
+                       "Bad packets dropped with a reason");
+}
+
+inline auto test_siit_batch_throughput() -> TestResult {
+    using namespace network;
+    SiitTranslator translator;
+    for (uint32_t i = 0; i < 1024; ++i) {
+        translator.add_mapping(ipv4_address(0x0A000000 + i), ipv6_address(0x20010DB8ULL << 32, i));
+    }
+    PacketBatch batch;
+    for (uint32_t i = 0; i < 256; ++i) {
+        batch.add(build_ipv4_packet(ipv4_address(0x0A000000 + i * 4), siit_v4("203.0.113.9"), 17,
+                                    siit_transport(512, static_cast<uint8_t>(i))));
+    }
+
+    PacketBatch ipv6;
+    PacketBatch ipv4;
+    constexpr int rounds = 200;
+    bool complete = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        ipv6.clear();
+        ipv4.clear();
+        complete &= translator.translate_to_ipv6(batch, ipv6) == batch.size();
+        complete &= translator.translate_to_ipv4(ipv6, ipv4) == batch.size();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double packets = 2.0 * rounds * batch.size();
+    std::cout << "SIIT translation: " << packets / elapsed / 1e6 << " Mpps (" << batch[0].size()
+              << "-byte packets)" << std::endl;
+
+    bool valid = true;
+    for (size_t i = 0; i < ipv4.size(); ++i) {
+        valid &= ipv4_packet_valid(ipv4[i]) && ipv6_transport_valid(ipv6[i]);
+    }
+    return assert_true(complete && valid, "Batches translate completely with valid checksums");
+}
+
+inline auto run_siit_tests() -> bool {
+    TestSuite suite("SIIT Translation Tests");
+
+    suite.add_test("RFC 6052 and Explicit Mappings", test_siit_rfc6052_mapping);
+    suite.add_test("Round Trip Through Virtual Adapter", test_siit_round_trip);
+    suite.add_test("Fragments and Drops", test_siit_fragments_and_drops);
+    suite.add_test("Batch Throughput", test_siit_batch_throughput);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
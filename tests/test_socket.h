@@ -16,6 +16,13 @@
 #include "../src/core/acceptor.h"
 #include <thread>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 namespace dualstack {
 namespace test {
@@ -126,6 +133,100 @@ inline auto test_performance_operations() -> TestResult {
     return TestResult(true, "Socket performance benchmark completed", std::chrono::milliseconds(0));
 }
 
+#ifndef _WIN32
+inline auto unix_socket_name(const std::string& name) -> std::string {
+    return "amphisbaena-" + name + "-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+inline auto test_unix_stream_socket() -> TestResult {
+    std::string path = (std::filesystem::temp_directory_path() / (unix_socket_name("stream") + ".sock")).string();
+    
+    // A dead listener's file is replaced
+    Acceptor stale;
+    if (stale.listen(UnixEndpoint(path)) != error_code::success) {
+        return TestResult(false, "Failed to listen on a Unix socket", std::chrono::milliseconds(0));
+    }
+    stale.detach();
+    Acceptor acceptor;
+    if (acceptor.listen(UnixEndpoint(path)) != error_code::success) {
+        return TestResult(false, "Stale socket file not replaced", std::chrono::milliseconds(0));
+    }
+    
+    Socket client;
+    if (client.connect(UnixEndpoint(path)) != error_code::success) {
+        return TestResult(false, "Failed to connect to the Unix socket", std::chrono::milliseconds(0));
+    }
+    auto server = acceptor.accept();
+    const std::string hello = "hello";
+    char reply[16] = {};
+    bool echoed = server && client.send(buffer_t(reinterpret_cast<const std::byte*>(hello.data()), hello.size())) == hello.size() &&
+                  server->receive(buffer_t(reinterpret_cast<const std::byte*>(reply), sizeof(reply))) == hello.size() &&
+                  hello == std::string(reply, hello.size());
+    auto credentials = server ? server->peer_credentials() : std::unexpected<error_code>(error_code::invalid_address);
+    bool identified = credentials && credentials->uid == static_cast<std::uint32_t>(::getuid());
+#if defined(__linux__)
+    identified = identified && credentials->pid == static_cast<std::int32_t>(::getpid());
+#endif
+    
+    // ...a live one is not
+    Acceptor rival;
+    bool kept_live = rival.listen(UnixEndpoint(path)) != error_code::success;
+    bool local = acceptor.local_port() == 0;
+    acceptor.stop_listening();
+    bool removed = !std::filesystem::exists(path);
+    
+    // Never clobber something that is not a socket
+    std::ofstream(path) << "keep";
+    bool kept = rival.listen(UnixEndpoint(path)) != error_code::success && std::filesystem::exists(path);
+    std::filesystem::remove(path);
+    
+    if (!echoed || !identified) {
+        return TestResult(false, "Data or peer credentials lost over the Unix socket", std::chrono::milliseconds(0));
+    }
+    return assert_true(kept_live && local && removed && kept, "Socket file removed on stop, other files left alone");
+}
+#endif
+
+#if defined(__linux__)
+inline auto test_unix_seqpacket_abstract() -> TestResult {
+    UnixEndpoint endpoint("@" + unix_socket_name("seqpacket"));
+    Acceptor acceptor;
+    if (acceptor.listen(endpoint, local_socket_type::seqpacket) != error_code::success) {
+        return TestResult(false, "Failed to listen in the abstract namespace", std::chrono::milliseconds(0));
+    }
+    Socket client;
+    if (client.connect(endpoint, local_socket_type::seqpacket) != error_code::success) {
+        return TestResult(false, "Failed to connect in the abstract namespace", std::chrono::milliseconds(0));
+    }
+    auto server = acceptor.accept();
+    if (!server || server->set_pass_credentials(true) != error_code::success) {
+        return TestResult(false, "Failed to accept or enable credential passing", std::chrono::milliseconds(0));
+    }
+    
+    // Two sends arrive as two messages, each with its sender's credentials
+    const std::string first = "first";
+    const std::string second = "second message";
+    (void)client.send(buffer_t(reinterpret_cast<const std::byte*>(first.data()), first.size()));
+    (void)client.send(buffer_t(reinterpret_cast<const std::byte*>(second.data()), second.size()));
+    char message[64] = {};
+    PeerCredentials sender;
+    auto got_first = server->receive_with_credentials(buffer_t(reinterpret_cast<const std::byte*>(message), sizeof(message)), sender);
+    bool first_ok = got_first == first.size() && std::string(message, got_first) == first;
+    bool credentialed = sender.pid == static_cast<std::int32_t>(::getpid()) && sender.uid == ::getuid() && sender.gid == ::getgid();
+    auto got_second = server->receive(buffer_t(reinterpret_cast<const std::byte*>(message), sizeof(message)));
+    bool second_ok = got_second == second.size() && std::string(message, got_second) == second;
+    
+    acceptor.stop_listening();
+    Socket late;
+    bool released = late.connect(endpoint, local_socket_type::seqpacket) != error_code::success;
+    
+    if (!first_ok || !second_ok) {
+        return TestResult(false, "Message boundaries not preserved", std::chrono::milliseconds(0));
+    }
+    return assert_true(credentialed && released, "Credentials attached, abstract name released on stop");
+}
+#endif
+
 inline auto run_socket_tests() -> bool {
     TestSuite suite("Socket Tests");
     
@@ -134,6 +235,12 @@ inline auto run_socket_tests() -> bool {
     suite.add_test("Dual-Stack Binding", test_dual_stack_binding);
     suite.add_test("Move Semantics", test_move_semantics);
     suite.add_test("Performance Operations", test_performance_operations);
+#ifndef _WIN32
+    suite.add_test("Unix Stream Socket", test_unix_stream_socket);
+#endif
+#if defined(__linux__)
+    suite.add_test("Unix Seqpacket Abstract Socket", test_unix_seqpacket_abstract);
+#endif
     
     return suite.run();
 }
@@ -0,0 +1,301 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "test_http_server.h"
+#include "../src/core/acceptor.h"
+#include "../src/network/tcp_proxy.h"
+#include <thread>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <sys/socket.h>
+#endif
+
+namespace dualstack {
+namespace test {
+
+// Backend that greets each connection with a tag byte, echoes, and half-closes after the client does
+class EchoBackend {
+public:
+    explicit EchoBackend(char tag) : tag_(tag) {}
+    ~EchoBackend() { stop(); }
+
+    bool start() {
+        if (acceptor_.listen(0) != error_code::success) {
+            return false;
+        }
+        running_ = true;
+        accept_thread_ = std::thread([this] {
+            while (running_) {
+                auto accepted = acceptor_.accept();
+                if (!accepted) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                workers_.emplace_back(&EchoBackend::echo, this, std::move(*accepted));
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        acceptor_.stop_listening();
+        accept_thread_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    network::proxy::BackendEndpoint endpoint() const {
+        return {IPAddress::from_string("::1").value(), acceptor_.local_port()};
+    }
+
+private:
+    void echo(Socket socket) {
+        http_send(socket, std::string_view(&tag_, 1));
+        char chunk[16384];
+        for (;;) {
+            size_t got = socket.receive(buffer_t(reinterpret_cast<const std::byte*>(chunk), sizeof(chunk)));
+            if (got == 0 || !http_send(socket, std::string_view(chunk, got))) {
+                break;
+            }
+        }
+        shutdown_write(socket);
+    }
+
+public:
+    static void shutdown_write(Socket& socket) {
+#ifdef _WIN32
+        ::shutdown(static_cast<SOCKET>(socket.get_native_handle()), SD_SEND);
+#else
+        ::shutdown(socket.get_native_handle(), SHUT_WR);
+#endif
+    }
+
+private:
+    char tag_;
+    Acceptor acceptor_;
+    std::atomic<bool> running_{false};
+    std::thread accept_thread_;
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+};
+
+inline auto test_tcp_proxy_forwarding() -> TestResult {
+    using namespace network::proxy;
+    EchoBackend backend('A');
+    if (!backend.start()) {
+        return TestResult(false, "Echo backend failed to start", std::chrono::milliseconds(0));
+    }
+    network::AsyncDualStackServer server(0);
+    TcpProxyConfig config;
+    config.backends = {backend.endpoint()};
+    config.io_threads = 2;
+    TcpProxy proxy(server, config);
+    if (!proxy.start()) {
+        return TestResult(false, "Proxy failed to start", std::chrono::milliseconds(0));
+    }
+
+    // Far more than the socket buffers hold, so the proxy must throttle both directions
+    std::string payload(1 << 20, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>('a' + (i * 7) % 26);
+    }
+    std::string received;
+    if (auto client = http_connect(server.local_port())) {
+        std::thread sender([&] {
+            http_send(*client, payload);
+            EchoBackend::shutdown_write(*client);       // Must reach the backend as EOF
+        });
+        received = http_receive_until(*client, [](const std::string&) { return false; });
+        sender.join();
+    }
+
+    for (int i = 0; i < 100 && proxy.get_stats().active_sessions != 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto stats = proxy.get_stats();
+    proxy.stop();
+    backend.stop();
+
+    if (received.size() != payload.size() + 1 || received[0] != 'A' || received.compare(1, payload.size(), payload) != 0) {
+        return TestResult(false, "Echoed bytes lost or reordered through the proxy", std::chrono::milliseconds(0));
+    }
+#if defined(__linux__)
+    bool spliced = stats.bytes_spliced == stats.bytes_upstream + stats.bytes_downstream;
+#else
+    bool spliced = stats.bytes_spliced == 0;
+#endif
+    return assert_true(stats.sessions == 1 && stats.active_sessions == 0 && stats.bytes_upstream == payload.size() &&
+                       stats.bytes_downstream == payload.size() + 1 && spliced,
+                       "Statistics count sessions and forwarded bytes");
+}
+
+inline auto test_tcp_proxy_balancing() -> TestResult {
+    using namespace network::proxy;
+    EchoBackend first('A');
+    EchoBackend second('B');
+    if (!first.start() || !second.start()) {
+        return TestResult(false, "Echo backends failed to start", std::chrono::milliseconds(0));
+    }
+    network::AsyncDualStackServer server(0);
+    TcpProxyConfig config;
+    config.backends = {first.endpoint(), second.endpoint()};
+    config.io_threads = 1;
+    config.health.interval = std::chrono::milliseconds(50);
+    config.health.timeout = std::chrono::milliseconds(200);
+    config.health.unhealthy_threshold = 2;
+    TcpProxy proxy(server, config);
+    if (!proxy.start()) {
+        return TestResult(false, "Proxy failed to start", std::chrono::milliseconds(0));
+    }
+    auto greeting = [&]() -> std::pair<std::optional<Socket>, char> {
+        auto client = http_connect(server.local_port());
+        if (!client) {
+            return {std::nullopt, 0};
+        }
+        std::string tag = http_receive_until(*client, [](const std::string& text) { return !text.empty(); });
+        return {std::move(client), tag.empty() ? '\0' : tag[0]};
+    };
+
+    // While one session is held open, the next goes to the backend with fewer outstanding
+    auto held = greeting();
+    auto next = greeting();
+    bool balanced = held.second != '\0' && next.second != '\0' && held.second != next.second;
+    held.first.reset();
+    next.first.reset();
+
+    // Once B stops answering health checks, every session lands on A
+    second.stop();
+    bool ejected = false;
+    for (int i = 0; i < 200 && !ejected; ++i) {
+        ejected = !proxy.get_stats().backends[1].healthy;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    bool all_first = true;
+    for (int i = 0; i < 4; ++i) {
+        all_first &= greeting().second == 'A';
+    }
+
+    auto stats = proxy.get_stats();
+    proxy.stop();
+    first.stop();
+
+    if (!balanced) {
+        return TestResult(false, "Second session not sent to the less loaded backend", std::chrono::milliseconds(0));
+    }
+    if (!ejected || !all_first) {
+        return TestResult(false, "Unhealthy backend still receiving sessions", std::chrono::milliseconds(0));
+    }
+    return assert_true(stats.sessions == 6 && stats.rejected == 0 && stats.backends[0].healthy &&
+                       stats.backends[1].health_checks_failed >= 2 && stats.backends[0].sessions + stats.backends[1].sessions == 6,
+                       "Per-backend statistics track sessions and failed checks");
+}
+
+inline auto test_tcp_proxy_client_hash() -> TestResult {
+    using namespace network::proxy;
+    EchoBackend first('A');
+    EchoBackend second('B');
+    if (!first.start() || !second.start()) {
+        return TestResult(false, "Echo backends failed to start", std::chrono::milliseconds(0));
+    }
+    network::AsyncDualStackServer server(0);
+    TcpProxyConfig config;
+    config.backends = {first.endpoint(), second.endpoint()};
+    config.io_threads = 2;
+    config.balance = BalancePolicy::client_hash;
+    config.health.interval = std::chrono::milliseconds(50);
+    config.health.timeout = std::chrono::milliseconds(200);
+    config.health.unhealthy_threshold = 2;
+    TcpProxy proxy(server, config);
+    if (!proxy.start()) {
+        return TestResult(false, "Proxy failed to start", std::chrono::milliseconds(0));
+    }
+    // Clients on distinct loopback sources, 127.0.0.2 upwards
+    auto greeting = [&](uint32_t source) -> char {
+        auto handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (handle == static_cast<decltype(handle)>(-1)) {
+            return '\0';
+        }
+        Socket client(static_cast<native_socket_handle>(handle), true);
+        sockaddr_storage address;
+        socklen_t length;
+        ip_to_sockaddr(IPAddress(ipv4_address(0x7F000002 + source)), 0, address, length);
+        if (::bind(handle, reinterpret_cast<const sockaddr*>(&address), length) != 0 ||
+            client.connect(IPAddress(ipv4_address(0x7F000001)), server.local_port()) != error_code::success) {
+            return '\0';
+        }
+        std::string tag = http_receive_until(client, [](const std::string& text) { return !text.empty(); });
+        return tag.empty() ? '\0' : tag[0];
+    };
+
+    // Every session from one address lands on the same backend, held open or not,
+    // and different addresses spread across the backends
+    constexpr uint32_t SOURCES = 16;
+    bool sticky = true;
+    bool seen_a = false;
+    bool seen_b = false;
+    for (uint32_t source = 0; source < SOURCES; ++source) {
+        char backend = greeting(source);
+        sticky &= backend != '\0';
+        for (int i = 0; i < 3; ++i) {
+            sticky &= greeting(source) == backend;
+        }
+        seen_a |= backend == 'A';
+        seen_b |= backend == 'B';
+    }
+    char pinned = greeting(0);
+
+    // Losing that backend moves the address to the survivor
+    EchoBackend& lost = pinned == 'A' ? first : second;
+    lost.stop();
+    bool ejected = false;
+    for (int i = 0; i < 200 && !ejected; ++i) {
+        ejected = !proxy.get_stats().backends[pinned == 'A' ? 0 : 1].healthy;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    char moved = greeting(0);
+
+    auto stats = proxy.get_stats();
+    proxy.stop();
+    first.stop();
+    second.stop();
+
+    if (!sticky) {
+        return TestResult(false, "Client address not pinned to one backend", std::chrono::milliseconds(0));
+    }
+    if (!seen_a || !seen_b) {
+        return TestResult(false, "Client addresses not spread across backends", std::chrono::milliseconds(0));
+    }
+    return assert_true(ejected && moved != '\0' && moved != pinned && stats.rejected == 0,
+                       "Sessions move to the surviving backend once theirs is unhealthy");
+}
+
+inline auto run_tcp_proxy_tests() -> bool {
+    TestSuite suite("TCP Proxy Tests");
+
+    suite.add_test("Spliced Forwarding and Half-Close", test_tcp_proxy_forwarding);
+    suite.add_test("Least-Outstanding Balancing and Health Checks", test_tcp_proxy_balancing);
+    suite.add_test("Client-Hash Affinity", test_tcp_proxy_client_hash);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack
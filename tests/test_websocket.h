@@ -0,0 +1,324 @@
+#pragma once
+
+/**
+ * DualStackNet26 - Amphisbaena 🐍
+ * Copyright © 2025 D Hargreaves | Roylepython AKA The Medusa Initiative 2025 - All Rights Reserved
+ *
+ * Yorkshire Champion Standards - Improving AI Safety and the Web
+ * British Standards improving AI Safety and the Web
+ *
+ * Weinberg's Second Law: If builders built buildings the way programmers wrote programs,
+ * then the first woodpecker that came along would destroy civilization.
+ */
+
+#include "test_framework.h"
+#include "test_http_server.h"
+#include "../src/network/websocket.h"
+#include <mutex>
+#include <thread>
+
+namespace dualstack {
+namespace test {
+
+inline auto ws_bytes(std::initializer_list<int> values) -> std::vector<std::byte> {
+    std::vector<std::byte> bytes;
+    for (int value : values) {
+        bytes.push_back(static_cast<std::byte>(value));
+    }
+    return bytes;
+}
+
+inline auto ws_text(std::span<const std::byte> bytes) -> std::string {
+    return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+inline auto test_websocket_frames() -> TestResult {
+    using namespace network::websocket;
+
+    // RFC 6455 section 1.3 and 5.7 examples
+    if (accept_key("dGhlIHNhbXBsZSBub25jZQ==") != "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") {
+        return TestResult(false, "Sec-WebSocket-Accept mismatch", std::chrono::milliseconds(0));
+    }
+    Frame frame;
+    auto unmasked = ws_bytes({0x81, 0x05, 0x48, 0x65, 0x6c, 0x6c, 0x6f});
+    auto parsed = parse_frame(unmasked, frame, 1024, false);
+    if (!parsed || *parsed != 7 || !frame.fin || frame.opcode != Opcode::text || ws_text(frame.payload) != "Hello") {
+        return TestResult(false, "Unmasked text frame parsed incorrectly", std::chrono::milliseconds(0));
+    }
+    auto masked = ws_bytes({0x81, 0x85, 0x37, 0xfa, 0x21, 0x3d, 0x7f, 0x9f, 0x4d, 0x51, 0x58});
+    parsed = parse_frame(masked, frame, 1024);
+    if (!parsed || *parsed != masked.size() || !frame.masked || frame.header_size != 6) {
+        return TestResult(false, "Masked text frame parsed incorrectly", std::chrono::milliseconds(0));
+    }
+    apply_mask(frame.payload, frame.mask);
+    if (ws_text(frame.payload) != "Hello") {
+        return TestResult(false, "Masked payload did not unmask", std::chrono::milliseconds(0));
+    }
+    for (size_t cut = 0; cut < masked.size(); ++cut) {
+        auto partial = parse_frame(std::span<std::byte>(masked).first(cut), frame, 1024);
+        if (partial || partial.error() != WebSocketError::incomplete) {
+            return TestResult(false, "Truncated frame should be incomplete", std::chrono::milliseconds(0));
+        }
+    }
+
+    // 16- and 64-bit lengths round-trip through the encoder
+    for (size_t length : {size_t{126}, size_t{65535}, size_t{65536}}) {
+        std::string payload(length, 'x');
+        MaskKey key{std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}};
+        std::string encoded = *encode_frame(Opcode::binary, payload, true, key);
+        auto view = std::as_writable_bytes(std::span<char>(encoded.data(), encoded.size()));
+        parsed = parse_frame(view, frame, 1 << 20);
+        if (!parsed || *parsed != encoded.size() || frame.payload.size() != length) {
+            return TestResult(false, "Extended length did not round-trip", std::chrono::milliseconds(0));
+        }
+        apply_mask(frame.payload, frame.mask);
+        if (ws_text(frame.payload) != payload) {
+            return TestResult(false, "Masked payload did not round-trip", std::chrono::milliseconds(0));
+        }
+    }
+
+    struct Rejected {
+        std::vector<std::byte> bytes;
+        WebSocketError error;
+    };
+    const Rejected rejected[] = {
+        {ws_bytes({0xC1, 0x80, 0, 0, 0, 0}), WebSocketError::protocol_error},         // RSV1 without an extension
+        {ws_bytes({0x83, 0x80, 0, 0, 0, 0}), WebSocketError::protocol_error},         // Reserved opcode
+        {ws_bytes({0x09, 0x80, 0, 0, 0, 0}), WebSocketError::protocol_error},         // Fragmented ping
+        {ws_bytes({0x89, 0xFE, 0, 126}), WebSocketError::protocol_error},             // Control payload > 125
+        {ws_bytes({0x81, 0x00}), WebSocketError::protocol_error},                     // Unmasked client frame
+        {ws_bytes({0x82, 0xFF, 0, 0, 0, 0, 0, 0x10, 0, 0}), WebSocketError::message_too_big},
+        {ws_bytes({0x82, 0xFE, 0, 125, 0, 0, 0, 0}), WebSocketError::protocol_error},   // 16-bit length < 126
+        {ws_bytes({0x82, 0xFF, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF}), WebSocketError::protocol_error},  // 64-bit length <= 0xFFFF
+    };
+    for (const Rejected& entry : rejected) {
+        std::vector<std::byte> bytes = entry.bytes;
+        auto result = parse_frame(bytes, frame, 1024);
+        if (result || result.error() != entry.error) {
+            return TestResult(false, "Malformed frame accepted", std::chrono::milliseconds(0));
+        }
+    }
+
+    // Vector kernels against a byte-wise reference, at every alignment, phase and tail length
+    MaskKey key{std::byte{0x37}, std::byte{0xfa}, std::byte{0x21}, std::byte{0x3d}};
+    std::vector<std::byte> data(300 + 3);
+    for (size_t length = 0; length <= 300; length += (length < 40 ? 1 : 37)) {
+        for (size_t offset = 0; offset < 4; ++offset) {
+            for (size_t phase = 0; phase < 4; ++phase) {
+                for (size_t i = 0; i < data.size(); ++i) {
+                    data[i] = static_cast<std::byte>(i * 7 + 1);
+                }
+                apply_mask(std::span<std::byte>(data).subspan(offset, length), key, phase);
+                for (size_t i = 0; i < data.size(); ++i) {
+                    auto original = static_cast<std::byte>(i * 7 + 1);
+                    bool inside = i >= offset && i < offset + length;
+                    auto expected = inside ? original ^ key[(phase + i - offset) & 3] : original;
+                    if (data[i] != expected) {
+                        return TestResult(false, "Mask kernel differs from reference", std::chrono::milliseconds(0));
+                    }
+                }
+            }
+        }
+    }
+
+    // UTF-8, including a code point split across fragments
+    Utf8Validator utf8;
+    std::string_view valid = "h\xC3\xA9llo \xE2\x82\xAC \xF0\x9D\x84\x9E plain ascii run";
+    auto valid_bytes = std::as_bytes(std::span<const char>(valid.data(), valid.size()));
+    if (!utf8.feed(valid_bytes.first(9)) || utf8.complete() || !utf8.feed(valid_bytes.subspan(9)) || !utf8.complete()) {
+        return TestResult(false, "Valid UTF-8 rejected", std::chrono::milliseconds(0));
+    }
+    for (std::string_view invalid : {"\xC0\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xFF", "a\x80"}) {
+        utf8.reset();
+        if (utf8.feed(std::as_bytes(std::span<const char>(invalid.data(), invalid.size())))) {
+            return TestResult(false, "Invalid UTF-8 accepted", std::chrono::milliseconds(0));
+        }
+    }
+    return TestResult(true, "", std::chrono::milliseconds(0));
+}
+
+// Blocking client helpers
+inline auto ws_handshake(Socket& client, std::string_view path = "/") -> std::string {
+    std::string request = "GET " + std::string(path) +
+                          " HTTP/1.1\r\nHost: x\r\nUpgrade: websocket\r\nConnection: keep-alive, Upgrade\r\n"
+                          "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    http_send(client, request);
+    return http_receive_until(client, [](const std::string& text) { return text.ends_with("\r\n\r\n"); });
+}
+
+inline auto ws_frame(network::websocket::Opcode opcode, std::string_view payload, bool fin = true) -> std::string {
+    network::websocket::MaskKey key{std::byte{0xA1}, std::byte{0xB2}, std::byte{0xC3}, std::byte{0xD4}};
+    return *network::websocket::encode_frame(opcode, payload, fin, key);
+}
+
+inline auto ws_receive(Socket& client, size_t bytes) -> std::string {
+    return http_receive_until(client, [bytes](const std::string& text) { return text.size() >= bytes; });
+}
+
+inline auto test_websocket_server_messages() -> TestResult {
+    using namespace network::websocket;
+    network::AsyncDualStackServer server(0);
+    WebSocketServerConfig config;
+    config.io_threads = 2;
+    WebSocketServer websocket(server, config);
+
+    std::mutex mutex;
+    size_t fragments_seen = 0;
+    std::vector<std::pair<std::string, uint16_t>> closed;
+    websocket.set_message_handler([&](const std::string& id, const Message& message) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fragments_seen = message.fragments.size();
+        }
+        websocket.send(id, encode_frame(message.opcode, message.to_string()));
+    });
+    websocket.set_close_handler([&](const std::string& id, uint16_t code) {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed.emplace_back(id, code);
+    });
+    if (!websocket.start()) {
+        return TestResult(false, "WebSocket server failed to start", std::chrono::milliseconds(0));
+    }
+
+    auto first = http_connect(server.local_port());
+    auto second = http_connect(server.local_port());
+    if (!first || !second) {
+        websocket.stop();
+        return TestResult(false, "Clients failed to connect", std::chrono::milliseconds(0));
+    }
+    std::string upgrade = ws_handshake(*first);
+    ws_handshake(*second);
+    bool upgraded = upgrade.starts_with("HTTP/1.1 101 Switching Protocols\r\n") &&
+                    upgrade.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n") != std::string::npos;
+
+    // A fragmented text message with a ping between its fragments, all in one write
+    http_send(*first, ws_frame(Opcode::text, "Hel", false) + ws_frame(Opcode::ping, "p") +
+                          ws_frame(Opcode::continuation, "lo"));
+    std::string replies = ws_receive(*first, 10);
+    bool echoed = replies == std::string("\x8A\x01p\x81\x05Hello", 10);
+
+    // One encoded frame fans out to both connections
+    size_t reached = websocket.broadcast(encode_frame(Opcode::text, "news"));
+    bool broadcast = reached == 2 && ws_receive(*first, 6) == "\x81\x04news" && ws_receive(*second, 6) == "\x81\x04news";
+
+    // Close handshake: the server echoes the code, then closes
+    http_send(*first, ws_frame(Opcode::close, std::string("\x03\xE8", 2)));
+    std::string close_reply = http_receive_until(*first, [](const std::string&) { return false; });
+    bool closed_cleanly = close_reply == std::string("\x88\x02\x03\xE8", 4);
+
+    for (int i = 0; i < 100; ++i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!closed.empty()) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto stats = websocket.get_stats();
+    websocket.stop();
+
+    if (!upgraded || !echoed || !broadcast || !closed_cleanly) {
+        return TestResult(false, "WebSocket exchange failed", std::chrono::milliseconds(0));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fragments_seen != 2 || closed.empty() || closed.front().second != 1000) {
+        return TestResult(false, "Fragments or close code not reported", std::chrono::milliseconds(0));
+    }
+    return assert_true(stats.connections == 2 && stats.fragmented_messages == 1 && stats.broadcasts == 1 &&
+                       stats.messages_received == 1, "Statistics count handshakes, fragments and broadcasts");
+}
+
+inline auto test_websocket_server_fragment_overhead() -> TestResult {
+    using namespace network::websocket;
+    network::AsyncDualStackServer server(0);
+    WebSocketServerConfig config;
+    config.io_threads = 1;
+    config.max_message_bytes = 16 * 1024;
+    WebSocketServer websocket(server, config);
+
+    std::mutex mutex;
+    size_t delivered = 0;
+    websocket.set_message_handler([&](const std::string& id, const Message& message) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            delivered = message.size;
+        }
+        websocket.send(id, encode_frame(message.opcode, message.to_string()));
+    });
+    if (!websocket.start()) {
+        return TestResult(false, "WebSocket server failed to start", std::chrono::milliseconds(0));
+    }
+    auto client = http_connect(server.local_port());
+    if (!client) {
+        websocket.stop();
+        return TestResult(false, "Client failed to connect", std::chrono::milliseconds(0));
+    }
+    ws_handshake(*client);
+
+    // A message exactly at the limit, sent as one-byte fragments: seven times its size on the wire
+    std::string wire;
+    for (size_t i = 0; i < config.max_message_bytes; ++i) {
+        wire += ws_frame(i == 0 ? Opcode::binary : Opcode::continuation, "x", i + 1 == config.max_message_bytes);
+    }
+    http_send(*client, wire);
+    std::string reply = ws_receive(*client, config.max_message_bytes + 4);
+    auto stats = websocket.get_stats();
+    websocket.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return assert_true(delivered == config.max_message_bytes && reply.size() == config.max_message_bytes + 4 &&
+                       reply.starts_with(std::string_view("\x82\x7E\x40\x00", 4)) && stats.fragmented_messages == 1,
+                       "Frame headers do not count toward the message limit");
+}
+
+inline auto test_websocket_server_rejects() -> TestResult {
+    using namespace network::websocket;
+    network::AsyncDualStackServer server(0);
+    WebSocketServerConfig config;
+    config.io_threads = 1;
+    WebSocketServer websocket(server, config);
+    websocket.set_open_handler([](const std::string&, const network::http::HttpRequest& request) {
+        return request.path != "/private";
+    });
+    if (!websocket.start()) {
+        return TestResult(false, "WebSocket server failed to start", std::chrono::milliseconds(0));
+    }
+
+    std::string plain, refused, violation;
+    if (auto client = http_connect(server.local_port())) {
+        http_send(*client, "GET / HTTP/1.1\r\nHost: x\r\n\r\n");
+        plain = http_receive_until(*client, [](const std::string&) { return false; });
+    }
+    if (auto client = http_connect(server.local_port())) {
+        refused = ws_handshake(*client, "/private");
+    }
+    if (auto client = http_connect(server.local_port())) {
+        ws_handshake(*client);
+        http_send(*client, std::string("\x81\x02hi", 4));       // Clients must mask
+        violation = http_receive_until(*client, [](const std::string&) { return false; });
+    }
+    auto stats = websocket.get_stats();
+    websocket.stop();
+
+    if (!plain.starts_with("HTTP/1.1 400 Bad Request\r\n") || !refused.starts_with("HTTP/1.1 403 Forbidden\r\n")) {
+        return TestResult(false, "Invalid handshakes were not refused", std::chrono::milliseconds(0));
+    }
+    if (violation != std::string("\x88\x02\x03\xEA", 4)) {
+        return TestResult(false, "Protocol violation not closed with 1002", std::chrono::milliseconds(0));
+    }
+    return assert_true(stats.handshakes_rejected == 2 && stats.protocol_errors == 1,
+                       "Statistics count rejected handshakes and protocol errors");
+}
+
+inline auto run_websocket_tests() -> bool {
+    TestSuite suite("WebSocket Tests");
+
+    suite.add_test("Frames, Masking and UTF-8", test_websocket_frames);
+    suite.add_test("Messages, Fragments and Broadcast", test_websocket_server_messages);
+    suite.add_test("Fragment Overhead Under The Limit", test_websocket_server_fragment_overhead);
+    suite.add_test("Rejected Handshakes and Violations", test_websocket_server_rejects);
+
+    return suite.run();
+}
+
+} // namespace test
+} // namespace dualstack